@@ -44,6 +44,8 @@ public:
   const std::string& contentEncoding() const override {
     return Http::CustomHeaders::get().ContentEncodingValues.Gzip;
   }
+  // The compressors use the QAT session of the worker that created them.
+  bool supportsOffload() const override { return false; }
 
 private:
   struct QatzipThreadLocal : public ThreadLocal::ThreadLocalObject {
@@ -43,6 +43,8 @@ public:
   const std::string& contentEncoding() const override {
     return Http::CustomHeaders::get().ContentEncodingValues.Zstd;
   }
+  // The compressors use the QAT session of the worker that created them.
+  bool supportsOffload() const override { return false; }
 
 private:
   struct QatzstdThreadLocal : public ThreadLocal::ThreadLocalObject,
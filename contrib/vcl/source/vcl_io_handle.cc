@@ -385,6 +385,8 @@ Api::IoCallUint64Result VclIoHandle::recvmmsg(RawSliceArrays&, uint32_t, const U
 
 bool VclIoHandle::supportsMmsg() const { return false; }
 
+Api::IoCallUint64Result VclIoHandle::splice(os_fd_t, bool, uint64_t) { PANIC("not implemented"); }
+
 Api::SysCallIntResult VclIoHandle::bind(Envoy::Network::Address::InstanceConstSharedPtr address) {
   if (!VCL_SH_VALID(sh_)) {
     return {-1, VPPCOM_EBADFD};
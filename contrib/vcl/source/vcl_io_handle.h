@@ -54,6 +54,8 @@ public:
 
   bool supportsMmsg() const override;
   bool supportsUdpGro() const override { return false; }
+  bool supportsSplice() const override { return false; }
+  Api::IoCallUint64Result splice(os_fd_t pipe_fd, bool from_handle, uint64_t max_length) override;
 
   Api::SysCallIntResult bind(Envoy::Network::Address::InstanceConstSharedPtr address) override;
   Api::SysCallIntResult listen(int backlog) override;
@@ -28,6 +28,19 @@ public:
    * @see sched_getaffinity (man 2 sched_getaffinity)
    */
   virtual SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) PURE;
+
+  /**
+   * @see man 2 pipe2
+   */
+  virtual SysCallIntResult pipe2(os_fd_t pipefd[2], int flags) PURE;
+
+  /**
+   * Moves data between two file descriptors without copying it to user space. One of them must be
+   * a pipe. The input and output offsets are not used.
+   * @see man 2 splice
+   */
+  virtual SysCallSizeResult splice(os_fd_t fd_in, os_fd_t fd_out, size_t len,
+                                   unsigned int flags) PURE;
 };
 
 using LinuxOsSysCallsPtr = std::unique_ptr<LinuxOsSysCalls>;
@@ -190,6 +190,31 @@ public:
    */
   virtual IoUringResult prepareReadMultishot(os_fd_t fd, Request* user_data) PURE;
 
+  /**
+   * Returns the provided buffer pool used for `multishot` datagram receives, or nullptr when
+   * datagram receives are not available. Each buffer holds a single datagram together with its
+   * source address and control messages.
+   */
+  virtual IoUringBufferPoolSharedPtr datagramBufferPool() PURE;
+
+  /**
+   * Prepares a `multishot` recvmsg that draws buffers from the datagram buffer pool and puts it
+   * into the submission queue. The msg_namelen and msg_controllen of the given header reserve the
+   * space for the source address and the control messages in each buffer, and the header must stay
+   * valid while the request is armed. Returns IoUringResult::Failed when the submission queue is
+   * full already and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareRecvmsgMultishot(os_fd_t fd, struct msghdr* msg,
+                                                Request* user_data) PURE;
+
+  /**
+   * Prepares a sendmsg system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareSendmsg(os_fd_t fd, const struct msghdr* msg,
+                                       Request* user_data) PURE;
+
   /**
    * Prepares a writev system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -455,6 +480,61 @@ public:
 
 using IoUringSocketPtr = std::unique_ptr<IoUringSocket>;
 
+/**
+ * A datagram received by a `multishot` recvmsg. The source address, the control messages and the
+ * payload point into a provided buffer that stays valid until the datagram is popped.
+ */
+struct ReceivedDatagram {
+  // Only msg_name, msg_namelen, msg_control, msg_controllen and msg_flags are populated. msg_flags
+  // carries MSG_TRUNC when the datagram did not fit into the buffer.
+  struct msghdr hdr_;
+  const uint8_t* payload_;
+  uint64_t payload_length_;
+};
+
+/**
+ * Abstract for a datagram socket. Received datagrams are queued in the socket and a read event is
+ * delivered once per completion batch, so the handler can drain several datagrams per wakeup.
+ */
+class IoUringDatagramSocket {
+public:
+  virtual ~IoUringDatagramSocket() = default;
+
+  /**
+   * Return the underlying IoUringSocket, which is used for the event and close handling.
+   */
+  virtual IoUringSocket& ioUringSocket() PURE;
+
+  /**
+   * Return the oldest received datagram, or nullptr when no datagram is queued.
+   */
+  virtual const ReceivedDatagram* frontDatagram() const PURE;
+
+  /**
+   * Release the oldest received datagram and return its buffer to the pool.
+   */
+  virtual void popDatagram() PURE;
+
+  /**
+   * Return the errno with which the kernel rejected receiving on the socket, or 0. Once it is set,
+   * no more datagrams are received.
+   */
+  virtual int recvError() const PURE;
+
+  /**
+   * Send a datagram. The data is copied, so the slices can be released once this returns.
+   * @param slices includes the datagram payload.
+   * @param num_slice the number of slices.
+   * @param self_ip the source address to send from, or nullptr to let the kernel pick it.
+   * @param peer_address the destination address.
+   * @return the number of bytes queued, which is zero when the socket is applying write
+   * backpressure so the caller can retry after a write event is delivered.
+   */
+  virtual uint64_t sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice,
+                           const Network::Address::Ip* self_ip,
+                           const Network::Address::Instance& peer_address) PURE;
+};
+
 /**
  * Abstract for per-thread worker.
  */
@@ -480,6 +560,16 @@ public:
   virtual IoUringSocket& addClientSocket(os_fd_t fd, Event::FileReadyCb cb,
                                          bool enable_close_event) PURE;
 
+  /**
+   * Add a datagram socket to the worker. Only valid when isDatagramEnabled() returns true.
+   */
+  virtual IoUringDatagramSocket& addDatagramSocket(os_fd_t fd, Event::FileReadyCb cb) PURE;
+
+  /**
+   * Whether the worker can receive and send datagrams through the io_uring.
+   */
+  virtual bool isDatagramEnabled() const PURE;
+
   /**
    * Return the current thread's dispatcher.
    */
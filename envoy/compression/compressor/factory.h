@@ -17,6 +17,13 @@ public:
   virtual CompressorPtr createCompressor() PURE;
   virtual const std::string& statsPrefix() const PURE;
   virtual const std::string& contentEncoding() const PURE;
+
+  /**
+   * @return whether the compressors created by this factory can be used from a thread other than
+   *         the one that created them, one thread at a time. Compressors that rely on state bound
+   *         to the thread that created them, such as per-worker hardware sessions, must not be.
+   */
+  virtual bool supportsOffload() const { return false; }
 };
 
 using CompressorFactoryPtr = std::unique_ptr<CompressorFactory>;
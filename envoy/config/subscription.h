@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -11,6 +12,8 @@
 
 #include "source/common/protobuf/protobuf.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Config {
 
@@ -87,6 +90,26 @@ public:
    *         the route config name for a envoy.config.route.v3.RouteConfiguration message.
    */
   virtual std::string resourceName(const Protobuf::Message& resource) PURE;
+
+  /**
+   * Decode an opaque resource like decodeResource(), but skip the checks for unknown and deprecated
+   * fields, which may depend on per-server state. Unlike decodeResource(), this may be called
+   * concurrently from threads other than the main thread. Callers must complete the validation by
+   * calling validateDecodedResource() on the main thread.
+   * @param resource some opaque resource (Protobuf::Any).
+   * @return ProtobufTypes::MessagePtr decoded protobuf message in the opaque resource, or nullptr
+   *         if the decoder does not support decoding off the main thread.
+   */
+  virtual ProtobufTypes::MessagePtr decodeResourceConcurrently(const Protobuf::Any&) {
+    return nullptr;
+  }
+
+  /**
+   * Check a resource returned by decodeResourceConcurrently() for unknown and deprecated fields.
+   * Must be called on the main thread.
+   * @param resource the decoded protobuf message.
+   */
+  virtual void validateDecodedResource(const Protobuf::Message&) {}
 };
 
 using OpaqueResourceDecoderSharedPtr = std::shared_ptr<OpaqueResourceDecoder>;
@@ -175,6 +198,23 @@ struct SubscriptionOptions {
    * For xdstp:// resource names, should node context parameters be added at the transport layer?
    */
   bool add_xdstp_node_context_params_{};
+
+  /**
+   * For state-of-the-world gRPC subscriptions, should resources that are unchanged since the last
+   * accepted update be filtered out? When set, every update after the first accepted one is
+   * delivered through the delta onConfigUpdate(), with only the added or changed resources and
+   * the names of the resources that are no longer present. Only subscribers whose delta
+   * onConfigUpdate() applies a partial update on top of their current state should set this.
+   */
+  bool skip_unchanged_resources_{};
+
+  /**
+   * Used together with skip_unchanged_resources_, returns the names of the resources that the
+   * subscriber currently holds. A resource that is unchanged but that the subscriber has dropped on
+   * its own since it was accepted, e.g. a listener that failed warming, is delivered again. When
+   * unset, the subscriber is assumed to hold every resource of the last accepted update.
+   */
+  std::function<absl::flat_hash_set<std::string>()> current_resource_names_;
 };
 
 /**
@@ -286,6 +326,7 @@ public:
   COUNTER(update_failure)                                                                          \
   COUNTER(update_rejected)                                                                         \
   COUNTER(update_success)                                                                          \
+  COUNTER(update_unchanged_resources_skipped)                                                      \
   GAUGE(update_time, NeverImport)                                                                  \
   GAUGE(version, NeverImport)                                                                      \
   HISTOGRAM(update_duration, Milliseconds)                                                         \
@@ -228,6 +228,25 @@ public:
    */
   virtual bool supportsUdpGro() const PURE;
 
+  /**
+   * return true if data can be moved between the handle and a pipe with splice(). Handles that
+   * read and write the data of the socket other than with plain system calls return false.
+   */
+  virtual bool supportsSplice() const PURE;
+
+  /**
+   * Move data between the handle and a pipe without copying it to user space (see man 2 splice).
+   * @param pipe_fd supplies the pipe to write the data read from the handle to, or to read the
+   *        data to write to the handle from.
+   * @param from_handle supplies whether data is read from the handle into the pipe, or written to
+   *        the handle from the pipe.
+   * @param max_length supplies the most data to move.
+   * @return a Api::IoCallUint64Result with err_ = nullptr and rc_ = the number of bytes moved if
+   * successful, or err_ = some IoError for failure. If call failed, rc_ shouldn't be used.
+   */
+  virtual Api::IoCallUint64Result splice(os_fd_t pipe_fd, bool from_handle,
+                                         uint64_t max_length) PURE;
+
   /**
    * Bind to address. The handle should have been created with a call to socket()
    * @param address address to bind to.
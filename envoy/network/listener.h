@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -400,6 +401,9 @@ struct UdpSendData {
   Buffer::Instance& buffer_;
 };
 
+class UdpListenerCallbacks;
+using UdpListenerCallbacksOptRef = std::optional<std::reference_wrapper<UdpListenerCallbacks>>;
+
 /**
  * UDP listener callbacks.
  */
@@ -470,6 +474,12 @@ public:
    */
   virtual void post(Network::UdpRecvData&& data) PURE;
 
+  /**
+   * Posts ``cb`` to run on this worker. ``cb`` is passed this worker's callbacks for the listener,
+   * or ``std::nullopt`` if the listener has been removed from this worker by the time ``cb`` runs.
+   */
+  virtual void postCallback(std::function<void(UdpListenerCallbacksOptRef)> cb) PURE;
+
   /**
    * An estimated number of UDP packets this callback expects to process in current read event.
    */
@@ -481,8 +491,6 @@ public:
   virtual const IoHandle::UdpSaveCmsgConfig& udpSaveCmsgConfig() const PURE;
 };
 
-using UdpListenerCallbacksOptRef = std::optional<std::reference_wrapper<UdpListenerCallbacks>>;
-
 /**
  * An abstract socket listener. Free the listener to stop listening on the socket.
  */
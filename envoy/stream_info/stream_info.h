@@ -283,6 +283,7 @@ struct LocalCloseReasonValues {
   const std::string TriggeredDelayedCloseTimeout = "triggered_delayed_close_timeout";
   const std::string TcpProxyInitializationFailure = "tcp_initializion_failure:";
   const std::string TcpProxyDrainClose = "tcp_proxy_drain_close";
+  const std::string TcpProxySpliceError = "tcp_proxy_splice_error";
   const std::string TcpSessionIdleTimeout = "tcp_session_idle_timeout";
   const std::string MaxConnectionDurationReached = "max_connection_duration_reached";
   const std::string ClosingUpstreamTcpDueToDownstreamRemoteClose =
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/common/optref.h"
 #include "envoy/extensions/filters/network/tcp_proxy/v3/tcp_proxy.pb.h"
 #include "envoy/http/filter.h"
 #include "envoy/http/header_evaluator.h"
@@ -181,6 +182,13 @@ public:
    * @return the failure reason of the local close.
    */
   virtual absl::string_view localCloseReason() const { return ""; }
+
+  /**
+   * @return the upstream connection if data is written to it as is, which allows moving data
+   *         between the downstream and upstream sockets without copying it. Empty for upstreams
+   *         that encapsulate the data, e.g. in HTTP streams.
+   */
+  virtual OptRef<Network::Connection> rawConnection() { return {}; }
 };
 
 using GenericConnPoolPtr = std::unique_ptr<GenericConnPool>;
@@ -42,6 +42,38 @@ public:
         version, std::nullopt, std::nullopt));
   }
 
+  // Like fromResource(), but decodes the resource with
+  // OpaqueResourceDecoder::decodeResourceConcurrently(), so that it may be called from threads
+  // other than the main thread. The caller must finish validation of the returned resource with
+  // OpaqueResourceDecoder::validateDecodedResource() on the main thread. Returns nullptr if the
+  // decoder does not support decoding off the main thread.
+  static absl::StatusOr<DecodedResourceImplPtr>
+  fromResourceConcurrently(OpaqueResourceDecoder& resource_decoder, const Protobuf::Any& resource,
+                           const std::string& version) {
+    if (resource.Is<envoy::service::discovery::v3::Resource>()) {
+      envoy::service::discovery::v3::Resource r;
+      RETURN_IF_NOT_OK(MessageUtil::unpackTo(resource, r));
+      ProtobufTypes::MessagePtr decoded = resource_decoder.decodeResourceConcurrently(r.resource());
+      if (decoded == nullptr) {
+        return nullptr;
+      }
+      return std::unique_ptr<DecodedResourceImpl>(new DecodedResourceImpl(
+          resource_decoder, std::move(decoded), r.name(), r.aliases(), r.has_resource(), version,
+          r.has_ttl() ? std::make_optional(std::chrono::milliseconds(
+                            DurationUtil::durationToMilliseconds(r.ttl())))
+                      : std::nullopt,
+          r.has_metadata() ? std::make_optional(r.metadata()) : std::nullopt));
+    }
+
+    ProtobufTypes::MessagePtr decoded = resource_decoder.decodeResourceConcurrently(resource);
+    if (decoded == nullptr) {
+      return nullptr;
+    }
+    return std::unique_ptr<DecodedResourceImpl>(new DecodedResourceImpl(
+        resource_decoder, std::move(decoded), std::nullopt,
+        Protobuf::RepeatedPtrField<std::string>(), true, version, std::nullopt, std::nullopt));
+  }
+
   static DecodedResourceImplPtr
   fromResource(OpaqueResourceDecoder& resource_decoder,
                const envoy::service::discovery::v3::Resource& resource) {
@@ -84,7 +116,14 @@ private:
                       const Protobuf::Any& resource, bool has_resource, const std::string& version,
                       std::optional<std::chrono::milliseconds> ttl,
                       const std::optional<envoy::config::core::v3::Metadata>& metadata)
-      : resource_(resource_decoder.decodeResource(resource)), has_resource_(has_resource),
+      : DecodedResourceImpl(resource_decoder, resource_decoder.decodeResource(resource), name,
+                            aliases, has_resource, version, ttl, metadata) {}
+  DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder, ProtobufTypes::MessagePtr&& resource,
+                      std::optional<std::string> name,
+                      const Protobuf::RepeatedPtrField<std::string>& aliases, bool has_resource,
+                      const std::string& version, std::optional<std::chrono::milliseconds> ttl,
+                      const std::optional<envoy::config::core::v3::Metadata>& metadata)
+      : resource_(std::move(resource)), has_resource_(has_resource),
         name_(name ? *name : resource_decoder.resourceName(*resource_)),
         aliases_(repeatedPtrFieldToVector(aliases)), version_(version), ttl_(ttl),
         metadata_(metadata) {}
@@ -28,6 +28,21 @@ public:
     return MessageUtil::getStringField(resource, name_field_);
   }
 
+  ProtobufTypes::MessagePtr decodeResourceConcurrently(const Protobuf::Any& resource) override {
+    auto typed_message = std::make_unique<Current>();
+    if (!resource.type_url().empty()) {
+      MessageUtil::anyConvert<Current>(resource, *typed_message);
+      MessageUtil::validateConstraints(*typed_message);
+    }
+    return typed_message;
+  }
+
+  void validateDecodedResource(const Protobuf::Message& resource) override {
+    if (!validation_visitor_.skipValidation()) {
+      MessageUtil::checkForUnexpectedFields(resource, validation_visitor_);
+    }
+  }
+
 private:
   ProtobufMessage::ValidationVisitor& validation_visitor_;
   const std::string name_field_;
@@ -240,7 +240,7 @@ XdsManagerImpl::initializeAdsConnections(const envoy::config::bootstrap::v3::Boo
                                  main_thread_dispatcher_, random_, *stats_.rootScope(),
                                  dyn_resources.ads_config(), local_info_,
                                  std::move(custom_config_validators), std::move(backoff_strategy),
-                                 xds_config_tracker, {}, lrs_factory);
+                                 xds_config_tracker, {}, lrs_factory, api_);
     } else {
       absl::Status status = Config::Utility::checkTransportVersion(dyn_resources.ads_config());
       RETURN_IF_NOT_OK(status);
@@ -274,7 +274,7 @@ XdsManagerImpl::initializeAdsConnections(const envoy::config::bootstrap::v3::Boo
                                  main_thread_dispatcher_, random_, *stats_.rootScope(),
                                  dyn_resources.ads_config(), local_info_,
                                  std::move(custom_config_validators), std::move(backoff_strategy),
-                                 xds_config_tracker, xds_resources_delegate, lrs_factory);
+                                 xds_config_tracker, xds_resources_delegate, lrs_factory, api_);
     }
   } else {
     ads_mux_ = std::make_unique<Config::NullGrpcMuxImpl>();
@@ -473,7 +473,7 @@ XdsManagerImpl::createAuthority(const envoy::config::core::v3::ConfigSource& con
     authority_mux = factory->create(
         std::move(primary_client), std::move(failover_client), main_thread_dispatcher_, random_,
         *stats_.rootScope(), api_config_source, local_info_, std::move(custom_config_validators),
-        std::move(backoff_strategy), xds_config_tracker, {}, lrs_factory);
+        std::move(backoff_strategy), xds_config_tracker, {}, lrs_factory, api_);
   } else {
     ASSERT(api_config_source.api_type() ==
            envoy::config::core::v3::ApiConfigSource::AGGREGATED_GRPC);
@@ -508,7 +508,7 @@ XdsManagerImpl::createAuthority(const envoy::config::core::v3::ConfigSource& con
     authority_mux = factory->create(
         std::move(primary_client), std::move(failover_client), main_thread_dispatcher_, random_,
         *stats_.rootScope(), api_config_source, local_info_, std::move(custom_config_validators),
-        std::move(backoff_strategy), xds_config_tracker, xds_resources_delegate, lrs_factory);
+        std::move(backoff_strategy), xds_config_tracker, xds_resources_delegate, lrs_factory, api_);
   }
   ASSERT(authority_mux != nullptr);
 
@@ -110,6 +110,24 @@ const StaticHeaderNameLookup& getStaticHeaderNameLookup() {
   CONSTRUCT_ON_FIRST_USE(StaticHeaderNameLookup);
 }
 
+// The maximum number of slices looked at when picking the length of a DATA frame.
+constexpr uint64_t MaxDataFrameSlices = 64;
+
+// Returns the length of the next DATA frame to send from `data`, which holds more than
+// `max_length` bytes. Moving part of a slice into a frame copies that part, while whole slices are
+// moved without copying, so the frame ends at the last slice boundary within `max_length`, as long
+// as that keeps the frame at least half as large. Otherwise `max_length` is returned.
+size_t sliceAlignedDataFrameLength(const Buffer::Instance& data, size_t max_length) {
+  size_t aligned_length = 0;
+  for (const Buffer::RawSlice& slice : data.getRawSlices(MaxDataFrameSlices)) {
+    if (aligned_length + slice.len_ > max_length) {
+      break;
+    }
+    aligned_length += slice.len_;
+  }
+  return aligned_length > 0 && aligned_length >= max_length / 2 ? aligned_length : max_length;
+}
+
 } // namespace
 
 // for nghttp2 compatibility.
@@ -994,6 +1012,8 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
           http2_options.override_stream_error_on_invalid_http_message().value()),
       record_http2_histograms_(
           Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http2_record_histograms")),
+      slice_aligned_data_frames_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.http2_slice_aligned_data_frames")),
       max_cookie_size_bytes_(
           runtime.has_value() ? runtime->snapshot().getInteger(
                                     "envoy.reloadable_features.http2_max_cookies_size_in_kb", 0) *
@@ -1915,7 +1935,10 @@ ConnectionImpl::Http2Visitor::OnReadyToSendDataForStream(Http2StreamId stream_id
     stream->data_deferred_ = true;
     return {/*payload_length=*/0, /*end_data=*/false, /*end_stream=*/false};
   }
-  const size_t length = std::min<size_t>(max_length, stream->pending_send_data_->length());
+  size_t length = std::min<size_t>(max_length, stream->pending_send_data_->length());
+  if (length < stream->pending_send_data_->length() && connection_->slice_aligned_data_frames_) {
+    length = sliceAlignedDataFrameLength(*stream->pending_send_data_, length);
+  }
   bool end_data = false;
   bool end_stream = false;
   if (stream->local_end_stream_ && length == stream->pending_send_data_->length()) {
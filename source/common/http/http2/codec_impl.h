@@ -741,6 +741,9 @@ protected:
   uint64_t max_metadata_size_;
   const bool stream_error_on_invalid_http_messaging_;
   const bool record_http2_histograms_;
+  // Whether DATA frames end at buffer slice boundaries, so that their payload is moved to the
+  // connection without being copied.
+  const bool slice_aligned_data_frames_;
   const uint64_t max_cookie_size_bytes_{0};
 
   // Status for any errors encountered by the nghttp2 callbacks.
@@ -11,6 +11,8 @@ namespace {
 // The buffer group id for the provided buffer ring backing `multishot` reads. A single group is
 // enough since each worker thread owns its own io_uring.
 constexpr uint16_t ProvidedBufferGroupId = 0;
+// The buffer group id for the provided buffer ring backing `multishot` datagram receives.
+constexpr uint16_t DatagramBufferGroupId = 1;
 
 // Idle time in milliseconds before the SQPOLL kernel thread sleeps when the submission queue is
 // empty.
@@ -26,6 +28,18 @@ uint32_t providedBufferCount(uint32_t io_uring_size) {
   }
   return count;
 }
+
+// `Multishot` recvmsg landed in Linux 6.0 without an opcode of its own, so probe for the zero-copy
+// send opcode that was added in the same release.
+bool isMultishotRecvmsgSupported(struct io_uring& ring) {
+  struct io_uring_probe* probe = io_uring_get_probe_ring(&ring);
+  if (probe == nullptr) {
+    return false;
+  }
+  const bool supported = io_uring_opcode_supported(probe, IORING_OP_SEND_ZC);
+  io_uring_free_probe(probe);
+  return supported;
+}
 } // namespace
 
 // A provided buffer ring registered with the kernel. The buffer memory is owned here and kept alive
@@ -115,7 +129,8 @@ bool isIoUringSupported() {
 }
 
 IoUringImpl::IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
-                         bool enable_multishot_receive, uint32_t multishot_buffer_size) {
+                         bool enable_multishot_receive, uint32_t multishot_buffer_size,
+                         uint32_t datagram_buffer_count) {
   struct io_uring_params p{};
 
   // Size the completion queue at twice the submission queue to reduce the chance of overflow.
@@ -158,6 +173,25 @@ IoUringImpl::IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polli
                        "unsupported, falling back to readv");
     }
   }
+
+  // Set up the provided buffer ring for datagram receives when requested. Without kernel support
+  // datagram sockets keep using the epoll-based path.
+  if (datagram_buffer_count > 0) {
+    if (isMultishotRecvmsgSupported(ring_)) {
+      const uint32_t buffer_count = providedBufferCount(datagram_buffer_count);
+      auto pool = std::make_shared<IoUringBufferPoolImpl>(ring_, DatagramBufferGroupId,
+                                                          buffer_count, DatagramBufferSize);
+      if (pool->valid()) {
+        datagram_buffer_pool_ = std::move(pool);
+        ENVOY_LOG(debug, "io_uring datagram receives enabled, {} buffers of {} bytes", buffer_count,
+                  DatagramBufferSize);
+      }
+    }
+    if (datagram_buffer_pool_ == nullptr) {
+      ENVOY_LOG(debug, "io_uring datagram receives requested but unsupported by the kernel, "
+                       "falling back to the socket API");
+    }
+  }
 }
 
 IoUringImpl::~IoUringImpl() {
@@ -167,6 +201,9 @@ IoUringImpl::~IoUringImpl() {
   if (buffer_pool_ != nullptr) {
     buffer_pool_->releaseRing();
   }
+  if (datagram_buffer_pool_ != nullptr) {
+    datagram_buffer_pool_->releaseRing();
+  }
   io_uring_queue_exit(&ring_);
 }
 
@@ -302,6 +339,37 @@ IoUringResult IoUringImpl::prepareReadMultishot(os_fd_t fd, Request* user_data)
   return IoUringResult::Ok;
 }
 
+IoUringBufferPoolSharedPtr IoUringImpl::datagramBufferPool() { return datagram_buffer_pool_; }
+
+IoUringResult IoUringImpl::prepareRecvmsgMultishot(os_fd_t fd, struct msghdr* msg,
+                                                   Request* user_data) {
+  ENVOY_LOG(trace, "prepare recvmsg multishot for fd = {}", fd);
+  ASSERT(datagram_buffer_pool_ != nullptr);
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_recvmsg_multishot(sqe, fd, msg, 0);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  io_uring_sqe_set_buf_group(sqe, datagram_buffer_pool_->groupId());
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareSendmsg(os_fd_t fd, const struct msghdr* msg,
+                                          Request* user_data) {
+  ENVOY_LOG(trace, "prepare sendmsg for fd = {}", fd);
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_sendmsg(sqe, fd, msg, 0);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                          off_t offset, Request* user_data) {
   ENVOY_LOG(trace, "prepare writev for fd = {}", fd);
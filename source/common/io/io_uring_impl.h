@@ -12,6 +12,18 @@ namespace Io {
 
 bool isIoUringSupported();
 
+// The space reserved in each datagram buffer for the control messages of a received datagram. It
+// fits the destination address, the dropped packet count, the GRO segment size and the TOS byte
+// with room to spare for a saved control message.
+constexpr uint32_t DatagramControlSpace = 256;
+// The largest UDP payload. Coalesced GRO datagrams are bounded by it as well.
+constexpr uint32_t MaxDatagramPayloadSize = 65535;
+// The size of each provided buffer for datagram receives. The kernel lays out a header, the source
+// address and the control messages ahead of the payload.
+constexpr uint32_t DatagramBufferSize = sizeof(struct io_uring_recvmsg_out) +
+                                        sizeof(struct sockaddr_storage) + DatagramControlSpace +
+                                        MaxDatagramPayloadSize;
+
 struct InjectedCompletion {
   InjectedCompletion(os_fd_t fd, Request* user_data, int32_t result)
       : fd_(fd), user_data_(user_data), result_(result) {}
@@ -28,7 +40,8 @@ class IoUringImpl : public IoUring,
                     protected Logger::Loggable<Logger::Id::io> {
 public:
   IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
-              bool enable_multishot_receive, uint32_t multishot_buffer_size);
+              bool enable_multishot_receive, uint32_t multishot_buffer_size,
+              uint32_t datagram_buffer_count = 0);
   ~IoUringImpl() override;
 
   os_fd_t registerEventfd() override;
@@ -45,6 +58,10 @@ public:
   bool isMultishotEnabled() const override;
   IoUringBufferPoolSharedPtr bufferPool() override;
   IoUringResult prepareReadMultishot(os_fd_t fd, Request* user_data) override;
+  IoUringBufferPoolSharedPtr datagramBufferPool() override;
+  IoUringResult prepareRecvmsgMultishot(os_fd_t fd, struct msghdr* msg,
+                                        Request* user_data) override;
+  IoUringResult prepareSendmsg(os_fd_t fd, const struct msghdr* msg, Request* user_data) override;
   IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                               off_t offset, Request* user_data) override;
   IoUringResult prepareClose(os_fd_t fd, Request* user_data) override;
@@ -68,6 +85,9 @@ private:
   // not supported by the kernel. Held as a shared_ptr so read fragments can keep the buffer memory
   // alive after this ring is gone.
   std::shared_ptr<IoUringBufferPoolImpl> buffer_pool_;
+  // The provided buffer pool backing `multishot` datagram receives. Null when datagram receives are
+  // disabled or not supported by the kernel.
+  std::shared_ptr<IoUringBufferPoolImpl> datagram_buffer_pool_;
 };
 
 } // namespace Io
@@ -1,18 +1,19 @@
 #include "source/common/io/io_uring_worker_factory_impl.h"
 
-#include "source/common/io/io_uring_worker_impl.h"
-
 namespace Envoy {
 namespace Io {
 
 IoUringWorkerFactoryImpl::IoUringWorkerFactoryImpl(
     uint32_t io_uring_size, bool use_submission_queue_polling, bool enable_multishot_receive,
     uint32_t read_buffer_size, uint32_t write_timeout_ms, uint32_t write_high_watermark_bytes,
-    uint32_t write_low_watermark_bytes, ThreadLocal::SlotAllocator& tls)
+    uint32_t write_low_watermark_bytes, ThreadLocal::SlotAllocator& tls,
+    uint32_t datagram_buffer_count, IoUringDatagramStatsSharedPtr datagram_stats)
     : io_uring_size_(io_uring_size), use_submission_queue_polling_(use_submission_queue_polling),
       enable_multishot_receive_(enable_multishot_receive), read_buffer_size_(read_buffer_size),
       write_timeout_ms_(write_timeout_ms), write_high_watermark_bytes_(write_high_watermark_bytes),
-      write_low_watermark_bytes_(write_low_watermark_bytes), tls_(tls) {}
+      write_low_watermark_bytes_(write_low_watermark_bytes),
+      datagram_buffer_count_(datagram_buffer_count), datagram_stats_(std::move(datagram_stats)),
+      tls_(tls) {}
 
 OptRef<IoUringWorker> IoUringWorkerFactoryImpl::getIoUringWorker() {
   auto ret = tls_.get();
@@ -28,10 +29,13 @@ void IoUringWorkerFactoryImpl::onWorkerThreadInitialized() {
             enable_multishot_receive = enable_multishot_receive_,
             read_buffer_size = read_buffer_size_, write_timeout_ms = write_timeout_ms_,
             write_high_watermark_bytes = write_high_watermark_bytes_,
-            write_low_watermark_bytes = write_low_watermark_bytes_](Event::Dispatcher& dispatcher) {
+            write_low_watermark_bytes = write_low_watermark_bytes_,
+            datagram_buffer_count = datagram_buffer_count_,
+            datagram_stats = datagram_stats_](Event::Dispatcher& dispatcher) {
     return std::make_shared<IoUringWorkerImpl>(
         io_uring_size, use_submission_queue_polling, enable_multishot_receive, read_buffer_size,
-        write_timeout_ms, write_high_watermark_bytes, write_low_watermark_bytes, dispatcher);
+        write_timeout_ms, write_high_watermark_bytes, write_low_watermark_bytes, dispatcher,
+        datagram_buffer_count, datagram_stats);
   });
 }
 
@@ -3,6 +3,8 @@
 #include "envoy/common/io/io_uring.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "source/common/io/io_uring_worker_impl.h"
+
 namespace Envoy {
 namespace Io {
 
@@ -11,7 +13,9 @@ public:
   IoUringWorkerFactoryImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                            bool enable_multishot_receive, uint32_t read_buffer_size,
                            uint32_t write_timeout_ms, uint32_t write_high_watermark_bytes,
-                           uint32_t write_low_watermark_bytes, ThreadLocal::SlotAllocator& tls);
+                           uint32_t write_low_watermark_bytes, ThreadLocal::SlotAllocator& tls,
+                           uint32_t datagram_buffer_count = 0,
+                           IoUringDatagramStatsSharedPtr datagram_stats = nullptr);
 
   OptRef<IoUringWorker> getIoUringWorker() override;
 
@@ -26,6 +30,10 @@ private:
   const uint32_t write_timeout_ms_;
   const uint32_t write_high_watermark_bytes_;
   const uint32_t write_low_watermark_bytes_;
+  // The number of provided buffers for datagram receives per worker, or zero to keep datagram
+  // sockets on the socket API.
+  const uint32_t datagram_buffer_count_;
+  const IoUringDatagramStatsSharedPtr datagram_stats_;
   ThreadLocal::TypedSlot<IoUringWorker> tls_;
 };
 
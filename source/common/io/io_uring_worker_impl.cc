@@ -2,6 +2,8 @@
 
 #include <algorithm>
 
+#include "source/common/common/utility.h"
+
 namespace Envoy {
 namespace Io {
 
@@ -37,6 +39,59 @@ WriteRequest::WriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector&
   }
 }
 
+RecvmsgRequest::RecvmsgRequest(IoUringSocket& socket) : Request(RequestType::Read, socket) {
+  msg_.msg_namelen = sizeof(struct sockaddr_storage);
+  msg_.msg_controllen = DatagramControlSpace;
+}
+
+SendmsgRequest::SendmsgRequest(IoUringSocket& socket, const Buffer::RawSlice* slices,
+                               uint64_t num_slice, uint64_t length,
+                               const Network::Address::Ip* self_ip,
+                               const Network::Address::Instance& peer_address)
+    : Request(RequestType::Write, socket), buf_(std::make_unique<uint8_t[]>(length)) {
+  // The caller may release the slices as soon as the send is submitted, so copy the datagram.
+  uint64_t offset = 0;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    if (slices[i].len_ > 0) {
+      memcpy(buf_.get() + offset, slices[i].mem_, slices[i].len_);
+      offset += slices[i].len_;
+    }
+  }
+  iov_.iov_base = buf_.get();
+  iov_.iov_len = length;
+
+  memcpy(&peer_address_, peer_address.sockAddr(), peer_address.sockAddrLen());
+  msg_.msg_name = &peer_address_;
+  msg_.msg_namelen = peer_address.sockAddrLen();
+  msg_.msg_iov = &iov_;
+  msg_.msg_iovlen = 1;
+
+  if (self_ip == nullptr) {
+    return;
+  }
+  // Pin the source address the same way IoSocketHandleImpl::sendmsg does.
+  memset(control_, 0, sizeof(control_));
+  msg_.msg_control = control_;
+  if (self_ip->version() == Network::Address::IpVersion::v4) {
+    msg_.msg_controllen = CMSG_SPACE(sizeof(struct in_pktinfo));
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg_);
+    cmsg->cmsg_level = IPPROTO_IP;
+    cmsg->cmsg_type = IP_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in_pktinfo));
+    auto* pktinfo = reinterpret_cast<struct in_pktinfo*>(CMSG_DATA(cmsg));
+    pktinfo->ipi_spec_dst.s_addr = self_ip->ipv4()->address();
+  } else {
+    msg_.msg_controllen = CMSG_SPACE(sizeof(struct in6_pktinfo));
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg_);
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in6_pktinfo));
+    auto* pktinfo = reinterpret_cast<struct in6_pktinfo*>(CMSG_DATA(cmsg));
+    const absl::uint128 address = self_ip->ipv6()->address();
+    memcpy(pktinfo->ipi6_addr.s6_addr, &address, sizeof(pktinfo->ipi6_addr.s6_addr));
+  }
+}
+
 IoUringSocketEntry::IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb,
                                        bool enable_close_event)
     : fd_(fd), parent_(parent), enable_close_event_(enable_close_event), cb_(std::move(cb)) {}
@@ -81,18 +136,23 @@ IoUringWorkerImpl::IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission
                                      bool enable_multishot_receive, uint32_t read_buffer_size,
                                      uint32_t write_timeout_ms, uint32_t write_high_watermark_bytes,
                                      uint32_t write_low_watermark_bytes,
-                                     Event::Dispatcher& dispatcher)
+                                     Event::Dispatcher& dispatcher, uint32_t datagram_buffer_count,
+                                     IoUringDatagramStatsSharedPtr datagram_stats)
     : IoUringWorkerImpl(std::make_unique<IoUringImpl>(io_uring_size, use_submission_queue_polling,
-                                                      enable_multishot_receive, read_buffer_size),
+                                                      enable_multishot_receive, read_buffer_size,
+                                                      datagram_buffer_count),
                         read_buffer_size, write_timeout_ms, write_high_watermark_bytes,
-                        write_low_watermark_bytes, dispatcher) {}
+                        write_low_watermark_bytes, dispatcher, std::move(datagram_stats)) {}
 
 IoUringWorkerImpl::IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size,
                                      uint32_t write_timeout_ms, uint32_t write_high_watermark_bytes,
                                      uint32_t write_low_watermark_bytes,
-                                     Event::Dispatcher& dispatcher)
+                                     Event::Dispatcher& dispatcher,
+                                     IoUringDatagramStatsSharedPtr datagram_stats)
     : io_uring_(std::move(io_uring)), multishot_enabled_(io_uring_->isMultishotEnabled()),
-      buffer_pool_(io_uring_->bufferPool()), read_buffer_size_(read_buffer_size),
+      buffer_pool_(io_uring_->bufferPool()),
+      datagram_buffer_pool_(io_uring_->datagramBufferPool()),
+      datagram_stats_(std::move(datagram_stats)), read_buffer_size_(read_buffer_size),
       write_timeout_ms_(write_timeout_ms), write_high_watermark_bytes_(write_high_watermark_bytes),
       write_low_watermark_bytes_(write_low_watermark_bytes), dispatcher_(dispatcher) {
   const os_fd_t event_fd = io_uring_->registerEventfd();
@@ -157,6 +217,16 @@ IoUringSocket& IoUringWorkerImpl::addClientSocket(os_fd_t fd, Event::FileReadyCb
   return addSocket(std::move(socket));
 }
 
+IoUringDatagramSocket& IoUringWorkerImpl::addDatagramSocket(os_fd_t fd, Event::FileReadyCb cb) {
+  ENVOY_LOG(trace, "add datagram socket, fd = {}", fd);
+  ASSERT(isDatagramEnabled());
+  std::unique_ptr<IoUringDatagramSocketImpl> socket =
+      std::make_unique<IoUringDatagramSocketImpl>(fd, *this, std::move(cb));
+  IoUringDatagramSocketImpl& datagram_socket = *socket;
+  addSocket(std::move(socket));
+  return datagram_socket;
+}
+
 Event::Dispatcher& IoUringWorkerImpl::dispatcher() { return dispatcher_; }
 
 IoUringSocketEntry& IoUringWorkerImpl::addSocket(IoUringSocketEntryPtr&& socket) {
@@ -235,6 +305,44 @@ Request* IoUringWorkerImpl::submitWriteRequest(IoUringSocket& socket,
   return req;
 }
 
+Request* IoUringWorkerImpl::submitRecvmsgMultishotRequest(IoUringSocket& socket) {
+  RecvmsgRequest* req = new RecvmsgRequest(socket);
+
+  ENVOY_LOG(trace, "submit recvmsg multishot request, fd = {}, req = {}", socket.fd(),
+            fmt::ptr(req));
+
+  auto res = io_uring_->prepareRecvmsgMultishot(socket.fd(), &req->msg_, req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareRecvmsgMultishot(socket.fd(), &req->msg_, req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare recvmsg multishot");
+  }
+  submit();
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitSendmsgRequest(IoUringSocket& socket,
+                                                 const Buffer::RawSlice* slices,
+                                                 uint64_t num_slice, uint64_t length,
+                                                 const Network::Address::Ip* self_ip,
+                                                 const Network::Address::Instance& peer_address) {
+  SendmsgRequest* req =
+      new SendmsgRequest(socket, slices, num_slice, length, self_ip, peer_address);
+
+  ENVOY_LOG(trace, "submit sendmsg request, fd = {}, req = {}", socket.fd(), fmt::ptr(req));
+
+  auto res = io_uring_->prepareSendmsg(socket.fd(), &req->msg_, req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareSendmsg(socket.fd(), &req->msg_, req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare sendmsg");
+  }
+  submit();
+  return req;
+}
+
 Request* IoUringWorkerImpl::submitCloseRequest(IoUringSocket& socket) {
   Request* req = new Request(Request::RequestType::Close, socket);
 
@@ -298,9 +406,60 @@ void IoUringWorkerImpl::injectCompletion(IoUringSocket& socket, Request::Request
   file_event_->activate(Event::FileReadyType::Read);
 }
 
+uint8_t* IoUringWorkerImpl::takeDatagramBuffer(uint32_t buffer_id) {
+  datagram_buffers_held_++;
+  return datagram_buffer_pool_->getBuffer(buffer_id);
+}
+
+void IoUringWorkerImpl::releaseDatagramBuffer(const void* buffer) {
+  ASSERT(datagram_buffers_held_ > 0);
+  datagram_buffers_held_--;
+  datagram_buffer_pool_->releaseBuffer(buffer);
+  if (stalled_datagram_sockets_.empty()) {
+    return;
+  }
+  // A stalled socket may be stalled again by the time its receive completes, in which case it is
+  // added back.
+  std::list<IoUringDatagramSocketImpl*> stalled;
+  stalled.swap(stalled_datagram_sockets_);
+  for (IoUringDatagramSocketImpl* socket : stalled) {
+    socket->resumeRecv();
+  }
+}
+
+void IoUringWorkerImpl::addStalledDatagramSocket(IoUringDatagramSocketImpl& socket) {
+  stalled_datagram_sockets_.push_back(&socket);
+}
+
+void IoUringWorkerImpl::removeStalledDatagramSocket(IoUringDatagramSocketImpl& socket) {
+  stalled_datagram_sockets_.remove(&socket);
+}
+
+void IoUringWorkerImpl::onDatagramReceived(bool truncated) {
+  datagrams_in_batch_++;
+  if (datagram_stats_ != nullptr) {
+    datagram_stats_->udp_rx_datagrams_.inc();
+    if (truncated) {
+      datagram_stats_->udp_rx_truncated_.inc();
+    }
+  }
+}
+
+void IoUringWorkerImpl::onDatagramSent(int32_t result) {
+  if (datagram_stats_ == nullptr) {
+    return;
+  }
+  if (result >= 0) {
+    datagram_stats_->udp_tx_datagrams_.inc();
+  } else if (result != -ECANCELED) {
+    datagram_stats_->udp_tx_errors_.inc();
+  }
+}
+
 void IoUringWorkerImpl::onFileEvent() {
   ENVOY_LOG(trace, "io uring worker, on file event");
   delay_submit_ = true;
+  datagrams_in_batch_ = 0;
   io_uring_->forEveryCompletion([](Request* req, int32_t result, bool injected) {
     ENVOY_LOG(trace, "receive request completion, type = {}, req = {}",
               static_cast<uint8_t>(req->type()), fmt::ptr(req));
@@ -353,6 +512,12 @@ void IoUringWorkerImpl::onFileEvent() {
   delay_submit_ = false;
   submit();
 
+  // The datagrams of a batch are received without any system call on the receive path, so this is
+  // the io_uring counterpart of the datagrams returned by a single recvmmsg.
+  if (datagrams_in_batch_ > 0 && datagram_stats_ != nullptr) {
+    datagram_stats_->udp_rx_datagrams_per_batch_.recordValue(datagrams_in_batch_);
+  }
+
   // forEveryCompletion reaps a bounded batch, so a burst that exceeds it (for example many
   // `multishot` completions) leaves entries in the completion queue. The eventfd is edge-triggered
   // and already drained, so re-arm the read event to reap the rest on the next loop iteration
@@ -821,6 +986,267 @@ void IoUringServerSocket::checkWriteWatermarks() {
   }
 }
 
+IoUringDatagramSocketImpl::IoUringDatagramSocketImpl(os_fd_t fd, IoUringWorkerImpl& parent,
+                                                     Event::FileReadyCb cb)
+    : IoUringSocketEntry(fd, parent, std::move(cb), false) {}
+
+IoUringDatagramSocketImpl::~IoUringDatagramSocketImpl() {
+  if (recv_stalled_) {
+    parent_.removeStalledDatagramSocket(*this);
+  }
+  releaseDatagrams();
+}
+
+void IoUringDatagramSocketImpl::close(bool keep_fd_open, IoUringSocketOnClosedCb cb) {
+  ENVOY_LOG(trace, "close the datagram socket, fd = {}, status = {}", fd_,
+            static_cast<int>(status_));
+
+  IoUringSocketEntry::close(keep_fd_open, cb);
+  keep_fd_open_ = keep_fd_open;
+  if (recv_stalled_) {
+    recv_stalled_ = false;
+    parent_.removeStalledDatagramSocket(*this);
+  }
+  // Datagrams that were received but not yet read are dropped, as they would be when closing a
+  // socket with a non-empty receive queue.
+  releaseDatagrams();
+  if (recv_req_ != nullptr && recv_cancel_req_ == nullptr) {
+    ENVOY_LOG(trace, "cancel the recvmsg request, fd = {}", fd_);
+    recv_cancel_req_ = parent_.submitCancelRequest(*this, recv_req_);
+  }
+  maybeCloseInternal();
+}
+
+void IoUringDatagramSocketImpl::enableRead() {
+  IoUringSocketEntry::enableRead();
+  ENVOY_LOG(trace, "enable read, fd = {}", fd_);
+
+  if (recv_req_ == nullptr && !recv_stalled_ && recv_error_ == 0) {
+    submitRecvRequest();
+  }
+  // Deliver the datagrams queued while the read was disabled, or the receive error.
+  if (!datagrams_.empty() || recv_error_ != 0) {
+    injectCompletion(Request::RequestType::Read);
+  }
+}
+
+void IoUringDatagramSocketImpl::onClose(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onClose(req, result, injected);
+  ASSERT(!injected);
+  cleanup();
+}
+
+void IoUringDatagramSocketImpl::onRead(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onRead(req, result, injected);
+
+  ENVOY_LOG(trace, "onRead with result {}, fd = {}, injected = {}, status_ = {}", result, fd_,
+            injected, static_cast<int>(status_));
+
+  if (injected) {
+    if (status_ == ReadEnabled) {
+      THROW_IF_NOT_OK(cb_(Event::FileReadyType::Read));
+    }
+    return;
+  }
+
+  // The `multishot` recvmsg stays armed across completions, so only forget the request once the
+  // kernel signals it will deliver no more completions for it.
+  if (!req->moreCompletions()) {
+    recv_req_ = nullptr;
+  }
+
+  if (result > 0) {
+    queueDatagram(req, result);
+  } else if (result == -ENOBUFS) {
+    // Every buffer of the worker holds a datagram that has not been read yet. Stop receiving and
+    // let the kernel queue new datagrams on the socket until any socket of the worker releases a
+    // buffer. If the worker holds none, they were all released before this completion was
+    // processed, so the receive is re-armed right away.
+    if (recv_req_ == nullptr && status_ != Closed && !recv_stalled_ &&
+        parent_.datagramBuffersHeld() > 0) {
+      recv_stalled_ = true;
+      parent_.addStalledDatagramSocket(*this);
+    }
+  } else if (result == -EINVAL || result == -EOPNOTSUPP || result == -EBADF ||
+             result == -ENOTSOCK) {
+    // The datagram buffer pool is only used once `multishot` recvmsg was probed to be supported, so
+    // this socket cannot receive through the io_uring. Report the error to the handler rather than
+    // silently dropping its datagrams.
+    ENVOY_LOG(error, "io_uring recvmsg failed, no more datagrams are received, fd = {}, error = {}",
+              fd_, errorDetails(-result));
+    recv_error_ = -result;
+  } else if (result != -ECANCELED) {
+    ENVOY_LOG(debug, "io_uring recvmsg failed, fd = {}, error = {}", fd_, errorDetails(-result));
+  }
+
+  if (status_ == Closed) {
+    maybeCloseInternal();
+    return;
+  }
+
+  // Re-arm a `multishot` recvmsg the kernel ended, for example after a transient error.
+  if (recv_req_ == nullptr && !recv_stalled_ && recv_error_ == 0 && status_ != Initialized) {
+    submitRecvRequest();
+  }
+
+  // Deliver a single read event for all the datagrams received in this completion batch.
+  if (status_ == ReadEnabled && (!datagrams_.empty() || recv_error_ != 0)) {
+    injectCompletion(Request::RequestType::Read);
+  }
+}
+
+void IoUringDatagramSocketImpl::onWrite(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onWrite(req, result, injected);
+
+  ENVOY_LOG(trace, "onWrite with result {}, fd = {}, injected = {}, status_ = {}", result, fd_,
+            injected, static_cast<int>(status_));
+
+  if (injected) {
+    if (status_ != Closed) {
+      THROW_IF_NOT_OK(cb_(Event::FileReadyType::Write));
+    }
+    return;
+  }
+
+  ASSERT(sends_in_flight_ > 0);
+  sends_in_flight_--;
+  parent_.onDatagramSent(result);
+  if (result < 0 && result != -ECANCELED) {
+    // Like an unconnected UDP socket, send errors are not surfaced to the handler.
+    ENVOY_LOG(debug, "io_uring sendmsg failed, fd = {}, error = {}", fd_, errorDetails(-result));
+  }
+
+  if (status_ == Closed) {
+    maybeCloseInternal();
+    return;
+  }
+
+  if (send_blocked_ && sends_in_flight_ <= MaxSendsInFlight / 2) {
+    send_blocked_ = false;
+    injectCompletion(Request::RequestType::Write);
+  }
+}
+
+void IoUringDatagramSocketImpl::onCancel(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onCancel(req, result, injected);
+  ASSERT(!injected);
+  if (recv_cancel_req_ == req) {
+    recv_cancel_req_ = nullptr;
+  }
+  if (status_ == Closed) {
+    maybeCloseInternal();
+  }
+}
+
+const ReceivedDatagram* IoUringDatagramSocketImpl::frontDatagram() const {
+  return datagrams_.empty() ? nullptr : &datagrams_.front().datagram_;
+}
+
+void IoUringDatagramSocketImpl::popDatagram() {
+  ASSERT(!datagrams_.empty());
+  uint8_t* buffer = datagrams_.front().buffer_;
+  datagrams_.pop_front();
+  parent_.releaseDatagramBuffer(buffer);
+}
+
+void IoUringDatagramSocketImpl::resumeRecv() {
+  ASSERT(recv_stalled_ && recv_req_ == nullptr && status_ != Closed);
+  recv_stalled_ = false;
+  submitRecvRequest();
+}
+
+uint64_t IoUringDatagramSocketImpl::sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice,
+                                            const Network::Address::Ip* self_ip,
+                                            const Network::Address::Instance& peer_address) {
+  ASSERT(status_ != Closed);
+  if (send_blocked_) {
+    return 0;
+  }
+  if (sends_in_flight_ >= MaxSendsInFlight) {
+    ENVOY_LOG(trace, "too many sends in flight, apply write backpressure, fd = {}", fd_);
+    send_blocked_ = true;
+    return 0;
+  }
+
+  uint64_t length = 0;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    length += slices[i].len_;
+  }
+  parent_.submitSendmsgRequest(*this, slices, num_slice, length, self_ip, peer_address);
+  sends_in_flight_++;
+  return length;
+}
+
+void IoUringDatagramSocketImpl::submitRecvRequest() {
+  ASSERT(recv_req_ == nullptr);
+  recv_req_ = parent_.submitRecvmsgMultishotRequest(*this);
+}
+
+void IoUringDatagramSocketImpl::queueDatagram(Request* req, int32_t result) {
+  const int32_t buffer_id = req->bufferId();
+  if (!multishotBufferIdValid(buffer_id)) {
+    return;
+  }
+  uint8_t* buffer = parent_.takeDatagramBuffer(buffer_id);
+  if (status_ == Closed) {
+    parent_.releaseDatagramBuffer(buffer);
+    return;
+  }
+
+  struct msghdr* msg = &static_cast<RecvmsgRequest*>(req)->msg_;
+  struct io_uring_recvmsg_out* out = io_uring_recvmsg_validate(buffer, result, msg);
+  if (out == nullptr) {
+    IS_ENVOY_BUG(fmt::format("invalid recvmsg completion of {} bytes", result));
+    parent_.releaseDatagramBuffer(buffer);
+    return;
+  }
+
+  QueuedDatagram& queued = datagrams_.emplace_back();
+  queued.buffer_ = buffer;
+  struct msghdr& hdr = queued.datagram_.hdr_;
+  hdr = {};
+  hdr.msg_name = io_uring_recvmsg_name(out);
+  hdr.msg_namelen = out->namelen;
+  hdr.msg_control = static_cast<uint8_t*>(io_uring_recvmsg_name(out)) + msg->msg_namelen;
+  hdr.msg_controllen = out->controllen;
+  hdr.msg_flags = static_cast<int>(out->flags);
+  queued.datagram_.payload_ = static_cast<const uint8_t*>(io_uring_recvmsg_payload(out, msg));
+  queued.datagram_.payload_length_ = io_uring_recvmsg_payload_length(out, result, msg);
+  parent_.onDatagramReceived((out->flags & MSG_TRUNC) != 0);
+}
+
+void IoUringDatagramSocketImpl::releaseDatagrams() {
+  if (datagrams_.empty()) {
+    return;
+  }
+  std::deque<QueuedDatagram> datagrams;
+  datagrams.swap(datagrams_);
+  for (const QueuedDatagram& queued : datagrams) {
+    parent_.releaseDatagramBuffer(queued.buffer_);
+  }
+}
+
+void IoUringDatagramSocketImpl::maybeCloseInternal() {
+  if (recv_req_ == nullptr && recv_cancel_req_ == nullptr && sends_in_flight_ == 0) {
+    closeInternal();
+  }
+}
+
+void IoUringDatagramSocketImpl::closeInternal() {
+  if (keep_fd_open_) {
+    if (on_closed_cb_) {
+      // Datagram sockets have no byte stream to hand over.
+      Buffer::OwnedImpl empty_buffer;
+      on_closed_cb_(empty_buffer);
+    }
+    cleanup();
+    return;
+  }
+  if (close_req_ == nullptr) {
+    close_req_ = parent_.submitCloseRequest(*this);
+  }
+}
+
 IoUringClientSocket::IoUringClientSocket(os_fd_t fd, IoUringWorkerImpl& parent,
                                          Event::FileReadyCb cb, uint32_t write_timeout_ms,
                                          uint32_t write_high_watermark_bytes,
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <deque>
+
 #include "envoy/common/io/io_uring.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/linked_object.h"
@@ -29,18 +32,64 @@ public:
   absl::InlinedVector<struct iovec, 16> iov_;
 };
 
+class RecvmsgRequest : public Request {
+public:
+  explicit RecvmsgRequest(IoUringSocket& socket);
+
+  // Reserves the space for the source address and the control messages in each provided buffer.
+  struct msghdr msg_{};
+};
+
+class SendmsgRequest : public Request {
+public:
+  SendmsgRequest(IoUringSocket& socket, const Buffer::RawSlice* slices, uint64_t num_slice,
+                 uint64_t length, const Network::Address::Ip* self_ip,
+                 const Network::Address::Instance& peer_address);
+
+  std::unique_ptr<uint8_t[]> buf_;
+  struct iovec iov_;
+  struct sockaddr_storage peer_address_;
+  // Large enough for either an IPv4 or an IPv6 packet info message.
+  alignas(struct cmsghdr) char control_[CMSG_SPACE(sizeof(struct in6_pktinfo))];
+  struct msghdr msg_{};
+};
+
+/**
+ * All io_uring datagram stats. @see stats_macros.h
+ */
+#define ALL_IO_URING_DATAGRAM_STATS(COUNTER, HISTOGRAM)                                            \
+  COUNTER(udp_rx_datagrams)                                                                        \
+  COUNTER(udp_rx_truncated)                                                                        \
+  COUNTER(udp_tx_datagrams)                                                                        \
+  COUNTER(udp_tx_errors)                                                                           \
+  HISTOGRAM(udp_rx_datagrams_per_batch, Unspecified)
+
+/**
+ * Struct definition for all io_uring datagram stats. @see stats_macros.h
+ */
+struct IoUringDatagramStats {
+  ALL_IO_URING_DATAGRAM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+using IoUringDatagramStatsSharedPtr = std::shared_ptr<IoUringDatagramStats>;
+
 class IoUringSocketEntry;
 using IoUringSocketEntryPtr = std::unique_ptr<IoUringSocketEntry>;
 
+class IoUringDatagramSocketImpl;
+
 class IoUringWorkerImpl : public IoUringWorker, private Logger::Loggable<Logger::Id::io> {
 public:
   IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                     bool enable_multishot_receive, uint32_t read_buffer_size,
                     uint32_t write_timeout_ms, uint32_t write_high_watermark_bytes,
-                    uint32_t write_low_watermark_bytes, Event::Dispatcher& dispatcher);
+                    uint32_t write_low_watermark_bytes, Event::Dispatcher& dispatcher,
+                    uint32_t datagram_buffer_count = 0,
+                    IoUringDatagramStatsSharedPtr datagram_stats = nullptr);
   IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size, uint32_t write_timeout_ms,
                     uint32_t write_high_watermark_bytes, uint32_t write_low_watermark_bytes,
-                    Event::Dispatcher& dispatcher);
+                    Event::Dispatcher& dispatcher,
+                    IoUringDatagramStatsSharedPtr datagram_stats = nullptr);
   ~IoUringWorkerImpl() override;
 
   // IoUringWorker
@@ -50,6 +99,8 @@ public:
                                  bool enable_close_event) override;
   IoUringSocket& addClientSocket(os_fd_t fd, Event::FileReadyCb cb,
                                  bool enable_close_event) override;
+  IoUringDatagramSocket& addDatagramSocket(os_fd_t fd, Event::FileReadyCb cb) override;
+  bool isDatagramEnabled() const override { return datagram_buffer_pool_ != nullptr; }
 
   Request* submitConnectRequest(IoUringSocket& socket,
                                 const Network::Address::InstanceConstSharedPtr& address) override;
@@ -59,6 +110,13 @@ public:
   // Submit a `multishot` read request that draws buffers from the provided buffer pool.
   Request* submitReadMultishotRequest(IoUringSocket& socket);
   Request* submitWriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices) override;
+  // Submit a `multishot` recvmsg request that draws buffers from the datagram buffer pool.
+  Request* submitRecvmsgMultishotRequest(IoUringSocket& socket);
+  // Submit a sendmsg request carrying a copy of the datagram in the slices.
+  Request* submitSendmsgRequest(IoUringSocket& socket, const Buffer::RawSlice* slices,
+                                uint64_t num_slice, uint64_t length,
+                                const Network::Address::Ip* self_ip,
+                                const Network::Address::Instance& peer_address);
   Request* submitCloseRequest(IoUringSocket& socket) override;
   Request* submitCancelRequest(IoUringSocket& socket, Request* request_to_cancel) override;
   Request* submitShutdownRequest(IoUringSocket& socket, int how) override;
@@ -83,6 +141,26 @@ public:
   // The provided buffer pool used for `multishot` reads, or nullptr when `multishot` reads are not
   // available. Cached at construction to avoid a virtual call on each read completion.
   const IoUringBufferPoolSharedPtr& bufferPool() const { return buffer_pool_; }
+  // The provided buffer pool used for datagram receives, or nullptr when datagram receives are not
+  // available.
+  const IoUringBufferPoolSharedPtr& datagramBufferPool() const { return datagram_buffer_pool_; }
+  // Take the datagram buffer with the given id, which the kernel filled for a receive completion.
+  uint8_t* takeDatagramBuffer(uint32_t buffer_id);
+  // The number of datagram buffers taken but not released yet.
+  uint32_t datagramBuffersHeld() const { return datagram_buffers_held_; }
+  // Return a buffer to the datagram buffer pool. The pool is shared by all the datagram sockets of
+  // this worker, so every socket that stopped receiving because it was exhausted is resumed.
+  void releaseDatagramBuffer(const void* buffer);
+  // Track a datagram socket that stopped receiving because the datagram buffer pool was exhausted,
+  // until a buffer is released or the socket is closed.
+  void addStalledDatagramSocket(IoUringDatagramSocketImpl& socket);
+  void removeStalledDatagramSocket(IoUringDatagramSocketImpl& socket);
+
+  // Record a received datagram, counted towards the datagrams received in the current completion
+  // batch.
+  void onDatagramReceived(bool truncated);
+  // Record the completion of a datagram send.
+  void onDatagramSent(int32_t result);
 
 protected:
   // Add a socket to the worker.
@@ -98,6 +176,16 @@ protected:
   // The provided buffer pool used for `multishot` reads, cached once at construction. Null when
   // `multishot` reads are not available.
   const IoUringBufferPoolSharedPtr buffer_pool_;
+  // The provided buffer pool used for datagram receives, cached once at construction. Null when
+  // datagram receives are not available.
+  const IoUringBufferPoolSharedPtr datagram_buffer_pool_;
+  // Shared by the workers of all threads. Null when no stats scope was provided.
+  const IoUringDatagramStatsSharedPtr datagram_stats_;
+  // The number of datagrams received in the completion batch being processed.
+  uint64_t datagrams_in_batch_{0};
+  uint32_t datagram_buffers_held_{0};
+  // The datagram sockets waiting for a buffer to be released to the datagram buffer pool.
+  std::list<IoUringDatagramSocketImpl*> stalled_datagram_sockets_;
   const uint32_t read_buffer_size_;
   const uint32_t write_timeout_ms_;
   const uint32_t write_high_watermark_bytes_;
@@ -296,6 +384,72 @@ protected:
   void checkWriteWatermarks();
 };
 
+/**
+ * A datagram socket, such as a UDP listener socket. A single `multishot` recvmsg stays armed and
+ * received datagrams are queued until the handler pops them. Sends are copied into their own
+ * requests, so several can be in flight at once up to a fixed bound.
+ */
+class IoUringDatagramSocketImpl : public IoUringSocketEntry, public IoUringDatagramSocket {
+public:
+  IoUringDatagramSocketImpl(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb);
+  ~IoUringDatagramSocketImpl() override;
+
+  // IoUringSocket
+  void close(bool keep_fd_open, IoUringSocketOnClosedCb cb = nullptr) override;
+  void enableRead() override;
+  void write(Buffer::Instance&) override { PANIC("not implemented"); }
+  uint64_t write(const Buffer::RawSlice*, uint64_t) override { PANIC("not implemented"); }
+  void shutdown(int) override { PANIC("not implemented"); }
+  void onClose(Request* req, int32_t result, bool injected) override;
+  void onRead(Request* req, int32_t result, bool injected) override;
+  void onWrite(Request* req, int32_t result, bool injected) override;
+  void onCancel(Request* req, int32_t result, bool injected) override;
+
+  // IoUringDatagramSocket
+  IoUringSocket& ioUringSocket() override { return *this; }
+  const ReceivedDatagram* frontDatagram() const override;
+  void popDatagram() override;
+  int recvError() const override { return recv_error_; }
+  uint64_t sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice,
+                   const Network::Address::Ip* self_ip,
+                   const Network::Address::Instance& peer_address) override;
+
+  // The maximum number of sends in flight before the socket applies write backpressure.
+  static constexpr uint32_t MaxSendsInFlight = 256;
+
+  // Re-arm the receive that stopped because the datagram buffer pool was exhausted.
+  void resumeRecv();
+
+private:
+  struct QueuedDatagram {
+    ReceivedDatagram datagram_;
+    // The provided buffer holding the datagram, returned to the pool when the datagram is popped.
+    uint8_t* buffer_;
+  };
+
+  void submitRecvRequest();
+  void queueDatagram(Request* req, int32_t result);
+  void releaseDatagrams();
+  void maybeCloseInternal();
+  void closeInternal();
+
+  std::deque<QueuedDatagram> datagrams_;
+  Request* recv_req_{nullptr};
+  Request* recv_cancel_req_{nullptr};
+  Request* close_req_{nullptr};
+  uint32_t sends_in_flight_{0};
+  // Set when a send was refused because too many sends were in flight. A write event is delivered
+  // once half of them have completed.
+  bool send_blocked_{false};
+  // Set when the `multishot` recvmsg ended because the datagram buffer pool was exhausted. It is
+  // re-armed once any socket of the worker releases a buffer.
+  bool recv_stalled_{false};
+  // The errno with which the kernel rejected the `multishot` recvmsg. No more receives are
+  // submitted once it is set, and it is reported to the handler.
+  int recv_error_{0};
+  bool keep_fd_open_{false};
+};
+
 class IoUringClientSocket : public IoUringServerSocket {
 public:
   IoUringClientSocket(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb,
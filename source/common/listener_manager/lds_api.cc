@@ -15,6 +15,7 @@
 #include "source/common/grpc/common.h"
 #include "source/common/protobuf/utility.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/strings/str_join.h"
 
@@ -31,10 +32,22 @@ LdsApiImpl::LdsApiImpl(const envoy::config::core::v3::ConfigSource& lds_config,
       init_target_("LDS", [this]() { subscription_->start({}); }) {
   const auto resource_name = resource_type_helper_.getResourceName();
   if (lds_resources_locator == nullptr) {
+    Config::SubscriptionOptions options;
+    options.skip_unchanged_resources_ = true;
+    // Listeners can be removed without LDS asking for it, e.g. when they fail warming, so unchanged
+    // listeners are skipped only while the listener manager still has them.
+    options.current_resource_names_ = [this]() {
+      absl::flat_hash_set<std::string> names;
+      for (const auto& listener :
+           listener_manager_.listeners(ListenerManager::WARMING | ListenerManager::ACTIVE)) {
+        names.insert(listener.get().name());
+      }
+      return names;
+    };
     subscription_ =
         THROW_OR_RETURN_VALUE(cm.subscriptionFactory().subscriptionFromConfigSource(
                                   lds_config, Grpc::Common::typeUrl(resource_name), *scope_, *this,
-                                  resource_type_helper_.resourceDecoder(), {}),
+                                  resource_type_helper_.resourceDecoder(), options),
                               Config::SubscriptionPtr);
   } else {
     subscription_ =
@@ -689,7 +689,9 @@ bool ListenerImpl::buildUdpListenerWorkerRouter(const Network::Address::Instance
     return false;
   }
   udp_listener_config_->listener_worker_routers_.emplace(
-      address.asString(), std::make_unique<Network::UdpListenerWorkerRouterImpl>(concurrency));
+      address.asString(), std::make_unique<Network::UdpListenerWorkerRouterImpl>(
+                              concurrency, listener_factory_context_->listenerScope(),
+                              parent_.server_.timeSource()));
   return true;
 }
 
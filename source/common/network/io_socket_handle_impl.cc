@@ -15,6 +15,12 @@
 
 #include "absl/container/fixed_array.h"
 
+#if defined(__linux__)
+#include <fcntl.h>
+
+#include "source/common/api/os_sys_calls_impl_linux.h"
+#endif
+
 using Envoy::Api::SysCallIntResult;
 using Envoy::Api::SysCallSizeResult;
 
@@ -379,48 +385,54 @@ Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
                  fmt::format("Unable to get remote address from recvmsg() for fd: {}", fd_));
   output.msg_[0].peer_address_ = getOrCreateEnvoyAddressInstance(peer_addr, hdr.msg_namelen);
   output.msg_[0].gso_size_ = 0;
+  processRecvMsgControl(hdr, self_port, save_cmsg_config, output, 0);
 
-  if (hdr.msg_controllen > 0) {
-    // Get overflow, local address and gso_size from control message.
-    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
-         cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
-      if (save_cmsg_config.hasConfig() &&
-          cmsg->cmsg_type == static_cast<int>(save_cmsg_config.type.value()) &&
-          cmsg->cmsg_level == static_cast<int>(save_cmsg_config.level.value())) {
-        Buffer::OwnedImpl cmsg_slice{CMSG_DATA(cmsg), cmsg->cmsg_len};
-        output.msg_[0].saved_cmsg_ = std::move(cmsg_slice);
-      }
-      if (output.msg_[0].local_address_ == nullptr) {
-        Address::InstanceConstSharedPtr addr = maybeGetDstAddressFromHeader(*cmsg, self_port);
-        if (addr != nullptr) {
-          // This is a IP packet info message.
-          output.msg_[0].local_address_ = std::move(addr);
-          continue;
-        }
+  return sysCallResultToIoCallResult(result);
+}
+
+void IoSocketHandleImpl::processRecvMsgControl(msghdr& hdr, uint32_t self_port,
+                                               const UdpSaveCmsgConfig& save_cmsg_config,
+                                               RecvMsgOutput& output, size_t index) {
+  if (hdr.msg_controllen == 0) {
+    return;
+  }
+  // Get overflow, local address and gso_size from control message.
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+    if (save_cmsg_config.hasConfig() &&
+        cmsg->cmsg_type == static_cast<int>(save_cmsg_config.type.value()) &&
+        cmsg->cmsg_level == static_cast<int>(save_cmsg_config.level.value())) {
+      Buffer::OwnedImpl cmsg_slice{CMSG_DATA(cmsg), cmsg->cmsg_len};
+      output.msg_[index].saved_cmsg_ = std::move(cmsg_slice);
+    }
+    if (output.msg_[index].local_address_ == nullptr) {
+      Address::InstanceConstSharedPtr addr = maybeGetDstAddressFromHeader(*cmsg, self_port);
+      if (addr != nullptr) {
+        // This is a IP packet info message.
+        output.msg_[index].local_address_ = std::move(addr);
+        continue;
       }
-      if (output.dropped_packets_ != nullptr) {
-        std::optional<uint32_t> maybe_dropped = maybeGetPacketsDroppedFromHeader(*cmsg);
-        if (maybe_dropped) {
-          *output.dropped_packets_ = *maybe_dropped;
-          continue;
-        }
+    }
+    if (output.dropped_packets_ != nullptr) {
+      std::optional<uint32_t> maybe_dropped = maybeGetPacketsDroppedFromHeader(*cmsg);
+      if (maybe_dropped) {
+        *output.dropped_packets_ = *maybe_dropped;
+        continue;
       }
+    }
 #ifdef UDP_GRO
-      if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
-        std::optional<uint16_t> maybe_gso = maybeGetUnsignedIntFromHeader<uint16_t>(*cmsg);
-        if (maybe_gso) {
-          output.msg_[0].gso_size_ = *maybe_gso;
-        }
+    if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+      std::optional<uint16_t> maybe_gso = maybeGetUnsignedIntFromHeader<uint16_t>(*cmsg);
+      if (maybe_gso) {
+        output.msg_[index].gso_size_ = *maybe_gso;
       }
+    }
 #endif
-      std::optional<uint8_t> maybe_tos = maybeGetTosFromHeader(*cmsg);
-      if (maybe_tos) {
-        output.msg_[0].tos_ = *maybe_tos;
-      }
+    std::optional<uint8_t> maybe_tos = maybeGetTosFromHeader(*cmsg);
+    if (maybe_tos) {
+      output.msg_[index].tos_ = *maybe_tos;
     }
   }
-
-  return sysCallResultToIoCallResult(result);
 }
 
 Api::IoCallUint64Result IoSocketHandleImpl::recvmmsg(RawSliceArrays& slices, uint32_t self_port,
@@ -536,6 +548,29 @@ Api::IoCallUint64Result IoSocketHandleImpl::recv(void* buffer, size_t length, in
   return sysCallResultToIoCallResult(result);
 }
 
+bool IoSocketHandleImpl::supportsSplice() const {
+#if defined(__linux__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+Api::IoCallUint64Result IoSocketHandleImpl::splice(os_fd_t pipe_fd, bool from_handle,
+                                                   uint64_t max_length) {
+#if defined(__linux__)
+  const Api::SysCallSizeResult result = Api::LinuxOsSysCallsSingleton::get().splice(
+      from_handle ? fd_ : pipe_fd, from_handle ? pipe_fd : fd_, max_length,
+      SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+  return sysCallResultToIoCallResult(result);
+#else
+  UNREFERENCED_PARAMETER(pipe_fd);
+  UNREFERENCED_PARAMETER(from_handle);
+  UNREFERENCED_PARAMETER(max_length);
+  return {0, IoSocketError::create(SOCKET_ERROR_NOT_SUP)};
+#endif
+}
+
 Api::SysCallIntResult IoSocketHandleImpl::bind(Address::InstanceConstSharedPtr address) {
   return Api::OsSysCallsSingleton::get().bind(fd_, address->sockAddr(), address->sockAddrLen());
 }
@@ -62,6 +62,8 @@ public:
                                    const UdpSaveCmsgConfig& save_cmsg_config,
                                    RecvMsgOutput& output) override;
   Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
+  bool supportsSplice() const override;
+  Api::IoCallUint64Result splice(os_fd_t pipe_fd, bool from_handle, uint64_t max_length) override;
 
   Api::SysCallIntResult bind(Address::InstanceConstSharedPtr address) override;
   Api::SysCallIntResult listen(int backlog) override;
@@ -107,15 +109,22 @@ protected:
 
   size_t addressCacheMaxSize() const { return address_cache_max_capacity_; }
 
+  Address::InstanceConstSharedPtr getOrCreateEnvoyAddressInstance(sockaddr_storage ss,
+                                                                  socklen_t ss_len);
+
+  // Fills the destination address, the dropped packet count, the GRO segment size, the TOS byte
+  // and the saved control message of the packet at `index` in `output` from the control messages
+  // of a received header.
+  void processRecvMsgControl(msghdr& hdr, uint32_t self_port,
+                             const UdpSaveCmsgConfig& save_cmsg_config, RecvMsgOutput& output,
+                             size_t index);
+
 private:
   // Returns the destination address if the control message carries it.
   // Otherwise returns nullptr.
   Address::InstanceConstSharedPtr maybeGetDstAddressFromHeader(const cmsghdr& cmsg,
                                                                uint32_t self_port);
 
-  Address::InstanceConstSharedPtr getOrCreateEnvoyAddressInstance(sockaddr_storage ss,
-                                                                  socklen_t ss_len);
-
   // Caches the address instances of the most recently received packets on this socket.
   // Should only be used by QUIC client sockets to avoid creating multiple address instances for
   // the same address in each read operation. Since the QUIC client sockets are connected via a
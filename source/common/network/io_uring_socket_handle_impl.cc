@@ -182,6 +182,11 @@ Api::IoCallUint64Result IoUringSocketHandleImpl::recv(void* buffer, size_t lengt
   return copyOut(length, &slice, 1);
 }
 
+Api::IoCallUint64Result IoUringSocketHandleImpl::splice(os_fd_t, bool, uint64_t) {
+  // The data of the socket is read by the io_uring worker, so it cannot be spliced.
+  return {0, IoSocketError::create(SOCKET_ERROR_NOT_SUP)};
+}
+
 Api::SysCallIntResult IoUringSocketHandleImpl::bind(Address::InstanceConstSharedPtr address) {
   ENVOY_LOG(trace, "bind {}, fd = {}, io_uring_socket_type = {}", address->asString(), fd_,
             ioUringSocketTypeStr());
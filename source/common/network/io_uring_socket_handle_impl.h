@@ -52,6 +52,8 @@ public:
                                    const IoHandle::UdpSaveCmsgConfig& udp_save_cmsg_config,
                                    RecvMsgOutput& output) override;
   Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
+  bool supportsSplice() const override { return false; }
+  Api::IoCallUint64Result splice(os_fd_t pipe_fd, bool from_handle, uint64_t max_length) override;
   Api::SysCallIntResult bind(Address::InstanceConstSharedPtr address) override;
   Api::SysCallIntResult listen(int backlog) override;
   IoHandlePtr accept(struct sockaddr* addr, socklen_t* addrlen) override;
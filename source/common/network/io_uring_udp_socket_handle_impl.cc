@@ -0,0 +1,233 @@
+#include "source/common/network/io_uring_udp_socket_handle_impl.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+#include "source/common/network/io_socket_error_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+IoUringUdpSocketHandleImpl::IoUringUdpSocketHandleImpl(
+    Io::IoUringWorkerFactory& io_uring_worker_factory, os_fd_t fd, bool socket_v6only,
+    std::optional<int> domain, size_t address_cache_max_capacity)
+    : IoSocketHandleImpl(fd, socket_v6only, domain, address_cache_max_capacity),
+      io_uring_worker_factory_(io_uring_worker_factory) {}
+
+IoUringUdpSocketHandleImpl::~IoUringUdpSocketHandleImpl() {
+  if (SOCKET_VALID(fd_) && datagram_socket_.has_value()) {
+    IoUringUdpSocketHandleImpl::close();
+  }
+}
+
+Api::IoCallUint64Result IoUringUdpSocketHandleImpl::close() {
+  if (!datagram_socket_.has_value()) {
+    return IoSocketHandleImpl::close();
+  }
+
+  ENVOY_LOG(trace, "close io_uring udp socket, fd = {}", fd_);
+  ASSERT(SOCKET_VALID(fd_));
+  // The worker closes its remaining sockets when it shuts down, so only close through the io_uring
+  // while the worker is still around.
+  if (io_uring_worker_factory_.currentThreadRegistered()) {
+    datagram_socket_->ioUringSocket().close(false);
+  }
+  datagram_socket_.reset();
+  SET_SOCKET_INVALID(fd_);
+  return Api::ioCallUint64ResultNoError();
+}
+
+Api::IoCallUint64Result IoUringUdpSocketHandleImpl::sendmsg(const Buffer::RawSlice* slices,
+                                                            uint64_t num_slice, int flags,
+                                                            const Address::Ip* self_ip,
+                                                            const Address::Instance& peer_address) {
+  if (!datagram_socket_.has_value()) {
+    return IoSocketHandleImpl::sendmsg(slices, num_slice, flags, self_ip, peer_address);
+  }
+
+  if (peer_address.sockAddr() == nullptr) {
+    // Unlikely to happen unless the wrong peer address is passed.
+    return IoSocketError::ioResultSocketInvalidAddress();
+  }
+  uint64_t length = 0;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    length += slices[i].len_;
+  }
+  if (length == 0) {
+    return Api::ioCallUint64ResultNoError();
+  }
+
+  const uint64_t bytes_sent = datagram_socket_->sendmsg(slices, num_slice, self_ip, peer_address);
+  // The socket accepts nothing when it is applying write backpressure, so report EAGAIN to let the
+  // caller retry after a write event is delivered.
+  if (bytes_sent == 0) {
+    return {0, IoSocketError::getIoSocketEagainError()};
+  }
+  return {bytes_sent, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result IoUringUdpSocketHandleImpl::recvmsg(
+    Buffer::RawSlice* slices, const uint64_t num_slice, uint32_t self_port,
+    const UdpSaveCmsgConfig& save_cmsg_config, RecvMsgOutput& output) {
+  if (!datagram_socket_.has_value()) {
+    return IoSocketHandleImpl::recvmsg(slices, num_slice, self_port, save_cmsg_config, output);
+  }
+
+  ASSERT(!output.msg_.empty());
+  if (datagram_socket_->frontDatagram() == nullptr) {
+    return {0, noDatagramError()};
+  }
+  const uint64_t length = popDatagram(slices, num_slice, self_port, save_cmsg_config, output, 0);
+  return {length, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result IoUringUdpSocketHandleImpl::recvmmsg(
+    RawSliceArrays& slices, uint32_t self_port, const UdpSaveCmsgConfig& save_cmsg_config,
+    RecvMsgOutput& output) {
+  if (!datagram_socket_.has_value()) {
+    return IoSocketHandleImpl::recvmmsg(slices, self_port, save_cmsg_config, output);
+  }
+
+  ASSERT(output.msg_.size() == slices.size());
+  uint64_t num_packets_read = 0;
+  while (num_packets_read < slices.size() && datagram_socket_->frontDatagram() != nullptr) {
+    popDatagram(slices[num_packets_read].data(), slices[num_packets_read].size(), self_port,
+                save_cmsg_config, output, num_packets_read);
+    num_packets_read++;
+  }
+  if (num_packets_read == 0) {
+    return {0, noDatagramError()};
+  }
+  return {num_packets_read, Api::IoError::none()};
+}
+
+Api::IoErrorPtr IoUringUdpSocketHandleImpl::noDatagramError() const {
+  // Once the io_uring can no longer receive on the socket, report why instead of leaving the caller
+  // waiting for datagrams that never arrive.
+  const int error = datagram_socket_->recvError();
+  if (error != 0) {
+    return IoSocketError::create(error);
+  }
+  return IoSocketError::getIoSocketEagainError();
+}
+
+uint64_t IoUringUdpSocketHandleImpl::popDatagram(const Buffer::RawSlice* slices,
+                                                 uint64_t num_slice, uint32_t self_port,
+                                                 const UdpSaveCmsgConfig& save_cmsg_config,
+                                                 RecvMsgOutput& output, size_t index) {
+  const Io::ReceivedDatagram& datagram = *datagram_socket_->frontDatagram();
+  // The header points into the datagram's buffer, so it is only valid until the datagram is popped.
+  msghdr hdr = datagram.hdr_;
+
+  uint64_t capacity = 0;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    capacity += slices[i].len_;
+  }
+  if ((hdr.msg_flags & MSG_TRUNC) != 0 || datagram.payload_length_ > capacity) {
+    ENVOY_LOG_MISC(debug, "Dropping truncated UDP packet with size: {}.", datagram.payload_length_);
+    if (output.dropped_packets_ != nullptr) {
+      (*output.dropped_packets_)++;
+    }
+    output.msg_[index].truncated_and_dropped_ = true;
+    datagram_socket_->popDatagram();
+    return 0;
+  }
+
+  RELEASE_ASSERT((hdr.msg_flags & MSG_CTRUNC) == 0,
+                 fmt::format("Incorrectly set control message length: {}", hdr.msg_controllen));
+  RELEASE_ASSERT(hdr.msg_namelen > 0 && hdr.msg_namelen <= sizeof(sockaddr_storage),
+                 fmt::format("Unable to get remote address from recvmsg() for fd: {}", fd_));
+
+  uint64_t copied = 0;
+  for (uint64_t i = 0; i < num_slice && copied < datagram.payload_length_; i++) {
+    const uint64_t slice_length =
+        std::min<uint64_t>(slices[i].len_, datagram.payload_length_ - copied);
+    memcpy(slices[i].mem_, datagram.payload_ + copied, slice_length);
+    copied += slice_length;
+  }
+
+  sockaddr_storage peer_addr;
+  memcpy(&peer_addr, hdr.msg_name, hdr.msg_namelen);
+  output.msg_[index].peer_address_ = getOrCreateEnvoyAddressInstance(peer_addr, hdr.msg_namelen);
+  output.msg_[index].msg_len_ = copied;
+  output.msg_[index].gso_size_ = 0;
+  processRecvMsgControl(hdr, self_port, save_cmsg_config, output, index);
+
+  datagram_socket_->popDatagram();
+  return copied;
+}
+
+IoHandlePtr IoUringUdpSocketHandleImpl::duplicate() {
+  Api::SysCallSocketResult result = Api::OsSysCallsSingleton::get().duplicate(fd_);
+  RELEASE_ASSERT(result.return_value_ != -1,
+                 fmt::format("duplicate failed for '{}': ({}) {}", fd_, result.errno_,
+                             errorDetails(result.errno_)));
+  return std::make_unique<IoUringUdpSocketHandleImpl>(io_uring_worker_factory_,
+                                                      result.return_value_, socket_v6only_,
+                                                      domain_, addressCacheMaxSize());
+}
+
+void IoUringUdpSocketHandleImpl::initializeFileEvent(Event::Dispatcher& dispatcher,
+                                                     Event::FileReadyCb cb,
+                                                     Event::FileTriggerType trigger,
+                                                     uint32_t events) {
+  ASSERT(!datagram_socket_.has_value());
+  // UDP sockets are created on the main thread and handed to a worker, so whether the io_uring is
+  // used is only decided once the file events are initialized on the thread that runs them.
+  OptRef<Io::IoUringWorker> worker;
+  if (io_uring_worker_factory_.currentThreadRegistered()) {
+    worker = io_uring_worker_factory_.getIoUringWorker();
+  }
+  if (!worker.has_value() || !worker->isDatagramEnabled()) {
+    IoSocketHandleImpl::initializeFileEvent(dispatcher, std::move(cb), trigger, events);
+    return;
+  }
+
+  ENVOY_LOG(trace, "initialize io_uring udp socket, fd = {}", fd_);
+  datagram_socket_ = worker->addDatagramSocket(fd_, std::move(cb));
+  enableFileEvents(events);
+}
+
+void IoUringUdpSocketHandleImpl::activateFileEvents(uint32_t events) {
+  if (!datagram_socket_.has_value()) {
+    IoSocketHandleImpl::activateFileEvents(events);
+    return;
+  }
+
+  if (events & Event::FileReadyType::Read) {
+    datagram_socket_->ioUringSocket().injectCompletion(Io::Request::RequestType::Read);
+  }
+  if (events & Event::FileReadyType::Write) {
+    datagram_socket_->ioUringSocket().injectCompletion(Io::Request::RequestType::Write);
+  }
+}
+
+void IoUringUdpSocketHandleImpl::enableFileEvents(uint32_t events) {
+  if (!datagram_socket_.has_value()) {
+    IoSocketHandleImpl::enableFileEvents(events);
+    return;
+  }
+
+  // Sends never block on the kernel, so a write event is only delivered after write backpressure
+  // is released.
+  if (events & Event::FileReadyType::Read) {
+    datagram_socket_->ioUringSocket().enableRead();
+  } else {
+    datagram_socket_->ioUringSocket().disableRead();
+  }
+}
+
+void IoUringUdpSocketHandleImpl::resetFileEvents() {
+  if (!datagram_socket_.has_value()) {
+    IoSocketHandleImpl::resetFileEvents();
+    return;
+  }
+
+  // Keep the fd open so the file events can be initialized again, possibly on another worker.
+  // Datagrams already received into the io_uring but not read yet are dropped.
+  datagram_socket_->ioUringSocket().close(true);
+  datagram_socket_.reset();
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "envoy/common/io/io_uring.h"
+
+#include "source/common/network/io_socket_handle_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * IoHandle derivative for UDP sockets that receives and sends datagrams through the io_uring of the
+ * worker thread the socket's file events are initialized on. On threads without an io_uring worker,
+ * or when the worker cannot handle datagrams, it behaves like IoSocketHandleImpl.
+ */
+class IoUringUdpSocketHandleImpl : public IoSocketHandleImpl {
+public:
+  IoUringUdpSocketHandleImpl(Io::IoUringWorkerFactory& io_uring_worker_factory,
+                             os_fd_t fd = INVALID_SOCKET, bool socket_v6only = false,
+                             std::optional<int> domain = std::nullopt,
+                             size_t address_cache_max_capacity = 0);
+  ~IoUringUdpSocketHandleImpl() override;
+
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice, int flags,
+                                  const Address::Ip* self_ip,
+                                  const Address::Instance& peer_address) override;
+  Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
+                                  uint32_t self_port, const UdpSaveCmsgConfig& save_cmsg_config,
+                                  RecvMsgOutput& output) override;
+  Api::IoCallUint64Result recvmmsg(RawSliceArrays& slices, uint32_t self_port,
+                                   const UdpSaveCmsgConfig& save_cmsg_config,
+                                   RecvMsgOutput& output) override;
+  bool supportsSplice() const override { return false; }
+  IoHandlePtr duplicate() override;
+  void initializeFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                           Event::FileTriggerType trigger, uint32_t events) override;
+  void activateFileEvents(uint32_t events) override;
+  void enableFileEvents(uint32_t events) override;
+  void resetFileEvents() override;
+
+private:
+  // Copies the oldest queued datagram into the slices and fills the packet at `index` in `output`.
+  // Returns the payload length, or zero when the datagram was dropped for not fitting.
+  uint64_t popDatagram(const Buffer::RawSlice* slices, uint64_t num_slice, uint32_t self_port,
+                       const UdpSaveCmsgConfig& save_cmsg_config, RecvMsgOutput& output,
+                       size_t index);
+  // The error to return when no datagram is queued.
+  Api::IoErrorPtr noDatagramError() const;
+
+  Io::IoUringWorkerFactory& io_uring_worker_factory_;
+  OptRef<Io::IoUringDatagramSocket> datagram_socket_;
+};
+
+} // namespace Network
+} // namespace Envoy
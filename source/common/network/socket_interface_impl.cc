@@ -14,7 +14,9 @@
 #if defined(__linux__) && !defined(__ANDROID_API__) && defined(ENVOY_ENABLE_IO_URING)
 #include "source/common/io/io_uring_impl.h"
 #include "source/common/io/io_uring_worker_factory_impl.h"
+#include "source/common/io/io_uring_worker_impl.h"
 #include "source/common/network/io_uring_socket_handle_impl.h"
+#include "source/common/network/io_uring_udp_socket_handle_impl.h"
 #endif
 
 namespace Envoy {
@@ -57,6 +59,17 @@ IoHandlePtr SocketInterfaceImpl::makeSocket(int socket_fd, bool socket_v6only,
                                             Socket::Type socket_type, std::optional<int> domain,
                                             const SocketCreationOptions& options) const {
   if (socket_type == Socket::Type::Datagram) {
+#if defined(__linux__) && !defined(__ANDROID_API__) && defined(ENVOY_ENABLE_IO_URING)
+    // UDP sockets are usually created on the main thread and handed to a worker, so the handle
+    // decides whether to use the io_uring once its file events are initialized.
+    std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory =
+        io_uring_worker_factory_.lock();
+    if (io_uring_udp_enabled_ && io_uring_worker_factory != nullptr) {
+      return std::make_unique<IoUringUdpSocketHandleImpl>(*io_uring_worker_factory, socket_fd,
+                                                          socket_v6only, domain,
+                                                          options.max_addresses_cache_size_);
+    }
+#endif
     return makePlatformSpecificSocket(socket_fd, socket_v6only, domain, options, nullptr);
   }
   return makePlatformSpecificSocket(socket_fd, socket_v6only, domain, options,
@@ -180,14 +193,25 @@ Server::BootstrapExtensionPtr SocketInterfaceImpl::createBootstrapExtension(
     if (write_low_watermark >= write_high_watermark) {
       write_low_watermark = write_high_watermark / 2;
     }
+    uint32_t udp_receive_buffer_count = 0;
+    Io::IoUringDatagramStatsSharedPtr datagram_stats;
+    if (options.enable_udp()) {
+      udp_receive_buffer_count =
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, udp_receive_buffer_count, 64);
+      datagram_stats = std::make_shared<Io::IoUringDatagramStats>(Io::IoUringDatagramStats{
+          ALL_IO_URING_DATAGRAM_STATS(POOL_COUNTER_PREFIX(context.serverScope(), "io_uring."),
+                                      POOL_HISTOGRAM_PREFIX(context.serverScope(), "io_uring."))});
+    }
     std::shared_ptr<Io::IoUringWorkerFactoryImpl> io_uring_worker_factory =
         std::make_shared<Io::IoUringWorkerFactoryImpl>(
             PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, io_uring_size, 1000),
             options.enable_submission_queue_polling(), options.enable_multishot_receive(),
             PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, read_buffer_size, 8192),
             PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, write_timeout_ms, 1000), write_high_watermark,
-            write_low_watermark, context.threadLocal());
+            write_low_watermark, context.threadLocal(), udp_receive_buffer_count,
+            std::move(datagram_stats));
     io_uring_worker_factory_ = io_uring_worker_factory;
+    io_uring_udp_enabled_ = options.enable_udp();
 
     return std::make_unique<DefaultSocketInterfaceExtension>(*this, io_uring_worker_factory);
   } else {
@@ -53,6 +53,8 @@ protected:
 
 private:
   std::weak_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory_;
+  // Whether UDP sockets send and receive through the io_uring of the worker they run on.
+  bool io_uring_udp_enabled_{false};
 };
 
 DECLARE_FACTORY(SocketInterfaceImpl);
@@ -19,8 +19,10 @@
 #include "source/common/event/dispatcher_impl.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/io_socket_error_impl.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/fixed_array.h"
+#include "absl/numeric/bits.h"
 #include "event2/listener.h"
 
 #define ENVOY_UDP_LOG(LEVEL, FORMAT, ...)                                                          \
@@ -170,8 +172,90 @@ void UdpListenerImpl::activateRead() {
   socket_->ioHandle().activateFileEvents(Event::FileReadyType::Read);
 }
 
+UdpWorkerForwardingQueue::UdpWorkerForwardingQueue(uint32_t capacity)
+    : mask_(absl::bit_ceil(std::max(capacity, 2U)) - 1), cells_(new Cell[mask_ + 1]) {
+  for (uint64_t i = 0; i <= mask_; ++i) {
+    cells_[i].sequence_.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool UdpWorkerForwardingQueue::push(UdpRecvData&& data) {
+  uint64_t position = push_position_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[position & mask_];
+    const uint64_t sequence = cell->sequence_.load(std::memory_order_acquire);
+    const int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+    if (diff == 0) {
+      // The cell is free for this lap: claim it.
+      if (push_position_.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The cell still holds the datagram pushed a lap ago: the queue is full.
+      return false;
+    } else {
+      // Another pusher claimed the cell first.
+      position = push_position_.load(std::memory_order_relaxed);
+    }
+  }
+  cell->data_ = std::make_unique<UdpRecvData>(std::move(data));
+  cell->sequence_.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+std::unique_ptr<UdpRecvData> UdpWorkerForwardingQueue::pop() {
+  uint64_t position = pop_position_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[position & mask_];
+    const uint64_t sequence = cell->sequence_.load(std::memory_order_acquire);
+    const int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(position + 1);
+    if (diff == 0) {
+      // The cell is filled for this lap: claim it.
+      if (pop_position_.compare_exchange_weak(position, position + 1,
+                                              std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // Either empty, or the pusher that claimed the cell has not stored its datagram yet.
+      return nullptr;
+    } else {
+      // Another popper claimed the cell first.
+      position = pop_position_.load(std::memory_order_relaxed);
+    }
+  }
+  std::unique_ptr<UdpRecvData> data = std::move(cell->data_);
+  // Free the cell for the next lap.
+  cell->sequence_.store(position + mask_ + 1, std::memory_order_release);
+  return data;
+}
+
+UdpListenerWorkerRouterImpl::ForwardingState::ForwardingState(uint32_t concurrency,
+                                                              Stats::Scope* scope,
+                                                              TimeSource* time_source)
+    : scope_(scope != nullptr ? scope->getShared() : nullptr),
+      stats_(scope != nullptr
+                 ? std::make_unique<UdpWorkerForwardingStats>(UdpWorkerForwardingStats{
+                       ALL_UDP_WORKER_FORWARDING_STATS(POOL_COUNTER_PREFIX(*scope, "udp."),
+                                                       POOL_HISTOGRAM_PREFIX(*scope, "udp."))})
+                 : nullptr),
+      time_source_(time_source) {
+  queues_.reserve(concurrency);
+  for (uint32_t i = 0; i < concurrency; ++i) {
+    queues_.push_back(std::make_shared<UdpWorkerForwardingQueue>(ForwardingQueueCapacity));
+  }
+}
+
 UdpListenerWorkerRouterImpl::UdpListenerWorkerRouterImpl(uint32_t concurrency)
-    : workers_(concurrency) {}
+    : workers_(concurrency),
+      forwarding_state_(std::make_shared<ForwardingState>(concurrency, nullptr, nullptr)) {}
+
+UdpListenerWorkerRouterImpl::UdpListenerWorkerRouterImpl(uint32_t concurrency, Stats::Scope& scope,
+                                                         TimeSource& time_source)
+    : workers_(concurrency),
+      forwarding_state_(std::make_shared<ForwardingState>(concurrency, &scope, &time_source)) {}
 
 void UdpListenerWorkerRouterImpl::registerWorkerForListener(UdpListenerCallbacks& listener) {
   absl::WriterMutexLock lock(mutex_);
@@ -189,16 +273,80 @@ void UdpListenerWorkerRouterImpl::unregisterWorkerForListener(UdpListenerCallbac
 }
 
 void UdpListenerWorkerRouterImpl::deliver(uint32_t dest_worker_index, UdpRecvData&& data) {
-  absl::ReaderMutexLock lock(mutex_);
-
   ASSERT(dest_worker_index < workers_.size(),
          "UdpListenerCallbacks::destination returned out-of-range value");
+
+  if (!Runtime::runtimeFeatureEnabled("envoy.reloadable_features.udp_worker_forwarding_queue")) {
+    absl::ReaderMutexLock lock(mutex_);
+    auto* worker = workers_[dest_worker_index];
+
+    // When a listener is being removed, packets could be processed on some workers after the
+    // listener is removed from other workers, which could result in a nullptr for that worker.
+    if (worker != nullptr) {
+      worker->post(std::move(data));
+    }
+    return;
+  }
+
+  const UdpWorkerForwardingQueueSharedPtr& queue = forwarding_state_->queues_[dest_worker_index];
+  if (!queue->push(std::move(data))) {
+    if (forwarding_state_->stats_ != nullptr) {
+      forwarding_state_->stats_->worker_forwarding_dropped_.inc();
+    }
+    return;
+  }
+  if (!queue->scheduleDrain()) {
+    // A drain is already pending on the destination worker and will pick this datagram up.
+    return;
+  }
+
+  absl::ReaderMutexLock lock(mutex_);
   auto* worker = workers_[dest_worker_index];
+  if (worker == nullptr) {
+    // The listener is being removed from the destination worker, so no drain will run for the
+    // queued datagrams. The drain is cleared first, so that a datagram pushed meanwhile is dropped
+    // by its own pusher.
+    queue->clearDrain();
+    discard(*forwarding_state_, *queue);
+    return;
+  }
+  // Datagrams pushed until the drain runs are handed to the listener in the same batch.
+  worker->postCallback([state = forwarding_state_, queue](UdpListenerCallbacksOptRef listener) {
+    drain(*state, *queue, listener);
+  });
+}
 
-  // When a listener is being removed, packets could be processed on some workers after the
-  // listener is removed from other workers, which could result in a nullptr for that worker.
-  if (worker != nullptr) {
-    worker->post(std::move(data));
+void UdpListenerWorkerRouterImpl::drain(ForwardingState& state, UdpWorkerForwardingQueue& queue,
+                                        UdpListenerCallbacksOptRef listener) {
+  queue.clearDrain();
+  if (!listener.has_value()) {
+    discard(state, queue);
+    return;
+  }
+  const MonotonicTime now =
+      state.time_source_ != nullptr ? state.time_source_->monotonicTime() : MonotonicTime();
+  uint64_t forwarded = 0;
+  while (std::unique_ptr<UdpRecvData> data = queue.pop()) {
+    if (state.stats_ != nullptr) {
+      state.stats_->worker_forwarding_latency_.recordValue(
+          std::chrono::duration_cast<std::chrono::microseconds>(now - data->receive_time_)
+              .count());
+    }
+    listener->get().onDataWorker(std::move(*data));
+    ++forwarded;
+  }
+  if (state.stats_ != nullptr) {
+    state.stats_->worker_forwarded_packets_.add(forwarded);
+  }
+}
+
+void UdpListenerWorkerRouterImpl::discard(ForwardingState& state, UdpWorkerForwardingQueue& queue) {
+  uint64_t dropped = 0;
+  while (queue.pop() != nullptr) {
+    ++dropped;
+  }
+  if (state.stats_ != nullptr) {
+    state.stats_->worker_forwarding_dropped_.add(dropped);
   }
 }
 
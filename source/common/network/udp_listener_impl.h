@@ -3,6 +3,8 @@
 #include <atomic>
 
 #include "envoy/common/time.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/event/event_impl_base.h"
@@ -76,18 +78,108 @@ private:
   uint32_t events_when_unpaused_ = Event::FileReadyType::Read | Event::FileReadyType::Write;
 };
 
+/**
+ * All stats for datagrams forwarded between workers. @see stats_macros.h
+ */
+#define ALL_UDP_WORKER_FORWARDING_STATS(COUNTER, HISTOGRAM)                                        \
+  COUNTER(worker_forwarded_packets)                                                                \
+  COUNTER(worker_forwarding_dropped)                                                               \
+  HISTOGRAM(worker_forwarding_latency, Microseconds)
+
+/**
+ * Struct definition for all stats for datagrams forwarded between workers. @see stats_macros.h
+ */
+struct UdpWorkerForwardingStats {
+  ALL_UDP_WORKER_FORWARDING_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * A bounded queue of datagrams forwarded to one worker. The destination worker pops to deliver
+ * them, and any thread may push, or pop to discard them when the destination worker is gone. Both
+ * are lock-free: each cell carries a sequence number telling pushers and poppers whether it is free
+ * or filled for the current lap around the ring.
+ */
+class UdpWorkerForwardingQueue {
+public:
+  // The capacity is rounded up to a power of two.
+  explicit UdpWorkerForwardingQueue(uint32_t capacity);
+
+  /**
+   * Pushes a datagram. May be called from any thread.
+   * @return false if the queue is full, in which case the datagram is dropped.
+   */
+  bool push(UdpRecvData&& data);
+
+  /**
+   * Pops the oldest datagram. May be called from any thread.
+   * @return the datagram, or nullptr if the queue is empty.
+   */
+  std::unique_ptr<UdpRecvData> pop();
+
+  /**
+   * Marks a drain of the queue as scheduled on the destination worker.
+   * @return true if no drain was scheduled yet, in which case the caller must schedule one.
+   */
+  bool scheduleDrain() { return !drain_scheduled_.exchange(true, std::memory_order_acq_rel); }
+
+  /**
+   * Clears the scheduled drain. Called by the drain before popping, so that a datagram pushed after
+   * the drain's last pop schedules another drain.
+   */
+  void clearDrain() { drain_scheduled_.exchange(false, std::memory_order_acq_rel); }
+
+private:
+  struct Cell {
+    std::atomic<uint64_t> sequence_;
+    std::unique_ptr<UdpRecvData> data_;
+  };
+
+  const uint64_t mask_;
+  const std::unique_ptr<Cell[]> cells_;
+  // Kept on separate cache lines, since the pushers and the poppers run on different threads.
+  alignas(64) std::atomic<uint64_t> push_position_{0};
+  alignas(64) std::atomic<uint64_t> pop_position_{0};
+  alignas(64) std::atomic<bool> drain_scheduled_{false};
+};
+
+using UdpWorkerForwardingQueueSharedPtr = std::shared_ptr<UdpWorkerForwardingQueue>;
+
 class UdpListenerWorkerRouterImpl : public UdpListenerWorkerRouter {
 public:
   UdpListenerWorkerRouterImpl(uint32_t concurrency);
+  UdpListenerWorkerRouterImpl(uint32_t concurrency, Stats::Scope& scope, TimeSource& time_source);
 
   // UdpListenerWorkerRouter
   void registerWorkerForListener(UdpListenerCallbacks& listener) override;
   void unregisterWorkerForListener(UdpListenerCallbacks& listener) override;
   void deliver(uint32_t dest_worker_index, UdpRecvData&& data) override;
 
+  // The number of datagrams that can be queued for a worker before more are dropped.
+  static constexpr uint32_t ForwardingQueueCapacity = 1024;
+
 private:
+  // State shared with the drains posted to the workers, which may run after the router is gone.
+  struct ForwardingState {
+    ForwardingState(uint32_t concurrency, Stats::Scope* scope, TimeSource* time_source);
+
+    std::vector<UdpWorkerForwardingQueueSharedPtr> queues_;
+    // Keeps the stats alive. Null when the router was created without a scope.
+    const Stats::ScopeSharedPtr scope_;
+    const std::unique_ptr<UdpWorkerForwardingStats> stats_;
+    TimeSource* const time_source_;
+  };
+  using ForwardingStateSharedPtr = std::shared_ptr<ForwardingState>;
+
+  // Pops every queued datagram on the destination worker and hands them to ``listener``, or drops
+  // them if the listener was removed from the worker.
+  static void drain(ForwardingState& state, UdpWorkerForwardingQueue& queue,
+                    UdpListenerCallbacksOptRef listener);
+  // Pops and drops every queued datagram.
+  static void discard(ForwardingState& state, UdpWorkerForwardingQueue& queue);
+
   absl::Mutex mutex_;
   std::vector<UdpListenerCallbacks*> workers_ ABSL_GUARDED_BY(mutex_);
+  const ForwardingStateSharedPtr forwarding_state_;
 };
 
 } // namespace Network
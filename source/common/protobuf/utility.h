@@ -336,6 +336,21 @@ public:
       checkForUnexpectedFields(message, validation_visitor, recurse_into_any);
     }
 
+    validateConstraints(message, recurse_into_any);
+  }
+
+  /**
+   * Validate duration fields and protoc-gen-validate constraints on a given protobuf, without
+   * performing unexpected field validation. Unlike validate(), this does not consult a validation
+   * visitor or the runtime, and may be called from any thread.
+   * Note the corresponding `.pb.validate.h` for the message has to be included in the source file
+   * of caller.
+   * @param message message to validate.
+   * @param recurse_into_any whether to recurse into Any messages during PGV checking.
+   * @throw EnvoyException if the message does not satisfy its type constraints.
+   */
+  template <class MessageType>
+  static void validateConstraints(const MessageType& message, bool recurse_into_any = false) {
     // Throw an exception if the config has an invalid Duration field. This is needed
     // because Envoy validates the duration in a strict way that is not supported by PGV.
     validateDurationFields(message, recurse_into_any);
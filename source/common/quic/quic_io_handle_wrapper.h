@@ -86,6 +86,14 @@ public:
   }
   bool supportsMmsg() const override { return io_handle_.supportsMmsg(); }
   bool supportsUdpGro() const override { return io_handle_.supportsUdpGro(); }
+  bool supportsSplice() const override { return io_handle_.supportsSplice(); }
+  Api::IoCallUint64Result splice(os_fd_t pipe_fd, bool from_handle, uint64_t max_length) override {
+    if (closed_) {
+      ASSERT(false, "splice called after close.");
+      return {0, Network::IoSocketError::getIoSocketEbadfError()};
+    }
+    return io_handle_.splice(pipe_fd, from_handle, max_length);
+  }
   Api::SysCallIntResult bind(Network::Address::InstanceConstSharedPtr address) override {
     return io_handle_.bind(address);
   }
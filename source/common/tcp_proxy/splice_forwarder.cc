@@ -0,0 +1,217 @@
+#include "source/common/tcp_proxy/splice_forwarder.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+
+#include "source/common/api/os_sys_calls_impl_linux.h"
+#endif
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+namespace {
+
+// The most data moved from a socket into a pipe by a single splice(2) call. This is the default
+// capacity of a pipe.
+constexpr size_t MaxSpliceSize = 64 * 1024;
+
+SpliceDirection otherDirection(SpliceDirection direction) {
+  return direction == SpliceDirection::DownstreamToUpstream
+             ? SpliceDirection::UpstreamToDownstream
+             : SpliceDirection::DownstreamToUpstream;
+}
+
+} // namespace
+
+SpliceForwarder::SpliceForwarder(Network::IoHandle& downstream, Network::IoHandle& upstream,
+                                 SpliceForwarderCallbacks& callbacks)
+    : callbacks_(callbacks) {
+  pipe(SpliceDirection::DownstreamToUpstream).source_ = &downstream;
+  pipe(SpliceDirection::DownstreamToUpstream).destination_ = &upstream;
+  pipe(SpliceDirection::UpstreamToDownstream).source_ = &upstream;
+  pipe(SpliceDirection::UpstreamToDownstream).destination_ = &downstream;
+}
+
+SpliceForwarder::~SpliceForwarder() { close(); }
+
+std::unique_ptr<SpliceForwarder> SpliceForwarder::create(Event::Dispatcher& dispatcher,
+                                                         Network::IoHandle& downstream,
+                                                         Network::IoHandle& upstream,
+                                                         SpliceForwarderCallbacks& callbacks) {
+  if (!downstream.supportsSplice() || !upstream.supportsSplice()) {
+    return nullptr;
+  }
+  // Not using std::make_unique as the constructor is private.
+  std::unique_ptr<SpliceForwarder> forwarder(new SpliceForwarder(downstream, upstream, callbacks));
+  if (!forwarder->createPipes()) {
+    return nullptr;
+  }
+  forwarder->createFileEvents(dispatcher);
+  return forwarder;
+}
+
+bool SpliceForwarder::createPipes() {
+#if defined(__linux__)
+  for (Pipe& pipe : pipes_) {
+    os_fd_t fds[2];
+    const Api::SysCallIntResult result =
+        Api::LinuxOsSysCallsSingleton::get().pipe2(fds, O_NONBLOCK | O_CLOEXEC);
+    if (result.return_value_ != 0) {
+      ENVOY_LOG(debug, "failed to create splice pipe: {}", errorDetails(result.errno_));
+      return false;
+    }
+    pipe.read_fd_ = fds[0];
+    pipe.write_fd_ = fds[1];
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void SpliceForwarder::createFileEvents(Event::Dispatcher& dispatcher) {
+  // The events are edge triggered like those of the connections on the same sockets, so every
+  // event must be handled until the socket would block.
+  downstream_events_ = pipe(SpliceDirection::DownstreamToUpstream).source_->duplicate();
+  downstream_events_->initializeFileEvent(
+      dispatcher,
+      [this](uint32_t events) {
+        onFileEvent(SpliceDirection::DownstreamToUpstream, events);
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read | Event::FileReadyType::Write);
+  upstream_events_ = pipe(SpliceDirection::UpstreamToDownstream).source_->duplicate();
+  upstream_events_->initializeFileEvent(
+      dispatcher,
+      [this](uint32_t events) {
+        onFileEvent(SpliceDirection::UpstreamToDownstream, events);
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read | Event::FileReadyType::Write);
+}
+
+void SpliceForwarder::close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  // Closing the duplicates does not close the sockets.
+  downstream_events_.reset();
+  upstream_events_.reset();
+  for (Pipe& pipe : pipes_) {
+    for (os_fd_t* fd : {&pipe.read_fd_, &pipe.write_fd_}) {
+      if (*fd != INVALID_SOCKET) {
+        Api::OsSysCallsSingleton::get().close(*fd);
+        *fd = INVALID_SOCKET;
+      }
+    }
+    pipe.buffered_ = 0;
+  }
+}
+
+uint64_t SpliceForwarder::bufferedBytes(SpliceDirection direction) const {
+  return pipes_[static_cast<size_t>(direction)].buffered_;
+}
+
+void SpliceForwarder::onFileEvent(SpliceDirection direction, uint32_t events) {
+  // Write the data buffered for the socket first, which may make room to read more data for it.
+  if (events & Event::FileReadyType::Write) {
+    pump(otherDirection(direction));
+  }
+  if (!closed_ && (events & Event::FileReadyType::Read)) {
+    pump(direction);
+  }
+}
+
+void SpliceForwarder::pump(SpliceDirection direction) {
+  Pipe& pipe = this->pipe(direction);
+  if (pipe.end_stream_reported_) {
+    return;
+  }
+
+  uint64_t bytes_read = 0;
+  uint64_t bytes_written = 0;
+  bool blocked = false;
+  int error = 0;
+  while (true) {
+    while (pipe.buffered_ > 0) {
+      const Api::IoCallUint64Result result =
+          pipe.destination_->splice(pipe.read_fd_, false, pipe.buffered_);
+      if (!result.ok()) {
+        if (result.wouldBlock()) {
+          blocked = true;
+        } else {
+          error = result.err_->getSystemErrorCode();
+        }
+        break;
+      }
+      pipe.buffered_ -= result.return_value_;
+      bytes_written += result.return_value_;
+    }
+    if (blocked || error != 0 || pipe.end_stream_) {
+      break;
+    }
+    if (bytes_read >= MaxReadPerEvent) {
+      // Continue in the next event loop iteration.
+      sourceEvents(direction).activateFileEvents(Event::FileReadyType::Read);
+      break;
+    }
+
+    // The pipe is empty, so it can take a whole read.
+    const Api::IoCallUint64Result result =
+        pipe.source_->splice(pipe.write_fd_, true, MaxSpliceSize);
+    if (!result.ok()) {
+      if (!result.wouldBlock()) {
+        error = result.err_->getSystemErrorCode();
+      }
+      break;
+    }
+    if (result.return_value_ == 0) {
+      pipe.end_stream_ = true;
+      break;
+    }
+    pipe.buffered_ += result.return_value_;
+    bytes_read += result.return_value_;
+  }
+
+  ENVOY_LOG(trace, "spliced {} bytes in direction {}, {} bytes buffered", bytes_written,
+            static_cast<int>(direction), pipe.buffered_);
+  if (bytes_read > 0 || bytes_written > 0) {
+    callbacks_.onSplicedData(direction, bytes_read, bytes_written);
+    if (closed_) {
+      return;
+    }
+  }
+
+  if (error != 0) {
+    ENVOY_LOG(debug, "splice failed in direction {}: {}", static_cast<int>(direction),
+              errorDetails(error));
+    callbacks_.onSpliceError(direction, error);
+    return;
+  }
+
+  // Reading stops while the pipe holds data the destination socket does not accept.
+  if (blocked != pipe.read_disabled_) {
+    pipe.read_disabled_ = blocked;
+    callbacks_.onSpliceReadDisabled(direction, blocked);
+    if (closed_) {
+      return;
+    }
+  }
+
+  if (pipe.end_stream_ && pipe.buffered_ == 0) {
+    pipe.end_stream_reported_ = true;
+    // The source socket is only the destination of the other direction from now on.
+    sourceEvents(direction).enableFileEvents(Event::FileReadyType::Write);
+    callbacks_.onSpliceEndStream(direction);
+  }
+}
+
+} // namespace TcpProxy
+} // namespace Envoy
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/platform.h"
+#include "envoy/common/pure.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/network/io_handle.h"
+
+#include "source/common/common/logger.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+enum class SpliceDirection { DownstreamToUpstream, UpstreamToDownstream };
+
+/**
+ * Callbacks for the data moved by a SpliceForwarder. The forwarder may be closed from within any
+ * of them.
+ */
+class SpliceForwarderCallbacks {
+public:
+  virtual ~SpliceForwarderCallbacks() = default;
+
+  /**
+   * Called after data has been moved in a direction.
+   * @param direction supplies the direction the data was moved in.
+   * @param bytes_read supplies the number of bytes read from the source socket.
+   * @param bytes_written supplies the number of bytes written to the destination socket.
+   */
+  virtual void onSplicedData(SpliceDirection direction, uint64_t bytes_read,
+                             uint64_t bytes_written) PURE;
+
+  /**
+   * Called when the forwarder stops reading from the source socket of a direction because the
+   * destination socket does not accept more data, and when it resumes reading.
+   * @param direction supplies the direction.
+   * @param disabled supplies whether reading stopped or resumed.
+   */
+  virtual void onSpliceReadDisabled(SpliceDirection direction, bool disabled) PURE;
+
+  /**
+   * Called when the source socket of a direction has reached end of stream, and all data read
+   * from it has been written to the destination socket. The forwarder no longer reads from the
+   * source socket, and does not shut down the destination socket.
+   * @param direction supplies the direction.
+   */
+  virtual void onSpliceEndStream(SpliceDirection direction) PURE;
+
+  /**
+   * Called when reading from or writing to a socket fails. The forwarder stops moving data in
+   * both directions.
+   * @param direction supplies the direction data was moved in.
+   * @param error supplies the errno of the failure.
+   */
+  virtual void onSpliceError(SpliceDirection direction, int error) PURE;
+};
+
+/**
+ * Moves data between a downstream and an upstream socket in both directions using splice(2),
+ * so that the data is never copied to user space. Each direction goes through a pipe, whose
+ * capacity bounds the data read from the source socket but not yet written to the destination
+ * socket. The owner of the sockets must not read from them while the forwarder exists, and must
+ * close the forwarder before closing the sockets. The owner keeps the file events of the sockets'
+ * handles, so the forwarder waits for events on duplicates of the handles.
+ */
+class SpliceForwarder : public Event::DeferredDeletable, Logger::Loggable<Logger::Id::filter> {
+public:
+  ~SpliceForwarder() override;
+
+  /**
+   * Creates a forwarder that moves data between the given sockets until closed.
+   * @param dispatcher supplies the dispatcher the sockets are used on.
+   * @param downstream supplies the handle of the downstream socket, which must outlive the
+   *        forwarder.
+   * @param upstream supplies the handle of the upstream socket, which must outlive the forwarder.
+   * @param callbacks supplies the callbacks, which must outlive the forwarder.
+   * @return the forwarder, or nullptr if either handle does not support splicing or the pipes
+   *         cannot be created.
+   */
+  static std::unique_ptr<SpliceForwarder> create(Event::Dispatcher& dispatcher,
+                                                 Network::IoHandle& downstream,
+                                                 Network::IoHandle& upstream,
+                                                 SpliceForwarderCallbacks& callbacks);
+
+  /**
+   * Stops moving data and releases the pipes. Data read into the pipes but not written yet is
+   * discarded. Callbacks are not invoked after this call.
+   */
+  void close();
+
+  /**
+   * @return the number of bytes read from the source socket of a direction but not yet written
+   *         to the destination socket.
+   */
+  uint64_t bufferedBytes(SpliceDirection direction) const;
+
+  // The most data read from a socket in a single event, so that a busy connection does not starve
+  // the others on its worker.
+  static constexpr uint64_t MaxReadPerEvent = 1024 * 1024;
+
+private:
+  // The state of a direction.
+  struct Pipe {
+    Network::IoHandle* source_{};
+    Network::IoHandle* destination_{};
+    os_fd_t read_fd_{INVALID_SOCKET};
+    os_fd_t write_fd_{INVALID_SOCKET};
+    uint64_t buffered_{};
+    bool read_disabled_{};
+    bool end_stream_{};
+    bool end_stream_reported_{};
+  };
+
+  SpliceForwarder(Network::IoHandle& downstream, Network::IoHandle& upstream,
+                  SpliceForwarderCallbacks& callbacks);
+
+  bool createPipes();
+  void createFileEvents(Event::Dispatcher& dispatcher);
+  // Called for the events of the source socket of the given direction, which is also the
+  // destination socket of the other direction.
+  void onFileEvent(SpliceDirection direction, uint32_t events);
+  void pump(SpliceDirection direction);
+  Network::IoHandle& sourceEvents(SpliceDirection direction) {
+    return direction == SpliceDirection::DownstreamToUpstream ? *downstream_events_
+                                                              : *upstream_events_;
+  }
+  Pipe& pipe(SpliceDirection direction) { return pipes_[static_cast<size_t>(direction)]; }
+
+  SpliceForwarderCallbacks& callbacks_;
+  std::array<Pipe, 2> pipes_;
+  // Duplicates of the socket handles, only used for their file events.
+  Network::IoHandlePtr downstream_events_;
+  Network::IoHandlePtr upstream_events_;
+  bool closed_{};
+};
+
+using SpliceForwarderPtr = std::unique_ptr<SpliceForwarder>;
+
+} // namespace TcpProxy
+} // namespace Envoy
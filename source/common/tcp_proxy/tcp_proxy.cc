@@ -225,7 +225,8 @@ Config::Config(const envoy::extensions::filters::network::tcp_proxy::v3::TcpProx
       drain_close_scope_(context.direction() == envoy::config::core::v3::TrafficDirection::INBOUND
                              ? Network::DrainDirection::InboundOnly
                              : Network::DrainDirection::All),
-      check_drain_close_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, check_drain_close, false)) {
+      check_drain_close_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, check_drain_close, false)),
+      kernel_splice_(config.kernel_splice()) {
   upstream_drain_manager_slot_->set([](Event::Dispatcher&) {
     ThreadLocal::ThreadLocalObjectSharedPtr drain_manager =
         std::make_shared<UpstreamDrainManager>();
@@ -497,6 +498,7 @@ void Filter::initialize(Network::ReadFilterCallbacks& callbacks, bool set_connec
 
   config_->stats().downstream_cx_total_.inc();
   if (set_connection_stats) {
+    connection_stats_set_ = true;
     read_callbacks_->connection().setConnectionStats(
         {config_->stats().downstream_cx_rx_bytes_total_,
          config_->stats().downstream_cx_rx_bytes_buffered_,
@@ -1215,6 +1217,10 @@ Network::FilterStatus Filter::onNewConnection() {
 }
 
 bool Filter::startUpstreamSecureTransport() {
+  if (splice_forwarder_ != nullptr) {
+    // Spliced data does not go through the transport socket.
+    return false;
+  }
   bool switched_to_tls = upstream_->startUpstreamSecureTransport();
   if (switched_to_tls) {
     StreamInfo::UpstreamInfo& upstream_info = *getStreamInfo().upstreamInfo();
@@ -1236,6 +1242,7 @@ void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::LocalClose ||
       event == Network::ConnectionEvent::RemoteClose) {
     downstream_closed_ = true;
+    stopSplice();
     // Record the downstream connection end time point for COMMON_DURATION access logging.
     getStreamInfo().downstreamTiming().onDownstreamConnectionEnd(
         read_callbacks_->connection().dispatcher().timeSource());
@@ -1307,6 +1314,7 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    stopSplice();
     // Propagate the upstream local close reason to the downstream stream info's upstreamInfo.
     if (upstream_) {
       getStreamInfo().upstreamInfo()->setUpstreamLocalCloseReason(upstream_->localCloseReason());
@@ -1396,7 +1404,7 @@ void Filter::onUpstreamConnection() {
   if (read_disabled_due_to_buffer_) {
     read_callbacks_->connection().readDisable(false);
     read_disabled_due_to_buffer_ = false;
-  } else if (!receive_before_connect_) {
+  } else if (!receive_before_connect_ && !maybeStartSplice()) {
     // Re-enable downstream reads that were disabled in establishUpstreamConnection()
     // when early data reception was NOT enabled.
     read_callbacks_->connection().readDisable(false);
@@ -1428,6 +1436,107 @@ void Filter::onUpstreamConnection() {
   }
 }
 
+bool Filter::maybeStartSplice() {
+  if (!config_->kernelSplice() || receive_before_connect_ || upstream_ == nullptr) {
+    return false;
+  }
+  Network::Connection& downstream_connection = read_callbacks_->connection();
+  OptRef<Network::Connection> upstream_connection = upstream_->rawConnection();
+  // Data that goes through TLS cannot be spliced.
+  if (!upstream_connection.has_value() ||
+      upstream_connection->state() != Network::Connection::State::Open ||
+      downstream_connection.ssl() != nullptr || upstream_connection->ssl() != nullptr) {
+    return false;
+  }
+
+  // This also fails for handles that do not support splicing, e.g. io_uring ones.
+  splice_forwarder_ = SpliceForwarder::create(
+      downstream_connection.dispatcher(), downstream_connection.getSocket()->ioHandle(),
+      upstream_connection->getSocket()->ioHandle(), *this);
+  if (splice_forwarder_ == nullptr) {
+    return false;
+  }
+  // The downstream connection has been read disabled since the upstream connection was requested,
+  // so no data has been read from either connection yet. Neither connection reads while the data
+  // is spliced.
+  upstream_connection->readDisable(true);
+  config_->stats().downstream_cx_spliced_total_.inc();
+  ENVOY_CONN_LOG(debug, "splicing data between downstream and upstream", downstream_connection);
+  return true;
+}
+
+void Filter::stopSplice() {
+  if (splice_forwarder_ != nullptr) {
+    // This may be called from within the forwarder's callbacks.
+    splice_forwarder_->close();
+    read_callbacks_->connection().dispatcher().deferredDelete(std::move(splice_forwarder_));
+  }
+}
+
+void Filter::onSplicedData(SpliceDirection direction, uint64_t bytes_read,
+                           uint64_t bytes_written) {
+  const auto& traffic_stats = read_callbacks_->upstreamHost()->cluster().trafficStats();
+  // The connections do not see spliced data, so account for it like they would.
+  if (direction == SpliceDirection::DownstreamToUpstream) {
+    getStreamInfo().getDownstreamBytesMeter()->addWireBytesReceived(bytes_read);
+    getStreamInfo().getUpstreamBytesMeter()->addWireBytesSent(bytes_written);
+    if (connection_stats_set_) {
+      config_->stats().downstream_cx_rx_bytes_total_.add(bytes_read);
+    }
+    traffic_stats->upstream_cx_tx_bytes_total_.add(bytes_written);
+  } else {
+    getStreamInfo().getUpstreamBytesMeter()->addWireBytesReceived(bytes_read);
+    getStreamInfo().getDownstreamBytesMeter()->addWireBytesSent(bytes_written);
+    traffic_stats->upstream_cx_rx_bytes_total_.add(bytes_read);
+    if (connection_stats_set_) {
+      config_->stats().downstream_cx_tx_bytes_total_.add(bytes_written);
+    }
+  }
+  resetIdleTimer();
+  maybeCloseDownstreamForDrainClose();
+}
+
+void Filter::onSpliceReadDisabled(SpliceDirection direction, bool disabled) {
+  if (direction == SpliceDirection::DownstreamToUpstream) {
+    if (disabled) {
+      config_->stats().downstream_flow_control_paused_reading_total_.inc();
+    } else {
+      config_->stats().downstream_flow_control_resumed_reading_total_.inc();
+    }
+    return;
+  }
+
+  const auto& traffic_stats = read_callbacks_->upstreamHost()->cluster().trafficStats();
+  if (disabled) {
+    traffic_stats->upstream_flow_control_paused_reading_total_.inc();
+  } else {
+    traffic_stats->upstream_flow_control_resumed_reading_total_.inc();
+  }
+}
+
+void Filter::onSpliceEndStream(SpliceDirection direction) {
+  ASSERT(upstream_ != nullptr);
+  // Let the connection read the end of stream itself, so that the half-close is proxied the same
+  // way as without splicing. There is no data left to read from the connection.
+  Network::Connection& connection = direction == SpliceDirection::DownstreamToUpstream
+                                        ? read_callbacks_->connection()
+                                        : upstream_->rawConnection().ref();
+  ENVOY_CONN_LOG(trace, "spliced end of stream from {}", read_callbacks_->connection(),
+                 direction == SpliceDirection::DownstreamToUpstream ? "downstream" : "upstream");
+  connection.readDisable(false);
+  connection.getSocket()->ioHandle().activateFileEvents(Event::FileReadyType::Read);
+}
+
+void Filter::onSpliceError(SpliceDirection direction, int error) {
+  ENVOY_CONN_LOG(debug, "splicing data from {} failed: {}", read_callbacks_->connection(),
+                 direction == SpliceDirection::DownstreamToUpstream ? "downstream" : "upstream",
+                 errorDetails(error));
+  stopSplice();
+  // This results in also closing the upstream connection.
+  read_callbacks_->connection().close(Network::ConnectionCloseType::NoFlush,
+                                      StreamInfo::LocalCloseReasons::get().TcpProxySpliceError);
+}
+
 void Filter::onIdleTimeout() {
   ENVOY_CONN_LOG(debug, "Session timed out", read_callbacks_->connection());
   config_->stats().idle_timeout_.inc();
@@ -34,6 +34,7 @@
 #include "source/common/network/hash_policy.h"
 #include "source/common/network/utility.h"
 #include "source/common/stream_info/stream_info_impl.h"
+#include "source/common/tcp_proxy/splice_forwarder.h"
 #include "source/common/tcp_proxy/upstream.h"
 #include "source/common/upstream/load_balancer_context_base.h"
 #include "source/common/upstream/od_cds_api_impl.h"
@@ -62,6 +63,7 @@ constexpr absl::string_view ReceiveBeforeConnectKey = "envoy.tcp_proxy.receive_b
   COUNTER(downstream_cx_drain_close)                                                               \
   COUNTER(downstream_cx_no_route)                                                                  \
   COUNTER(downstream_cx_rx_bytes_total)                                                            \
+  COUNTER(downstream_cx_spliced_total)                                                             \
   COUNTER(downstream_cx_total)                                                                     \
   COUNTER(downstream_cx_tx_bytes_total)                                                            \
   COUNTER(downstream_flow_control_paused_reading_total)                                            \
@@ -382,6 +384,7 @@ public:
   bool checkDrainClose() const { return check_drain_close_; }
   const Network::DrainDecision& drainDecision() const { return drain_decision_; }
   Network::DrainDirection drainCloseScope() const { return drain_close_scope_; }
+  bool kernelSplice() const { return kernel_splice_; }
 
 private:
   struct SimpleRouteImpl : public Route {
@@ -441,6 +444,7 @@ private:
   const Network::DrainDecision& drain_decision_;
   const Network::DrainDirection drain_close_scope_{};
   const bool check_drain_close_{false};
+  const bool kernel_splice_{false};
 };
 
 using ConfigSharedPtr = std::shared_ptr<Config>;
@@ -467,7 +471,8 @@ private:
 class Filter : public Network::ReadFilter,
                public Upstream::LoadBalancerContextBase,
                protected Logger::Loggable<Logger::Id::filter>,
-               public GenericConnectionPoolCallbacks {
+               public GenericConnectionPoolCallbacks,
+               public SpliceForwarderCallbacks {
 public:
   Filter(ConfigSharedPtr config, Upstream::ClusterManager& cluster_manager);
   ~Filter() override;
@@ -487,6 +492,13 @@ public:
                             absl::string_view failure_reason,
                             Upstream::HostDescriptionConstSharedPtr host) override;
 
+  // SpliceForwarderCallbacks
+  void onSplicedData(SpliceDirection direction, uint64_t bytes_read,
+                     uint64_t bytes_written) override;
+  void onSpliceReadDisabled(SpliceDirection direction, bool disabled) override;
+  void onSpliceEndStream(SpliceDirection direction) override;
+  void onSpliceError(SpliceDirection direction, int error) override;
+
   // Upstream::LoadBalancerContext
   const Router::MetadataMatchCriteria* metadataMatchCriteria() override;
   std::optional<uint64_t> computeHashKey() override {
@@ -702,6 +714,10 @@ protected:
   void onUpstreamEvent(Network::ConnectionEvent event);
   void maybeCloseDownstreamForDrainClose();
   void onUpstreamConnection();
+  // Starts splicing data between the downstream and upstream connections if configured and
+  // possible. Returns whether splicing started.
+  bool maybeStartSplice();
+  void stopSplice();
   void onIdleTimeout();
   void resetIdleTimer();
   void disableIdleTimer();
@@ -772,6 +788,10 @@ protected:
   bool read_disabled_due_to_buffer_{false}; // Track if we disabled reading due to buffer overflow.
   uint32_t max_buffered_bytes_{65536};      // Default 64KB.
   bool delay_route_selection_{false};
+  bool connection_stats_set_{false};
+  // Moves data between the downstream and upstream sockets once the upstream connection is
+  // established, if kernel splicing is enabled. The connections do not read while it is set.
+  SpliceForwarderPtr splice_forwarder_;
 };
 
 // This class deals with an upstream connection that needs to finish flushing, when the downstream
@@ -3,6 +3,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/grpc/common.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -36,9 +37,24 @@ CdsApiImpl::CdsApiImpl(const envoy::config::core::v3::ConfigSource& cds_config,
   const auto resource_name = resource_type_helper_.getResourceName();
   absl::StatusOr<Config::SubscriptionPtr> subscription_or_error;
   if (cds_resources_locator == nullptr) {
+    Config::SubscriptionOptions options;
+    // With multiple ADS sources the removals are derived from the full state-of-the-world
+    // update, so unchanged clusters can only be skipped when there is a single source.
+    options.skip_unchanged_resources_ = !support_multi_ads_sources_;
+    options.current_resource_names_ = [this]() {
+      const auto clusters = cm_.clusters();
+      absl::flat_hash_set<std::string> names;
+      for (const auto& cluster : clusters.active_clusters_) {
+        names.insert(cluster.first);
+      }
+      for (const auto& cluster : clusters.warming_clusters_) {
+        names.insert(cluster.first);
+      }
+      return names;
+    };
     subscription_or_error = cm_.subscriptionFactory().subscriptionFromConfigSource(
         cds_config, Grpc::Common::typeUrl(resource_name), *scope_, *this,
-        resource_type_helper_.resourceDecoder(), {});
+        resource_type_helper_.resourceDecoder(), options);
   } else {
     subscription_or_error = cm.subscriptionFactory().collectionSubscriptionFromUrl(
         *cds_resources_locator, cds_config, resource_name, *scope_, *this,
@@ -24,10 +24,9 @@ CELAccessLogExtensionFilter::CELAccessLogExtensionFilter(
 
 bool CELAccessLogExtensionFilter::evaluate(const Formatter::Context& log_context,
                                            const StreamInfo::StreamInfo& stream_info) const {
-  Protobuf::Arena arena;
-  const auto result =
-      expr_.evaluate(arena, &local_info_, stream_info, log_context.requestHeaders().ptr(),
-                     log_context.responseHeaders().ptr(), log_context.responseTrailers().ptr());
+  const auto result = expr_.evaluateReusingActivation(
+      &local_info_, stream_info, log_context.requestHeaders().ptr(),
+      log_context.responseHeaders().ptr(), log_context.responseTrailers().ptr());
   if (!result.has_value() || result.value().IsError()) {
     return false;
   }
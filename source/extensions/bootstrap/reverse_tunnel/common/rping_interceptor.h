@@ -19,6 +19,8 @@ public:
                                std::optional<uint64_t> max_length) override;
   Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
                                 uint64_t num_slice) override;
+  // Spliced data would not be stripped of RPING keepalives.
+  bool supportsSplice() const override { return false; }
 
   virtual void onPingMessage() PURE;
 
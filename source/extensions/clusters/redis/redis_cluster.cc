@@ -89,7 +89,9 @@ RedisCluster::RedisCluster(
                                          context.serverFactoryContext().clusterManager(),
                                          context.serverFactoryContext().api().timeSource())),
       registration_handle_(nullptr), enable_zone_discovery_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
-                                         redis_cluster, enable_zone_discovery, false)) {
+                                         redis_cluster, enable_zone_discovery, false)),
+      topology_stats_{ALL_REDIS_CLUSTER_TOPOLOGY_STATS(
+          POOL_HISTOGRAM_PREFIX(info()->statsScope(), "redis_cluster."))} {
   const auto& locality_lb_endpoints = load_assignment_.endpoints();
   for (const auto& locality_lb_endpoint : locality_lb_endpoints) {
     for (const auto& lb_endpoint : locality_lb_endpoint.lb_endpoints()) {
@@ -203,8 +205,21 @@ void RedisCluster::onClusterSlotUpdate(ClusterSlotsSharedPtr&& slots,
     updated_hosts[host->address()->asString()] = host;
   }
 
+  TimeSource& time_source = dispatcher_.timeSource();
+  const MonotonicTime slot_map_update_start_time = time_source.monotonicTime();
   const bool slot_updated =
       lb_factory_ ? lb_factory_->onClusterSlotUpdate(std::move(slots), updated_hosts) : false;
+  topology_stats_.slot_map_update_time_.recordValue(
+      std::chrono::duration_cast<std::chrono::microseconds>(time_source.monotonicTime() -
+                                                            slot_map_update_start_time)
+          .count());
+  if (topology_refresh_start_time_.has_value()) {
+    topology_stats_.topology_refresh_time_.recordValue(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            time_source.monotonicTime() - topology_refresh_start_time_.value())
+            .count());
+    topology_refresh_start_time_.reset();
+  }
 
   // If slot is updated, call updateAllHosts regardless of if there's new hosts to force
   // update of the thread local load balancers.
@@ -402,6 +417,7 @@ void RedisCluster::RedisDiscoverySession::startResolveRedis() {
     client->client_->addConnectionCallbacks(*client);
   }
   ENVOY_LOG(debug, "executing redis cluster slot request for '{}'", parent_.info_->name());
+  parent_.topology_refresh_start_time_ = dispatcher_.timeSource().monotonicTime();
   current_request_ = client->client_->makeRequest(ClusterSlotsRequest::instance_, *this);
 }
 
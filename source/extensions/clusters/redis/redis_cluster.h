@@ -7,6 +7,7 @@
 #include <functional>
 #include <list>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -33,6 +34,7 @@
 #include "envoy/singleton/manager.h"
 #include "envoy/ssl/context_manager.h"
 #include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 #include "envoy/upstream/health_checker.h"
@@ -68,6 +70,20 @@ namespace Extensions {
 namespace Clusters {
 namespace Redis {
 
+/**
+ * All redis cluster topology stats. @see stats_macros.h
+ */
+#define ALL_REDIS_CLUSTER_TOPOLOGY_STATS(HISTOGRAM)                                                \
+  HISTOGRAM(slot_map_update_time, Microseconds)                                                    \
+  HISTOGRAM(topology_refresh_time, Milliseconds)
+
+/**
+ * Struct definition for all redis cluster topology stats. @see stats_macros.h
+ */
+struct RedisClusterTopologyStats {
+  ALL_REDIS_CLUSTER_TOPOLOGY_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
 /*
  * This class implements support for the topology part of `Redis Cluster
  * <https://redis.io/topics/cluster-spec>`_. Specifically, it allows Envoy to maintain an internal
@@ -367,6 +383,9 @@ private:
   const Common::Redis::ClusterRefreshManagerSharedPtr refresh_manager_;
   Common::Redis::ClusterRefreshManager::HandlePtr registration_handle_;
   const bool enable_zone_discovery_;
+  RedisClusterTopologyStats topology_stats_;
+  // Set when a CLUSTER SLOTS request is sent, to record the time until its topology is applied.
+  std::optional<MonotonicTime> topology_refresh_start_time_;
 
   // Flag to prevent callbacks during destruction
   std::atomic<bool> is_destroying_{false};
@@ -1,6 +1,9 @@
 #include "source/extensions/clusters/redis/redis_cluster_lb.h"
 
 #include <string>
+#include <tuple>
+
+#include "absl/container/flat_hash_set.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -28,76 +31,144 @@ bool RedisClusterLoadBalancerFactory::onClusterSlotUpdate(ClusterSlotsSharedPtr&
         return lhs.start() < rhs.start() || (!(lhs.start() < rhs.start()) && lhs.end() < rhs.end());
       });
 
-  if (current_cluster_slot_ && *current_cluster_slot_ == *slots) {
+  const TopologyConstSharedPtr previous = topology();
+  if (previous && *previous->cluster_slots_ == *slots) {
     return false;
   }
 
-  auto updated_slots = std::make_shared<SlotArray>();
-  auto shard_vector = std::make_shared<std::vector<RedisShardSharedPtr>>();
-  absl::flat_hash_map<std::string, uint64_t> shards;
+  auto topology = std::make_shared<Topology>();
+  auto shard_vector = std::make_shared<ShardVector>();
 
   for (const ClusterSlot& slot : *slots) {
     // look in the updated map
     const std::string primary_address = slot.primary()->asString();
 
-    auto result = shards.try_emplace(primary_address, shard_vector->size());
+    auto result = topology->shard_indexes_.try_emplace(primary_address, shard_vector->size());
     if (result.second) {
       auto primary_host = all_hosts.find(primary_address);
       ASSERT(primary_host != all_hosts.end(),
              "we expect all address to be found in the updated_hosts");
 
-      Upstream::HostVectorSharedPtr primary_and_replicas = std::make_shared<Upstream::HostVector>();
       Upstream::HostVectorSharedPtr replicas = std::make_shared<Upstream::HostVector>();
-      primary_and_replicas->push_back(primary_host->second);
-
       for (auto const& replica : slot.replicas()) {
         auto replica_host = all_hosts.find(replica.first);
         ASSERT(replica_host != all_hosts.end(),
                "we expect all address to be found in the updated_hosts");
         replicas->push_back(replica_host->second);
-        primary_and_replicas->push_back(replica_host->second);
       }
 
-      shard_vector->emplace_back(std::make_shared<RedisShard>(primary_host->second, replicas,
-                                                              primary_and_replicas, random_));
-    }
-
-    for (auto i = slot.start(); i <= slot.end(); ++i) {
-      updated_slots->at(i) = result.first->second;
+      shard_vector->push_back(
+          makeShard(previous.get(), primary_address, primary_host->second, std::move(replicas)));
     }
   }
 
+  topology->slot_array_ = makeSlotArray(previous.get(), *slots, topology->shard_indexes_);
+  topology->shard_vector_ = std::move(shard_vector);
+  topology->cluster_slots_ = std::move(slots);
+
   {
     absl::WriterMutexLock lock(mutex_);
-    current_cluster_slot_ = std::move(slots);
-    slot_array_ = std::move(updated_slots);
-    shard_vector_ = std::move(shard_vector);
+    topology_ = std::move(topology);
   }
   return true;
 }
 
-void RedisClusterLoadBalancerFactory::onHostHealthUpdate() {
-  ShardVectorSharedPtr current_shard_vector;
-  {
-    absl::ReaderMutexLock lock(mutex_);
-    current_shard_vector = shard_vector_;
+RedisClusterLoadBalancerFactory::RedisShardSharedPtr RedisClusterLoadBalancerFactory::makeShard(
+    const Topology* previous, const std::string& primary_address,
+    Upstream::HostConstSharedPtr primary, Upstream::HostVectorSharedPtr replicas) {
+  // Building a shard partitions its hosts, so the shards whose hosts did not change are shared
+  // with the previous topology. Their host sets are rebuilt by onHostHealthUpdate() whenever the
+  // health of a host changes.
+  if (previous != nullptr) {
+    auto it = previous->shard_indexes_.find(primary_address);
+    if (it != previous->shard_indexes_.end()) {
+      const RedisShardSharedPtr& shard = previous->shard_vector_->at(it->second);
+      if (shard->primary() == primary && shard->replicas().hosts() == *replicas) {
+        return shard;
+      }
+    }
+  }
+
+  Upstream::HostVectorSharedPtr primary_and_replicas = std::make_shared<Upstream::HostVector>();
+  primary_and_replicas->reserve(replicas->size() + 1);
+  primary_and_replicas->push_back(primary);
+  primary_and_replicas->insert(primary_and_replicas->end(), replicas->begin(), replicas->end());
+  return std::make_shared<RedisShard>(std::move(primary), std::move(replicas),
+                                      std::move(primary_and_replicas), random_);
+}
+
+RedisClusterLoadBalancerFactory::SlotArraySharedPtr RedisClusterLoadBalancerFactory::makeSlotArray(
+    const Topology* previous, const std::vector<ClusterSlot>& slots,
+    const absl::flat_hash_map<std::string, uint64_t>& shards) {
+  auto slot_array = std::make_shared<SlotArray>();
+  auto assign = [&](const ClusterSlot& slot, uint64_t shard) {
+    for (auto i = slot.start(); i <= slot.end(); ++i) {
+      slot_array->at(i) = shard;
+    }
+  };
+
+  if (previous == nullptr || previous->shard_indexes_ != shards) {
+    for (const ClusterSlot& slot : slots) {
+      assign(slot, shards.at(slot.primary()->asString()));
+    }
+    return slot_array;
+  }
+
+  // During resharding only a few slot ranges move between refreshes. The slots that are not
+  // assigned in the updated slots map to the first shard, as in a new slot array.
+  *slot_array = *previous->slot_array_;
+  auto range_key = [](const ClusterSlot& slot) {
+    return std::make_tuple(slot.start(), slot.end(), slot.primary()->asString());
+  };
+  absl::flat_hash_set<std::tuple<int64_t, int64_t, std::string>> previous_ranges;
+  for (const ClusterSlot& slot : *previous->cluster_slots_) {
+    previous_ranges.insert(range_key(slot));
+  }
+  absl::flat_hash_set<std::tuple<int64_t, int64_t, std::string>> updated_ranges;
+  for (const ClusterSlot& slot : slots) {
+    updated_ranges.insert(range_key(slot));
+  }
+  for (const ClusterSlot& slot : *previous->cluster_slots_) {
+    if (!updated_ranges.contains(range_key(slot))) {
+      assign(slot, 0);
+    }
+  }
+  for (const ClusterSlot& slot : slots) {
+    if (!previous_ranges.contains(range_key(slot))) {
+      assign(slot, shards.at(slot.primary()->asString()));
+    }
   }
+  return slot_array;
+}
+
+RedisClusterLoadBalancerFactory::TopologyConstSharedPtr
+RedisClusterLoadBalancerFactory::topology() const {
+  absl::ReaderMutexLock lock(mutex_);
+  return topology_;
+}
+
+void RedisClusterLoadBalancerFactory::onHostHealthUpdate() {
+  const TopologyConstSharedPtr current = topology();
 
   // This can get called by cluster initialization before the Redis Cluster topology is resolved.
-  if (!current_shard_vector) {
+  if (!current) {
     return;
   }
 
-  auto shard_vector = std::make_shared<std::vector<RedisShardSharedPtr>>();
-
-  for (auto const& shard : *current_shard_vector) {
+  auto shard_vector = std::make_shared<ShardVector>();
+  shard_vector->reserve(current->shard_vector_->size());
+  for (auto const& shard : *current->shard_vector_) {
     shard_vector->emplace_back(std::make_shared<RedisShard>(
         shard->primary(), shard->replicas().hostsPtr(), shard->allHosts().hostsPtr(), random_));
   }
 
+  // The slots are unchanged, so the new snapshot shares them with the current one.
+  auto topology = std::make_shared<Topology>(*current);
+  topology->shard_vector_ = std::move(shard_vector);
+
   {
     absl::WriterMutexLock lock(mutex_);
-    shard_vector_ = std::move(shard_vector);
+    topology_ = std::move(topology);
   }
 }
 
@@ -116,9 +187,7 @@ RedisClusterLoadBalancerFactory::RedisClusterLoadBalancer::RedisClusterLoadBalan
 }
 
 void RedisClusterLoadBalancerFactory::RedisClusterLoadBalancer::refresh() {
-  absl::ReaderMutexLock lock(factory_->mutex_);
-  slot_array_ = factory_->slot_array_;
-  shard_vector_ = factory_->shard_vector_;
+  topology_ = factory_->topology();
 }
 
 namespace {
@@ -145,7 +214,7 @@ Upstream::HostConstSharedPtr chooseRandomHost(const Upstream::HostSetImpl& host_
 Upstream::HostSelectionResponse
 RedisClusterLoadBalancerFactory::RedisClusterLoadBalancer::chooseHost(
     Envoy::Upstream::LoadBalancerContext* context) {
-  if (!slot_array_) {
+  if (!topology_) {
     return {nullptr};
   }
   std::optional<uint64_t> hash;
@@ -159,14 +228,14 @@ RedisClusterLoadBalancerFactory::RedisClusterLoadBalancer::chooseHost(
 
   RedisShardSharedPtr shard;
   if (dynamic_cast<const RedisSpecifyShardContextImpl*>(context)) {
-    if (hash.value() < shard_vector_->size()) {
-      shard = shard_vector_->at(hash.value());
+    if (hash.value() < topology_->shard_vector_->size()) {
+      shard = topology_->shard_vector_->at(hash.value());
     } else {
       return {nullptr};
     }
   } else {
-    shard = shard_vector_->at(
-        slot_array_->at(hash.value() % Envoy::Extensions::Clusters::Redis::MaxSlot));
+    shard = topology_->shard_vector_->at(
+        topology_->slot_array_->at(hash.value() % Envoy::Extensions::Clusters::Redis::MaxSlot));
   }
 
   auto redis_context = dynamic_cast<RedisLoadBalancerContext*>(context);
@@ -252,19 +252,46 @@ private:
   };
 
   using RedisShardSharedPtr = std::shared_ptr<const RedisShard>;
-  using ShardVectorSharedPtr = std::shared_ptr<std::vector<RedisShardSharedPtr>>;
+  using ShardVector = std::vector<RedisShardSharedPtr>;
+  using ShardVectorSharedPtr = std::shared_ptr<const ShardVector>;
   using SlotArray = std::array<uint64_t, MaxSlot>;
   using SlotArraySharedPtr = std::shared_ptr<const SlotArray>;
 
+  /**
+   * An immutable snapshot of the topology. A new snapshot is built on the main thread for each
+   * update and published as a whole, so that the workers only copy a pointer to pick it up and
+   * never observe a partially updated topology.
+   */
+  struct Topology {
+    ClusterSlotsSharedPtr cluster_slots_;
+    SlotArraySharedPtr slot_array_;
+    ShardVectorSharedPtr shard_vector_;
+    // The index in shard_vector_ of the shard of each primary address.
+    absl::flat_hash_map<std::string, uint64_t> shard_indexes_;
+  };
+  using TopologyConstSharedPtr = std::shared_ptr<const Topology>;
+
+  // Returns the shard of the primary with the given replicas, reusing the shard of the previous
+  // topology if it has the same hosts.
+  RedisShardSharedPtr makeShard(const Topology* previous, const std::string& primary_address,
+                                Upstream::HostConstSharedPtr primary,
+                                Upstream::HostVectorSharedPtr replicas);
+
+  // Builds the slot array of the updated slots. If the shards keep their indexes, the slot array
+  // of the previous topology is copied and only the slot ranges that changed are rewritten.
+  static SlotArraySharedPtr makeSlotArray(const Topology* previous,
+                                          const std::vector<ClusterSlot>& slots,
+                                          const absl::flat_hash_map<std::string, uint64_t>& shards);
+
   /*
    * This class implements load balancing according to `Redis Cluster
    * <https://redis.io/topics/cluster-spec>`_. This load balancer is thread local and created
    * through the RedisClusterLoadBalancerFactory by the cluster manager.
    *
-   * The topology is stored in slot_array_ and shard_vector_. According to the
+   * The topology is stored in a snapshot of the slot array and the shard vector. According to the
    * `Redis Cluster Spec <https://redis.io/topics/cluster-spec#keys-distribution-model`_, the key
    * space is split into a fixed size 16384 slots. The current implementation uses a fixed size
-   * std::array() of the index of the shard in the shard_vector_. This has a fixed cpu and memory
+   * std::array() of the index of the shard in the shard vector. This has a fixed cpu and memory
    * cost and provide a fast lookup constant time lookup similar to Maglev. This will be used by the
    * redis proxy filter for load balancing purpose.
    */
@@ -295,16 +322,16 @@ private:
     void refresh();
 
     const std::shared_ptr<RedisClusterLoadBalancerFactory> factory_;
-    SlotArraySharedPtr slot_array_;
-    ShardVectorSharedPtr shard_vector_;
+    TopologyConstSharedPtr topology_;
     Random::RandomGenerator& random_;
     ::Envoy::Common::CallbackHandlePtr member_update_cb_;
   };
 
-  absl::Mutex mutex_;
-  SlotArraySharedPtr slot_array_ ABSL_GUARDED_BY(mutex_);
-  ClusterSlotsSharedPtr current_cluster_slot_;
-  ShardVectorSharedPtr shard_vector_;
+  // Returns the current topology snapshot, which may be null before the first update.
+  TopologyConstSharedPtr topology() const;
+
+  mutable absl::Mutex mutex_;
+  TopologyConstSharedPtr topology_ ABSL_GUARDED_BY(mutex_);
   Random::RandomGenerator& random_;
 };
 
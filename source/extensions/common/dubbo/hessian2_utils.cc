@@ -1,5 +1,7 @@
 #include "source/extensions/common/dubbo/hessian2_utils.h"
 
+#include <algorithm>
+
 namespace Envoy {
 namespace Extensions {
 namespace Common {
@@ -64,6 +66,347 @@ void BufferReader::rawReadNBytes(void* data, size_t len, size_t peek_offset) {
   buffer_.copyOut(offset() + peek_offset, len, data);
 }
 
+namespace {
+
+bool isStringTag(uint8_t tag) {
+  return tag <= 0x1f || (tag >= 0x30 && tag <= 0x33) || tag == 'S' || tag == 'R';
+}
+
+bool isBinaryTag(uint8_t tag) {
+  return (tag >= 0x20 && tag <= 0x2f) || (tag >= 0x34 && tag <= 0x37) || tag == 'B' || tag == 'A';
+}
+
+} // namespace
+
+Hessian2ValueSkipper::Hessian2ValueSkipper(const Envoy::Buffer::Instance& buffer, uint64_t offset)
+    : slices_(buffer.getRawSlices()) {
+  skipBytes(offset);
+}
+
+bool Hessian2ValueSkipper::skipValue() { return skipValue(0); }
+
+// Check http://hessian.caucho.com/doc/hessian-serialization.html for the encoding of the values.
+bool Hessian2ValueSkipper::skipValue(uint32_t depth) {
+  if (depth > MaxDepth) {
+    return false;
+  }
+
+  uint8_t tag;
+  if (!readByte(tag)) {
+    return false;
+  }
+
+  if (isStringTag(tag)) {
+    return skipString(tag);
+  }
+  if (isBinaryTag(tag)) {
+    return skipBinary(tag);
+  }
+
+  // Compact integers and longs.
+  if ((tag >= 0x80 && tag <= 0xbf) || (tag >= 0xd8 && tag <= 0xef)) {
+    return true;
+  }
+  if ((tag >= 0xc0 && tag <= 0xcf) || tag >= 0xf0) {
+    return skipBytes(1);
+  }
+  if ((tag >= 0xd0 && tag <= 0xd7) || (tag >= 0x38 && tag <= 0x3f)) {
+    return skipBytes(2);
+  }
+
+  // Objects with a compact class definition reference.
+  if (tag >= 0x60 && tag <= 0x6f) {
+    const uint64_t definition = tag - 0x60;
+    return definition < class_field_counts_.size() &&
+           skipValues(class_field_counts_[definition], depth + 1);
+  }
+
+  // Compact fixed length lists, typed and untyped.
+  if (tag >= 0x70 && tag <= 0x77) {
+    return skipType() && skipValues(tag - 0x70, depth + 1);
+  }
+  if (tag >= 0x78 && tag <= 0x7f) {
+    return skipValues(tag - 0x78, depth + 1);
+  }
+
+  int64_t value;
+  switch (tag) {
+  case 'N':
+  case 'T':
+  case 'F':
+  case 0x5b: // Double 0.0.
+  case 0x5c: // Double 1.0.
+    return true;
+  case 0x5d: // Double as a byte.
+    return skipBytes(1);
+  case 0x5e: // Double as a short.
+    return skipBytes(2);
+  case 0x5f: // Double as a float.
+  case 'Y':  // Long as an int.
+  case 'I':
+  case 0x4b: // Date in minutes.
+    return skipBytes(4);
+  case 'D':
+  case 'L':
+  case 0x4a: // Date in milliseconds.
+    return skipBytes(8);
+  case 'Q': // Reference to a previous value.
+    return readInt(value);
+  case 0x55: // Variable length typed list.
+    return skipType() && skipValuesUntilEnd(depth + 1);
+  case 'V': // Fixed length typed list.
+    return skipType() && readInt(value) && value >= 0 && skipValues(value, depth + 1);
+  case 0x57: // Variable length untyped list.
+    return skipValuesUntilEnd(depth + 1);
+  case 0x58: // Fixed length untyped list.
+    return readInt(value) && value >= 0 && skipValues(value, depth + 1);
+  case 'M': // Typed map.
+    return skipType() && skipValuesUntilEnd(depth + 1);
+  case 'H': // Untyped map.
+    return skipValuesUntilEnd(depth + 1);
+  case 'C': {
+    // A class definition, which is followed by the value that uses it.
+    uint8_t name_tag;
+    if (!readByte(name_tag) || !skipString(name_tag) || !readInt(value) || value < 0) {
+      return false;
+    }
+    for (int64_t i = 0; i < value; i++) {
+      uint8_t field_tag;
+      if (!readByte(field_tag) || !skipString(field_tag)) {
+        return false;
+      }
+    }
+    class_field_counts_.push_back(value);
+    return skipValue(depth + 1);
+  }
+  case 'O':
+    return readInt(value) && value >= 0 &&
+           static_cast<uint64_t>(value) < class_field_counts_.size() &&
+           skipValues(class_field_counts_[value], depth + 1);
+  default:
+    return false;
+  }
+}
+
+bool Hessian2ValueSkipper::skipString(uint8_t tag) {
+  while (true) {
+    uint64_t length;
+    bool final_chunk = true;
+    if (tag <= 0x1f) {
+      length = tag;
+    } else if (tag >= 0x30 && tag <= 0x33) {
+      if (!readUint(1, length)) {
+        return false;
+      }
+      length += static_cast<uint64_t>(tag - 0x30) << 8;
+    } else if (tag == 'S' || tag == 'R') {
+      if (!readUint(2, length)) {
+        return false;
+      }
+      final_chunk = tag == 'S';
+    } else {
+      return false;
+    }
+
+    // The length is the number of UTF-16 code units, which are encoded as UTF-8. A four byte
+    // sequence encodes a surrogate pair.
+    while (length > 0) {
+      uint8_t lead;
+      if (!readByte(lead)) {
+        return false;
+      }
+      uint64_t continuation_bytes = 0;
+      uint64_t code_units = 1;
+      if (lead < 0x80) {
+        continuation_bytes = 0;
+      } else if ((lead & 0xe0) == 0xc0) {
+        continuation_bytes = 1;
+      } else if ((lead & 0xf0) == 0xe0) {
+        continuation_bytes = 2;
+      } else if ((lead & 0xf8) == 0xf0) {
+        continuation_bytes = 3;
+        code_units = 2;
+      } else {
+        return false;
+      }
+      if (!skipBytes(continuation_bytes)) {
+        return false;
+      }
+      length -= std::min(length, code_units);
+    }
+
+    if (final_chunk) {
+      return true;
+    }
+    if (!readByte(tag)) {
+      return false;
+    }
+  }
+}
+
+bool Hessian2ValueSkipper::skipBinary(uint8_t tag) {
+  while (true) {
+    uint64_t length;
+    bool final_chunk = true;
+    if (tag >= 0x20 && tag <= 0x2f) {
+      length = tag - 0x20;
+    } else if (tag >= 0x34 && tag <= 0x37) {
+      if (!readUint(1, length)) {
+        return false;
+      }
+      length += static_cast<uint64_t>(tag - 0x34) << 8;
+    } else if (tag == 'B' || tag == 'A') {
+      if (!readUint(2, length)) {
+        return false;
+      }
+      final_chunk = tag == 'B';
+    } else {
+      return false;
+    }
+
+    if (!skipBytes(length)) {
+      return false;
+    }
+    if (final_chunk) {
+      return true;
+    }
+    if (!readByte(tag)) {
+      return false;
+    }
+  }
+}
+
+bool Hessian2ValueSkipper::skipType() {
+  // The type of a list or a map is either a type name or a reference to a previous type name.
+  uint8_t tag;
+  if (!peekByte(tag)) {
+    return false;
+  }
+  if (isStringTag(tag)) {
+    readByte(tag);
+    return skipString(tag);
+  }
+  int64_t reference;
+  return readInt(reference);
+}
+
+bool Hessian2ValueSkipper::skipValuesUntilEnd(uint32_t depth) {
+  while (true) {
+    uint8_t tag;
+    if (!peekByte(tag)) {
+      return false;
+    }
+    if (tag == 'Z') {
+      return readByte(tag);
+    }
+    if (!skipValue(depth)) {
+      return false;
+    }
+  }
+}
+
+bool Hessian2ValueSkipper::skipValues(uint64_t count, uint32_t depth) {
+  for (uint64_t i = 0; i < count; i++) {
+    if (!skipValue(depth)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Hessian2ValueSkipper::readInt(int64_t& value) {
+  uint8_t tag;
+  if (!readByte(tag)) {
+    return false;
+  }
+  uint64_t low;
+  if (tag >= 0x80 && tag <= 0xbf) {
+    value = static_cast<int64_t>(tag) - 0x90;
+    return true;
+  }
+  if (tag >= 0xc0 && tag <= 0xcf) {
+    if (!readUint(1, low)) {
+      return false;
+    }
+    value = (static_cast<int64_t>(tag) - 0xc8) * 0x100 + static_cast<int64_t>(low);
+    return true;
+  }
+  if (tag >= 0xd0 && tag <= 0xd7) {
+    if (!readUint(2, low)) {
+      return false;
+    }
+    value = (static_cast<int64_t>(tag) - 0xd4) * 0x10000 + static_cast<int64_t>(low);
+    return true;
+  }
+  if (tag == 'I') {
+    if (!readUint(4, low)) {
+      return false;
+    }
+    value = static_cast<int32_t>(static_cast<uint32_t>(low));
+    return true;
+  }
+  return false;
+}
+
+bool Hessian2ValueSkipper::readUint(uint64_t size, uint64_t& value) {
+  value = 0;
+  for (uint64_t i = 0; i < size; i++) {
+    uint8_t byte;
+    if (!readByte(byte)) {
+      return false;
+    }
+    value = (value << 8) | byte;
+  }
+  return true;
+}
+
+bool Hessian2ValueSkipper::peekByte(uint8_t& byte) const {
+  size_t index = slice_index_;
+  uint64_t slice_offset = slice_offset_;
+  while (index < slices_.size() && slice_offset == slices_[index].len_) {
+    index++;
+    slice_offset = 0;
+  }
+  if (index == slices_.size()) {
+    return false;
+  }
+  byte = static_cast<const uint8_t*>(slices_[index].mem_)[slice_offset];
+  return true;
+}
+
+bool Hessian2ValueSkipper::readByte(uint8_t& byte) {
+  while (slice_index_ < slices_.size() && slice_offset_ == slices_[slice_index_].len_) {
+    slice_index_++;
+    slice_offset_ = 0;
+  }
+  if (slice_index_ == slices_.size()) {
+    return false;
+  }
+  byte = static_cast<const uint8_t*>(slices_[slice_index_].mem_)[slice_offset_];
+  slice_offset_++;
+  offset_++;
+  return true;
+}
+
+bool Hessian2ValueSkipper::skipBytes(uint64_t size) {
+  while (size > 0) {
+    if (slice_index_ == slices_.size()) {
+      return false;
+    }
+    const uint64_t available = slices_[slice_index_].len_ - slice_offset_;
+    if (available == 0) {
+      slice_index_++;
+      slice_offset_ = 0;
+      continue;
+    }
+    const uint64_t skipped = std::min(available, size);
+    slice_offset_ += skipped;
+    offset_ += skipped;
+    size -= skipped;
+  }
+  return true;
+}
+
 } // namespace Dubbo
 } // namespace Common
 } // namespace Extensions
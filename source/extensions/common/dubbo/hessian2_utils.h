@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
 
@@ -47,6 +49,49 @@ private:
   Envoy::Buffer::Instance& buffer_;
 };
 
+/**
+ * Walks over Hessian2 encoded values in a buffer without decoding them into objects, so that the
+ * data after them can be reached cheaply. The buffer is not modified and must outlive the skipper.
+ */
+class Hessian2ValueSkipper {
+public:
+  Hessian2ValueSkipper(const Envoy::Buffer::Instance& buffer, uint64_t offset = 0);
+
+  /**
+   * Skips the value at the current offset.
+   * @return false if the value is malformed or truncated. The offset is undefined then.
+   */
+  bool skipValue();
+
+  /**
+   * @return the offset of the next value in the buffer.
+   */
+  uint64_t offset() const { return offset_; }
+
+  // The deepest nesting of lists, maps and objects that is skipped.
+  static constexpr uint32_t MaxDepth = 64;
+
+private:
+  bool skipValue(uint32_t depth);
+  bool skipString(uint8_t tag);
+  bool skipBinary(uint8_t tag);
+  bool skipType();
+  bool skipValuesUntilEnd(uint32_t depth);
+  bool skipValues(uint64_t count, uint32_t depth);
+  bool readInt(int64_t& value);
+  bool readUint(uint64_t size, uint64_t& value);
+  bool peekByte(uint8_t& byte) const;
+  bool readByte(uint8_t& byte);
+  bool skipBytes(uint64_t size);
+
+  Envoy::Buffer::RawSliceVector slices_;
+  size_t slice_index_{};
+  uint64_t slice_offset_{};
+  uint64_t offset_{};
+  // The number of fields of each class definition seen so far, in order.
+  std::vector<uint64_t> class_field_counts_;
+};
+
 } // namespace Dubbo
 } // namespace Common
 } // namespace Extensions
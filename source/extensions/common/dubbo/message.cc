@@ -1,6 +1,7 @@
 #include "source/extensions/common/dubbo/message.h"
 
 #include "source/common/common/logger.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/extensions/common/dubbo/hessian2_utils.h"
 
 namespace Envoy {
@@ -8,6 +9,37 @@ namespace Extensions {
 namespace Common {
 namespace Dubbo {
 
+namespace {
+
+bool skipArgumentsForAttachments() {
+  return Runtime::runtimeFeatureEnabled(
+      "envoy.reloadable_features.dubbo_skip_arguments_for_attachments");
+}
+
+// Decode the attachments map at the current offset of the decoder. Returns false if no
+// value can be decoded there.
+bool decodeAttachments(Hessian2::Decoder& decoder, Attachments& attachs) {
+  auto map = decoder.decode<Hessian2::Object>();
+  if (map == nullptr) {
+    return false;
+  }
+  if (map->type() != Hessian2::Object::Type::UntypedMap) {
+    return true;
+  }
+
+  for (auto& [key, val] : map->toMutableUntypedMap().value().get()) {
+    if (key->type() != Hessian2::Object::Type::String ||
+        val->type() != Hessian2::Object::Type::String) {
+      continue;
+    }
+    attachs.emplace(std::move(key->toMutableString().value().get()),
+                    std::move(val->toMutableString().value().get()));
+  }
+  return true;
+}
+
+} // namespace
+
 void RequestContent::initialize(Buffer::Instance& buffer, uint64_t length) {
   ASSERT(content_buffer_.length() == 0, "content buffer has been initialized");
 
@@ -21,6 +53,7 @@ void RequestContent::initialize(Buffer::Instance& buffer, uint64_t length) {
   // Set both decoded and updated to false since the content has been initialized
   // by raw buffer.
   decoded_ = false;
+  attachments_decoded_ = false;
   updated_ = false;
 }
 
@@ -38,6 +71,7 @@ void RequestContent::initialize(std::string&& types, ArgumentVec&& argvs, Attach
   // Set decoded to true since the content has been initialized by types,
   // arguments and attachments.
   decoded_ = true;
+  attachments_decoded_ = true;
   updated_ = false;
 }
 
@@ -53,7 +87,14 @@ const Buffer::Instance& RequestContent::buffer() {
   return content_buffer_;
 }
 
-void RequestContent::bufferMoveTo(Buffer::Instance& buffer) { buffer.move(content_buffer_); }
+void RequestContent::bufferMoveTo(Buffer::Instance& buffer) {
+  // The arguments may have been skipped when the attachments were decoded. They are required
+  // to re-encode the content after the buffer has been moved.
+  if (attachments_decoded_) {
+    lazyDecode();
+  }
+  buffer.move(content_buffer_);
+}
 
 const ArgumentVec& RequestContent::arguments() {
   lazyDecode();
@@ -62,20 +103,20 @@ const ArgumentVec& RequestContent::arguments() {
 }
 
 const Attachments& RequestContent::attachments() {
-  lazyDecode();
+  lazyDecodeAttachments();
 
   return attachs_;
 }
 
 void RequestContent::setAttachment(absl::string_view key, absl::string_view val) {
-  lazyDecode();
+  lazyDecodeAttachments();
 
   updated_ = true;
   attachs_[key] = val;
 }
 
 void RequestContent::delAttachment(absl::string_view key) {
-  lazyDecode();
+  lazyDecodeAttachments();
 
   updated_ = true;
   attachs_.erase(key);
@@ -91,66 +132,105 @@ void RequestContent::lazyDecode() {
   Hessian2::Decoder decoder(std::make_unique<BufferReader>(content_buffer_));
 
   // Handle the types and arguments.
-  if (auto element = decoder.decode<Hessian2::Object>(); element != nullptr) {
-    uint32_t number = 0;
-
-    if (element->type() == Hessian2::Object::Type::Integer) {
-      ASSERT(element->toInteger().has_value());
-      if (int32_t direct_num = element->toInteger().value(); direct_num == -1) {
-        if (auto types = decoder.decode<std::string>(); types != nullptr) {
-          types_ = *types;
-          number = Hessian2Utils::getParametersNumber(types_);
-        } else {
-          ENVOY_LOG(error, "Cannot parse RpcInvocation parameter types from buffer");
-          handleBrokenValue();
-          return;
-        }
-      } else if (direct_num >= 0) {
-        number = direct_num;
-      } else {
-        ENVOY_LOG(error, "Invalid RpcInvocation parameter number {}", direct_num);
-        handleBrokenValue();
-        return;
-      }
-    } else if (element->type() == Hessian2::Object::Type::String) {
-      ASSERT(element->toString().has_value());
-      types_ = element->toString().value().get();
-      number = Hessian2Utils::getParametersNumber(types_);
-    }
-
-    for (uint32_t i = 0; i < number; i++) {
-      if (auto result = decoder.decode<Hessian2::Object>(); result != nullptr) {
-        argvs_.push_back(std::move(result));
-      } else {
-        ENVOY_LOG(error, "Cannot parse RpcInvocation parameter from buffer");
-        handleBrokenValue();
-        return;
-      }
-    }
-  } else {
-    ENVOY_LOG(error, "Cannot parse RpcInvocation from buffer");
+  uint32_t number = 0;
+  if (!decodeParametersNumber(decoder, number)) {
     handleBrokenValue();
     return;
   }
 
+  for (uint32_t i = 0; i < number; i++) {
+    if (auto result = decoder.decode<Hessian2::Object>(); result != nullptr) {
+      argvs_.push_back(std::move(result));
+    } else {
+      ENVOY_LOG(error, "Cannot parse RpcInvocation parameter from buffer");
+      handleBrokenValue();
+      return;
+    }
+  }
+
   // Record the size of the arguments in the content buffer. This is useful for
   // re-encoding the attachments.
   argvs_size_ = decoder.offset();
 
+  // The attachments may have been decoded and updated already.
+  if (attachments_decoded_) {
+    return;
+  }
+  attachments_decoded_ = true;
+
   // Handle the attachments.
-  auto map = decoder.decode<Hessian2::Object>();
-  if (map == nullptr || map->type() != Hessian2::Object::Type::UntypedMap) {
+  decodeAttachments(decoder, attachs_);
+}
+
+void RequestContent::lazyDecodeAttachments() {
+  if (decoded_ || attachments_decoded_) {
+    return;
+  }
+  if (!skipArgumentsForAttachments()) {
+    lazyDecode();
     return;
   }
 
-  for (auto& [key, val] : map->toMutableUntypedMap().value().get()) {
-    if (key->type() != Hessian2::Object::Type::String ||
-        val->type() != Hessian2::Object::Type::String) {
-      continue;
+  Hessian2::Decoder decoder(std::make_unique<BufferReader>(content_buffer_));
+  uint32_t number = 0;
+  if (!decodeParametersNumber(decoder, number)) {
+    handleBrokenValue();
+    return;
+  }
+
+  // Skip the arguments without decoding them. They are decoded by lazyDecode() if they are
+  // accessed later.
+  Hessian2ValueSkipper skipper(content_buffer_, decoder.offset());
+  for (uint32_t i = 0; i < number; i++) {
+    if (!skipper.skipValue()) {
+      // Fall back to the complete decoding, which handles the broken content.
+      lazyDecode();
+      return;
     }
-    attachs_.emplace(std::move(key->toMutableString().value().get()),
-                     std::move(val->toMutableString().value().get()));
   }
+  argvs_size_ = skipper.offset();
+
+  // The attachments are decoded by a new decoder. This fails if they refer to a class
+  // definition in the arguments, and the complete decoding is used then.
+  Hessian2::Decoder attachments_decoder(
+      std::make_unique<BufferReader>(content_buffer_, argvs_size_));
+  if (!decodeAttachments(attachments_decoder, attachs_) &&
+      argvs_size_ < content_buffer_.length()) {
+    lazyDecode();
+    return;
+  }
+  attachments_decoded_ = true;
+}
+
+bool RequestContent::decodeParametersNumber(Hessian2::Decoder& decoder, uint32_t& number) {
+  auto element = decoder.decode<Hessian2::Object>();
+  if (element == nullptr) {
+    ENVOY_LOG(error, "Cannot parse RpcInvocation from buffer");
+    return false;
+  }
+
+  if (element->type() == Hessian2::Object::Type::Integer) {
+    ASSERT(element->toInteger().has_value());
+    if (int32_t direct_num = element->toInteger().value(); direct_num == -1) {
+      if (auto types = decoder.decode<std::string>(); types != nullptr) {
+        types_ = *types;
+        number = Hessian2Utils::getParametersNumber(types_);
+      } else {
+        ENVOY_LOG(error, "Cannot parse RpcInvocation parameter types from buffer");
+        return false;
+      }
+    } else if (direct_num >= 0) {
+      number = direct_num;
+    } else {
+      ENVOY_LOG(error, "Invalid RpcInvocation parameter number {}", direct_num);
+      return false;
+    }
+  } else if (element->type() == Hessian2::Object::Type::String) {
+    ASSERT(element->toString().has_value());
+    types_ = element->toString().value().get();
+    number = Hessian2Utils::getParametersNumber(types_);
+  }
+  return true;
 }
 
 void RequestContent::encodeAttachments() {
@@ -159,13 +239,14 @@ void RequestContent::encodeAttachments() {
     return;
   }
 
-  // Ensure the content has been decoded before re-encoding it.
-  lazyDecode();
+  // Ensure the attachments have been decoded before re-encoding them.
+  lazyDecodeAttachments();
 
   const uint64_t buffer_length = content_buffer_.length();
   ASSERT(buffer_length > 0, "content buffer is empty");
 
-  // The size of arguments will be set when doing lazyDecode() or encodeEverything().
+  // The size of arguments will be set when doing lazyDecode(), lazyDecodeAttachments() or
+  // encodeEverything().
   if (buffer_length < argvs_size_) {
     ENVOY_LOG(error, "arguments size {} is larger than content buffer {}", argvs_size_,
               buffer_length);
@@ -244,6 +325,7 @@ void RequestContent::handleBrokenValue() {
   encodeEverything();
 
   decoded_ = true;
+  attachments_decoded_ = true;
   updated_ = false;
 }
 
@@ -258,6 +340,7 @@ void ResponseContent::initialize(Buffer::Instance& buffer, uint64_t length) {
   // Set both decoded and updated to false since the content has been initialized
   // by raw buffer.
   decoded_ = false;
+  attachments_decoded_ = false;
   updated_ = false;
 }
 
@@ -273,6 +356,7 @@ void ResponseContent::initialize(Hessian2::ObjectPtr&& value, Attachments&& atta
 
   // Set decoded to true since the content has been initialized by result and attachments.
   decoded_ = true;
+  attachments_decoded_ = true;
   updated_ = false;
 }
 
@@ -287,7 +371,14 @@ const Buffer::Instance& ResponseContent::buffer() {
   return content_buffer_;
 }
 
-void ResponseContent::bufferMoveTo(Buffer::Instance& buffer) { buffer.move(content_buffer_); }
+void ResponseContent::bufferMoveTo(Buffer::Instance& buffer) {
+  // The result may have been skipped when the attachments were decoded. It is required
+  // to re-encode the content after the buffer has been moved.
+  if (attachments_decoded_) {
+    lazyDecode();
+  }
+  buffer.move(content_buffer_);
+}
 
 const Hessian2::Object* ResponseContent::result() {
   lazyDecode();
@@ -296,20 +387,20 @@ const Hessian2::Object* ResponseContent::result() {
 }
 
 const Attachments& ResponseContent::attachments() {
-  lazyDecode();
+  lazyDecodeAttachments();
 
   return attachs_;
 }
 
 void ResponseContent::setAttachment(absl::string_view key, absl::string_view val) {
-  lazyDecode();
+  lazyDecodeAttachments();
 
   updated_ = true;
   attachs_[key] = val;
 }
 
 void ResponseContent::delAttachment(absl::string_view key) {
-  lazyDecode();
+  lazyDecodeAttachments();
 
   updated_ = true;
   attachs_.erase(key);
@@ -337,20 +428,45 @@ void ResponseContent::lazyDecode() {
   // re-encoding the attachments.
   result_size_ = decoder.offset();
 
+  // The attachments may have been decoded and updated already.
+  if (attachments_decoded_) {
+    return;
+  }
+  attachments_decoded_ = true;
+
   // Handle the attachments.
-  auto map = decoder.decode<Hessian2::Object>();
-  if (map == nullptr || map->type() != Hessian2::Object::Type::UntypedMap) {
+  decodeAttachments(decoder, attachs_);
+}
+
+void ResponseContent::lazyDecodeAttachments() {
+  if (decoded_ || attachments_decoded_) {
+    return;
+  }
+  if (!skipArgumentsForAttachments()) {
+    lazyDecode();
     return;
   }
 
-  for (auto& [key, val] : map->toMutableUntypedMap().value().get()) {
-    if (key->type() != Hessian2::Object::Type::String ||
-        val->type() != Hessian2::Object::Type::String) {
-      continue;
-    }
-    attachs_.emplace(std::move(key->toMutableString().value().get()),
-                     std::move(val->toMutableString().value().get()));
+  // Skip the result without decoding it. It is decoded by lazyDecode() if it is accessed
+  // later.
+  Hessian2ValueSkipper skipper(content_buffer_);
+  if (!skipper.skipValue()) {
+    // Fall back to the complete decoding, which handles the broken content.
+    lazyDecode();
+    return;
   }
+  result_size_ = skipper.offset();
+
+  // The attachments are decoded by a new decoder. This fails if they refer to a class
+  // definition in the result, and the complete decoding is used then.
+  Hessian2::Decoder attachments_decoder(
+      std::make_unique<BufferReader>(content_buffer_, result_size_));
+  if (!decodeAttachments(attachments_decoder, attachs_) &&
+      result_size_ < content_buffer_.length()) {
+    lazyDecode();
+    return;
+  }
+  attachments_decoded_ = true;
 }
 
 void ResponseContent::encodeAttachments() {
@@ -358,8 +474,8 @@ void ResponseContent::encodeAttachments() {
     return;
   }
 
-  // Ensure the content has been decoded before re-encoding it.
-  lazyDecode();
+  // Ensure the attachments have been decoded before re-encoding them.
+  lazyDecodeAttachments();
 
   const uint64_t buffer_length = content_buffer_.length();
   ASSERT(buffer_length > 0, "content buffer is empty");
@@ -431,6 +547,7 @@ void ResponseContent::handleBrokenValue() {
   encodeEverything();
 
   decoded_ = true;
+  attachments_decoded_ = true;
   updated_ = false;
 }
 
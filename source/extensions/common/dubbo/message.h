@@ -124,6 +124,13 @@ private:
   // lazy and will be triggered when the content is accessed.
   void lazyDecode();
 
+  // Decode only the attachments from the content buffer. The arguments are skipped
+  // without being decoded, unless they have been decoded already.
+  void lazyDecodeAttachments();
+
+  // Decode the types or the number of the arguments. Returns false if the content is broken.
+  bool decodeParametersNumber(Hessian2::Decoder& decoder, uint32_t& number);
+
   // Re-encode the attachments into the content buffer.
   void encodeAttachments();
 
@@ -139,6 +146,9 @@ private:
   // If the content has been decoded. This ensures the decoding is only performed once.
   bool decoded_{false};
 
+  // If the attachments have been decoded, either with the whole content or alone.
+  bool attachments_decoded_{false};
+
   // If the attachments has been updated. This ensures the re-encoding is only
   // when the attachment has been modified.
   bool updated_{false};
@@ -214,6 +224,10 @@ private:
   // be triggered when the content is accessed.
   void lazyDecode();
 
+  // Decode only the attachments from the content buffer. The result is skipped without
+  // being decoded, unless it has been decoded already.
+  void lazyDecodeAttachments();
+
   // Re-encode the attachments into the content buffer.
   void encodeAttachments();
 
@@ -229,6 +243,9 @@ private:
   // If the content has been decoded. This ensures the decoding is only performed once.
   bool decoded_{false};
 
+  // If the attachments have been decoded, either with the whole content or alone.
+  bool attachments_decoded_{false};
+
   // If the attachments has been updated. This ensures the re-encoding is only
   // when the attachment has been modified.
   bool updated_{false};
@@ -2,6 +2,8 @@
 
 #include "envoy/singleton/manager.h"
 
+#include "source/common/runtime/runtime_features.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Common {
@@ -130,8 +132,19 @@ bool ClusterRefreshManagerImpl::onEvent(const std::string& cluster_name, EventTy
         *count = 0;
       }
 
+      // A refresh that is still queued on the main thread picks up the latest topology when it
+      // runs, so there is no need to queue another one behind it when the main thread is slower
+      // than min_time_between_triggering.
+      if (post_callback &&
+          Runtime::runtimeFeatureEnabled(
+              "envoy.reloadable_features.redis_cluster_refresh_dedup") &&
+          info->callback_pending_.exchange(true)) {
+        return false;
+      }
+
       if (post_callback) {
         main_thread_dispatcher_.post([this, cluster_name, info]() {
+          info->callback_pending_ = false;
           // Ensure that cluster is still active before calling callback.
           auto maps = cm_.clusters();
           auto it = maps.active_clusters_.find(cluster_name);
@@ -39,6 +39,8 @@ public:
     std::atomic<uint32_t> redirects_count_{0};
     std::atomic<uint32_t> failures_count_{0};
     std::atomic<uint32_t> host_degraded_count_{0};
+    // Set while a callback is posted to the main thread and has not run yet.
+    std::atomic<bool> callback_pending_{false};
     std::chrono::milliseconds min_time_between_triggering_;
     const uint32_t redirects_threshold_;
     const uint32_t failure_threshold_;
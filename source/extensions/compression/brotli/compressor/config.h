@@ -46,6 +46,7 @@ public:
   const std::string& contentEncoding() const override {
     return Http::CustomHeaders::get().ContentEncodingValues.Brotli;
   }
+  bool supportsOffload() const override { return true; }
 
 private:
   static BrotliCompressorImpl::EncoderMode encoderModeEnum(
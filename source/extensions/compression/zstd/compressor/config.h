@@ -35,6 +35,9 @@ public:
   const std::string& contentEncoding() const override {
     return Http::CustomHeaders::get().ContentEncodingValues.Zstd;
   }
+  // A compressor references the dictionary of the worker that created it, which can be replaced
+  // on that worker while the compressor is in use.
+  bool supportsOffload() const override { return cdict_manager_ == nullptr; }
 
 private:
   const uint32_t compression_level_;
@@ -11,6 +11,7 @@
 #include "envoy/stats/scope.h"
 
 #include "source/common/config/utility.h"
+#include "source/extensions/config_subscription/grpc/resource_decode_pool.h"
 
 namespace Envoy {
 namespace Config {
@@ -34,6 +35,9 @@ struct GrpcMuxContext {
   // A factory method that allows a GrpcMux lazily create a Load-Stats-Reporter
   // if needed.
   std::function<std::unique_ptr<Upstream::LoadStatsReporter>()> load_stats_reporter_factory_;
+  // An optional pool for decoding the resources of large responses on multiple threads. Only used
+  // by GrpcMuxImpl.
+  ResourceDecodePoolPtr resource_decode_pool_;
 };
 
 } // namespace Config
@@ -7,6 +7,7 @@
 #include "source/common/config/utility.h"
 #include "source/common/memory/utils.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/common/stats/timespan_impl.h"
 #include "source/extensions/config_subscription/grpc/eds_resources_cache_impl.h"
 #include "source/extensions/config_subscription/grpc/xds_source_id.h"
 
@@ -75,6 +76,7 @@ GrpcMuxImpl::GrpcMuxImpl(GrpcMuxContext& grpc_mux_context)
       eds_resources_cache_(std::move(grpc_mux_context.eds_resources_cache_)),
       target_xds_authority_(grpc_mux_context.target_xds_authority_),
       load_stats_reporter_factory_(grpc_mux_context.load_stats_reporter_factory_),
+      resource_decode_pool_(std::move(grpc_mux_context.resource_decode_pool_)),
       dynamic_update_callback_handle_(
           grpc_mux_context.local_info_.contextProvider().addDynamicContextUpdateCallback(
               [this](absl::string_view resource_type_url) {
@@ -411,30 +413,20 @@ void GrpcMuxImpl::onDiscoveryResponse(
   // see https://github.com/envoyproxy/envoy/issues/11477.
   same_type_resume = pause(type_url);
   TRY_ASSERT_MAIN_THREAD {
-    std::vector<DecodedResourcePtr> resources;
-    OpaqueResourceDecoder& resource_decoder = *api_state.watches_.front()->resource_decoder_;
-
-    for (const auto& resource : message->resources()) {
-      // TODO(snowp): Check the underlying type when the resource is a Resource.
-      if (!resource.Is<envoy::service::discovery::v3::Resource>() &&
-          type_url != resource.type_url()) {
-        throwEnvoyExceptionOrPanic(
-            fmt::format("{} does not match the message-wide type URL {} in DiscoveryResponse {}",
-                        resource.type_url(), type_url, message->DebugString()));
-      }
-
-      auto decoded_resource = THROW_OR_RETURN_VALUE(
-          DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info()),
-          DecodedResourceImplPtr);
-
-      if (!isHeartbeatResource(type_url, *decoded_resource)) {
-        resources.emplace_back(std::move(decoded_resource));
-      }
+    std::vector<DecodedResourcePtr> resources =
+        decodeResources(*message, *api_state.watches_.front()->resource_decoder_);
+
+    if (resource_decode_pool_ != nullptr) {
+      Stats::HistogramCompletableTimespanImpl update_timespan(
+          resource_decode_pool_->stats().update_time_, dispatcher_.timeSource());
+      processDiscoveryResources(resources, api_state, type_url, message->version_info(),
+                                /*call_delegate=*/true);
+      update_timespan.complete();
+    } else {
+      processDiscoveryResources(resources, api_state, type_url, message->version_info(),
+                                /*call_delegate=*/true);
     }
 
-    processDiscoveryResources(resources, api_state, type_url, message->version_info(),
-                              /*call_delegate=*/true);
-
     // Processing point when resources are successfully ingested.
     if (xds_config_tracker_.has_value()) {
       xds_config_tracker_->onConfigAccepted(type_url, resources);
@@ -461,6 +453,47 @@ void GrpcMuxImpl::onDiscoveryResponse(
   queueDiscoveryRequest(type_url);
 }
 
+std::vector<DecodedResourcePtr>
+GrpcMuxImpl::decodeResources(const envoy::service::discovery::v3::DiscoveryResponse& message,
+                             OpaqueResourceDecoder& resource_decoder) {
+  const std::string& type_url = message.type_url();
+  std::vector<DecodedResourcePtr> resources;
+
+  for (const auto& resource : message.resources()) {
+    // TODO(snowp): Check the underlying type when the resource is a Resource.
+    if (!resource.Is<envoy::service::discovery::v3::Resource>() &&
+        type_url != resource.type_url()) {
+      throwEnvoyExceptionOrPanic(
+          fmt::format("{} does not match the message-wide type URL {} in DiscoveryResponse {}",
+                      resource.type_url(), type_url, message.DebugString()));
+    }
+  }
+
+  if (resource_decode_pool_ != nullptr) {
+    std::vector<DecodedResourcePtr> decoded_resources = THROW_OR_RETURN_VALUE(
+        resource_decode_pool_->decode(resource_decoder, message.resources(),
+                                      message.version_info()),
+        std::vector<DecodedResourcePtr>);
+    for (auto& decoded_resource : decoded_resources) {
+      if (!isHeartbeatResource(type_url, *decoded_resource)) {
+        resources.emplace_back(std::move(decoded_resource));
+      }
+    }
+    return resources;
+  }
+
+  for (const auto& resource : message.resources()) {
+    auto decoded_resource = THROW_OR_RETURN_VALUE(
+        DecodedResourceImpl::fromResource(resource_decoder, resource, message.version_info()),
+        DecodedResourceImplPtr);
+
+    if (!isHeartbeatResource(type_url, *decoded_resource)) {
+      resources.emplace_back(std::move(decoded_resource));
+    }
+  }
+  return resources;
+}
+
 void GrpcMuxImpl::processDiscoveryResources(const std::vector<DecodedResourcePtr>& resources,
                                             ApiState& api_state, const std::string& type_url,
                                             const std::string& version_info,
@@ -693,8 +726,8 @@ public:
          const LocalInfo::LocalInfo& local_info, CustomConfigValidatorsPtr&& config_validators,
          BackOffStrategyPtr&& backoff_strategy, XdsConfigTrackerOptRef xds_config_tracker,
          XdsResourcesDelegateOptRef xds_resources_delegate,
-         std::function<std::unique_ptr<Upstream::LoadStatsReporter>()> load_stats_reporter_factory)
-      override {
+         std::function<std::unique_ptr<Upstream::LoadStatsReporter>()> load_stats_reporter_factory,
+         Api::Api& api) override {
     absl::StatusOr<RateLimitSettings> rate_limit_settings_or_error =
         Utility::parseRateLimitSettings(ads_config);
     THROW_IF_NOT_OK_REF(rate_limit_settings_or_error.status());
@@ -715,7 +748,12 @@ public:
         /*target_xds_authority_=*/Config::Utility::getGrpcControlPlane(ads_config).value_or(""),
         /*eds_resources_cache_=*/std::make_unique<EdsResourcesCacheImpl>(dispatcher),
         /*skip_subsequent_node_=*/ads_config.set_node_on_first_message_only(),
-        /*load_stats_reporter_factory_=*/load_stats_reporter_factory};
+        /*load_stats_reporter_factory_=*/load_stats_reporter_factory,
+        /*resource_decode_pool_=*/
+        ads_config.has_resource_decode_settings()
+            ? std::make_unique<ResourceDecodePool>(api.threadFactory(), dispatcher.timeSource(),
+                                                   scope, ads_config.resource_decode_settings())
+            : nullptr};
     return std::make_shared<Config::GrpcMuxImpl>(grpc_mux_context);
   }
 };
@@ -296,6 +296,10 @@ private:
     bool previously_fetched_data_{false};
   };
 
+  // Decodes the resources of the given response, dropping heartbeat resources.
+  std::vector<DecodedResourcePtr>
+  decodeResources(const envoy::service::discovery::v3::DiscoveryResponse& message,
+                  OpaqueResourceDecoder& resource_decoder);
   bool isHeartbeatResource(const std::string& type_url, const DecodedResource& resource) {
     return !resource.hasResource() &&
            resource.version() == apiStateFor(type_url).request_.version_info();
@@ -332,6 +336,8 @@ private:
   std::function<std::unique_ptr<Upstream::LoadStatsReporter>()> load_stats_reporter_factory_;
   // The load stats reporter, lazily created.
   std::unique_ptr<Upstream::LoadStatsReporter> lrs_server_;
+  // If set, used to decode the resources of discovery responses on multiple threads.
+  ResourceDecodePoolPtr resource_decode_pool_;
   bool first_stream_request_{true};
 
   // Helper function for looking up and potentially allocating a new ApiState.
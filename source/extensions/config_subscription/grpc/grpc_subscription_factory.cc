@@ -46,6 +46,8 @@ GrpcConfigSubscriptionFactory::create(ConfigSubscriptionFactory::SubscriptionDat
     return reporter;
   };
 
+  // Only the legacy mux decodes the resources with the decode pool.
+  const bool unified_mux = Runtime::runtimeFeatureEnabled("envoy.reloadable_features.unified_mux");
   GrpcMuxContext grpc_mux_context{
       /*async_client_=*/std::move(primary_client),
       /*failover_async_client_=*/nullptr, // Failover is only supported for ADS.
@@ -61,9 +63,15 @@ GrpcConfigSubscriptionFactory::create(ConfigSubscriptionFactory::SubscriptionDat
       /*target_xds_authority_=*/control_plane_id,
       /*eds_resources_cache_=*/nullptr, // EDS cache is only used for ADS.
       /*skip_subsequent_node_=*/api_config_source.set_node_on_first_message_only(),
-      /*load_stats_reporter_factory_=*/lrs_factory};
-
-  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.unified_mux")) {
+      /*load_stats_reporter_factory_=*/lrs_factory,
+      /*resource_decode_pool_=*/
+      !unified_mux && api_config_source.has_resource_decode_settings()
+          ? std::make_unique<ResourceDecodePool>(data.api_.threadFactory(),
+                                                 data.dispatcher_.timeSource(), data.scope_,
+                                                 api_config_source.resource_decode_settings())
+          : nullptr};
+
+  if (unified_mux) {
     mux = std::make_shared<Config::XdsMux::GrpcMuxSotw>(grpc_mux_context);
   } else {
     mux = std::make_shared<Config::GrpcMuxImpl>(grpc_mux_context);
@@ -11,6 +11,7 @@
 #include "source/common/grpc/common.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_features.h"
 
 namespace Envoy {
 namespace Config {
@@ -73,7 +74,9 @@ GrpcSubscriptionImpl::onConfigUpdate(const std::vector<Config::DecodedResourceRe
   // version_info. This way, both types of versions can be tracked and exposed for debugging by
   // the configuration update targets.
   auto start = dispatcher_.timeSource().monotonicTime();
-  absl::Status status = callbacks_.onConfigUpdate(resources, version_info);
+  absl::Status status = options_.skip_unchanged_resources_
+                            ? onChangedResourcesUpdate(resources, version_info)
+                            : callbacks_.onConfigUpdate(resources, version_info);
   if (!status.ok()) {
     return status;
   }
@@ -117,6 +120,67 @@ absl::Status GrpcSubscriptionImpl::onConfigUpdate(
   return absl::OkStatus();
 }
 
+absl::Status
+GrpcSubscriptionImpl::onChangedResourcesUpdate(const std::vector<DecodedResourceRef>& resources,
+                                               const std::string& version_info) {
+  // Take the previous content hashes out first, so that an update that is rejected, possibly after
+  // having been partially applied, or that throws, leaves no baseline behind and the next update is
+  // delivered in full.
+  std::optional<ResourceHashes> previous_hashes;
+  previous_hashes.swap(resource_hashes_);
+  if (!Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.xds_sotw_skip_unchanged_resources")) {
+    return callbacks_.onConfigUpdate(resources, version_info);
+  }
+
+  ResourceHashes next_hashes;
+  next_hashes.reserve(resources.size());
+  bool deliver_all = !previous_hashes.has_value();
+  for (const auto& resource : resources) {
+    const bool inserted =
+        next_hashes.emplace(resource.get().name(), MessageUtil::hash(resource.get().resource()))
+            .second;
+    // Duplicate names and resources without a payload are left to the subscriber to deal with.
+    if (!inserted || !resource.get().hasResource()) {
+      deliver_all = true;
+    }
+  }
+  if (deliver_all) {
+    RETURN_IF_NOT_OK(callbacks_.onConfigUpdate(resources, version_info));
+    resource_hashes_ = std::move(next_hashes);
+    return absl::OkStatus();
+  }
+
+  // The subscriber may have dropped resources on its own since they were accepted, so the
+  // unchanged resources it no longer holds are delivered again.
+  std::optional<absl::flat_hash_set<std::string>> current_names;
+  if (options_.current_resource_names_) {
+    current_names = options_.current_resource_names_();
+  }
+  std::vector<DecodedResourceRef> changed_resources;
+  for (const auto& resource : resources) {
+    const auto previous = previous_hashes->find(resource.get().name());
+    if (previous == previous_hashes->end() ||
+        previous->second != next_hashes.at(resource.get().name()) ||
+        (current_names.has_value() && !current_names->contains(resource.get().name()))) {
+      changed_resources.push_back(resource);
+    }
+  }
+  Protobuf::RepeatedPtrField<std::string> removed_resources;
+  for (const auto& [name, _] : *previous_hashes) {
+    if (!next_hashes.contains(name)) {
+      *removed_resources.Add() = name;
+    }
+  }
+  const uint64_t skipped = resources.size() - changed_resources.size();
+  stats_.update_unchanged_resources_skipped_.add(skipped);
+  ENVOY_LOG(debug, "gRPC config for {}: {} changed, {} removed and {} unchanged resources",
+            type_url_, changed_resources.size(), removed_resources.size(), skipped);
+  RETURN_IF_NOT_OK(callbacks_.onConfigUpdate(changed_resources, removed_resources, version_info));
+  resource_hashes_ = std::move(next_hashes);
+  return absl::OkStatus();
+}
+
 void GrpcSubscriptionImpl::onConfigUpdateFailed(ConfigUpdateFailureReason reason,
                                                 const EnvoyException* e) {
   switch (reason) {
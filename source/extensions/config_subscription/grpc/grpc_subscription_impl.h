@@ -9,6 +9,7 @@
 
 #include "source/common/common/logger.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "xds/core/v3/resource_locator.pb.h"
 
 namespace Envoy {
@@ -45,7 +46,13 @@ public:
   ScopedResume pause();
 
 private:
+  using ResourceHashes = absl::flat_hash_map<std::string, uint64_t>;
+
   void disableInitFetchTimeoutTimer();
+  // Delivers a state-of-the-world update as a delta of the last accepted one, leaving out the
+  // resources whose content hash has not changed.
+  absl::Status onChangedResourcesUpdate(const std::vector<DecodedResourceRef>& resources,
+                                        const std::string& version_info);
 
   GrpcMuxSharedPtr grpc_mux_;
   SubscriptionCallbacks& callbacks_;
@@ -60,6 +67,9 @@ private:
   Event::TimerPtr init_fetch_timeout_timer_;
   const bool is_aggregated_;
   const SubscriptionOptions options_;
+  // Content hashes of the resources in the last accepted state-of-the-world update, keyed by
+  // resource name. Only used when options_.skip_unchanged_resources_ is set.
+  std::optional<ResourceHashes> resource_hashes_;
 
   struct ResourceNameFormatter {
     void operator()(std::string* out, const Config::DecodedResourceRef& resource) {
@@ -0,0 +1,204 @@
+#include "source/extensions/config_subscription/grpc/resource_decode_pool.h"
+
+#include "source/common/common/thread.h"
+#include "source/common/protobuf/utility.h"
+#include "source/common/stats/timespan_impl.h"
+
+namespace Envoy {
+namespace Config {
+
+namespace {
+
+constexpr absl::string_view StatPrefix = "control_plane.resource_decode.";
+
+// The outcome of decoding a contiguous range of resources on one thread.
+struct RangeResult {
+  // The index of the first resource in the range that failed to decode, if any.
+  uint32_t error_index_{};
+  absl::Status status_;
+};
+
+} // namespace
+
+ResourceDecodePool::ResourceDecodePool(
+    Thread::ThreadFactory& thread_factory, TimeSource& time_source, Stats::Scope& scope,
+    const envoy::config::core::v3::ResourceDecodeSettings& settings)
+    : time_source_(time_source),
+      stats_({ALL_RESOURCE_DECODE_STATS(POOL_COUNTER_PREFIX(scope, StatPrefix),
+                                        POOL_HISTOGRAM_PREFIX(scope, StatPrefix))}),
+      concurrency_(settings.concurrency()),
+      min_resources_per_thread_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(settings, min_resources_per_thread,
+                                                                DefaultMinResourcesPerThread)) {
+  // The calling thread decodes alongside the workers.
+  for (uint32_t i = 1; i < concurrency_; ++i) {
+    threads_.emplace_back(
+        thread_factory.createThread([this]() { worker(); }, Thread::Options{"xds_decode"}));
+  }
+}
+
+ResourceDecodePool::~ResourceDecodePool() {
+  ASSERT_IS_MAIN_OR_TEST_THREAD();
+  {
+    absl::MutexLock lock(mutex_);
+    terminate_ = true;
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+uint32_t ResourceDecodePool::threadsFor(uint32_t num_resources) const {
+  if (concurrency_ <= 1) {
+    return 1;
+  }
+  return std::max(1U, std::min(concurrency_, num_resources / min_resources_per_thread_));
+}
+
+absl::StatusOr<std::vector<DecodedResourcePtr>>
+ResourceDecodePool::decode(OpaqueResourceDecoder& resource_decoder,
+                           const Protobuf::RepeatedPtrField<Protobuf::Any>& resources,
+                           const std::string& version) {
+  ASSERT_IS_MAIN_OR_TEST_THREAD();
+  const uint32_t num_resources = resources.size();
+  const uint32_t num_threads = threadsFor(num_resources);
+  std::vector<DecodedResourcePtr> decoded_resources;
+  decoded_resources.reserve(num_resources);
+
+  if (num_threads == 1) {
+    stats_.serial_decode_.inc();
+    Stats::HistogramCompletableTimespanImpl decode_timespan(stats_.decode_time_, time_source_);
+    for (const auto& resource : resources) {
+      absl::StatusOr<DecodedResourceImplPtr> resource_or_error =
+          DecodedResourceImpl::fromResource(resource_decoder, resource, version);
+      RETURN_IF_NOT_OK_REF(resource_or_error.status());
+      decoded_resources.emplace_back(std::move(resource_or_error.value()));
+    }
+    decode_timespan.complete();
+    return decoded_resources;
+  }
+
+  stats_.concurrent_decode_.inc();
+  ENVOY_LOG(debug, "Decoding {} resources on {} threads", num_resources, num_threads);
+
+  // Each range of contiguous resources is decoded into its own slots, so that the results end up
+  // in response order without any synchronization beyond waiting for all the ranges.
+  std::vector<DecodedResourceImplPtr> concurrently_decoded(num_resources);
+  std::vector<RangeResult> range_results(num_threads);
+  const uint32_t range_size = (num_resources + num_threads - 1) / num_threads;
+  const std::function<void(uint32_t)> decode_range = [&](uint32_t range_index) {
+    const uint32_t begin = range_index * range_size;
+    const uint32_t end = std::min(num_resources, begin + range_size);
+    RangeResult& result = range_results[range_index];
+    result.error_index_ = end;
+    for (uint32_t i = begin; i < end; ++i) {
+      absl::StatusOr<DecodedResourceImplPtr> resource_or_error = nullptr;
+      TRY_NEEDS_AUDIT {
+        resource_or_error =
+            DecodedResourceImpl::fromResourceConcurrently(resource_decoder, resources[i], version);
+      }
+      END_TRY
+      CATCH(const EnvoyException& e,
+            { resource_or_error = absl::InvalidArgumentError(e.what()); });
+      if (!resource_or_error.ok()) {
+        // Resources after the first failure in this range will never be used.
+        result.error_index_ = i;
+        result.status_ = resource_or_error.status();
+        return;
+      }
+      concurrently_decoded[i] = std::move(resource_or_error.value());
+    }
+  };
+
+  Stats::HistogramCompletableTimespanImpl decode_timespan(stats_.decode_time_, time_source_);
+  runRanges(num_threads, decode_range);
+  decode_timespan.complete();
+
+  // The ranges are in response order, so the first range with an error holds the first failed
+  // resource.
+  uint32_t error_index = num_resources;
+  absl::Status error_status;
+  for (const RangeResult& result : range_results) {
+    if (!result.status_.ok()) {
+      error_index = result.error_index_;
+      error_status = result.status_;
+      break;
+    }
+  }
+
+  // Finish validation on the main thread, in response order, so that an unknown or deprecated field
+  // in an earlier resource is reported before a constraint violation in a later one, as it would be
+  // when decoding serially.
+  Stats::HistogramCompletableTimespanImpl validate_timespan(stats_.validate_time_, time_source_);
+  for (uint32_t i = 0; i < error_index; ++i) {
+    if (concurrently_decoded[i] == nullptr) {
+      // The decoder does not support decoding off the main thread.
+      absl::StatusOr<DecodedResourceImplPtr> resource_or_error =
+          DecodedResourceImpl::fromResource(resource_decoder, resources[i], version);
+      RETURN_IF_NOT_OK_REF(resource_or_error.status());
+      decoded_resources.emplace_back(std::move(resource_or_error.value()));
+      continue;
+    }
+    resource_decoder.validateDecodedResource(concurrently_decoded[i]->resource());
+    decoded_resources.emplace_back(std::move(concurrently_decoded[i]));
+  }
+  validate_timespan.complete();
+  RETURN_IF_NOT_OK(error_status);
+  return decoded_resources;
+}
+
+void ResourceDecodePool::runRanges(uint32_t num_ranges,
+                                   const std::function<void(uint32_t)>& decode_range) {
+  {
+    absl::MutexLock lock(mutex_);
+    decode_range_ = &decode_range;
+    num_ranges_ = num_ranges;
+    next_range_ = 0;
+    unfinished_ranges_ = num_ranges;
+  }
+  while (runNextRange()) {
+  }
+  absl::MutexLock lock(mutex_);
+  const auto done = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return unfinished_ranges_ == 0;
+  };
+  mutex_.Await(absl::Condition(&done));
+  decode_range_ = nullptr;
+  num_ranges_ = 0;
+  next_range_ = 0;
+}
+
+bool ResourceDecodePool::runNextRange() {
+  const std::function<void(uint32_t)>* decode_range;
+  uint32_t range_index;
+  {
+    absl::MutexLock lock(mutex_);
+    if (next_range_ == num_ranges_) {
+      return false;
+    }
+    decode_range = decode_range_;
+    range_index = next_range_++;
+  }
+  (*decode_range)(range_index);
+  absl::MutexLock lock(mutex_);
+  --unfinished_ranges_;
+  return true;
+}
+
+void ResourceDecodePool::worker() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return next_range_ < num_ranges_ || terminate_;
+  };
+  while (true) {
+    {
+      absl::MutexLock lock(mutex_);
+      mutex_.Await(absl::Condition(&condition));
+      if (terminate_) {
+        return;
+      }
+    }
+    runNextRange();
+  }
+}
+
+} // namespace Config
+} // namespace Envoy
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/config/core/v3/config_source.pb.h"
+#include "envoy/config/subscription.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/config/decoded_resource_impl.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * All resource decoding stats. @see stats_macros.h
+ */
+#define ALL_RESOURCE_DECODE_STATS(COUNTER, HISTOGRAM)                                              \
+  COUNTER(concurrent_decode)                                                                       \
+  COUNTER(serial_decode)                                                                           \
+  HISTOGRAM(decode_time, Milliseconds)                                                             \
+  HISTOGRAM(validate_time, Milliseconds)                                                           \
+  HISTOGRAM(update_time, Milliseconds)
+
+/**
+ * Struct definition for all resource decoding stats. @see stats_macros.h
+ */
+struct ResourceDecodeStats {
+  ALL_RESOURCE_DECODE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * Decodes the resources of a state-of-the-world discovery response, splitting the unpacking and
+ * constraint validation of large responses across a bounded number of threads. The worker threads
+ * are started with the pool and kept until it is destroyed, which must happen on the main thread.
+ * The calling thread takes part in decoding and blocks until all threads are done. The checks for
+ * unknown and deprecated fields, which may depend on per-server state, are then run on the calling
+ * thread. Resources are always returned in the order in which they appear in the response, and
+ * when several resources fail to decode, the error of the first one in response order is reported,
+ * so the result does not depend on the number of threads used.
+ */
+class ResourceDecodePool : Logger::Loggable<Logger::Id::config> {
+public:
+  ResourceDecodePool(Thread::ThreadFactory& thread_factory, TimeSource& time_source,
+                     Stats::Scope& scope,
+                     const envoy::config::core::v3::ResourceDecodeSettings& settings);
+  ~ResourceDecodePool();
+
+  /**
+   * Decodes and validates the given resources. Must be called on the main thread.
+   * @param resource_decoder the decoder for the resources' type.
+   * @param resources the opaque resources of the discovery response.
+   * @param version the version of the discovery response.
+   * @return the decoded resources in response order, or the error of the first resource in
+   *         response order that failed to unpack or to satisfy its type constraints.
+   * @throw EnvoyException if a resource has unknown or disallowed deprecated fields.
+   */
+  absl::StatusOr<std::vector<DecodedResourcePtr>>
+  decode(OpaqueResourceDecoder& resource_decoder,
+         const Protobuf::RepeatedPtrField<Protobuf::Any>& resources, const std::string& version);
+
+  const ResourceDecodeStats& stats() const { return stats_; }
+
+  static constexpr uint32_t DefaultMinResourcesPerThread = 1000;
+
+private:
+  // Returns the number of threads used to decode a response with the given number of resources.
+  uint32_t threadsFor(uint32_t num_resources) const;
+  // Runs decode_range for each range index below num_ranges, on the calling thread and the worker
+  // threads, and returns once all the ranges are done.
+  void runRanges(uint32_t num_ranges, const std::function<void(uint32_t)>& decode_range);
+  // Runs the next range of the current response, if any is left.
+  // @return false if all the ranges were already claimed.
+  bool runNextRange();
+  void worker();
+
+  TimeSource& time_source_;
+  ResourceDecodeStats stats_;
+  const uint32_t concurrency_;
+  const uint32_t min_resources_per_thread_;
+  absl::Mutex mutex_;
+  // The decoding of the current response, only set while runRanges() is running.
+  const std::function<void(uint32_t)>* decode_range_ ABSL_GUARDED_BY(mutex_){};
+  uint32_t num_ranges_ ABSL_GUARDED_BY(mutex_){};
+  uint32_t next_range_ ABSL_GUARDED_BY(mutex_){};
+  uint32_t unfinished_ranges_ ABSL_GUARDED_BY(mutex_){};
+  bool terminate_ ABSL_GUARDED_BY(mutex_){false};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+using ResourceDecodePoolPtr = std::unique_ptr<ResourceDecodePool>;
+
+} // namespace Config
+} // namespace Envoy
@@ -95,6 +95,67 @@ void StreamActivation::resetActivation() const {
   activation_response_trailers_ = nullptr;
 }
 
+std::optional<CelValue> ReusableActivation::FindValue(absl::string_view name,
+                                                      Protobuf::Arena* arena) const {
+  // Only the attributes created in the arena of the activation outlive the evaluation.
+  if (arena != &arena_) {
+    return StreamActivation::FindValue(name, arena);
+  }
+  const auto& tokens = getActivationTokens();
+  const auto token = tokens.find(name);
+  // The filter states and the metadata are objects of their own rather than the stream data the
+  // activation is set up for, and the upstream filter state is only set once an upstream is picked.
+  if (token == tokens.end() || token->second == ActivationToken::Metadata ||
+      token->second == ActivationToken::FilterState ||
+      token->second == ActivationToken::UpstreamFilterState) {
+    return StreamActivation::FindValue(name, arena);
+  }
+  if (token->second == ActivationToken::Response) {
+    needs_response_path_data_ = true;
+  }
+  const int key = static_cast<int>(token->second);
+  if (const auto it = attributes_.find(key); it != attributes_.end()) {
+    return it->second;
+  }
+  auto value = StreamActivation::FindValue(name, arena);
+  if (value.has_value()) {
+    attributes_.emplace(key, value.value());
+  }
+  return value;
+}
+
+ReusableActivation& ReusableActivation::get(const LocalInfo::LocalInfo* local_info,
+                                            const StreamInfo::StreamInfo& info,
+                                            const Http::RequestHeaderMap* request_headers,
+                                            const Http::ResponseHeaderMap* response_headers,
+                                            const Http::ResponseTrailerMap* response_trailers) {
+  static thread_local ReusableActivation activation;
+  activation.set(local_info, info, request_headers, response_headers, response_trailers);
+  return activation;
+}
+
+void ReusableActivation::set(const LocalInfo::LocalInfo* local_info,
+                             const StreamInfo::StreamInfo& info,
+                             const Http::RequestHeaderMap* request_headers,
+                             const Http::ResponseHeaderMap* response_headers,
+                             const Http::ResponseTrailerMap* response_trailers) {
+  const bool same_data = local_info_ == local_info && activation_info_ == &info &&
+                         activation_request_headers_ == request_headers &&
+                         activation_response_headers_ == response_headers &&
+                         activation_response_trailers_ == response_trailers;
+  needs_response_path_data_ = false;
+  if (same_data && arena_.SpaceUsed() <= MaxArenaBytes) {
+    return;
+  }
+  local_info_ = local_info;
+  activation_info_ = &info;
+  activation_request_headers_ = request_headers;
+  activation_response_headers_ = response_headers;
+  activation_response_trailers_ = response_trailers;
+  attributes_.clear();
+  arena_.Reset();
+}
+
 ActivationPtr createActivation(const LocalInfo::LocalInfo* local_info,
                                const StreamInfo::StreamInfo& info,
                                const Http::RequestHeaderMap* request_headers,
@@ -263,9 +324,24 @@ std::optional<CelValue> CompiledExpression::evaluate(
     const StreamInfo::StreamInfo& info, const ::Envoy::Http::RequestHeaderMap* request_headers,
     const ::Envoy::Http::ResponseHeaderMap* response_headers,
     const ::Envoy::Http::ResponseTrailerMap* response_trailers) const {
-  auto activation =
-      createActivation(local_info, info, request_headers, response_headers, response_trailers);
-  auto eval_status = expr_->Evaluate(*activation, &arena);
+  const StreamActivation activation(local_info, info, request_headers, response_headers,
+                                    response_trailers);
+  auto eval_status = expr_->Evaluate(activation, &arena);
+  if (!eval_status.ok()) {
+    return {};
+  }
+
+  return eval_status.value();
+}
+
+std::optional<CelValue> CompiledExpression::evaluateReusingActivation(
+    const ::Envoy::LocalInfo::LocalInfo* local_info, const StreamInfo::StreamInfo& info,
+    const ::Envoy::Http::RequestHeaderMap* request_headers,
+    const ::Envoy::Http::ResponseHeaderMap* response_headers,
+    const ::Envoy::Http::ResponseTrailerMap* response_trailers) const {
+  ReusableActivation& activation = ReusableActivation::get(local_info, info, request_headers,
+                                                           response_headers, response_trailers);
+  auto eval_status = expr_->Evaluate(activation, &activation.arena());
   if (!eval_status.ok()) {
     return {};
   }
@@ -280,8 +356,7 @@ absl::StatusOr<CelValue> CompiledExpression::evaluate(const Activation& activati
 
 bool CompiledExpression::matches(const StreamInfo::StreamInfo& info,
                                  const Http::RequestHeaderMap& headers) const {
-  Protobuf::Arena arena;
-  auto eval_status = evaluate(arena, nullptr, info, &headers, nullptr, nullptr);
+  auto eval_status = evaluateReusingActivation(nullptr, info, &headers, nullptr, nullptr);
   if (!eval_status.has_value()) {
     return false;
   }
@@ -87,6 +87,43 @@ ActivationPtr createActivation(const ::Envoy::LocalInfo::LocalInfo* local_info,
                                const ::Envoy::Http::ResponseHeaderMap* response_headers,
                                const ::Envoy::Http::ResponseTrailerMap* response_trailers);
 
+// An activation reused by the evaluations of a thread, which keeps the attributes it creates for as
+// long as the evaluations are for the same stream data. The attribute wrappers only refer to the
+// stream data, so that the expressions evaluated for a request share them and their arena rather
+// than creating them again for every expression.
+class ReusableActivation : public StreamActivation {
+public:
+  ReusableActivation() : arena_(initial_block_, sizeof(initial_block_)) {}
+
+  // Returns the activation of the current thread, set up for the given stream data. The values
+  // created by a previous evaluation on the thread are invalidated unless it was for the same data.
+  static ReusableActivation& get(const ::Envoy::LocalInfo::LocalInfo* local_info,
+                                 const StreamInfo::StreamInfo& info,
+                                 const ::Envoy::Http::RequestHeaderMap* request_headers,
+                                 const ::Envoy::Http::ResponseHeaderMap* response_headers,
+                                 const ::Envoy::Http::ResponseTrailerMap* response_trailers);
+
+  std::optional<CelValue> FindValue(absl::string_view name, Protobuf::Arena* arena) const override;
+
+  // The arena to evaluate expressions with, for the attributes to be kept.
+  Protobuf::Arena& arena() { return arena_; }
+
+  // The arena is also reset past this size, since the intermediate results of the evaluations of a
+  // long-lived stream accumulate in it.
+  static constexpr uint64_t MaxArenaBytes = 64 * 1024;
+
+private:
+  void set(const ::Envoy::LocalInfo::LocalInfo* local_info, const StreamInfo::StreamInfo& info,
+           const ::Envoy::Http::RequestHeaderMap* request_headers,
+           const ::Envoy::Http::ResponseHeaderMap* response_headers,
+           const ::Envoy::Http::ResponseTrailerMap* response_trailers);
+
+  alignas(8) char initial_block_[4096];
+  Protobuf::Arena arena_;
+  // The attributes created for the current stream data, by activation token.
+  mutable absl::flat_hash_map<int, CelValue> attributes_;
+};
+
 // Forward declarations.
 class BuilderInstance;
 class BuilderCache;
@@ -167,6 +204,16 @@ public:
 
   absl::StatusOr<CelValue> evaluate(const Activation& activation, Protobuf::Arena* arena) const;
 
+  // Evaluates an expression for a request with the reusable activation of the current thread, which
+  // shares the attributes created by the previous evaluations for the same request. The value is
+  // only valid until the next evaluation with the reusable activation on this thread.
+  std::optional<CelValue>
+  evaluateReusingActivation(const ::Envoy::LocalInfo::LocalInfo* local_info,
+                            const StreamInfo::StreamInfo& info,
+                            const ::Envoy::Http::RequestHeaderMap* request_headers,
+                            const ::Envoy::Http::ResponseHeaderMap* response_headers,
+                            const ::Envoy::Http::ResponseTrailerMap* response_trailers) const;
+
   // Evaluates an expression and returns true if the expression evaluates to "true".
   // Returns false if the expression fails to evaluate.
   bool matches(const StreamInfo::StreamInfo& info, const Http::RequestHeaderMap& headers) const;
@@ -1,5 +1,6 @@
 #include "source/extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <memory>
@@ -87,12 +88,21 @@ bool RateLimitTokenBucket::consume(double factor, uint64_t to_consume) {
   return token_bucket_.consume(cb) != 0.0;
 }
 
-void RateLimitTokenBucket::refill(uint64_t tokens) {
-  if (tokens == 0) {
+void RateLimitTokenBucket::refill(uint64_t tokens) { returnTokens(static_cast<double>(tokens)); }
+
+double RateLimitTokenBucket::lease(double min_tokens, double max_tokens) {
+  ASSERT(min_tokens <= max_tokens);
+  return token_bucket_.consume([min_tokens, max_tokens](double total) {
+    return total < min_tokens ? 0.0 : std::min(total, max_tokens);
+  });
+}
+
+void RateLimitTokenBucket::returnTokens(double tokens) {
+  if (tokens <= 0) {
     return;
   }
   // Use a negative consumed value to add tokens back, capped so we never exceed max_tokens.
-  token_bucket_.consume([tokens_to_refill = static_cast<double>(tokens),
+  token_bucket_.consume([tokens_to_refill = tokens,
                          max = token_bucket_.maxTokens()](double total) -> double {
     const double headroom = max - total;
     if (headroom <= 0) {
@@ -103,6 +113,62 @@ void RateLimitTokenBucket::refill(uint64_t tokens) {
   });
 }
 
+TokenLeases::TokenLeases(uint64_t lease_tokens, std::chrono::milliseconds lease_duration,
+                         Event::Dispatcher& dispatcher)
+    : lease_tokens_(lease_tokens), lease_duration_(lease_duration),
+      time_source_(dispatcher.timeSource()),
+      expiry_timer_(dispatcher.createTimer([this]() { onExpiryTimer(); })) {}
+
+TokenLeases::~TokenLeases() {
+  for (const auto& entry : leases_) {
+    entry.second.token_bucket_->returnTokens(entry.second.tokens_);
+  }
+}
+
+bool TokenLeases::consume(const RateLimitTokenBucketSharedPtr& token_bucket, double factor,
+                          uint64_t tokens) {
+  ASSERT(!(factor <= 0.0 || factor > 1.0));
+  const double needed = tokens / factor;
+  const MonotonicTime now = time_source_.monotonicTime();
+  auto [it, inserted] = leases_.try_emplace(token_bucket.get());
+  Lease& lease = it->second;
+  if (!inserted && lease.expiry_ > now && lease.tokens_ >= needed) {
+    lease.tokens_ -= needed;
+    return true;
+  }
+
+  // Return what is left of the lease before drawing a new batch, so that the tokens it needs can
+  // be drawn even when the bucket is almost empty.
+  if (!inserted) {
+    token_bucket->returnTokens(lease.tokens_);
+  }
+  const double drawn = token_bucket->lease(needed, std::max(needed, lease_tokens_ / factor));
+  if (drawn == 0) {
+    leases_.erase(it);
+    return false;
+  }
+  lease = Lease{token_bucket, drawn - needed, now + lease_duration_};
+  if (!expiry_timer_->enabled()) {
+    expiry_timer_->enableTimer(lease_duration_);
+  }
+  return true;
+}
+
+void TokenLeases::onExpiryTimer() {
+  const MonotonicTime now = time_source_.monotonicTime();
+  for (auto it = leases_.begin(); it != leases_.end();) {
+    if (it->second.expiry_ > now) {
+      ++it;
+      continue;
+    }
+    it->second.token_bucket_->returnTokens(it->second.tokens_);
+    leases_.erase(it++);
+  }
+  if (!leases_.empty()) {
+    expiry_timer_->enableTimer(lease_duration_);
+  }
+}
+
 LocalRateLimiterImpl::LocalRateLimiterImpl(
     const std::chrono::milliseconds fill_interval, const uint64_t max_tokens,
     const uint64_t tokens_per_fill, Event::Dispatcher& dispatcher,
@@ -175,6 +241,23 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
 
 LocalRateLimiterImpl::~LocalRateLimiterImpl() = default;
 
+void LocalRateLimiterImpl::enableTokenLeasing(ThreadLocal::SlotAllocator& tls,
+                                              uint64_t lease_tokens,
+                                              std::chrono::milliseconds lease_duration) {
+  token_leases_ = ThreadLocal::TypedSlot<TokenLeases>::makeUnique(tls);
+  token_leases_->set([lease_tokens, lease_duration](Event::Dispatcher& dispatcher) {
+    return std::make_shared<TokenLeases>(lease_tokens, lease_duration, dispatcher);
+  });
+}
+
+bool LocalRateLimiterImpl::consume(const RateLimitTokenBucketSharedPtr& token_bucket,
+                                   double factor, uint64_t tokens) {
+  if (token_leases_ != nullptr) {
+    return (*token_leases_)->consume(token_bucket, factor, tokens);
+  }
+  return token_bucket->consume(factor, tokens);
+}
+
 struct MatchResult {
   RateLimitTokenBucketSharedPtr token_bucket;
   std::reference_wrapper<const RateLimit::Descriptor> request_descriptor;
@@ -217,8 +300,8 @@ LocalRateLimiterImpl::requestAllowed(absl::Span<const RateLimit::Descriptor> req
         match_result.request_descriptor.get().hits_addend_.has_value()) {
       // Negative addend means refill tokens instead of consuming.
       match_result.token_bucket->refill(match_result.request_descriptor.get().hits_addend_.value());
-    } else if (!match_result.token_bucket->consume(
-                   share_factor, match_result.request_descriptor.get().hits_addend_.value_or(1))) {
+    } else if (!consume(match_result.token_bucket, share_factor,
+                        match_result.request_descriptor.get().hits_addend_.value_or(1))) {
       // If the request is forbidden by a descriptor, return the result and the descriptor
       // token bucket.
       return {false, std::shared_ptr<TokenBucketContext>(match_result.token_bucket),
@@ -249,7 +332,7 @@ LocalRateLimiterImpl::requestAllowed(absl::Span<const RateLimit::Descriptor> req
     }
     ASSERT(default_token_bucket_ != nullptr);
 
-    if (const bool result = default_token_bucket_->consume(share_factor); !result) {
+    if (const bool result = consume(default_token_bucket_, share_factor, 1); !result) {
       // If the request is forbidden by the default token bucket, return the result and the
       // default token bucket.
       return {false, std::shared_ptr<TokenBucketContext>(default_token_bucket_),
@@ -8,6 +8,7 @@
 #include "envoy/extensions/common/ratelimit/v3/ratelimit.pb.h"
 #include "envoy/ratelimit/ratelimit.h"
 #include "envoy/singleton/instance.h"
+#include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/common/thread_synchronizer.h"
@@ -15,6 +16,8 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/extensions/filters/common/local_ratelimit/local_ratelimit.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -113,6 +116,11 @@ public:
   bool consume(double factor = 1.0, uint64_t tokens = 1);
   // Refill tokens back to the bucket, capped at max_tokens.
   void refill(uint64_t tokens);
+  // Draws between min_tokens and max_tokens from the bucket, as many as available.
+  // @return the number of tokens drawn, 0 if fewer than min_tokens are available.
+  double lease(double min_tokens, double max_tokens);
+  // Returns tokens drawn by lease() back to the bucket, capped at max_tokens.
+  void returnTokens(double tokens);
   double fillRate() const { return token_bucket_.fillRate(); }
   std::chrono::milliseconds fillInterval() const { return fill_interval_; }
 
@@ -133,6 +141,49 @@ private:
 };
 using RateLimitTokenBucketSharedPtr = std::shared_ptr<RateLimitTokenBucket>;
 
+/**
+ * The tokens leased by a worker from the token buckets of a limiter shared by the workers. A worker
+ * draws a batch of tokens from a bucket and consumes them without touching the bucket again until
+ * the batch is used up, or expires and its unused tokens are returned to the bucket.
+ *
+ * The bucket never hands out more tokens than it would without leasing, but the tokens leased by a
+ * worker can be consumed up to lease_duration after they were drawn, and are unavailable to the
+ * other workers meanwhile. Over any period, the admissions of the limiter differ from those of the
+ * bucket by at most the tokens of the unexpired leases, i.e. lease_tokens per worker and bucket.
+ */
+class TokenLeases : public ThreadLocal::ThreadLocalObject {
+public:
+  TokenLeases(uint64_t lease_tokens, std::chrono::milliseconds lease_duration,
+              Event::Dispatcher& dispatcher);
+  ~TokenLeases() override;
+
+  /**
+   * Consumes tokens from the lease of the worker on a bucket, leasing a new batch from the bucket
+   * when the lease is used up or expired.
+   * @return true if the tokens were consumed.
+   */
+  bool consume(const RateLimitTokenBucketSharedPtr& token_bucket, double factor, uint64_t tokens);
+
+  size_t size() const { return leases_.size(); }
+
+private:
+  struct Lease {
+    // Keeps the bucket alive until its unused tokens are returned.
+    RateLimitTokenBucketSharedPtr token_bucket_;
+    double tokens_{};
+    MonotonicTime expiry_;
+  };
+
+  // Returns the unused tokens of the expired leases to their buckets.
+  void onExpiryTimer();
+
+  const uint64_t lease_tokens_;
+  const std::chrono::milliseconds lease_duration_;
+  TimeSource& time_source_;
+  Event::TimerPtr expiry_timer_;
+  absl::flat_hash_map<const RateLimitTokenBucket*, Lease> leases_;
+};
+
 class LocalRateLimiterImpl : public Logger::Loggable<Logger::Id::local_rate_limit>,
                              public LocalRateLimiter {
 public:
@@ -148,7 +199,17 @@ public:
   LocalRateLimiter::Result
   requestAllowed(absl::Span<const RateLimit::Descriptor> request_descriptors) override;
 
+  /**
+   * Makes the workers consume the tokens of the buckets from leases of lease_tokens tokens rather
+   * than from the buckets themselves. Must be called on the main thread, before the limiter is
+   * used. @see TokenLeases.
+   */
+  void enableTokenLeasing(ThreadLocal::SlotAllocator& tls, uint64_t lease_tokens,
+                          std::chrono::milliseconds lease_duration);
+
 private:
+  bool consume(const RateLimitTokenBucketSharedPtr& token_bucket, double factor, uint64_t tokens);
+
   RateLimitTokenBucketSharedPtr default_token_bucket_;
 
   TimeSource& time_source_;
@@ -157,6 +218,9 @@ private:
   DynamicDescriptorMap dynamic_descriptors_{};
   ShareProviderSharedPtr share_provider_;
 
+  // Set when the tokens are leased by the workers.
+  ThreadLocal::TypedSlotPtr<TokenLeases> token_leases_;
+
   mutable Thread::ThreadSynchronizer synchronizer_; // Used for testing only.
   const bool always_consume_default_token_bucket_{};
   bool always_deny_default_{false};
@@ -0,0 +1,308 @@
+#include "source/extensions/filters/common/ratelimit/over_limit_cache.h"
+
+#include <algorithm>
+
+#include "envoy/event/dispatcher.h"
+
+#include "source/common/common/empty_string.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/protobuf.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+
+namespace {
+
+using envoy::service::ratelimit::v3::RateLimitResponse;
+using DescriptorStatus = RateLimitResponse::DescriptorStatus;
+
+// The values are length prefixed so that the keys of different descriptors can't collide.
+void appendDescriptor(std::string& key, const Envoy::RateLimit::Descriptor& descriptor) {
+  absl::StrAppend(&key, descriptor.entries_.size(), ":");
+  for (const Envoy::RateLimit::DescriptorEntry& entry : descriptor.entries_) {
+    absl::StrAppend(&key, entry.key_.size(), ":", entry.key_, entry.value_.size(), ":",
+                    entry.value_);
+  }
+  if (descriptor.limit_.has_value()) {
+    absl::StrAppend(&key, "l", descriptor.limit_->requests_per_unit_, "/",
+                    static_cast<int>(descriptor.limit_->unit_));
+  }
+  absl::StrAppend(&key, ";");
+}
+
+} // namespace
+
+std::optional<DescriptorStatus> OverLimitCache::find(const std::string& key) {
+  const auto index_iter = index_.find(key);
+  if (index_iter == index_.end()) {
+    return std::nullopt;
+  }
+
+  const auto entry = index_iter->second;
+  const MonotonicTime now = time_source_.monotonicTime();
+  if (entry->reset_time_ <= now) {
+    index_.erase(index_iter);
+    entries_.erase(entry);
+    return std::nullopt;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry);
+  DescriptorStatus status = entry->status_;
+  *status.mutable_duration_until_reset() = Protobuf::util::TimeUtil::MillisecondsToDuration(
+      std::chrono::duration_cast<std::chrono::milliseconds>(entry->reset_time_ - now).count());
+  return status;
+}
+
+bool OverLimitCache::insert(const std::string& key, const DescriptorStatus& status,
+                            std::chrono::milliseconds duration_until_reset) {
+  const auto index_iter = index_.find(key);
+  if (index_iter != index_.end()) {
+    entries_.erase(index_iter->second);
+    index_.erase(index_iter);
+  }
+
+  bool evicted = false;
+  if (entries_.size() >= max_entries_) {
+    index_.erase(entries_.back().key_);
+    entries_.pop_back();
+    evicted = true;
+  }
+
+  entries_.push_front(Entry{key, time_source_.monotonicTime() + duration_until_reset, status});
+  index_.emplace(key, entries_.begin());
+  return evicted;
+}
+
+std::string OverLimitCache::descriptorKey(const std::string& domain,
+                                          const Envoy::RateLimit::Descriptor& descriptor) {
+  std::string key = absl::StrCat(domain.size(), ":", domain);
+  appendDescriptor(key, descriptor);
+  return key;
+}
+
+std::string
+OverLimitCache::requestKey(const std::string& domain,
+                           const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                           uint32_t hits_addend) {
+  std::string key = absl::StrCat(domain.size(), ":", domain, hits_addend, ";");
+  for (const Envoy::RateLimit::Descriptor& descriptor : descriptors) {
+    appendDescriptor(key, descriptor);
+    absl::StrAppend(&key, descriptor.hits_addend_.value_or(0), ";");
+  }
+  return key;
+}
+
+OverLimitCacheConfig::OverLimitCacheConfig(uint32_t max_entries, bool coalesce_requests,
+                                           ThreadLocal::SlotAllocator& tls,
+                                           const OverLimitCacheStats& stats)
+    : coalesce_requests_(coalesce_requests), stats_(stats),
+      tls_(ThreadLocal::TypedSlot<OverLimitCache>::makeUnique(tls)) {
+  tls_->set([max_entries](Event::Dispatcher& dispatcher) {
+    return std::make_shared<OverLimitCache>(max_entries, dispatcher.timeSource());
+  });
+}
+
+OverLimitCacheClient::~OverLimitCacheClient() {
+  if (leader_ != nullptr) {
+    auto& followers = leader_->followers_;
+    followers.erase(std::remove(followers.begin(), followers.end(), this), followers.end());
+  }
+  handOverFollowers();
+}
+
+void OverLimitCacheClient::cancel() {
+  callbacks_ = nullptr;
+  if (leader_ != nullptr) {
+    auto& followers = leader_->followers_;
+    followers.erase(std::remove(followers.begin(), followers.end(), this), followers.end());
+    leader_ = nullptr;
+    return;
+  }
+  client_->cancel();
+  handOverFollowers();
+}
+
+void OverLimitCacheClient::detach() {
+  if (leader_ != nullptr) {
+    // The stream of a detached request goes away, so the request is sent while its arguments are
+    // still valid rather than waiting on its leader.
+    auto& followers = leader_->followers_;
+    followers.erase(std::remove(followers.begin(), followers.end(), this), followers.end());
+    leader_ = nullptr;
+    request_key_.clear();
+    const std::unique_ptr<PendingRequest> request = std::move(pending_request_);
+    send(request->domain_, request->descriptors_, *request->parent_span_, *request->stream_info_,
+         request->hits_addend_);
+  }
+  client_->detach();
+}
+
+void OverLimitCacheClient::limit(RequestCallbacks& callbacks, const std::string& domain,
+                                 const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                                 Tracing::Span& parent_span,
+                                 const StreamInfo::StreamInfo& stream_info, uint32_t hits_addend) {
+  ASSERT(callbacks_ == nullptr);
+  callbacks_ = &callbacks;
+  descriptor_keys_.clear();
+  request_key_.clear();
+
+  // Requests returning hits to the service must reach it, whatever the state of the descriptors.
+  const bool cacheable =
+      std::none_of(descriptors.begin(), descriptors.end(),
+                   [](const Envoy::RateLimit::Descriptor& d) { return d.is_negative_hits_; });
+  if (!cacheable) {
+    client_->limit(*this, domain, descriptors, parent_span, stream_info, hits_addend);
+    return;
+  }
+
+  bool over_limit = false;
+  auto descriptor_statuses = std::make_unique<DescriptorStatusList>(descriptors.size());
+  descriptor_keys_.reserve(descriptors.size());
+  for (size_t i = 0; i < descriptors.size(); i++) {
+    descriptor_keys_.push_back(OverLimitCache::descriptorKey(domain, descriptors[i]));
+    if (auto status = cache_.find(descriptor_keys_.back()); status.has_value()) {
+      (*descriptor_statuses)[i] = std::move(status.value());
+      over_limit = true;
+    }
+  }
+  if (over_limit) {
+    ENVOY_LOG(debug, "rate limit descriptor over limit until reset, skipping the service call");
+    config_.stats().over_limit_cache_hit_.inc();
+    callbacks_ = nullptr;
+    callbacks.complete(LimitStatus::OverLimit, std::move(descriptor_statuses), nullptr, nullptr,
+                       EMPTY_STRING, nullptr);
+    return;
+  }
+
+  if (config_.coalesceRequests()) {
+    request_key_ = OverLimitCache::requestKey(domain, descriptors, hits_addend);
+    const auto it = cache_.in_flight_.find(request_key_);
+    if (it != cache_.in_flight_.end()) {
+      config_.stats().coalesced_requests_.inc();
+      leader_ = it->second;
+      leader_->followers_.push_back(this);
+      pending_request_ = std::make_unique<PendingRequest>(
+          PendingRequest{domain, descriptors, &parent_span, &stream_info, hits_addend});
+      return;
+    }
+  }
+  send(domain, descriptors, parent_span, stream_info, hits_addend);
+}
+
+void OverLimitCacheClient::send(const std::string& domain,
+                                const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                                Tracing::Span& parent_span,
+                                const StreamInfo::StreamInfo& stream_info, uint32_t hits_addend) {
+  if (!request_key_.empty()) {
+    cache_.in_flight_[request_key_] = this;
+  }
+  client_->limit(*this, domain, descriptors, parent_span, stream_info, hits_addend);
+}
+
+void OverLimitCacheClient::handOverFollowers() {
+  if (request_key_.empty()) {
+    return;
+  }
+  const auto it = cache_.in_flight_.find(request_key_);
+  if (it != cache_.in_flight_.end() && it->second == this) {
+    cache_.in_flight_.erase(it);
+  }
+  if (followers_.empty()) {
+    return;
+  }
+
+  std::vector<OverLimitCacheClient*> followers = std::move(followers_);
+  followers_.clear();
+  OverLimitCacheClient* leader = followers.front();
+  leader->leader_ = nullptr;
+  for (auto follower = followers.begin() + 1; follower != followers.end(); ++follower) {
+    (*follower)->leader_ = leader;
+    leader->followers_.push_back(*follower);
+  }
+  const std::unique_ptr<PendingRequest> request = std::move(leader->pending_request_);
+  leader->send(request->domain_, request->descriptors_, *request->parent_span_,
+               *request->stream_info_, request->hits_addend_);
+}
+
+void OverLimitCacheClient::complete(LimitStatus status,
+                                    DescriptorStatusListPtr&& descriptor_statuses,
+                                    Http::ResponseHeaderMapPtr&& response_headers_to_add,
+                                    Http::RequestHeaderMapPtr&& request_headers_to_add,
+                                    const std::string& response_body,
+                                    DynamicMetadataPtr&& dynamic_metadata) {
+  if (!request_key_.empty()) {
+    cache_.in_flight_.erase(request_key_);
+  }
+
+  if (status == LimitStatus::OverLimit && descriptor_statuses != nullptr) {
+    const size_t size = std::min(descriptor_keys_.size(), descriptor_statuses->size());
+    for (size_t i = 0; i < size; i++) {
+      const DescriptorStatus& descriptor_status = (*descriptor_statuses)[i];
+      if (descriptor_status.code() != RateLimitResponse::OVER_LIMIT ||
+          !descriptor_status.has_duration_until_reset()) {
+        continue;
+      }
+      const std::chrono::milliseconds duration_until_reset(
+          Protobuf::util::TimeUtil::DurationToMilliseconds(
+              descriptor_status.duration_until_reset()));
+      if (duration_until_reset.count() > 0 &&
+          cache_.insert(descriptor_keys_[i], descriptor_status, duration_until_reset)) {
+        config_.stats().over_limit_cache_eviction_.inc();
+      }
+    }
+  }
+
+  // The coalesced requests are completed first, as completing this one may destroy this client.
+  std::vector<OverLimitCacheClient*> followers = std::move(followers_);
+  followers_.clear();
+  for (OverLimitCacheClient* follower : followers) {
+    follower->onLeaderComplete(status, descriptor_statuses.get(), response_headers_to_add.get(),
+                               request_headers_to_add.get(), response_body,
+                               dynamic_metadata.get());
+  }
+
+  RequestCallbacks* callbacks = callbacks_;
+  callbacks_ = nullptr;
+  ASSERT(callbacks != nullptr);
+  callbacks->complete(status, std::move(descriptor_statuses), std::move(response_headers_to_add),
+                      std::move(request_headers_to_add), response_body,
+                      std::move(dynamic_metadata));
+}
+
+void OverLimitCacheClient::onLeaderComplete(LimitStatus status,
+                                            const DescriptorStatusList* descriptor_statuses,
+                                            const Http::ResponseHeaderMap* response_headers_to_add,
+                                            const Http::RequestHeaderMap* request_headers_to_add,
+                                            const std::string& response_body,
+                                            const Protobuf::Struct* dynamic_metadata) {
+  leader_ = nullptr;
+  pending_request_.reset();
+  RequestCallbacks* callbacks = callbacks_;
+  callbacks_ = nullptr;
+  ASSERT(callbacks != nullptr);
+  callbacks->complete(
+      status,
+      descriptor_statuses != nullptr
+          ? std::make_unique<DescriptorStatusList>(*descriptor_statuses)
+          : nullptr,
+      response_headers_to_add != nullptr
+          ? Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*response_headers_to_add)
+          : nullptr,
+      request_headers_to_add != nullptr
+          ? Http::createHeaderMap<Http::RequestHeaderMapImpl>(*request_headers_to_add)
+          : nullptr,
+      response_body,
+      dynamic_metadata != nullptr ? std::make_unique<Protobuf::Struct>(*dynamic_metadata)
+                                  : nullptr);
+}
+
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/ratelimit/ratelimit.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/filters/common/ratelimit/ratelimit.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+
+/**
+ * All over limit cache stats. @see stats_macros.h
+ */
+#define ALL_OVER_LIMIT_CACHE_STATS(COUNTER)                                                        \
+  COUNTER(over_limit_cache_hit)                                                                    \
+  COUNTER(over_limit_cache_eviction)                                                               \
+  COUNTER(coalesced_requests)
+
+/**
+ * Struct definition for all over limit cache stats. @see stats_macros.h
+ */
+struct OverLimitCacheStats {
+  ALL_OVER_LIMIT_CACHE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+class OverLimitCacheClient;
+
+/**
+ * The descriptors of a worker known to be over limit until their reset time, and the rate limit
+ * requests of the worker in flight, by request.
+ */
+class OverLimitCache : public ThreadLocal::ThreadLocalObject {
+public:
+  OverLimitCache(uint32_t max_entries, TimeSource& time_source)
+      : max_entries_(max_entries), time_source_(time_source) {}
+
+  /**
+   * @return the status of a descriptor over limit, with the time left until its reset, or nullopt
+   *         if the descriptor is not known to be over limit.
+   */
+  std::optional<envoy::service::ratelimit::v3::RateLimitResponse::DescriptorStatus>
+  find(const std::string& key);
+
+  /**
+   * Records that a descriptor is over limit until its reset.
+   * @return true if an entry was evicted to make room for the descriptor.
+   */
+  bool insert(const std::string& key,
+              const envoy::service::ratelimit::v3::RateLimitResponse::DescriptorStatus& status,
+              std::chrono::milliseconds duration_until_reset);
+
+  size_t size() const { return entries_.size(); }
+
+  /**
+   * @return the over limit cache key of a descriptor.
+   */
+  static std::string descriptorKey(const std::string& domain,
+                                   const Envoy::RateLimit::Descriptor& descriptor);
+
+  /**
+   * @return the key of a rate limit request, identical for the requests that can be coalesced.
+   */
+  static std::string requestKey(const std::string& domain,
+                                const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                                uint32_t hits_addend);
+
+  // The clients sending the requests in flight, by request key.
+  absl::flat_hash_map<std::string, OverLimitCacheClient*> in_flight_;
+
+private:
+  struct Entry {
+    std::string key_;
+    MonotonicTime reset_time_;
+    envoy::service::ratelimit::v3::RateLimitResponse::DescriptorStatus status_;
+  };
+
+  const uint32_t max_entries_;
+  TimeSource& time_source_;
+  // Ordered from the most to the least recently used.
+  std::list<Entry> entries_;
+  absl::flat_hash_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+/**
+ * The configuration of the over limit cache of a filter, and the cache of the current worker.
+ */
+class OverLimitCacheConfig {
+public:
+  OverLimitCacheConfig(uint32_t max_entries, bool coalesce_requests,
+                       ThreadLocal::SlotAllocator& tls, const OverLimitCacheStats& stats);
+
+  bool coalesceRequests() const { return coalesce_requests_; }
+  OverLimitCacheStats& stats() { return stats_; }
+  OverLimitCache& cache() { return *tls_; }
+
+  static constexpr uint32_t DefaultMaxEntries = 10000;
+
+private:
+  const bool coalesce_requests_;
+  OverLimitCacheStats stats_;
+  ThreadLocal::TypedSlotPtr<OverLimitCache> tls_;
+};
+
+using OverLimitCacheConfigSharedPtr = std::shared_ptr<OverLimitCacheConfig>;
+
+/**
+ * A client completing the requests with a descriptor known to be over limit without calling the
+ * rate limit service, and optionally coalescing identical requests in flight on the worker. The
+ * requests not served locally are sent through the wrapped client.
+ */
+class OverLimitCacheClient : public Client,
+                             public RequestCallbacks,
+                             public Logger::Loggable<Logger::Id::filter> {
+public:
+  OverLimitCacheClient(ClientPtr&& client, OverLimitCacheConfig& config)
+      : client_(std::move(client)), config_(config), cache_(config.cache()) {}
+  ~OverLimitCacheClient() override;
+
+  // Client
+  void cancel() override;
+  void detach() override;
+  void limit(RequestCallbacks& callbacks, const std::string& domain,
+             const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+             Tracing::Span& parent_span, const StreamInfo::StreamInfo& stream_info,
+             uint32_t hits_addend) override;
+
+  // RequestCallbacks
+  void complete(LimitStatus status, DescriptorStatusListPtr&& descriptor_statuses,
+                Http::ResponseHeaderMapPtr&& response_headers_to_add,
+                Http::RequestHeaderMapPtr&& request_headers_to_add,
+                const std::string& response_body, DynamicMetadataPtr&& dynamic_metadata) override;
+
+private:
+  // Sends the request through the wrapped client, leading the requests coalesced with it if any.
+  void send(const std::string& domain, const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+            Tracing::Span& parent_span, const StreamInfo::StreamInfo& stream_info,
+            uint32_t hits_addend);
+  // Stops leading the coalesced requests, and sends the first one to lead the others.
+  void handOverFollowers();
+  // Completes a coalesced request with a copy of the response of its leader.
+  void onLeaderComplete(LimitStatus status, const DescriptorStatusList* descriptor_statuses,
+                        const Http::ResponseHeaderMap* response_headers_to_add,
+                        const Http::RequestHeaderMap* request_headers_to_add,
+                        const std::string& response_body,
+                        const Protobuf::Struct* dynamic_metadata);
+
+  ClientPtr client_;
+  OverLimitCacheConfig& config_;
+  OverLimitCache& cache_;
+  RequestCallbacks* callbacks_{};
+  std::vector<std::string> descriptor_keys_;
+  // The key of the request when it can be coalesced.
+  std::string request_key_;
+  // Set while the request is coalesced with the request of another client.
+  OverLimitCacheClient* leader_{};
+  // The clients whose requests are coalesced with the request of this one.
+  std::vector<OverLimitCacheClient*> followers_;
+
+  // The arguments of a coalesced request, to send it if its leader is cancelled.
+  struct PendingRequest {
+    std::string domain_;
+    std::vector<Envoy::RateLimit::Descriptor> descriptors_;
+    Tracing::Span* parent_span_;
+    const StreamInfo::StreamInfo* stream_info_;
+    uint32_t hits_addend_;
+  };
+  std::unique_ptr<PendingRequest> pending_request_;
+};
+
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -64,6 +64,17 @@ RoleBasedAccessControlEngineImpl::RoleBasedAccessControlEngineImpl(
                           policy.second, validation_visitor, context,
                           builder_with_arena_ ? builder_with_arena_->builder_instance_ : nullptr));
   }
+
+  if (rules.index_policies()) {
+    std::vector<const envoy::config::rbac::v3::Policy*> policies;
+    policies.reserve(policies_.size());
+    ordered_policies_.reserve(policies_.size());
+    for (auto it = policies_.cbegin(); it != policies_.cend(); ++it) {
+      policies.push_back(&rules.policies().at(it->first));
+      ordered_policies_.push_back(it);
+    }
+    policy_index_ = std::make_unique<PolicyIndex>(policies);
+  }
 }
 
 bool RoleBasedAccessControlEngineImpl::handleAction(const Network::Connection& connection,
@@ -97,6 +108,22 @@ bool RoleBasedAccessControlEngineImpl::handleAction(const Network::Connection& c
 bool RoleBasedAccessControlEngineImpl::checkPolicyMatch(
     const Network::Connection& connection, const StreamInfo::StreamInfo& info,
     const Envoy::Http::RequestHeaderMap& headers, std::string* effective_policy_id) const {
+  if (policy_index_ != nullptr) {
+    // Only the policies which may match are evaluated, in the same order as without the index.
+    std::vector<uint32_t> candidates;
+    policy_index_->candidates(connection, headers, info, candidates);
+    for (const uint32_t position : candidates) {
+      const auto& policy = *ordered_policies_[position];
+      if (policy.second->matches(connection, headers, info)) {
+        if (effective_policy_id != nullptr) {
+          *effective_policy_id = policy.first;
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
   bool matched = false;
 
   for (const auto& policy : policies_) {
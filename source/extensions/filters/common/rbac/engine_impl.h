@@ -6,6 +6,7 @@
 #include "source/common/matcher/matcher.h"
 #include "source/extensions/filters/common/rbac/engine.h"
 #include "source/extensions/filters/common/rbac/matchers.h"
+#include "source/extensions/filters/common/rbac/policy_index.h"
 
 #include "xds/type/matcher/v3/matcher.pb.h"
 
@@ -93,6 +94,10 @@ private:
   const EnforcementMode mode_;
 
   std::map<std::string, std::unique_ptr<PolicyMatcher>> policies_;
+  // Set when the policies are indexed, along with the policies in evaluation order.
+  std::unique_ptr<PolicyIndex> policy_index_;
+  std::vector<std::map<std::string, std::unique_ptr<PolicyMatcher>>::const_iterator>
+      ordered_policies_;
   // Arena-based builder for when cel_config is not used.
   std::unique_ptr<ExprBuilderWithArena> builder_with_arena_;
 };
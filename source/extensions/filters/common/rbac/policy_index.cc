@@ -0,0 +1,275 @@
+#include "source/extensions/filters/common/rbac/policy_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "source/common/http/header_utility.h"
+#include "source/common/http/path_utility.h"
+#include "source/common/network/cidr_range.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+
+namespace {
+
+using Requirement = PolicyIndex::Requirement;
+using RequirementPtr = std::unique_ptr<Requirement>;
+
+RequirementPtr pathRequirement(const envoy::type::matcher::v3::PathMatcher& path_matcher) {
+  if (!path_matcher.has_path() || path_matcher.path().ignore_case()) {
+    return nullptr;
+  }
+  // An exact path is also a prefix of the paths it matches.
+  const auto& matcher = path_matcher.path();
+  std::string prefix;
+  switch (matcher.match_pattern_case()) {
+  case envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kExact:
+    prefix = matcher.exact();
+    break;
+  case envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kPrefix:
+    prefix = matcher.prefix();
+    break;
+  default:
+    return nullptr;
+  }
+  auto requirement = std::make_unique<Requirement>();
+  requirement->kind_ = Requirement::Kind::PathPrefix;
+  requirement->values_.push_back(std::move(prefix));
+  return requirement;
+}
+
+RequirementPtr headerRequirement(const envoy::config::route::v3::HeaderMatcher& header_matcher) {
+  if (header_matcher.invert_match() || header_matcher.treat_missing_header_as_empty()) {
+    return nullptr;
+  }
+  std::string value;
+  if (header_matcher.header_match_specifier_case() ==
+      envoy::config::route::v3::HeaderMatcher::HeaderMatchSpecifierCase::kExactMatch) {
+    value = header_matcher.exact_match();
+  } else if (header_matcher.has_string_match() && !header_matcher.string_match().ignore_case() &&
+             header_matcher.string_match().match_pattern_case() ==
+                 envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kExact) {
+    value = header_matcher.string_match().exact();
+  } else {
+    return nullptr;
+  }
+  auto requirement = std::make_unique<Requirement>();
+  requirement->kind_ = Requirement::Kind::HeaderValue;
+  requirement->header_name_ = Envoy::Http::LowerCaseString(header_matcher.name()).get();
+  requirement->values_.push_back(std::move(value));
+  return requirement;
+}
+
+RequirementPtr ipRequirement(const envoy::config::core::v3::CidrRange& range,
+                             IPMatcher::Type type) {
+  auto cidr_range = Network::Address::CidrRange::create(range);
+  if (!cidr_range.ok()) {
+    return nullptr;
+  }
+  auto requirement = std::make_unique<Requirement>();
+  requirement->kind_ = Requirement::Kind::IpRange;
+  requirement->ip_type_ = type;
+  requirement->ranges_.push_back(std::move(cidr_range.value()));
+  return requirement;
+}
+
+// The requirement of a conjunction is the requirement of any of its operands.
+template <class T, class RequirementFn>
+RequirementPtr allOf(const Protobuf::RepeatedPtrField<T>& operands, RequirementFn requirement_fn) {
+  for (const T& operand : operands) {
+    if (auto requirement = requirement_fn(operand); requirement != nullptr) {
+      return requirement;
+    }
+  }
+  return nullptr;
+}
+
+// A disjunction requires either of the requirements of its operands, which must all be of the same
+// kind to be looked up in the same index.
+template <class T, class RequirementFn>
+RequirementPtr anyOf(const Protobuf::RepeatedPtrField<T>& operands, RequirementFn requirement_fn) {
+  RequirementPtr result;
+  for (const T& operand : operands) {
+    RequirementPtr requirement = requirement_fn(operand);
+    if (requirement == nullptr) {
+      return nullptr;
+    }
+    if (result == nullptr) {
+      result = std::move(requirement);
+      continue;
+    }
+    if (requirement->kind_ != result->kind_ || requirement->header_name_ != result->header_name_ ||
+        requirement->ip_type_ != result->ip_type_) {
+      return nullptr;
+    }
+    std::move(requirement->values_.begin(), requirement->values_.end(),
+              std::back_inserter(result->values_));
+    std::move(requirement->ranges_.begin(), requirement->ranges_.end(),
+              std::back_inserter(result->ranges_));
+  }
+  return result;
+}
+
+RequirementPtr permissionRequirement(const envoy::config::rbac::v3::Permission& permission) {
+  using Permission = envoy::config::rbac::v3::Permission;
+  switch (permission.rule_case()) {
+  case Permission::RuleCase::kAndRules:
+    return allOf(permission.and_rules().rules(), permissionRequirement);
+  case Permission::RuleCase::kOrRules:
+    return anyOf(permission.or_rules().rules(), permissionRequirement);
+  case Permission::RuleCase::kHeader:
+    return headerRequirement(permission.header());
+  case Permission::RuleCase::kUrlPath:
+    return pathRequirement(permission.url_path());
+  case Permission::RuleCase::kDestinationIp:
+    return ipRequirement(permission.destination_ip(), IPMatcher::Type::DownstreamLocal);
+  default:
+    return nullptr;
+  }
+}
+
+RequirementPtr principalRequirement(const envoy::config::rbac::v3::Principal& principal) {
+  using Principal = envoy::config::rbac::v3::Principal;
+  switch (principal.identifier_case()) {
+  case Principal::IdentifierCase::kAndIds:
+    return allOf(principal.and_ids().ids(), principalRequirement);
+  case Principal::IdentifierCase::kOrIds:
+    return anyOf(principal.or_ids().ids(), principalRequirement);
+  case Principal::IdentifierCase::kHeader:
+    return headerRequirement(principal.header());
+  case Principal::IdentifierCase::kUrlPath:
+    return pathRequirement(principal.url_path());
+  case Principal::IdentifierCase::kSourceIp:
+    return ipRequirement(principal.source_ip(), IPMatcher::Type::ConnectionRemote);
+  case Principal::IdentifierCase::kDirectRemoteIp:
+    return ipRequirement(principal.direct_remote_ip(), IPMatcher::Type::DownstreamDirectRemote);
+  case Principal::IdentifierCase::kRemoteIp:
+    return ipRequirement(principal.remote_ip(), IPMatcher::Type::DownstreamRemote);
+  default:
+    return nullptr;
+  }
+}
+
+void addPositions(const std::vector<uint32_t>& positions, std::vector<uint32_t>& candidates) {
+  candidates.insert(candidates.end(), positions.begin(), positions.end());
+}
+
+} // namespace
+
+std::unique_ptr<PolicyIndex::Requirement>
+PolicyIndex::requirement(const envoy::config::rbac::v3::Policy& policy) {
+  // A policy matches when any of its permissions and any of its principals match.
+  if (auto requirement = anyOf(policy.permissions(), permissionRequirement);
+      requirement != nullptr) {
+    return requirement;
+  }
+  return anyOf(policy.principals(), principalRequirement);
+}
+
+PolicyIndex::PolicyIndex(const std::vector<const envoy::config::rbac::v3::Policy*>& policies) {
+  std::array<std::vector<std::pair<uint32_t, std::vector<Network::Address::CidrRange>>>, 4>
+      ip_ranges;
+  for (uint32_t position = 0; position < policies.size(); position++) {
+    const RequirementPtr policy_requirement = requirement(*policies[position]);
+    if (policy_requirement == nullptr) {
+      unindexed_.push_back(position);
+      continue;
+    }
+
+    indexed_policies_++;
+    switch (policy_requirement->kind_) {
+    case Requirement::Kind::PathPrefix:
+      for (const std::string& prefix : policy_requirement->values_) {
+        path_prefixes_[prefix].push_back(position);
+      }
+      break;
+    case Requirement::Kind::HeaderValue: {
+      const Envoy::Http::LowerCaseString name(policy_requirement->header_name_);
+      auto it = std::find_if(header_values_.begin(), header_values_.end(),
+                             [&name](const auto& header) { return header.first == name; });
+      if (it == header_values_.end()) {
+        it = header_values_.emplace(header_values_.end(), name,
+                                    absl::flat_hash_map<std::string, Positions>());
+      }
+      for (const std::string& value : policy_requirement->values_) {
+        it->second[value].push_back(position);
+      }
+      break;
+    }
+    case Requirement::Kind::IpRange:
+      ip_ranges[policy_requirement->ip_type_].emplace_back(position,
+                                                           std::move(policy_requirement->ranges_));
+      break;
+    }
+  }
+
+  // The positions are not moved anymore once all the policies are indexed.
+  for (const auto& [prefix, positions] : path_prefixes_) {
+    path_tree_.add(prefix, &positions);
+  }
+  for (size_t type = 0; type < ip_ranges.size(); type++) {
+    if (!ip_ranges[type].empty()) {
+      ip_tries_[type] = std::make_unique<Network::LcTrie::LcTrie<uint32_t>>(ip_ranges[type]);
+    }
+  }
+}
+
+void PolicyIndex::candidates(const Network::Connection& connection,
+                             const Envoy::Http::RequestHeaderMap& headers,
+                             const StreamInfo::StreamInfo& info,
+                             std::vector<uint32_t>& candidates) const {
+  candidates.assign(unindexed_.begin(), unindexed_.end());
+
+  if (!path_prefixes_.empty() && headers.Path() != nullptr) {
+    const absl::string_view path = Envoy::Http::PathUtil::removeQueryAndFragment(
+        headers.getPathValue());
+    for (const Positions* positions : path_tree_.findMatchingPrefixes(path)) {
+      addPositions(*positions, candidates);
+    }
+  }
+
+  for (const auto& [name, values] : header_values_) {
+    const auto header = headers.get(name);
+    if (header.empty()) {
+      continue;
+    }
+    // The header values are matched either joined or individually, depending on a runtime flag.
+    const auto joined = Envoy::Http::HeaderUtility::getAllOfHeaderAsString(header);
+    if (const auto it = values.find(joined.result().value()); it != values.end()) {
+      addPositions(it->second, candidates);
+    }
+    if (header.size() > 1) {
+      for (size_t i = 0; i < header.size(); i++) {
+        if (const auto it = values.find(header[i]->value().getStringView()); it != values.end()) {
+          addPositions(it->second, candidates);
+        }
+      }
+    }
+  }
+
+  for (size_t type = 0; type < ip_tries_.size(); type++) {
+    if (ip_tries_[type] == nullptr) {
+      continue;
+    }
+    const auto& address =
+        IPMatcher::extractIpAddress(static_cast<IPMatcher::Type>(type), connection, info);
+    if (address == nullptr || address->ip() == nullptr) {
+      continue;
+    }
+    addPositions(ip_tries_[type]->getData(address), candidates);
+  }
+
+  if (candidates.size() > unindexed_.size()) {
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+  }
+}
+
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
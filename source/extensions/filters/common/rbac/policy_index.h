@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/config/rbac/v3/rbac.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/network/connection.h"
+#include "envoy/stream_info/stream_info.h"
+
+#include "source/common/common/radix_tree.h"
+#include "source/common/network/lc_trie.h"
+#include "source/extensions/filters/common/rbac/matchers.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+
+/**
+ * An index of the policies of an RBAC engine by a predicate each of them requires to match: a path
+ * prefix, an exact header value or an IP range. The policies without such a predicate are never
+ * ruled out. The index only narrows down the policies to evaluate, their matchers still decide.
+ */
+class PolicyIndex {
+public:
+  /**
+   * @param policies the policies, in evaluation order.
+   */
+  explicit PolicyIndex(const std::vector<const envoy::config::rbac::v3::Policy*>& policies);
+
+  /**
+   * Sets the positions of the policies which may match a request, in increasing order.
+   */
+  void candidates(const Network::Connection& connection,
+                  const Envoy::Http::RequestHeaderMap& headers, const StreamInfo::StreamInfo& info,
+                  std::vector<uint32_t>& candidates) const;
+
+  /**
+   * @return the number of policies ruled out by the index when they don't match its predicates.
+   */
+  size_t indexedPolicies() const { return indexed_policies_; }
+
+  // A predicate required by a permission, a principal or a policy to match.
+  struct Requirement {
+    enum class Kind { PathPrefix, HeaderValue, IpRange };
+
+    Kind kind_;
+    // The header of a HeaderValue requirement.
+    std::string header_name_;
+    // The address of an IpRange requirement.
+    IPMatcher::Type ip_type_{};
+    // Either of which is required: the path prefixes or the header values.
+    std::vector<std::string> values_;
+    std::vector<Network::Address::CidrRange> ranges_;
+  };
+
+  /**
+   * @return the requirement of a policy, if any.
+   */
+  static std::unique_ptr<Requirement> requirement(const envoy::config::rbac::v3::Policy& policy);
+
+private:
+  using Positions = std::vector<uint32_t>;
+
+  // The positions of the policies by path prefix.
+  absl::flat_hash_map<std::string, Positions> path_prefixes_;
+  RadixTree<const Positions*> path_tree_;
+  // The positions of the policies by header, then by exact header value.
+  std::vector<std::pair<Envoy::Http::LowerCaseString, absl::flat_hash_map<std::string, Positions>>>
+      header_values_;
+  // The positions of the policies by IP range, for each address type.
+  std::array<std::unique_ptr<Network::LcTrie::LcTrie<uint32_t>>, 4> ip_tries_;
+  // The positions of the policies which are always evaluated.
+  Positions unindexed_;
+  size_t indexed_policies_{};
+};
+
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
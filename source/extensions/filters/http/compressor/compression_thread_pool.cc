@@ -0,0 +1,77 @@
+#include "source/extensions/filters/http/compressor/compression_thread_pool.h"
+
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+CompressionThreadPool::CompressionThreadPool(
+    const envoy::extensions::filters::http::compressor::v3::Compressor::CompressionThreadPool&
+        config,
+    Thread::ThreadFactory& thread_factory, const std::string& stats_prefix, Stats::Scope& scope)
+    : min_chunk_size_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, min_chunk_size, DefaultMinChunkSize)),
+      max_queued_chunks_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_queued_chunks, DefaultMaxQueuedChunks)),
+      scope_(scope.createScope(stats_prefix)),
+      stats_{ALL_COMPRESSION_THREAD_POOL_STATS(
+          POOL_COUNTER(*scope_), POOL_GAUGE(*scope_), POOL_HISTOGRAM(*scope_))} {
+  const uint32_t thread_count = std::max(1U, config.thread_count());
+  threads_.reserve(thread_count);
+  for (uint32_t i = 0; i < thread_count; i++) {
+    threads_.emplace_back(
+        thread_factory.createThread([this]() { worker(); }, Thread::Options{"compressor"}));
+  }
+}
+
+CompressionThreadPool::~CompressionThreadPool() {
+  {
+    absl::MutexLock lock(mutex_);
+    terminate_ = true;
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+  absl::MutexLock lock(mutex_);
+  stats_.chunks_queued_.sub(queue_.size());
+}
+
+bool CompressionThreadPool::trySchedule(std::function<void()> work) {
+  {
+    absl::MutexLock lock(mutex_);
+    if (queue_.size() >= max_queued_chunks_) {
+      stats_.chunks_rejected_.inc();
+      return false;
+    }
+    queue_.push(std::move(work));
+  }
+  stats_.chunks_queued_.inc();
+  return true;
+}
+
+void CompressionThreadPool::worker() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !queue_.empty() || terminate_;
+  };
+  while (true) {
+    std::function<void()> work;
+    {
+      absl::MutexLock lock(mutex_);
+      mutex_.Await(absl::Condition(&condition));
+      if (terminate_) {
+        return;
+      }
+      work = std::move(queue_.front());
+      queue_.pop();
+    }
+    stats_.chunks_queued_.dec();
+    work();
+  }
+}
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+/**
+ * All compression thread pool stats. @see stats_macros.h
+ * "compression_time" is the time from queuing a chunk to resuming its stream with the compressed
+ * chunk, including the time spent waiting for a pool thread.
+ */
+#define ALL_COMPRESSION_THREAD_POOL_STATS(COUNTER, GAUGE, HISTOGRAM)                               \
+  COUNTER(chunks_compressed)                                                                       \
+  COUNTER(chunks_rejected)                                                                         \
+  GAUGE(chunks_queued, Accumulate)                                                                 \
+  HISTOGRAM(compression_time, Milliseconds)
+
+/**
+ * Struct definition for all compression thread pool stats. @see stats_macros.h
+ */
+struct CompressionThreadPoolStats {
+  ALL_COMPRESSION_THREAD_POOL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                                    GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * A bounded pool of threads compressing the large response data chunks of the streams of all the
+ * workers using a compressor filter configuration. The work is run in the order in which it is
+ * queued. Work that is still queued when the pool is destroyed is dropped. The pool joins its
+ * threads when it is destroyed, so it must be destroyed on the main thread.
+ */
+class CompressionThreadPool : Logger::Loggable<Logger::Id::filter> {
+public:
+  CompressionThreadPool(
+      const envoy::extensions::filters::http::compressor::v3::Compressor::CompressionThreadPool&
+          config,
+      Thread::ThreadFactory& thread_factory, const std::string& stats_prefix, Stats::Scope& scope);
+  ~CompressionThreadPool();
+
+  /**
+   * Queues work to be run on one of the pool threads.
+   * @return false, without queuing the work, if max_queued_chunks chunks are queued already.
+   */
+  bool trySchedule(std::function<void()> work);
+
+  uint64_t minChunkSize() const { return min_chunk_size_; }
+  CompressionThreadPoolStats& stats() { return stats_; }
+
+  static constexpr uint64_t DefaultMinChunkSize = 64 * 1024;
+  static constexpr uint64_t DefaultMaxQueuedChunks = 64;
+
+private:
+  void worker();
+
+  const uint64_t min_chunk_size_;
+  const uint64_t max_queued_chunks_;
+  // Owned so that the stats outlive the filter configuration, which may be destroyed first.
+  const Stats::ScopeSharedPtr scope_;
+  CompressionThreadPoolStats stats_;
+  absl::Mutex mutex_;
+  std::queue<std::function<void()>> queue_ ABSL_GUARDED_BY(mutex_);
+  bool terminate_ ABSL_GUARDED_BY(mutex_) = false;
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+using CompressionThreadPoolPtr = std::unique_ptr<CompressionThreadPool>;
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
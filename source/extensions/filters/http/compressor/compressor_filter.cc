@@ -7,6 +7,7 @@
 #include "envoy/registry/registry.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/thread.h"
 #include "source/common/config/utility.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/utility.h"
@@ -14,6 +15,7 @@
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -100,7 +102,8 @@ CompressorFilterConfig::DirectionConfig::DirectionConfig(
 CompressorFilterConfig::CompressorFilterConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
     const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
-    Compression::Compressor::CompressorFactoryPtr compressor_factory)
+    Compression::Compressor::CompressorFactoryPtr compressor_factory,
+    Thread::ThreadFactory& thread_factory, Event::Dispatcher& main_thread_dispatcher)
     : common_stats_prefix_(fmt::format("{}compressor.{}.{}", stats_prefix,
                                        proto_config.compressor_library().name(),
                                        compressor_factory->statsPrefix())),
@@ -108,7 +111,22 @@ CompressorFilterConfig::CompressorFilterConfig(
       response_direction_config_(proto_config, common_stats_prefix_, scope, runtime),
       content_encoding_(compressor_factory->contentEncoding()),
       compressor_factory_(std::move(compressor_factory)),
-      choose_first_(proto_config.choose_first()) {}
+      choose_first_(proto_config.choose_first()), main_thread_dispatcher_(main_thread_dispatcher),
+      compression_thread_pool_(
+          proto_config.has_compression_thread_pool()
+              ? std::make_unique<CompressionThreadPool>(proto_config.compression_thread_pool(),
+                                                        thread_factory,
+                                                        common_stats_prefix_ + "thread_pool.",
+                                                        scope)
+              : nullptr) {}
+
+CompressorFilterConfig::~CompressorFilterConfig() {
+  // The last stream using the configuration may be destroyed on a worker thread, which must not
+  // block on joining the threads of the pool, so they are joined on the main thread.
+  if (compression_thread_pool_ != nullptr && !Thread::MainThread::isMainOrTestThread()) {
+    main_thread_dispatcher_.post([thread_pool = std::move(compression_thread_pool_)]() {});
+  }
+}
 
 StringUtil::CaseUnorderedSet CompressorFilterConfig::DirectionConfig::contentTypeSet(
     const Protobuf::RepeatedPtrField<std::string>& types) {
@@ -466,14 +484,158 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeadersWithStatusHeader(
 }
 
 Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (offloaded_chunk_ != nullptr) {
+    // The data is compressed after the chunk being compressed, to keep the response in order.
+    pending_response_data_.move(data);
+    pending_response_end_stream_ = end_stream;
+    const uint64_t buffer_limit = encoder_callbacks_->bufferLimit();
+    if (!above_write_buffer_high_watermark_ && buffer_limit > 0 &&
+        pending_response_data_.length() > buffer_limit) {
+      above_write_buffer_high_watermark_ = true;
+      encoder_callbacks_->onEncoderFilterAboveWriteBufferHighWatermark();
+    }
+    return Http::FilterDataStatus::StopIterationNoBuffer;
+  }
   if (response_compressor_ != nullptr) {
+    if (offloadResponseChunk(data, end_stream)) {
+      return Http::FilterDataStatus::StopIterationNoBuffer;
+    }
     compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(), data,
                            end_stream);
   }
   return Http::FilterDataStatus::Continue;
 }
 
+// A response chunk compressed by the compression thread pool. The chunk owns the compressor of
+// the stream until it is compressed, so that the compressor is only used by one thread at a time.
+struct CompressorFilter::OffloadedChunk {
+  OffloadedChunk(CompressorFilter& filter, Event::Dispatcher& dispatcher)
+      : filter_(filter), dispatcher_(dispatcher) {}
+
+  CompressorFilter& filter_;
+  Event::Dispatcher& dispatcher_;
+  Compression::Compressor::CompressorPtr compressor_;
+  Buffer::OwnedImpl data_;
+  uint64_t uncompressed_length_{};
+  bool end_stream_{};
+  MonotonicTime queued_time_;
+  absl::Mutex mutex_;
+  // Set when the stream is destroyed before the chunk is compressed. The pool thread posts the
+  // compressed chunk to the dispatcher while holding the mutex, so that it never posts to the
+  // dispatcher of a stream that is gone.
+  bool cancelled_ ABSL_GUARDED_BY(mutex_){};
+};
+
+bool CompressorFilter::offloadResponseChunk(Buffer::Instance& data, bool end_stream) {
+  CompressionThreadPool* thread_pool = config_->compressionThreadPool();
+  if (thread_pool == nullptr || data.length() < thread_pool->minChunkSize() ||
+      !getCompressorFactory().supportsOffload()) {
+    return false;
+  }
+
+  auto chunk = std::make_shared<OffloadedChunk>(*this, encoder_callbacks_->dispatcher());
+  // The data is copied rather than moved so that its slices, which may be charged to the memory
+  // account of the stream, are released on the worker thread.
+  chunk->data_.add(data);
+  chunk->uncompressed_length_ = data.length();
+  chunk->end_stream_ = end_stream;
+  chunk->compressor_ = std::move(response_compressor_);
+  chunk->queued_time_ = chunk->dispatcher_.timeSource().monotonicTime();
+  // The work only references the chunk, as the filter configuration may be destroyed while it is
+  // queued. The stats are updated once the stream is resumed.
+  const bool scheduled = thread_pool->trySchedule([chunk]() {
+    {
+      absl::MutexLock lock(chunk->mutex_);
+      if (chunk->cancelled_) {
+        return;
+      }
+    }
+    chunk->compressor_->compress(chunk->data_,
+                                 chunk->end_stream_
+                                     ? Envoy::Compression::Compressor::State::Finish
+                                     : Envoy::Compression::Compressor::State::Flush);
+    absl::MutexLock lock(chunk->mutex_);
+    if (!chunk->cancelled_) {
+      chunk->dispatcher_.post([chunk]() {
+        {
+          absl::MutexLock lock(chunk->mutex_);
+          if (chunk->cancelled_) {
+            return;
+          }
+        }
+        chunk->filter_.onResponseChunkCompressed();
+      });
+    }
+  });
+  if (!scheduled) {
+    // The pool is saturated.
+    response_compressor_ = std::move(chunk->compressor_);
+    return false;
+  }
+
+  data.drain(data.length());
+  offloaded_chunk_ = std::move(chunk);
+  return true;
+}
+
+void CompressorFilter::onResponseChunkCompressed() {
+  OffloadedChunkSharedPtr chunk = std::move(offloaded_chunk_);
+  CompressionThreadPoolStats& thread_pool_stats = config_->compressionThreadPool()->stats();
+  thread_pool_stats.chunks_compressed_.inc();
+  thread_pool_stats.compression_time_.recordValue(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          chunk->dispatcher_.timeSource().monotonicTime() - chunk->queued_time_)
+          .count());
+  const CompressorStats& stats = config_->responseDirectionConfig().stats();
+  stats.total_uncompressed_bytes_.add(chunk->uncompressed_length_);
+  stats.total_compressed_bytes_.add(chunk->data_.length());
+  response_compressor_ = std::move(chunk->compressor_);
+  encoder_callbacks_->injectEncodedDataToFilterChain(chunk->data_, chunk->end_stream_);
+  if (chunk->end_stream_) {
+    return;
+  }
+
+  if (pending_response_data_.length() > 0 || pending_response_end_stream_) {
+    Buffer::OwnedImpl data;
+    data.move(pending_response_data_);
+    const bool end_stream = pending_response_end_stream_;
+    pending_response_end_stream_ = false;
+    if (above_write_buffer_high_watermark_) {
+      above_write_buffer_high_watermark_ = false;
+      encoder_callbacks_->onEncoderFilterBelowWriteBufferLowWatermark();
+    }
+    if (offloadResponseChunk(data, end_stream)) {
+      return;
+    }
+    compressAndUpdateStats(response_compressor_, stats, data, end_stream);
+    encoder_callbacks_->injectEncodedDataToFilterChain(data, end_stream);
+    if (end_stream) {
+      return;
+    }
+  }
+
+  if (response_trailers_pending_) {
+    response_trailers_pending_ = false;
+    Buffer::OwnedImpl empty_buffer;
+    compressAndUpdateStats(response_compressor_, stats, empty_buffer, true);
+    encoder_callbacks_->injectEncodedDataToFilterChain(empty_buffer, false);
+    encoder_callbacks_->continueEncoding();
+  }
+}
+
+void CompressorFilter::onDestroy() {
+  if (offloaded_chunk_ != nullptr) {
+    absl::MutexLock lock(offloaded_chunk_->mutex_);
+    offloaded_chunk_->cancelled_ = true;
+  }
+}
+
 Http::FilterTrailersStatus CompressorFilter::encodeTrailers(Http::ResponseTrailerMap&) {
+  if (offloaded_chunk_ != nullptr) {
+    // The compression is finished once the chunk being compressed has been sent.
+    response_trailers_pending_ = true;
+    return Http::FilterTrailersStatus::StopIteration;
+  }
   if (response_compressor_ != nullptr) {
     Buffer::OwnedImpl empty_buffer;
     // The presence of trailers means the stream is ended, but encodeData()
@@ -4,13 +4,17 @@
 
 #include "envoy/compression/compressor/factory.h"
 #include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/server/factory_context.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/logger.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/runtime/runtime_protos.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
+#include "source/extensions/filters/http/compressor/compression_thread_pool.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -148,7 +152,9 @@ public:
   CompressorFilterConfig(
       const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
       const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
-      Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory);
+      Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory,
+      Thread::ThreadFactory& thread_factory, Event::Dispatcher& main_thread_dispatcher);
+  ~CompressorFilterConfig();
 
   Envoy::Compression::Compressor::CompressorPtr makeCompressor();
 
@@ -159,6 +165,8 @@ public:
   const Envoy::Compression::Compressor::CompressorFactory& compressorFactory() const {
     return *compressor_factory_;
   }
+  // Returns the pool compressing large response chunks, or nullptr if it is not configured.
+  CompressionThreadPool* compressionThreadPool() const { return compression_thread_pool_.get(); }
 
 private:
   const std::string common_stats_prefix_;
@@ -168,6 +176,8 @@ private:
   const std::string content_encoding_;
   const Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory_;
   const bool choose_first_;
+  Event::Dispatcher& main_thread_dispatcher_;
+  CompressionThreadPoolPtr compression_thread_pool_;
 };
 using CompressorFilterConfigSharedPtr = std::shared_ptr<CompressorFilterConfig>;
 
@@ -221,6 +231,9 @@ public:
   Http::FilterDataStatus encodeData(Buffer::Instance& buffer, bool end_stream) override;
   Http::FilterTrailersStatus encodeTrailers(Http::ResponseTrailerMap&) override;
 
+  // Http::StreamFilterBase
+  void onDestroy() override;
+
   // Grant testing peer access.
   friend class CompressorFilterTestingPeer;
 
@@ -256,6 +269,15 @@ private:
       std::optional<absl::string_view> original_length = std::nullopt);
   void insertVaryHeader(Http::ResponseHeaderMap& headers);
 
+  struct OffloadedChunk;
+  using OffloadedChunkSharedPtr = std::shared_ptr<OffloadedChunk>;
+
+  // Hands the chunk to the compression thread pool if it is large enough and the pool is not
+  // saturated, draining the buffer. Returns false if the chunk must be compressed inline.
+  bool offloadResponseChunk(Buffer::Instance& data, bool end_stream);
+  // Resumes the stream with the chunk compressed by the compression thread pool.
+  void onResponseChunkCompressed();
+
   class EncodingDecision : public StreamInfo::FilterState::Object {
   public:
     enum class HeaderStat { NotValid, Identity, Wildcard, ValidCompressor };
@@ -290,6 +312,15 @@ private:
   std::unique_ptr<std::string> accept_encoding_;
   // Cached per-route configuration pointer, initialized once per stream.
   const CompressorPerRouteFilterConfig* per_route_config_{};
+
+  // The response chunk being compressed by the compression thread pool, if any. The response
+  // compressor is moved to it until it is compressed.
+  OffloadedChunkSharedPtr offloaded_chunk_;
+  // The response data received while a chunk is compressed by the compression thread pool.
+  Buffer::OwnedImpl pending_response_data_;
+  bool pending_response_end_stream_{};
+  bool response_trailers_pending_{};
+  bool above_write_buffer_high_watermark_{};
 };
 
 } // namespace Compressor
@@ -32,9 +32,16 @@ absl::StatusOr<Http::FilterFactoryCb> CompressorFilterFactory::createFilterFacto
       *config_factory);
   Compression::Compressor::CompressorFactoryPtr compressor_factory =
       config_factory->createCompressorFactoryFromProto(*message, context);
+  if (proto_config.has_compression_thread_pool() && !compressor_factory->supportsOffload()) {
+    return absl::InvalidArgumentError(
+        fmt::format("compressor library '{}' can't be used with a compression thread pool",
+                    proto_config.compressor_library().name()));
+  }
+  auto& server_context = context.serverFactoryContext();
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
-      proto_config, stats_prefix, context.scope(), context.serverFactoryContext().runtime(),
-      std::move(compressor_factory));
+      proto_config, stats_prefix, context.scope(), server_context.runtime(),
+      std::move(compressor_factory), server_context.api().threadFactory(),
+      server_context.mainThreadDispatcher());
   return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<CompressorFilter>(config));
   };
@@ -0,0 +1,166 @@
+#include "source/extensions/filters/http/ext_authz/decision_cache.h"
+
+#include <algorithm>
+
+#include "envoy/event/dispatcher.h"
+
+#include "source/common/common/enum_to_int.h"
+#include "source/common/http/codes.h"
+#include "source/common/http/header_utility.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+namespace {
+
+// The longest TTL a response can set, so that it can't overflow the expiry time.
+constexpr int64_t MaxTtlSeconds = 24 * 60 * 60;
+
+std::optional<std::chrono::milliseconds> secondsToTtl(double seconds) {
+  // Also rejects NaN.
+  if (!(seconds >= 1)) {
+    return std::nullopt;
+  }
+  return std::chrono::seconds(
+      static_cast<int64_t>(std::min(seconds, static_cast<double>(MaxTtlSeconds))));
+}
+
+} // namespace
+
+ResponseConstSharedPtr DecisionCache::find(const std::string& key) {
+  absl::MutexLockMaybe lock(shared_ ? &mutex_ : nullptr);
+  const auto index_iter = index_.find(key);
+  if (index_iter == index_.end()) {
+    return nullptr;
+  }
+
+  const auto entry = index_iter->second;
+  if (entry->expiry_ <= time_source_.monotonicTime()) {
+    index_.erase(index_iter);
+    entries_.erase(entry);
+    return nullptr;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry);
+  return entry->response_;
+}
+
+bool DecisionCache::insert(const std::string& key, ResponseConstSharedPtr response,
+                           std::chrono::milliseconds ttl) {
+  absl::MutexLockMaybe lock(shared_ ? &mutex_ : nullptr);
+  const auto index_iter = index_.find(key);
+  if (index_iter != index_.end()) {
+    entries_.erase(index_iter->second);
+    index_.erase(index_iter);
+  }
+
+  bool evicted = false;
+  if (entries_.size() >= max_entries_) {
+    index_.erase(entries_.back().key_);
+    entries_.pop_back();
+    evicted = true;
+  }
+
+  entries_.push_front(Entry{key, time_source_.monotonicTime() + ttl, std::move(response)});
+  index_.emplace(key, entries_.begin());
+  return evicted;
+}
+
+size_t DecisionCache::size() {
+  absl::MutexLockMaybe lock(shared_ ? &mutex_ : nullptr);
+  return entries_.size();
+}
+
+DecisionCacheConfig::DecisionCacheConfig(
+    const envoy::extensions::filters::http::ext_authz::v3::DecisionCache& config,
+    ThreadLocal::SlotAllocator& tls, TimeSource& time_source)
+    : key_headers_(config.key_headers().begin(), config.key_headers().end()),
+      allowed_ttl_(PROTOBUF_GET_OPTIONAL_MS(config, allowed_ttl)),
+      denied_ttl_(PROTOBUF_GET_OPTIONAL_MS(config, denied_ttl)),
+      ttl_header_(config.ttl_header()), ttl_metadata_key_(config.ttl_metadata_key()) {
+  const uint32_t max_entries =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, DefaultMaxEntries);
+  if (config.shared()) {
+    shared_cache_ = std::make_unique<DecisionCache>(max_entries, true, time_source);
+    return;
+  }
+  tls_ = ThreadLocal::TypedSlot<DecisionCache>::makeUnique(tls);
+  tls_->set([max_entries](Event::Dispatcher& dispatcher) {
+    return std::make_shared<DecisionCache>(max_entries, false, dispatcher.timeSource());
+  });
+}
+
+std::string DecisionCacheConfig::key(const Http::RequestHeaderMap& headers,
+                                     absl::string_view route_name) const {
+  // The values are length prefixed so that the keys of different requests can't collide.
+  std::string key = absl::StrCat(route_name.size(), ":", route_name);
+  for (const Http::LowerCaseString& name : key_headers_) {
+    const auto value = Http::HeaderUtility::getAllOfHeaderAsString(headers, name);
+    if (!value.result().has_value()) {
+      absl::StrAppend(&key, "-");
+      continue;
+    }
+    absl::StrAppend(&key, value.result()->size(), ":", value.result().value());
+  }
+  return key;
+}
+
+std::optional<std::chrono::milliseconds>
+DecisionCacheConfig::ttl(const Filters::Common::ExtAuthz::Response& response) const {
+  using Filters::Common::ExtAuthz::CheckStatus;
+  // The errors of the authorization service are not decisions, even when they are reported as a
+  // denial with a 5xx status.
+  if (response.status == CheckStatus::Error ||
+      (response.status == CheckStatus::Denied &&
+       Http::CodeUtility::is5xx(enumToInt(response.status_code)))) {
+    return std::nullopt;
+  }
+
+  if (!ttl_metadata_key_.empty()) {
+    const auto& fields = response.dynamic_metadata.fields();
+    if (const auto it = fields.find(ttl_metadata_key_);
+        it != fields.end() && it->second.kind_case() == Protobuf::Value::kNumberValue) {
+      return secondsToTtl(it->second.number_value());
+    }
+  }
+  if (!ttl_header_.empty()) {
+    if (const auto seconds = ttlHeaderSeconds(
+            {&response.headers_to_set, &response.headers_to_add, &response.headers_to_append,
+             &response.response_headers_to_add, &response.response_headers_to_set});
+        seconds.has_value()) {
+      return secondsToTtl(static_cast<double>(seconds.value()));
+    }
+  }
+  return response.status == CheckStatus::OK ? allowed_ttl_ : denied_ttl_;
+}
+
+std::optional<int64_t> DecisionCacheConfig::ttlHeaderSeconds(
+    const std::vector<const Filters::Common::ExtAuthz::UnsafeHeaderVector*>& headers) const {
+  for (const Filters::Common::ExtAuthz::UnsafeHeaderVector* header_vector : headers) {
+    for (const auto& [key, value] : *header_vector) {
+      if (!absl::EqualsIgnoreCase(key, ttl_header_)) {
+        continue;
+      }
+      int64_t seconds;
+      // A malformed TTL disables the caching of the decision.
+      return absl::SimpleAtoi(value, &seconds) ? seconds : 0;
+    }
+  }
+  return std::nullopt;
+}
+
+DecisionCache& DecisionCacheConfig::cache() {
+  return shared_cache_ != nullptr ? *shared_cache_ : **tls_;
+}
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/extensions/filters/common/ext_authz/ext_authz.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+using ResponseConstSharedPtr = std::shared_ptr<const Filters::Common::ExtAuthz::Response>;
+
+/**
+ * A bounded LRU cache of the responses of the authorization service, by cache key. The cache is
+ * either used by a single worker, or shared by all the workers and guarded by a lock.
+ */
+class DecisionCache : public ThreadLocal::ThreadLocalObject {
+public:
+  DecisionCache(uint32_t max_entries, bool shared, TimeSource& time_source)
+      : max_entries_(max_entries), shared_(shared), time_source_(time_source) {}
+
+  /**
+   * @return the response cached for the key, or nullptr if there is none. Expired entries are
+   *         removed.
+   */
+  ResponseConstSharedPtr find(const std::string& key);
+
+  /**
+   * Caches the response for the key, replacing any response already cached for it.
+   * @return true if an entry was evicted to make room for the response.
+   */
+  bool insert(const std::string& key, ResponseConstSharedPtr response,
+              std::chrono::milliseconds ttl);
+
+  size_t size();
+
+private:
+  struct Entry {
+    std::string key_;
+    MonotonicTime expiry_;
+    ResponseConstSharedPtr response_;
+  };
+
+  const uint32_t max_entries_;
+  const bool shared_;
+  TimeSource& time_source_;
+  // Only locked when the cache is shared by the workers.
+  absl::Mutex mutex_;
+  // Ordered from the most to the least recently used.
+  std::list<Entry> entries_;
+  absl::flat_hash_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+/**
+ * The configuration of the decision cache of a filter, and the cache of the current worker.
+ */
+class DecisionCacheConfig {
+public:
+  DecisionCacheConfig(const envoy::extensions::filters::http::ext_authz::v3::DecisionCache& config,
+                      ThreadLocal::SlotAllocator& tls, TimeSource& time_source);
+
+  /**
+   * @return the cache key of a request.
+   */
+  std::string key(const Http::RequestHeaderMap& headers, absl::string_view route_name) const;
+
+  /**
+   * @return how long a response can be cached for, or nullopt if it can't be cached.
+   */
+  std::optional<std::chrono::milliseconds>
+  ttl(const Filters::Common::ExtAuthz::Response& response) const;
+
+  DecisionCache& cache();
+
+  static constexpr uint32_t DefaultMaxEntries = 10000;
+
+private:
+  // @return the number of seconds carried by the TTL header, if found in the headers.
+  std::optional<int64_t> ttlHeaderSeconds(
+      const std::vector<const Filters::Common::ExtAuthz::UnsafeHeaderVector*>& headers) const;
+
+  const std::vector<Http::LowerCaseString> key_headers_;
+  const std::optional<std::chrono::milliseconds> allowed_ttl_;
+  const std::optional<std::chrono::milliseconds> denied_ttl_;
+  const std::string ttl_header_;
+  const std::string ttl_metadata_key_;
+  // Set when the cache is shared by the workers.
+  std::unique_ptr<DecisionCache> shared_cache_;
+  ThreadLocal::TypedSlotPtr<DecisionCache> tls_;
+};
+
+using DecisionCacheConfigPtr = std::unique_ptr<DecisionCacheConfig>;
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
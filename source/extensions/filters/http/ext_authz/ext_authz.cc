@@ -186,6 +186,10 @@ FilterConfig::FilterConfig(const envoy::extensions::filters::http::ext_authz::v3
     disallowed_headers_matcher_ = Filters::Common::ExtAuthz::CheckRequestUtils::toRequestMatchers(
         config.disallowed_headers(), false, factory_context);
   }
+  if (config.has_decision_cache()) {
+    decision_cache_ = std::make_unique<DecisionCacheConfig>(
+        config.decision_cache(), factory_context.threadLocal(), factory_context.timeSource());
+  }
 }
 
 void FilterConfigPerRoute::merge(const FilterConfigPerRoute& other) {
@@ -283,6 +287,52 @@ Filters::Common::ExtAuthz::ClientPtr Filter::createPerRouteHttpClient(
       server_context_->clusterManager(), client_config);
 }
 
+bool Filter::replayCachedDecision(const Http::RequestHeaderMap& headers) {
+  DecisionCacheConfig* decision_cache = config_->decisionCache();
+  // The decision for a request sent with its body may depend on the body, which isn't in the key.
+  if (decision_cache == nullptr || buffer_data_) {
+    return false;
+  }
+
+  // The decisions are cached by route, and the routes without a name can't be told apart.
+  const auto route = decoder_callbacks_->route();
+  if (route == nullptr || route->routeName().empty()) {
+    return false;
+  }
+
+  decision_cache_key_ = decision_cache->key(headers, route->routeName());
+  const ResponseConstSharedPtr cached = decision_cache->cache().find(decision_cache_key_);
+  if (cached == nullptr) {
+    stats_.decision_cache_miss_.inc();
+    return false;
+  }
+
+  stats_.decision_cache_hit_.inc();
+  ENVOY_STREAM_LOG(trace, "ext_authz filter replaying a cached decision.", *decoder_callbacks_);
+  // The replayed decision must not be cached again, which would extend its lifetime.
+  decision_cache_key_.clear();
+  state_ = State::Calling;
+  filter_return_ = FilterReturn::StopDecoding;
+  cluster_ = decoder_callbacks_->clusterInfoSharedPtr();
+  initiating_call_ = true;
+  onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(*cached));
+  initiating_call_ = false;
+  return true;
+}
+
+void Filter::cacheDecision(const Filters::Common::ExtAuthz::Response& response) {
+  DecisionCacheConfig& decision_cache = *config_->decisionCache();
+  const auto ttl = decision_cache.ttl(response);
+  if (!ttl.has_value()) {
+    return;
+  }
+  if (decision_cache.cache().insert(
+          decision_cache_key_, std::make_shared<Filters::Common::ExtAuthz::Response>(response),
+          ttl.value())) {
+    stats_.decision_cache_eviction_.inc();
+  }
+}
+
 void Filter::initiateCall(const Http::RequestHeaderMap& headers) {
   if (filter_return_ == FilterReturn::StopDecoding) {
     return;
@@ -311,6 +361,10 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers) {
     }
   }
 
+  if (replayCachedDecision(headers)) {
+    return;
+  }
+
   std::optional<FilterConfigPerRoute> maybe_merged_per_route_config;
   for (const FilterConfigPerRoute& cfg :
        Http::Utility::getAllPerFilterConfig<FilterConfigPerRoute>(decoder_callbacks_)) {
@@ -670,6 +724,11 @@ void Filter::onComplete(Filters::Common::ExtAuthz::ResponsePtr&& response) {
   updateLoggingInfo(response->grpc_status);
   active_client_ = nullptr;
 
+  if (!decision_cache_key_.empty()) {
+    // Cached before the response is altered below.
+    cacheDecision(*response);
+  }
+
   if (response->saw_invalid_append_actions) {
     if (config_->validateMutations()) {
       ENVOY_STREAM_LOG(trace, "Rejecting response with invalid header append action.",
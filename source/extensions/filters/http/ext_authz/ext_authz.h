@@ -29,6 +29,7 @@
 #include "source/extensions/filters/common/ext_authz/ext_authz_http_impl.h"
 #include "source/extensions/filters/common/mutation_rules/mutation_rules.h"
 #include "source/extensions/filters/common/processing_effect/processing_effect.h"
+#include "source/extensions/filters/http/ext_authz/decision_cache.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -52,7 +53,10 @@ namespace ExtAuthz {
   COUNTER(request_header_limits_reached)                                                           \
   COUNTER(response_header_limits_reached)                                                          \
   COUNTER(shadow_denied)                                                                           \
-  COUNTER(shadow_error)
+  COUNTER(shadow_error)                                                                            \
+  COUNTER(decision_cache_hit)                                                                      \
+  COUNTER(decision_cache_miss)                                                                     \
+  COUNTER(decision_cache_eviction)
 
 /**
  * Wrapper struct for ext_authz filter stats. @see stats_macros.h
@@ -288,6 +292,9 @@ public:
     return disallowed_headers_matcher_;
   }
 
+  // The decision cache, or nullptr if decisions are not cached.
+  DecisionCacheConfig* decisionCache() { return decision_cache_.get(); }
+
 private:
   static Http::Code toErrorCode(uint64_t status) {
     const auto code = static_cast<Http::Code>(status);
@@ -356,6 +363,8 @@ private:
   Filters::Common::ExtAuthz::MatcherSharedPtr allowed_headers_matcher_;
   Filters::Common::ExtAuthz::MatcherSharedPtr disallowed_headers_matcher_;
 
+  DecisionCacheConfigPtr decision_cache_;
+
 public:
   // TODO(nezdolik): deprecate cluster scope stats counters in favor of filter scope stats
   // (ExtAuthzFilterStats stats_).
@@ -529,6 +538,10 @@ private:
   std::optional<MonotonicTime> start_time_;
   void addResponseHeaders(Http::HeaderMap& header_map, const Http::HeaderVector& headers);
   void initiateCall(const Http::RequestHeaderMap& headers);
+  // Looks the request up in the decision cache, and completes the call with the cached decision
+  // if there is one. Returns true if the decision was replayed.
+  bool replayCachedDecision(const Http::RequestHeaderMap& headers);
+  void cacheDecision(const Filters::Common::ExtAuthz::Response& response);
   void continueDecoding();
   // In shadow mode, writes the authorization decision and response attributes into
   // FilterState and increments the appropriate shadow stat counter. Takes the response
@@ -588,6 +601,8 @@ private:
   bool buffer_data_{};
   bool skip_check_{false};
   envoy::service::auth::v3::CheckRequest check_request_;
+  // The decision cache key of the request, empty if its decision is not to be cached.
+  std::string decision_cache_key_;
 };
 
 } // namespace ExtAuthz
@@ -68,6 +68,10 @@ absl::Status verifyFilterConfig(
                                       "be set to none-default at the same time.");
   }
 
+  if (config.has_stream_multiplexing() && !config.has_grpc_service()) {
+    return absl::InvalidArgumentError("stream_multiplexing can only be used with grpc_service");
+  }
+
   return verifyProcessingModeConfig(config);
 }
 
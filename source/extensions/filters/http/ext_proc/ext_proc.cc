@@ -312,6 +312,22 @@ FilterConfig::FilterConfig(const ExternalProcessor& config,
 
   thread_local_stream_manager_slot_->set(
       [](Envoy::Event::Dispatcher&) { return std::make_shared<ThreadLocalStreamManager>(); });
+
+  if (config.has_stream_multiplexing()) {
+    const uint32_t max_http_streams_per_grpc_stream =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.stream_multiplexing(),
+                                        max_http_streams_per_grpc_stream,
+                                        DefaultMaxHttpStreamsPerGrpcStream);
+    const ExtProcMultiplexingStats multiplexing_stats =
+        generateMultiplexingStats(stats_prefix, config.stat_prefix(), scope);
+    multiplexed_stream_pool_slot_ = context.threadLocal().allocateSlot();
+    multiplexed_stream_pool_slot_->set(
+        [max_http_streams_per_grpc_stream,
+         multiplexing_stats](Envoy::Event::Dispatcher& dispatcher) {
+          return std::make_shared<MultiplexedStreamPool>(
+              max_http_streams_per_grpc_stream, multiplexing_stats, dispatcher.timeSource());
+        });
+  }
 }
 
 void ExtProcLoggingInfo::recordGrpcCall(
@@ -776,18 +792,23 @@ Filter::StreamOpenState Filter::openStream() {
   if (!stream_) {
     ENVOY_STREAM_LOG(debug, "Opening gRPC stream to external processor", *decoder_callbacks_);
 
-    Http::AsyncClient::ParentContext grpc_context;
-    grpc_context.stream_info = &decoder_callbacks_->streamInfo();
-    auto options = Http::AsyncClient::StreamOptions()
-                       .setParentSpan(decoder_callbacks_->activeSpan())
-                       .setParentContext(grpc_context)
-                       .setBufferBodyForRetry(grpc_service_.has_retry_policy())
-                       .setSampled(std::nullopt)
-                       .setRemoteCloseTimeout(config_->remoteCloseTimeout());
-
     ExternalProcessorClient* grpc_client = dynamic_cast<ExternalProcessorClient*>(client_.get());
-    ExternalProcessorStreamPtr stream_object =
-        grpc_client->start(*this, config_with_hash_key_, options, watermark_callbacks_);
+    ExternalProcessorStreamPtr stream_object;
+    if (config_->streamMultiplexing()) {
+      stream_object = config_->threadLocalMultiplexedStreamPool().attach(
+          *grpc_client, *this, config_with_hash_key_, config_->remoteCloseTimeout());
+    } else {
+      Http::AsyncClient::ParentContext grpc_context;
+      grpc_context.stream_info = &decoder_callbacks_->streamInfo();
+      auto options = Http::AsyncClient::StreamOptions()
+                         .setParentSpan(decoder_callbacks_->activeSpan())
+                         .setParentContext(grpc_context)
+                         .setBufferBodyForRetry(grpc_service_.has_retry_policy())
+                         .setSampled(std::nullopt)
+                         .setRemoteCloseTimeout(config_->remoteCloseTimeout());
+      stream_object =
+          grpc_client->start(*this, config_with_hash_key_, options, watermark_callbacks_);
+    }
 
     if (processing_complete_ || stream_object == nullptr) {
       // Stream failed while starting and either onGrpcError or onGrpcClose was already called.
@@ -26,6 +26,7 @@
 #include "source/extensions/filters/http/ext_proc/allowed_override_modes_set.h"
 #include "source/extensions/filters/http/ext_proc/client_impl.h"
 #include "source/extensions/filters/http/ext_proc/matching_utils.h"
+#include "source/extensions/filters/http/ext_proc/multiplexed_stream.h"
 #include "source/extensions/filters/http/ext_proc/on_processing_response.h"
 #include "source/extensions/filters/http/ext_proc/processing_request_modifier.h"
 #include "source/extensions/filters/http/ext_proc/processor_state.h"
@@ -337,6 +338,13 @@ public:
     return thread_local_stream_manager_slot_->getTyped<ThreadLocalStreamManager>();
   }
 
+  // True if the HTTP streams are multiplexed over shared gRPC streams.
+  bool streamMultiplexing() const { return multiplexed_stream_pool_slot_ != nullptr; }
+
+  MultiplexedStreamPool& threadLocalMultiplexedStreamPool() {
+    return multiplexed_stream_pool_slot_->getTyped<MultiplexedStreamPool>();
+  }
+
   const std::optional<const envoy::config::core::v3::GrpcService> grpcService() const {
     return grpc_service_;
   }
@@ -368,6 +376,15 @@ private:
     const std::string final_prefix = absl::StrCat(prefix, "ext_proc.", filter_stats_prefix);
     return {ALL_EXT_PROC_FILTER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
   }
+  ExtProcMultiplexingStats generateMultiplexingStats(const std::string& prefix,
+                                                     const std::string& filter_stats_prefix,
+                                                     Stats::Scope& scope) {
+    const std::string final_prefix =
+        absl::StrCat(prefix, "ext_proc.", filter_stats_prefix, "multiplexing.");
+    return {ALL_EXT_PROC_MULTIPLEXING_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
+                                            POOL_GAUGE_PREFIX(scope, final_prefix),
+                                            POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
+  }
   static std::function<std::unique_ptr<OnProcessingResponse>()> createOnProcessingResponseCb(
       const envoy::extensions::filters::http::ext_proc::v3::ExternalProcessor& config,
       Envoy::Server::Configuration::CommonFactoryContext& context, const std::string& stats_prefix);
@@ -400,6 +417,8 @@ private:
   const std::function<std::unique_ptr<OnProcessingResponse>()> on_processing_response_factory_cb_;
 
   ThreadLocal::SlotPtr thread_local_stream_manager_slot_;
+  // Only set with stream multiplexing.
+  ThreadLocal::SlotPtr multiplexed_stream_pool_slot_;
   envoy::extensions::filters::http::ext_proc::v3::ExternalProcessor::RouteCacheAction
       route_cache_action_;
   const envoy::extensions::filters::http::ext_proc::v3::ProcessingMode processing_mode_;
@@ -0,0 +1,246 @@
+#include "source/extensions/filters/http/ext_proc/multiplexed_stream.h"
+
+#include <algorithm>
+
+#include "source/common/grpc/codec.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExternalProcessing {
+
+SharedProcessorStream::SharedProcessorStream(
+    MultiplexedStreamPool& pool, const Grpc::GrpcServiceConfigWithHashKey& config_with_hash_key,
+    const ExtProcMultiplexingStats& stats)
+    : pool_(&pool), config_with_hash_key_(config_with_hash_key), stats_(stats) {}
+
+bool SharedProcessorStream::start(ExternalProcessorClient& client,
+                                  std::chrono::milliseconds remote_close_timeout) {
+  // The stream outlives the HTTP streams sharing it, so it has no parent stream or span.
+  auto options = Http::AsyncClient::StreamOptions()
+                     .setSampled(std::nullopt)
+                     .setRemoteCloseTimeout(remote_close_timeout);
+  stream_ = client.start(*this, config_with_hash_key_, options, watermark_callbacks_);
+  return stream_ != nullptr && !closed_;
+}
+
+void SharedProcessorStream::attach(MultiplexedProcessorStream& stream) {
+  ASSERT(!closed_);
+  streams_[stream.correlationId()] = &stream;
+  stats_.http_streams_active_.inc();
+  stats_.http_streams_per_grpc_stream_.recordValue(streams_.size());
+}
+
+void SharedProcessorStream::detach(MultiplexedProcessorStream& stream) {
+  if (streams_.erase(stream.correlationId()) == 0) {
+    return;
+  }
+  stats_.http_streams_active_.dec();
+  if (streams_.empty() && !closed_ && pool_ != nullptr) {
+    pool_->onIdle(*this);
+  }
+}
+
+void SharedProcessorStream::send(ProcessingRequest&& request) {
+  ASSERT(!closed_);
+  stream_->send(std::move(request), false);
+}
+
+void SharedProcessorStream::close() {
+  closed_ = true;
+  stream_->close();
+}
+
+void SharedProcessorStream::replayClose(ExternalProcessorCallbacks& callbacks) const {
+  if (!closed_) {
+    return;
+  }
+  if (close_status_ == Grpc::Status::Ok) {
+    callbacks.onGrpcClose();
+  } else {
+    callbacks.onGrpcError(close_status_, close_message_);
+  }
+}
+
+void SharedProcessorStream::onReceiveMessage(Grpc::ResponsePtr<ProcessingResponse>&& response) {
+  auto it = streams_.find(response->stream_correlation_id());
+  if (it == streams_.end() || !it->second->callbacks().has_value()) {
+    // The HTTP stream is gone, e.g. after a message timeout.
+    ENVOY_LOG(debug, "Dropping message for unknown correlation ID {}",
+              response->stream_correlation_id());
+    stats_.unknown_correlation_id_.inc();
+    return;
+  }
+  it->second->onReceived(*response);
+  it->second->callbacks()->onReceiveMessage(std::move(response));
+}
+
+void SharedProcessorStream::onGrpcError(Grpc::Status::GrpcStatus status,
+                                        const std::string& message) {
+  onClosed(status, message);
+}
+
+void SharedProcessorStream::onGrpcClose() { onClosed(Grpc::Status::Ok, ""); }
+
+void SharedProcessorStream::onClosed(Grpc::Status::GrpcStatus status, const std::string& message) {
+  ENVOY_LOG(debug, "Shared gRPC stream closed with status {} while shared by {} HTTP streams",
+            status, streams_.size());
+  // Keep this alive while the HTTP streams are notified, as the pool releases it.
+  SharedProcessorStreamSharedPtr self = shared_from_this();
+  closed_ = true;
+  close_status_ = status;
+  close_message_ = message;
+  if (pool_ != nullptr) {
+    pool_->remove(*this);
+  }
+
+  // Notifying an HTTP stream may destroy other ones, so they are detached one at a time.
+  while (!streams_.empty()) {
+    auto it = streams_.begin();
+    MultiplexedProcessorStream& stream = *it->second;
+    streams_.erase(it);
+    stats_.http_streams_active_.dec();
+    stream.onDetached();
+    OptRef<ExternalProcessorCallbacks> callbacks = stream.callbacks();
+    if (!callbacks.has_value()) {
+      continue;
+    }
+    callbacks->logStreamInfo();
+    replayClose(*callbacks);
+  }
+}
+
+MultiplexedProcessorStream::MultiplexedProcessorStream(SharedProcessorStreamSharedPtr shared,
+                                                       uint64_t correlation_id,
+                                                       ExternalProcessorCallbacks& callbacks,
+                                                       TimeSource& time_source)
+    : shared_(std::move(shared)), correlation_id_(correlation_id), callbacks_(callbacks),
+      stream_info_(time_source, nullptr, StreamInfo::FilterState::LifeSpan::FilterChain) {
+  stream_info_.setUpstreamInfo(std::make_shared<StreamInfo::UpstreamInfoImpl>());
+  updateUpstream();
+}
+
+void MultiplexedProcessorStream::send(ProcessingRequest&& request, bool) {
+  if (!attached_) {
+    return;
+  }
+  request.set_stream_correlation_id(correlation_id_);
+  stream_info_.getUpstreamBytesMeter()->addWireBytesSent(Grpc::GRPC_FRAME_HEADER_SIZE +
+                                                         request.ByteSizeLong());
+  shared_->send(std::move(request));
+}
+
+void MultiplexedProcessorStream::onReceived(const ProcessingResponse& response) {
+  stream_info_.getUpstreamBytesMeter()->addWireBytesReceived(Grpc::GRPC_FRAME_HEADER_SIZE +
+                                                             response.ByteSizeLong());
+  updateUpstream();
+}
+
+void MultiplexedProcessorStream::onDetached() {
+  attached_ = false;
+  updateUpstream();
+}
+
+bool MultiplexedProcessorStream::close() {
+  if (!attached_) {
+    return false;
+  }
+  attached_ = false;
+  updateUpstream();
+  shared_->detach(*this);
+  return true;
+}
+
+void MultiplexedProcessorStream::updateUpstream() {
+  const StreamInfo::StreamInfo& shared_info = shared_->streamInfo();
+  if (shared_info.upstreamInfo().has_value() &&
+      shared_info.upstreamInfo()->upstreamHost() != nullptr) {
+    stream_info_.upstreamInfo()->setUpstreamHost(shared_info.upstreamInfo()->upstreamHost());
+  }
+  if (shared_info.upstreamClusterInfoSharedPtr() != nullptr) {
+    stream_info_.setUpstreamClusterInfo(shared_info.upstreamClusterInfoSharedPtr());
+  }
+  if (shared_info.responseCodeDetails().has_value()) {
+    stream_info_.setResponseCodeDetails(shared_info.responseCodeDetails().value());
+  }
+}
+
+MultiplexedStreamPool::~MultiplexedStreamPool() {
+  for (auto& [config_with_hash_key, shared_streams] : streams_) {
+    for (const SharedProcessorStreamSharedPtr& shared_stream : shared_streams) {
+      shared_stream->onPoolDestroyed();
+      stats_.grpc_streams_active_.dec();
+    }
+  }
+}
+
+ExternalProcessorStreamPtr
+MultiplexedStreamPool::attach(ExternalProcessorClient& client,
+                              ExternalProcessorCallbacks& callbacks,
+                              const Grpc::GrpcServiceConfigWithHashKey& config_with_hash_key,
+                              std::chrono::milliseconds remote_close_timeout) {
+  SharedProcessorStreamSharedPtr shared_stream;
+  auto it = streams_.find(config_with_hash_key);
+  if (it != streams_.end()) {
+    auto least_loaded = std::min_element(
+        it->second.begin(), it->second.end(),
+        [](const SharedProcessorStreamSharedPtr& a, const SharedProcessorStreamSharedPtr& b) {
+          return a->httpStreams() < b->httpStreams();
+        });
+    if (least_loaded != it->second.end() &&
+        (*least_loaded)->httpStreams() < max_http_streams_per_grpc_stream_) {
+      shared_stream = *least_loaded;
+    }
+  }
+
+  if (shared_stream == nullptr) {
+    shared_stream = std::make_shared<SharedProcessorStream>(*this, config_with_hash_key, stats_);
+    if (!shared_stream->start(client, remote_close_timeout)) {
+      shared_stream->replayClose(callbacks);
+      return nullptr;
+    }
+    stats_.grpc_streams_started_.inc();
+    stats_.grpc_streams_active_.inc();
+    streams_[config_with_hash_key].push_back(shared_stream);
+  }
+
+  auto stream = std::make_unique<MultiplexedProcessorStream>(shared_stream, next_correlation_id_++,
+                                                             callbacks, time_source_);
+  shared_stream->attach(*stream);
+  return stream;
+}
+
+void MultiplexedStreamPool::remove(SharedProcessorStream& stream) {
+  auto it = streams_.find(stream.configWithHashKey());
+  if (it == streams_.end()) {
+    return;
+  }
+  SharedStreams& shared_streams = it->second;
+  auto stream_it = std::find_if(
+      shared_streams.begin(), shared_streams.end(),
+      [&stream](const SharedProcessorStreamSharedPtr& shared) { return shared.get() == &stream; });
+  if (stream_it == shared_streams.end()) {
+    return;
+  }
+  shared_streams.erase(stream_it);
+  stats_.grpc_streams_active_.dec();
+  if (shared_streams.empty()) {
+    streams_.erase(it);
+  }
+}
+
+void MultiplexedStreamPool::onIdle(SharedProcessorStream& stream) {
+  auto it = streams_.find(stream.configWithHashKey());
+  if (it == streams_.end() || it->second.size() <= 1) {
+    // The last stream to the service is kept open for the next HTTP streams.
+    return;
+  }
+  ENVOY_LOG_MISC(debug, "Closing idle shared gRPC stream to the external processor");
+  stream.close();
+  remove(stream);
+}
+
+} // namespace ExternalProcessing
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
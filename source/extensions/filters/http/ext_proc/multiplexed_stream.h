@@ -0,0 +1,201 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/grpc/async_client_manager.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local_object.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/http/sidestream_watermark.h"
+#include "source/common/stream_info/stream_info_impl.h"
+#include "source/extensions/filters/http/ext_proc/client_impl.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExternalProcessing {
+
+/**
+ * All ext_proc stream multiplexing stats. @see stats_macros.h
+ * "http_streams_per_grpc_stream" records the number of HTTP streams sharing a gRPC stream each time
+ * an HTTP stream is added to it.
+ */
+#define ALL_EXT_PROC_MULTIPLEXING_STATS(COUNTER, GAUGE, HISTOGRAM)                                 \
+  COUNTER(grpc_streams_started)                                                                    \
+  COUNTER(unknown_correlation_id)                                                                  \
+  GAUGE(grpc_streams_active, Accumulate)                                                           \
+  GAUGE(http_streams_active, Accumulate)                                                           \
+  HISTOGRAM(http_streams_per_grpc_stream, Unspecified)
+
+/**
+ * Struct definition for all ext_proc stream multiplexing stats. @see stats_macros.h
+ */
+struct ExtProcMultiplexingStats {
+  ALL_EXT_PROC_MULTIPLEXING_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                                  GENERATE_HISTOGRAM_STRUCT)
+};
+
+// Default value of max_http_streams_per_grpc_stream.
+inline constexpr uint32_t DefaultMaxHttpStreamsPerGrpcStream = 100;
+
+class MultiplexedStreamPool;
+class MultiplexedProcessorStream;
+
+/**
+ * A gRPC stream to the external processor shared by the HTTP streams of a worker. The messages
+ * received on it are dispatched to the HTTP streams by their correlation ID.
+ */
+class SharedProcessorStream : public ExternalProcessorCallbacks,
+                              public std::enable_shared_from_this<SharedProcessorStream>,
+                              public Logger::Loggable<Logger::Id::ext_proc> {
+public:
+  SharedProcessorStream(MultiplexedStreamPool& pool,
+                        const Grpc::GrpcServiceConfigWithHashKey& config_with_hash_key,
+                        const ExtProcMultiplexingStats& stats);
+
+  /**
+   * Starts the gRPC stream.
+   * @return false if the stream failed to start.
+   */
+  bool start(ExternalProcessorClient& client, std::chrono::milliseconds remote_close_timeout);
+
+  void attach(MultiplexedProcessorStream& stream);
+  void detach(MultiplexedProcessorStream& stream);
+  void send(ProcessingRequest&& request);
+  // Resets the gRPC stream. The HTTP streams sharing it, if any, are not notified.
+  void close();
+
+  /**
+   * Notifies the callbacks of an HTTP stream of how this stream was closed while it was starting.
+   */
+  void replayClose(ExternalProcessorCallbacks& callbacks) const;
+
+  const Grpc::GrpcServiceConfigWithHashKey& configWithHashKey() const {
+    return config_with_hash_key_;
+  }
+  uint64_t httpStreams() const { return streams_.size(); }
+  bool closed() const { return closed_; }
+  StreamInfo::StreamInfo& streamInfo() { return stream_->streamInfo(); }
+
+  // ExternalProcessorCallbacks
+  void onReceiveMessage(Grpc::ResponsePtr<ProcessingResponse>&& response) override;
+  void onGrpcError(Grpc::Status::GrpcStatus status, const std::string& message) override;
+  void onGrpcClose() override;
+  // The stream info is logged by each HTTP stream when it is notified of the close.
+  void logStreamInfo() override {}
+  void onComplete(ProcessingResponse&) override {}
+  void onError() override {}
+
+  // Called by the pool when it is destroyed before the stream.
+  void onPoolDestroyed() { pool_ = nullptr; }
+
+private:
+  void onClosed(Grpc::Status::GrpcStatus status, const std::string& message);
+
+  MultiplexedStreamPool* pool_;
+  const Grpc::GrpcServiceConfigWithHashKey config_with_hash_key_;
+  ExtProcMultiplexingStats stats_;
+  ExternalProcessorStreamPtr stream_;
+  // The HTTP streams sharing this stream by correlation ID.
+  absl::flat_hash_map<uint64_t, MultiplexedProcessorStream*> streams_;
+  // The shared stream is not read-disabled on behalf of any HTTP stream.
+  Http::StreamFilterSidestreamWatermarkCallbacks watermark_callbacks_;
+  bool closed_{};
+  Grpc::Status::GrpcStatus close_status_{Grpc::Status::Ok};
+  std::string close_message_;
+};
+
+using SharedProcessorStreamSharedPtr = std::shared_ptr<SharedProcessorStream>;
+
+/**
+ * The stream of one HTTP stream to the external processor, multiplexed over a shared gRPC stream.
+ * Closing it detaches it from the shared stream, which stays open.
+ *
+ * Its stream info counts the gRPC messages of this HTTP stream only, as the upstream wire bytes,
+ * and takes the upstream host, cluster and response code details from the shared stream.
+ */
+class MultiplexedProcessorStream : public ExternalProcessorStream {
+public:
+  MultiplexedProcessorStream(SharedProcessorStreamSharedPtr shared, uint64_t correlation_id,
+                             ExternalProcessorCallbacks& callbacks, TimeSource& time_source);
+  ~MultiplexedProcessorStream() override { close(); }
+
+  uint64_t correlationId() const { return correlation_id_; }
+  OptRef<ExternalProcessorCallbacks> callbacks() { return callbacks_; }
+  // Called by the shared stream when a message is received for this stream.
+  void onReceived(const ProcessingResponse& response);
+  // Called by the shared stream when it is closed.
+  void onDetached();
+
+  // ExternalProcessorStream
+  // The end_stream flag is ignored, as the shared stream outlives the HTTP stream.
+  void send(ProcessingRequest&& request, bool end_stream) override;
+  bool close() override;
+  bool halfCloseAndDeleteOnRemoteClose() override { return close(); }
+  const StreamInfo::StreamInfo& streamInfo() const override { return stream_info_; }
+  StreamInfo::StreamInfo& streamInfo() override { return stream_info_; }
+  void notifyFilterDestroy() override { callbacks_.reset(); }
+
+private:
+  // Copies the upstream of the shared stream into the stream info.
+  void updateUpstream();
+
+  // Keeps the shared stream alive until the HTTP stream is done with it.
+  const SharedProcessorStreamSharedPtr shared_;
+  const uint64_t correlation_id_;
+  OptRef<ExternalProcessorCallbacks> callbacks_;
+  StreamInfo::StreamInfoImpl stream_info_;
+  bool attached_{true};
+};
+
+/**
+ * The shared gRPC streams of a worker for one filter configuration, by gRPC service.
+ */
+class MultiplexedStreamPool : public ThreadLocal::ThreadLocalObject {
+public:
+  MultiplexedStreamPool(uint32_t max_http_streams_per_grpc_stream,
+                        const ExtProcMultiplexingStats& stats, TimeSource& time_source)
+      : max_http_streams_per_grpc_stream_(max_http_streams_per_grpc_stream), stats_(stats),
+        time_source_(time_source) {}
+  ~MultiplexedStreamPool() override;
+
+  /**
+   * Adds an HTTP stream to the least loaded gRPC stream to the service, starting a new one if all
+   * the gRPC streams carry max_http_streams_per_grpc_stream HTTP streams already.
+   * @return the stream of the HTTP stream, or nullptr if a new gRPC stream failed to start. In
+   *         that case the callbacks have been notified of the failure if it was reported.
+   */
+  ExternalProcessorStreamPtr
+  attach(ExternalProcessorClient& client, ExternalProcessorCallbacks& callbacks,
+         const Grpc::GrpcServiceConfigWithHashKey& config_with_hash_key,
+         std::chrono::milliseconds remote_close_timeout);
+
+  // Called by a shared stream when it is closed.
+  void remove(SharedProcessorStream& stream);
+  // Called by a shared stream when its last HTTP stream is detached. The stream is closed unless
+  // it is the last one to its service.
+  void onIdle(SharedProcessorStream& stream);
+
+private:
+  using SharedStreams = std::vector<SharedProcessorStreamSharedPtr>;
+
+  const uint32_t max_http_streams_per_grpc_stream_;
+  ExtProcMultiplexingStats stats_;
+  TimeSource& time_source_;
+  uint64_t next_correlation_id_{1};
+  absl::flat_hash_map<Grpc::GrpcServiceConfigWithHashKey, SharedStreams> streams_;
+};
+
+} // namespace ExternalProcessing
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -537,6 +537,10 @@ Http::FilterHeadersStatus JsonTranscoderFilter::decodeHeaders(Http::RequestHeade
   }
 
   maybeExpandBufferLimits();
+  bound_request_message_ =
+      per_route_config_->max_request_body_size_.has_value() &&
+      Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.grpc_json_transcoder_bound_pending_request_message");
 
   if (method_->request_type_is_http_body_) {
     if (headers.ContentType() != nullptr) {
@@ -585,9 +589,7 @@ Http::FilterHeadersStatus JsonTranscoderFilter::decodeHeaders(Http::RequestHeade
     request_in_.finish();
 
     Buffer::OwnedImpl data;
-    uint64_t stream_size_before = request_in_.bytesStored();
-    readToBuffer(*transcoder_->RequestOutput(), data);
-    stats_->transcoder_request_buffer_bytes_.sub(stream_size_before - request_in_.bytesStored());
+    transcodeRequestData(data);
     if (checkAndRejectIfRequestTranscoderFailed(RcDetails::get().GrpcTranscodeFailedEarly)) {
       return Http::FilterHeadersStatus::StopIteration;
     }
@@ -637,7 +639,7 @@ Http::FilterDataStatus JsonTranscoderFilter::decodeData(Buffer::Instance& data,
   } else {
     stats_->transcoder_request_buffer_bytes_.add(data.length());
     request_in_.move(data);
-    if (decoderBufferLimitReached(request_in_.bytesStored())) {
+    if (decoderBufferLimitReached(request_in_.bytesStored() + pendingRequestMessageBytes())) {
       return Http::FilterDataStatus::StopIterationNoBuffer;
     }
 
@@ -646,9 +648,7 @@ Http::FilterDataStatus JsonTranscoderFilter::decodeData(Buffer::Instance& data,
     }
 
     // Move the transcoded data to the output buffer.
-    uint64_t stream_size_before = request_in_.bytesStored();
-    readToBuffer(*transcoder_->RequestOutput(), data);
-    stats_->transcoder_request_buffer_bytes_.sub(stream_size_before - request_in_.bytesStored());
+    transcodeRequestData(data);
   }
 
   if (checkAndRejectIfRequestTranscoderFailed(RcDetails::get().GrpcTranscodeFailed)) {
@@ -675,9 +675,7 @@ Http::FilterTrailersStatus JsonTranscoderFilter::decodeTrailers(Http::RequestTra
     request_in_.finish();
 
     Buffer::OwnedImpl data;
-    uint64_t stream_size_before = request_in_.bytesStored();
-    readToBuffer(*transcoder_->RequestOutput(), data);
-    stats_->transcoder_request_buffer_bytes_.sub(stream_size_before - request_in_.bytesStored());
+    transcodeRequestData(data);
 
     if (data.length()) {
       ENVOY_STREAM_LOG(debug,
@@ -934,6 +932,27 @@ bool JsonTranscoderFilter::readToBuffer(Protobuf::io::ZeroCopyInputStream& strea
   return false;
 }
 
+void JsonTranscoderFilter::transcodeRequestData(Buffer::Instance& data) {
+  const uint64_t stream_size_before = request_in_.bytesStored();
+  const uint64_t data_size_before = data.length();
+  readToBuffer(*transcoder_->RequestOutput(), data);
+  const uint64_t consumed = stream_size_before - request_in_.bytesStored();
+  stats_->transcoder_request_buffer_bytes_.sub(consumed);
+
+  // The transcoder parses all the JSON it is given, but only outputs a request message once it is
+  // complete, since a gRPC frame starts with the size of its message. The JSON consumed after the
+  // last message output is attributed to the next one.
+  if (data.length() > data_size_before) {
+    request_message_bytes_ = 0;
+  } else {
+    request_message_bytes_ += consumed;
+  }
+}
+
+uint64_t JsonTranscoderFilter::pendingRequestMessageBytes() const {
+  return bound_request_message_ ? request_message_bytes_ : 0;
+}
+
 void JsonTranscoderFilter::onDestroy() {
   if (request_data_.length() || request_in_.bytesStored()) {
     stats_->transcoder_request_buffer_bytes_.sub(request_data_.length() +
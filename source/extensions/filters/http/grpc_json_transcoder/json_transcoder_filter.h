@@ -181,6 +181,16 @@ private:
   bool checkAndRejectIfRequestTranscoderFailed(const std::string& details);
   bool checkAndRejectIfResponseTranscoderFailed();
   bool readToBuffer(Protobuf::io::ZeroCopyInputStream& stream, Buffer::Instance& data);
+  /**
+   * Moves the request messages transcoded from the data of request_in_ to data, and keeps track of
+   * the size of the request message being transcoded.
+   */
+  void transcodeRequestData(Buffer::Instance& data);
+  /**
+   * Returns the size of the JSON of the request message which the transcoder is holding until it is
+   * complete, when it is bounded by max_request_body_size.
+   */
+  uint64_t pendingRequestMessageBytes() const;
   void maybeSendHttpBodyRequestMessage(Buffer::Instance* data);
   /**
    * Builds response from HttpBody protobuf.
@@ -222,6 +232,9 @@ private:
   Buffer::OwnedImpl request_data_;
   bool first_request_sent_{false};
   std::string content_type_;
+  // The JSON bytes consumed by the transcoder since it last output a request message.
+  uint64_t request_message_bytes_{0};
+  bool bound_request_message_{false};
 
   bool error_{false};
   bool has_body_{false};
@@ -107,6 +107,8 @@ private:
   JwtLocationConstPtr curr_token_;
   // The JWT object.
   std::unique_ptr<JwtVerify::Jwt> owned_jwt_;
+  // The JWT found in the JWT cache, held in case it gets evicted during the verification.
+  JwtConstSharedPtr cached_jwt_;
   // The JWKS data object
   JwksCache::JwksData* jwks_data_{};
   // The HTTP request headers
@@ -128,7 +130,7 @@ private:
   const bool is_allow_failed_;
   const bool is_allow_missing_;
   TimeSource& time_source_;
-  JwtVerify::Jwt* jwt_{};
+  const JwtVerify::Jwt* jwt_{};
 };
 
 std::string AuthenticatorImpl::name() const {
@@ -178,7 +180,8 @@ void AuthenticatorImpl::startVerify() {
   Status status;
   if (provider_.has_value()) {
     jwks_data_ = jwks_cache_.findByProvider(*provider_);
-    jwt_ = jwks_data_->getJwtCache().lookup(curr_token_->token());
+    cached_jwt_ = jwks_data_->getJwtCache().lookup(curr_token_->token());
+    jwt_ = cached_jwt_.get();
     if (jwt_ != nullptr) {
       jwks_cache_.stats().jwt_cache_hit_.inc();
       use_jwt_cache = true;
@@ -61,6 +61,10 @@ public:
 
     bool enable_jwt_cache = jwt_provider_.has_jwt_cache_config();
     const auto& config = jwt_provider_.jwt_cache_config();
+    if (enable_jwt_cache && config.shared()) {
+      shared_jwt_cache_ = JwtCache::create(true, config, time_source_);
+      enable_jwt_cache = false;
+    }
     tls_.set([enable_jwt_cache, config](Envoy::Event::Dispatcher& dispatcher) {
       return std::make_shared<ThreadLocalCache>(enable_jwt_cache, config, dispatcher.timeSource());
     });
@@ -181,7 +185,9 @@ public:
     return shared_jwks.get();
   }
 
-  JwtCache& getJwtCache() override { return *tls_->jwt_cache_; }
+  JwtCache& getJwtCache() override {
+    return shared_jwt_cache_ != nullptr ? *shared_jwt_cache_ : *tls_->jwt_cache_;
+  }
 
 private:
   struct ThreadLocalCache : public ThreadLocal::ThreadLocalObject {
@@ -217,6 +223,8 @@ private:
   TimeSource& time_source_;
   // the thread local slot for cache
   ThreadLocal::TypedSlot<ThreadLocalCache> tls_;
+  // The JWT cache shared by the workers, used instead of their own if set.
+  JwtCachePtr shared_jwt_cache_;
   // async fetcher
   JwksAsyncFetcherPtr async_fetcher_;
   std::optional<Matchers::StringMatcherImpl> sub_matcher_;
@@ -1,10 +1,15 @@
 #include "source/extensions/filters/http/jwt_authn/jwt_cache.h"
 
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 #include "source/common/common/assert.h"
+#include "source/common/common/hash.h"
 #include "source/common/jwt/simple_lru_cache_inl.h"
 
+#include "absl/synchronization/mutex.h"
+
 using ::Envoy::SimpleLruCache::SimpleLRUCache;
 
 namespace Envoy {
@@ -18,36 +23,29 @@ constexpr int kJwtCacheDefaultSize = 100;
 // The maximum size of JWT to be cached.
 constexpr int kMaxJwtSizeForCache = 4 * 1024; // 4KiB
 
-class JwtCacheImpl : public JwtCache {
+using JwtLruCache = SimpleLRUCache<std::string, const JwtConstSharedPtr>;
+
+// The estimated memory used by a cached JWT: the cache key and the parsed JWT hold about three
+// copies of the token, in its encoded and decoded forms, in addition to the parsed claims.
+size_t jwtSizeBytes(const std::string& token, const JwtVerify::Jwt& jwt) {
+  return sizeof(JwtVerify::Jwt) + 3 * token.size() + jwt.header_pb_.SpaceUsedLong() +
+         jwt.payload_pb_.SpaceUsedLong();
+}
+
+// A LRU cache of JWTs bounded either by its number of JWTs, or by their size in bytes.
+class JwtCacheShard {
 public:
-  JwtCacheImpl(bool enable_cache, const JwtCacheConfig& config, TimeSource& time_source)
-      : time_source_(time_source) {
-    if (enable_cache) {
-      // if cache_size is 0, it is not specified in the config, use default
-      auto cache_size =
-          config.jwt_cache_size() == 0 ? kJwtCacheDefaultSize : config.jwt_cache_size();
-      jwt_lru_cache_ = std::make_unique<SimpleLRUCache<std::string, JwtVerify::Jwt>>(cache_size);
-      max_jwt_size_for_cache_ =
-          config.jwt_max_token_size() == 0 ? kMaxJwtSizeForCache : config.jwt_max_token_size();
-    }
-  }
+  JwtCacheShard(int64_t max_size, bool size_in_bytes)
+      : jwt_lru_cache_(std::make_unique<JwtLruCache>(max_size)), size_in_bytes_(size_in_bytes) {}
 
-  ~JwtCacheImpl() override {
-    if (jwt_lru_cache_) {
-      jwt_lru_cache_->clear();
-    }
-  }
+  ~JwtCacheShard() { jwt_lru_cache_->clear(); }
 
-  JwtVerify::Jwt* lookup(const std::string& token) override {
-    if (!jwt_lru_cache_) {
-      return nullptr;
-    }
-    SimpleLRUCache<std::string, JwtVerify::Jwt>::ScopedLookup lookup(jwt_lru_cache_.get(), token);
+  JwtConstSharedPtr lookup(const std::string& token, uint64_t now) {
+    JwtLruCache::ScopedLookup lookup(jwt_lru_cache_.get(), token);
     if (lookup.found()) {
-      JwtVerify::Jwt* const found_jwt = lookup.value();
+      const JwtConstSharedPtr& found_jwt = *lookup.value();
       ASSERT(found_jwt != nullptr);
-      if (found_jwt->verifyTimeConstraint(DateUtil::nowToSeconds(time_source_)) !=
-          JwtVerify::Status::JwtExpired) {
+      if (found_jwt->verifyTimeConstraint(now) != JwtVerify::Status::JwtExpired) {
         return found_jwt;
       } else {
         jwt_lru_cache_->remove(token);
@@ -56,19 +54,94 @@ public:
     return nullptr;
   }
 
+  void insert(const std::string& token, JwtConstSharedPtr&& jwt) {
+    const size_t units = size_in_bytes_ ? jwtSizeBytes(token, *jwt) : 1;
+    // pass the ownership of jwt to cache
+    jwt_lru_cache_->insert(token, new JwtConstSharedPtr(std::move(jwt)), units);
+  }
+
+private:
+  const std::unique_ptr<JwtLruCache> jwt_lru_cache_;
+  const bool size_in_bytes_;
+};
+
+class JwtCacheImpl : public JwtCache {
+public:
+  JwtCacheImpl(bool enable_cache, const JwtCacheConfig& config, TimeSource& time_source)
+      : time_source_(time_source), shared_(config.shared()),
+        shards_(enable_cache ? numShards(config, cacheSize(config)) : 0) {
+    if (enable_cache) {
+      const bool size_in_bytes = config.jwt_cache_size_bytes() > 0;
+      const int64_t cache_size = cacheSize(config);
+      const int64_t num_shards = shards_.size();
+      const int64_t shard_size = (cache_size + num_shards - 1) / num_shards;
+      for (Shard& shard : shards_) {
+        shard.cache_ = std::make_unique<JwtCacheShard>(shard_size, size_in_bytes);
+      }
+      max_jwt_size_for_cache_ =
+          config.jwt_max_token_size() == 0 ? kMaxJwtSizeForCache : config.jwt_max_token_size();
+    }
+  }
+
+  JwtConstSharedPtr lookup(const std::string& token) override {
+    if (shards_.empty()) {
+      return nullptr;
+    }
+    Shard& shard = shardFor(token);
+    absl::MutexLockMaybe lock(shared_ ? &shard.mutex_ : nullptr);
+    return shard.cache_->lookup(token, DateUtil::nowToSeconds(time_source_));
+  }
+
   void insert(const std::string& token, std::unique_ptr<JwtVerify::Jwt>&& jwt) override {
-    if (!jwt_lru_cache_ || token.size() > std::numeric_limits<uint32_t>::max()) {
+    if (shards_.empty() || token.size() > std::numeric_limits<uint32_t>::max()) {
       return;
     }
     if (static_cast<uint32_t>(token.size()) <= max_jwt_size_for_cache_) {
-      // pass the ownership of jwt to cache
-      jwt_lru_cache_->insert(token, jwt.release(), 1);
+      Shard& shard = shardFor(token);
+      absl::MutexLockMaybe lock(shared_ ? &shard.mutex_ : nullptr);
+      shard.cache_->insert(token, std::move(jwt));
     }
   }
 
 private:
-  std::unique_ptr<SimpleLRUCache<std::string, JwtVerify::Jwt>> jwt_lru_cache_;
+  struct Shard {
+    // Only locked when the cache is shared by the workers.
+    absl::Mutex mutex_;
+    std::unique_ptr<JwtCacheShard> cache_;
+  };
+
+  // The size of the cache, in number of JWTs or in bytes.
+  static int64_t cacheSize(const JwtCacheConfig& config) {
+    if (config.jwt_cache_size_bytes() > 0) {
+      return static_cast<int64_t>(
+          std::min<uint64_t>(config.jwt_cache_size_bytes(), std::numeric_limits<int64_t>::max()));
+    }
+    // if cache_size is 0, it is not specified in the config, use default
+    return config.jwt_cache_size() == 0 ? kJwtCacheDefaultSize : config.jwt_cache_size();
+  }
+
+  // The JWTs of a shared cache are spread over its shards by the hash of their token, each shard
+  // being locked independently so that the workers rarely contend for the same lock. There are no
+  // more shards than the cache holds units, so that rounding up the size of the shards doesn't
+  // grow the cache beyond its size.
+  static uint32_t numShards(const JwtCacheConfig& config, int64_t cache_size) {
+    if (!config.shared()) {
+      return 1;
+    }
+    const uint32_t num_shards = config.num_shards() == 0 ? DefaultNumShards : config.num_shards();
+    return static_cast<uint32_t>(std::min<int64_t>(num_shards, cache_size));
+  }
+
+  Shard& shardFor(const std::string& token) {
+    if (shards_.size() == 1) {
+      return shards_.front();
+    }
+    return shards_[HashUtil::xxHash64(token) % shards_.size()];
+  }
+
   TimeSource& time_source_;
+  const bool shared_;
+  std::vector<Shard> shards_;
   uint32_t max_jwt_size_for_cache_;
 };
 } // namespace
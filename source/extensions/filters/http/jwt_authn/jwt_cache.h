@@ -20,22 +20,27 @@ namespace JwtAuthn {
 
 class JwtCache;
 using JwtCachePtr = std::unique_ptr<JwtCache>;
+using JwtConstSharedPtr = std::shared_ptr<const JwtVerify::Jwt>;
 
 class JwtCache {
 public:
   virtual ~JwtCache() = default;
 
-  // Lookup a JWT in the cache, if found return the pointer to its parsed jwt struct.
-  // If no found, return nullptr.
-  virtual JwtVerify::Jwt* lookup(const std::string& token) PURE;
+  // Lookup a JWT in the cache, if found return its parsed jwt struct, which stays valid
+  // after its eviction. If no found, return nullptr.
+  virtual JwtConstSharedPtr lookup(const std::string& token) PURE;
 
   // Insert a JWT and its parsed JWT struct to the cache.
   // The function will take over the ownership of jwt object.
   virtual void insert(const std::string& token, std::unique_ptr<JwtVerify::Jwt>&& jwt) PURE;
 
-  // JwtCache factory function.
+  // JwtCache factory function. The cache is used by a single worker, unless it is created with
+  // `shared` set in its config, in which case it is thread safe.
   static JwtCachePtr create(bool enable_cache, const JwtCacheConfig& config,
                             TimeSource& time_source);
+
+  // The default number of shards of a shared cache.
+  static constexpr uint32_t DefaultNumShards = 16;
 };
 
 } // namespace JwtAuthn
@@ -129,6 +129,12 @@ FilterConfig::FilterConfig(
   rate_limiter_ = std::make_unique<Filters::Common::LocalRateLimit::LocalRateLimiterImpl>(
       fill_interval_, max_tokens_, tokens_per_fill_, dispatcher_, descriptors_,
       always_consume_default_token_bucket_, std::move(share_provider), max_dynamic_descriptors_);
+  if (config.has_token_leasing() && !rate_limit_per_connection_) {
+    rate_limiter_->enableTokenLeasing(
+        context.threadLocal(), config.token_leasing().lease_tokens(),
+        std::chrono::milliseconds(
+            PROTOBUF_GET_MS_OR_DEFAULT(config.token_leasing(), lease_duration, 100)));
+  }
 }
 
 Filters::Common::LocalRateLimit::LocalRateLimiter::Result
@@ -9,9 +9,12 @@
 
 #include "source/common/config/utility.h"
 #include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/common/ratelimit/over_limit_cache.h"
 #include "source/extensions/filters/common/ratelimit/ratelimit_impl.h"
 #include "source/extensions/filters/http/ratelimit/ratelimit.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -35,11 +38,29 @@ absl::StatusOr<Http::FilterFactoryCb> RateLimitFilterConfig::createFilterFactory
   RETURN_IF_NOT_OK(Config::Utility::checkTransportVersion(proto_config.rate_limit_service()));
   Grpc::GrpcServiceConfigWithHashKey config_with_hash_key =
       Grpc::GrpcServiceConfigWithHashKey(proto_config.rate_limit_service().grpc_service());
-  return [config_with_hash_key, &context, timeout,
-          filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addStreamFilter(std::make_shared<Filter>(
-        filter_config,
-        Filters::Common::RateLimit::rateLimitClient(context, config_with_hash_key, timeout)));
+  Filters::Common::RateLimit::OverLimitCacheConfigSharedPtr over_limit_cache;
+  if (proto_config.has_over_limit_cache()) {
+    const std::string stat_prefix =
+        proto_config.stat_prefix().empty()
+            ? "ratelimit."
+            : absl::StrCat("ratelimit.", proto_config.stat_prefix(), ".");
+    over_limit_cache = std::make_shared<Filters::Common::RateLimit::OverLimitCacheConfig>(
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+            proto_config.over_limit_cache(), max_entries,
+            Filters::Common::RateLimit::OverLimitCacheConfig::DefaultMaxEntries),
+        proto_config.over_limit_cache().coalesce_requests(), context.threadLocal(),
+        Filters::Common::RateLimit::OverLimitCacheStats{ALL_OVER_LIMIT_CACHE_STATS(
+            POOL_COUNTER_PREFIX(scope, stat_prefix))});
+  }
+  return [config_with_hash_key, &context, timeout, filter_config,
+          over_limit_cache](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    Filters::Common::RateLimit::ClientPtr client =
+        Filters::Common::RateLimit::rateLimitClient(context, config_with_hash_key, timeout);
+    if (over_limit_cache != nullptr) {
+      client = std::make_unique<Filters::Common::RateLimit::OverLimitCacheClient>(
+          std::move(client), *over_limit_cache);
+    }
+    callbacks.addStreamFilter(std::make_shared<Filter>(filter_config, std::move(client)));
   };
 }
 
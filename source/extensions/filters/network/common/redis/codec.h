@@ -194,6 +194,8 @@ public:
   //   Double:          raw RESP3 Double payload — decoder → encoder pass-through preserves
   //                    upstream bytes verbatim (a non-canonical-but-parseable representation
   //                    survives intact).
+  // A BulkString set by setBufferedString() is materialized on the first call. The non-const
+  // overload also drops the buffered payload, since the caller may modify the string.
   std::string& asString();
   const std::string& asString() const;
   int64_t& asInteger();
@@ -202,6 +204,21 @@ public:
   CompositeArray& asCompositeArray();
   const CompositeArray& asCompositeArray() const;
 
+  /**
+   * Sets the payload of a BulkString to the bytes of a buffer, which is taken over without copying
+   * its slices. The payload is shared, not copied, when the value is copied, and is encoded by
+   * referencing its slices, so a large value can be forwarded without ever being copied into a
+   * string.
+   * @param payload supplies the bytes of the bulk string.
+   */
+  void setBufferedString(Buffer::InstancePtr&& payload);
+
+  /**
+   * @return the payload set by setBufferedString(), or nullptr if the value is not a BulkString
+   *         backed by a buffer.
+   */
+  const std::shared_ptr<const Buffer::Instance>& bufferedString() const;
+
   /**
    * Get/set the type of the RespValue. A RespValue can only be a single type at a time. Each time
    * type() is called the type is changed and then the type specific as* methods can be used.
@@ -227,7 +244,12 @@ private:
   };
 
   void cleanup();
+  // Copies the string of ``other``, which must have the same string type as this value.
+  void assignString(const RespValue& other);
 
+  // The payload of a BulkString set by setBufferedString(). While set, ``string_`` is either empty
+  // or holds a copy materialized by asString().
+  std::shared_ptr<const Buffer::Instance> buffered_string_;
   RespType type_{};
 };
 
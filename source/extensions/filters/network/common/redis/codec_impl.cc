@@ -9,9 +9,11 @@
 
 #include "envoy/common/platform.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/fmt.h"
 #include "source/common/common/utility.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "absl/strings/ascii.h"
 #include "absl/strings/numbers.h"
@@ -29,6 +31,10 @@ namespace Redis {
 
 namespace {
 
+// Slices of a buffered bulk string shorter than this are copied when encoding, which is cheaper
+// than referencing them.
+constexpr uint64_t kMinReferencedSliceLength = 4096;
+
 bool isValidResp3BigNumber(absl::string_view value) {
   if (value.empty()) {
     return false;
@@ -145,6 +151,12 @@ std::string& RespValue::asString() {
          type_ == RespType::SimpleString || type_ == RespType::BlobError ||
          type_ == RespType::VerbatimString || type_ == RespType::BigNumber ||
          type_ == RespType::Double);
+  if (buffered_string_ != nullptr) {
+    if (string_.empty()) {
+      string_ = buffered_string_->toString();
+    }
+    buffered_string_.reset();
+  }
   return string_;
 }
 
@@ -153,9 +165,34 @@ const std::string& RespValue::asString() const {
          type_ == RespType::SimpleString || type_ == RespType::BlobError ||
          type_ == RespType::VerbatimString || type_ == RespType::BigNumber ||
          type_ == RespType::Double);
+  if (buffered_string_ != nullptr && string_.empty()) {
+    // Materializing the payload changes how the value is stored, not the value itself.
+    const_cast<std::string&>(string_) = buffered_string_->toString();
+  }
   return string_;
 }
 
+void RespValue::setBufferedString(Buffer::InstancePtr&& payload) {
+  ASSERT(type_ == RespType::BulkString);
+  string_.clear();
+  buffered_string_ = std::move(payload);
+}
+
+const std::shared_ptr<const Buffer::Instance>& RespValue::bufferedString() const {
+  return buffered_string_;
+}
+
+void RespValue::assignString(const RespValue& other) {
+  if (other.buffered_string_ != nullptr) {
+    // Share the payload rather than copying it, or a copy materialized from it.
+    string_.clear();
+    buffered_string_ = other.buffered_string_;
+  } else {
+    string_ = other.string_;
+    buffered_string_.reset();
+  }
+}
+
 int64_t& RespValue::asInteger() {
   ASSERT(type_ == RespType::Integer || type_ == RespType::Boolean);
   return integer_;
@@ -182,6 +219,7 @@ bool RespValue::asBoolean() const {
 }
 
 void RespValue::cleanup() {
+  buffered_string_.reset();
   // Need to manually delete because of the union.
   switch (type_) {
   case RespType::Array:
@@ -271,7 +309,7 @@ RespValue::RespValue(const RespValue& other) : type_(RespType::Null) {
   case RespType::VerbatimString:
   case RespType::BigNumber:
   case RespType::Double: {
-    asString() = other.asString();
+    assignString(other);
     break;
   }
   case RespType::Integer:
@@ -305,6 +343,7 @@ RespValue::RespValue(RespValue&& other) noexcept : type_(other.type_) {
   case RespType::BigNumber:
   case RespType::Double: {
     new (&string_) std::string(std::move(other.string_));
+    buffered_string_ = std::move(other.buffered_string_);
     break;
   }
   case RespType::Integer:
@@ -341,7 +380,7 @@ RespValue& RespValue::operator=(const RespValue& other) {
   case RespType::VerbatimString:
   case RespType::BigNumber:
   case RespType::Double: {
-    asString() = other.asString();
+    assignString(other);
     break;
   }
   case RespType::Integer:
@@ -381,6 +420,7 @@ RespValue& RespValue::operator=(RespValue&& other) noexcept {
   case RespType::BigNumber:
   case RespType::Double: {
     string_ = std::move(other.string_);
+    buffered_string_ = std::move(other.buffered_string_);
     break;
   }
   case RespType::Integer:
@@ -473,19 +513,39 @@ RespValue::CompositeArray::CompositeArrayConstIterator::empty() {
   return *instance;
 }
 
+DecoderImpl::DecoderImpl(DecoderCallbacks& callbacks)
+    : callbacks_(callbacks),
+      buffer_bulk_strings_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.redis_buffered_bulk_strings")) {}
+
 void DecoderImpl::decode(Buffer::Instance& data) {
-  for (const Buffer::RawSlice& slice : data.getRawSlices()) {
-    parseSlice(slice);
+  while (data.length() > 0) {
+    if (pending_buffered_string_ != nullptr) {
+      // Whole slices are moved, only a slice shared with the surrounding framing is copied.
+      const uint64_t length = std::min(pending_integer_.integer_, data.length());
+      pending_buffered_string_->move(data, length);
+      pending_integer_.integer_ -= length;
+      if (pending_integer_.integer_ == 0) {
+        ENVOY_LOG(trace, "parse slice: buffered BulkStringBody complete");
+        pending_value_stack_.front().value_->setBufferedString(
+            std::move(pending_buffered_string_));
+        state_ = State::CR;
+      }
+      continue;
+    }
+    data.drain(parseSlice(data.frontSlice()));
   }
-
-  data.drain(data.length());
 }
 
-void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
+uint64_t DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
   const char* buffer = reinterpret_cast<const char*>(slice.mem_);
   uint64_t remaining = slice.len_;
 
   while (remaining || state_ == State::ValueComplete) {
+    if (pending_buffered_string_ != nullptr) {
+      // The payload is moved out of the buffer by decode().
+      break;
+    }
     ENVOY_LOG(trace, "parse slice: {} remaining", remaining);
     switch (state_) {
     case State::ValueRootStart: {
@@ -971,6 +1031,10 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
           if (pending_integer_.integer_ > kMaxBulkStringLength) {
             throw ProtocolError("bulk string length exceeds maximum");
           }
+          if (buffer_bulk_strings_ && value_type == RespType::BulkString &&
+              pending_integer_.integer_ >= kMinBufferedBulkStringLength) {
+            pending_buffered_string_ = std::make_unique<Buffer::OwnedImpl>();
+          }
           state_ = State::BulkStringBody;
         } else if (value_type == RespType::BulkString && pending_integer_.integer_ == 1) {
           // Per RESP spec, only ``$-1`` is the null bulk string. Anything
@@ -1165,6 +1229,8 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
     }
     }
   }
+
+  return slice.len_ - remaining;
 }
 
 void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
@@ -1182,7 +1248,11 @@ void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
     break;
   }
   case RespType::BulkString: {
-    encodeBulkString(value.asString(), out);
+    if (value.bufferedString() != nullptr) {
+      encodeBufferedBulkString(value.bufferedString(), out);
+    } else {
+      encodeBulkString(value.asString(), out);
+    }
     break;
   }
   case RespType::Error: {
@@ -1356,6 +1426,32 @@ void EncoderImpl::encodeBulkString(const std::string& string, Buffer::Instance&
   encodeLengthPrefixed('$', string, out);
 }
 
+void EncoderImpl::encodeBufferedBulkString(const std::shared_ptr<const Buffer::Instance>& payload,
+                                           Buffer::Instance& out) {
+  char buffer[32];
+  char* current = buffer;
+  *current++ = '$';
+  current += StringUtil::itoa(current, 21, payload->length());
+  *current++ = '\r';
+  *current++ = '\n';
+  out.add(buffer, current - buffer);
+  for (const Buffer::RawSlice& slice : payload->getRawSlices()) {
+    if (slice.len_ < kMinReferencedSliceLength) {
+      out.add(slice.mem_, slice.len_);
+      continue;
+    }
+    // Reference the slice rather than copying it. The payload is kept alive until ``out`` is done
+    // with the slice, even if the value is destroyed first.
+    auto* fragment = new Buffer::BufferFragmentImpl(
+        slice.mem_, slice.len_,
+        [payload](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+          delete fragment;
+        });
+    out.addBufferFragment(*fragment);
+  }
+  out.add("\r\n", 2);
+}
+
 void EncoderImpl::encodeError(const std::string& string, Buffer::Instance& out) {
   out.add("-", 1);
   out.add(string);
@@ -23,7 +23,7 @@ namespace Redis {
  */
 class DecoderImpl : public Decoder, Logger::Loggable<Logger::Id::redis> {
 public:
-  DecoderImpl(DecoderCallbacks& callbacks) : callbacks_(callbacks) {}
+  DecoderImpl(DecoderCallbacks& callbacks);
 
   // RedisProxy::Decoder
   void decode(Buffer::Instance& data) override;
@@ -61,6 +61,10 @@ public:
   // upstream equivalent: an additional defense against multiplicative growth (kMaxNestingDepth *
   // kMaxRespElements element headers) that no single per-aggregate / per-depth limit catches.
   static constexpr uint64_t kMaxTotalElements = 4ULL * 1024ULL * 1024ULL;
+  // Bulk strings of at least this many bytes are not copied out of the decoded buffer: their
+  // payload is moved slice by slice into a buffer owned by the RespValue (see
+  // RespValue::setBufferedString()). Smaller ones are cheaper to copy than to move.
+  static constexpr uint64_t kMinBufferedBulkStringLength = 16 * 1024;
 
 private:
   enum class State {
@@ -110,9 +114,12 @@ private:
     bool is_attribute_{false}; // True when parsing RESP3 Attribute (|) — discarded on completion.
   };
 
-  void parseSlice(const Buffer::RawSlice& slice);
+  // Parses ``slice`` until it is consumed or the body of a buffered bulk string starts.
+  // @return the number of bytes of ``slice`` consumed.
+  uint64_t parseSlice(const Buffer::RawSlice& slice);
 
   DecoderCallbacks& callbacks_;
+  const bool buffer_bulk_strings_;
   State state_{State::ValueRootStart};
   PendingInteger pending_integer_;
   RespValuePtr pending_value_root_;
@@ -122,6 +129,9 @@ private:
   // cap enforced as each byte is accumulated; the terminating CR validates numeric syntax and
   // moves the buffer into ``RespValue::asString()``.
   std::string pending_double_buf_;
+  // The payload of the bulk string being decoded when it is at least kMinBufferedBulkStringLength
+  // bytes long, or nullptr.
+  Buffer::InstancePtr pending_buffered_string_;
   uint32_t consecutive_attributes_{0}; // counts toward kMaxConsecutiveAttributes
   // Number of attribute frames currently open on pending_value_stack_. Values completing while
   // this is non-zero belong to a frame that will itself be discarded, so they must not reset
@@ -159,6 +169,8 @@ private:
   void encodeArray(absl::Span<const RespValue> array, Buffer::Instance& out);
   void encodeCompositeArray(const RespValue::CompositeArray& array, Buffer::Instance& out);
   void encodeBulkString(const std::string& string, Buffer::Instance& out);
+  void encodeBufferedBulkString(const std::shared_ptr<const Buffer::Instance>& payload,
+                                Buffer::Instance& out);
   // Shared body of the three length-prefixed scalar frames — ``$`` bulk string, ``!`` blob
   // error, ``=`` verbatim string — which differ only in the type marker:
   // <prefix><length>CRLF<payload>CRLF.
@@ -196,6 +196,33 @@ struct SupportedCommands {
     return !writeCommands().contains(command);
   }
 
+  /**
+   * @return single-key read commands whose response only depends on the command, its arguments
+   * and the value of the key, so that identical in-flight requests may share one response.
+   */
+  static const absl::flat_hash_set<std::string>& coalescableReadCommands() {
+    CONSTRUCT_ON_FIRST_USE(
+        absl::flat_hash_set<std::string>, "bitcount", "bitpos", "get", "getbit", "getrange",
+        "hexists", "hget", "hgetall", "hkeys", "hlen", "hmget", "hstrlen", "hvals", "lindex",
+        "llen", "lpos", "lrange", "scard", "sismember", "smembers", "smismember", "strlen",
+        "xlen", "xrange", "xrevrange", "zcard", "zcount", "zlexcount", "zmscore", "zrange",
+        "zrangebylex", "zrangebyscore", "zrank", "zrevrange", "zrevrangebylex",
+        "zrevrangebyscore", "zrevrank", "zscore");
+  }
+
+  /**
+   * @return write commands that may write keys other than the one they are routed by, such as
+   * the destination of RENAME or of the *STORE commands, or of BITOP, which is routed by its
+   * operation.
+   */
+  static const absl::flat_hash_set<std::string>& multiKeyWriteCommands() {
+    CONSTRUCT_ON_FIRST_USE(absl::flat_hash_set<std::string>, "bitop", "copy", "georadius",
+                           "georadiusbymember", "geosearchstore", "lmove", "msetnx", "pfmerge",
+                           "rename", "renamenx", "rpoplpush", "sdiffstore", "sinterstore",
+                           "smove", "sort", "sunionstore", "zdiffstore", "zinterstore",
+                           "zrangestore", "zunionstore");
+  }
+
   /**
    * @return commands that are valid without mandatory arguments beyond the command name
    */
@@ -136,13 +136,19 @@ Factory::createFilterFactoryFromProtoTyped(const ProxyConfig& proto_config,
 
   const std::string stat_prefix = fmt::format("generic_proxy.{}.", proto_config.stat_prefix());
 
+  WriteCoalescingConfigSharedPtr write_coalescing;
+  if (proto_config.has_write_coalescing()) {
+    write_coalescing = std::make_shared<WriteCoalescingConfig>(
+        proto_config.write_coalescing(), stat_prefix + "downstream_", context.scope());
+  }
+
   const FilterConfigSharedPtr config = std::make_shared<FilterConfigImpl>(
       stat_prefix, std::move(factories.first),
       routeConfigProviderFromProto(proto_config, context, *route_config_provider_manager),
       filtersFactoryFromProto(proto_config.filters(), proto_config.codec_config(), stat_prefix,
                               context),
       std::move(tracer), std::move(tracing_config), std::move(access_logs), *code_or_flags,
-      context);
+      context, std::move(write_coalescing));
 
   return [route_config_provider_manager, tracer_manager, config, &context,
           custom_proxy_factory](Envoy::Network::FilterManager& filter_manager) -> void {
@@ -724,6 +724,10 @@ void Filter::writeToConnection(Buffer::Instance& buffer) {
   if (downstream_connection_closed_) {
     return;
   }
+  if (write_coalescer_ != nullptr) {
+    write_coalescer_->write(buffer);
+    return;
+  }
   downstreamConnection().write(buffer, false);
 }
 
@@ -773,6 +777,9 @@ void Filter::closeDownstreamConnection() {
   if (downstream_connection_closed_) {
     return;
   }
+  if (write_coalescer_ != nullptr) {
+    write_coalescer_->flush();
+  }
   downstream_connection_closed_ = true;
   downstreamConnection().close(Network::ConnectionCloseType::FlushWrite);
 }
@@ -31,6 +31,7 @@
 #include "source/extensions/filters/network/generic_proxy/route_impl.h"
 #include "source/extensions/filters/network/generic_proxy/stats.h"
 #include "source/extensions/filters/network/generic_proxy/tracing.h"
+#include "source/extensions/filters/network/generic_proxy/write_coalescer.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -66,14 +67,16 @@ public:
                    Tracing::ConnectionManagerTracingConfigPtr tracing_config,
                    AccessLog::InstanceSharedPtrVector&& access_logs,
                    const CodeOrFlags& code_or_flags,
-                   Envoy::Server::Configuration::FactoryContext& context)
+                   Envoy::Server::Configuration::FactoryContext& context,
+                   WriteCoalescingConfigSharedPtr write_coalescing = nullptr)
       : stat_prefix_(stat_prefix),
         stats_(GenericFilterStats::generateStats(stat_prefix_, context.scope())),
         code_or_flags_(code_or_flags), codec_factory_(std::move(codec)),
         route_config_provider_(std::move(route_config_provider)), factories_(std::move(factories)),
         drain_decision_(context.drainDecision()), tracer_(std::move(tracer)),
         tracing_config_(std::move(tracing_config)), access_logs_(std::move(access_logs)),
-        time_source_(context.serverFactoryContext().timeSource()) {}
+        time_source_(context.serverFactoryContext().timeSource()),
+        write_coalescing_(std::move(write_coalescing)) {}
 
   // FilterConfig
   RouteEntryConstSharedPtr routeEntry(const MatchInput& request) const override {
@@ -91,6 +94,9 @@ public:
   GenericFilterStats& stats() override { return stats_; }
   const CodeOrFlags& codeOrFlags() const override { return code_or_flags_; }
   const AccessLog::InstanceSharedPtrVector& accessLogs() const override { return access_logs_; }
+  const WriteCoalescingConfigSharedPtr& writeCoalescing() const override {
+    return write_coalescing_;
+  }
 
   // FilterChainFactory
   void createFilterChain(FilterChainFactoryCallbacks& callbacks) override {
@@ -122,6 +128,8 @@ private:
   std::vector<AccessLog::InstanceSharedPtr> access_logs_;
 
   TimeSource& time_source_;
+
+  const WriteCoalescingConfigSharedPtr write_coalescing_;
 };
 
 class ActiveStream : public LinkedObject<ActiveStream>,
@@ -374,6 +382,10 @@ public:
   void initializeReadFilterCallbacks(Envoy::Network::ReadFilterCallbacks& callbacks) override {
     callbacks_ = &callbacks;
     callbacks_->connection().addConnectionCallbacks(*this);
+    if (config_->writeCoalescing() != nullptr) {
+      write_coalescer_ =
+          std::make_unique<WriteCoalescer>(config_->writeCoalescing(), callbacks_->connection());
+    }
   }
 
   // ServerCodecCallbacks
@@ -453,6 +465,8 @@ private:
   ServerCodecPtr server_codec_;
 
   Buffer::OwnedImpl response_buffer_;
+  // Only set if the frames written to the downstream connection are coalesced.
+  WriteCoalescerPtr write_coalescer_;
 
   std::list<ActiveStreamPtr> active_streams_;
   absl::flat_hash_map<uint64_t, ActiveStream*> frame_handlers_;
@@ -11,6 +11,7 @@
 #include "source/extensions/filters/network/generic_proxy/match_input.h"
 #include "source/extensions/filters/network/generic_proxy/route.h"
 #include "source/extensions/filters/network/generic_proxy/stats.h"
+#include "source/extensions/filters/network/generic_proxy/write_coalescer.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -65,6 +66,12 @@ public:
    * @return const std::vector<AccessLogInstanceSharedPtr>& access logs.
    */
   virtual const AccessLog::InstanceSharedPtrVector& accessLogs() const PURE;
+
+  /**
+   * @return the write coalescing config of the downstream connections, or nullptr if the frames
+   * are written to the downstream connections directly.
+   */
+  virtual const WriteCoalescingConfigSharedPtr& writeCoalescing() const PURE;
 };
 
 } // namespace GenericProxy
@@ -9,13 +9,20 @@ namespace GenericProxy {
 namespace Router {
 
 FilterFactoryCb
-RouterFactory::createFilterFactoryFromProto(const Protobuf::Message& config, const std::string&,
+RouterFactory::createFilterFactoryFromProto(const Protobuf::Message& config,
+                                            const std::string& stat_prefix,
                                             Server::Configuration::FactoryContext& context) {
   const auto& typed_config = MessageUtil::downcastAndValidate<
       const envoy::extensions::filters::network::generic_proxy::router::v3::Router&>(
       config, context.messageValidationVisitor());
 
-  auto router_config = std::make_shared<RouterConfig>(typed_config);
+  WriteCoalescingConfigSharedPtr upstream_write_coalescing;
+  if (typed_config.bind_upstream_connection() && typed_config.has_upstream_write_coalescing()) {
+    upstream_write_coalescing = std::make_shared<WriteCoalescingConfig>(
+        typed_config.upstream_write_coalescing(), stat_prefix + "upstream_", context.scope());
+  }
+
+  auto router_config = std::make_shared<RouterConfig>(typed_config, upstream_write_coalescing);
 
   return [&context, router_config](FilterChainFactoryCallbacks& callbacks) {
     callbacks.addDecoderFilter(std::make_shared<RouterFilter>(router_config, context));
@@ -441,7 +441,8 @@ void RouterFilter::kickOffNewUpstreamRequest() {
 
   GenericUpstreamSharedPtr generic_upstream = generic_upstream_factory_->createGenericUpstream(
       *thread_local_cluster, this, const_cast<Network::Connection&>(*callbacks_->connection()),
-      callbacks_->codecFactory(), config_->bindUpstreamConnection());
+      callbacks_->codecFactory(), config_->bindUpstreamConnection(),
+      config_->upstreamWriteCoalescing());
   if (generic_upstream == nullptr) {
     completeAndSendLocalReply(Status(StatusCode::kUnavailable, "no_healthy_upstream"), {},
                               StreamInfo::CoreResponseFlag::NoHealthyUpstream);
@@ -104,13 +104,19 @@ using UpstreamRequestPtr = std::unique_ptr<UpstreamRequest>;
 
 class RouterConfig {
 public:
-  RouterConfig(const envoy::extensions::filters::network::generic_proxy::router::v3::Router& config)
-      : bind_upstream_connection_(config.bind_upstream_connection()) {}
+  RouterConfig(const envoy::extensions::filters::network::generic_proxy::router::v3::Router& config,
+               WriteCoalescingConfigSharedPtr upstream_write_coalescing = nullptr)
+      : bind_upstream_connection_(config.bind_upstream_connection()),
+        upstream_write_coalescing_(std::move(upstream_write_coalescing)) {}
 
   bool bindUpstreamConnection() const { return bind_upstream_connection_; }
+  const WriteCoalescingConfigSharedPtr& upstreamWriteCoalescing() const {
+    return upstream_write_coalescing_;
+  }
 
 private:
   const bool bind_upstream_connection_{};
+  const WriteCoalescingConfigSharedPtr upstream_write_coalescing_;
 };
 using RouterConfigSharedPtr = std::shared_ptr<RouterConfig>;
 
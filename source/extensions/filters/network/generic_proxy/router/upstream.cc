@@ -138,8 +138,9 @@ void UniqueRequestManager::onDecodingFailure(absl::string_view reason) {
 
 BoundGenericUpstream::BoundGenericUpstream(Envoy::Upstream::TcpPoolData tcp_pool_data,
                                            const CodecFactory& codec_factory,
-                                           Network::Connection& downstream_connection)
-    : UpstreamBase(std::move(tcp_pool_data), codec_factory),
+                                           Network::Connection& downstream_connection,
+                                           WriteCoalescingConfigSharedPtr write_coalescing)
+    : UpstreamBase(std::move(tcp_pool_data), codec_factory, std::move(write_coalescing)),
       downstream_conn_(downstream_connection),
       connection_event_watcher_(
           [this](Network::ConnectionEvent event) { onDownstreamConnectionEvent(event); }) {
@@ -313,7 +314,8 @@ void OwnedGenericUpstream::onUpstreamFailure(ConnectionPool::PoolFailureReason r
 
 GenericUpstreamSharedPtr ProdGenericUpstreamFactory::createGenericUpstream(
     Upstream::ThreadLocalCluster& cluster, Upstream::LoadBalancerContext* context,
-    Network::Connection& downstream_conn, const CodecFactory& codec_factory, bool bound) const {
+    Network::Connection& downstream_conn, const CodecFactory& codec_factory, bool bound,
+    const WriteCoalescingConfigSharedPtr& write_coalescing) const {
 
   if (bound) {
     auto* bound_upstream =
@@ -326,7 +328,7 @@ GenericUpstreamSharedPtr ProdGenericUpstreamFactory::createGenericUpstream(
         return nullptr;
       }
       auto new_bound_upstream = std::make_shared<BoundGenericUpstream>(
-          std::move(pool_data.value()), codec_factory, downstream_conn);
+          std::move(pool_data.value()), codec_factory, downstream_conn, write_coalescing);
       bound_upstream = new_bound_upstream.get();
       downstream_conn.streamInfo().filterState()->setData(
           RouterFilterName, std::move(new_bound_upstream),
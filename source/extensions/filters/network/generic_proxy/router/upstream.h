@@ -7,6 +7,7 @@
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/extensions/filters/network/generic_proxy/interface/codec.h"
+#include "source/extensions/filters/network/generic_proxy/write_coalescer.h"
 
 #include "absl/container/linked_hash_map.h"
 
@@ -70,11 +71,14 @@ class GenericUpstreamFactory {
 public:
   virtual ~GenericUpstreamFactory() = default;
 
-  virtual GenericUpstreamSharedPtr createGenericUpstream(Upstream::ThreadLocalCluster& cluster,
-                                                         Upstream::LoadBalancerContext* context,
-                                                         Network::Connection& downstream_conn,
-                                                         const CodecFactory& codec_factory,
-                                                         bool bound) const PURE;
+  // The write coalescing config is only used for bound upstream connections, which may carry
+  // several requests at a time.
+  virtual GenericUpstreamSharedPtr
+  createGenericUpstream(Upstream::ThreadLocalCluster& cluster,
+                        Upstream::LoadBalancerContext* context,
+                        Network::Connection& downstream_conn, const CodecFactory& codec_factory,
+                        bool bound,
+                        const WriteCoalescingConfigSharedPtr& write_coalescing) const PURE;
 };
 
 template <class RequestManager>
@@ -83,13 +87,24 @@ class EncoderDecoder : public ClientCodecCallbacks,
                        public Network::ConnectionCallbacks {
 public:
   EncoderDecoder(Network::Connection& connection, Upstream::HostDescriptionConstSharedPtr host,
-                 ClientCodecPtr client_codec)
+                 ClientCodecPtr client_codec,
+                 WriteCoalescingConfigSharedPtr write_coalescing = nullptr)
       : connection_(connection), host_(std::move(host)), client_codec_(std::move(client_codec)) {
     client_codec_->setCodecCallbacks(*this);
+    if (write_coalescing != nullptr) {
+      write_coalescer_ = std::make_unique<WriteCoalescer>(std::move(write_coalescing), connection_);
+    }
   }
 
   ClientCodec& clientCodec() { return *client_codec_; }
 
+  // Write the coalesced frames to the connection now, if any.
+  void flushWrites() {
+    if (write_coalescer_ != nullptr) {
+      write_coalescer_->flush();
+    }
+  }
+
   // Insert a pending request that is waiting response into the encoder/decoder.
   void appendUpstreamRequest(uint64_t stream_id, UpstreamRequestCallbacks* pending_request) {
     request_manager_.appendUpstreamRequest(stream_id, pending_request);
@@ -115,9 +130,14 @@ public:
     request_manager_.onDecodingFailure(reason);
   }
   void writeToConnection(Buffer::Instance& buffer) override {
-    if (connection_.state() == Network::Connection::State::Open) {
-      connection_.write(buffer, false);
+    if (connection_.state() != Network::Connection::State::Open) {
+      return;
     }
+    if (write_coalescer_ != nullptr) {
+      write_coalescer_->write(buffer);
+      return;
+    }
+    connection_.write(buffer, false);
   }
   OptRef<Network::Connection> connection() override {
     return connection_.state() == Network::Connection::State::Open
@@ -142,6 +162,8 @@ private:
   Upstream::HostDescriptionConstSharedPtr host_;
   ClientCodecPtr client_codec_;
   RequestManager request_manager_{};
+  // Only set if the frames written to the connection are coalesced.
+  WriteCoalescerPtr write_coalescer_;
 };
 
 class SharedRequestManager : Logger::Loggable<Logger::Id::upstream> {
@@ -190,8 +212,10 @@ class UpstreamBase : public GenericUpstream,
                      public Tcp::ConnectionPool::UpstreamCallbacks,
                      public Logger::Loggable<Logger::Id::upstream> {
 public:
-  UpstreamBase(Upstream::TcpPoolData pool_data, const CodecFactory& codec_factory)
-      : tcp_pool_data_(std::move(pool_data)), codec_factory_(codec_factory) {}
+  UpstreamBase(Upstream::TcpPoolData pool_data, const CodecFactory& codec_factory,
+               WriteCoalescingConfigSharedPtr write_coalescing = nullptr)
+      : tcp_pool_data_(std::move(pool_data)), codec_factory_(codec_factory),
+        write_coalescing_(std::move(write_coalescing)) {}
   ~UpstreamBase() override {
     if (tcp_pool_handle_ != nullptr) {
       tcp_pool_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
@@ -247,6 +271,11 @@ public:
     ENVOY_LOG(debug, "generic proxy upstream manager: clean up upstream (close: {})",
               close_connection);
 
+    // Write the coalesced frames before the connection is closed.
+    if (close_connection && encoder_decoder_ != nullptr) {
+      encoder_decoder_->flushWrites();
+    }
+
     // Clear the encoder/decoder first.
     encoder_decoder_ = nullptr;
 
@@ -312,8 +341,8 @@ protected:
         connection.streamInfo().filterState()->getDataMutable<EncoderDecoderType>(
             RouterFilterEncoderDecoderName);
     if (encoder_decoder == nullptr) {
-      auto data = std::make_unique<EncoderDecoderType>(connection, tcp_pool_data_.host(),
-                                                       codec_factory_.createClientCodec());
+      auto data = std::make_unique<EncoderDecoderType>(
+          connection, tcp_pool_data_.host(), codec_factory_.createClientCodec(), write_coalescing_);
       // The encoder_decoder will has lifetime of the upstream connection. Register it as a
       // connection callback to handle connection close event.
       connection.addConnectionCallbacks(*data);
@@ -329,6 +358,7 @@ protected:
   Tcp::ConnectionPool::Cancellable* tcp_pool_handle_{};
   Tcp::ConnectionPool::ConnectionDataPtr owned_conn_data_;
   const CodecFactory& codec_factory_;
+  const WriteCoalescingConfigSharedPtr write_coalescing_;
   EncoderDecoderType* encoder_decoder_{};
 
   // Whether the upstream connection is created. This will be set to true when
@@ -353,7 +383,8 @@ class BoundGenericUpstream : public BoundGenericUpstreamBase,
 public:
   BoundGenericUpstream(Envoy::Upstream::TcpPoolData tcp_pool_data,
                        const CodecFactory& codec_factory,
-                       Network::Connection& downstream_connection);
+                       Network::Connection& downstream_connection,
+                       WriteCoalescingConfigSharedPtr write_coalescing = nullptr);
 
   // UpstreamBase
   void onUpstreamSuccess() override;
@@ -418,11 +449,12 @@ private:
 
 class ProdGenericUpstreamFactory : public GenericUpstreamFactory {
 public:
-  GenericUpstreamSharedPtr createGenericUpstream(Upstream::ThreadLocalCluster& cluster,
-                                                 Upstream::LoadBalancerContext* context,
-                                                 Network::Connection& downstream_conn,
-                                                 const CodecFactory& codec_factory,
-                                                 bool bound) const override;
+  GenericUpstreamSharedPtr
+  createGenericUpstream(Upstream::ThreadLocalCluster& cluster,
+                        Upstream::LoadBalancerContext* context,
+                        Network::Connection& downstream_conn, const CodecFactory& codec_factory,
+                        bool bound,
+                        const WriteCoalescingConfigSharedPtr& write_coalescing) const override;
 };
 
 using DefaultGenericUpstreamFactory = ConstSingleton<ProdGenericUpstreamFactory>;
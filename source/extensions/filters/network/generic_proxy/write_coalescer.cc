@@ -0,0 +1,83 @@
+#include "source/extensions/filters/network/generic_proxy/write_coalescer.h"
+
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace GenericProxy {
+
+namespace {
+
+constexpr uint64_t DefaultMaxBytes = 16 * 1024;
+
+} // namespace
+
+WriteCoalescingConfig::WriteCoalescingConfig(
+    const envoy::extensions::filters::network::generic_proxy::v3::WriteCoalescing& config,
+    const std::string& stat_prefix, Stats::Scope& scope)
+    : max_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_bytes, DefaultMaxBytes)),
+      max_delay_(PROTOBUF_GET_MS_OR_DEFAULT(config, max_delay, 0)),
+      stats_{ALL_WRITE_COALESCING_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix),
+                                        POOL_HISTOGRAM_PREFIX(scope, stat_prefix))} {}
+
+WriteCoalescer::WriteCoalescer(WriteCoalescingConfigSharedPtr config,
+                               Network::Connection& connection)
+    : config_(std::move(config)), connection_(connection) {
+  if (config_->maxDelay().count() > 0) {
+    flush_timer_ = connection_.dispatcher().createTimer([this]() { flush(); });
+  } else {
+    flush_callback_ = connection_.dispatcher().createSchedulableCallback([this]() { flush(); });
+  }
+}
+
+void WriteCoalescer::write(Buffer::Instance& buffer) {
+  buffer_.move(buffer);
+  buffered_frames_++;
+
+  if (buffer_.length() >= config_->maxBytes()) {
+    flush();
+    return;
+  }
+
+  // Only the first buffered frame arms the flush, so that a frame is never delayed by more than
+  // the configured delay.
+  if (buffered_frames_ == 1) {
+    if (flush_timer_ != nullptr) {
+      flush_timer_->enableTimer(config_->maxDelay());
+    } else {
+      flush_callback_->scheduleCallbackCurrentIteration();
+    }
+  }
+}
+
+void WriteCoalescer::flush() {
+  if (buffered_frames_ == 0) {
+    return;
+  }
+  if (flush_timer_ != nullptr) {
+    flush_timer_->disableTimer();
+  } else {
+    flush_callback_->cancel();
+  }
+
+  const uint64_t frames = buffered_frames_;
+  buffered_frames_ = 0;
+  if (connection_.state() != Network::Connection::State::Open) {
+    buffer_.drain(buffer_.length());
+    return;
+  }
+
+  WriteCoalescingStats& stats = config_->stats();
+  stats.coalesced_frames_.add(frames);
+  stats.coalesced_writes_.inc();
+  stats.frames_per_write_.recordValue(frames);
+  ENVOY_LOG(trace, "generic proxy: writing {} coalesced frames ({} bytes)", frames,
+            buffer_.length());
+  connection_.write(buffer_, false);
+}
+
+} // namespace GenericProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
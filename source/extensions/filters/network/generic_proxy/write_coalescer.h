@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/schedulable_cb.h"
+#include "envoy/event/timer.h"
+#include "envoy/extensions/filters/network/generic_proxy/v3/generic_proxy.pb.h"
+#include "envoy/network/connection.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/logger.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace GenericProxy {
+
+/**
+ * All write coalescing stats. @see stats_macros.h. The average number of frames per write is
+ * coalesced_frames / coalesced_writes.
+ */
+#define ALL_WRITE_COALESCING_STATS(COUNTER, HISTOGRAM)                                             \
+  COUNTER(coalesced_frames)                                                                        \
+  COUNTER(coalesced_writes)                                                                        \
+  HISTOGRAM(frames_per_write, Unspecified)
+
+/**
+ * Struct definition for all write coalescing stats. @see stats_macros.h
+ */
+struct WriteCoalescingStats {
+  ALL_WRITE_COALESCING_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * Configuration of the write coalescing of the connections on one side of a generic proxy.
+ */
+class WriteCoalescingConfig {
+public:
+  /**
+   * @param config supplies the proto configuration.
+   * @param stat_prefix supplies the prefix of the stats, e.g. "generic_proxy.foo.downstream_".
+   * @param scope supplies the scope of the stats.
+   */
+  WriteCoalescingConfig(
+      const envoy::extensions::filters::network::generic_proxy::v3::WriteCoalescing& config,
+      const std::string& stat_prefix, Stats::Scope& scope);
+
+  uint64_t maxBytes() const { return max_bytes_; }
+  std::chrono::milliseconds maxDelay() const { return max_delay_; }
+  WriteCoalescingStats& stats() const { return stats_; }
+
+private:
+  const uint64_t max_bytes_;
+  const std::chrono::milliseconds max_delay_;
+  mutable WriteCoalescingStats stats_;
+};
+using WriteCoalescingConfigSharedPtr = std::shared_ptr<const WriteCoalescingConfig>;
+
+/**
+ * Buffers the frames written to a connection and writes them to it together, at the end of the
+ * current event loop iteration or after the configured delay, or as soon as the configured number
+ * of bytes is buffered. Each call to write() is counted as one frame.
+ */
+class WriteCoalescer : Logger::Loggable<Logger::Id::filter> {
+public:
+  WriteCoalescer(WriteCoalescingConfigSharedPtr config, Network::Connection& connection);
+
+  /**
+   * Buffers a frame, draining the supplied buffer.
+   */
+  void write(Buffer::Instance& buffer);
+
+  /**
+   * Writes the buffered frames to the connection now, if it is still open. This should be called
+   * before the connection is closed with a flush.
+   */
+  void flush();
+
+  uint64_t bufferedBytes() const { return buffer_.length(); }
+
+private:
+  WriteCoalescingConfigSharedPtr config_;
+  Network::Connection& connection_;
+  Buffer::OwnedImpl buffer_;
+  uint64_t buffered_frames_{};
+  // Only one of them is created, depending on whether a delay is configured.
+  Event::SchedulableCallbackPtr flush_callback_;
+  Event::TimerPtr flush_timer_;
+};
+using WriteCoalescerPtr = std::unique_ptr<WriteCoalescer>;
+
+} // namespace GenericProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -116,6 +116,11 @@ public:
   virtual void encode(Buffer::Instance& output) const PURE;
   virtual const Field* find(const std::string& name) const PURE;
   virtual const Field* find(const std::string& name, Field::Type type) const PURE;
+
+  /**
+   * @return the first field of the document, or nullptr if the document is empty.
+   */
+  virtual const Field* front() const PURE;
   virtual std::string toString() const PURE;
   virtual const std::list<FieldPtr>& values() const PURE;
 };
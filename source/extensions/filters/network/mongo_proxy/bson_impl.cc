@@ -4,6 +4,7 @@
 #include <sstream>
 #include <string>
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/byte_order.h"
 #include "source/common/common/fmt.h"
@@ -417,110 +418,106 @@ void DocumentImpl::fromBuffer(Buffer::Instance& data, uint32_t max_depth, uint32
 
     const uint8_t element_type = BufferHelper::removeByte(data);
     const std::string key = BufferHelper::removeCString(data);
-    ENVOY_LOG(trace, "BSON element type: {:#x} key: {}", element_type, key);
-    switch (static_cast<Field::Type>(element_type)) {
-    case Field::Type::Double: {
-      double value = BufferHelper::removeDouble(data);
-      ENVOY_LOG(trace, "BSON double: {}", value);
-      addDouble(key, value);
-      break;
-    }
+    fields_.push_back(decodeField(element_type, key, data, max_depth, current_depth, false));
+  }
+}
 
-    case Field::Type::String: {
-      std::string value = BufferHelper::removeString(data);
-      ENVOY_LOG(trace, "BSON string: {}", value);
-      addString(key, std::move(value));
-      break;
-    }
+FieldPtr DocumentImpl::decodeField(uint8_t element_type, const std::string& key,
+                                   Buffer::Instance& data, uint32_t max_depth,
+                                   uint32_t current_depth, bool lazy) {
+  ENVOY_LOG(trace, "BSON element type: {:#x} key: {}", element_type, key);
+  switch (static_cast<Field::Type>(element_type)) {
+  case Field::Type::Double: {
+    double value = BufferHelper::removeDouble(data);
+    ENVOY_LOG(trace, "BSON double: {}", value);
+    return std::make_unique<FieldImpl>(key, value);
+  }
 
-    case Field::Type::Symbol: {
-      std::string value = BufferHelper::removeString(data);
-      ENVOY_LOG(trace, "BSON symbol: {}", value);
-      addSymbol(key, std::move(value));
-      break;
-    }
+  case Field::Type::String: {
+    std::string value = BufferHelper::removeString(data);
+    ENVOY_LOG(trace, "BSON string: {}", value);
+    return std::make_unique<FieldImpl>(Field::Type::String, key, std::move(value));
+  }
 
-    case Field::Type::Document: {
-      ENVOY_LOG(trace, "BSON document");
-      addDocument(key, DocumentImpl::create(data, max_depth, current_depth + 1));
-      break;
-    }
+  case Field::Type::Symbol: {
+    std::string value = BufferHelper::removeString(data);
+    ENVOY_LOG(trace, "BSON symbol: {}", value);
+    return std::make_unique<FieldImpl>(Field::Type::Symbol, key, std::move(value));
+  }
 
-    case Field::Type::Array: {
-      ENVOY_LOG(trace, "BSON array");
-      addArray(key, DocumentImpl::create(data, max_depth, current_depth + 1));
-      break;
-    }
+  case Field::Type::Document: {
+    ENVOY_LOG(trace, "BSON document");
+    return std::make_unique<FieldImpl>(
+        Field::Type::Document, key,
+        lazy ? LazyDocumentImpl::create(data, max_depth, current_depth + 1)
+             : DocumentImpl::create(data, max_depth, current_depth + 1));
+  }
 
-    case Field::Type::Binary: {
-      std::string value = BufferHelper::removeBinary(data);
-      ENVOY_LOG(trace, "BSON binary: {}", value);
-      addBinary(key, std::move(value));
-      break;
-    }
+  case Field::Type::Array: {
+    ENVOY_LOG(trace, "BSON array");
+    return std::make_unique<FieldImpl>(
+        Field::Type::Array, key,
+        lazy ? LazyDocumentImpl::create(data, max_depth, current_depth + 1)
+             : DocumentImpl::create(data, max_depth, current_depth + 1));
+  }
 
-    case Field::Type::ObjectId: {
-      Field::ObjectId value;
-      BufferHelper::removeBytes(data, &value[0], value.size());
-      addObjectId(key, std::move(value));
-      break;
-    }
+  case Field::Type::Binary: {
+    std::string value = BufferHelper::removeBinary(data);
+    ENVOY_LOG(trace, "BSON binary: {}", value);
+    return std::make_unique<FieldImpl>(Field::Type::Binary, key, std::move(value));
+  }
 
-    case Field::Type::Boolean: {
-      const bool value = BufferHelper::removeByte(data) != 0;
-      ENVOY_LOG(trace, "BSON boolean: {}", value);
-      addBoolean(key, value);
-      break;
-    }
+  case Field::Type::ObjectId: {
+    Field::ObjectId value;
+    BufferHelper::removeBytes(data, &value[0], value.size());
+    return std::make_unique<FieldImpl>(key, std::move(value));
+  }
 
-    case Field::Type::Datetime: {
-      const int64_t value = BufferHelper::removeInt64(data);
-      ENVOY_LOG(trace, "BSON datetime: {}", value);
-      addDatetime(key, value);
-      break;
-    }
+  case Field::Type::Boolean: {
+    const bool value = BufferHelper::removeByte(data) != 0;
+    ENVOY_LOG(trace, "BSON boolean: {}", value);
+    return std::make_unique<FieldImpl>(key, value);
+  }
 
-    case Field::Type::NullValue: {
-      ENVOY_LOG(trace, "BSON null value");
-      addNull(key);
-      break;
-    }
+  case Field::Type::Datetime: {
+    const int64_t value = BufferHelper::removeInt64(data);
+    ENVOY_LOG(trace, "BSON datetime: {}", value);
+    return std::make_unique<FieldImpl>(Field::Type::Datetime, key, value);
+  }
 
-    case Field::Type::Regex: {
-      Field::Regex value;
-      value.pattern_ = BufferHelper::removeCString(data);
-      value.options_ = BufferHelper::removeCString(data);
-      ENVOY_LOG(trace, "BSON regex pattern: {} options: {}", value.pattern_, value.options_);
-      addRegex(key, std::move(value));
-      break;
-    }
+  case Field::Type::NullValue: {
+    ENVOY_LOG(trace, "BSON null value");
+    return std::make_unique<FieldImpl>(key);
+  }
 
-    case Field::Type::Int32: {
-      const int32_t value = BufferHelper::removeInt32(data);
-      ENVOY_LOG(trace, "BSON int32: {}", value);
-      addInt32(key, value);
-      break;
-    }
+  case Field::Type::Regex: {
+    Field::Regex value;
+    value.pattern_ = BufferHelper::removeCString(data);
+    value.options_ = BufferHelper::removeCString(data);
+    ENVOY_LOG(trace, "BSON regex pattern: {} options: {}", value.pattern_, value.options_);
+    return std::make_unique<FieldImpl>(key, std::move(value));
+  }
 
-    case Field::Type::Timestamp: {
-      const int64_t value = BufferHelper::removeInt64(data);
-      ENVOY_LOG(trace, "BSON timestamp: {}", value);
-      addTimestamp(key, value);
-      break;
-    }
+  case Field::Type::Int32: {
+    const int32_t value = BufferHelper::removeInt32(data);
+    ENVOY_LOG(trace, "BSON int32: {}", value);
+    return std::make_unique<FieldImpl>(key, value);
+  }
 
-    case Field::Type::Int64: {
-      const int64_t value = BufferHelper::removeInt64(data);
-      ENVOY_LOG(trace, "BSON int64: {}", value);
-      addInt64(key, value);
-      break;
-    }
+  case Field::Type::Timestamp: {
+    const int64_t value = BufferHelper::removeInt64(data);
+    ENVOY_LOG(trace, "BSON timestamp: {}", value);
+    return std::make_unique<FieldImpl>(Field::Type::Timestamp, key, value);
+  }
 
-    default:
-      throw EnvoyException(
-          fmt::format("invalid BSON element type: {:#x} key: {}", element_type, key));
-    }
+  case Field::Type::Int64: {
+    const int64_t value = BufferHelper::removeInt64(data);
+    ENVOY_LOG(trace, "BSON int64: {}", value);
+    return std::make_unique<FieldImpl>(Field::Type::Int64, key, value);
   }
+  }
+
+  throw EnvoyException(fmt::format("invalid BSON element type: {:#x} key: {}", element_type, key));
 }
 
 int32_t DocumentImpl::byteSize() const {
@@ -597,6 +594,201 @@ const Field* DocumentImpl::find(const std::string& name, Field::Type type) const
   return nullptr;
 }
 
+DocumentSharedPtr LazyDocumentImpl::create(Buffer::Instance& data, uint32_t max_depth,
+                                           uint32_t current_depth) {
+  if (current_depth > max_depth) {
+    throw EnvoyException("BSON recursion limit exceeded");
+  }
+
+  // The smallest document is its length and terminator.
+  const int32_t length = BufferHelper::peekInt32(data);
+  if (length < static_cast<int32_t>(sizeof(int32_t) + 1) ||
+      static_cast<uint64_t>(length) > data.length()) {
+    throw EnvoyException("invalid BSON message length");
+  }
+
+  std::string raw(length, '\0');
+  data.copyOut(0, length, raw.data());
+  data.drain(length);
+  if (raw.back() != '\0') {
+    throw EnvoyException("invalid document");
+  }
+
+  ENVOY_LOG(trace, "BSON document length: {} (lazy)", length);
+  return DocumentSharedPtr{new LazyDocumentImpl(std::move(raw), max_depth, current_depth)};
+}
+
+Document& LazyDocumentImpl::document() const {
+  if (document_ == nullptr) {
+    Buffer::BufferFragmentImpl fragment(raw_.data(), raw_.size(), nullptr);
+    Buffer::OwnedImpl data;
+    data.addBufferFragment(fragment);
+    document_ = DocumentImpl::create(data, max_depth_, current_depth_);
+    std::string().swap(raw_);
+  }
+
+  return *document_;
+}
+
+int32_t LazyDocumentImpl::byteSize() const {
+  return document_ != nullptr ? document_->byteSize() : static_cast<int32_t>(raw_.size());
+}
+
+void LazyDocumentImpl::encode(Buffer::Instance& output) const {
+  if (document_ != nullptr) {
+    return document_->encode(output);
+  }
+
+  output.add(raw_);
+}
+
+const Field* LazyDocumentImpl::find(const std::string& name) const {
+  if (document_ != nullptr) {
+    return document_->find(name);
+  }
+
+  return lazyFind([&name](Field::Type, absl::string_view key) { return key == name; });
+}
+
+const Field* LazyDocumentImpl::find(const std::string& name, Field::Type type) const {
+  if (document_ != nullptr) {
+    return document_->find(name, type);
+  }
+
+  return lazyFind([&name, type](Field::Type field_type, absl::string_view key) {
+    return field_type == type && key == name;
+  });
+}
+
+const Field* LazyDocumentImpl::front() const {
+  if (document_ != nullptr) {
+    return document_->front();
+  }
+
+  return lazyFind([](Field::Type, absl::string_view) { return true; });
+}
+
+const Field* LazyDocumentImpl::lazyFind(
+    const std::function<bool(Field::Type, absl::string_view)>& matches) const {
+  // raw_ is known to end with the document terminator, which no field extends into.
+  const uint64_t end = raw_.size() - 1;
+  uint64_t offset = sizeof(int32_t);
+  while (offset < end) {
+    const uint64_t field_offset = offset;
+    const uint8_t element_type = raw_[offset++];
+    const uint64_t key_end = raw_.find('\0', offset);
+    if (key_end >= end) {
+      throw EnvoyException("invalid CString");
+    }
+
+    const absl::string_view key(raw_.data() + offset, key_end - offset);
+    offset = key_end + 1;
+    const uint64_t value_size = valueSize(static_cast<Field::Type>(element_type), key, offset);
+    if (!matches(static_cast<Field::Type>(element_type), key)) {
+      offset += value_size;
+      continue;
+    }
+
+    auto it = found_fields_.find(field_offset);
+    if (it == found_fields_.end()) {
+      Buffer::BufferFragmentImpl fragment(raw_.data() + offset, value_size, nullptr);
+      Buffer::OwnedImpl value;
+      value.addBufferFragment(fragment);
+      it = found_fields_
+               .emplace(field_offset,
+                        DocumentImpl::decodeField(element_type, std::string(key), value,
+                                                  max_depth_, current_depth_, true))
+               .first;
+    }
+
+    return it->second.get();
+  }
+
+  return nullptr;
+}
+
+uint64_t LazyDocumentImpl::valueSize(Field::Type type, absl::string_view key,
+                                     uint64_t offset) const {
+  uint64_t size;
+  switch (type) {
+  case Field::Type::Double:
+  case Field::Type::Datetime:
+  case Field::Type::Timestamp:
+  case Field::Type::Int64:
+    size = sizeof(int64_t);
+    break;
+
+  case Field::Type::String:
+  case Field::Type::Symbol:
+    size = sizeof(int32_t) + readLength(offset);
+    break;
+
+  case Field::Type::Document:
+  case Field::Type::Array:
+    // The length of an embedded document includes itself.
+    size = readLength(offset);
+    break;
+
+  case Field::Type::Binary:
+    // The length is followed by the subtype.
+    size = sizeof(int32_t) + 1 + readLength(offset);
+    break;
+
+  case Field::Type::ObjectId:
+    size = sizeof(Field::ObjectId);
+    break;
+
+  case Field::Type::Boolean:
+    size = 1;
+    break;
+
+  case Field::Type::NullValue:
+    size = 0;
+    break;
+
+  case Field::Type::Regex: {
+    // The pattern and the options are both C strings.
+    const uint64_t pattern_end = raw_.find('\0', offset);
+    const uint64_t options_end = pattern_end < raw_.size() - 1 ? raw_.find('\0', pattern_end + 1)
+                                                               : std::string::npos;
+    if (options_end >= raw_.size() - 1) {
+      throw EnvoyException("invalid CString");
+    }
+    size = options_end + 1 - offset;
+    break;
+  }
+
+  case Field::Type::Int32:
+    size = sizeof(int32_t);
+    break;
+
+  default:
+    throw EnvoyException(fmt::format("invalid BSON element type: {:#x} key: {}",
+                                     static_cast<uint8_t>(type), key));
+  }
+
+  if (size > raw_.size() - 1 - offset) {
+    throw EnvoyException("invalid document");
+  }
+
+  return size;
+}
+
+uint64_t LazyDocumentImpl::readLength(uint64_t offset) const {
+  if (raw_.size() - 1 - offset < sizeof(int32_t)) {
+    throw EnvoyException("invalid buffer size");
+  }
+
+  uint32_t length;
+  safeMemcpyUnsafeSrc(&length, raw_.data() + offset);
+  const int32_t value = le32toh(length);
+  if (value < 0) {
+    throw EnvoyException("invalid buffer size");
+  }
+
+  return value;
+}
+
 } // namespace Bson
 } // namespace MongoProxy
 } // namespace NetworkFilters
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <list>
 #include <memory>
 #include <string>
@@ -11,6 +12,9 @@
 #include "source/common/common/utility.h"
 #include "source/extensions/filters/network/mongo_proxy/bson.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -185,6 +189,19 @@ public:
     return new_doc;
   }
 
+  /**
+   * Decodes the value of a field from a buffer.
+   * @param element_type supplies the raw type of the field.
+   * @param key supplies the key of the field.
+   * @param data supplies the buffer, which starts with the value and is drained of it.
+   * @param max_depth supplies the maximum depth of embedded documents.
+   * @param current_depth supplies the depth of the document the field belongs to.
+   * @param lazy whether embedded documents are decoded on demand.
+   * @return FieldPtr the decoded field.
+   */
+  static FieldPtr decodeField(uint8_t element_type, const std::string& key, Buffer::Instance& data,
+                              uint32_t max_depth, uint32_t current_depth, bool lazy);
+
   // Mongo::Document
   DocumentSharedPtr addDouble(const std::string& key, double value) override {
     fields_.emplace_back(new FieldImpl(key, value));
@@ -261,6 +278,9 @@ public:
   void encode(Buffer::Instance& output) const override;
   const Field* find(const std::string& name) const override;
   const Field* find(const std::string& name, Field::Type type) const override;
+  const Field* front() const override {
+    return fields_.empty() ? nullptr : fields_.front().get();
+  }
   std::string toString() const override;
   const std::list<FieldPtr>& values() const override { return fields_; }
 
@@ -272,6 +292,129 @@ private:
   std::list<FieldPtr> fields_;
 };
 
+/**
+ * A document that keeps its wire bytes and decodes them on demand. find() and front() walk the
+ * wire bytes and decode only the field they return, skipping over the values of other fields
+ * including embedded documents. Embedded documents that are returned are decoded on demand as
+ * well. Anything that needs every field, such as values(), toString() or add*(), decodes the whole
+ * document once. Decoding errors are thrown when the affected bytes are first decoded.
+ */
+class LazyDocumentImpl : public Document,
+                         Logger::Loggable<Logger::Id::mongo>,
+                         public std::enable_shared_from_this<LazyDocumentImpl> {
+public:
+  static DocumentSharedPtr create(Buffer::Instance& data, uint32_t max_depth,
+                                  uint32_t current_depth = 0);
+
+  // Mongo::Document
+  DocumentSharedPtr addDouble(const std::string& key, double value) override {
+    document().addDouble(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addString(const std::string& key, std::string&& value) override {
+    document().addString(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addSymbol(const std::string& key, std::string&& value) override {
+    document().addSymbol(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addDocument(const std::string& key, DocumentSharedPtr value) override {
+    document().addDocument(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addArray(const std::string& key, DocumentSharedPtr value) override {
+    document().addArray(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addBinary(const std::string& key, std::string&& value) override {
+    document().addBinary(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addObjectId(const std::string& key, Field::ObjectId&& value) override {
+    document().addObjectId(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addBoolean(const std::string& key, bool value) override {
+    document().addBoolean(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addDatetime(const std::string& key, int64_t value) override {
+    document().addDatetime(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addNull(const std::string& key) override {
+    document().addNull(key);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addRegex(const std::string& key, Field::Regex&& value) override {
+    document().addRegex(key, std::move(value));
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addInt32(const std::string& key, int32_t value) override {
+    document().addInt32(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addTimestamp(const std::string& key, int64_t value) override {
+    document().addTimestamp(key, value);
+    return shared_from_this();
+  }
+
+  DocumentSharedPtr addInt64(const std::string& key, int64_t value) override {
+    document().addInt64(key, value);
+    return shared_from_this();
+  }
+
+  bool operator==(const Document& rhs) const override { return document() == rhs; }
+  int32_t byteSize() const override;
+  void encode(Buffer::Instance& output) const override;
+  const Field* find(const std::string& name) const override;
+  const Field* find(const std::string& name, Field::Type type) const override;
+  const Field* front() const override;
+  std::string toString() const override { return document().toString(); }
+  const std::list<FieldPtr>& values() const override { return document().values(); }
+
+  /**
+   * @return whether the whole document has been decoded.
+   */
+  bool decoded() const { return document_ != nullptr; }
+
+private:
+  LazyDocumentImpl(std::string&& raw, uint32_t max_depth, uint32_t current_depth)
+      : raw_(std::move(raw)), max_depth_(max_depth), current_depth_(current_depth) {}
+
+  // Decodes the whole document if it has not been decoded yet.
+  Document& document() const;
+  // Returns the first field whose type and key match, decoding only that field.
+  const Field* lazyFind(const std::function<bool(Field::Type, absl::string_view)>& matches) const;
+  // Returns the size of the value of a field of the given type that starts at offset.
+  uint64_t valueSize(Field::Type type, absl::string_view key, uint64_t offset) const;
+  // Returns the non-negative length that starts at offset.
+  uint64_t readLength(uint64_t offset) const;
+
+  // The wire bytes of the document, including its length and terminator. Released once the whole
+  // document has been decoded.
+  mutable std::string raw_;
+  const uint32_t max_depth_;
+  const uint32_t current_depth_;
+  mutable DocumentSharedPtr document_;
+  // Fields decoded by lazyFind(), by offset in raw_. They outlive the decoding of the whole
+  // document so that the pointers handed out stay valid.
+  mutable absl::flat_hash_map<uint64_t, FieldPtr> found_fields_;
+};
+
 } // namespace Bson
 } // namespace MongoProxy
 } // namespace NetworkFilters
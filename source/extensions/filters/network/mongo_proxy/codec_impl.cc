@@ -37,6 +37,14 @@ MessageImpl::documentListToString(const std::list<Bson::DocumentSharedPtr>& docu
   return out.str();
 }
 
+Bson::DocumentSharedPtr MessageImpl::decodeDocument(Buffer::Instance& data) const {
+  if (lazy_bson_) {
+    return Bson::LazyDocumentImpl::create(data, max_bson_depth_);
+  }
+
+  return Bson::DocumentImpl::create(data, max_bson_depth_);
+}
+
 void GetMoreMessageImpl::fromBuffer(uint32_t, Buffer::Instance& data) {
   ENVOY_LOG(trace, "decoding get more message");
   Bson::BufferHelper::removeInt32(data); // "zero" (unused)
@@ -67,7 +75,7 @@ void InsertMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& da
   flags_ = Bson::BufferHelper::removeInt32(data);
   full_collection_name_ = Bson::BufferHelper::removeCString(data);
   while (data.length() - (original_buffer_length - message_length) > 0) {
-    documents_.emplace_back(Bson::DocumentImpl::create(data, max_bson_depth_));
+    documents_.emplace_back(decodeDocument(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -141,10 +149,10 @@ void QueryMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& dat
   full_collection_name_ = Bson::BufferHelper::removeCString(data);
   number_to_skip_ = Bson::BufferHelper::removeInt32(data);
   number_to_return_ = Bson::BufferHelper::removeInt32(data);
-  query_ = Bson::DocumentImpl::create(data, max_bson_depth_);
+  query_ = decodeDocument(data);
 
   if (data.length() - (original_buffer_length - message_length) > 0) {
-    return_fields_selector_ = Bson::DocumentImpl::create(data, max_bson_depth_);
+    return_fields_selector_ = decodeDocument(data);
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -189,7 +197,7 @@ void ReplyMessageImpl::fromBuffer(uint32_t, Buffer::Instance& data) {
   starting_from_ = Bson::BufferHelper::removeInt32(data);
   number_returned_ = Bson::BufferHelper::removeInt32(data);
   for (int32_t i = 0; i < number_returned_; i++) {
-    documents_.emplace_back(Bson::DocumentImpl::create(data, max_bson_depth_));
+    documents_.emplace_back(decodeDocument(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -231,14 +239,14 @@ void CommandMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& d
 
   database_ = Bson::BufferHelper::removeCString(data);
   command_name_ = Bson::BufferHelper::removeCString(data);
-  metadata_ = Bson::DocumentImpl::create(data, max_bson_depth_);
-  command_args_ = Bson::DocumentImpl::create(data, max_bson_depth_);
+  metadata_ = decodeDocument(data);
+  command_args_ = decodeDocument(data);
 
   // There may be additional docs.
   // message_length is mongo message length. original_data_length contains
   // mongo message and possibly first few bytes of next message.
   while (data.length() - (original_data_length - message_length) > 0) {
-    input_docs_.emplace_back(Bson::DocumentImpl::create(data, max_bson_depth_));
+    input_docs_.emplace_back(decodeDocument(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -291,14 +299,14 @@ void CommandReplyMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instan
   const uint64_t original_data_length = data.length();
   ASSERT(data.length() >= message_length); // See comment below about relationship.
 
-  metadata_ = Bson::DocumentImpl::create(data, max_bson_depth_);
-  command_reply_ = Bson::DocumentImpl::create(data, max_bson_depth_);
+  metadata_ = decodeDocument(data);
+  command_reply_ = decodeDocument(data);
 
   // There may be additional docs.
   // message_length is mongo message length. original_data_length contains
   // mongo message and possibly first few bytes of next message.
   while (data.length() - (original_data_length - message_length) > 0) {
-    output_docs_.emplace_back(Bson::DocumentImpl::create(data, max_bson_depth_));
+    output_docs_.emplace_back(decodeDocument(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -372,7 +380,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
   switch (op_code) {
   case Message::OpCode::Reply: {
     std::unique_ptr<ReplyMessageImpl> message(
-        new ReplyMessageImpl(request_id, response_to, max_bson_depth_));
+        new ReplyMessageImpl(request_id, response_to, max_bson_depth_, lazy_bson_));
     message->fromBuffer(message_length, data);
     callbacks_.decodeReply(std::move(message));
     break;
@@ -380,7 +388,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::Query: {
     std::unique_ptr<QueryMessageImpl> message(
-        new QueryMessageImpl(request_id, response_to, max_bson_depth_));
+        new QueryMessageImpl(request_id, response_to, max_bson_depth_, lazy_bson_));
     message->fromBuffer(message_length, data);
     callbacks_.decodeQuery(std::move(message));
     break;
@@ -388,7 +396,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::GetMore: {
     std::unique_ptr<GetMoreMessageImpl> message(
-        new GetMoreMessageImpl(request_id, response_to, max_bson_depth_));
+        new GetMoreMessageImpl(request_id, response_to, max_bson_depth_, lazy_bson_));
     message->fromBuffer(message_length, data);
     callbacks_.decodeGetMore(std::move(message));
     break;
@@ -396,7 +404,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::Insert: {
     std::unique_ptr<InsertMessageImpl> message(
-        new InsertMessageImpl(request_id, response_to, max_bson_depth_));
+        new InsertMessageImpl(request_id, response_to, max_bson_depth_, lazy_bson_));
     message->fromBuffer(message_length, data);
     callbacks_.decodeInsert(std::move(message));
     break;
@@ -404,7 +412,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::KillCursors: {
     std::unique_ptr<KillCursorsMessageImpl> message(
-        new KillCursorsMessageImpl(request_id, response_to, max_bson_depth_));
+        new KillCursorsMessageImpl(request_id, response_to, max_bson_depth_, lazy_bson_));
     message->fromBuffer(message_length, data);
     callbacks_.decodeKillCursors(std::move(message));
     break;
@@ -412,7 +420,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::Command: {
     std::unique_ptr<CommandMessageImpl> message(
-        new CommandMessageImpl(request_id, response_to, max_bson_depth_));
+        new CommandMessageImpl(request_id, response_to, max_bson_depth_, lazy_bson_));
     message->fromBuffer(message_length, data);
     callbacks_.decodeCommand(std::move(message));
     break;
@@ -420,7 +428,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::CommandReply: {
     std::unique_ptr<CommandReplyMessageImpl> message(
-        new CommandReplyMessageImpl(request_id, response_to, max_bson_depth_));
+        new CommandReplyMessageImpl(request_id, response_to, max_bson_depth_, lazy_bson_));
     message->fromBuffer(message_length, data);
     callbacks_.decodeCommandReply(std::move(message));
     break;
@@ -15,8 +15,10 @@ namespace MongoProxy {
 
 class MessageImpl : public virtual Message {
 public:
-  MessageImpl(int32_t request_id, uint32_t response_to, uint32_t max_bson_depth = 100)
-      : request_id_(request_id), response_to_(response_to), max_bson_depth_(max_bson_depth) {}
+  MessageImpl(int32_t request_id, uint32_t response_to, uint32_t max_bson_depth = 100,
+              bool lazy_bson = false)
+      : request_id_(request_id), response_to_(response_to), max_bson_depth_(max_bson_depth),
+        lazy_bson_(lazy_bson) {}
 
   virtual void fromBuffer(uint32_t message_length, Buffer::Instance& data) PURE;
 
@@ -26,10 +28,14 @@ public:
 
 protected:
   std::string documentListToString(const std::list<Bson::DocumentSharedPtr>& documents) const;
+  // Decodes the next document of the message, lazily if lazy_bson_ is set.
+  Bson::DocumentSharedPtr decodeDocument(Buffer::Instance& data) const;
 
   const int32_t request_id_;
   const int32_t response_to_;
   const uint32_t max_bson_depth_;
+  // Whether documents are decoded on demand. See Bson::LazyDocumentImpl.
+  const bool lazy_bson_;
 };
 
 class GetMoreMessageImpl : public MessageImpl,
@@ -272,8 +278,8 @@ private:
 
 class DecoderImpl : public Decoder, Logger::Loggable<Logger::Id::mongo> {
 public:
-  DecoderImpl(DecoderCallbacks& callbacks, uint32_t max_bson_depth)
-      : callbacks_(callbacks), max_bson_depth_(max_bson_depth) {}
+  DecoderImpl(DecoderCallbacks& callbacks, uint32_t max_bson_depth, bool lazy_bson = false)
+      : callbacks_(callbacks), max_bson_depth_(max_bson_depth), lazy_bson_(lazy_bson) {}
 
   // Mongo::Decoder
   void onData(Buffer::Instance& data) override;
@@ -283,6 +289,7 @@ private:
 
   DecoderCallbacks& callbacks_;
   const uint32_t max_bson_depth_;
+  const bool lazy_bson_;
 };
 
 class EncoderImpl : public Encoder, Logger::Loggable<Logger::Id::mongo> {
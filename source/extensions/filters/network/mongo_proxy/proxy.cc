@@ -13,6 +13,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/fmt.h"
 #include "source/common/common/utility.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/extensions/filters/network/mongo_proxy/codec_impl.h"
 #include "source/extensions/filters/network/well_known_names.h"
 
@@ -391,7 +392,9 @@ Network::FilterStatus ProxyFilter::onWrite(Buffer::Instance& data, bool) {
 }
 
 DecoderPtr ProdProxyFilter::createDecoder(DecoderCallbacks& callbacks) {
-  return DecoderPtr{new DecoderImpl(callbacks, max_bson_depth_)};
+  return DecoderPtr{new DecoderImpl(
+      callbacks, max_bson_depth_,
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.mongo_proxy_lazy_bson"))};
 }
 
 std::optional<std::chrono::milliseconds> ProxyFilter::delayDuration() {
@@ -16,7 +16,7 @@ QueryMessageInfo::QueryMessageInfo(const QueryMessage& query) : request_id_{quer
   // First see if this is a command, if so we are done.
   const Bson::Document* command = parseCommand(query);
   if (command) {
-    command_ = command->values().front()->key();
+    command_ = command->front()->key();
 
     // Special case the 3.2 'find' command since it is a query.
     if (command_ == "find") {
@@ -84,7 +84,7 @@ const Bson::Document* QueryMessageInfo::parseCommand(const QueryMessage& query)
     doc_to_use = &field->asDocument();
   }
 
-  if (doc_to_use->values().empty()) {
+  if (doc_to_use->front() == nullptr) {
     throw EnvoyException("invalid query command");
   }
 
@@ -140,7 +140,7 @@ QueryMessageInfo::parseTypeFromDocument(const Bson::Document& document) {
 }
 
 void QueryMessageInfo::parseFindCommand(const Bson::Document& command) {
-  collection_ = command.values().front()->asString();
+  collection_ = command.front()->asString();
   const Bson::Field* comment = command.find("comment", Bson::Field::Type::String);
   if (comment) {
     callsite_ = parseCallingFunctionJson(comment->asString());
@@ -433,7 +433,8 @@ void MGETRequest::onChildResponse(Common::Redis::RespValuePtr&& value, uint32_t
     FALLTHRU;
   }
   case Common::Redis::RespType::BulkString: {
-    pending_response_->asArray()[index].asString().swap(value->asString());
+    // Moving the value keeps a buffered bulk string from being materialized.
+    pending_response_->asArray()[index] = std::move(*value);
     break;
   }
   case Common::Redis::RespType::Null:
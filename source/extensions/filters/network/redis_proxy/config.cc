@@ -74,6 +74,12 @@ Network::FilterFactoryCb RedisProxyFilterConfigFactory::createFilterFactoryFromP
   auto redis_command_stats =
       Common::Redis::RedisCommandStats::createRedisCommandStats(context.scope().symbolTable());
 
+  ConnPool::ReadCoalescerConfigConstSharedPtr read_coalescer_config;
+  if (proto_config.settings().has_read_coalescing()) {
+    read_coalescer_config = std::make_shared<const ConnPool::ReadCoalescerConfig>(
+        proto_config.settings().read_coalescing(), server_context);
+  }
+
   Upstreams upstreams;
   for (auto& cluster : unique_clusters) {
 
@@ -110,7 +116,7 @@ Network::FilterFactoryCb RedisProxyFilterConfigFactory::createFilterFactoryFromP
         Common::Redis::Client::ClientFactoryImpl::instance_, server_context.threadLocal(),
         proto_config.settings(), server_context.api(), std::move(stats_scope), redis_command_stats,
         refresh_manager, filter_config->dns_cache_, aws_iam_config, aws_iam_authenticator,
-        local_zone, protocol_version);
+        local_zone, protocol_version, read_coalescer_config);
     conn_pool_ptr->init();
     upstreams.emplace(cluster, conn_pool_ptr);
   }
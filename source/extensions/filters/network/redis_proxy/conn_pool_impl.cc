@@ -54,14 +54,21 @@ InstanceImpl::InstanceImpl(
     std::optional<envoy::extensions::filters::network::redis_proxy::v3::AwsIam> aws_iam_config,
     std::optional<Common::Redis::AwsIamAuthenticator::AwsIamAuthenticatorSharedPtr>
         aws_iam_authenticator,
-    const std::string& local_zone, Common::Redis::RespProtocolVersion protocol_version)
+    const std::string& local_zone, Common::Redis::RespProtocolVersion protocol_version,
+    ReadCoalescerConfigConstSharedPtr read_coalescer_config)
     : cluster_name_(cluster_name), cm_(cm), client_factory_(client_factory),
       tls_(tls.allocateSlot()), config_(new Common::Redis::Client::ConfigImpl(config)), api_(api),
       stats_scope_(std::move(stats_scope)), redis_command_stats_(redis_command_stats),
       redis_cluster_stats_{REDIS_CLUSTER_STATS(POOL_COUNTER(*stats_scope_))},
       refresh_manager_(std::move(refresh_manager)), dns_cache_(dns_cache),
       aws_iam_authenticator_(aws_iam_authenticator), aws_iam_config_(aws_iam_config),
-      local_zone_(local_zone), protocol_version_(protocol_version) {}
+      local_zone_(local_zone), protocol_version_(protocol_version),
+      read_coalescer_config_(std::move(read_coalescer_config)) {
+  if (read_coalescer_config_ != nullptr) {
+    read_coalescer_stats_ = std::make_unique<ReadCoalescerStats>(
+        ReadCoalescerStats{ALL_READ_COALESCER_STATS(POOL_COUNTER(*stats_scope_))});
+  }
+}
 
 void InstanceImpl::init() {
   // Note: `this` and `cluster_name` have a a lifetime of the filter.
@@ -125,6 +132,10 @@ InstanceImpl::ThreadLocalPool::ThreadLocalPool(
       refresh_manager_(parent->refresh_manager_), aws_iam_authenticator_(aws_iam_authenticator),
       aws_iam_config_(aws_iam_config), client_zone_(parent->localZone()),
       upstream_protocol_version_(parent->protocol_version_) {
+  if (parent->read_coalescer_config_ != nullptr) {
+    read_coalescer_ = std::make_unique<ReadCoalescer>(parent->read_coalescer_config_,
+                                                      *parent->read_coalescer_stats_, dispatcher);
+  }
 
   cluster_update_handle_ = parent->cm_.addThreadLocalClusterUpdateCallbacks(*this);
   Upstream::ThreadLocalCluster* cluster = parent->cm_.getThreadLocalCluster(cluster_name_);
@@ -336,6 +347,19 @@ Common::Redis::Client::PoolRequest*
 InstanceImpl::ThreadLocalPool::makeRequest(const std::string& key, RespVariant&& request,
                                            PoolCallbacks& callbacks,
                                            Common::Redis::Client::Transaction& transaction) {
+  if (read_coalescer_ == nullptr) {
+    return makeRequestToKeyHost(key, std::move(request), callbacks, transaction);
+  }
+  return read_coalescer_->makeRequest(
+      key, std::move(request), callbacks, transaction.active_,
+      [this, &key, &transaction](RespVariant&& request, PoolCallbacks& callbacks) {
+        return makeRequestToKeyHost(key, std::move(request), callbacks, transaction);
+      });
+}
+
+Common::Redis::Client::PoolRequest* InstanceImpl::ThreadLocalPool::makeRequestToKeyHost(
+    const std::string& key, RespVariant&& request, PoolCallbacks& callbacks,
+    Common::Redis::Client::Transaction& transaction) {
   if (cluster_ == nullptr) {
     ASSERT(client_map_.empty());
     ASSERT(host_set_member_update_cb_handle_ == nullptr);
@@ -365,6 +389,9 @@ InstanceImpl::ThreadLocalPool::makeRequestToShard(uint16_t shard_index, RespVari
     ASSERT(host_set_member_update_cb_handle_ == nullptr);
     return nullptr;
   }
+  if (read_coalescer_ != nullptr) {
+    read_coalescer_->onShardRequest(getRequest(request));
+  }
 
   Clusters::Redis::RedisSpecifyShardContextImpl lb_context(
       shard_index, getRequest(request),
@@ -29,6 +29,7 @@
 #include "source/extensions/filters/network/common/redis/codec_impl.h"
 #include "source/extensions/filters/network/common/redis/utility.h"
 #include "source/extensions/filters/network/redis_proxy/conn_pool.h"
+#include "source/extensions/filters/network/redis_proxy/read_coalescer.h"
 
 #include "absl/container/node_hash_map.h"
 #include "absl/strings/string_view.h"
@@ -72,7 +73,8 @@ public:
       std::optional<envoy::extensions::filters::network::redis_proxy::v3::AwsIam> aws_iam_config,
       std::optional<Common::Redis::AwsIamAuthenticator::AwsIamAuthenticatorSharedPtr>
           aws_iam_authenticator,
-      const std::string& local_zone, Common::Redis::RespProtocolVersion protocol_version);
+      const std::string& local_zone, Common::Redis::RespProtocolVersion protocol_version,
+      ReadCoalescerConfigConstSharedPtr read_coalescer_config);
   uint16_t shardSize() override;
   // RedisProxy::ConnPool::Instance
   Common::Redis::Client::PoolRequest*
@@ -171,6 +173,9 @@ private:
     makeRequest(const std::string& key, RespVariant&& request, PoolCallbacks& callbacks,
                 Common::Redis::Client::Transaction& transaction);
     Common::Redis::Client::PoolRequest*
+    makeRequestToKeyHost(const std::string& key, RespVariant&& request, PoolCallbacks& callbacks,
+                         Common::Redis::Client::Transaction& transaction);
+    Common::Redis::Client::PoolRequest*
     makeRequestToHost(Upstream::HostConstSharedPtr& host, RespVariant&& request,
                       PoolCallbacks& callbacks, Common::Redis::Client::Transaction& transaction);
     Common::Redis::Client::PoolRequest*
@@ -230,6 +235,8 @@ private:
     std::string client_zone_; // Zone from node.locality.zone
     // Mirrors InstanceImpl::protocol_version_; drives upstream HELLO 3 emission.
     Common::Redis::RespProtocolVersion upstream_protocol_version_;
+    // Only set if read coalescing is configured.
+    ReadCoalescerPtr read_coalescer_;
   };
 
   const std::string& localZone() const { return local_zone_; }
@@ -251,6 +258,8 @@ private:
   const std::string local_zone_; // Zone from node.locality.zone
   // Listener-level RESP version, mirrored into each ThreadLocalPool on slot creation.
   const Common::Redis::RespProtocolVersion protocol_version_;
+  const ReadCoalescerConfigConstSharedPtr read_coalescer_config_;
+  std::unique_ptr<ReadCoalescerStats> read_coalescer_stats_;
 };
 
 } // namespace ConnPool
@@ -0,0 +1,335 @@
+#include "source/extensions/filters/network/redis_proxy/read_coalescer.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/network/common/redis/supported_commands.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+namespace ConnPool {
+
+namespace {
+
+constexpr absl::string_view Separator{"\0", 1};
+
+// Returns the lowercase command name of a request, or an empty string if it has none.
+std::string commandName(const Common::Redis::RespValue& request) {
+  if (request.type() != Common::Redis::RespType::Array || request.asArray().empty() ||
+      request.asArray()[0].type() != Common::Redis::RespType::BulkString) {
+    return "";
+  }
+  return absl::AsciiStrToLower(request.asArray()[0].asString());
+}
+
+const Common::Redis::RespValue& getRequest(const RespVariant& request) {
+  if (request.index() == 0) {
+    return absl::get<const Common::Redis::RespValue>(request);
+  } else {
+    return *(absl::get<Common::Redis::RespValueConstSharedPtr>(request));
+  }
+}
+
+} // namespace
+
+ReadCoalescerConfig::ReadCoalescerConfig(
+    const envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCoalescing& config,
+    Server::Configuration::CommonFactoryContext& context)
+    : cache_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, cache_ttl, DefaultCacheTtlMs)),
+      max_cached_responses_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_cached_responses,
+                                                            DefaultMaxCachedResponses)) {
+  for (const auto& matcher : config.cached_keys()) {
+    cached_keys_.emplace_back(matcher, context);
+  }
+}
+
+bool ReadCoalescerConfig::cacheable(absl::string_view key) const {
+  for (const auto& matcher : cached_keys_) {
+    if (matcher.match(key)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+ReadCoalescer::ReadCoalescer(ReadCoalescerConfigConstSharedPtr config,
+                             const ReadCoalescerStats& stats, Event::Dispatcher& dispatcher)
+    : config_(std::move(config)), stats_(stats), dispatcher_(dispatcher),
+      deliver_cached_responses_(
+          dispatcher.createSchedulableCallback([this]() { deliverCachedResponses(); })) {}
+
+ReadCoalescer::~ReadCoalescer() {
+  // Requests still in flight upstream have already been failed by the owning pool. Responses
+  // served from the cache that have not been delivered yet are failed the same way.
+  while (!cached_responses_.empty()) {
+    CachedResponsePtr response = std::move(cached_responses_.front());
+    cached_responses_.pop_front();
+    response->callbacks_.onFailure();
+  }
+}
+
+Common::Redis::Client::PoolRequest*
+ReadCoalescer::makeRequest(const std::string& key, RespVariant&& request, PoolCallbacks& callbacks,
+                           bool in_transaction, UpstreamRequest upstream_request) {
+  const Common::Redis::RespValue& value = getRequest(request);
+  const std::string command = commandName(value);
+  if (in_transaction) {
+    // The commands of a transaction are routed by the transaction's first key, and only run
+    // upstream at EXEC, which may write any key.
+    if (command != "exec") {
+      return upstream_request(std::move(request), callbacks);
+    }
+    // The transaction runs on its own upstream connection, so reads sent on other connections
+    // before EXEC completes may run before it. Their responses are dropped when it completes.
+    invalidateAll();
+    Group& group = addGroup("", false);
+    group.joinable_ = false;
+    group.invalidate_all_on_completion_ = true;
+    return sendGroupRequest(group, std::move(request), callbacks, upstream_request);
+  }
+
+  std::string signature = readSignature(key, value);
+  if (signature.empty()) {
+    // Anything that is not a known read is treated as a write. Scripts may write any key, and
+    // some commands write keys other than the one they are routed by.
+    if (Common::Redis::SupportedCommands::evalCommands().contains(command) ||
+        Common::Redis::SupportedCommands::multiKeyWriteCommands().contains(command)) {
+      invalidateAll();
+    } else {
+      invalidate(key);
+    }
+    return upstream_request(std::move(request), callbacks);
+  }
+
+  const bool cacheable = config_->cacheable(key);
+  if (cacheable) {
+    Common::Redis::Client::PoolRequest* cached = serveFromCache(signature, callbacks);
+    if (cached != nullptr) {
+      return cached;
+    }
+  }
+
+  auto joinable = joinable_groups_.find(signature);
+  if (joinable != joinable_groups_.end()) {
+    stats_.read_coalesced_.inc();
+    return &joinable->second->addWaiter(callbacks);
+  }
+
+  Group& group = addGroup(std::move(signature), cacheable);
+  joinable_groups_.emplace(group.signature_, &group);
+  return sendGroupRequest(group, std::move(request), callbacks, upstream_request);
+}
+
+ReadCoalescer::Group& ReadCoalescer::addGroup(std::string signature, bool cacheable) {
+  groups_.push_front(std::make_unique<Group>(*this, std::move(signature), cacheable));
+  Group& group = *groups_.front();
+  group.entry_ = groups_.begin();
+  return group;
+}
+
+Common::Redis::Client::PoolRequest*
+ReadCoalescer::sendGroupRequest(Group& group, RespVariant&& request, PoolCallbacks& callbacks,
+                                UpstreamRequest upstream_request) {
+  Waiter& waiter = group.addWaiter(callbacks);
+  group.upstream_request_ = upstream_request(std::move(request), group);
+  if (group.upstream_request_ == nullptr) {
+    // The request could not be made, and no callbacks have been or will be called.
+    ASSERT(group.waiters_.size() == 1);
+    if (group.joinable_) {
+      joinable_groups_.erase(group.signature_);
+    }
+    groups_.erase(group.entry_);
+    return nullptr;
+  }
+  return &waiter;
+}
+
+void ReadCoalescer::onShardRequest(const Common::Redis::RespValue& request) {
+  const std::string command = commandName(request);
+  if (command == "flushall" || command == "flushdb" || command == "select") {
+    invalidateAll();
+  }
+}
+
+void ReadCoalescer::invalidateAll() {
+  for (auto& [signature, group] : joinable_groups_) {
+    group->joinable_ = false;
+    group->cacheable_ = false;
+  }
+  joinable_groups_.clear();
+  stats_.read_cache_invalidated_.add(cache_.size());
+  cache_.clear();
+}
+
+std::string ReadCoalescer::readSignature(const std::string& key,
+                                         const Common::Redis::RespValue& request) {
+  if (request.type() != Common::Redis::RespType::Array || request.asArray().size() < 2) {
+    return "";
+  }
+  const std::vector<Common::Redis::RespValue>& args = request.asArray();
+  for (const auto& arg : args) {
+    if (arg.type() != Common::Redis::RespType::BulkString) {
+      return "";
+    }
+  }
+  const std::string command = commandName(request);
+  if (!Common::Redis::SupportedCommands::coalescableReadCommands().contains(command)) {
+    return "";
+  }
+  // Arguments are length-prefixed so that arguments containing NULs cannot collide.
+  std::string signature = absl::StrCat(keyPrefix(key), command);
+  for (size_t i = 1; i < args.size(); ++i) {
+    const std::string& arg = args[i].asString();
+    absl::StrAppend(&signature, Separator, arg.size(), ":", arg);
+  }
+  return signature;
+}
+
+std::string ReadCoalescer::keyPrefix(const std::string& key) {
+  return absl::StrCat(key, Separator);
+}
+
+Common::Redis::Client::PoolRequest* ReadCoalescer::serveFromCache(const std::string& signature,
+                                                                  PoolCallbacks& callbacks) {
+  auto entry = cache_.find(signature);
+  if (entry == cache_.end()) {
+    return nullptr;
+  }
+  if (entry->second.expiry_ <= dispatcher_.timeSource().monotonicTime()) {
+    cache_.erase(entry);
+    return nullptr;
+  }
+
+  stats_.read_cache_hit_.inc();
+  cached_responses_.push_back(std::make_unique<CachedResponse>(
+      *this, callbacks, std::make_unique<Common::Redis::RespValue>(entry->second.value_)));
+  CachedResponse& response = *cached_responses_.back();
+  response.entry_ = std::prev(cached_responses_.end());
+  deliver_cached_responses_->scheduleCallbackCurrentIteration();
+  return &response;
+}
+
+void ReadCoalescer::insertIntoCache(const std::string& signature,
+                                    const Common::Redis::RespValue& value) {
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  auto entry = cache_.find(signature);
+  if (entry == cache_.end() && cache_.size() >= config_->maxCachedResponses()) {
+    absl::erase_if(cache_, [now](const auto& cached) { return cached.second.expiry_ <= now; });
+    if (cache_.size() >= config_->maxCachedResponses()) {
+      ENVOY_LOG(debug, "read cache is full, not caching response");
+      return;
+    }
+  }
+  cache_.insert_or_assign(signature, CacheEntry{value, now + config_->cacheTtl()});
+}
+
+void ReadCoalescer::invalidate(const std::string& key) {
+  const std::string prefix = keyPrefix(key);
+  for (auto group = joinable_groups_.lower_bound(prefix);
+       group != joinable_groups_.end() && absl::StartsWith(group->first, prefix);) {
+    group->second->joinable_ = false;
+    group->second->cacheable_ = false;
+    group = joinable_groups_.erase(group);
+  }
+  for (auto entry = cache_.lower_bound(prefix);
+       entry != cache_.end() && absl::StartsWith(entry->first, prefix);) {
+    stats_.read_cache_invalidated_.inc();
+    entry = cache_.erase(entry);
+  }
+}
+
+void ReadCoalescer::onGroupComplete(Group& group) {
+  if (group.joinable_) {
+    joinable_groups_.erase(group.signature_);
+    group.joinable_ = false;
+  }
+  if (group.invalidate_all_on_completion_) {
+    group.invalidate_all_on_completion_ = false;
+    invalidateAll();
+  }
+}
+
+void ReadCoalescer::removeGroup(Group& group) {
+  onGroupComplete(group);
+  GroupPtr removed = std::move(*group.entry_);
+  groups_.erase(group.entry_);
+  dispatcher_.deferredDelete(std::move(removed));
+}
+
+void ReadCoalescer::deliverCachedResponses() {
+  while (!cached_responses_.empty()) {
+    CachedResponsePtr response = std::move(cached_responses_.front());
+    cached_responses_.pop_front();
+    response->callbacks_.onResponse(std::move(response->value_));
+  }
+}
+
+void ReadCoalescer::Waiter::cancel() { group_.removeWaiter(*this); }
+
+void ReadCoalescer::CachedResponse::cancel() { parent_.cached_responses_.erase(entry_); }
+
+ReadCoalescer::Waiter& ReadCoalescer::Group::addWaiter(PoolCallbacks& callbacks) {
+  waiters_.push_back(std::make_unique<Waiter>(*this, callbacks));
+  Waiter& waiter = *waiters_.back();
+  waiter.entry_ = std::prev(waiters_.end());
+  return waiter;
+}
+
+void ReadCoalescer::Group::removeWaiter(Waiter& waiter) {
+  waiters_.erase(waiter.entry_);
+  if (!waiters_.empty() || delivering_) {
+    return;
+  }
+  // Nobody is waiting for the response anymore.
+  if (upstream_request_ != nullptr) {
+    upstream_request_->cancel();
+    upstream_request_ = nullptr;
+  }
+  parent_.removeGroup(*this);
+}
+
+void ReadCoalescer::Group::onResponse(Common::Redis::RespValuePtr&& value) {
+  upstream_request_ = nullptr;
+  parent_.onGroupComplete(*this);
+  if (cacheable_ && value->type() != Common::Redis::RespType::Error) {
+    parent_.insertIntoCache(signature_, *value);
+  }
+
+  // Waiters are removed before their callbacks are called, so that a callback may cancel any of
+  // the remaining waiters.
+  delivering_ = true;
+  while (!waiters_.empty()) {
+    WaiterPtr waiter = std::move(waiters_.front());
+    waiters_.pop_front();
+    if (waiters_.empty()) {
+      waiter->callbacks_.onResponse(std::move(value));
+    } else {
+      waiter->callbacks_.onResponse(std::make_unique<Common::Redis::RespValue>(*value));
+    }
+  }
+  parent_.removeGroup(*this);
+}
+
+void ReadCoalescer::Group::onFailure() {
+  upstream_request_ = nullptr;
+  parent_.onGroupComplete(*this);
+
+  delivering_ = true;
+  while (!waiters_.empty()) {
+    WaiterPtr waiter = std::move(waiters_.front());
+    waiters_.pop_front();
+    waiter->callbacks_.onFailure();
+  }
+  parent_.removeGroup(*this);
+}
+
+} // namespace ConnPool
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
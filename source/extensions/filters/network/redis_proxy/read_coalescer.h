@@ -0,0 +1,223 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/filters/network/redis_proxy/v3/redis_proxy.pb.h"
+#include "envoy/server/factory_context.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/common/matchers.h"
+#include "source/extensions/filters/network/common/redis/client.h"
+#include "source/extensions/filters/network/common/redis/codec.h"
+#include "source/extensions/filters/network/redis_proxy/conn_pool.h"
+
+#include "absl/container/btree_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+namespace ConnPool {
+
+/**
+ * All read coalescing stats. @see stats_macros.h
+ */
+#define ALL_READ_COALESCER_STATS(COUNTER)                                                          \
+  COUNTER(read_coalesced)                                                                          \
+  COUNTER(read_cache_hit)                                                                          \
+  COUNTER(read_cache_invalidated)
+
+/**
+ * Struct definition for all read coalescing stats. @see stats_macros.h
+ */
+struct ReadCoalescerStats {
+  ALL_READ_COALESCER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Read coalescing configuration shared by the coalescers of all workers.
+ */
+class ReadCoalescerConfig {
+public:
+  ReadCoalescerConfig(
+      const envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCoalescing&
+          config,
+      Server::Configuration::CommonFactoryContext& context);
+
+  /**
+   * @return whether responses to read commands on the given key may be cached.
+   */
+  bool cacheable(absl::string_view key) const;
+
+  std::chrono::milliseconds cacheTtl() const { return cache_ttl_; }
+  uint32_t maxCachedResponses() const { return max_cached_responses_; }
+
+  static constexpr uint64_t DefaultCacheTtlMs = 1000;
+  static constexpr uint32_t DefaultMaxCachedResponses = 1024;
+
+private:
+  std::vector<Matchers::StringMatcherImpl> cached_keys_;
+  const std::chrono::milliseconds cache_ttl_;
+  const uint32_t max_cached_responses_;
+};
+
+using ReadCoalescerConfigConstSharedPtr = std::shared_ptr<const ReadCoalescerConfig>;
+
+/**
+ * Sends identical read commands that are in flight at the same time upstream once, and delivers
+ * the response to every caller. Responses for keys that the configuration marks as cacheable are
+ * kept for a short time and served without going upstream. Any other command on a key, which is
+ * assumed to be a write, drops the cached responses for the key and keeps the reads in flight on
+ * the key from being joined or cached, so that a client always reads its own writes. Scripts,
+ * commands that may write other keys than the one they are routed by, and transactions, when
+ * they are executed, do so for every key. A coalescer belongs to a single worker and is not
+ * thread safe.
+ */
+class ReadCoalescer : Logger::Loggable<Logger::Id::redis> {
+public:
+  /**
+   * Sends a request upstream, returning a handle to the upstream request or nullptr if the
+   * request could not be made.
+   */
+  using UpstreamRequest = absl::FunctionRef<Common::Redis::Client::PoolRequest*(
+      RespVariant&& request, PoolCallbacks& callbacks)>;
+
+  ReadCoalescer(ReadCoalescerConfigConstSharedPtr config, const ReadCoalescerStats& stats,
+                Event::Dispatcher& dispatcher);
+  ~ReadCoalescer();
+
+  /**
+   * Makes a request through the coalescer.
+   * @param key supplies the key the request is routed by.
+   * @param request supplies the request to make.
+   * @param callbacks supplies the request completion callbacks. Responses served from the cache
+   *        are delivered on a later iteration of the event loop, never from within this call.
+   * @param in_transaction whether the request is part of a transaction, in which case it is never
+   *        coalesced or served from the cache, and only its EXEC invalidates cached responses.
+   * @param upstream_request sends the request upstream if it is not served by the coalescer.
+   * @return PoolRequest* a handle to the request or nullptr if the request could not be made.
+   */
+  Common::Redis::Client::PoolRequest* makeRequest(const std::string& key, RespVariant&& request,
+                                                  PoolCallbacks& callbacks, bool in_transaction,
+                                                  UpstreamRequest upstream_request);
+
+  /**
+   * Called for requests that are sent to a shard rather than for a key. Commands that may change
+   * any key, such as FLUSHALL, drop every cached response and keep every read in flight from
+   * being joined or cached.
+   * @param request supplies the request.
+   */
+  void onShardRequest(const Common::Redis::RespValue& request);
+
+private:
+  class Group;
+  using GroupPtr = std::unique_ptr<Group>;
+
+  // A caller waiting for the response of a group.
+  struct Waiter : public Common::Redis::Client::PoolRequest {
+    Waiter(Group& group, PoolCallbacks& callbacks) : group_(group), callbacks_(callbacks) {}
+
+    // Common::Redis::Client::PoolRequest
+    void cancel() override;
+
+    Group& group_;
+    PoolCallbacks& callbacks_;
+    std::list<std::unique_ptr<Waiter>>::iterator entry_;
+  };
+
+  using WaiterPtr = std::unique_ptr<Waiter>;
+
+  // One request in flight upstream, and the callers waiting for its response.
+  class Group : public PoolCallbacks, public Event::DeferredDeletable {
+  public:
+    Group(ReadCoalescer& parent, std::string signature, bool cacheable)
+        : parent_(parent), signature_(std::move(signature)), cacheable_(cacheable) {}
+
+    Waiter& addWaiter(PoolCallbacks& callbacks);
+    void removeWaiter(Waiter& waiter);
+
+    // PoolCallbacks
+    void onResponse(Common::Redis::RespValuePtr&& value) override;
+    void onFailure() override;
+
+    ReadCoalescer& parent_;
+    const std::string signature_;
+    std::list<WaiterPtr> waiters_;
+    std::list<GroupPtr>::iterator entry_;
+    Common::Redis::Client::PoolRequest* upstream_request_{};
+    bool cacheable_;
+    bool joinable_{true};
+    bool delivering_{false};
+    // Whether every key is invalidated once the request completes or is cancelled.
+    bool invalidate_all_on_completion_{false};
+  };
+
+  // A response served from the cache, waiting to be delivered.
+  struct CachedResponse : public Common::Redis::Client::PoolRequest {
+    CachedResponse(ReadCoalescer& parent, PoolCallbacks& callbacks,
+                   Common::Redis::RespValuePtr&& value)
+        : parent_(parent), callbacks_(callbacks), value_(std::move(value)) {}
+
+    // Common::Redis::Client::PoolRequest
+    void cancel() override;
+
+    ReadCoalescer& parent_;
+    PoolCallbacks& callbacks_;
+    Common::Redis::RespValuePtr value_;
+    std::list<std::unique_ptr<CachedResponse>>::iterator entry_;
+  };
+
+  using CachedResponsePtr = std::unique_ptr<CachedResponse>;
+
+  struct CacheEntry {
+    Common::Redis::RespValue value_;
+    MonotonicTime expiry_;
+  };
+
+  // Returns the signature of a coalescable read command on the given key, or an empty string if
+  // the request may not be coalesced. Signatures start with the key followed by a NUL, so that
+  // the entries of a key are adjacent in the maps below.
+  static std::string readSignature(const std::string& key, const Common::Redis::RespValue& request);
+  static std::string keyPrefix(const std::string& key);
+
+  Group& addGroup(std::string signature, bool cacheable);
+  Common::Redis::Client::PoolRequest* sendGroupRequest(Group& group, RespVariant&& request,
+                                                       PoolCallbacks& callbacks,
+                                                       UpstreamRequest upstream_request);
+  Common::Redis::Client::PoolRequest* serveFromCache(const std::string& signature,
+                                                     PoolCallbacks& callbacks);
+  void insertIntoCache(const std::string& signature, const Common::Redis::RespValue& value);
+  void invalidate(const std::string& key);
+  void invalidateAll();
+  void onGroupComplete(Group& group);
+  void removeGroup(Group& group);
+  void deliverCachedResponses();
+
+  const ReadCoalescerConfigConstSharedPtr config_;
+  ReadCoalescerStats stats_;
+  Event::Dispatcher& dispatcher_;
+  std::list<GroupPtr> groups_;
+  absl::btree_map<std::string, Group*> joinable_groups_;
+  absl::btree_map<std::string, CacheEntry> cache_;
+  std::list<CachedResponsePtr> cached_responses_;
+  Event::SchedulableCallbackPtr deliver_cached_responses_;
+};
+
+using ReadCoalescerPtr = std::unique_ptr<ReadCoalescer>;
+
+} // namespace ConnPool
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -6,6 +6,7 @@
 
 #include "source/extensions/filters/network/thrift_proxy/router/router_impl.h"
 #include "source/extensions/filters/network/thrift_proxy/router/shadow_writer_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/router/upstream_multiplexer.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -25,12 +26,18 @@ ThriftFilters::FilterFactoryCb RouterFilterConfig::createFilterFactoryFromProtoT
                                                           server_context.threadLocal());
   bool close_downstream_on_error =
       PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, close_downstream_on_upstream_error, true);
-
-  return [&context, stats, shadow_writer, close_downstream_on_error](
-             ThriftFilters::FilterChainFactoryCallbacks& callbacks) -> void {
+  UpstreamMultiplexerSharedPtr upstream_multiplexer;
+  if (proto_config.has_upstream_multiplexing()) {
+    upstream_multiplexer = std::make_shared<UpstreamMultiplexer>(
+        proto_config.upstream_multiplexing(), stats, server_context.threadLocal());
+  }
+
+  return [&context, stats, shadow_writer, close_downstream_on_error,
+          upstream_multiplexer](ThriftFilters::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addDecoderFilter(std::make_shared<Router>(
         context.serverFactoryContext().clusterManager(), *stats,
-        context.serverFactoryContext().runtime(), *shadow_writer, close_downstream_on_error));
+        context.serverFactoryContext().runtime(), *shadow_writer, close_downstream_on_error,
+        makeOptRefFromPtr(upstream_multiplexer.get())));
   };
 }
 
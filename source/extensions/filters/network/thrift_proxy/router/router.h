@@ -107,7 +107,12 @@ using ConfigConstSharedPtr = std::shared_ptr<const Config>;
   COUNTER(unknown_cluster)                                                                         \
   COUNTER(upstream_rq_maintenance_mode)                                                            \
   COUNTER(no_healthy_upstream)                                                                     \
-  COUNTER(shadow_request_submit_failure)
+  COUNTER(shadow_request_submit_failure)                                                           \
+  COUNTER(upstream_rq_multiplexed)                                                                 \
+  COUNTER(upstream_resp_multiplexed_unmatched)                                                     \
+  COUNTER(upstream_rq_multiplexed_timeout)                                                         \
+  GAUGE(upstream_cx_multiplexed_active, Accumulate)                                                \
+  GAUGE(upstream_rq_multiplexed_active, Accumulate)
 
 /**
  * Struct containing named stats for the router.
@@ -330,9 +330,15 @@ FilterStatus Router::messageBegin(MessageMetadataSharedPtr metadata) {
     }
   }
 
+  OptRef<MultiplexedConnPool> multiplexed_conn_pool;
+  if (upstream_multiplexer_.has_value() &&
+      MultiplexedConnPool::supported(upstream_req_info.transport, upstream_req_info.protocol)) {
+    multiplexed_conn_pool = upstream_multiplexer_->connPool();
+  }
+
   upstream_request_ = std::make_unique<UpstreamRequest>(
       *this, *upstream_req_info.conn_pool_data, metadata, upstream_req_info.transport,
-      upstream_req_info.protocol, close_downstream_on_error_);
+      upstream_req_info.protocol, close_downstream_on_error_, multiplexed_conn_pool);
   return upstream_request_->start();
 }
 
@@ -17,6 +17,7 @@
 #include "source/extensions/filters/network/thrift_proxy/filters/filter.h"
 #include "source/extensions/filters/network/thrift_proxy/router/router.h"
 #include "source/extensions/filters/network/thrift_proxy/router/router_ratelimit_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/router/upstream_multiplexer.h"
 #include "source/extensions/filters/network/thrift_proxy/router/upstream_request.h"
 #include "source/extensions/filters/network/thrift_proxy/thrift_object.h"
 
@@ -229,9 +230,11 @@ class Router : public Tcp::ConnectionPool::UpstreamCallbacks,
                public ThriftFilters::DecoderFilter {
 public:
   Router(Upstream::ClusterManager& cluster_manager, const RouterStats& stats,
-         Runtime::Loader& runtime, ShadowWriter& shadow_writer, bool close_downstream_on_error)
+         Runtime::Loader& runtime, ShadowWriter& shadow_writer, bool close_downstream_on_error,
+         OptRef<UpstreamMultiplexer> upstream_multiplexer)
       : RequestOwner(cluster_manager, stats), runtime_(runtime), shadow_writer_(shadow_writer),
-        close_downstream_on_error_(close_downstream_on_error) {}
+        close_downstream_on_error_(close_downstream_on_error),
+        upstream_multiplexer_(upstream_multiplexer) {}
 
   ~Router() override = default;
 
@@ -335,6 +338,7 @@ private:
   std::vector<std::reference_wrapper<ShadowRouterHandle>> shadow_routers_;
 
   bool close_downstream_on_error_;
+  OptRef<UpstreamMultiplexer> upstream_multiplexer_;
 };
 
 } // namespace Router
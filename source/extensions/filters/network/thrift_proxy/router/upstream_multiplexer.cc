@@ -0,0 +1,476 @@
+#include "source/extensions/filters/network/thrift_proxy/router/upstream_multiplexer.h"
+
+#include <limits>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/network/thrift_proxy/framed_transport_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/header_transport_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+
+namespace {
+
+// Size of the frame length that prefixes framed and header transport frames.
+constexpr uint64_t FrameSizeLength = 4;
+
+// Number of bytes of a response frame that are copied to find its sequence id, which covers the
+// transport header and message begin of nearly all responses.
+constexpr uint64_t SequenceIdPeekLength = 512;
+
+int32_t maxFrameSize(TransportType transport) {
+  if (transport == TransportType::Header) {
+    return HeaderTransportImpl::MaxFrameSize;
+  }
+  return FramedTransportImpl::MaxFrameSize;
+}
+
+} // namespace
+
+MultiplexedConnPool::MultiplexedConnPool(std::shared_ptr<const RouterStats> stats,
+                                         uint32_t max_requests_per_connection,
+                                         std::chrono::milliseconds response_timeout,
+                                         Event::Dispatcher& dispatcher)
+    : stats_(std::move(stats)), max_requests_per_connection_(max_requests_per_connection),
+      response_timeout_(response_timeout), dispatcher_(dispatcher) {}
+
+MultiplexedConnPool::~MultiplexedConnPool() {
+  // Requests that are still waiting for a connection or outstanding on one are failed as if their
+  // connection was closed. Their owners may give up other requests while being notified, so the
+  // groups are looked up again after every notification.
+  while (!groups_.empty()) {
+    ConnectionGroup& group = *groups_.begin()->second;
+    if (!group.pending_.empty()) {
+      group.pending_.front()->cancel();
+    } else {
+      group.ready_.front()->close();
+    }
+  }
+}
+
+bool MultiplexedConnPool::supported(TransportType transport, ProtocolType protocol) {
+  // Twitter protocol connections are upgraded, and belong to a single request until then.
+  return (transport == TransportType::Framed || transport == TransportType::Header) &&
+         protocol != ProtocolType::Twitter;
+}
+
+Tcp::ConnectionPool::Cancellable*
+MultiplexedConnPool::newStream(Upstream::TcpPoolData& pool_data, TransportType transport,
+                               ProtocolType protocol, MultiplexedStreamCallbacks& callbacks) {
+  ASSERT(supported(transport, protocol));
+  Upstream::HostDescriptionConstSharedPtr host = pool_data.host();
+  const GroupKey key{host.get(), transport, protocol};
+  auto it = groups_.find(key);
+  if (it == groups_.end()) {
+    it = groups_.emplace(key, std::make_unique<ConnectionGroup>(host, transport, protocol)).first;
+  }
+  ConnectionGroup& group = *it->second;
+
+  for (auto& connection : group.ready_) {
+    if (connection->hasCapacity()) {
+      callbacks.onStreamReady(connection->newStream(callbacks), host);
+      return nullptr;
+    }
+  }
+
+  for (auto& pending : group.pending_) {
+    if (pending->waiters_.size() < max_requests_per_connection_) {
+      return &pending->addWaiter(callbacks);
+    }
+  }
+
+  auto pending = std::make_unique<PendingConnection>(*this, group);
+  PendingStream& waiter = pending->addWaiter(callbacks);
+  PendingConnection& pending_connection = *pending;
+  LinkedList::moveIntoListBack(std::move(pending), group.pending_);
+
+  // The TCP connection pool may invoke the callbacks, and so the waiter's, before returning.
+  Tcp::ConnectionPool::Cancellable* handle = pool_data.newConnection(pending_connection);
+  if (handle == nullptr) {
+    return nullptr;
+  }
+  pending_connection.handle_ = handle;
+  return &waiter;
+}
+
+void MultiplexedConnPool::maybeRemoveGroup(ConnectionGroup& group) {
+  if (group.ready_.empty() && group.pending_.empty()) {
+    groups_.erase(group.key());
+  }
+}
+
+MultiplexedConnPool::ActiveStream::~ActiveStream() {
+  if (connection_ != nullptr) {
+    connection_->onStreamDestroyed(*this);
+  }
+}
+
+void MultiplexedConnPool::ActiveStream::write(Buffer::Instance& data, bool expect_response) {
+  if (connection_ == nullptr) {
+    data.drain(data.length());
+    return;
+  }
+  awaiting_response_ = expect_response;
+  if (expect_response) {
+    connection_->armResponseTimer(sequence_id_);
+  }
+  connection_->write(data);
+}
+
+void MultiplexedConnPool::ActiveStream::drainConnection() {
+  if (connection_ != nullptr) {
+    connection_->drain();
+  }
+}
+
+MultiplexedConnPool::ActiveConnection::ActiveConnection(
+    MultiplexedConnPool& parent, ConnectionGroup& group,
+    Tcp::ConnectionPool::ConnectionDataPtr&& conn_data)
+    : parent_(parent), group_(group), conn_data_(std::move(conn_data)),
+      transport_(NamedTransportConfigFactory::getFactory(group.transport_).createTransport()),
+      protocol_(NamedProtocolConfigFactory::getFactory(group.protocol_).createProtocol()) {
+  conn_data_->addUpstreamCallbacks(*this);
+  parent_.stats_->routerStats().upstream_cx_multiplexed_active_.inc();
+}
+
+MultiplexedConnPool::ActiveConnection::~ActiveConnection() { ASSERT(streams_.empty()); }
+
+bool MultiplexedConnPool::ActiveConnection::hasCapacity() const {
+  return !draining_ && conn_data_ != nullptr &&
+         streams_.size() < parent_.max_requests_per_connection_;
+}
+
+MultiplexedStreamPtr
+MultiplexedConnPool::ActiveConnection::newStream(MultiplexedStreamCallbacks& owner) {
+  ASSERT(hasCapacity());
+  // Skip the sequence ids of requests that are still outstanding.
+  int32_t sequence_id;
+  do {
+    sequence_id = next_sequence_id_;
+    next_sequence_id_ =
+        next_sequence_id_ == std::numeric_limits<int32_t>::max() ? 0 : next_sequence_id_ + 1;
+  } while (streams_.contains(sequence_id));
+
+  auto stream = std::make_unique<ActiveStream>(*this, sequence_id, owner);
+  streams_.emplace(sequence_id, OutstandingRequest{stream.get(), nullptr});
+  parent_.stats_->routerStats().upstream_rq_multiplexed_.inc();
+  parent_.stats_->routerStats().upstream_rq_multiplexed_active_.inc();
+  return stream;
+}
+
+void MultiplexedConnPool::ActiveConnection::write(Buffer::Instance& data) {
+  ASSERT(conn_data_ != nullptr);
+  conn_data_->connection().write(data, false);
+}
+
+void MultiplexedConnPool::ActiveConnection::armResponseTimer(int32_t sequence_id) {
+  auto it = streams_.find(sequence_id);
+  ASSERT(it != streams_.end());
+  it->second.response_timer_ =
+      parent_.dispatcher_.createTimer([this, sequence_id]() { onResponseTimeout(sequence_id); });
+  it->second.response_timer_->enableTimer(parent_.response_timeout_);
+}
+
+void MultiplexedConnPool::ActiveConnection::onResponseTimeout(int32_t sequence_id) {
+  auto it = streams_.find(sequence_id);
+  ASSERT(it != streams_.end());
+  ENVOY_LOG(debug, "multiplexed upstream request with sequence id {} timed out", sequence_id);
+  // The timer is destroyed once its callback is done. Sequence ids are handed out in increasing
+  // order, so a late response is counted as unmatched rather than routed to another request.
+  const Event::TimerPtr timer = std::move(it->second.response_timer_);
+  ActiveStream* stream = it->second.stream_;
+  streams_.erase(it);
+  parent_.stats_->routerStats().upstream_rq_multiplexed_timeout_.inc();
+  parent_.stats_->routerStats().upstream_rq_multiplexed_active_.dec();
+
+  MultiplexedStreamCallbacks* owner = nullptr;
+  if (stream != nullptr) {
+    stream->connection_ = nullptr;
+    stream->awaiting_response_ = false;
+    owner = &stream->owner_;
+  }
+  maybeRelease();
+  if (owner != nullptr) {
+    owner->onStreamTimeout();
+  }
+}
+
+void MultiplexedConnPool::ActiveConnection::onStreamDestroyed(ActiveStream& stream) {
+  auto it = streams_.find(stream.sequence_id_);
+  ASSERT(it != streams_.end() && it->second.stream_ == &stream);
+  if (stream.awaiting_response_) {
+    // The response is discarded when it arrives or times out. Until then, the sequence id may not
+    // be reused and the connection may not be handed back to the TCP connection pool.
+    it->second.stream_ = nullptr;
+    return;
+  }
+  streams_.erase(it);
+  parent_.stats_->routerStats().upstream_rq_multiplexed_active_.dec();
+  maybeRelease();
+}
+
+void MultiplexedConnPool::ActiveConnection::drain() {
+  draining_ = true;
+  maybeRelease();
+}
+
+void MultiplexedConnPool::ActiveConnection::maybeRelease() {
+  if (!streams_.empty() || conn_data_ == nullptr) {
+    return;
+  }
+
+  Tcp::ConnectionPool::ConnectionDataPtr conn_data = std::move(conn_data_);
+  detach();
+  if (draining_) {
+    ENVOY_LOG(debug, "closing drained multiplexed upstream connection");
+    conn_data->connection().close(Network::ConnectionCloseType::NoFlush);
+  }
+  // Destroying the connection data hands the connection back to the TCP connection pool.
+}
+
+void MultiplexedConnPool::ActiveConnection::detach() {
+  parent_.stats_->routerStats().upstream_cx_multiplexed_active_.dec();
+  ConnectionGroup& group = group_;
+  parent_.dispatcher_.deferredDelete(removeFromList(group.ready_));
+  parent_.maybeRemoveGroup(group);
+}
+
+void MultiplexedConnPool::ActiveConnection::onUpstreamData(Buffer::Instance& data, bool) {
+  // A close is reported separately through onEvent().
+  response_buffer_.move(data);
+  while (conn_data_ != nullptr && response_buffer_.length() >= FrameSizeLength) {
+    const int32_t frame_size = response_buffer_.peekBEInt<int32_t>();
+    if (frame_size <= 0 || frame_size > maxFrameSize(group_.transport_)) {
+      ENVOY_LOG(debug, "invalid multiplexed upstream response frame size {}", frame_size);
+      close();
+      return;
+    }
+    if (response_buffer_.length() < FrameSizeLength + frame_size) {
+      return;
+    }
+
+    Buffer::OwnedImpl frame;
+    frame.move(response_buffer_, FrameSizeLength + frame_size);
+    dispatchFrame(frame);
+  }
+}
+
+std::optional<int32_t>
+MultiplexedConnPool::ActiveConnection::sequenceId(const Buffer::Instance& frame) {
+  // The start of the frame is decoded from a copy, so that the frame is passed on as received.
+  uint64_t length = std::min(frame.length(), SequenceIdPeekLength);
+  while (true) {
+    Buffer::OwnedImpl copy;
+    if (length == frame.length()) {
+      copy.add(frame);
+    } else {
+      std::string prefix(length, '\0');
+      frame.copyOut(0, length, prefix.data());
+      copy.add(prefix);
+    }
+
+    MessageMetadata metadata;
+    TRY_NEEDS_AUDIT {
+      if (transport_->decodeFrameStart(copy, metadata) &&
+          protocol_->readMessageBegin(copy, metadata)) {
+        return metadata.sequenceId();
+      }
+    }
+    END_TRY catch (const EnvoyException& e) {
+      ENVOY_LOG(debug, "cannot decode multiplexed upstream response: {}", e.what());
+      return std::nullopt;
+    }
+
+    if (length == frame.length()) {
+      return std::nullopt;
+    }
+    length = frame.length();
+  }
+}
+
+void MultiplexedConnPool::ActiveConnection::dispatchFrame(Buffer::Instance& frame) {
+  const std::optional<int32_t> sequence_id = sequenceId(frame);
+  if (!sequence_id.has_value()) {
+    // Frames are delimited by their length, but a response that cannot be routed to its request
+    // leaves that request waiting forever.
+    close();
+    return;
+  }
+
+  auto it = streams_.find(sequence_id.value());
+  if (it == streams_.end()) {
+    ENVOY_LOG(debug, "multiplexed upstream response with unknown sequence id {}",
+              sequence_id.value());
+    parent_.stats_->routerStats().upstream_resp_multiplexed_unmatched_.inc();
+    return;
+  }
+
+  ActiveStream* stream = it->second.stream_;
+  if (stream == nullptr) {
+    // The request was given up while awaiting this response.
+    streams_.erase(it);
+    parent_.stats_->routerStats().upstream_rq_multiplexed_active_.dec();
+    maybeRelease();
+    return;
+  }
+
+  // The stream is usually destroyed by its owner once it has the response.
+  ASSERT(stream->callbacks_ != nullptr);
+  it->second.response_timer_.reset();
+  stream->awaiting_response_ = false;
+  stream->callbacks_->onUpstreamData(frame, false);
+}
+
+void MultiplexedConnPool::ActiveConnection::onEvent(Network::ConnectionEvent event) {
+  switch (event) {
+  case Network::ConnectionEvent::RemoteClose:
+  case Network::ConnectionEvent::LocalClose:
+    // Closes initiated by close() are also reported here, after conn_data_ has been cleared.
+    if (conn_data_ != nullptr) {
+      onClose(event, false);
+    }
+    break;
+  case Network::ConnectionEvent::Connected:
+  case Network::ConnectionEvent::ConnectedZeroRtt:
+    // Connected is consumed by the connection pool.
+    IS_ENVOY_BUG("reached unexpectedly");
+  }
+}
+
+void MultiplexedConnPool::ActiveConnection::close() {
+  onClose(Network::ConnectionEvent::LocalClose, true);
+}
+
+void MultiplexedConnPool::ActiveConnection::onClose(Network::ConnectionEvent event,
+                                                     bool close_connection) {
+  ASSERT(conn_data_ != nullptr);
+  Tcp::ConnectionPool::ConnectionDataPtr conn_data = std::move(conn_data_);
+  detach();
+  if (close_connection) {
+    conn_data->connection().close(Network::ConnectionCloseType::NoFlush);
+  }
+  conn_data.reset();
+
+  // Every request outstanding on the connection sees the close. Owners may destroy other streams
+  // while being notified, so the streams are detached one at a time.
+  while (!streams_.empty()) {
+    auto it = streams_.begin();
+    ActiveStream* stream = it->second.stream_;
+    streams_.erase(it);
+    parent_.stats_->routerStats().upstream_rq_multiplexed_active_.dec();
+    if (stream != nullptr) {
+      stream->connection_ = nullptr;
+      if (stream->callbacks_ != nullptr) {
+        stream->callbacks_->onEvent(event);
+      }
+    }
+  }
+}
+
+void MultiplexedConnPool::PendingStream::cancel(Tcp::ConnectionPool::CancelPolicy) {
+  parent_.removeWaiter(*this);
+}
+
+MultiplexedConnPool::PendingStream&
+MultiplexedConnPool::PendingConnection::addWaiter(MultiplexedStreamCallbacks& callbacks) {
+  waiters_.push_back(std::make_unique<PendingStream>(*this, callbacks));
+  PendingStream& waiter = *waiters_.back();
+  waiter.entry_ = std::prev(waiters_.end());
+  return waiter;
+}
+
+void MultiplexedConnPool::PendingConnection::removeWaiter(PendingStream& waiter) {
+  waiters_.erase(waiter.entry_);
+  if (waiters_.empty() && !completed_) {
+    // Nobody is waiting for the connection anymore. The TCP connection pool keeps it if it is
+    // established.
+    cancel();
+  }
+}
+
+void MultiplexedConnPool::PendingConnection::cancel() {
+  ASSERT(!completed_);
+  completed_ = true;
+  if (handle_ != nullptr) {
+    handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+    handle_ = nullptr;
+  }
+  MultiplexedConnPool& parent = parent_;
+  ConnectionGroup& group = group_;
+  parent.dispatcher_.deferredDelete(removeFromList(group.pending_));
+  parent.maybeRemoveGroup(group);
+
+  while (!waiters_.empty()) {
+    PendingStreamPtr waiter = std::move(waiters_.front());
+    waiters_.pop_front();
+    waiter->callbacks_.onStreamFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                                       "", nullptr);
+  }
+}
+
+void MultiplexedConnPool::PendingConnection::onPoolFailure(
+    ConnectionPool::PoolFailureReason reason, absl::string_view transport_failure_reason,
+    Upstream::HostDescriptionConstSharedPtr host) {
+  completed_ = true;
+  handle_ = nullptr;
+  MultiplexedConnPool& parent = parent_;
+  ConnectionGroup& group = group_;
+  parent.dispatcher_.deferredDelete(removeFromList(group.pending_));
+  parent.maybeRemoveGroup(group);
+
+  // Waiters may cancel other waiters while being notified.
+  while (!waiters_.empty()) {
+    PendingStreamPtr waiter = std::move(waiters_.front());
+    waiters_.pop_front();
+    waiter->callbacks_.onStreamFailure(reason, transport_failure_reason, host);
+  }
+}
+
+void MultiplexedConnPool::PendingConnection::onPoolReady(
+    Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+    Upstream::HostDescriptionConstSharedPtr host) {
+  completed_ = true;
+  handle_ = nullptr;
+  auto connection = std::make_unique<ActiveConnection>(parent_, group_, std::move(conn_data));
+  ActiveConnection& active_connection = *connection;
+  LinkedList::moveIntoList(std::move(connection), group_.ready_);
+  parent_.dispatcher_.deferredDelete(removeFromList(group_.pending_));
+
+  // Every waiter gets its share before any is notified, so that the connection is not handed
+  // back to the TCP connection pool while waiters remain.
+  for (auto& waiter : waiters_) {
+    waiter->stream_ = active_connection.newStream(waiter->callbacks_);
+  }
+  while (!waiters_.empty()) {
+    PendingStreamPtr waiter = std::move(waiters_.front());
+    waiters_.pop_front();
+    waiter->callbacks_.onStreamReady(std::move(waiter->stream_), host);
+  }
+}
+
+UpstreamMultiplexer::UpstreamMultiplexer(
+    const envoy::extensions::filters::network::thrift_proxy::router::v3::Router::
+        UpstreamMultiplexing& config,
+    std::shared_ptr<const RouterStats> stats, ThreadLocal::SlotAllocator& tls)
+    : tls_(tls) {
+  const uint32_t max_requests_per_connection = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, max_concurrent_requests_per_connection, DefaultMaxConcurrentRequestsPerConnection);
+  const std::chrono::milliseconds response_timeout(
+      PROTOBUF_GET_MS_OR_DEFAULT(config, response_timeout, DefaultResponseTimeoutMs));
+  tls_.set([stats, max_requests_per_connection, response_timeout](Event::Dispatcher& dispatcher) {
+    return std::make_shared<MultiplexedConnPool>(stats, max_requests_per_connection,
+                                                 response_timeout, dispatcher);
+  });
+}
+
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <tuple>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/filters/network/thrift_proxy/router/v3/router.pb.h"
+#include "envoy/tcp/conn_pool.h"
+#include "envoy/thread_local/thread_local.h"
+#include "envoy/upstream/thread_local_cluster.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/linked_object.h"
+#include "source/common/common/logger.h"
+#include "source/extensions/filters/network/thrift_proxy/protocol.h"
+#include "source/extensions/filters/network/thrift_proxy/router/router.h"
+#include "source/extensions/filters/network/thrift_proxy/transport.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+
+/**
+ * A request's share of an upstream connection that is shared with other requests. Destroying the
+ * stream gives up the share. If the response to the request is still outstanding, it is discarded
+ * when it arrives.
+ */
+class MultiplexedStream {
+public:
+  virtual ~MultiplexedStream() = default;
+
+  /**
+   * @return int32_t the sequence id to send the request with. It is unique among the requests
+   *         outstanding on the upstream connection.
+   */
+  virtual int32_t sequenceId() const PURE;
+
+  /**
+   * Sets the callbacks that receive the response frame with the stream's sequence id, and the
+   * events of the upstream connection while the stream exists. The response frame is delivered
+   * in full, with end_stream set to false.
+   * @param callbacks supplies the callbacks.
+   */
+  virtual void addUpstreamCallbacks(Tcp::ConnectionPool::UpstreamCallbacks& callbacks) PURE;
+
+  /**
+   * Writes an encoded request frame to the upstream connection.
+   * @param data supplies the frame, which is drained.
+   * @param expect_response whether the upstream replies to the request. If so, the stream is
+   *        failed through MultiplexedStreamCallbacks::onStreamTimeout() if the response does not
+   *        arrive within the response timeout.
+   */
+  virtual void write(Buffer::Instance& data, bool expect_response) PURE;
+
+  /**
+   * Stops sending requests over the upstream connection, and closes it once the requests that are
+   * outstanding on it are complete.
+   */
+  virtual void drainConnection() PURE;
+};
+
+using MultiplexedStreamPtr = std::unique_ptr<MultiplexedStream>;
+
+/**
+ * Callbacks for a request waiting for a share of an upstream connection.
+ */
+class MultiplexedStreamCallbacks {
+public:
+  virtual ~MultiplexedStreamCallbacks() = default;
+
+  /**
+   * Called when no upstream connection could be established for the request.
+   * @param reason supplies the failure reason.
+   * @param transport_failure_reason supplies the details of a transport failure.
+   * @param host supplies the description of the host that caused the failure. This may be nullptr
+   *        if no host was involved in the failure.
+   */
+  virtual void onStreamFailure(ConnectionPool::PoolFailureReason reason,
+                               absl::string_view transport_failure_reason,
+                               Upstream::HostDescriptionConstSharedPtr host) PURE;
+
+  /**
+   * Called when the request may be sent.
+   * @param stream supplies the request's share of the upstream connection.
+   * @param host supplies the description of the host the connection is to.
+   */
+  virtual void onStreamReady(MultiplexedStreamPtr&& stream,
+                             Upstream::HostDescriptionConstSharedPtr host) PURE;
+
+  /**
+   * Called when the response to the request sent over the stream did not arrive within the
+   * response timeout. The stream no longer refers to the upstream connection, and its sequence id
+   * may be given to another request.
+   */
+  virtual void onStreamTimeout() PURE;
+};
+
+/**
+ * Per-worker pool of upstream connections that are shared by concurrent requests. Connections
+ * are taken from the cluster's TCP connection pool, and only used for requests with the same
+ * transport and protocol. A connection is handed back to the TCP connection pool once no requests
+ * are outstanding on it. Response frames are routed to their requests by sequence id, which
+ * requires a transport that prefixes every frame with its length.
+ */
+class MultiplexedConnPool : public ThreadLocal::ThreadLocalObject,
+                            Logger::Loggable<Logger::Id::thrift> {
+public:
+  MultiplexedConnPool(std::shared_ptr<const RouterStats> stats,
+                      uint32_t max_requests_per_connection,
+                      std::chrono::milliseconds response_timeout, Event::Dispatcher& dispatcher);
+  ~MultiplexedConnPool() override;
+
+  /**
+   * Requests a share of a connection to the host of the given TCP connection pool.
+   * @param pool_data supplies the TCP connection pool of the host.
+   * @param transport supplies the transport of the request. It must be framed or header.
+   * @param protocol supplies the protocol of the request.
+   * @param callbacks supplies the callbacks to invoke when a share is ready or cannot be had.
+   * @return a handle to cancel the request, or nullptr if the callbacks have already been invoked.
+   */
+  Tcp::ConnectionPool::Cancellable* newStream(Upstream::TcpPoolData& pool_data,
+                                              TransportType transport, ProtocolType protocol,
+                                              MultiplexedStreamCallbacks& callbacks);
+
+  /**
+   * @return whether requests with the given transport and protocol may share connections.
+   */
+  static bool supported(TransportType transport, ProtocolType protocol);
+
+private:
+  struct ConnectionGroup;
+  class ActiveConnection;
+  class PendingConnection;
+
+  using ActiveConnectionPtr = std::unique_ptr<ActiveConnection>;
+  using PendingConnectionPtr = std::unique_ptr<PendingConnection>;
+  using GroupKey = std::tuple<const Upstream::HostDescription*, TransportType, ProtocolType>;
+
+  class ActiveStream : public MultiplexedStream {
+  public:
+    ActiveStream(ActiveConnection& connection, int32_t sequence_id,
+                 MultiplexedStreamCallbacks& owner)
+        : connection_(&connection), sequence_id_(sequence_id), owner_(owner) {}
+    ~ActiveStream() override;
+
+    // MultiplexedStream
+    int32_t sequenceId() const override { return sequence_id_; }
+    void addUpstreamCallbacks(Tcp::ConnectionPool::UpstreamCallbacks& callbacks) override {
+      callbacks_ = &callbacks;
+    }
+    void write(Buffer::Instance& data, bool expect_response) override;
+    void drainConnection() override;
+
+    // Set to nullptr once the stream has been detached from its connection.
+    ActiveConnection* connection_;
+    const int32_t sequence_id_;
+    MultiplexedStreamCallbacks& owner_;
+    Tcp::ConnectionPool::UpstreamCallbacks* callbacks_{};
+    bool awaiting_response_{};
+  };
+
+  // An upstream connection and the requests outstanding on it.
+  class ActiveConnection : public Tcp::ConnectionPool::UpstreamCallbacks,
+                           public Event::DeferredDeletable,
+                           public LinkedObject<ActiveConnection> {
+  public:
+    ActiveConnection(MultiplexedConnPool& parent, ConnectionGroup& group,
+                     Tcp::ConnectionPool::ConnectionDataPtr&& conn_data);
+    ~ActiveConnection() override;
+
+    bool hasCapacity() const;
+    MultiplexedStreamPtr newStream(MultiplexedStreamCallbacks& owner);
+    void write(Buffer::Instance& data);
+    void armResponseTimer(int32_t sequence_id);
+    void onStreamDestroyed(ActiveStream& stream);
+    void drain();
+    void close();
+
+    // Tcp::ConnectionPool::UpstreamCallbacks
+    void onUpstreamData(Buffer::Instance& data, bool end_stream) override;
+    void onEvent(Network::ConnectionEvent event) override;
+    void onAboveWriteBufferHighWatermark() override {}
+    void onBelowWriteBufferLowWatermark() override {}
+
+  private:
+    // A request outstanding on the connection.
+    struct OutstandingRequest {
+      // Set to nullptr once the request was given up while awaiting its response.
+      ActiveStream* stream_;
+      // Armed while the response is awaited.
+      Event::TimerPtr response_timer_;
+    };
+
+    // Returns the sequence id of a response frame, or std::nullopt if it cannot be decoded.
+    std::optional<int32_t> sequenceId(const Buffer::Instance& frame);
+    void dispatchFrame(Buffer::Instance& frame);
+    void onResponseTimeout(int32_t sequence_id);
+    void onClose(Network::ConnectionEvent event, bool close_connection);
+    void maybeRelease();
+    void detach();
+
+    MultiplexedConnPool& parent_;
+    ConnectionGroup& group_;
+    Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+    TransportPtr transport_;
+    ProtocolPtr protocol_;
+    Buffer::OwnedImpl response_buffer_;
+    // The requests outstanding on the connection, by sequence id. Requests that were given up
+    // while awaiting their response are kept until the response arrives or times out.
+    absl::flat_hash_map<int32_t, OutstandingRequest> streams_;
+    int32_t next_sequence_id_{};
+    bool draining_{};
+  };
+
+  // A request waiting for a connection to be established.
+  class PendingStream : public Tcp::ConnectionPool::Cancellable {
+  public:
+    PendingStream(PendingConnection& parent, MultiplexedStreamCallbacks& callbacks)
+        : parent_(parent), callbacks_(callbacks) {}
+
+    // Tcp::ConnectionPool::Cancellable
+    void cancel(Tcp::ConnectionPool::CancelPolicy cancel_policy) override;
+
+    PendingConnection& parent_;
+    MultiplexedStreamCallbacks& callbacks_;
+    MultiplexedStreamPtr stream_;
+    std::list<std::unique_ptr<PendingStream>>::iterator entry_;
+  };
+
+  using PendingStreamPtr = std::unique_ptr<PendingStream>;
+
+  // A connection being established, and the requests waiting for it.
+  class PendingConnection : public Tcp::ConnectionPool::Callbacks,
+                            public Event::DeferredDeletable,
+                            public LinkedObject<PendingConnection> {
+  public:
+    PendingConnection(MultiplexedConnPool& parent, ConnectionGroup& group)
+        : parent_(parent), group_(group) {}
+
+    PendingStream& addWaiter(MultiplexedStreamCallbacks& callbacks);
+    void removeWaiter(PendingStream& waiter);
+    void cancel();
+
+    // Tcp::ConnectionPool::Callbacks
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       absl::string_view transport_failure_reason,
+                       Upstream::HostDescriptionConstSharedPtr host) override;
+    void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+
+    MultiplexedConnPool& parent_;
+    ConnectionGroup& group_;
+    Tcp::ConnectionPool::Cancellable* handle_{};
+    std::list<PendingStreamPtr> waiters_;
+    bool completed_{};
+  };
+
+  // The connections to a host that are used for a transport and protocol.
+  struct ConnectionGroup {
+    ConnectionGroup(Upstream::HostDescriptionConstSharedPtr host, TransportType transport,
+                    ProtocolType protocol)
+        : host_(std::move(host)), transport_(transport), protocol_(protocol) {}
+
+    GroupKey key() const { return {host_.get(), transport_, protocol_}; }
+
+    const Upstream::HostDescriptionConstSharedPtr host_;
+    const TransportType transport_;
+    const ProtocolType protocol_;
+    std::list<ActiveConnectionPtr> ready_;
+    std::list<PendingConnectionPtr> pending_;
+  };
+
+  using ConnectionGroupPtr = std::unique_ptr<ConnectionGroup>;
+
+  void maybeRemoveGroup(ConnectionGroup& group);
+
+  const std::shared_ptr<const RouterStats> stats_;
+  const uint32_t max_requests_per_connection_;
+  const std::chrono::milliseconds response_timeout_;
+  Event::Dispatcher& dispatcher_;
+  absl::flat_hash_map<GroupKey, ConnectionGroupPtr> groups_;
+};
+
+/**
+ * Shares upstream connections among the concurrent requests of a router filter, with a
+ * connection pool per worker.
+ */
+class UpstreamMultiplexer {
+public:
+  UpstreamMultiplexer(
+      const envoy::extensions::filters::network::thrift_proxy::router::v3::Router::
+          UpstreamMultiplexing& config,
+      std::shared_ptr<const RouterStats> stats, ThreadLocal::SlotAllocator& tls);
+
+  /**
+   * @return the connection pool of the calling worker.
+   */
+  MultiplexedConnPool& connPool() { return *tls_; }
+
+  static constexpr uint32_t DefaultMaxConcurrentRequestsPerConnection = 100;
+  static constexpr uint64_t DefaultResponseTimeoutMs = 60000;
+
+private:
+  ThreadLocal::TypedSlot<MultiplexedConnPool> tls_;
+};
+
+using UpstreamMultiplexerSharedPtr = std::shared_ptr<UpstreamMultiplexer>;
+
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -10,8 +10,10 @@ namespace Router {
 
 UpstreamRequest::UpstreamRequest(RequestOwner& parent, Upstream::TcpPoolData& pool_data,
                                  MessageMetadataSharedPtr& metadata, TransportType transport_type,
-                                 ProtocolType protocol_type, bool close_downstream_on_error)
+                                 ProtocolType protocol_type, bool close_downstream_on_error,
+                                 OptRef<MultiplexedConnPool> multiplexed_conn_pool)
     : parent_(parent), stats_(parent.stats()), conn_pool_data_(pool_data), metadata_(metadata),
+      multiplexed_conn_pool_(multiplexed_conn_pool),
       transport_(NamedTransportConfigFactory::getFactory(transport_type).createTransport()),
       protocol_(NamedProtocolConfigFactory::getFactory(protocol_type).createProtocol()),
       close_downstream_on_error_(close_downstream_on_error) {}
@@ -23,7 +25,11 @@ UpstreamRequest::~UpstreamRequest() {
 }
 
 FilterStatus UpstreamRequest::start() {
-  Tcp::ConnectionPool::Cancellable* handle = conn_pool_data_.newConnection(*this);
+  Tcp::ConnectionPool::Cancellable* handle =
+      multiplexed_conn_pool_.has_value()
+          ? multiplexed_conn_pool_->newStream(conn_pool_data_, transport_->type(),
+                                              protocol_->type(), *this)
+          : conn_pool_data_.newConnection(*this);
   if (handle) {
     // Pause while we wait for a connection.
     conn_pool_handle_ = handle;
@@ -50,6 +56,8 @@ void UpstreamRequest::releaseConnection(const bool close) {
   }
 
   conn_state_ = nullptr;
+  // A shared connection stays open for the other requests on it.
+  multiplexed_stream_.reset();
 
   // The event triggered by close will also release this connection so clear conn_data_ before
   // closing.
@@ -107,6 +115,37 @@ void UpstreamRequest::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_
   onRequestStart(continue_decoding);
 }
 
+void UpstreamRequest::onStreamFailure(ConnectionPool::PoolFailureReason reason,
+                                      absl::string_view transport_failure_reason,
+                                      Upstream::HostDescriptionConstSharedPtr host) {
+  onPoolFailure(reason, transport_failure_reason, host);
+}
+
+void UpstreamRequest::onStreamReady(MultiplexedStreamPtr&& stream,
+                                    Upstream::HostDescriptionConstSharedPtr host) {
+  // Only invoke continueDecoding if we'd previously stopped the filter chain.
+  bool continue_decoding = conn_pool_handle_ != nullptr;
+  conn_pool_handle_ = nullptr;
+
+  onUpstreamHostSelected(host);
+  host->outlierDetector().putResult(Upstream::Outlier::Result::LocalOriginConnectSuccess);
+
+  multiplexed_stream_ = std::move(stream);
+  multiplexed_stream_->addUpstreamCallbacks(parent_.upstreamCallbacks());
+  onRequestStart(continue_decoding);
+}
+
+void UpstreamRequest::onStreamTimeout() {
+  ENVOY_LOG(debug, "upstream response timeout");
+  // The shared connection stays open for the other requests on it.
+  const bool end_downstream = onResetStream(ConnectionPool::PoolFailureReason::Timeout);
+  releaseConnection(false);
+  if (!end_downstream && request_complete_) {
+    ENVOY_LOG(debug, "reset parent callbacks");
+    parent_.onReset();
+  }
+}
+
 void UpstreamRequest::handleUpgradeResponse(Buffer::Instance& data) {
   ENVOY_LOG(trace, "reading upgrade response: {} bytes", data.length());
   if (!upgrade_response_->onData(data)) {
@@ -179,6 +218,9 @@ UpstreamRequest::handleRegularResponse(Buffer::Instance& data,
       // ResponseState::Completed before ResponseState::ConnectionReleased to
       // hint that got all the response and not to close the downstream
       // connection, especially while we got a draining signal.
+      if (multiplexed_stream_ != nullptr) {
+        multiplexed_stream_->drainConnection();
+      }
       resetStream();
     }
     onResponseComplete();
@@ -208,7 +250,9 @@ bool UpstreamRequest::handleUpstreamData(Buffer::Instance& data, bool end_stream
     }
   }
 
-  if (end_stream) {
+  // A shared connection delivers the response frame in full, so no more data is coming for it
+  // either.
+  if (end_stream || multiplexed_stream_ != nullptr) {
     // Response is incomplete, but no more data is coming.
     ENVOY_LOG(debug, "response underflow");
     onResponseComplete();
@@ -254,7 +298,11 @@ uint64_t UpstreamRequest::encodeAndWrite(Buffer::OwnedImpl& request_buffer) {
 
   uint64_t size = transport_buffer.length();
 
-  conn_data_->connection().write(transport_buffer, false);
+  if (multiplexed_stream_ != nullptr) {
+    multiplexed_stream_->write(transport_buffer, metadata_->messageType() == MessageType::Call);
+  } else {
+    conn_data_->connection().write(transport_buffer, false);
+  }
 
   return size;
 }
@@ -263,7 +311,8 @@ void UpstreamRequest::onRequestStart(bool continue_decoding) {
   auto& buffer = parent_.buffer();
   parent_.initProtocolConverter(*protocol_, buffer);
 
-  metadata_->setSequenceId(conn_state_->nextSequenceId());
+  metadata_->setSequenceId(multiplexed_stream_ != nullptr ? multiplexed_stream_->sequenceId()
+                                                          : conn_state_->nextSequenceId());
   parent_.convertMessageBegin(metadata_);
 
   if (continue_decoding) {
@@ -283,6 +332,7 @@ void UpstreamRequest::onResponseComplete() {
   chargeResponseTiming();
   response_state_ = ResponseState::ConnectionReleased;
   conn_state_ = nullptr;
+  multiplexed_stream_.reset();
   conn_data_.reset();
 }
 
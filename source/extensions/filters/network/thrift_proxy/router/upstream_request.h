@@ -8,6 +8,7 @@
 #include "source/extensions/filters/network/thrift_proxy/filters/filter.h"
 #include "source/extensions/filters/network/thrift_proxy/metadata.h"
 #include "source/extensions/filters/network/thrift_proxy/router/router.h"
+#include "source/extensions/filters/network/thrift_proxy/router/upstream_multiplexer.h"
 #include "source/extensions/filters/network/thrift_proxy/thrift.h"
 
 namespace Envoy {
@@ -27,10 +28,12 @@ public:
 };
 
 struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks,
+                         public MultiplexedStreamCallbacks,
                          Logger::Loggable<Logger::Id::thrift> {
   UpstreamRequest(RequestOwner& parent, Upstream::TcpPoolData& pool_data,
                   MessageMetadataSharedPtr& metadata, TransportType transport_type,
-                  ProtocolType protocol_type, bool close_downstream_on_error);
+                  ProtocolType protocol_type, bool close_downstream_on_error,
+                  OptRef<MultiplexedConnPool> multiplexed_conn_pool);
   ~UpstreamRequest() override;
 
   FilterStatus start();
@@ -44,6 +47,14 @@ struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks,
   void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn,
                    Upstream::HostDescriptionConstSharedPtr host) override;
 
+  // MultiplexedStreamCallbacks
+  void onStreamFailure(ConnectionPool::PoolFailureReason reason,
+                       absl::string_view transport_failure_reason,
+                       Upstream::HostDescriptionConstSharedPtr host) override;
+  void onStreamReady(MultiplexedStreamPtr&& stream,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+  void onStreamTimeout() override;
+
   bool handleUpstreamData(Buffer::Instance& data, bool end_stream,
                           UpstreamResponseCallbacks& callbacks);
   void handleUpgradeResponse(Buffer::Instance& data);
@@ -65,6 +76,9 @@ struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks,
 
   Tcp::ConnectionPool::Cancellable* conn_pool_handle_{};
   Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+  // Set instead of conn_data_ when the request shares its upstream connection.
+  OptRef<MultiplexedConnPool> multiplexed_conn_pool_;
+  MultiplexedStreamPtr multiplexed_stream_;
   Upstream::HostDescriptionConstSharedPtr upstream_host_;
   ThriftConnectionState* conn_state_{};
   TransportPtr transport_;
@@ -0,0 +1,55 @@
+#include "source/extensions/filters/udp/dns_filter/dns_answer_cache.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+
+const DnsSerializedAnswers* DnsAnswerCache::find(const absl::string_view name,
+                                                 const uint16_t rec_type) {
+  const auto index_iter = index_.find(Key{absl::AsciiStrToLower(name), rec_type});
+  if (index_iter == index_.end()) {
+    return nullptr;
+  }
+
+  const auto entry = index_iter->second;
+  const auto remaining = std::chrono::duration_cast<std::chrono::seconds>(
+      entry->expiry_ - time_source_.monotonicTime());
+  if (remaining.count() <= 0) {
+    index_.erase(index_iter);
+    entries_.erase(entry);
+    return nullptr;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry);
+  entry->answers_.setTtl(remaining);
+  return &entry->answers_;
+}
+
+bool DnsAnswerCache::insert(const absl::string_view name, DnsSerializedAnswers&& answers,
+                            const std::chrono::seconds ttl) {
+  Key key{absl::AsciiStrToLower(name), answers.type()};
+  const auto index_iter = index_.find(key);
+  if (index_iter != index_.end()) {
+    entries_.erase(index_iter->second);
+    index_.erase(index_iter);
+  }
+
+  bool evicted = false;
+  if (entries_.size() >= max_entries_) {
+    index_.erase(entries_.back().key_);
+    entries_.pop_back();
+    evicted = true;
+  }
+
+  entries_.push_front(Entry{key, time_source_.monotonicTime() + ttl, std::move(answers)});
+  index_.emplace(std::move(key), entries_.begin());
+  return evicted;
+}
+
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
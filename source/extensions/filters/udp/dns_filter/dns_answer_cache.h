@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <string>
+
+#include "envoy/common/time.h"
+
+#include "source/extensions/filters/udp/dns_filter/dns_parser.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+
+/**
+ * DnsAnswerCache holds the serialized answers to externally resolved queries, keyed by the
+ * queried name and type. Entries expire after the Time-to-live of their answers, and the least
+ * recently used entry is evicted when the cache is full. A cache is used by a single worker.
+ */
+class DnsAnswerCache {
+public:
+  DnsAnswerCache(uint32_t max_entries, TimeSource& time_source)
+      : max_entries_(max_entries), time_source_(time_source) {}
+
+  /**
+   * @brief Retrieves the answers for a name and type. The Time-to-live of the returned answer
+   * records is the remaining lifetime of the entry. Expired entries are removed
+   *
+   * @param name the queried name. Names are compared case insensitively
+   * @param rec_type the queried record type
+   * @return const DnsSerializedAnswers* the cached answers, or nullptr if there are none. The
+   * answers remain valid until the cache is next modified
+   */
+  const DnsSerializedAnswers* find(const absl::string_view name, const uint16_t rec_type);
+
+  /**
+   * @brief Stores the answers for a name, replacing any answers stored for the name and type
+   *
+   * @param name the queried name
+   * @param answers the answers to the query
+   * @param ttl the Time-to-live of the answers, after which the entry expires
+   * @return bool true if an entry was evicted to make room for the answers
+   */
+  bool insert(const absl::string_view name, DnsSerializedAnswers&& answers,
+              const std::chrono::seconds ttl);
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  using Key = std::pair<std::string, uint16_t>;
+
+  struct Entry {
+    Key key_;
+    MonotonicTime expiry_;
+    DnsSerializedAnswers answers_;
+  };
+
+  const uint32_t max_entries_;
+  TimeSource& time_source_;
+  // Ordered from the most to the least recently used
+  std::list<Entry> entries_;
+  absl::flat_hash_map<Key, std::list<Entry>::iterator> index_;
+};
+
+using DnsAnswerCachePtr = std::unique_ptr<DnsAnswerCache>;
+
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
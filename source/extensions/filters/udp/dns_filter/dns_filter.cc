@@ -10,6 +10,7 @@
 #include "source/common/network/dns_resolver/dns_factory_util.h"
 #include "source/common/protobuf/message_validator_impl.h"
 #include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/extensions/filters/udp/dns_filter/dns_filter_access_log.h"
 #include "source/extensions/filters/udp/dns_filter/dns_filter_utils.h"
 
@@ -169,6 +170,10 @@ DnsFilterEnvoyConfig::DnsFilterEnvoyConfig(
     domain_ttl_.emplace(virtual_domain_name, ttl);
   }
 
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.dns_filter_serialized_answers")) {
+    serializeAnswers(dns_table);
+  }
+
   forward_queries_ = config.has_client_config();
   if (forward_queries_) {
     const auto& client_config = config.client_config();
@@ -178,6 +183,7 @@ DnsFilterEnvoyConfig::DnsFilterEnvoyConfig(
     resolver_timeout_ = std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
         client_config, resolver_timeout, DEFAULT_RESOLVER_TIMEOUT.count()));
     max_pending_lookups_ = client_config.max_pending_lookups();
+    max_cached_answers_ = client_config.max_cached_answers();
   } else {
     // In case client_config doesn't exist, use the bootstrap DNS resolver if it is configured.
     if (context.serverFactoryContext().bootstrap().has_typed_dns_resolver_config() &&
@@ -219,6 +225,34 @@ void DnsFilterEnvoyConfig::addEndpointToSuffix(const absl::string_view suffix,
   ASSERT(success, "Unable to overwrite existing suffix in dns_filter trie");
 }
 
+void DnsFilterEnvoyConfig::serializeAnswers(const envoy::data::dns::v3::DnsTable& table) {
+  // The answers are serialized once all domains are loaded, since the addresses of a domain may be
+  // configured in more than one entry
+  for (const auto& virtual_domain : table.virtual_domains()) {
+    if (!virtual_domain.endpoint().has_address_list()) {
+      continue;
+    }
+
+    const absl::string_view virtual_domain_name =
+        Utils::getVirtualDomainName(virtual_domain.name());
+    auto virtual_domains = dns_lookup_trie_.find(Utils::getDomainSuffix(virtual_domain_name));
+    if (virtual_domains == nullptr) {
+      continue;
+    }
+    auto endpoint_config = virtual_domains->find(virtual_domain_name);
+    if (endpoint_config == virtual_domains->end() ||
+        !endpoint_config->second.address_list.has_value() ||
+        endpoint_config->second.a_answers.has_value()) {
+      continue;
+    }
+
+    const std::chrono::seconds ttl = domain_ttl_.at(virtual_domain_name);
+    const AddressConstPtrVec& address_list = endpoint_config->second.address_list.value();
+    endpoint_config->second.a_answers.emplace(DNS_RECORD_TYPE_A, ttl, address_list);
+    endpoint_config->second.aaaa_answers.emplace(DNS_RECORD_TYPE_AAAA, ttl, address_list);
+  }
+}
+
 bool DnsFilterEnvoyConfig::loadServerConfig(
     const envoy::extensions::filters::udp::dns_filter::v3::DnsFilterConfig::ServerContextConfig&
         config,
@@ -257,7 +291,8 @@ DnsFilter::DnsFilter(Network::UdpReadFilterCallbacks& callbacks,
   // the resolver, we build an answer record from each IP returned then send a response to the
   // client
   resolver_callback_ = [this](DnsQueryContextPtr context, const DnsQueryRecord* query,
-                              AddressConstPtrVec& iplist) -> void {
+                              AddressConstPtrVec& iplist,
+                              std::chrono::seconds records_ttl) -> void {
     // We cannot retry the resolution if ares returns without a response. The ares context
     // is still dirty and will result in a segfault when it is freed during a subsequent resolve
     // call from here. We will retry resolutions for pending lookups only
@@ -276,11 +311,23 @@ DnsFilter::DnsFilter(Network::UdpReadFilterCallbacks& callbacks,
     }
 
     incrementExternalQueryTypeCount(query->type_);
+    const std::chrono::seconds ttl = getDomainTTL(query->name_);
     for (const auto& ip : iplist) {
       incrementExternalQueryTypeAnswerCount(query->type_);
-      const std::chrono::seconds ttl = getDomainTTL(query->name_);
       message_parser_.storeDnsAnswerRecord(context, *query, ttl, ip);
     }
+
+    // Cache the answers that fit in a response in full, until the first of their records expires
+    // upstream, and no longer than the TTL they are returned with
+    const std::chrono::seconds cache_ttl = std::min(ttl, records_ttl);
+    if (answer_cache_ != nullptr && cache_ttl.count() > 0 &&
+        context->resolution_status_ == Network::DnsResolver::ResolutionStatus::Completed) {
+      DnsSerializedAnswers answers(query->type_, cache_ttl, iplist);
+      if (answers.count() > 0 && answers.count() <= MAX_RETURNED_RECORDS &&
+          answer_cache_->insert(query->name_, std::move(answers), cache_ttl)) {
+        config_->stats().external_answer_cache_evictions_.inc();
+      }
+    }
     sendDnsResponse(std::move(context));
   };
 
@@ -288,6 +335,11 @@ DnsFilter::DnsFilter(Network::UdpReadFilterCallbacks& callbacks,
       resolver_callback_, config->resolverTimeout(), listener_.dispatcher(),
       config->maxPendingLookups(), config->typedDnsResolverConfig(), config->dnsResolverFactory(),
       config->api());
+
+  if (config->maxCachedAnswers() > 0) {
+    answer_cache_ = std::make_unique<DnsAnswerCache>(config->maxCachedAnswers(),
+                                                     listener_.dispatcher().timeSource());
+  }
 }
 
 Network::FilterStatus DnsFilter::onData(Network::UdpRecvData& client_request) {
@@ -327,7 +379,11 @@ void DnsFilter::sendDnsResponse(DnsQueryContextPtr query_context) {
 
   // Serializes the generated response to the parsed query from the client. If there is a
   // parsing error or the incoming query is invalid, we will still generate a valid DNS response
-  message_parser_.buildResponseBuffer(query_context, response);
+  if (query_context->serialized_answers_ != nullptr) {
+    message_parser_.buildSerializedResponseBuffer(query_context, response);
+  } else {
+    message_parser_.buildResponseBuffer(query_context, response);
+  }
   config_->stats().downstream_tx_responses_.inc();
   config_->stats().downstream_tx_bytes_.recordValue(response.length());
 
@@ -368,6 +424,24 @@ DnsLookupResponseCode DnsFilter::getResponseForQuery(DnsQueryContextPtr& context
     // Forwarding queries is enabled if the configuration contains a client configuration
     // for the dns_filter.
     if (forward_queries) {
+      if (answer_cache_ != nullptr) {
+        const DnsSerializedAnswers* cached_answers =
+            answer_cache_->find(query->name_, query->type_);
+        if (cached_answers != nullptr) {
+          ENVOY_LOG(debug, "using cached answers for name [{}]", query->name_);
+          config_->stats().external_answer_cache_hits_.inc();
+          // The cached answers are counted as the external answers they replay.
+          config_->stats().externally_resolved_queries_.inc();
+          incrementExternalQueryTypeCount(query->type_);
+          for (uint16_t i = 0; i < cached_answers->count(); i++) {
+            incrementExternalQueryTypeAnswerCount(query->type_);
+          }
+          context->serialized_answers_ = cached_answers;
+          continue;
+        }
+        config_->stats().external_answer_cache_misses_.inc();
+      }
+
       ENVOY_LOG(debug, "resolving name [{}] via external resolvers", query->name_);
       resolver_->resolveExternalQuery(std::move(context), query.get());
 
@@ -375,7 +449,7 @@ DnsLookupResponseCode DnsFilter::getResponseForQuery(DnsQueryContextPtr& context
     }
   }
 
-  if (context->answers_.empty()) {
+  if (context->answerCount() == 0) {
     config_->stats().unanswered_queries_.inc();
     return DnsLookupResponseCode::Failure;
   }
@@ -417,7 +491,8 @@ bool DnsFilter::isKnownDomain(const absl::string_view domain_name) {
   return false;
 }
 
-const DnsEndpointConfig* DnsFilter::getEndpointConfigForDomain(const absl::string_view domain) {
+const DnsEndpointConfig* DnsFilter::getEndpointConfigForDomain(const absl::string_view domain,
+                                                                bool* exact_match) {
   const absl::string_view suffix = Utils::getDomainSuffix(domain);
   const auto virtual_domains = config_->getDnsTrie().find(suffix);
 
@@ -432,6 +507,9 @@ const DnsEndpointConfig* DnsFilter::getEndpointConfigForDomain(const absl::strin
   while (pos != domain.npos) {
     const auto iter = virtual_domains->find(domain.substr(pos));
     if (iter != virtual_domains->end()) {
+      if (exact_match != nullptr) {
+        *exact_match = (pos == 0);
+      }
       return &(iter->second);
     }
 
@@ -575,19 +653,38 @@ bool DnsFilter::resolveViaClusters(DnsQueryContextPtr& context, const DnsQueryRe
 }
 
 bool DnsFilter::resolveConfiguredDomain(DnsQueryContextPtr& context, const DnsQueryRecord& query) {
-  const auto* configured_address_list = getAddressListForDomain(query.name_);
+  bool exact_match = false;
+  const DnsEndpointConfig* endpoint_config = getEndpointConfigForDomain(query.name_, &exact_match);
+  if (endpoint_config == nullptr || !endpoint_config->address_list.has_value()) {
+    return false;
+  }
+
+  // Use the answers serialized with the configuration when they are all returned. A wildcard
+  // match is answered with the TTL of the queried name rather than that of the wildcard, so the
+  // serialized answers are only used for the configured name itself.
+  const auto& serialized_answers = query.type_ == DNS_RECORD_TYPE_A ? endpoint_config->a_answers
+                                                                    : endpoint_config->aaaa_answers;
+  if (exact_match && serialized_answers.has_value() && serialized_answers->count() > 0 &&
+      serialized_answers->count() <= MAX_RETURNED_RECORDS) {
+    ENVOY_LOG(trace, "using {} serialized answers for domain [{}]", serialized_answers->count(),
+              query.name_);
+    context->serialized_answers_ = &serialized_answers.value();
+    for (uint16_t i = 0; i < serialized_answers->count(); i++) {
+      incrementLocalQueryTypeAnswerCount(query.type_);
+    }
+    return true;
+  }
+
+  // Build an answer record from each configured IP address
   uint64_t hosts_found = 0;
-  if (configured_address_list != nullptr) {
-    // Build an answer record from each configured IP address
-    for (const auto& configured_address : *configured_address_list) {
-      ASSERT(configured_address != nullptr);
-      ENVOY_LOG(trace, "using local address {} for domain [{}]",
-                configured_address->ip()->addressAsString(), query.name_);
-      ++hosts_found;
-      const std::chrono::seconds ttl = getDomainTTL(query.name_);
-      if (message_parser_.storeDnsAnswerRecord(context, query, ttl, configured_address)) {
-        incrementLocalQueryTypeAnswerCount(query.type_);
-      }
+  for (const auto& configured_address : endpoint_config->address_list.value()) {
+    ASSERT(configured_address != nullptr);
+    ENVOY_LOG(trace, "using local address {} for domain [{}]",
+              configured_address->ip()->addressAsString(), query.name_);
+    ++hosts_found;
+    const std::chrono::seconds ttl = getDomainTTL(query.name_);
+    if (message_parser_.storeDnsAnswerRecord(context, query, ttl, configured_address)) {
+      incrementLocalQueryTypeAnswerCount(query.type_);
     }
   }
   return (hosts_found != 0);
@@ -13,6 +13,7 @@
 #include "source/common/network/socket_impl.h"
 #include "source/common/network/utility.h"
 #include "source/common/stream_info/stream_info_impl.h"
+#include "source/extensions/filters/udp/dns_filter/dns_answer_cache.h"
 #include "source/extensions/filters/udp/dns_filter/dns_filter_resolver.h"
 #include "source/extensions/filters/udp/dns_filter/dns_parser.h"
 
@@ -43,6 +44,9 @@ inline constexpr absl::string_view DnsFilterName = "envoy.filters.udp.dns_filter
   COUNTER(external_a_record_answers)                                                               \
   COUNTER(external_aaaa_record_answers)                                                            \
   COUNTER(external_aaaa_record_queries)                                                            \
+  COUNTER(external_answer_cache_evictions)                                                         \
+  COUNTER(external_answer_cache_hits)                                                              \
+  COUNTER(external_answer_cache_misses)                                                            \
   COUNTER(external_unsupported_answers)                                                            \
   COUNTER(external_unsupported_queries)                                                            \
   COUNTER(externally_resolved_queries)                                                             \
@@ -74,6 +78,10 @@ struct DnsEndpointConfig {
   std::optional<AddressConstPtrVec> address_list;
   std::optional<std::string> cluster_name;
   std::optional<DnsSrvRecordPtr> service_list;
+  // The answers to A and AAAA queries for the address_list, serialized when the configuration is
+  // loaded
+  std::optional<DnsSerializedAnswers> a_answers;
+  std::optional<DnsSerializedAnswers> aaaa_answers;
 };
 
 using DnsVirtualDomainConfig = absl::flat_hash_map<std::string, DnsEndpointConfig>;
@@ -98,6 +106,7 @@ public:
   uint64_t retryCount() const { return retry_count_; }
   Random::RandomGenerator& random() const { return random_; }
   uint64_t maxPendingLookups() const { return max_pending_lookups_; }
+  uint32_t maxCachedAnswers() const { return max_cached_answers_; }
   const envoy::config::core::v3::TypedExtensionConfig& typedDnsResolverConfig() const {
     return typed_dns_resolver_config_;
   }
@@ -121,6 +130,8 @@ private:
   void addEndpointToSuffix(const absl::string_view suffix, const absl::string_view domain_name,
                            DnsEndpointConfig& endpoint_config);
 
+  void serializeAnswers(const envoy::data::dns::v3::DnsTable& table);
+
   Stats::Scope& root_scope_;
   Upstream::ClusterManager& cluster_manager_;
   Network::DnsResolverSharedPtr resolver_;
@@ -135,6 +146,7 @@ private:
   std::chrono::milliseconds resolver_timeout_;
   Random::RandomGenerator& random_;
   uint64_t max_pending_lookups_;
+  uint32_t max_cached_answers_{0};
   envoy::config::core::v3::TypedExtensionConfig typed_dns_resolver_config_;
   Network::DnsResolverFactory* dns_resolver_factory_;
   AccessLog::InstanceSharedPtrVector access_logs_;
@@ -359,8 +371,12 @@ private:
 
   /**
    * @brief Helper function to retrieve the Endpoint configuration for a requested domain
+   *
+   * @param exact_match if not null, set to whether the configuration is for the domain itself
+   * rather than a wildcard matching it
    */
-  const DnsEndpointConfig* getEndpointConfigForDomain(const absl::string_view domain);
+  const DnsEndpointConfig* getEndpointConfigForDomain(const absl::string_view domain,
+                                                      bool* exact_match = nullptr);
 
   /**
    * @brief Helper function to retrieve the Service Config for a requested domain
@@ -389,6 +405,7 @@ private:
   Upstream::ClusterManager& cluster_manager_;
   DnsMessageParser message_parser_;
   DnsFilterResolverPtr resolver_;
+  DnsAnswerCachePtr answer_cache_;
   Network::Address::InstanceConstSharedPtr local_;
   Network::Address::InstanceConstSharedPtr peer_;
   DnsFilterResolverCallback resolver_callback_;
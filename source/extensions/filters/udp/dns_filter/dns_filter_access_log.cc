@@ -117,7 +117,7 @@ private:
             {"ANSWER_COUNT",
              [](absl::string_view, std::optional<size_t>) -> Formatter::FormatterProviderPtr {
                return makeContextFieldProvider(
-                   [](const DnsQueryContext& ctx) { return absl::StrCat(ctx.answers_.size()); });
+                   [](const DnsQueryContext& ctx) { return absl::StrCat(ctx.answerCount()); });
              }},
             {"RESPONSE_CODE",
              [](absl::string_view, std::optional<size_t>) -> Formatter::FormatterProviderPtr {
@@ -1,5 +1,7 @@
 #include "source/extensions/filters/udp/dns_filter/dns_filter_resolver.h"
 
+#include <algorithm>
+
 #include "source/common/network/utility.h"
 
 namespace Envoy {
@@ -86,7 +88,6 @@ void DnsFilterResolver::resolveExternalQuery(DnsQueryContextPtr context,
                        ctx.query_context->resolution_status_ = status;
                        ctx.resolver_status = DnsFilterResolverStatus::Complete;
 
-                       // C-ares doesn't expose the TTL in the data available here.
                        if (status == Network::DnsResolver::ResolutionStatus::Completed) {
                          ctx.resolved_hosts.reserve(response.size());
                          for (const auto& resp : response) {
@@ -95,6 +96,9 @@ void DnsFilterResolver::resolveExternalQuery(DnsQueryContextPtr context,
                            ENVOY_LOG(trace, "Resolved address: {} for {}",
                                      addrinfo.address_->ip()->addressAsString(),
                                      ctx.query_rec->name_);
+                           ctx.resolved_ttl = ctx.resolved_hosts.empty()
+                                                  ? addrinfo.ttl_
+                                                  : std::min(ctx.resolved_ttl, addrinfo.ttl_);
                            ctx.resolved_hosts.emplace_back(std::move(addrinfo.address_));
                          }
                        }
@@ -118,7 +122,8 @@ void DnsFilterResolver::onResolveTimeout() {
       ctx.query_context->resolution_status_ = Network::DnsResolver::ResolutionStatus::Failure;
 
       lookups_.erase(ctx_iter.first);
-      callback_(std::move(ctx.query_context), ctx.query_rec, ctx.resolved_hosts);
+      callback_(std::move(ctx.query_context), ctx.query_rec, ctx.resolved_hosts,
+                ctx.resolved_ttl);
       return;
     }
   }
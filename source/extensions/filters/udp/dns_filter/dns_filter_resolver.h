@@ -45,6 +45,8 @@ private:
     DnsQueryContextPtr query_context;
     uint64_t expiry;
     AddressConstPtrVec resolved_hosts;
+    // The smallest Time-to-live of the resolved hosts.
+    std::chrono::seconds resolved_ttl{0};
     DnsFilterResolverStatus resolver_status;
     Event::TimerPtr timeout_timer;
   };
@@ -55,7 +57,8 @@ private:
   void invokeCallback(LookupContext& context) {
     // If we've timed out. Guard against sending a response
     if (context.resolver_status == DnsFilterResolverStatus::Complete) {
-      callback_(std::move(context.query_context), context.query_rec, context.resolved_hosts);
+      callback_(std::move(context.query_context), context.query_rec, context.resolved_hosts,
+                context.resolved_ttl);
     }
   }
 
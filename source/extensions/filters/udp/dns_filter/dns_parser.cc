@@ -75,32 +75,49 @@ bool DnsQueryRecord::serialize(Buffer::OwnedImpl& output) {
   return (output.length() > 0);
 }
 
+namespace {
+
+// The compression pointer to the name of the first question, which directly follows the header
+constexpr uint16_t QUESTION_NAME_POINTER = 0xC000 | sizeof(DnsHeader);
+
+// The offset of the Time-to-live from the start of an answer record with a compressed name
+constexpr size_t SERIALIZED_ANSWER_TTL_OFFSET = 3 * sizeof(uint16_t);
+
+// Serialize the fields of an address record following its name
+void serializeAddressRecordData(Buffer::OwnedImpl& output, const uint16_t rec_type,
+                                const uint16_t rec_class, const std::chrono::seconds ttl,
+                                const Network::Address::Ip& ip_address) {
+  output.writeBEInt<uint16_t>(rec_type);
+  output.writeBEInt<uint16_t>(rec_class);
+  output.writeBEInt<uint32_t>(static_cast<uint32_t>(ttl.count()));
+
+  if (ip_address.ipv6() != nullptr) {
+    // Store the 128bit address with 2 64 bit writes
+    const absl::uint128 addr6 = ip_address.ipv6()->address();
+    output.writeBEInt<uint16_t>(sizeof(addr6));
+#ifdef ABSL_IS_BIG_ENDIAN
+    output.writeBEInt<uint64_t>(absl::Uint128High64(addr6));
+    output.writeBEInt<uint64_t>(absl::Uint128Low64(addr6));
+#else
+    output.writeLEInt<uint64_t>(absl::Uint128Low64(addr6));
+    output.writeLEInt<uint64_t>(absl::Uint128High64(addr6));
+#endif
+  } else if (ip_address.ipv4() != nullptr) {
+    output.writeBEInt<uint16_t>(4);
+    output.writeLEInt<uint32_t>(ip_address.ipv4()->address());
+  }
+}
+
+} // namespace
+
 // Serialize a single DNS Answer Record
 bool DnsAnswerRecord::serialize(Buffer::OwnedImpl& output) {
   if (serializeName(output)) {
-    output.writeBEInt<uint16_t>(type_);
-    output.writeBEInt<uint16_t>(class_);
-    output.writeBEInt<uint32_t>(static_cast<uint32_t>(ttl_.count()));
-
     ASSERT(ip_addr_ != nullptr);
     const auto ip_address = ip_addr_->ip();
 
     ASSERT(ip_address != nullptr);
-    if (ip_address->ipv6() != nullptr) {
-      // Store the 128bit address with 2 64 bit writes
-      const absl::uint128 addr6 = ip_address->ipv6()->address();
-      output.writeBEInt<uint16_t>(sizeof(addr6));
-#ifdef ABSL_IS_BIG_ENDIAN
-      output.writeBEInt<uint64_t>(absl::Uint128High64(addr6));
-      output.writeBEInt<uint64_t>(absl::Uint128Low64(addr6));
-#else
-      output.writeLEInt<uint64_t>(absl::Uint128Low64(addr6));
-      output.writeLEInt<uint64_t>(absl::Uint128High64(addr6));
-#endif
-    } else if (ip_address->ipv4() != nullptr) {
-      output.writeBEInt<uint16_t>(4);
-      output.writeLEInt<uint32_t>(ip_address->ipv4()->address());
-    }
+    serializeAddressRecordData(output, type_, class_, ttl_, *ip_address);
   }
   return (output.length() > 0);
 }
@@ -131,6 +148,42 @@ void DnsSrvRecord::addTarget(const absl::string_view target, const DnsTargetAttr
   targets_.emplace(std::make_pair(std::string(target), attrs));
 }
 
+DnsSerializedAnswers::DnsSerializedAnswers(const uint16_t rec_type,
+                                           const std::chrono::seconds ttl,
+                                           const AddressConstPtrVec& addresses)
+    : type_(rec_type) {
+  Buffer::OwnedImpl output;
+  for (const auto& address : addresses) {
+    const auto ip_address = address->ip();
+    ASSERT(ip_address != nullptr);
+    if ((type_ == DNS_RECORD_TYPE_A && ip_address->ipv4() == nullptr) ||
+        (type_ == DNS_RECORD_TYPE_AAAA && ip_address->ipv6() == nullptr)) {
+      continue;
+    }
+    output.writeBEInt<uint16_t>(QUESTION_NAME_POINTER);
+    serializeAddressRecordData(output, type_, DNS_RECORD_CLASS_IN, ttl, *ip_address);
+    ++count_;
+  }
+  records_ = output.toString();
+}
+
+void DnsSerializedAnswers::setTtl(const std::chrono::seconds ttl) {
+  if (count_ == 0) {
+    return;
+  }
+
+  // All records have the same type, and thus the same size
+  const uint32_t value = static_cast<uint32_t>(ttl.count());
+  const size_t record_size = records_.size() / count_;
+  for (size_t offset = SERIALIZED_ANSWER_TTL_OFFSET; offset < records_.size();
+       offset += record_size) {
+    records_[offset] = static_cast<char>(value >> 24);
+    records_[offset + 1] = static_cast<char>(value >> 16);
+    records_[offset + 2] = static_cast<char>(value >> 8);
+    records_[offset + 3] = static_cast<char>(value);
+  }
+}
+
 DnsQueryContextPtr DnsMessageParser::createQueryContext(Network::UdpRecvData& client_request,
                                                         DnsParserCounters& counters) {
   DnsQueryContextPtr query_context = std::make_unique<DnsQueryContext>(
@@ -559,6 +612,50 @@ void DnsMessageParser::buildResponseBuffer(DnsQueryContextPtr& query_context,
                       serialized_authority_rrs, serialized_additional_rrs);
 
   // Build the response buffer for transmission to the client
+  serializeResponseHeader(query_context, buffer);
+
+  // write the queries and answers
+  buffer.move(query_buffer);
+  buffer.move(answer_buffer);
+  buffer.move(addl_rec_buffer);
+}
+
+void DnsMessageParser::buildSerializedResponseBuffer(DnsQueryContextPtr& query_context,
+                                                     Buffer::OwnedImpl& buffer) {
+  const DnsSerializedAnswers* answers = query_context->serialized_answers_;
+  ASSERT(answers != nullptr);
+
+  // The names of the answer records point to the name of the question, so there must be exactly
+  // one question ahead of them
+  ASSERT(query_context->queries_.size() == 1);
+  const auto& query = query_context->queries_.front();
+  ASSERT(query->type_ == answers->type());
+
+  ENVOY_LOG(trace, "Building response for query ID [{}] from {} serialized answers",
+            query_context->id_, answers->count());
+
+  Buffer::OwnedImpl query_buffer{};
+  uint16_t serialized_queries = 0;
+  uint16_t serialized_answers = 0;
+  if (query->serialize(query_buffer)) {
+    ++serialized_queries;
+    serialized_answers = answers->count();
+  } else {
+    ENVOY_LOG(debug, "Unable to serialize query record for {}", query->name_);
+  }
+
+  setResponseCode(query_context, serialized_queries, serialized_answers);
+  setDnsResponseFlags(query_context, serialized_queries, serialized_answers, 0, 0);
+  serializeResponseHeader(query_context, buffer);
+
+  buffer.move(query_buffer);
+  if (serialized_answers > 0) {
+    buffer.add(answers->records());
+  }
+}
+
+void DnsMessageParser::serializeResponseHeader(DnsQueryContextPtr& query_context,
+                                               Buffer::OwnedImpl& buffer) {
   buffer.writeBEInt<uint16_t>(query_context->response_header_.id);
 
   uint16_t flags;
@@ -569,11 +666,6 @@ void DnsMessageParser::buildResponseBuffer(DnsQueryContextPtr& query_context,
   buffer.writeBEInt<uint16_t>(query_context->response_header_.answers);
   buffer.writeBEInt<uint16_t>(query_context->response_header_.authority_rrs);
   buffer.writeBEInt<uint16_t>(query_context->response_header_.additional_rrs);
-
-  // write the queries and answers
-  buffer.move(query_buffer);
-  buffer.move(answer_buffer);
-  buffer.move(addl_rec_buffer);
 }
 
 } // namespace DnsFilter
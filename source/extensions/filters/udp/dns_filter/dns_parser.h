@@ -118,6 +118,38 @@ using DnsSrvRecordPtr = std::unique_ptr<DnsSrvRecord>;
 // weighted to distribute connections to multiple hosts, etc.
 using DnsSrvRecordPtrVec = std::vector<DnsSrvRecordPtr>;
 
+/**
+ * DnsSerializedAnswers holds the A or AAAA answer records for a name in wire format, so that a
+ * response can be built without creating and serializing a record for each address on every
+ * query. The name of each record is a compression pointer to the name of the question, which
+ * directly follows the header of a response to a single question.
+ */
+class DnsSerializedAnswers {
+public:
+  /**
+   * @param rec_type the type of the answer records
+   * @param ttl the Time-to-live of the answer records
+   * @param addresses the addresses returned in the answer records. Addresses not matching the
+   * record type are skipped
+   */
+  DnsSerializedAnswers(const uint16_t rec_type, const std::chrono::seconds ttl,
+                       const AddressConstPtrVec& addresses);
+
+  /**
+   * @brief Rewrites the Time-to-live of every answer record
+   */
+  void setTtl(const std::chrono::seconds ttl);
+
+  uint16_t type() const { return type_; }
+  uint16_t count() const { return count_; }
+  absl::string_view records() const { return records_; }
+
+private:
+  uint16_t type_;
+  uint16_t count_{0};
+  std::string records_;
+};
+
 /**
  * @brief This struct is used to hold pointers to the counters that are relevant to the
  * parser. This is done to prevent dependency loops between the parser and filter headers
@@ -207,8 +239,17 @@ public:
   DnsQueryPtrVec queries_;
   DnsAnswerMap answers_;
   DnsAnswerMap additional_;
+  // Set instead of answers_ when the query is answered with serialized answer records
+  const DnsSerializedAnswers* serialized_answers_{nullptr};
   bool in_callback_;
 
+  /**
+   * @return size_t the number of answer records for the query
+   */
+  size_t answerCount() const {
+    return serialized_answers_ != nullptr ? serialized_answers_->count() : answers_.size();
+  }
+
   /**
    * @param context the query context for which we are querying the response code
    * @return uint16_t the response code flag value from a parsed dns object
@@ -217,8 +258,10 @@ public:
 };
 
 using DnsQueryContextPtr = std::unique_ptr<DnsQueryContext>;
-using DnsFilterResolverCallback = std::function<void(
-    DnsQueryContextPtr context, const DnsQueryRecord* current_query, AddressConstPtrVec& ipaddr)>;
+// The records_ttl is the smallest Time-to-live of the resolved records, zero if there are none.
+using DnsFilterResolverCallback =
+    std::function<void(DnsQueryContextPtr context, const DnsQueryRecord* current_query,
+                       AddressConstPtrVec& ipaddr, std::chrono::seconds records_ttl)>;
 
 /**
  * This class orchestrates parsing a DNS query and building the response to be sent to a client.
@@ -242,6 +285,14 @@ public:
    */
   void buildResponseBuffer(DnsQueryContextPtr& query_context, Buffer::OwnedImpl& buffer);
 
+  /**
+   * @brief Builds the response to a query answered with serialized answer records
+   *
+   * @param query_context the query context containing the answer records
+   * @param buffer the buffer containing the constructed DNS response to be sent to a client
+   */
+  void buildSerializedResponseBuffer(DnsQueryContextPtr& query_context, Buffer::OwnedImpl& buffer);
+
   /**
    * @brief parse a single query record from a client request
    *
@@ -370,6 +421,14 @@ private:
                            const uint16_t answers, const uint16_t authority_rrs,
                            const uint16_t additional_rrs);
 
+  /**
+   * @brief serializes the DNS header of the response sent to a client
+   *
+   * @param context the query context for which we are generating a response
+   * @param buffer the buffer to which the header is written
+   */
+  void serializeResponseHeader(DnsQueryContextPtr& context, Buffer::OwnedImpl& buffer);
+
   /**
    * @brief Extracts a DNS query name from a buffer
    *
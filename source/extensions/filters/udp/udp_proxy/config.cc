@@ -113,7 +113,10 @@ UdpProxyFilterConfigImpl::UdpProxyFilterConfigImpl(
       upstream_socket_config_(config.upstream_socket_config(), true),
       udp_session_filter_config_provider_manager_(
           createSingletonUdpSessionFilterConfigProviderManager(context.serverFactoryContext())),
-      random_generator_(context.serverFactoryContext().api().randomGenerator()) {
+      random_generator_(context.serverFactoryContext().api().randomGenerator()),
+      use_shared_upstream_sockets_(config.has_shared_upstream_sockets()),
+      max_upstream_batch_size_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.shared_upstream_sockets(), max_batch_size, 32)) {
   if (use_per_packet_load_balancing_ && config.has_tunneling_config()) {
     throw EnvoyException(
         "Only one of use_per_packet_load_balancing or tunneling_config can be used.");
@@ -124,6 +127,14 @@ UdpProxyFilterConfigImpl::UdpProxyFilterConfigImpl(
         "Only one of use_per_packet_load_balancing or session_filters can be used.");
   }
 
+  if (use_shared_upstream_sockets_ && use_original_src_ip_) {
+    throw EnvoyException("Only one of shared_upstream_sockets or use_original_src_ip can be used.");
+  }
+
+  if (use_shared_upstream_sockets_ && config.has_tunneling_config()) {
+    throw EnvoyException("Only one of shared_upstream_sockets or tunneling_config can be used.");
+  }
+
   if (use_original_src_ip_ &&
       !Api::OsSysCallsSingleton::get().supportsIpTransparent(
           context.serverFactoryContext().options().localAddressIpVersion())) {
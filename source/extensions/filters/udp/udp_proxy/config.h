@@ -156,6 +156,8 @@ public:
     return access_log_flush_interval_;
   }
   Random::RandomGenerator& randomGenerator() const override { return random_generator_; }
+  bool usingSharedUpstreamSockets() const override { return use_shared_upstream_sockets_; }
+  uint32_t maxUpstreamBatchSize() const override { return max_upstream_batch_size_; }
 
   // UdpSessionFilterChainFactory
   bool createFilterChain(Network::UdpSessionFilterChainFactoryCallbacks& callbacks) const override {
@@ -177,7 +179,8 @@ private:
                                                Stats::Scope& scope) {
     const auto final_prefix = absl::StrCat("udp.", stat_prefix);
     return {ALL_UDP_PROXY_DOWNSTREAM_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
-                                           POOL_GAUGE_PREFIX(scope, final_prefix))};
+                                           POOL_GAUGE_PREFIX(scope, final_prefix),
+                                           POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
   }
 
   std::shared_ptr<UdpSessionFilterConfigProviderManager>
@@ -202,6 +205,8 @@ private:
       udp_session_filter_config_provider_manager_;
   UdpSessionFilterFactoriesList filter_factories_;
   Random::RandomGenerator& random_generator_;
+  const bool use_shared_upstream_sockets_;
+  const uint32_t max_upstream_batch_size_;
 };
 
 /**
@@ -5,6 +5,8 @@
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/network/socket_option_factory.h"
 
+#include "absl/container/fixed_array.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace UdpFilters {
@@ -30,6 +32,10 @@ UdpProxyFilter::UdpProxyFilter(Network::UdpReadFilterCallbacks& callbacks,
     udp_proxy_stats_.emplace(StreamInfo::StreamInfoImpl(
         config_->timeSource(), nullptr, StreamInfo::FilterState::LifeSpan::Connection));
   }
+
+  if (config_->usingSharedUpstreamSockets()) {
+    shared_socket_pool_ = std::make_unique<SharedUpstreamSocketPool>(*this);
+  }
 }
 
 UdpProxyFilter::~UdpProxyFilter() {
@@ -438,6 +444,14 @@ void UdpProxyFilter::UdpActiveSession::onIdleTimer() {
   filter_.removeSession(this);
 }
 
+void UdpProxyFilter::UdpActiveSession::onSessionComplete() {
+  if (shared_socket_ != nullptr) {
+    filter_.shared_socket_pool_->removeFlow(*shared_socket_, *host_);
+    shared_socket_ = nullptr;
+  }
+  ActiveSession::onSessionComplete();
+}
+
 void UdpProxyFilter::UdpActiveSession::onReadReady() {
   ASSERT(cluster_);
   resetIdleTimer();
@@ -527,6 +541,14 @@ void UdpProxyFilter::ActiveSession::onData(Network::UdpRecvData& data) {
 }
 
 void UdpProxyFilter::UdpActiveSession::writeUpstream(Network::UdpRecvData& data) {
+  if (shared_socket_ != nullptr) {
+    ENVOY_LOG(trace, "queueing {} byte datagram upstream: downstream={} local={} upstream={}",
+              data.buffer_->length(), addresses_.peer_->asStringView(),
+              addresses_.local_->asStringView(), host_->address()->asStringView());
+    shared_socket_->write(*this, host_->address(), *data.buffer_);
+    return;
+  }
+
   if (!udp_socket_) {
     ENVOY_LOG(debug, "cannot write upstream because the socket was not created.");
     return;
@@ -562,20 +584,26 @@ void UdpProxyFilter::UdpActiveSession::writeUpstream(Network::UdpRecvData& data)
   const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
   Api::IoCallUint64Result rc = Network::Utility::writeToSocket(
       udp_socket_->ioHandle(), *data.buffer_, local_ip, *host_->address());
+  onUpstreamWrite(rc.ok(), tx_buffer_length, udp_socket_->ioHandle());
+}
 
-  if (!rc.ok()) {
+void UdpProxyFilter::UdpActiveSession::onUpstreamWrite(bool ok, uint64_t bytes,
+                                                       Network::IoHandle& io_handle) {
+  ASSERT(cluster_);
+  if (!ok) {
     cluster_->cluster_stats_.sess_tx_errors_.inc();
-  } else {
-    cluster_->cluster_stats_.sess_tx_datagrams_.inc();
-    cluster_->cluster_info_->trafficStats()->upstream_cx_tx_bytes_total_.add(tx_buffer_length);
-
-    // The local ephemeral address is only bound after the first successful send, so populate the
-    // upstream local address for access logging once it becomes available.
-    if (udp_session_info_.upstreamInfo()->upstreamLocalAddress() == nullptr) {
-      auto local_address = udp_socket_->ioHandle().localAddress();
-      if (local_address.ok()) {
-        udp_session_info_.upstreamInfo()->setUpstreamLocalAddress(*local_address);
-      }
+    return;
+  }
+
+  cluster_->cluster_stats_.sess_tx_datagrams_.inc();
+  cluster_->cluster_info_->trafficStats()->upstream_cx_tx_bytes_total_.add(bytes);
+
+  // The local ephemeral address is only bound after the first successful send, so populate the
+  // upstream local address for access logging once it becomes available.
+  if (udp_session_info_.upstreamInfo()->upstreamLocalAddress() == nullptr) {
+    auto local_address = io_handle.localAddress();
+    if (local_address.ok()) {
+      udp_session_info_.upstreamInfo()->setUpstreamLocalAddress(*local_address);
     }
   }
 }
@@ -613,7 +641,7 @@ bool UdpProxyFilter::ActiveSession::onContinueFilterChain(ActiveReadFilter* filt
 }
 
 bool UdpProxyFilter::UdpActiveSession::shouldCreateUpstream() {
-  if (udp_socket_) {
+  if (udp_socket_ || shared_socket_ != nullptr) {
     // A session filter may call on continueFilterChain(), after already creating the socket,
     // so we first check that the socket was not created already.
     return false;
@@ -646,6 +674,15 @@ bool UdpProxyFilter::UdpActiveSession::createUpstream() {
 
 void UdpProxyFilter::UdpActiveSession::createUdpSocket(const Upstream::HostConstSharedPtr& host) {
   ASSERT(cluster_);
+  if (filter_.shared_socket_pool_ != nullptr) {
+    // Shared sockets are never used together with use_original_src_ip.
+    shared_socket_ = &filter_.shared_socket_pool_->addFlow(host, *this);
+    ENVOY_LOG(debug, "creating new session on a shared socket: downstream={} local={} upstream={}",
+              addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
+              host->address()->asStringView());
+    return;
+  }
+
   // NOTE: The socket call can only fail due to memory/fd exhaustion. No local ephemeral port
   //       is bound until the first packet is sent to the upstream host.
   udp_socket_ = filter_.createUdpSocket(host);
@@ -738,6 +775,204 @@ void UdpProxyFilter::UdpActiveSession::processPacket(
   processUpstreamDatagram(recv_data);
 }
 
+UdpProxyFilter::SharedUpstreamSocket::SharedUpstreamSocket(UdpProxyFilter& filter,
+                                                           Network::SocketPtr&& socket)
+    : filter_(filter), socket_(std::move(socket)),
+      flush_callback_(
+          filter_.read_callbacks_->udpListener().dispatcher().createSchedulableCallback(
+              [this]() { flush(); })) {
+  // NOTE: The socket is not connected, as it is used for several upstream hosts. A local
+  //       ephemeral port is bound on the first write.
+  socket_->ioHandle().initializeFileEvent(
+      filter_.read_callbacks_->udpListener().dispatcher(),
+      [this](uint32_t) {
+        onReadReady();
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+}
+
+void UdpProxyFilter::SharedUpstreamSocket::addFlow(const Network::Address::Instance& host_address,
+                                                   UdpActiveSession& session) {
+  ASSERT(!hasFlow(host_address));
+  flows_.emplace(host_address.asString(), &session);
+}
+
+void UdpProxyFilter::SharedUpstreamSocket::removeFlow(
+    const Network::Address::Instance& host_address) {
+  flush();
+  flows_.erase(host_address.asString());
+}
+
+void UdpProxyFilter::SharedUpstreamSocket::close() {
+  ASSERT(queue_.empty());
+  flush_callback_->cancel();
+  socket_->ioHandle().resetFileEvents();
+}
+
+void UdpProxyFilter::SharedUpstreamSocket::write(
+    UdpActiveSession& session, const Network::Address::InstanceConstSharedPtr& host_address,
+    Buffer::Instance& data) {
+  auto buffer = std::make_unique<Buffer::OwnedImpl>();
+  buffer->move(data);
+  queue_.push_back({&session, host_address, std::move(buffer)});
+
+  if (queue_.size() >= filter_.config_->maxUpstreamBatchSize()) {
+    flush();
+  } else {
+    flush_callback_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void UdpProxyFilter::SharedUpstreamSocket::flush() {
+  flush_callback_->cancel();
+  if (queue_.empty()) {
+    return;
+  }
+
+  filter_.config_->stats().upstream_socket_tx_batch_size_.recordValue(queue_.size());
+  if (queue_.size() > 1 && Api::OsSysCallsSingleton::get().supportsMmsg()) {
+    writeBatch();
+  } else {
+    for (QueuedDatagram& datagram : queue_) {
+      const uint64_t length = datagram.buffer_->length();
+      const Api::IoCallUint64Result rc = Network::Utility::writeToSocket(
+          socket_->ioHandle(), *datagram.buffer_, nullptr, *datagram.host_address_);
+      datagram.session_->onUpstreamWrite(rc.ok(), length, socket_->ioHandle());
+    }
+  }
+  queue_.clear();
+}
+
+void UdpProxyFilter::SharedUpstreamSocket::writeBatch() {
+  absl::FixedArray<iovec> iovs(queue_.size());
+  absl::FixedArray<mmsghdr> msgs(queue_.size());
+  memset(msgs.data(), 0, msgs.size() * sizeof(mmsghdr));
+  for (size_t i = 0; i < queue_.size(); ++i) {
+    Buffer::Instance& buffer = *queue_[i].buffer_;
+    iovs[i].iov_len = buffer.length();
+    iovs[i].iov_base = buffer.linearize(buffer.length());
+    msgs[i].msg_hdr.msg_name = const_cast<sockaddr*>(queue_[i].host_address_->sockAddr());
+    msgs[i].msg_hdr.msg_namelen = queue_[i].host_address_->sockAddrLen();
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  size_t next = 0;
+  while (next < queue_.size()) {
+    const Api::SysCallIntResult rc = Api::OsSysCallsSingleton::get().sendmmsg(
+        socket_->ioHandle().fdDoNotUse(), &msgs[next], queue_.size() - next, 0);
+    if (rc.return_value_ > 0) {
+      for (int i = 0; i < rc.return_value_; ++i, ++next) {
+        queue_[next].session_->onUpstreamWrite(true, iovs[next].iov_len, socket_->ioHandle());
+      }
+      continue;
+    }
+    if (rc.return_value_ < 0 && rc.errno_ == SOCKET_ERROR_INTR) {
+      continue;
+    }
+
+    ENVOY_LOG(debug, "cannot write upstream datagram: ({}) {}", rc.errno_,
+              errorDetails(rc.errno_));
+    // The socket buffer is full, so the remaining datagrams are dropped as writeToSocket() would
+    // drop them. Any other error only concerns the first datagram, e.g. an unreachable host.
+    const size_t failed = rc.errno_ == SOCKET_ERROR_AGAIN ? queue_.size() - next : 1;
+    for (size_t i = 0; i < failed; ++i, ++next) {
+      queue_[next].session_->onUpstreamWrite(false, iovs[next].iov_len, socket_->ioHandle());
+    }
+  }
+}
+
+void UdpProxyFilter::SharedUpstreamSocket::onReadReady() {
+  // The local address is not used, as the flow of a datagram is found by its peer address.
+  uint32_t packets_dropped = 0;
+  const Api::IoErrorPtr result = Network::Utility::readPacketsFromSocket(
+      socket_->ioHandle(), *filter_.read_callbacks_->udpListener().localAddress(), *this,
+      filter_.config_->timeSource(), filter_.config_->upstreamSocketConfig().prefer_gro_,
+      /*allow_mmsg=*/true, packets_dropped);
+
+  // The socket has been closed if the last flow was removed while processing the datagrams.
+  if (result == nullptr && !flows_.empty()) {
+    socket_->ioHandle().activateFileEvents(Event::FileReadyType::Read);
+    return;
+  }
+
+  // Flush out buffered data at the end of IO event.
+  filter_.read_callbacks_->udpListener().flush();
+}
+
+void UdpProxyFilter::SharedUpstreamSocket::processPacket(
+    Network::Address::InstanceConstSharedPtr, Network::Address::InstanceConstSharedPtr peer_address,
+    Buffer::InstancePtr buffer, MonotonicTime receive_time, uint8_t tos,
+    Buffer::OwnedImpl saved_cmsg) {
+  const auto it = flows_.find(peer_address->asStringView());
+  if (it == flows_.end()) {
+    ENVOY_LOG(trace, "dropping datagram from upstream without a session: upstream={}",
+              peer_address->asStringView());
+    filter_.config_->stats().upstream_socket_rx_no_flow_.inc();
+    return;
+  }
+
+  UdpActiveSession& session = *it->second;
+  session.resetIdleTimer();
+  session.processPacket(session.addresses().local_, std::move(peer_address), std::move(buffer),
+                        receive_time, tos, std::move(saved_cmsg));
+}
+
+UdpProxyFilter::SharedUpstreamSocketPool::~SharedUpstreamSocketPool() {
+  ASSERT(sockets_.empty());
+}
+
+UdpProxyFilter::SharedUpstreamSocket&
+UdpProxyFilter::SharedUpstreamSocketPool::addFlow(const Upstream::HostConstSharedPtr& host,
+                                                  UdpActiveSession& session) {
+  const Network::Address::Instance& address = *host->address();
+  uint32_t& host_flows = host_flows_[address.asString()];
+
+  SharedUpstreamSocket* socket = nullptr;
+  // Every socket already has a flow to the host when there are as many flows as sockets.
+  if (host_flows < sockets_.size()) {
+    for (const SharedUpstreamSocketPtr& candidate : sockets_) {
+      if (candidate->canUse(address)) {
+        socket = candidate.get();
+        break;
+      }
+    }
+  }
+
+  if (socket == nullptr) {
+    LinkedList::moveIntoListBack(
+        std::make_unique<SharedUpstreamSocket>(filter_, filter_.createUdpSocket(host)), sockets_);
+    socket = sockets_.back().get();
+    filter_.config_->stats().upstream_sockets_active_.inc();
+  }
+
+  socket->addFlow(address, session);
+  ++host_flows;
+  filter_.config_->stats().upstream_socket_flows_active_.inc();
+  return *socket;
+}
+
+void UdpProxyFilter::SharedUpstreamSocketPool::removeFlow(SharedUpstreamSocket& socket,
+                                                          const Upstream::Host& host) {
+  const Network::Address::Instance& address = *host.address();
+  socket.removeFlow(address);
+  filter_.config_->stats().upstream_socket_flows_active_.dec();
+
+  auto it = host_flows_.find(address.asString());
+  ASSERT(it != host_flows_.end());
+  if (--it->second == 0) {
+    host_flows_.erase(it);
+  }
+
+  if (socket.empty()) {
+    socket.close();
+    filter_.read_callbacks_->udpListener().dispatcher().deferredDelete(
+        socket.removeFromList(sockets_));
+    filter_.config_->stats().upstream_sockets_active_.dec();
+  }
+}
+
 void UdpProxyFilter::ActiveSession::resetIdleTimer() {
   if (idle_timer_ == nullptr) {
     return;
@@ -44,7 +44,7 @@ namespace UdpProxy {
 /**
  * All UDP proxy downstream stats. @see stats_macros.h
  */
-#define ALL_UDP_PROXY_DOWNSTREAM_STATS(COUNTER, GAUGE)                                             \
+#define ALL_UDP_PROXY_DOWNSTREAM_STATS(COUNTER, GAUGE, HISTOGRAM)                                  \
   COUNTER(downstream_sess_no_route)                                                                \
   COUNTER(downstream_sess_rx_bytes)                                                                \
   COUNTER(downstream_sess_rx_datagrams)                                                            \
@@ -55,13 +55,19 @@ namespace UdpProxy {
   COUNTER(downstream_sess_tx_errors)                                                               \
   COUNTER(idle_timeout)                                                                            \
   COUNTER(session_filter_config_missing)                                                           \
-  GAUGE(downstream_sess_active, Accumulate)
+  COUNTER(upstream_socket_rx_datagrams_dropped)                                                    \
+  COUNTER(upstream_socket_rx_no_flow)                                                              \
+  GAUGE(downstream_sess_active, Accumulate)                                                        \
+  GAUGE(upstream_socket_flows_active, Accumulate)                                                  \
+  GAUGE(upstream_sockets_active, Accumulate)                                                       \
+  HISTOGRAM(upstream_socket_tx_batch_size, Unspecified)
 
 /**
  * Struct definition for all UDP proxy downstream stats. @see stats_macros.h
  */
 struct UdpProxyDownstreamStats {
-  ALL_UDP_PROXY_DOWNSTREAM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_UDP_PROXY_DOWNSTREAM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                                 GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
@@ -128,6 +134,8 @@ public:
   virtual std::chrono::milliseconds sessionTimeout() const PURE;
   virtual bool usingOriginalSrcIp() const PURE;
   virtual bool usingPerPacketLoadBalancing() const PURE;
+  virtual bool usingSharedUpstreamSockets() const PURE;
+  virtual uint32_t maxUpstreamBatchSize() const PURE;
   virtual const Udp::HashPolicy* hashPolicy() const PURE;
   virtual UdpProxyDownstreamStats& stats() const PURE;
   virtual TimeSource& timeSource() const PURE;
@@ -518,6 +526,8 @@ public:
 protected:
   class ActiveSession;
   class ClusterInfo;
+  class SharedUpstreamSocket;
+  class SharedUpstreamSocketPool;
 
   UdpProxyFilter(Network::UdpReadFilterCallbacks& callbacks,
                  const UdpProxyFilterConfigSharedPtr& config);
@@ -696,6 +706,15 @@ protected:
     bool createUpstream() override;
     void writeUpstream(Network::UdpRecvData& data) override;
     void onIdleTimer() override;
+    void onSessionComplete() override;
+
+    /**
+     * Called with the result of writing a datagram of the session upstream.
+     * @param ok supplies whether the datagram was written.
+     * @param bytes supplies the size of the datagram.
+     * @param io_handle supplies the handle of the socket the datagram was written to.
+     */
+    void onUpstreamWrite(bool ok, uint64_t bytes, Network::IoHandle& io_handle);
 
     // Network::UdpPacketProcessor
     void processPacket(Network::Address::InstanceConstSharedPtr local_address,
@@ -734,6 +753,103 @@ protected:
     // The socket has been connected to avoid port exhaustion.
     bool connected_{};
     const bool use_original_src_ip_;
+    // The socket used instead of udp_socket_ when upstream sockets are shared between sessions.
+    SharedUpstreamSocket* shared_socket_{};
+  };
+
+  /**
+   * An unconnected upstream socket shared by sessions of the filter that use different upstream
+   * hosts. The flow table maps the address of each host to the session using the socket for it, so
+   * that datagrams received from the host can be returned to the session. Datagrams written to the
+   * socket are queued and sent together with sendmmsg() at the end of the event loop iteration, or
+   * as soon as the maximum batch size is reached. The socket is deferred deleted once its last flow
+   * is removed, as that may happen while it processes received datagrams.
+   */
+  class SharedUpstreamSocket : public Network::UdpPacketProcessor,
+                               public Event::DeferredDeletable,
+                               public LinkedObject<SharedUpstreamSocket> {
+  public:
+    SharedUpstreamSocket(UdpProxyFilter& filter, Network::SocketPtr&& socket);
+
+    bool hasFlow(const Network::Address::Instance& host_address) const {
+      return flows_.contains(host_address.asString());
+    }
+    void addFlow(const Network::Address::Instance& host_address, UdpActiveSession& session);
+    // Writes the queued datagrams first, so that none of them refers to a removed session.
+    void removeFlow(const Network::Address::Instance& host_address);
+    bool empty() const { return flows_.empty(); }
+    bool canUse(const Network::Address::Instance& host_address) const {
+      return socket_->ipVersion() == host_address.ip()->version() && !hasFlow(host_address);
+    }
+
+    /**
+     * Queues a datagram of the session, moving the data out of the buffer.
+     */
+    void write(UdpActiveSession& session,
+               const Network::Address::InstanceConstSharedPtr& host_address,
+               Buffer::Instance& data);
+    void flush();
+    // Stops reading from the socket before it is deferred deleted.
+    void close();
+
+    // Network::UdpPacketProcessor
+    void processPacket(Network::Address::InstanceConstSharedPtr local_address,
+                       Network::Address::InstanceConstSharedPtr peer_address,
+                       Buffer::InstancePtr buffer, MonotonicTime receive_time, uint8_t tos,
+                       Buffer::OwnedImpl saved_cmsg) override;
+    uint64_t maxDatagramSize() const override {
+      return filter_.config_->upstreamSocketConfig().max_rx_datagram_size_;
+    }
+    void onDatagramsDropped(uint32_t dropped) override {
+      filter_.config_->stats().upstream_socket_rx_datagrams_dropped_.add(dropped);
+    }
+    size_t numPacketsExpectedPerEventLoop() const final {
+      return Network::MAX_NUM_PACKETS_PER_EVENT_LOOP;
+    }
+    const Network::IoHandle::UdpSaveCmsgConfig& saveCmsgConfig() const override {
+      static const Network::IoHandle::UdpSaveCmsgConfig empty_config{};
+      return empty_config;
+    }
+
+  private:
+    struct QueuedDatagram {
+      UdpActiveSession* session_;
+      Network::Address::InstanceConstSharedPtr host_address_;
+      Buffer::InstancePtr buffer_;
+    };
+
+    void onReadReady();
+    // Writes the queued datagrams with sendmmsg(), as many per call as the socket accepts.
+    void writeBatch();
+
+    UdpProxyFilter& filter_;
+    Network::SocketPtr socket_;
+    absl::flat_hash_map<std::string, UdpActiveSession*> flows_;
+    std::vector<QueuedDatagram> queue_;
+    const Event::SchedulableCallbackPtr flush_callback_;
+  };
+
+  using SharedUpstreamSocketPtr = std::unique_ptr<SharedUpstreamSocket>;
+
+  /**
+   * The upstream sockets shared by the sessions of the filter. A session uses the first socket
+   * that has no flow to its upstream host, and a socket is created when there is none. A socket is
+   * closed once its last flow is removed.
+   */
+  class SharedUpstreamSocketPool {
+  public:
+    SharedUpstreamSocketPool(UdpProxyFilter& filter) : filter_(filter) {}
+    ~SharedUpstreamSocketPool();
+
+    SharedUpstreamSocket& addFlow(const Upstream::HostConstSharedPtr& host,
+                                  UdpActiveSession& session);
+    void removeFlow(SharedUpstreamSocket& socket, const Upstream::Host& host);
+
+  private:
+    UdpProxyFilter& filter_;
+    std::list<SharedUpstreamSocketPtr> sockets_;
+    // The number of flows to each upstream host, which tells whether every socket already has one.
+    absl::flat_hash_map<std::string, uint32_t> host_flows_;
   };
 
   /**
@@ -927,6 +1043,7 @@ private:
   absl::flat_hash_map<std::string, ClusterInfoPtr> cluster_infos_;
 
   std::optional<StreamInfo::StreamInfoImpl> udp_proxy_stats_;
+  std::unique_ptr<SharedUpstreamSocketPool> shared_socket_pool_;
 };
 
 /**
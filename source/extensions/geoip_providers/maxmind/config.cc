@@ -36,7 +36,7 @@ public:
       const auto& provider_config =
           std::make_shared<GeoipProviderConfig>(proto_config, stat_prefix, context.scope());
       driver = std::make_shared<GeoipProvider>(context.mainThreadDispatcher(), context.api(),
-                                               singleton, provider_config);
+                                               context.threadLocal(), singleton, provider_config);
       drivers_[key] = driver;
     }
     return driver;
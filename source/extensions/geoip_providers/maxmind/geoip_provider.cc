@@ -1,5 +1,7 @@
 #include "source/extensions/geoip_providers/maxmind/geoip_provider.h"
 
+#include <algorithm>
+
 #include "source/common/common/assert.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/runtime/runtime_features.h"
@@ -41,6 +43,9 @@ GeoipProviderConfig::GeoipProviderConfig(
       anon_db_path_(getOptionalString(config.anon_db_path())),
       asn_db_path_(getOptionalString(config.asn_db_path())),
       country_db_path_(getOptionalString(config.country_db_path())),
+      lookup_cache_size_(config.has_lookup_cache_size()
+                             ? std::make_optional(config.lookup_cache_size().value())
+                             : std::nullopt),
       stats_scope_(scope.createScope(absl::StrCat(stat_prefix, "maxmind."))),
       stat_name_set_(stats_scope_->symbolTable().makeSet("Maxmind")) {
   const auto& common_config = config.common_provider_config();
@@ -98,6 +103,9 @@ GeoipProviderConfig::GeoipProviderConfig(
   if (country_db_path_) {
     registerGeoDbStats(COUNTRY_DB_TYPE);
   }
+  if (lookup_cache_size_) {
+    stat_name_set_->rememberBuiltins({"lookup_cache.hit", "lookup_cache.miss"});
+  }
 };
 
 void GeoipProviderConfig::registerGeoDbStats(const absl::string_view& db_type) {
@@ -122,9 +130,16 @@ void GeoipProviderConfig::setGuage(Stats::StatName name, const uint64_t value) {
 }
 
 GeoipProvider::GeoipProvider(Event::Dispatcher& dispatcher, Api::Api& api,
-                             Singleton::InstanceSharedPtr owner,
+                             ThreadLocal::SlotAllocator& tls, Singleton::InstanceSharedPtr owner,
                              GeoipProviderConfigSharedPtr config)
     : config_(config), owner_(owner) {
+  if (config_->lookupCacheSize()) {
+    lookup_cache_slot_ = ThreadLocal::TypedSlot<ThreadLocalLookupCache>::makeUnique(tls);
+    lookup_cache_slot_->set([max_entries = config_->lookupCacheSize().value()](
+                                Event::Dispatcher&) -> std::shared_ptr<ThreadLocalLookupCache> {
+      return std::make_shared<ThreadLocalLookupCache>(max_entries);
+    });
+  }
   city_db_ =
       config_->cityDbPath() ? initMaxmindDb(config_->cityDbPath().value(), CITY_DB_TYPE) : nullptr;
   isp_db_ =
@@ -193,18 +208,63 @@ GeoipProvider::~GeoipProvider() {
 void GeoipProvider::lookup(Geolocation::LookupRequest&& request,
                            Geolocation::LookupGeoHeadersCallback&& cb) const {
   auto& remote_address = request.remoteAddress();
+  LookupCache* cache = lookupCache(*remote_address);
+  if (cache != nullptr) {
+    if (const LookupResultMap* cached_result = cache->find(*remote_address->ip());
+        cached_result != nullptr) {
+      config_->incLookupCacheHit();
+      cb(LookupResultMap(*cached_result));
+      return;
+    }
+    config_->incLookupCacheMiss();
+  }
   auto lookup_result = absl::flat_hash_map<std::string, std::string>{};
-  lookupInCountryDb(remote_address, lookup_result);
-  lookupInCityDb(remote_address, lookup_result);
-  lookupInAsnDb(remote_address, lookup_result);
-  lookupInAnonDb(remote_address, lookup_result);
-  lookupInIspDb(remote_address, lookup_result);
+  LookupNetwork network;
+  lookupInCountryDb(remote_address, lookup_result, network);
+  lookupInCityDb(remote_address, lookup_result, network);
+  lookupInAsnDb(remote_address, lookup_result, network);
+  lookupInAnonDb(remote_address, lookup_result, network);
+  lookupInIspDb(remote_address, lookup_result, network);
+  if (cache != nullptr && network.cacheable_) {
+    cache->insert(*remote_address->ip(), network.prefix_len_, lookup_result);
+  }
   cb(std::move(lookup_result));
 }
 
+LookupCache* GeoipProvider::lookupCache(const Network::Address::Instance& address) const {
+  if (lookup_cache_slot_ == nullptr || address.ip() == nullptr) {
+    return nullptr;
+  }
+  ThreadLocalLookupCache& tls_cache = lookup_cache_slot_->get().ref();
+  // The results looked up in the previous databases are dropped once a database is reloaded.
+  const uint64_t db_generation = db_generation_.load(std::memory_order_acquire);
+  if (tls_cache.db_generation_ != db_generation) {
+    tls_cache.cache_.clear();
+    tls_cache.db_generation_ = db_generation;
+  }
+  return &tls_cache.cache_;
+}
+
+void GeoipProvider::LookupNetwork::narrow(const MMDB_s& mmdb,
+                                          const Network::Address::Instance& address,
+                                          const MMDB_lookup_result_s& mmdb_lookup_result,
+                                          int mmdb_error) {
+  if (mmdb_error) {
+    cacheable_ = false;
+    return;
+  }
+  // The IPv4 addresses are looked up in the IPv4-mapped IPv6 network of IPv6 databases.
+  uint32_t prefix_len = mmdb_lookup_result.netmask;
+  if (address.ip()->version() == Network::Address::IpVersion::v4 &&
+      mmdb.metadata.ip_version == 6) {
+    prefix_len = prefix_len > 96 ? prefix_len - 96 : 0;
+  }
+  prefix_len_ = std::max(prefix_len_, prefix_len);
+}
+
 void GeoipProvider::lookupInCityDb(
     const Network::Address::InstanceConstSharedPtr& remote_address,
-    absl::flat_hash_map<std::string, std::string>& lookup_result) const {
+    absl::flat_hash_map<std::string, std::string>& lookup_result, LookupNetwork& network) const {
   // Country lookup falls back to City DB only if Country DB is not configured.
   const bool should_lookup_country_from_city_db =
       !config_->isCountryDbPathSet() && config_->isLookupEnabledForHeader(config_->countryHeader());
@@ -217,12 +277,14 @@ void GeoipProvider::lookupInCityDb(
     synchronizer_.syncPoint(std::string(CITY_DB_TYPE).append("_lookup_pre_complete"));
     if (!city_db_ptr) {
       IS_ENVOY_BUG("Maxmind city database must be initialised for performing lookups");
+      network.cacheable_ = false;
       return;
     }
     auto city_db = city_db_ptr.get();
     MMDB_lookup_result_s mmdb_lookup_result = MMDB_lookup_sockaddr(
         city_db->mmdb(), reinterpret_cast<const sockaddr*>(remote_address->sockAddr()),
         &mmdb_error);
+    network.narrow(*city_db->mmdb(), *remote_address, mmdb_lookup_result, mmdb_error);
     const uint32_t n_prev_hits = lookup_result.size();
     if (!mmdb_error && mmdb_lookup_result.found_entry) {
       MMDB_entry_data_list_s* entry_data_list;
@@ -248,6 +310,9 @@ void GeoipProvider::lookupInCityDb(
           config_->incHit(CITY_DB_TYPE);
         }
         MMDB_free_entry_data_list(entry_data_list);
+      } else {
+        // The entry could not be decoded, so that its empty result is not cached for the network.
+        network.cacheable_ = false;
       }
 
     } else {
@@ -259,7 +324,7 @@ void GeoipProvider::lookupInCityDb(
 
 void GeoipProvider::lookupInAsnDb(
     const Network::Address::InstanceConstSharedPtr& remote_address,
-    absl::flat_hash_map<std::string, std::string>& lookup_result) const {
+    absl::flat_hash_map<std::string, std::string>& lookup_result, LookupNetwork& network) const {
   if (config_->isLookupEnabledForHeader(config_->asnHeader()) ||
       config_->isLookupEnabledForHeader(config_->asnOrgHeader())) {
     int mmdb_error;
@@ -273,11 +338,13 @@ void GeoipProvider::lookupInAsnDb(
         return;
       }
       IS_ENVOY_BUG("Maxmind asn database must be initialised for performing lookups");
+      network.cacheable_ = false;
       return;
     }
     MMDB_lookup_result_s mmdb_lookup_result = MMDB_lookup_sockaddr(
         asn_db_ptr->mmdb(), reinterpret_cast<const sockaddr*>(remote_address->sockAddr()),
         &mmdb_error);
+    network.narrow(*asn_db_ptr->mmdb(), *remote_address, mmdb_lookup_result, mmdb_error);
     const uint32_t n_prev_hits = lookup_result.size();
     if (!mmdb_error && mmdb_lookup_result.found_entry) {
       MMDB_entry_data_list_s* entry_data_list;
@@ -297,6 +364,7 @@ void GeoipProvider::lookupInAsnDb(
           config_->incHit(ASN_DB_TYPE);
         }
       } else {
+        network.cacheable_ = false;
         config_->incLookupError(ASN_DB_TYPE);
       }
     }
@@ -306,7 +374,7 @@ void GeoipProvider::lookupInAsnDb(
 
 void GeoipProvider::lookupInAnonDb(
     const Network::Address::InstanceConstSharedPtr& remote_address,
-    absl::flat_hash_map<std::string, std::string>& lookup_result) const {
+    absl::flat_hash_map<std::string, std::string>& lookup_result, LookupNetwork& network) const {
   if (config_->isLookupEnabledForHeader(config_->anonHeader()) || config_->anonVpnHeader()) {
     int mmdb_error;
     auto anon_db_ptr = getAnonDb();
@@ -314,12 +382,14 @@ void GeoipProvider::lookupInAnonDb(
     synchronizer_.syncPoint(std::string(ANON_DB_TYPE).append("_lookup_pre_complete"));
     if (!anon_db_ptr) {
       IS_ENVOY_BUG("Maxmind anon database must be initialised for performing lookups");
+      network.cacheable_ = false;
       return;
     }
     auto anon_db = anon_db_ptr.get();
     MMDB_lookup_result_s mmdb_lookup_result = MMDB_lookup_sockaddr(
         anon_db->mmdb(), reinterpret_cast<const sockaddr*>(remote_address->sockAddr()),
         &mmdb_error);
+    network.narrow(*anon_db->mmdb(), *remote_address, mmdb_lookup_result, mmdb_error);
     const uint32_t n_prev_hits = lookup_result.size();
     if (!mmdb_error && mmdb_lookup_result.found_entry) {
       MMDB_entry_data_list_s* entry_data_list;
@@ -350,6 +420,7 @@ void GeoipProvider::lookupInAnonDb(
         }
         MMDB_free_entry_data_list(entry_data_list);
       } else {
+        network.cacheable_ = false;
         config_->incLookupError(ANON_DB_TYPE);
       }
     }
@@ -359,7 +430,7 @@ void GeoipProvider::lookupInAnonDb(
 
 void GeoipProvider::lookupInIspDb(
     const Network::Address::InstanceConstSharedPtr& remote_address,
-    absl::flat_hash_map<std::string, std::string>& lookup_result) const {
+    absl::flat_hash_map<std::string, std::string>& lookup_result, LookupNetwork& network) const {
   if (config_->isLookupEnabledForHeader(config_->ispHeader()) ||
       config_->isLookupEnabledForHeader(config_->applePrivateRelayHeader()) ||
       (!config_->isAsnDbPathSet() &&
@@ -371,11 +442,13 @@ void GeoipProvider::lookupInIspDb(
     synchronizer_.syncPoint(std::string(ISP_DB_TYPE).append("_lookup_pre_complete"));
     if (!isp_db_ptr) {
       IS_ENVOY_BUG("Maxmind isp database must be initialised for performing lookups");
+      network.cacheable_ = false;
       return;
     }
     auto isp_db = isp_db_ptr.get();
     MMDB_lookup_result_s mmdb_lookup_result = MMDB_lookup_sockaddr(
         isp_db->mmdb(), reinterpret_cast<const sockaddr*>(remote_address->sockAddr()), &mmdb_error);
+    network.narrow(*isp_db->mmdb(), *remote_address, mmdb_lookup_result, mmdb_error);
     const uint32_t n_prev_hits = lookup_result.size();
     if (!mmdb_error && mmdb_lookup_result.found_entry) {
       MMDB_entry_data_list_s* entry_data_list;
@@ -411,6 +484,7 @@ void GeoipProvider::lookupInIspDb(
         }
         MMDB_free_entry_data_list(entry_data_list);
       } else {
+        network.cacheable_ = false;
         config_->incLookupError(ISP_DB_TYPE);
       }
     }
@@ -420,7 +494,7 @@ void GeoipProvider::lookupInIspDb(
 
 void GeoipProvider::lookupInCountryDb(
     const Network::Address::InstanceConstSharedPtr& remote_address,
-    absl::flat_hash_map<std::string, std::string>& lookup_result) const {
+    absl::flat_hash_map<std::string, std::string>& lookup_result, LookupNetwork& network) const {
   if (config_->isLookupEnabledForHeader(config_->countryHeader())) {
     // Country DB takes precedence if configured, otherwise fall back to City DB.
     if (!config_->isCountryDbPathSet()) {
@@ -438,12 +512,14 @@ void GeoipProvider::lookupInCountryDb(
         return;
       }
       IS_ENVOY_BUG("Maxmind country database must be initialised for performing lookups");
+      network.cacheable_ = false;
       return;
     }
     auto country_db = country_db_ptr.get();
     MMDB_lookup_result_s mmdb_lookup_result = MMDB_lookup_sockaddr(
         country_db->mmdb(), reinterpret_cast<const sockaddr*>(remote_address->sockAddr()),
         &mmdb_error);
+    network.narrow(*country_db->mmdb(), *remote_address, mmdb_lookup_result, mmdb_error);
     const uint32_t n_prev_hits = lookup_result.size();
     if (!mmdb_error && mmdb_lookup_result.found_entry) {
       MMDB_entry_data_list_s* entry_data_list;
@@ -456,6 +532,7 @@ void GeoipProvider::lookupInCountryDb(
         }
         MMDB_free_entry_data_list(entry_data_list);
       } else {
+        network.cacheable_ = false;
         config_->incLookupError(COUNTRY_DB_TYPE);
       }
     }
@@ -508,6 +585,8 @@ absl::Status GeoipProvider::mmdbReload(const MaxmindDbSharedPtr reloaded_db,
       ENVOY_LOG(error, "Unsupported maxmind db type {}", db_type);
       return absl::InvalidArgumentError(fmt::format("Unsupported maxmind db type {}", db_type));
     }
+    // The workers drop the results cached from the previous database on their next lookup.
+    db_generation_.fetch_add(1, std::memory_order_release);
   } else {
     config_->incDbReloadError(db_type);
   }
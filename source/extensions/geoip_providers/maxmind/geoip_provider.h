@@ -1,11 +1,15 @@
 #pragma once
 
+#include <atomic>
+
 #include "envoy/common/platform.h"
 #include "envoy/extensions/geoip_providers/maxmind/v3/maxmind.pb.h"
 #include "envoy/geoip/geoip_provider_driver.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "source/common/common/logger.h"
 #include "source/common/common/thread_synchronizer.h"
+#include "source/extensions/geoip_providers/maxmind/lookup_cache.h"
 
 #include "maxminddb.h"
 
@@ -24,6 +28,7 @@ public:
   const std::optional<std::string>& anonDbPath() const { return anon_db_path_; }
   const std::optional<std::string>& asnDbPath() const { return asn_db_path_; }
   const std::optional<std::string>& countryDbPath() const { return country_db_path_; }
+  const std::optional<uint32_t>& lookupCacheSize() const { return lookup_cache_size_; }
 
   bool isLookupEnabledForHeader(const std::optional<std::string>& header);
   bool isAsnDbPathSet() const { return asn_db_path_.has_value(); }
@@ -77,6 +82,14 @@ public:
         value);
   }
 
+  void incLookupCacheHit() {
+    incCounter(stat_name_set_->getBuiltin("lookup_cache.hit", unknown_hit_));
+  }
+
+  void incLookupCacheMiss() {
+    incCounter(stat_name_set_->getBuiltin("lookup_cache.miss", unknown_hit_));
+  }
+
   void registerGeoDbStats(const absl::string_view& db_type);
 
   Stats::Scope& getStatsScopeForTest() const { return *stats_scope_; }
@@ -87,6 +100,7 @@ private:
   std::optional<std::string> anon_db_path_;
   std::optional<std::string> asn_db_path_;
   std::optional<std::string> country_db_path_;
+  std::optional<uint32_t> lookup_cache_size_;
 
   std::optional<std::string> country_header_;
   std::optional<std::string> city_header_;
@@ -125,12 +139,22 @@ private:
 };
 
 using MaxmindDbSharedPtr = std::shared_ptr<MaxmindDb>;
+
+// The lookup results cached by a worker.
+struct ThreadLocalLookupCache : public ThreadLocal::ThreadLocalObject {
+  explicit ThreadLocalLookupCache(uint32_t max_entries) : cache_(max_entries) {}
+
+  LookupCache cache_;
+  // The generation of the databases the cached results were looked up in.
+  uint64_t db_generation_{0};
+};
+
 class GeoipProvider : public Envoy::Geolocation::Driver,
                       public Logger::Loggable<Logger::Id::geolocation> {
 
 public:
-  GeoipProvider(Event::Dispatcher& dispatcher, Api::Api& api, Singleton::InstanceSharedPtr owner,
-                GeoipProviderConfigSharedPtr config);
+  GeoipProvider(Event::Dispatcher& dispatcher, Api::Api& api, ThreadLocal::SlotAllocator& tls,
+                Singleton::InstanceSharedPtr owner, GeoipProviderConfigSharedPtr config);
 
   ~GeoipProvider() override;
 
@@ -147,21 +171,40 @@ private:
   MaxmindDbSharedPtr anon_db_ ABSL_GUARDED_BY(mmdb_mutex_);
   MaxmindDbSharedPtr asn_db_ ABSL_GUARDED_BY(mmdb_mutex_);
   MaxmindDbSharedPtr country_db_ ABSL_GUARDED_BY(mmdb_mutex_);
+  // Incremented once a reloaded database is in use, for the workers to drop their cached results.
+  std::atomic<uint64_t> db_generation_{0};
+  ThreadLocal::TypedSlotPtr<ThreadLocalLookupCache> lookup_cache_slot_;
   Thread::ThreadPtr mmdb_reload_thread_;
   Event::DispatcherPtr mmdb_reload_dispatcher_;
   Filesystem::WatcherPtr mmdb_watcher_;
+  // The network of a looked up address over which the databases return the same records.
+  struct LookupNetwork {
+    uint32_t prefix_len_{0};
+    // Whether the result of the lookup may be cached for the network.
+    bool cacheable_{true};
+
+    // Narrows the network to the network of the record looked up in a database, if any.
+    void narrow(const MMDB_s& mmdb, const Network::Address::Instance& address,
+                const MMDB_lookup_result_s& mmdb_lookup_result, int mmdb_error);
+  };
+  LookupCache* lookupCache(const Network::Address::Instance& address) const;
   MaxmindDbSharedPtr initMaxmindDb(const std::string& db_path, const absl::string_view& db_type,
                                    bool reload = false);
   void lookupInCityDb(const Network::Address::InstanceConstSharedPtr& remote_address,
-                      absl::flat_hash_map<std::string, std::string>& lookup_result) const;
+                      absl::flat_hash_map<std::string, std::string>& lookup_result,
+                      LookupNetwork& network) const;
   void lookupInAsnDb(const Network::Address::InstanceConstSharedPtr& remote_address,
-                     absl::flat_hash_map<std::string, std::string>& lookup_result) const;
+                     absl::flat_hash_map<std::string, std::string>& lookup_result,
+                     LookupNetwork& network) const;
   void lookupInAnonDb(const Network::Address::InstanceConstSharedPtr& remote_address,
-                      absl::flat_hash_map<std::string, std::string>& lookup_result) const;
+                      absl::flat_hash_map<std::string, std::string>& lookup_result,
+                      LookupNetwork& network) const;
   void lookupInIspDb(const Network::Address::InstanceConstSharedPtr& remote_address,
-                     absl::flat_hash_map<std::string, std::string>& lookup_result) const;
+                     absl::flat_hash_map<std::string, std::string>& lookup_result,
+                     LookupNetwork& network) const;
   void lookupInCountryDb(const Network::Address::InstanceConstSharedPtr& remote_address,
-                         absl::flat_hash_map<std::string, std::string>& lookup_result) const;
+                         absl::flat_hash_map<std::string, std::string>& lookup_result,
+                         LookupNetwork& network) const;
   absl::Status onMaxmindDbUpdate(const std::string& db_path, const absl::string_view& db_type);
   absl::Status mmdbReload(const MaxmindDbSharedPtr reloaded_db, const absl::string_view& db_type)
       ABSL_LOCKS_EXCLUDED(mmdb_mutex_);
@@ -0,0 +1,75 @@
+#include "source/extensions/geoip_providers/maxmind/lookup_cache.h"
+
+#include <algorithm>
+
+#include "envoy/common/platform.h"
+
+#include "source/common/network/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace GeoipProviders {
+namespace Maxmind {
+
+LookupCache::NetworkKey LookupCache::networkKey(const Network::Address::Ip& address,
+                                                uint32_t prefix_len) {
+  const bool v6 = address.version() == Network::Address::IpVersion::v6;
+  const uint32_t width = v6 ? 128 : 32;
+  absl::uint128 bits = v6 ? Network::Utility::Ip6ntohl(address.ipv6()->address())
+                          : absl::uint128(ntohl(address.ipv4()->address()));
+  if (prefix_len == 0) {
+    bits = 0;
+  } else if (prefix_len < width) {
+    bits &= ~((absl::uint128(1) << (width - prefix_len)) - 1);
+  }
+  return {bits, std::min(prefix_len, width), v6};
+}
+
+const LookupResultMap* LookupCache::find(const Network::Address::Ip& address) {
+  const bool v6 = address.version() == Network::Address::IpVersion::v6;
+  // All the cached results were looked up in the same databases, so that the result of any cached
+  // network containing the address is its result.
+  for (const auto& [prefix_len, count] : prefix_lengths_[v6]) {
+    const auto it = index_.find(networkKey(address, prefix_len));
+    if (it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return &it->second->result_;
+    }
+  }
+  return nullptr;
+}
+
+void LookupCache::insert(const Network::Address::Ip& address, uint32_t prefix_len,
+                         LookupResultMap result) {
+  if (max_entries_ == 0) {
+    return;
+  }
+  const NetworkKey key = networkKey(address, prefix_len);
+  if (index_.contains(key)) {
+    return;
+  }
+  if (entries_.size() >= max_entries_) {
+    const NetworkKey& evicted = entries_.back().network_;
+    auto count = prefix_lengths_[evicted.v6_].find(evicted.prefix_len_);
+    if (--count->second == 0) {
+      prefix_lengths_[evicted.v6_].erase(count);
+    }
+    index_.erase(evicted);
+    entries_.pop_back();
+  }
+  entries_.push_front(Entry{key, std::move(result)});
+  index_.emplace(key, entries_.begin());
+  prefix_lengths_[key.v6_][key.prefix_len_]++;
+}
+
+void LookupCache::clear() {
+  index_.clear();
+  entries_.clear();
+  prefix_lengths_[0].clear();
+  prefix_lengths_[1].clear();
+}
+
+} // namespace Maxmind
+} // namespace GeoipProviders
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+
+#include "envoy/network/address.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/numeric/int128.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace GeoipProviders {
+namespace Maxmind {
+
+using LookupResultMap = absl::flat_hash_map<std::string, std::string>;
+
+/**
+ * A bounded LRU cache of the lookup results of a worker. A result is cached for the network of the
+ * looked up address over which the databases return the same records, so that a single entry
+ * serves all the addresses of that network. Not thread safe.
+ */
+class LookupCache {
+public:
+  explicit LookupCache(uint32_t max_entries) : max_entries_(max_entries) {}
+
+  /**
+   * @return the result cached for a network containing the address, or nullptr if there is none.
+   * The result is valid until the cache is next modified.
+   */
+  const LookupResultMap* find(const Network::Address::Ip& address);
+
+  /**
+   * Caches the result of the lookup of an address for its network of prefix_len bits, evicting the
+   * least recently used result if the cache is full.
+   */
+  void insert(const Network::Address::Ip& address, uint32_t prefix_len, LookupResultMap result);
+
+  void clear();
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  struct NetworkKey {
+    bool operator==(const NetworkKey& other) const {
+      return address_ == other.address_ && prefix_len_ == other.prefix_len_ && v6_ == other.v6_;
+    }
+    template <typename H> friend H AbslHashValue(H h, const NetworkKey& network) {
+      return H::combine(std::move(h), network.address_, network.prefix_len_, network.v6_);
+    }
+
+    // The network address, in host byte order.
+    absl::uint128 address_;
+    uint32_t prefix_len_;
+    bool v6_;
+  };
+
+  struct Entry {
+    NetworkKey network_;
+    LookupResultMap result_;
+  };
+
+  static NetworkKey networkKey(const Network::Address::Ip& address, uint32_t prefix_len);
+
+  const uint32_t max_entries_;
+  // The entries from the most to the least recently used.
+  std::list<Entry> entries_;
+  absl::flat_hash_map<NetworkKey, std::list<Entry>::iterator> index_;
+  // The number of entries by prefix length, for each address family, which are the prefix lengths
+  // to look an address up with.
+  absl::flat_hash_map<uint32_t, uint32_t> prefix_lengths_[2];
+};
+
+} // namespace Maxmind
+} // namespace GeoipProviders
+} // namespace Extensions
+} // namespace Envoy
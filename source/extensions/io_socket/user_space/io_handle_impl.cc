@@ -260,6 +260,12 @@ bool IoHandleImpl::supportsMmsg() const { return false; }
 
 bool IoHandleImpl::supportsUdpGro() const { return false; }
 
+bool IoHandleImpl::supportsSplice() const { return false; }
+
+Api::IoCallUint64Result IoHandleImpl::splice(os_fd_t, bool, uint64_t) {
+  return {0, Network::IoSocketError::create(SOCKET_ERROR_NOT_SUP)};
+}
+
 Api::SysCallIntResult IoHandleImpl::bind(Network::Address::InstanceConstSharedPtr) {
   return makeInvalidSyscallResult();
 }
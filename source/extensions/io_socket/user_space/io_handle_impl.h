@@ -69,6 +69,8 @@ public:
   Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
   bool supportsMmsg() const override;
   bool supportsUdpGro() const override;
+  bool supportsSplice() const override;
+  Api::IoCallUint64Result splice(os_fd_t pipe_fd, bool from_handle, uint64_t max_length) override;
   Api::SysCallIntResult bind(Network::Address::InstanceConstSharedPtr address) override;
   Api::SysCallIntResult listen(int backlog) override;
   Network::IoHandlePtr accept(struct sockaddr* addr, socklen_t* addrlen) override;
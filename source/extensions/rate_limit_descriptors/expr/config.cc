@@ -31,8 +31,8 @@ public:
   bool populateDescriptor(RateLimit::DescriptorEntry& descriptor_entry, const std::string&,
                           const Http::RequestHeaderMap& headers,
                           const StreamInfo::StreamInfo& info) const override {
-    Protobuf::Arena arena;
-    const auto result = compiled_expr_.evaluate(arena, nullptr, info, &headers, nullptr, nullptr);
+    const auto result =
+        compiled_expr_.evaluateReusingActivation(nullptr, info, &headers, nullptr, nullptr);
     if (!result.has_value() || result.value().IsError()) {
       // If result is an error and if skip_if_error is true skip this descriptor,
       // while calling rate limiting service. If skip_if_error is false, do not call rate limiting
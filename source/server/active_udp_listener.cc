@@ -44,6 +44,18 @@ void ActiveUdpListenerBase::post(Network::UdpRecvData&& data) {
   });
 }
 
+void ActiveUdpListenerBase::postCallback(
+    std::function<void(Network::UdpListenerCallbacksOptRef)> cb) {
+  ASSERT(!udp_listener_->dispatcher().isThreadSafe(),
+         "Shouldn't be posting if thread safe; call the listener directly instead.");
+
+  auto address = listen_socket_.connectionInfoProvider().localAddress();
+  udp_listener_->dispatcher().post(
+      [cb = std::move(cb), tag = config_->listenerTag(), &parent = parent_, address]() {
+        cb(parent.getUdpListenerCallbacks(tag, *address));
+      });
+}
+
 void ActiveUdpListenerBase::onData(Network::UdpRecvData&& data) {
   uint32_t dest = worker_index_;
 
@@ -36,6 +36,7 @@ public:
   void onData(Network::UdpRecvData&& data) final;
   uint32_t workerIndex() const final { return worker_index_; }
   void post(Network::UdpRecvData&& data) final;
+  void postCallback(std::function<void(Network::UdpListenerCallbacksOptRef)> cb) final;
   void onDatagramsDropped(uint32_t dropped) final {
     udp_stats_.downstream_rx_datagram_dropped_.add(dropped);
   }
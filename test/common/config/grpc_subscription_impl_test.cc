@@ -1,8 +1,12 @@
+#include "source/common/config/decoded_resource_impl.h"
+
 #include "test/common/config/grpc_subscription_test_harness.h"
+#include "test/test_common/test_runtime.h"
 
 #include "gtest/gtest.h"
 
 using testing::InSequence;
+using testing::Invoke;
 using testing::Return;
 
 namespace Envoy {
@@ -109,6 +113,154 @@ TEST_P(GrpcSubscriptionImplTest, UpdateTimeChangedOnUpdateSuccess) {
   EXPECT_TRUE(statsAre(2, 2, 0, 0, 0, TEST_TIME_MILLIS + 1, 7148434200721666028, "0"));
 }
 
+class GrpcSubscriptionSkipUnchangedTest : public testing::Test {
+public:
+  GrpcSubscriptionSkipUnchangedTest()
+      : resource_decoder_(std::make_shared<TestUtility::TestOpaqueResourceDecoderImpl<
+                              envoy::config::endpoint::v3::ClusterLoadAssignment>>("cluster_name")),
+        stats_(Utility::generateStats(*stats_store_.rootScope())) {
+    SubscriptionOptions options;
+    options.skip_unchanged_resources_ = true;
+    createSubscription(options);
+  }
+
+  void createSubscription(const SubscriptionOptions& options) {
+    subscription_ = std::make_unique<GrpcSubscriptionImpl>(
+        std::make_shared<NiceMock<MockGrpcMux>>(), callbacks_, resource_decoder_, stats_,
+        Config::TestTypeUrl::get().ClusterLoadAssignment, dispatcher_,
+        std::chrono::milliseconds(0), false, options);
+  }
+
+  // Delivers a state-of-the-world update with one resource per (name, overprovisioning factor).
+  absl::Status deliver(const std::vector<std::pair<std::string, uint32_t>>& contents,
+                       const std::string& version) {
+    std::vector<DecodedResourcePtr> resources;
+    std::vector<DecodedResourceRef> refs;
+    for (const auto& [name, factor] : contents) {
+      auto load_assignment = std::make_unique<envoy::config::endpoint::v3::ClusterLoadAssignment>();
+      load_assignment->set_cluster_name(name);
+      load_assignment->mutable_policy()->mutable_overprovisioning_factor()->set_value(factor);
+      resources.push_back(std::make_unique<DecodedResourceImpl>(std::move(load_assignment), name,
+                                                                std::vector<std::string>{},
+                                                                version));
+      refs.emplace_back(*resources.back());
+    }
+    return subscription_->onConfigUpdate(refs, version);
+  }
+
+  // Expects the next update to be delivered as a delta with the given names.
+  void expectDelta(const std::vector<std::string>& added, const std::vector<std::string>& removed,
+                   const std::string& version) {
+    EXPECT_CALL(callbacks_, onConfigUpdate(_, _, version))
+        .WillOnce(Invoke([added, removed](
+                             const std::vector<DecodedResourceRef>& added_resources,
+                             const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                             const std::string&) {
+          std::vector<std::string> added_names;
+          for (const auto& resource : added_resources) {
+            added_names.push_back(resource.get().name());
+          }
+          EXPECT_EQ(added, added_names);
+          EXPECT_EQ(removed, std::vector<std::string>(removed_resources.begin(),
+                                                      removed_resources.end()));
+          return absl::OkStatus();
+        }));
+  }
+
+  uint64_t skipped() { return stats_store_.counter("update_unchanged_resources_skipped").value(); }
+
+  Stats::TestUtil::TestStore stats_store_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<MockSubscriptionCallbacks> callbacks_;
+  OpaqueResourceDecoderSharedPtr resource_decoder_;
+  SubscriptionStats stats_;
+  std::unique_ptr<GrpcSubscriptionImpl> subscription_;
+};
+
+// The first update is delivered in full, and later ones only carry what changed.
+TEST_F(GrpcSubscriptionSkipUnchangedTest, DeliversOnlyChangedResources) {
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1")).WillOnce(Return(absl::OkStatus()));
+  EXPECT_TRUE(deliver({{"a", 100}, {"b", 100}, {"c", 100}}, "1").ok());
+  EXPECT_EQ(0, skipped());
+
+  // "b" changed, "c" was removed and "d" was added.
+  expectDelta({"b", "d"}, {"c"}, "2");
+  EXPECT_TRUE(deliver({{"a", 100}, {"b", 120}, {"d", 100}}, "2").ok());
+  EXPECT_EQ(1, skipped());
+
+  // Nothing changed, but the version is still delivered.
+  expectDelta({}, {}, "3");
+  EXPECT_TRUE(deliver({{"a", 100}, {"b", 120}, {"d", 100}}, "3").ok());
+  EXPECT_EQ(4, skipped());
+  EXPECT_EQ(3, stats_store_.counter("update_success").value());
+}
+
+// A rejected update may have been partially applied, so the next one is delivered in full.
+TEST_F(GrpcSubscriptionSkipUnchangedTest, RejectedUpdateIsFollowedByFullUpdate) {
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1")).WillOnce(Return(absl::OkStatus()));
+  EXPECT_TRUE(deliver({{"a", 100}, {"b", 100}}, "1").ok());
+
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _, "2"))
+      .WillOnce(Return(absl::InvalidArgumentError("bad config")));
+  EXPECT_FALSE(deliver({{"a", 100}, {"b", 120}}, "2").ok());
+
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "3")).WillOnce(Return(absl::OkStatus()));
+  EXPECT_TRUE(deliver({{"a", 100}, {"b", 120}}, "3").ok());
+  EXPECT_EQ(1, skipped());
+}
+
+// Updates with duplicate resource names are delivered in full so that the subscriber can reject
+// them.
+TEST_F(GrpcSubscriptionSkipUnchangedTest, DuplicateNamesAreDeliveredInFull) {
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1")).WillOnce(Return(absl::OkStatus()));
+  EXPECT_TRUE(deliver({{"a", 100}}, "1").ok());
+
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "2")).WillOnce(Return(absl::OkStatus()));
+  EXPECT_TRUE(deliver({{"a", 100}, {"a", 100}}, "2").ok());
+  EXPECT_EQ(0, skipped());
+}
+
+// Unchanged resources that the subscriber dropped on its own are delivered again.
+TEST_F(GrpcSubscriptionSkipUnchangedTest, DeliversResourcesDroppedBySubscriber) {
+  absl::flat_hash_set<std::string> current_names;
+  SubscriptionOptions options;
+  options.skip_unchanged_resources_ = true;
+  options.current_resource_names_ = [&current_names]() { return current_names; };
+  createSubscription(options);
+
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1")).WillOnce(Return(absl::OkStatus()));
+  EXPECT_TRUE(deliver({{"a", 100}, {"b", 100}}, "1").ok());
+
+  // "b" was removed by the subscriber, e.g. after failing to warm.
+  current_names = {"a"};
+  expectDelta({"b"}, {}, "2");
+  EXPECT_TRUE(deliver({{"a", 100}, {"b", 100}}, "2").ok());
+  EXPECT_EQ(1, skipped());
+
+  current_names = {"a", "b"};
+  expectDelta({}, {}, "3");
+  EXPECT_TRUE(deliver({{"a", 100}, {"b", 100}}, "3").ok());
+  EXPECT_EQ(3, skipped());
+}
+
+TEST_F(GrpcSubscriptionSkipUnchangedTest, RuntimeGuardDisabled) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.xds_sotw_skip_unchanged_resources", "false"}});
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _)).Times(2).WillRepeatedly(Return(absl::OkStatus()));
+  EXPECT_TRUE(deliver({{"a", 100}}, "1").ok());
+  EXPECT_TRUE(deliver({{"a", 100}}, "2").ok());
+  EXPECT_EQ(0, skipped());
+
+  // No baseline was kept while the guard was off, so the first update after it is turned on is
+  // delivered in full.
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.xds_sotw_skip_unchanged_resources", "true"}});
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "3")).WillOnce(Return(absl::OkStatus()));
+  EXPECT_TRUE(deliver({{"a", 100}}, "3").ok());
+  EXPECT_EQ(0, skipped());
+}
+
 } // namespace
 } // namespace Config
 } // namespace Envoy
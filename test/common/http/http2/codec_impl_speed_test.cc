@@ -0,0 +1,176 @@
+// Benchmarks for sending large amounts of DATA over HTTP/2, such as large downloads and gRPC
+// streams with messages of 1 MiB and more. Each benchmark runs with and without slice-aligned DATA
+// frames.
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/http2/codec_impl.h"
+#include "source/common/http/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/common/http/http2/codec_impl_test_util.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+// Flow control windows large enough for the benchmarks to measure the data path rather than
+// WINDOW_UPDATE round trips.
+constexpr uint32_t WindowSize = 64 * 1024 * 1024;
+
+// A server and a client codec connected back to back, with a single stream over which the server
+// sends response data to the client.
+class BackToBackCodecs {
+public:
+  explicit BackToBackCodecs(bool slice_aligned_data_frames) {
+    scoped_runtime_.mergeValues({{"envoy.reloadable_features.http2_slice_aligned_data_frames",
+                                  slice_aligned_data_frames ? "true" : "false"}});
+    envoy::config::core::v3::Http2ProtocolOptions options;
+    options.mutable_initial_stream_window_size()->set_value(WindowSize);
+    options.mutable_initial_connection_window_size()->set_value(WindowSize);
+    options.mutable_max_outbound_frames()->set_value(1000000);
+    http2_options_ = ::Envoy::Http2::Utility::initializeAndValidateOptions(options).value();
+
+    ON_CALL(client_connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) { server_buffer_.move(data); }));
+    ON_CALL(server_connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) { client_buffer_.move(data); }));
+    ON_CALL(server_connection_.dispatcher_, trackedObjectStackIsEmpty())
+        .WillByDefault(Return(true));
+    ON_CALL(server_callbacks_, newStream(_, _))
+        .WillByDefault(Invoke([this](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+          response_encoder_ = &encoder;
+          return request_decoder_;
+        }));
+    ON_CALL(request_decoder_, getRequestDecoderHandle()).WillByDefault(Invoke([this]() {
+      auto handle = std::make_unique<NiceMock<MockRequestDecoderHandle>>();
+      ON_CALL(*handle, get()).WillByDefault(Return(OptRef<RequestDecoder>(request_decoder_)));
+      return handle;
+    }));
+
+    client_ = std::make_unique<TestClientConnectionImpl>(
+        client_connection_, client_callbacks_, *stats_store_.rootScope(), http2_options_, random_,
+        DEFAULT_MAX_REQUEST_HEADERS_KB, DEFAULT_MAX_HEADERS_COUNT,
+        ProdNghttp2SessionFactory::get());
+    server_ = std::make_unique<TestServerConnectionImpl>(
+        server_connection_, server_callbacks_, *stats_store_.rootScope(), http2_options_, random_,
+        DEFAULT_MAX_REQUEST_HEADERS_KB, DEFAULT_MAX_HEADERS_COUNT,
+        envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+
+    TestRequestHeaderMapImpl request_headers;
+    HttpTestUtility::addDefaultHeaders(request_headers);
+    client_->newStream(response_decoder_).encodeHeaders(request_headers, true).IgnoreError();
+    drive();
+    TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+    response_encoder_->encodeHeaders(response_headers, false);
+    drive();
+  }
+
+  // Sends `data` from the server to the client, and returns once the client has decoded it.
+  void sendResponseData(Buffer::Instance& data) {
+    response_encoder_->encodeData(data, false);
+    drive();
+  }
+
+private:
+  void drive() {
+    while (server_buffer_.length() > 0 || client_buffer_.length() > 0 ||
+           server_->wantsToWrite() || client_->wantsToWrite()) {
+      server_->dispatch(server_buffer_).IgnoreError();
+      client_->dispatch(client_buffer_).IgnoreError();
+    }
+  }
+
+  TestScopedRuntime scoped_runtime_;
+  envoy::config::core::v3::Http2ProtocolOptions http2_options_;
+  Stats::IsolatedStoreImpl stats_store_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<Network::MockConnection> client_connection_;
+  NiceMock<Network::MockConnection> server_connection_;
+  NiceMock<MockConnectionCallbacks> client_callbacks_;
+  NiceMock<MockServerConnectionCallbacks> server_callbacks_;
+  NiceMock<MockResponseDecoder> response_decoder_;
+  NiceMock<MockRequestDecoder> request_decoder_;
+  Buffer::OwnedImpl client_buffer_;
+  Buffer::OwnedImpl server_buffer_;
+  std::unique_ptr<TestClientConnectionImpl> client_;
+  std::unique_ptr<TestServerConnectionImpl> server_;
+  ResponseEncoder* response_encoder_{};
+};
+
+// Appends `length` bytes to `buffer`, as separate slices of at most `slice_size` bytes, the way
+// data read from an upstream connection is buffered.
+void addSlices(Buffer::Instance& buffer, uint64_t length, uint64_t slice_size) {
+  const std::string slice_data(slice_size, 'a');
+  for (uint64_t added = 0; added < length; added += slice_size) {
+    Buffer::OwnedImpl slice(absl::string_view(slice_data).substr(0, length - added));
+    buffer.move(slice);
+  }
+}
+
+// A 16 MiB download read from upstream in slices of range(0) bytes, with slice-aligned DATA frames
+// enabled if range(1) is non-zero.
+static void bmLargeDownload(benchmark::State& state) {
+  constexpr uint64_t BodySize = 16 * 1024 * 1024;
+  BackToBackCodecs codecs(state.range(1) != 0);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    Buffer::OwnedImpl body;
+    addSlices(body, BodySize, state.range(0));
+    state.ResumeTiming();
+    codecs.sendResponseData(body);
+  }
+  state.SetBytesProcessed(state.iterations() * BodySize);
+}
+BENCHMARK(bmLargeDownload)
+    ->Args({4096, 0})
+    ->Args({4096, 1})
+    ->Args({10000, 0})
+    ->Args({10000, 1})
+    ->Args({16384, 0})
+    ->Args({16384, 1})
+    ->Unit(benchmark::kMillisecond);
+
+// A gRPC stream of 16 messages of range(0) bytes each, serialized into slices of range(1) bytes,
+// with slice-aligned DATA frames enabled if range(2) is non-zero.
+static void bmGrpcStreaming(benchmark::State& state) {
+  constexpr uint64_t MessageCount = 16;
+  const uint64_t message_size = state.range(0);
+  BackToBackCodecs codecs(state.range(2) != 0);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (uint64_t i = 0; i < MessageCount; ++i) {
+      state.PauseTiming();
+      Buffer::OwnedImpl message;
+      // The gRPC frame header.
+      message.add(std::string(5, '\0'));
+      addSlices(message, message_size, state.range(1));
+      state.ResumeTiming();
+      codecs.sendResponseData(message);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * MessageCount * message_size);
+}
+BENCHMARK(bmGrpcStreaming)
+    ->Args({1024 * 1024, 10000, 0})
+    ->Args({1024 * 1024, 10000, 1})
+    ->Args({4 * 1024 * 1024, 10000, 0})
+    ->Args({4 * 1024 * 1024, 10000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
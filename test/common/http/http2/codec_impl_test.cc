@@ -1255,6 +1255,76 @@ TEST_P(Http2CodecImplTest, TrailingHeadersLargeClientBody) {
   driveToCompletion();
 }
 
+// DATA frames end at buffer slice boundaries so that their payload is moved to the connection
+// without being copied.
+TEST_P(Http2CodecImplTest, DataFramesEndAtSliceBoundaries) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_OK(request_encoder_->encodeHeaders(request_headers, true));
+  driveToCompletion();
+
+  TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, false));
+  response_encoder_->encodeHeaders(response_headers, false);
+  driveToCompletion();
+
+  std::vector<uint64_t> frame_sizes;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) -> void {
+        frame_sizes.push_back(data.length());
+        client_wrapper_->buffer_.add(data);
+      }));
+  // With the default maximum frame size of 16384 bytes, the first frame would otherwise end in the
+  // middle of the second slice.
+  Buffer::OwnedImpl body;
+  for (int i = 0; i < 3; ++i) {
+    Buffer::OwnedImpl slice(std::string(10000, 'a'));
+    body.move(slice);
+  }
+  ASSERT_EQ(3, body.getRawSlices().size());
+  EXPECT_CALL(response_decoder_, decodeData(_, _)).Times(AnyNumber());
+  response_encoder_->encodeData(body, true);
+  driveToCompletion();
+  // Each write is a 9 byte frame header followed by the payload.
+  EXPECT_THAT(frame_sizes, ElementsAre(10009, 10009, 10009));
+}
+
+TEST_P(Http2CodecImplTest, DataFramesEndAtSliceBoundariesDisabled) {
+  scoped_runtime_.mergeValues(
+      {{"envoy.reloadable_features.http2_slice_aligned_data_frames", "false"}});
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_OK(request_encoder_->encodeHeaders(request_headers, true));
+  driveToCompletion();
+
+  TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, false));
+  response_encoder_->encodeHeaders(response_headers, false);
+  driveToCompletion();
+
+  std::vector<uint64_t> frame_sizes;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) -> void {
+        frame_sizes.push_back(data.length());
+        client_wrapper_->buffer_.add(data);
+      }));
+  Buffer::OwnedImpl body;
+  for (int i = 0; i < 3; ++i) {
+    Buffer::OwnedImpl slice(std::string(10000, 'a'));
+    body.move(slice);
+  }
+  EXPECT_CALL(response_decoder_, decodeData(_, _)).Times(AnyNumber());
+  response_encoder_->encodeData(body, true);
+  driveToCompletion();
+  EXPECT_THAT(frame_sizes, ElementsAre(16393, 13625));
+}
+
 TEST_P(Http2CodecImplTest, SmallMetadataVecTest) {
   allow_metadata_ = true;
   initialize();
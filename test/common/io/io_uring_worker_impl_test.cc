@@ -4,9 +4,11 @@
 #include <cstring>
 #include <vector>
 
+#include "source/common/io/io_uring_impl.h"
 #include "source/common/io/io_uring_worker_impl.h"
 #include "source/common/network/address_impl.h"
 
+#include "test/common/stats/stat_test_utility.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/io/mocks.h"
 #include "test/test_common/logging.h"
@@ -1331,6 +1333,416 @@ TEST(IoUringWorkerImplTest, ServerSocketMultishotCloseKeepFdOpenCopiesData) {
   delete cancel_req;
 }
 
+// Lays out a datagram from `peer` in a provided buffer the way the kernel does for a `multishot`
+// recvmsg, and returns the completion result.
+int32_t fillDatagram(FakeIoUringBufferPool& buffer_pool, uint32_t buffer_id,
+                     const Network::Address::Instance& peer, absl::string_view payload,
+                     uint32_t flags = 0) {
+  uint8_t* buffer = buffer_pool.getBuffer(buffer_id);
+  struct io_uring_recvmsg_out out {};
+  out.namelen = peer.sockAddrLen();
+  out.payloadlen = payload.size();
+  out.flags = flags;
+  memcpy(buffer, &out, sizeof(out));
+  memcpy(buffer + sizeof(out), peer.sockAddr(), peer.sockAddrLen());
+  const size_t payload_offset =
+      sizeof(out) + sizeof(struct sockaddr_storage) + DatagramControlSpace;
+  memcpy(buffer + payload_offset, payload.data(), payload.size());
+  return payload_offset + payload.size();
+}
+
+constexpr uint32_t DatagramTestBufferSize =
+    sizeof(struct io_uring_recvmsg_out) + sizeof(struct sockaddr_storage) + DatagramControlSpace +
+    64;
+
+// A `multishot` recvmsg stays armed across completions, the datagrams received in a batch are
+// delivered with a single read event, and each buffer is recycled once its datagram is popped.
+TEST(IoUringWorkerImplTest, DatagramSocketReceive) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  auto buffer_pool = std::make_shared<FakeIoUringBufferPool>(DatagramTestBufferSize, 4);
+  Stats::TestUtil::TestStore store;
+  auto stats = std::make_shared<IoUringDatagramStats>(IoUringDatagramStats{
+      ALL_IO_URING_DATAGRAM_STATS(POOL_COUNTER_PREFIX(*store.rootScope(), "io_uring."),
+                                  POOL_HISTOGRAM_PREFIX(*store.rootScope(), "io_uring."))});
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, datagramBufferPool()).WillRepeatedly(Return(buffer_pool));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(ReturnNew<NiceMock<Event::MockFileEvent>>());
+  IoUringWorkerImpl worker(std::move(io_uring_instance), 8192, 1000, 131072, 16384, dispatcher,
+                           stats);
+  EXPECT_TRUE(worker.isDatagramEnabled());
+
+  IoUringDatagramSocketImpl* socket_ptr = nullptr;
+  std::vector<std::string> payloads;
+  std::vector<std::string> peers;
+  auto cb = [&socket_ptr, &payloads, &peers](uint32_t events) -> absl::Status {
+    EXPECT_EQ(Event::FileReadyType::Read, events);
+    while (const ReceivedDatagram* datagram = socket_ptr->frontDatagram()) {
+      payloads.emplace_back(reinterpret_cast<const char*>(datagram->payload_),
+                            datagram->payload_length_);
+      sockaddr_storage peer_addr;
+      memcpy(&peer_addr, datagram->hdr_.msg_name, datagram->hdr_.msg_namelen);
+      peers.push_back(
+          Network::Address::addressFromSockAddrOrDie(peer_addr, datagram->hdr_.msg_namelen, -1)
+              ->asString());
+      socket_ptr->popDatagram();
+    }
+    return absl::OkStatus();
+  };
+  IoUringDatagramSocketImpl socket(0, worker, cb);
+  socket_ptr = &socket;
+
+  // Enabling read arms a single `multishot` recvmsg.
+  Request* recv_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(0, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&recv_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.enableRead();
+
+  // Two datagrams received in the same batch inject a single read event.
+  Network::Address::Ipv4Instance peer1("127.0.0.1", 5000);
+  Network::Address::Ipv4Instance peer2("127.0.0.2", 6000);
+  Request* injected_req = nullptr;
+  EXPECT_CALL(mock_io_uring, injectCompletion(0, _, -EAGAIN))
+      .WillOnce(SaveArg<1>(&injected_req));
+  recv_req->setBufferId(0);
+  recv_req->setMoreCompletions(true);
+  socket.onRead(recv_req, fillDatagram(*buffer_pool, 0, peer1, "hello"), false);
+  recv_req->setBufferId(1);
+  recv_req->setMoreCompletions(true);
+  socket.onRead(recv_req, fillDatagram(*buffer_pool, 1, peer2, "world!"), false);
+  EXPECT_EQ(2, store.counter("io_uring.udp_rx_datagrams").value());
+  EXPECT_TRUE(buffer_pool->released_buffers_.empty());
+
+  // The injected read event delivers both datagrams in order and recycles their buffers.
+  socket.onRead(injected_req, -EAGAIN, true);
+  EXPECT_EQ(std::vector<std::string>({"hello", "world!"}), payloads);
+  EXPECT_EQ(std::vector<std::string>({"127.0.0.1:5000", "127.0.0.2:6000"}), peers);
+  EXPECT_EQ(std::vector<uint32_t>({0, 1}), buffer_pool->released_buffers_);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete recv_req;
+  delete injected_req;
+}
+
+// A truncated datagram is queued with MSG_TRUNC so the handler can drop it, and is counted.
+TEST(IoUringWorkerImplTest, DatagramSocketReceiveTruncated) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  auto buffer_pool = std::make_shared<FakeIoUringBufferPool>(DatagramTestBufferSize, 4);
+  Stats::TestUtil::TestStore store;
+  auto stats = std::make_shared<IoUringDatagramStats>(IoUringDatagramStats{
+      ALL_IO_URING_DATAGRAM_STATS(POOL_COUNTER_PREFIX(*store.rootScope(), "io_uring."),
+                                  POOL_HISTOGRAM_PREFIX(*store.rootScope(), "io_uring."))});
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, datagramBufferPool()).WillRepeatedly(Return(buffer_pool));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(ReturnNew<NiceMock<Event::MockFileEvent>>());
+  IoUringWorkerImpl worker(std::move(io_uring_instance), 8192, 1000, 131072, 16384, dispatcher,
+                           stats);
+  IoUringDatagramSocketImpl socket(0, worker, [](uint32_t) { return absl::OkStatus(); });
+
+  Request* recv_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(0, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&recv_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.enableRead();
+
+  Request* injected_req = nullptr;
+  EXPECT_CALL(mock_io_uring, injectCompletion(0, _, -EAGAIN))
+      .WillOnce(SaveArg<1>(&injected_req));
+  recv_req->setBufferId(2);
+  recv_req->setMoreCompletions(true);
+  Network::Address::Ipv4Instance peer("127.0.0.1", 5000);
+  socket.onRead(recv_req, fillDatagram(*buffer_pool, 2, peer, "too long", MSG_TRUNC), false);
+  EXPECT_EQ(1, store.counter("io_uring.udp_rx_datagrams").value());
+  EXPECT_EQ(1, store.counter("io_uring.udp_rx_truncated").value());
+  ASSERT_NE(nullptr, socket.frontDatagram());
+  EXPECT_NE(0, socket.frontDatagram()->hdr_.msg_flags & MSG_TRUNC);
+  socket.popDatagram();
+  EXPECT_EQ(std::vector<uint32_t>({2}), buffer_pool->released_buffers_);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete recv_req;
+  delete injected_req;
+}
+
+// Running out of provided buffers ends the `multishot` recvmsg, which is re-armed once the handler
+// pops a queued datagram.
+TEST(IoUringWorkerImplTest, DatagramSocketReceiveResumesAfterEnobufs) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  auto buffer_pool = std::make_shared<FakeIoUringBufferPool>(DatagramTestBufferSize, 1);
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, datagramBufferPool()).WillRepeatedly(Return(buffer_pool));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(ReturnNew<NiceMock<Event::MockFileEvent>>());
+  IoUringWorkerImpl worker(std::move(io_uring_instance), 8192, 1000, 131072, 16384, dispatcher);
+  IoUringDatagramSocketImpl socket(0, worker, [](uint32_t) { return absl::OkStatus(); });
+
+  Request* recv_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(0, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&recv_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.enableRead();
+
+  // The only buffer is filled, then the kernel ends the request since no buffer is left.
+  Request* injected_req = nullptr;
+  EXPECT_CALL(mock_io_uring, injectCompletion(0, _, -EAGAIN))
+      .WillOnce(SaveArg<1>(&injected_req));
+  recv_req->setBufferId(0);
+  recv_req->setMoreCompletions(true);
+  Network::Address::Ipv4Instance peer("127.0.0.1", 5000);
+  socket.onRead(recv_req, fillDatagram(*buffer_pool, 0, peer, "hello"), false);
+  recv_req->setMoreCompletions(false);
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(_, _, _)).Times(0);
+  socket.onRead(recv_req, -ENOBUFS, false);
+  delete recv_req;
+
+  // Popping the datagram frees the buffer and re-arms the receive.
+  Request* new_recv_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(0, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&new_recv_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.popDatagram();
+  EXPECT_NE(nullptr, new_recv_req);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete new_recv_req;
+  delete injected_req;
+}
+
+// The buffer pool is shared by the datagram sockets of a worker, so a socket stalled because
+// another socket holds the buffers is re-armed once that socket releases one.
+TEST(IoUringWorkerImplTest, DatagramSocketReceiveResumesWhenAnotherSocketReleasesBuffer) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  auto buffer_pool = std::make_shared<FakeIoUringBufferPool>(DatagramTestBufferSize, 1);
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, datagramBufferPool()).WillRepeatedly(Return(buffer_pool));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(ReturnNew<NiceMock<Event::MockFileEvent>>());
+  IoUringWorkerImpl worker(std::move(io_uring_instance), 8192, 1000, 131072, 16384, dispatcher);
+  IoUringDatagramSocketImpl socket1(0, worker, [](uint32_t) { return absl::OkStatus(); });
+  IoUringDatagramSocketImpl socket2(1, worker, [](uint32_t) { return absl::OkStatus(); });
+
+  Request* recv_req1 = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(0, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&recv_req1), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket1.enableRead();
+  Request* recv_req2 = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(1, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&recv_req2), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket2.enableRead();
+
+  // The first socket takes the only buffer, which stalls the second one.
+  Request* injected_req = nullptr;
+  EXPECT_CALL(mock_io_uring, injectCompletion(0, _, -EAGAIN))
+      .WillOnce(SaveArg<1>(&injected_req));
+  recv_req1->setBufferId(0);
+  recv_req1->setMoreCompletions(true);
+  Network::Address::Ipv4Instance peer("127.0.0.1", 5000);
+  socket1.onRead(recv_req1, fillDatagram(*buffer_pool, 0, peer, "hello"), false);
+  recv_req2->setMoreCompletions(false);
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(_, _, _)).Times(0);
+  socket2.onRead(recv_req2, -ENOBUFS, false);
+  delete recv_req2;
+
+  // Popping the datagram of the first socket re-arms the receive of the second one.
+  Request* new_recv_req2 = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(1, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&new_recv_req2), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket1.popDatagram();
+  EXPECT_NE(nullptr, new_recv_req2);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete recv_req1;
+  delete new_recv_req2;
+  delete injected_req;
+}
+
+// A socket on which the kernel rejects the `multishot` recvmsg reports the error to its handler.
+TEST(IoUringWorkerImplTest, DatagramSocketReceiveRejected) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  auto buffer_pool = std::make_shared<FakeIoUringBufferPool>(DatagramTestBufferSize, 1);
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, datagramBufferPool()).WillRepeatedly(Return(buffer_pool));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(ReturnNew<NiceMock<Event::MockFileEvent>>());
+  IoUringWorkerImpl worker(std::move(io_uring_instance), 8192, 1000, 131072, 16384, dispatcher);
+  IoUringDatagramSocketImpl socket(0, worker, [](uint32_t) { return absl::OkStatus(); });
+
+  Request* recv_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(0, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&recv_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.enableRead();
+  EXPECT_EQ(0, socket.recvError());
+
+  // The receive is not re-armed, and a read event is delivered for the handler to see the error.
+  Request* injected_req = nullptr;
+  EXPECT_CALL(mock_io_uring, injectCompletion(0, _, -EAGAIN))
+      .WillOnce(SaveArg<1>(&injected_req));
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(_, _, _)).Times(0);
+  recv_req->setMoreCompletions(false);
+  socket.onRead(recv_req, -EOPNOTSUPP, false);
+  EXPECT_EQ(EOPNOTSUPP, socket.recvError());
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete recv_req;
+  delete injected_req;
+}
+
+// Sends are refused once too many are in flight, and a write event is delivered once half of them
+// have completed.
+TEST(IoUringWorkerImplTest, DatagramSocketSendBackpressure) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  auto buffer_pool = std::make_shared<FakeIoUringBufferPool>(DatagramTestBufferSize, 1);
+  Stats::TestUtil::TestStore store;
+  auto stats = std::make_shared<IoUringDatagramStats>(IoUringDatagramStats{
+      ALL_IO_URING_DATAGRAM_STATS(POOL_COUNTER_PREFIX(*store.rootScope(), "io_uring."),
+                                  POOL_HISTOGRAM_PREFIX(*store.rootScope(), "io_uring."))});
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, datagramBufferPool()).WillRepeatedly(Return(buffer_pool));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(ReturnNew<NiceMock<Event::MockFileEvent>>());
+  IoUringWorkerImpl worker(std::move(io_uring_instance), 8192, 1000, 131072, 16384, dispatcher,
+                           stats);
+  uint32_t write_events = 0;
+  IoUringDatagramSocketImpl socket(0, worker, [&write_events](uint32_t events) {
+    EXPECT_EQ(Event::FileReadyType::Write, events);
+    write_events++;
+    return absl::OkStatus();
+  });
+
+  std::string payload = "hello";
+  Buffer::RawSlice slice{payload.data(), payload.size()};
+  Network::Address::Ipv4Instance peer("127.0.0.1", 5000);
+  std::vector<Request*> send_reqs;
+  EXPECT_CALL(mock_io_uring, prepareSendmsg(0, _, _))
+      .Times(IoUringDatagramSocketImpl::MaxSendsInFlight)
+      .WillRepeatedly(Invoke([&send_reqs, &payload](os_fd_t, const struct msghdr* msg,
+                                                    Request* req) {
+        // The datagram is copied, so the caller's slices may be released right away.
+        EXPECT_NE(payload.data(), msg->msg_iov[0].iov_base);
+        EXPECT_EQ(payload.size(), msg->msg_iov[0].iov_len);
+        send_reqs.push_back(req);
+        return IoUringResult::Ok;
+      }));
+  EXPECT_CALL(mock_io_uring, submit()).Times(IoUringDatagramSocketImpl::MaxSendsInFlight);
+  for (uint32_t i = 0; i < IoUringDatagramSocketImpl::MaxSendsInFlight; i++) {
+    EXPECT_EQ(payload.size(), socket.sendmsg(&slice, 1, nullptr, peer));
+  }
+  EXPECT_EQ(0, socket.sendmsg(&slice, 1, nullptr, peer));
+
+  // Completing half of the sends releases the backpressure with a single write event.
+  Request* injected_req = nullptr;
+  EXPECT_CALL(mock_io_uring, injectCompletion(0, _, -EAGAIN))
+      .WillOnce(SaveArg<1>(&injected_req));
+  for (uint32_t i = 0; i < IoUringDatagramSocketImpl::MaxSendsInFlight / 2; i++) {
+    socket.onWrite(send_reqs[i], payload.size(), false);
+  }
+  socket.onWrite(send_reqs[IoUringDatagramSocketImpl::MaxSendsInFlight / 2], -EPERM, false);
+  EXPECT_EQ(IoUringDatagramSocketImpl::MaxSendsInFlight / 2,
+            store.counter("io_uring.udp_tx_datagrams").value());
+  EXPECT_EQ(1, store.counter("io_uring.udp_tx_errors").value());
+  ASSERT_NE(nullptr, injected_req);
+  socket.onWrite(injected_req, -EAGAIN, true);
+  EXPECT_EQ(1, write_events);
+
+  for (uint32_t i = IoUringDatagramSocketImpl::MaxSendsInFlight / 2 + 1;
+       i < IoUringDatagramSocketImpl::MaxSendsInFlight; i++) {
+    socket.onWrite(send_reqs[i], payload.size(), false);
+  }
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  for (Request* req : send_reqs) {
+    delete req;
+  }
+  delete injected_req;
+}
+
+// Closing cancels the `multishot` recvmsg and waits for it and for the sends in flight to complete
+// before closing the fd.
+TEST(IoUringWorkerImplTest, DatagramSocketCloseWaitsForRequests) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  auto buffer_pool = std::make_shared<FakeIoUringBufferPool>(DatagramTestBufferSize, 1);
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, datagramBufferPool()).WillRepeatedly(Return(buffer_pool));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(ReturnNew<NiceMock<Event::MockFileEvent>>());
+  IoUringWorkerImpl worker(std::move(io_uring_instance), 8192, 1000, 131072, 16384, dispatcher);
+  IoUringDatagramSocketImpl socket(0, worker, [](uint32_t) { return absl::OkStatus(); });
+
+  Request* recv_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecvmsgMultishot(0, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&recv_req), Return<IoUringResult>(IoUringResult::Ok)));
+  Request* send_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareSendmsg(0, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&send_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(2).RetiresOnSaturation();
+  socket.enableRead();
+  std::string payload = "hello";
+  Buffer::RawSlice slice{payload.data(), payload.size()};
+  Network::Address::Ipv4Instance peer("127.0.0.1", 5000);
+  EXPECT_EQ(payload.size(), socket.sendmsg(&slice, 1, nullptr, peer));
+
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareCancel(recv_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, prepareClose(_, _)).Times(0);
+  socket.close(false);
+  socket.onCancel(cancel_req, 0, false);
+  recv_req->setMoreCompletions(false);
+  socket.onRead(recv_req, -ECANCELED, false);
+
+  // The fd is closed once the last send completes.
+  Request* close_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareClose(0, _))
+      .WillOnce(DoAll(SaveArg<1>(&close_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.onWrite(send_req, payload.size(), false);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete recv_req;
+  delete send_req;
+  delete cancel_req;
+  delete close_req;
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
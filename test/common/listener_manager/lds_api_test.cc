@@ -487,6 +487,39 @@ TEST_F(LdsApiTest, ReplacingListenerWithSameAddress) {
   EXPECT_OK(lds_callbacks_->onConfigUpdate(decoded_resources_2.refvec_, response2.version_info()));
 }
 
+// Unchanged listeners are only skipped by the subscription while the listener manager still has
+// them.
+TEST_F(LdsApiTest, CurrentResourceNamesAreTheWarmingAndActiveListeners) {
+  Config::SubscriptionOptions options;
+  EXPECT_CALL(cluster_manager_.subscription_factory_,
+              subscriptionFromConfigSource(_, _, _, _, _, _))
+      .WillOnce(Invoke([&options](const envoy::config::core::v3::ConfigSource&, absl::string_view,
+                                  Stats::Scope&, Config::SubscriptionCallbacks&,
+                                  Config::OpaqueResourceDecoderSharedPtr,
+                                  const Config::SubscriptionOptions& subscription_options)
+                           -> Config::SubscriptionPtr {
+        options = subscription_options;
+        return std::make_unique<NiceMock<Config::MockSubscription>>();
+      }));
+  envoy::config::core::v3::ConfigSource lds_config;
+  EXPECT_CALL(init_manager_, add(_));
+  lds_ = std::make_unique<LdsApiImpl>(lds_config, nullptr, xds_manager_, cluster_manager_,
+                                      init_manager_, *store_.rootScope(), listener_manager_,
+                                      validation_visitor_);
+  EXPECT_TRUE(options.skip_unchanged_resources_);
+  ASSERT_TRUE(options.current_resource_names_);
+
+  NiceMock<Network::MockListenerConfig> listener1;
+  listener1.name_ = "listener1";
+  NiceMock<Network::MockListenerConfig> listener2;
+  listener2.name_ = "listener2";
+  EXPECT_CALL(listener_manager_, listeners(ListenerManager::WARMING | ListenerManager::ACTIVE))
+      .WillOnce(Return(std::vector<std::reference_wrapper<Network::ListenerConfig>>{listener1,
+                                                                                    listener2}));
+  EXPECT_EQ((absl::flat_hash_set<std::string>{"listener1", "listener2"}),
+            options.current_resource_names_());
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy
@@ -0,0 +1,203 @@
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/io/io_uring_worker_factory_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/network/io_uring_udp_socket_handle_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/thread_local/thread_local_impl.h"
+
+#include "test/test_common/test_time.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class TestUdpPacketProcessor : public UdpPacketProcessor {
+public:
+  // UdpPacketProcessor
+  void processPacket(Address::InstanceConstSharedPtr, Address::InstanceConstSharedPtr peer_address,
+                     Buffer::InstancePtr buffer, MonotonicTime, uint8_t,
+                     Buffer::OwnedImpl) override {
+    payloads_.push_back(buffer->toString());
+    peer_addresses_.push_back(peer_address->asString());
+  }
+  void onDatagramsDropped(uint32_t dropped) override { dropped_ += dropped; }
+  uint64_t maxDatagramSize() const override { return DEFAULT_UDP_MAX_DATAGRAM_SIZE; }
+  size_t numPacketsExpectedPerEventLoop() const override { return MAX_NUM_PACKETS_PER_EVENT_LOOP; }
+  const IoHandle::UdpSaveCmsgConfig& saveCmsgConfig() const override { return save_cmsg_config_; }
+
+  std::vector<std::string> payloads_;
+  std::vector<std::string> peer_addresses_;
+  uint32_t dropped_{0};
+  IoHandle::UdpSaveCmsgConfig save_cmsg_config_;
+};
+
+class IoUringUdpSocketHandleImplIntegrationTest : public testing::TestWithParam<bool> {
+public:
+  IoUringUdpSocketHandleImplIntegrationTest() : should_skip_(!Io::isIoUringSupported()) {}
+
+  void SetUp() override {
+    if (should_skip_) {
+      GTEST_SKIP();
+    }
+    api_ = Api::createApiForTest(time_system_);
+    dispatcher_ = api_->allocateDispatcher("test_thread");
+    instance_.registerThread(*dispatcher_, true);
+    io_uring_worker_factory_ = std::make_unique<Io::IoUringWorkerFactoryImpl>(
+        10, false, false, 8192, 1000, 131072, 16384, instance_, 8);
+    io_uring_worker_factory_->onWorkerThreadInitialized();
+    if (!io_uring_worker_factory_->getIoUringWorker()->isDatagramEnabled()) {
+      // The kernel does not support `multishot` recvmsg.
+      GTEST_SKIP();
+    }
+
+    // Create an io_uring handle with a UDP socket bound to a local port.
+    const os_fd_t fd =
+        Api::OsSysCallsSingleton::get().socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP).return_value_;
+    EXPECT_GE(fd, 0);
+    io_uring_socket_handle_ =
+        std::make_unique<IoUringUdpSocketHandleImpl>(*io_uring_worker_factory_, fd);
+    auto local_addr = std::make_shared<Address::Ipv4Instance>("127.0.0.1", 0);
+    EXPECT_EQ(0, io_uring_socket_handle_->bind(local_addr).return_value_);
+    local_address_ = io_uring_socket_handle_->localAddress();
+
+    // Create a peer socket handle.
+    const os_fd_t peer_fd = Api::OsSysCallsSingleton::get()
+                                .socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP)
+                                .return_value_;
+    EXPECT_GE(peer_fd, 0);
+    peer_socket_handle_ = std::make_unique<IoSocketHandleImpl>(peer_fd);
+    EXPECT_EQ(0, peer_socket_handle_->bind(local_addr).return_value_);
+    peer_address_ = peer_socket_handle_->localAddress();
+  }
+
+  void TearDown() override {
+    if (io_uring_socket_handle_ != nullptr) {
+      io_uring_socket_handle_->close();
+    }
+    if (api_ != nullptr) {
+      instance_.shutdownGlobalThreading();
+      instance_.shutdownThread();
+    }
+  }
+
+  void sendFromPeer(absl::string_view payload) {
+    Buffer::RawSlice slice{const_cast<char*>(payload.data()), payload.size()};
+    EXPECT_EQ(payload.size(),
+              peer_socket_handle_->sendmsg(&slice, 1, 0, nullptr, *local_address_).return_value_);
+  }
+
+  bool should_skip_{false};
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Event::GlobalTimeSystem time_system_;
+  ThreadLocal::InstanceImpl instance_;
+  std::unique_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory_;
+  IoHandlePtr io_uring_socket_handle_;
+  IoHandlePtr peer_socket_handle_;
+  Address::InstanceConstSharedPtr local_address_;
+  Address::InstanceConstSharedPtr peer_address_;
+};
+
+INSTANTIATE_TEST_SUITE_P(AllowMmsg, IoUringUdpSocketHandleImplIntegrationTest, testing::Bool());
+
+// Datagrams received through the io_uring are read with recvmmsg() or recvmsg().
+TEST_P(IoUringUdpSocketHandleImplIntegrationTest, Receive) {
+  TestUdpPacketProcessor processor;
+  uint32_t packets_dropped = 0;
+  io_uring_socket_handle_->initializeFileEvent(
+      *dispatcher_,
+      [this, &processor, &packets_dropped](uint32_t events) {
+        EXPECT_EQ(Event::FileReadyType::Read, events);
+        Api::IoErrorPtr error = Utility::readPacketsFromSocket(
+            *io_uring_socket_handle_, *local_address_, processor, time_system_, false, GetParam(),
+            packets_dropped);
+        EXPECT_NE(nullptr, error);
+        EXPECT_EQ(Api::IoError::IoErrorCode::Again, error->getErrorCode());
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  sendFromPeer("hello");
+  sendFromPeer("world!");
+  while (processor.payloads_.size() < 2) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(std::vector<std::string>({"hello", "world!"}), processor.payloads_);
+  EXPECT_EQ(std::vector<std::string>({peer_address_->asString(), peer_address_->asString()}),
+            processor.peer_addresses_);
+  EXPECT_EQ(0, processor.dropped_);
+}
+
+// Datagrams larger than the processor's maximum datagram size are dropped and counted.
+TEST_P(IoUringUdpSocketHandleImplIntegrationTest, ReceiveTruncated) {
+  TestUdpPacketProcessor processor;
+  uint32_t packets_dropped = 0;
+  io_uring_socket_handle_->initializeFileEvent(
+      *dispatcher_,
+      [this, &processor, &packets_dropped](uint32_t) {
+        Utility::readPacketsFromSocket(*io_uring_socket_handle_, *local_address_, processor,
+                                       time_system_, false, GetParam(), packets_dropped)
+            .reset();
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  sendFromPeer(std::string(DEFAULT_UDP_MAX_DATAGRAM_SIZE + 1, 'a'));
+  sendFromPeer("hello");
+  while (processor.payloads_.empty()) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(std::vector<std::string>({"hello"}), processor.payloads_);
+  EXPECT_EQ(1, processor.dropped_);
+}
+
+// Datagrams sent through the io_uring reach the peer, and the slices can be released right away.
+TEST_P(IoUringUdpSocketHandleImplIntegrationTest, Send) {
+  io_uring_socket_handle_->initializeFileEvent(
+      *dispatcher_, [](uint32_t) { return absl::OkStatus(); }, Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read);
+
+  {
+    std::string payload = "hello";
+    Buffer::RawSlice slice{payload.data(), payload.size()};
+    const Address::Ip* self_ip = GetParam() ? local_address_->ip() : nullptr;
+    EXPECT_EQ(payload.size(),
+              io_uring_socket_handle_->sendmsg(&slice, 1, 0, self_ip, *peer_address_)
+                  .return_value_);
+  }
+
+  std::string received(16, '\0');
+  Api::IoCallUint64Result result(0, Api::IoError::none());
+  do {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    Buffer::RawSlice slice{received.data(), received.size()};
+    result = peer_socket_handle_->readv(received.size(), &slice, 1);
+  } while (!result.ok() && result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ("hello", received.substr(0, result.return_value_));
+}
+
+// Closing the handle closes the fd through the io_uring.
+TEST_P(IoUringUdpSocketHandleImplIntegrationTest, Close) {
+  io_uring_socket_handle_->initializeFileEvent(
+      *dispatcher_, [](uint32_t) { return absl::OkStatus(); }, Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read);
+  const os_fd_t fd = io_uring_socket_handle_->fdDoNotUse();
+  io_uring_socket_handle_->close();
+  EXPECT_FALSE(io_uring_socket_handle_->isOpen());
+
+  while (fcntl(fd, F_GETFD, 0) >= 0) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(errno, EBADF);
+  io_uring_socket_handle_.reset();
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,120 @@
+// Benchmarks for receiving bursts of UDP datagrams from a local client, with the socket API and
+// through io_uring.
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/io/io_uring_worker_factory_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/network/io_uring_udp_socket_handle_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/thread_local/thread_local_impl.h"
+
+#include "test/test_common/test_time.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class CountingUdpPacketProcessor : public UdpPacketProcessor {
+public:
+  // UdpPacketProcessor
+  void processPacket(Address::InstanceConstSharedPtr, Address::InstanceConstSharedPtr,
+                     Buffer::InstancePtr, MonotonicTime, uint8_t, Buffer::OwnedImpl) override {
+    packets_++;
+  }
+  void onDatagramsDropped(uint32_t) override {}
+  uint64_t maxDatagramSize() const override { return DEFAULT_UDP_MAX_DATAGRAM_SIZE; }
+  size_t numPacketsExpectedPerEventLoop() const override { return MAX_NUM_PACKETS_PER_EVENT_LOOP; }
+  const IoHandle::UdpSaveCmsgConfig& saveCmsgConfig() const override { return save_cmsg_config_; }
+
+  uint64_t packets_{0};
+  IoHandle::UdpSaveCmsgConfig save_cmsg_config_;
+};
+
+// A client sends bursts of range(0) datagrams of 1200 bytes, the size of a typical QUIC packet, to
+// a listener that reads them with recvmmsg(), through io_uring if range(1) is non-zero. Bursts are
+// kept small enough for the default socket receive buffer, so no datagram is dropped.
+static void bmUdpReceive(benchmark::State& state) {
+  const bool use_io_uring = state.range(1) != 0;
+  if (use_io_uring && !Io::isIoUringSupported()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+
+  Event::GlobalTimeSystem time_system;
+  Api::ApiPtr api = Api::createApiForTest(time_system);
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  ThreadLocal::InstanceImpl tls;
+  tls.registerThread(*dispatcher, true);
+  Io::IoUringWorkerFactoryImpl io_uring_worker_factory(1000, false, false, 8192, 1000, 131072,
+                                                       16384, tls, 256);
+  io_uring_worker_factory.onWorkerThreadInitialized();
+  if (use_io_uring && !io_uring_worker_factory.getIoUringWorker()->isDatagramEnabled()) {
+    state.SkipWithError("io_uring does not support multishot recvmsg");
+    tls.shutdownGlobalThreading();
+    tls.shutdownThread();
+    return;
+  }
+
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  IoHandlePtr listener;
+  if (use_io_uring) {
+    listener = std::make_unique<IoUringUdpSocketHandleImpl>(
+        io_uring_worker_factory,
+        os_sys_calls.socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP).return_value_);
+  } else {
+    listener = std::make_unique<IoSocketHandleImpl>(
+        os_sys_calls.socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP).return_value_);
+  }
+  auto local_addr = std::make_shared<Address::Ipv4Instance>("127.0.0.1", 0);
+  listener->bind(local_addr);
+  const Address::InstanceConstSharedPtr listener_address = listener->localAddress();
+
+  CountingUdpPacketProcessor processor;
+  uint32_t packets_dropped = 0;
+  listener->initializeFileEvent(
+      *dispatcher,
+      [&](uint32_t) {
+        Utility::readPacketsFromSocket(*listener, *listener_address, processor, time_system,
+                                       false, true, packets_dropped)
+            .reset();
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  IoSocketHandleImpl client(
+      os_sys_calls.socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP).return_value_);
+  std::string payload(1200, 'a');
+  Buffer::RawSlice slice{payload.data(), payload.size()};
+
+  const uint64_t burst_size = state.range(0);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    const uint64_t expected_packets = processor.packets_ + burst_size;
+    for (uint64_t i = 0; i < burst_size; ++i) {
+      client.sendmsg(&slice, 1, 0, nullptr, *listener_address);
+    }
+    while (processor.packets_ < expected_packets) {
+      dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * burst_size);
+
+  listener->close();
+  tls.shutdownGlobalThreading();
+  tls.shutdownThread();
+}
+BENCHMARK(bmUdpReceive)
+    ->Args({16, 0})
+    ->Args({16, 1})
+    ->Args({64, 0})
+    ->Args({64, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
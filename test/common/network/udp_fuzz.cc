@@ -41,6 +41,7 @@ public:
   void onReceiveError(Api::IoError::IoErrorCode error_code) override;
   void onDataWorker(Network::UdpRecvData&& data) override;
   void post(Network::UdpRecvData&& data) override;
+  void postCallback(std::function<void(Network::UdpListenerCallbacksOptRef)> cb) override;
   void onDatagramsDropped(uint32_t dropped) override;
   uint32_t workerIndex() const override;
   Network::UdpPacketWriter& udpPacketWriter() override;
@@ -174,6 +175,11 @@ void FuzzUdpListenerCallbacks::onDataWorker(Network::UdpRecvData&& data) {
 }
 void FuzzUdpListenerCallbacks::post(Network::UdpRecvData&& data) { UNREFERENCED_PARAMETER(data); }
 
+void FuzzUdpListenerCallbacks::postCallback(
+    std::function<void(Network::UdpListenerCallbacksOptRef)> cb) {
+  UNREFERENCED_PARAMETER(cb);
+}
+
 void FuzzUdpListenerCallbacks::onDatagramsDropped(uint32_t dropped) {
   my_upf_->sent_packets_++;
   if (my_upf_->sent_packets_ == my_upf_->total_packets_) {
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <string>
@@ -11,19 +12,26 @@
 #include "source/common/network/utility.h"
 
 #include "test/common/network/udp_listener_impl_test_base.h"
+#include "test/common/stats/stat_test_utility.h"
 #include "test/mocks/api/mocks.h"
 #include "test/mocks/network/mock_parent_drained_callback_registrar.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::_;
 using testing::AtLeast;
 using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -853,6 +861,222 @@ TEST_P(UdpListenerImplTest, UdpGroReadLimit) {
 
 #endif
 
+UdpRecvData makeForwardedDatagram(absl::string_view payload, MonotonicTime receive_time = {}) {
+  UdpRecvData data;
+  data.buffer_ = std::make_unique<Buffer::OwnedImpl>(payload);
+  data.receive_time_ = receive_time;
+  return data;
+}
+
+// Datagrams are popped in the order they were pushed, and pushes fail once the queue is full.
+TEST(UdpWorkerForwardingQueueTest, PushPopInOrder) {
+  UdpWorkerForwardingQueue queue(3);
+  EXPECT_EQ(nullptr, queue.pop());
+  // The capacity is rounded up to 4.
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.push(makeForwardedDatagram(absl::StrCat(i))));
+  }
+  EXPECT_FALSE(queue.push(makeForwardedDatagram("dropped")));
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < 4; ++i) {
+      std::unique_ptr<UdpRecvData> data = queue.pop();
+      ASSERT_NE(nullptr, data);
+      EXPECT_EQ(absl::StrCat(lap * 4 + i), data->buffer_->toString());
+      EXPECT_TRUE(queue.push(makeForwardedDatagram(absl::StrCat((lap + 1) * 4 + i))));
+    }
+  }
+}
+
+// Datagrams pushed concurrently from several threads are all popped exactly once, in the order
+// each thread pushed them.
+TEST(UdpWorkerForwardingQueueTest, ConcurrentPushers) {
+  constexpr uint32_t NumThreads = 4;
+  constexpr uint32_t DatagramsPerThread = 10000;
+  UdpWorkerForwardingQueue queue(64);
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t t = 0; t < NumThreads; ++t) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&queue, t]() {
+      for (uint32_t i = 0; i < DatagramsPerThread; ++i) {
+        while (!queue.push(makeForwardedDatagram(absl::StrCat(t, ":", i)))) {
+        }
+      }
+    }));
+  }
+  std::vector<uint32_t> next(NumThreads, 0);
+  for (uint32_t popped = 0; popped < NumThreads * DatagramsPerThread;) {
+    std::unique_ptr<UdpRecvData> data = queue.pop();
+    if (data == nullptr) {
+      continue;
+    }
+    std::vector<std::string> parts = absl::StrSplit(data->buffer_->toString(), ':');
+    ASSERT_EQ(2, parts.size());
+    uint32_t thread_index;
+    uint32_t datagram_index;
+    ASSERT_TRUE(absl::SimpleAtoi(parts[0], &thread_index));
+    ASSERT_TRUE(absl::SimpleAtoi(parts[1], &datagram_index));
+    EXPECT_EQ(next[thread_index]++, datagram_index);
+    ++popped;
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(nullptr, queue.pop());
+}
+
+// Datagrams popped concurrently from several threads are each popped exactly once.
+TEST(UdpWorkerForwardingQueueTest, ConcurrentPoppers) {
+  constexpr uint32_t NumThreads = 4;
+  constexpr uint32_t NumDatagrams = 40000;
+  UdpWorkerForwardingQueue queue(64);
+  std::atomic<uint32_t> popped{0};
+  std::vector<std::vector<uint32_t>> received(NumThreads);
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t t = 0; t < NumThreads; ++t) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&, t]() {
+      while (popped.load() < NumDatagrams) {
+        std::unique_ptr<UdpRecvData> data = queue.pop();
+        if (data == nullptr) {
+          continue;
+        }
+        uint32_t index;
+        EXPECT_TRUE(absl::SimpleAtoi(data->buffer_->toString(), &index));
+        received[t].push_back(index);
+        ++popped;
+      }
+    }));
+  }
+  for (uint32_t i = 0; i < NumDatagrams; ++i) {
+    while (!queue.push(makeForwardedDatagram(absl::StrCat(i)))) {
+    }
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  std::vector<bool> seen(NumDatagrams, false);
+  for (const std::vector<uint32_t>& indexes : received) {
+    for (uint32_t index : indexes) {
+      ASSERT_LT(index, NumDatagrams);
+      EXPECT_FALSE(seen[index]);
+      seen[index] = true;
+    }
+  }
+  EXPECT_EQ(nullptr, queue.pop());
+}
+
+class UdpListenerWorkerRouterTest : public testing::Test {
+protected:
+  UdpListenerWorkerRouterTest() : router_(2, *store_.rootScope(), time_system_) {
+    for (uint32_t i = 0; i < 2; ++i) {
+      ON_CALL(workers_[i], workerIndex()).WillByDefault(Return(i));
+      ON_CALL(workers_[i], postCallback(_))
+          .WillByDefault(Invoke([this](std::function<void(UdpListenerCallbacksOptRef)> cb) {
+            posted_.push_back(std::move(cb));
+          }));
+      router_.registerWorkerForListener(workers_[i]);
+    }
+  }
+
+  // Runs the callbacks posted to the workers, as the destination worker would.
+  void runPosted(UdpListenerCallbacksOptRef listener) {
+    std::vector<std::function<void(UdpListenerCallbacksOptRef)>> posted;
+    posted.swap(posted_);
+    for (auto& cb : posted) {
+      cb(listener);
+    }
+  }
+
+  TestScopedRuntime scoped_runtime_;
+  Event::SimulatedTimeSystem time_system_;
+  Stats::TestUtil::TestStore store_;
+  NiceMock<MockUdpListenerCallbacks> workers_[2];
+  UdpListenerWorkerRouterImpl router_;
+  std::vector<std::function<void(UdpListenerCallbacksOptRef)>> posted_;
+};
+
+// Datagrams forwarded before the destination worker runs are handed over in a single batch.
+TEST_F(UdpListenerWorkerRouterTest, ForwardsInBatches) {
+  const MonotonicTime receive_time = time_system_.monotonicTime();
+  router_.deliver(1, makeForwardedDatagram("a", receive_time));
+  router_.deliver(1, makeForwardedDatagram("b", receive_time));
+  router_.deliver(1, makeForwardedDatagram("c", receive_time));
+  EXPECT_EQ(1, posted_.size());
+
+  time_system_.advanceTimeWait(std::chrono::microseconds(50));
+  std::vector<std::string> received;
+  EXPECT_CALL(workers_[1], onDataWorker(_))
+      .Times(3)
+      .WillRepeatedly(
+          Invoke([&](UdpRecvData&& data) { received.push_back(data.buffer_->toString()); }));
+  runPosted(workers_[1]);
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), received);
+  EXPECT_EQ((std::vector<uint64_t>{50, 50, 50}),
+            store_.histogramValues("udp.worker_forwarding_latency", false));
+  EXPECT_EQ(3, store_.counter("udp.worker_forwarded_packets").value());
+
+  // The next datagram schedules another drain.
+  router_.deliver(1, makeForwardedDatagram("d", receive_time));
+  EXPECT_EQ(1, posted_.size());
+}
+
+// Datagrams are dropped when the destination worker's queue is full.
+TEST_F(UdpListenerWorkerRouterTest, DropsWhenQueueFull) {
+  for (uint32_t i = 0; i < UdpListenerWorkerRouterImpl::ForwardingQueueCapacity + 2; ++i) {
+    router_.deliver(0, makeForwardedDatagram("a"));
+  }
+  EXPECT_EQ(1, posted_.size());
+  EXPECT_EQ(2, store_.counter("udp.worker_forwarding_dropped").value());
+
+  EXPECT_CALL(workers_[0], onDataWorker(_))
+      .Times(UdpListenerWorkerRouterImpl::ForwardingQueueCapacity);
+  runPosted(workers_[0]);
+  EXPECT_EQ(UdpListenerWorkerRouterImpl::ForwardingQueueCapacity,
+            store_.counter("udp.worker_forwarded_packets").value());
+}
+
+// Queued datagrams are dropped if the listener is removed from the worker before the drain runs.
+TEST_F(UdpListenerWorkerRouterTest, ListenerRemovedBeforeDrain) {
+  router_.deliver(0, makeForwardedDatagram("a"));
+  router_.unregisterWorkerForListener(workers_[0]);
+  router_.deliver(0, makeForwardedDatagram("b"));
+  EXPECT_EQ(1, posted_.size());
+
+  EXPECT_CALL(workers_[0], onDataWorker(_)).Times(0);
+  runPosted(std::nullopt);
+  EXPECT_EQ(0, store_.counter("udp.worker_forwarded_packets").value());
+  EXPECT_EQ(2, store_.counter("udp.worker_forwarding_dropped").value());
+}
+
+// Datagrams forwarded to a worker the listener was removed from are dropped right away, as no
+// drain is scheduled for them.
+TEST_F(UdpListenerWorkerRouterTest, ListenerRemovedBeforeForwarding) {
+  router_.unregisterWorkerForListener(workers_[1]);
+  router_.deliver(1, makeForwardedDatagram("a"));
+  router_.deliver(1, makeForwardedDatagram("b"));
+  EXPECT_EQ(0, posted_.size());
+  EXPECT_EQ(2, store_.counter("udp.worker_forwarding_dropped").value());
+
+  // The queue is empty when the listener is added back, and the next datagram schedules a drain.
+  router_.registerWorkerForListener(workers_[1]);
+  router_.deliver(1, makeForwardedDatagram("c"));
+  EXPECT_EQ(1, posted_.size());
+  std::vector<std::string> received;
+  EXPECT_CALL(workers_[1], onDataWorker(_)).WillOnce(Invoke([&](UdpRecvData&& data) {
+    received.push_back(data.buffer_->toString());
+  }));
+  runPosted(workers_[1]);
+  EXPECT_EQ((std::vector<std::string>{"c"}), received);
+  EXPECT_EQ(2, store_.counter("udp.worker_forwarding_dropped").value());
+}
+
+// With the runtime guard disabled, each datagram is posted to the destination worker on its own.
+TEST_F(UdpListenerWorkerRouterTest, QueueDisabled) {
+  scoped_runtime_.mergeValues({{"envoy.reloadable_features.udp_worker_forwarding_queue", "false"}});
+  EXPECT_CALL(workers_[1], postCallback(_)).Times(0);
+  EXPECT_CALL(workers_[1], post(_)).Times(2);
+  router_.deliver(1, makeForwardedDatagram("a"));
+  router_.deliver(1, makeForwardedDatagram("b"));
+}
+
 } // namespace
 } // namespace Network
 } // namespace Envoy
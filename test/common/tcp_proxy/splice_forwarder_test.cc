@@ -0,0 +1,253 @@
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <string>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/event/dispatcher_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/tcp_proxy/splice_forwarder.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/network/io_handle.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace TcpProxy {
+namespace {
+
+using testing::_;
+using testing::AnyNumber;
+using testing::AtMost;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+class MockSpliceForwarderCallbacks : public SpliceForwarderCallbacks {
+public:
+  MOCK_METHOD(void, onSplicedData,
+              (SpliceDirection direction, uint64_t bytes_read, uint64_t bytes_written));
+  MOCK_METHOD(void, onSpliceReadDisabled, (SpliceDirection direction, bool disabled));
+  MOCK_METHOD(void, onSpliceEndStream, (SpliceDirection direction));
+  MOCK_METHOD(void, onSpliceError, (SpliceDirection direction, int error));
+};
+
+// Handles that cannot splice, e.g. io_uring ones, are not used.
+TEST(SpliceForwarderCreateTest, HandleNotSupported) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  NiceMock<Network::MockIoHandle> downstream;
+  NiceMock<Network::MockIoHandle> upstream;
+  MockSpliceForwarderCallbacks callbacks;
+
+  EXPECT_CALL(downstream, supportsSplice()).WillRepeatedly(Return(true));
+  EXPECT_CALL(upstream, supportsSplice()).WillRepeatedly(Return(false));
+  EXPECT_CALL(upstream, duplicate()).Times(0);
+  EXPECT_EQ(nullptr, SpliceForwarder::create(*dispatcher, downstream, upstream, callbacks));
+}
+
+#if defined(__linux__)
+
+// Proxies between a client and a server over two socket pairs, with the forwarder between the
+// proxy's ends of them.
+class SpliceForwarderTest : public testing::Test {
+public:
+  SpliceForwarderTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        os_sys_calls_(Api::OsSysCallsSingleton::get()) {}
+
+  void SetUp() override {
+    ASSERT_EQ(0, os_sys_calls_.socketpair(AF_UNIX, SOCK_STREAM, 0, downstream_fds_).return_value_);
+    ASSERT_EQ(0, os_sys_calls_.socketpair(AF_UNIX, SOCK_STREAM, 0, upstream_fds_).return_value_);
+    for (os_fd_t fd : {client(), downstream(), upstream(), server()}) {
+      ASSERT_EQ(0, os_sys_calls_.setsocketblocking(fd, false).return_value_);
+    }
+    downstream_handle_ = std::make_unique<Network::IoSocketHandleImpl>(downstream());
+    upstream_handle_ = std::make_unique<Network::IoSocketHandleImpl>(upstream());
+    forwarder_ =
+        SpliceForwarder::create(*dispatcher_, *downstream_handle_, *upstream_handle_, callbacks_);
+    ASSERT_NE(nullptr, forwarder_);
+  }
+
+  void TearDown() override {
+    forwarder_.reset();
+    // The handles close the proxy's ends of the socket pairs.
+    downstream_handle_.reset();
+    upstream_handle_.reset();
+    for (os_fd_t fd : {client(), server()}) {
+      if (fd != INVALID_SOCKET) {
+        os_sys_calls_.close(fd);
+      }
+    }
+  }
+
+  os_fd_t client() const { return downstream_fds_[0]; }
+  os_fd_t downstream() const { return downstream_fds_[1]; }
+  os_fd_t upstream() const { return upstream_fds_[0]; }
+  os_fd_t server() const { return upstream_fds_[1]; }
+
+  void write(os_fd_t fd, const std::string& data) {
+    ASSERT_EQ(data.size(), os_sys_calls_.write(fd, data.data(), data.size()).return_value_);
+  }
+
+  std::string read(os_fd_t fd) {
+    std::string data;
+    char buffer[16384];
+    while (true) {
+      const Api::SysCallSizeResult result = os_sys_calls_.recv(fd, buffer, sizeof(buffer), 0);
+      if (result.return_value_ <= 0) {
+        return data;
+      }
+      data.append(buffer, result.return_value_);
+    }
+  }
+
+  void run() { dispatcher_->run(Event::Dispatcher::RunType::NonBlock); }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Api::OsSysCalls& os_sys_calls_;
+  os_fd_t downstream_fds_[2];
+  os_fd_t upstream_fds_[2];
+  Network::IoHandlePtr downstream_handle_;
+  Network::IoHandlePtr upstream_handle_;
+  MockSpliceForwarderCallbacks callbacks_;
+  SpliceForwarderPtr forwarder_;
+};
+
+// Data is moved in both directions and reported per direction.
+TEST_F(SpliceForwarderTest, ForwardsBothDirections) {
+  write(client(), "hello");
+  EXPECT_CALL(callbacks_, onSplicedData(SpliceDirection::DownstreamToUpstream, 5, 5));
+  run();
+  EXPECT_EQ("hello", read(server()));
+
+  write(server(), "world!");
+  EXPECT_CALL(callbacks_, onSplicedData(SpliceDirection::UpstreamToDownstream, 6, 6));
+  run();
+  EXPECT_EQ("world!", read(client()));
+  EXPECT_EQ(0, forwarder_->bufferedBytes(SpliceDirection::DownstreamToUpstream));
+  EXPECT_EQ(0, forwarder_->bufferedBytes(SpliceDirection::UpstreamToDownstream));
+}
+
+// The end of stream is reported once the data before it has been written, and is not forwarded.
+TEST_F(SpliceForwarderTest, EndStream) {
+  write(client(), "hello");
+  ASSERT_EQ(0, os_sys_calls_.shutdown(client(), SHUT_WR).return_value_);
+  EXPECT_CALL(callbacks_, onSplicedData(SpliceDirection::DownstreamToUpstream, 5, 5));
+  EXPECT_CALL(callbacks_, onSpliceEndStream(SpliceDirection::DownstreamToUpstream));
+  run();
+
+  char buffer[16];
+  EXPECT_EQ(5, os_sys_calls_.recv(server(), buffer, sizeof(buffer), 0).return_value_);
+  const Api::SysCallSizeResult result = os_sys_calls_.recv(server(), buffer, sizeof(buffer), 0);
+  EXPECT_EQ(-1, result.return_value_);
+  EXPECT_EQ(SOCKET_ERROR_AGAIN, result.errno_);
+
+  // The other direction keeps going.
+  write(server(), "world");
+  EXPECT_CALL(callbacks_, onSplicedData(SpliceDirection::UpstreamToDownstream, 5, 5));
+  run();
+  EXPECT_EQ("world", read(client()));
+}
+
+// Reading stops while the destination does not accept more data, and resumes once it does.
+TEST_F(SpliceForwarderTest, BackPressure) {
+  uint64_t bytes_read = 0;
+  uint64_t bytes_written = 0;
+  bool read_disabled = false;
+  EXPECT_CALL(callbacks_, onSplicedData(SpliceDirection::DownstreamToUpstream, _, _))
+      .Times(AnyNumber())
+      .WillRepeatedly(Invoke([&](SpliceDirection, uint64_t read, uint64_t written) {
+        bytes_read += read;
+        bytes_written += written;
+      }));
+  EXPECT_CALL(callbacks_, onSpliceReadDisabled(SpliceDirection::DownstreamToUpstream, true))
+      .WillOnce(Invoke([&](SpliceDirection, bool) { read_disabled = true; }));
+
+  // Write until the client can write no more, without the server reading.
+  const std::string chunk(16384, 'a');
+  uint64_t sent = 0;
+  while (!read_disabled) {
+    const Api::SysCallSizeResult result = os_sys_calls_.write(client(), chunk.data(), chunk.size());
+    if (result.return_value_ > 0) {
+      sent += result.return_value_;
+    }
+    run();
+  }
+  EXPECT_GT(forwarder_->bufferedBytes(SpliceDirection::DownstreamToUpstream), 0);
+  EXPECT_EQ(bytes_read - bytes_written,
+            forwarder_->bufferedBytes(SpliceDirection::DownstreamToUpstream));
+
+  EXPECT_CALL(callbacks_, onSpliceReadDisabled(SpliceDirection::DownstreamToUpstream, false));
+  uint64_t received = 0;
+  while (received < sent) {
+    const std::string data = read(server());
+    EXPECT_EQ(std::string(data.size(), 'a'), data);
+    received += data.size();
+    run();
+  }
+  EXPECT_EQ(sent, received);
+  EXPECT_EQ(sent, bytes_written);
+  EXPECT_EQ(0, forwarder_->bufferedBytes(SpliceDirection::DownstreamToUpstream));
+}
+
+// A failed write is reported and stops the forwarder.
+TEST_F(SpliceForwarderTest, WriteError) {
+  os_sys_calls_.close(server());
+  upstream_fds_[1] = INVALID_SOCKET;
+
+  write(client(), "hello");
+  // Whether the upstream end of stream is read first depends on the order of the events.
+  EXPECT_CALL(callbacks_, onSpliceEndStream(SpliceDirection::UpstreamToDownstream))
+      .Times(AtMost(1));
+  EXPECT_CALL(callbacks_, onSplicedData(SpliceDirection::DownstreamToUpstream, 5, 0));
+  EXPECT_CALL(callbacks_, onSpliceError(SpliceDirection::DownstreamToUpstream, EPIPE))
+      .WillOnce(Invoke([&](SpliceDirection, int) { forwarder_->close(); }));
+  run();
+}
+
+// No data is moved and no callbacks are invoked once closed.
+TEST_F(SpliceForwarderTest, Close) {
+  forwarder_->close();
+  write(client(), "hello");
+  run();
+
+  char buffer[16];
+  EXPECT_EQ(5, os_sys_calls_.recv(downstream(), buffer, sizeof(buffer), 0).return_value_);
+  EXPECT_EQ(-1, os_sys_calls_.recv(server(), buffer, sizeof(buffer), 0).return_value_);
+}
+
+// The forwarder closes itself when the callbacks close it.
+TEST_F(SpliceForwarderTest, CloseFromCallback) {
+  write(client(), "hello");
+  write(server(), "world");
+  EXPECT_CALL(callbacks_, onSplicedData(_, 5, 5))
+      .WillOnce(Invoke([&](SpliceDirection, uint64_t, uint64_t) { forwarder_->close(); }));
+  run();
+}
+
+TEST(SpliceForwarderCreateTest, PipeFailure) {
+  Api::MockLinuxOsSysCalls linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  NiceMock<Network::MockIoHandle> downstream;
+  NiceMock<Network::MockIoHandle> upstream;
+  MockSpliceForwarderCallbacks callbacks;
+
+  EXPECT_CALL(downstream, supportsSplice()).WillRepeatedly(Return(true));
+  EXPECT_CALL(upstream, supportsSplice()).WillRepeatedly(Return(true));
+  EXPECT_CALL(linux_os_sys_calls, pipe2(_, _)).WillOnce(Return(Api::SysCallIntResult{-1, EMFILE}));
+  EXPECT_EQ(nullptr, SpliceForwarder::create(*dispatcher, downstream, upstream, callbacks));
+}
+
+#endif
+
+} // namespace
+} // namespace TcpProxy
+} // namespace Envoy
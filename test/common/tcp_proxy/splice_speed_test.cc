@@ -0,0 +1,127 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <sys/socket.h>
+
+#include <string>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/network/io_socket_handle_impl.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+
+#include "source/common/api/os_sys_calls_impl_linux.h"
+#endif
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+// A client and a server connected through a proxy over two socket pairs, as the tcp_proxy filter
+// sees them. Each iteration writes a chunk from the client, moves it through the proxy and reads
+// it on the server.
+class SpliceSpeedTest {
+public:
+  SpliceSpeedTest() {
+    Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+    for (os_fd_t* fds : {downstream_fds_, upstream_fds_}) {
+      RELEASE_ASSERT(os_sys_calls.socketpair(AF_UNIX, SOCK_STREAM, 0, fds).return_value_ == 0, "");
+    }
+  }
+
+  ~SpliceSpeedTest() {
+    for (os_fd_t fd : {downstream_fds_[0], downstream_fds_[1], upstream_fds_[0],
+                       upstream_fds_[1]}) {
+      Api::OsSysCallsSingleton::get().close(fd);
+    }
+  }
+
+  void writeClient(const std::string& chunk) {
+    RELEASE_ASSERT(Api::OsSysCallsSingleton::get()
+                           .write(downstream_fds_[0], chunk.data(), chunk.size())
+                           .return_value_ == static_cast<ssize_t>(chunk.size()),
+                   "");
+  }
+
+  void readServer(uint64_t size) {
+    while (size > 0) {
+      const Api::SysCallSizeResult result = Api::OsSysCallsSingleton::get().recv(
+          upstream_fds_[1], scratch_, std::min<uint64_t>(size, sizeof(scratch_)), 0);
+      RELEASE_ASSERT(result.return_value_ > 0, "");
+      size -= result.return_value_;
+    }
+  }
+
+  os_fd_t downstream() const { return downstream_fds_[1]; }
+  os_fd_t upstream() const { return upstream_fds_[0]; }
+
+private:
+  os_fd_t downstream_fds_[2];
+  os_fd_t upstream_fds_[2];
+  char scratch_[64 * 1024];
+};
+
+} // namespace TcpProxy
+} // namespace Envoy
+
+// The argument is the size of the chunk moved through the proxy in each iteration. Bytes per
+// second is the inverse of CPU time per MB, including the client and the server.
+static void bmCopyThroughBuffer(benchmark::State& state) {
+  Envoy::TcpProxy::SpliceSpeedTest test;
+  const std::string chunk(state.range(0), 'a');
+  // The handles close their own copies of the sockets.
+  Envoy::Network::IoSocketHandleImpl downstream(
+      Envoy::Api::OsSysCallsSingleton::get().duplicate(test.downstream()).return_value_);
+  Envoy::Network::IoSocketHandleImpl upstream(
+      Envoy::Api::OsSysCallsSingleton::get().duplicate(test.upstream()).return_value_);
+  Envoy::Buffer::OwnedImpl buffer;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    test.writeClient(chunk);
+    uint64_t moved = 0;
+    while (moved < chunk.size()) {
+      moved += downstream.read(buffer, chunk.size() - moved).return_value_;
+      while (buffer.length() > 0) {
+        upstream.write(buffer);
+      }
+    }
+    test.readServer(chunk.size());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * chunk.size());
+}
+BENCHMARK(bmCopyThroughBuffer)->Arg(4 << 10)->Arg(16 << 10)->Arg(64 << 10);
+
+#if defined(__linux__)
+static void bmSpliceThroughPipe(benchmark::State& state) {
+  Envoy::TcpProxy::SpliceSpeedTest test;
+  const std::string chunk(state.range(0), 'a');
+  Envoy::Api::LinuxOsSysCalls& linux_os_sys_calls = Envoy::Api::LinuxOsSysCallsSingleton::get();
+  os_fd_t pipe_fds[2];
+  RELEASE_ASSERT(linux_os_sys_calls.pipe2(pipe_fds, O_CLOEXEC).return_value_ == 0, "");
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    test.writeClient(chunk);
+    uint64_t moved = 0;
+    while (moved < chunk.size()) {
+      uint64_t buffered = linux_os_sys_calls
+                              .splice(test.downstream(), pipe_fds[1], chunk.size() - moved,
+                                      SPLICE_F_MOVE)
+                              .return_value_;
+      moved += buffered;
+      while (buffered > 0) {
+        buffered -= linux_os_sys_calls.splice(pipe_fds[0], test.upstream(), buffered, SPLICE_F_MOVE)
+                        .return_value_;
+      }
+    }
+    test.readServer(chunk.size());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * chunk.size());
+  Envoy::Api::OsSysCallsSingleton::get().close(pipe_fds[0]);
+  Envoy::Api::OsSysCallsSingleton::get().close(pipe_fds[1]);
+}
+BENCHMARK(bmSpliceThroughPipe)->Arg(4 << 10)->Arg(16 << 10)->Arg(64 << 10);
+#endif
@@ -292,6 +292,46 @@ TEST_P(TcpProxyTest, DrainCloseAfterDownstreamRead) {
   filter_->onData(buffer, false);
 }
 
+// Data read through TLS cannot be spliced, so the downstream connection is read enabled as usual.
+TEST_P(TcpProxyTest, KernelSpliceNotUsedWithTls) {
+  auto config = defaultConfig();
+  config.set_kernel_splice(true);
+  auto ssl = std::make_shared<Ssl::MockConnectionInfo>();
+  EXPECT_CALL(filter_callbacks_.connection_, ssl()).WillRepeatedly(Return(ssl));
+  setup(1, config);
+
+  EXPECT_CALL(*upstream_connections_.at(0), readDisable(true)).Times(0);
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(0, config_->stats().downstream_cx_spliced_total_.value());
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+}
+
+// Data of sockets whose handles cannot splice, e.g. io_uring ones, is proxied as usual.
+TEST_P(TcpProxyTest, KernelSpliceNotUsedWithoutHandleSupport) {
+  auto config = defaultConfig();
+  config.set_kernel_splice(true);
+  setup(1, config);
+
+  NiceMock<Network::MockIoHandle> io_handle;
+  EXPECT_CALL(io_handle, supportsSplice()).WillOnce(Return(false));
+  auto socket = std::make_unique<NiceMock<Network::MockConnectionSocket>>();
+  ON_CALL(*socket, ioHandle()).WillByDefault(ReturnRef(io_handle));
+  const Network::ConnectionSocketPtr connection_socket = std::move(socket);
+  ON_CALL(filter_callbacks_.connection_, getSocket()).WillByDefault(ReturnRef(connection_socket));
+  ON_CALL(*upstream_connections_.at(0), getSocket()).WillByDefault(ReturnRef(connection_socket));
+
+  EXPECT_CALL(*upstream_connections_.at(0), readDisable(true)).Times(0);
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(0, config_->stats().downstream_cx_spliced_total_.value());
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+}
+
 TEST_P(TcpProxyTest, DrainCloseUsesInboundOnlyScopeForInboundListeners) {
   auto config = defaultConfig();
   config.mutable_check_drain_close()->set_value(true);
@@ -430,6 +430,50 @@ TEST_F(RedisClusterLoadBalancerTest, ClusterSlotUpdate) {
   validateAssignment(hosts, updated_assignments);
 }
 
+// Moving slot ranges between the existing shards updates only the slot ranges that changed, and
+// the slots that are no longer assigned map to the first shard as in a new slot array.
+TEST_F(RedisClusterLoadBalancerTest, ClusterSlotIncrementalUpdate) {
+  Upstream::HostVector hosts{Upstream::makeTestHost(info_, "tcp://127.0.0.1:90"),
+                             Upstream::makeTestHost(info_, "tcp://127.0.0.1:91"),
+                             Upstream::makeTestHost(info_, "tcp://127.0.0.1:92")};
+  Upstream::HostMap all_hosts = generateHostMap(hosts);
+  init();
+  EXPECT_EQ(true, factory_->onClusterSlotUpdate(
+                      std::make_unique<std::vector<ClusterSlot>>(std::vector<ClusterSlot>{
+                          ClusterSlot(0, 1000, hosts[0]->address()),
+                          ClusterSlot(1001, 2000, hosts[1]->address()),
+                          ClusterSlot(2001, 16383, hosts[2]->address())}),
+                      all_hosts));
+  validateAssignment(hosts, {{100, 0}, {600, 0}, {1100, 1}, {2100, 2}});
+
+  // Migrate half of the slots of the first shard to the second one.
+  EXPECT_EQ(true, factory_->onClusterSlotUpdate(
+                      std::make_unique<std::vector<ClusterSlot>>(std::vector<ClusterSlot>{
+                          ClusterSlot(0, 500, hosts[0]->address()),
+                          ClusterSlot(501, 1000, hosts[1]->address()),
+                          ClusterSlot(1001, 2000, hosts[1]->address()),
+                          ClusterSlot(2001, 16383, hosts[2]->address())}),
+                      all_hosts));
+  validateAssignment(hosts, {{100, 0}, {500, 0}, {501, 1}, {600, 1}, {1100, 1}, {2100, 2}});
+
+  // Slots that are not assigned to any shard fall back to the first shard.
+  EXPECT_EQ(true, factory_->onClusterSlotUpdate(
+                      std::make_unique<std::vector<ClusterSlot>>(std::vector<ClusterSlot>{
+                          ClusterSlot(0, 500, hosts[0]->address()),
+                          ClusterSlot(1001, 2000, hosts[1]->address()),
+                          ClusterSlot(2001, 16383, hosts[2]->address())}),
+                      all_hosts));
+  validateAssignment(hosts, {{100, 0}, {600, 0}, {1100, 1}, {2100, 2}});
+
+  // Removing a shard changes the shard indexes, so the slot array is rebuilt.
+  EXPECT_EQ(true, factory_->onClusterSlotUpdate(
+                      std::make_unique<std::vector<ClusterSlot>>(std::vector<ClusterSlot>{
+                          ClusterSlot(0, 2000, hosts[1]->address()),
+                          ClusterSlot(2001, 16383, hosts[2]->address())}),
+                      all_hosts));
+  validateAssignment(hosts, {{100, 1}, {600, 1}, {1100, 1}, {2100, 2}});
+}
+
 // Verifies that a worker-local LB instance refreshes its slot and shard
 // snapshot when the worker priority set fires its member update callback,
 // rather than relying on the cluster manager to recreate the LB.
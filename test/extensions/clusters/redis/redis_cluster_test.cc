@@ -1264,6 +1264,50 @@ TEST_F(RedisClusterTest, RedisResolveFailure) {
   EXPECT_EQ(2U, cluster_->info()->configUpdateStats().update_failure_.value());
 }
 
+// The time from the CLUSTER SLOTS request to the update of the topology and the time of the slot
+// map update are recorded for each successful refresh.
+TEST_F(RedisClusterTest, TopologyUpdateTimeHistograms) {
+  setupFromV3Yaml(BasicConfig);
+  const std::list<std::string> resolved_addresses{"127.0.0.1", "127.0.0.2"};
+  expectResolveDiscovery(Network::DnsLookupFamily::V4Only, "foo.bar.com", resolved_addresses);
+  expectRedisResolve(true);
+
+  EXPECT_CALL(membership_updated_, ready());
+  EXPECT_CALL(initialized_, ready());
+  cluster_->initialize([&]() {
+    initialized_.ready();
+    return absl::OkStatus();
+  });
+
+  EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _));
+  expectClusterSlotResponse(singleSlotPrimaryReplica("127.0.0.1", "127.0.0.2", 22120));
+  EXPECT_EQ(1, stats_store_.histogramValues("cluster.name.redis_cluster.topology_refresh_time",
+                                            false)
+                   .size());
+  EXPECT_EQ(1, stats_store_.histogramValues("cluster.name.redis_cluster.slot_map_update_time",
+                                            false)
+                   .size());
+
+  // Nothing is recorded for a failed refresh.
+  expectRedisResolve();
+  resolve_timer_->invokeCallback();
+  expectClusterSlotFailure();
+  EXPECT_EQ(1, stats_store_.histogramValues("cluster.name.redis_cluster.topology_refresh_time",
+                                            false)
+                   .size());
+
+  expectRedisResolve();
+  resolve_timer_->invokeCallback();
+  EXPECT_CALL(*cluster_callback_, onClusterSlotUpdate(_, _)).WillOnce(Return(false));
+  expectClusterSlotResponse(singleSlotPrimaryReplica("127.0.0.1", "127.0.0.2", 22120));
+  EXPECT_EQ(2, stats_store_.histogramValues("cluster.name.redis_cluster.topology_refresh_time",
+                                            false)
+                   .size());
+  EXPECT_EQ(2, stats_store_.histogramValues("cluster.name.redis_cluster.slot_map_update_time",
+                                            false)
+                   .size());
+}
+
 TEST_F(RedisClusterTest, FactoryInitNotRedisClusterTypeFailure) {
   const std::string basic_yaml_hosts = R"EOF(
   name: name
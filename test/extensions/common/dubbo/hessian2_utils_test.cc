@@ -77,6 +77,171 @@ TEST(Hessian2UtilsTest, GetParametersNumberTest) {
   EXPECT_EQ(0, Hessian2Utils::getParametersNumber(test_error_types));
 }
 
+// Skips all the values in the buffer and expects every value to end where the decoder ends it.
+void expectSkippedAsDecoded(Buffer::Instance& buffer, size_t expected_values) {
+  Hessian2::Decoder decoder(std::make_unique<BufferReader>(buffer));
+  Hessian2ValueSkipper skipper(buffer);
+  size_t values = 0;
+  while (skipper.offset() < buffer.length()) {
+    ASSERT_TRUE(skipper.skipValue());
+    ASSERT_NE(nullptr, decoder.decode<Hessian2::Object>());
+    EXPECT_EQ(decoder.offset(), skipper.offset());
+    values++;
+  }
+  EXPECT_EQ(expected_values, values);
+}
+
+TEST(Hessian2ValueSkipperTest, SkipEncodedObjects) {
+  Hessian2::Object::UntypedMap inner_map;
+  inner_map.emplace(std::make_unique<Hessian2::StringObject>("key"),
+                    std::make_unique<Hessian2::LongObject>(1));
+  Hessian2::Object::UntypedMap map;
+  map.emplace(std::make_unique<Hessian2::StringObject>("map"),
+              std::make_unique<Hessian2::UntypedMapObject>(std::move(inner_map)));
+  map.emplace(std::make_unique<Hessian2::LongObject>(2), std::make_unique<Hessian2::NullObject>());
+
+  std::vector<Hessian2::ObjectPtr> objects;
+  objects.push_back(std::make_unique<Hessian2::StringObject>(""));
+  objects.push_back(std::make_unique<Hessian2::StringObject>("group"));
+  objects.push_back(std::make_unique<Hessian2::StringObject>(std::string(100, 'a')));
+  // Long strings are encoded in chunks.
+  objects.push_back(std::make_unique<Hessian2::StringObject>(std::string(70000, 'a')));
+  // Two and three bytes UTF-8 characters.
+  objects.push_back(std::make_unique<Hessian2::StringObject>("\xc3\xa9\xe4\xbd\xa0"));
+  objects.push_back(std::make_unique<Hessian2::BinaryObject>(std::vector<uint8_t>{0, 1, 2}));
+  objects.push_back(std::make_unique<Hessian2::BinaryObject>(std::vector<uint8_t>(1000, 1)));
+  objects.push_back(std::make_unique<Hessian2::BinaryObject>(std::vector<uint8_t>(70000, 1)));
+  for (int64_t value : {0L, -8L, 15L, 2047L, -262144L, 262143L, 1L << 30, 1L << 40}) {
+    objects.push_back(std::make_unique<Hessian2::LongObject>(value));
+  }
+  for (int32_t value : {0, -16, 47, 2047, -262144, 262143, 1 << 30}) {
+    objects.push_back(std::make_unique<Hessian2::IntegerObject>(value));
+  }
+  for (double value : {0.0, 1.0, 2.0, 300.0, 1.5, 0.1}) {
+    objects.push_back(std::make_unique<Hessian2::DoubleObject>(value));
+  }
+  objects.push_back(std::make_unique<Hessian2::BooleanObject>(true));
+  objects.push_back(std::make_unique<Hessian2::NullObject>());
+  objects.push_back(std::make_unique<Hessian2::UntypedMapObject>(std::move(map)));
+
+  Buffer::OwnedImpl buffer;
+  Hessian2::Encoder encoder(std::make_unique<BufferWriter>(buffer));
+  for (const auto& object : objects) {
+    encoder.encode(*object);
+  }
+
+  expectSkippedAsDecoded(buffer, objects.size());
+}
+
+TEST(Hessian2ValueSkipperTest, SkipRawValues) {
+  Buffer::OwnedImpl buffer(std::string({
+      // A class definition with two fields followed by a compact object.
+      'C', 0x4, 'T', 'e', 's', 't', '\x92', 0x1, 'a', 0x1, 'b', 0x60, '\x91', 'N',
+      // An object of the same class.
+      'O', '\x90', 'T', 'F',
+      // A variable length typed list.
+      0x55, 0x4, '[', 'i', 'n', 't', '\x91', '\x92', 'Z',
+      // A fixed length typed list.
+      'V', 0x4, '[', 'i', 'n', 't', '\x92', '\x91', '\x92',
+      // Variable and fixed length untyped lists.
+      0x57, 'N', 'Z', 0x58, '\x91', 'N',
+      // Compact typed list whose type is a reference, and compact untyped list.
+      0x72, '\x90', '\x91', '\x92', 0x79, 'N',
+      // A typed map whose type is a reference.
+      'M', '\x90', '\x91', 'N', 'Z',
+      // A reference to a previous value.
+      'Q', '\x90',
+      // A string of a four bytes UTF-8 character, which counts as two characters.
+      0x2, '\xf0', '\x9f', '\x98', '\x80',
+      // Dates.
+      0x4a, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x4b, 0x0, 0x0, 0x0, 0x0,
+      // Doubles.
+      'D', 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x5b, 0x5c, 0x5d, 0x1, 0x5e, 0x1, 0x1, 0x5f,
+      0x0, 0x0, 0x0, 0x0,
+      // Longs.
+      'L', 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 'Y', 0x0, 0x0, 0x0, 0x0, 0x38, 0x0, 0x0,
+      '\xf0', 0x0,
+      // Ints.
+      'I', 0x0, 0x0, 0x0, 0x0, '\xc0', 0x0, '\xd0', 0x0, 0x0,
+  }));
+
+  Hessian2ValueSkipper skipper(buffer);
+  size_t values = 0;
+  while (skipper.offset() < buffer.length()) {
+    ASSERT_TRUE(skipper.skipValue());
+    values++;
+  }
+  EXPECT_EQ(26, values);
+}
+
+TEST(Hessian2ValueSkipperTest, SkipValuesAcrossSlices) {
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest(std::string({'\x92', 'T'}));
+  buffer.appendSliceForTest(std::string({0x5, 'g', 'r'}));
+  buffer.appendSliceForTest("");
+  buffer.appendSliceForTest(std::string({'o', 'u', 'p', 'H', 0x1}));
+  buffer.appendSliceForTest(std::string({'a', 0x1, 'b', 'Z'}));
+
+  // Start after the first byte.
+  Hessian2ValueSkipper skipper(buffer, 1);
+  EXPECT_EQ(1, skipper.offset());
+  EXPECT_TRUE(skipper.skipValue());
+  EXPECT_EQ(2, skipper.offset());
+  EXPECT_TRUE(skipper.skipValue());
+  EXPECT_EQ(8, skipper.offset());
+  EXPECT_TRUE(skipper.skipValue());
+  EXPECT_EQ(buffer.length(), skipper.offset());
+  EXPECT_FALSE(skipper.skipValue());
+}
+
+TEST(Hessian2ValueSkipperTest, SkipBrokenValues) {
+  const std::vector<std::string> broken_values = {
+      // Empty buffer.
+      "",
+      // Reserved tags.
+      std::string({0x40}),
+      std::string({0x50}),
+      // A list end out of a list.
+      std::string({'Z'}),
+      // Truncated values.
+      std::string({0x5, 'g', 'r'}),
+      std::string({'S', 0x0}),
+      std::string({'R', 0x0, 0x1, 'a'}),
+      std::string({0x23, 0x1}),
+      std::string({'I', 0x0, 0x0}),
+      std::string({'D', 0x0}),
+      std::string({'H', 0x1, 'a'}),
+      std::string({0x58, '\x92', 'N'}),
+      // A string with an invalid UTF-8 lead byte.
+      std::string({0x1, '\xff'}),
+      // Objects of undefined classes.
+      std::string({0x60}),
+      std::string({'O', '\x91'}),
+      // A negative list length.
+      std::string({0x58, '\x8f'}),
+  };
+  for (const auto& value : broken_values) {
+    Buffer::OwnedImpl buffer(value);
+    Hessian2ValueSkipper skipper(buffer);
+    EXPECT_FALSE(skipper.skipValue());
+  }
+}
+
+TEST(Hessian2ValueSkipperTest, SkipTooDeepValues) {
+  auto nested_lists = [](uint32_t depth) {
+    return std::string(depth, 0x57) + "N" + std::string(depth, 'Z');
+  };
+
+  Buffer::OwnedImpl buffer(nested_lists(Hessian2ValueSkipper::MaxDepth));
+  Hessian2ValueSkipper skipper(buffer);
+  EXPECT_TRUE(skipper.skipValue());
+  EXPECT_EQ(buffer.length(), skipper.offset());
+
+  Buffer::OwnedImpl too_deep_buffer(nested_lists(Hessian2ValueSkipper::MaxDepth + 1));
+  Hessian2ValueSkipper too_deep_skipper(too_deep_buffer);
+  EXPECT_FALSE(too_deep_skipper.skipValue());
+}
+
 } // namespace
 } // namespace Dubbo
 } // namespace Common
@@ -0,0 +1,99 @@
+// Benchmarks for reading the attachments of Dubbo requests with large arguments, as the Dubbo
+// codecs do to route a request. Each benchmark runs with and without skipping the arguments.
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/common/dubbo/message.h"
+
+#include "test/test_common/test_runtime.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Dubbo {
+namespace {
+
+// Encodes a request whose arguments are a string of `size` bytes and a map of `size / 64`
+// entries, followed by a few attachments.
+std::string encodeRequest(uint64_t size) {
+  Hessian2::Object::UntypedMap map;
+  for (uint64_t i = 0; i < size / 64; ++i) {
+    map.emplace(std::make_unique<Hessian2::StringObject>(absl::StrCat("key", i)),
+                std::make_unique<Hessian2::StringObject>(std::string(56, 'v')));
+  }
+
+  ArgumentVec args;
+  args.push_back(std::make_unique<Hessian2::StringObject>(std::string(size, 'a')));
+  args.push_back(std::make_unique<Hessian2::UntypedMapObject>(std::move(map)));
+
+  Attachments attachs;
+  attachs.emplace("group", "group");
+  attachs.emplace("version", "1.0.0");
+  attachs.emplace("timeout", "3000");
+
+  RequestContent content;
+  content.initialize("Ljava/lang/String;Ljava/util/Map;", std::move(args), std::move(attachs));
+  return content.buffer().toString();
+}
+
+// Reads the group attachment of a request with arguments of range(0) bytes and forwards the
+// content, with the arguments skipped if range(1) is non-zero.
+static void bmRequestAttachments(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.dubbo_skip_arguments_for_attachments",
+                               state.range(1) != 0 ? "true" : "false"}});
+  const std::string wire = encodeRequest(state.range(0));
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    Buffer::OwnedImpl data(wire);
+    state.ResumeTiming();
+    RequestContent content;
+    content.initialize(data, data.length());
+    benchmark::DoNotOptimize(content.attachments().at("group"));
+    benchmark::DoNotOptimize(content.buffer().length());
+  }
+  state.SetBytesProcessed(state.iterations() * wire.size());
+}
+BENCHMARK(bmRequestAttachments)
+    ->ArgsProduct({{1024, 16 * 1024, 64 * 1024, 256 * 1024}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Reads and updates the attachments of a response with a result of range(0) bytes, with the result
+// skipped if range(1) is non-zero.
+static void bmResponseAttachments(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.dubbo_skip_arguments_for_attachments",
+                               state.range(1) != 0 ? "true" : "false"}});
+  Hessian2::Object::UntypedList list;
+  for (uint64_t i = 0; i < static_cast<uint64_t>(state.range(0)) / 64; ++i) {
+    list.push_back(std::make_unique<Hessian2::StringObject>(std::string(62, 'v')));
+  }
+  ResponseContent encoder;
+  encoder.initialize(std::make_unique<Hessian2::UntypedListObject>(std::move(list)),
+                     Attachments{{"group", "group"}});
+  const std::string wire = encoder.buffer().toString();
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    Buffer::OwnedImpl data(wire);
+    state.ResumeTiming();
+    ResponseContent content;
+    content.initialize(data, data.length());
+    content.setAttachment("trace", "abc");
+    benchmark::DoNotOptimize(content.buffer().length());
+  }
+  state.SetBytesProcessed(state.iterations() * wire.size());
+}
+BENCHMARK(bmResponseAttachments)
+    ->ArgsProduct({{1024, 16 * 1024, 64 * 1024, 256 * 1024}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Dubbo
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
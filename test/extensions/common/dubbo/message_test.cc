@@ -1,6 +1,7 @@
 #include "source/extensions/common/dubbo/message.h"
 
 #include "test/test_common/printers.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -406,6 +407,98 @@ TEST(RpcRequestTest, InitializeWithDecodedValuesTest) {
                                                    }));
 }
 
+// The arguments are skipped when only the attachments are accessed, and decoded later on demand.
+TEST(RpcRequestTest, DecodeAttachmentsBeforeArgumentsTest) {
+  const std::string content({
+      0x2, 'Z', 'Z',                // The types string
+      0x5, 'h', 'e', 'l', 'l', 'o', // The first argument
+      'H', 0x1, 'k', '\x91', 'Z',   // The second argument
+      'H',                          // Attachments start
+      0x5, 'g', 'r', 'o', 'u', 'p', // Key
+      0x5, 'g', 'r', 'o', 'u', 'p', // Value
+      'Z'                           // Attachments end
+  });
+  const std::string updated_content({
+      0x2, 'Z', 'Z',                     // The types string
+      0x5, 'h', 'e', 'l', 'l', 'o',      // The first argument
+      'H', 0x1, 'k', '\x91', 'Z',        // The second argument
+      'H',                               // Attachments start
+      0x5, 'g', 'r', 'o', 'u', 'p',      // Key
+      0x6, 'g', 'r', 'o', 'u', 'p', 'x', // Value
+      'Z'                                // Attachments end
+  });
+
+  for (const bool skip_arguments : {true, false}) {
+    TestScopedRuntime scoped_runtime;
+    scoped_runtime.mergeValues({{"envoy.reloadable_features.dubbo_skip_arguments_for_attachments",
+                                 skip_arguments ? "true" : "false"}});
+
+    RpcRequest request("a", "b", "c", "d");
+    Buffer::OwnedImpl buffer(content);
+    request.content().initialize(buffer, buffer.length());
+
+    EXPECT_EQ("group", request.content().attachments().at("group"));
+
+    // The content is not changed if the attachments are not updated.
+    EXPECT_EQ(content, request.content().buffer().toString());
+
+    request.content().setAttachment("group", "groupx");
+    EXPECT_EQ(updated_content, request.content().buffer().toString());
+
+    // The arguments are decoded and the updated attachments are kept.
+    const auto& args = request.content().arguments();
+    EXPECT_EQ(2, args.size());
+    EXPECT_EQ("hello", args[0]->toString().value().get());
+    EXPECT_EQ(Hessian2::Object::Type::UntypedMap, args[1]->type());
+    EXPECT_EQ("groupx", request.content().attachments().at("group"));
+    EXPECT_EQ(updated_content, request.content().buffer().toString());
+  }
+}
+
+TEST(RpcRequestTest, DecodeAttachmentsFallbackTest) {
+  // The attachments refer to a class definition in the arguments, so they cannot be decoded
+  // alone.
+  {
+    RpcRequest request("a", "b", "c", "d");
+    Buffer::OwnedImpl buffer(std::string({
+        0x2, 'Z', 'Z',                                  // The types string
+        'C', 0x4, 'T', 'e', 's', 't', '\x91', 0x1, 'a', // Class definition
+        0x60, '\x91',                                   // The first argument
+        'T',                                            // The second argument
+        'H',                                            // Attachments start
+        0x5, 'g', 'r', 'o', 'u', 'p',                   // Key
+        0x5, 'g', 'r', 'o', 'u', 'p',                   // Value
+        0x1, 'o',                                       // Key
+        0x60, '\x92',                                   // Value
+        'Z'                                             // Attachments end
+    }));
+    request.content().initialize(buffer, buffer.length());
+
+    // Only string key and value are used.
+    EXPECT_EQ(1, request.content().attachments().size());
+    EXPECT_EQ("group", request.content().attachments().at("group"));
+    EXPECT_EQ(2, request.content().arguments().size());
+  }
+
+  // Broken arguments.
+  {
+    RpcRequest request("a", "b", "c", "d");
+    Buffer::OwnedImpl buffer(std::string({
+        0x1, 'Z', // The types string
+        0x40,     // Reserved tag
+        'H',      // Attachments start
+        'Z'       // Attachments end
+    }));
+    request.content().initialize(buffer, buffer.length());
+
+    EXPECT_TRUE(request.content().attachments().empty());
+
+    // The content is broken, so the content will be reset to an empty state:
+    // empty types, empty arguments, empty attachments.
+    EXPECT_EQ(request.content().buffer().toString(), std::string({0x0, 'H', 'Z'}));
+  }
+}
+
 TEST(RpcResponseTest, SimpleSetAndGetTest) {
   RpcResponse response;
 
@@ -566,6 +659,38 @@ TEST(RpcResponseTest, InitializeWithDecodedValuesTest) {
                                                     }));
 }
 
+// The result is skipped when only the attachments are accessed, and decoded later on demand.
+TEST(RpcResponseTest, DecodeAttachmentsBeforeResultTest) {
+  RpcResponse response;
+
+  Buffer::OwnedImpl buffer(std::string({
+      'H', 0x1, 'k', '\x91', 'Z',   // The result
+      'H',                          // Attachments start
+      0x5, 'g', 'r', 'o', 'u', 'p', // Key
+      0x5, 'g', 'r', 'o', 'u', 'p', // Value
+      'Z'                           // Attachments end
+  }));
+  response.content().initialize(buffer, buffer.length());
+
+  EXPECT_EQ("group", response.content().attachments().at("group"));
+
+  response.content().delAttachment("group");
+  EXPECT_EQ(response.content().buffer().toString(), std::string({
+                                                        'H', 0x1, 'k', '\x91', 'Z', // The result
+                                                        'H', // Attachments start
+                                                        'Z'  // Attachments end
+                                                    }));
+
+  // The result is decoded when the buffer is moved, so the content can be re-encoded.
+  Buffer::OwnedImpl buffer2;
+  response.content().bufferMoveTo(buffer2);
+  EXPECT_EQ(response.content().buffer().toString(), buffer2.toString());
+
+  // The updated attachments are kept.
+  EXPECT_EQ(Hessian2::Object::Type::UntypedMap, response.content().result()->type());
+  EXPECT_TRUE(response.content().attachments().empty());
+}
+
 } // namespace
 } // namespace Dubbo
 } // namespace Common
@@ -11,6 +11,7 @@
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/priority_set.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -93,11 +94,19 @@ public:
     }
   }
 
+  // The tests that post several callbacks before running the main thread dispatcher cover the time
+  // based rate limiting only, so they disable the deduplication of the pending callbacks.
+  void disableDedup() {
+    scoped_runtime_.mergeValues(
+        {{"envoy.reloadable_features.redis_cluster_refresh_dedup", "false"}});
+  }
+
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr clusterInfo(const std::string& cluster_name) {
     Thread::LockGuard lock(refresh_manager_->map_mutex_);
     return refresh_manager_->info_map_[cluster_name];
   }
 
+  TestScopedRuntime scoped_runtime_;
   const std::string cluster_name_;
   Api::ApiPtr api_ = Api::createApiForTest();
   Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
@@ -120,6 +129,7 @@ public:
 // registered via 2 threads. The manager is notified of events on valid registered clusters and
 // invalid unregistered cluster names.
 TEST_F(ClusterRefreshManagerTest, Basic) {
+  disableDedup();
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
                                               1, [&]() { callback_count_++; });
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
@@ -165,6 +175,7 @@ TEST_F(ClusterRefreshManagerTest, Basic) {
 // registered via 2 threads. The manager is notified of events on valid registered clusters and
 // invalid unregistered cluster names.
 TEST_F(ClusterRefreshManagerTest, BasicFailureEvents) {
+  disableDedup();
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
                                               1, [&]() { callback_count_++; });
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
@@ -211,6 +222,7 @@ TEST_F(ClusterRefreshManagerTest, BasicFailureEvents) {
 // registered via 2 threads. The manager is notified of events on valid registered clusters and
 // invalid unregistered cluster names.
 TEST_F(ClusterRefreshManagerTest, BasicDegradedEvents) {
+  disableDedup();
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
                                               1, [&]() { callback_count_++; });
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
@@ -257,6 +269,7 @@ TEST_F(ClusterRefreshManagerTest, BasicDegradedEvents) {
 // is advanced without thread synchronization for up to 2 seconds during the threads' activity
 // to simulate possible thread timing issues.
 TEST_F(ClusterRefreshManagerTest, HighVolume) {
+  disableDedup();
   handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::seconds(2), 1000, 1000,
                                               1000, [&]() { callback_count_++; });
   ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
@@ -300,6 +313,30 @@ TEST_F(ClusterRefreshManagerTest, HighVolume) {
   EXPECT_EQ(callback_count_, 30);
 }
 
+// A callback is not posted again while the previous one is still pending on the main thread.
+TEST_F(ClusterRefreshManagerTest, PendingCallbackDedup) {
+  handle_ = refresh_manager_->registerCluster(cluster_name_, std::chrono::milliseconds(1000), 1, 1,
+                                              1, [&]() { callback_count_++; });
+  ClusterRefreshManagerImpl::ClusterInfoSharedPtr cluster_info = clusterInfo(cluster_name_);
+
+  EXPECT_TRUE(refresh_manager_->onRedirection(cluster_name_));
+  EXPECT_TRUE(cluster_info->callback_pending_);
+
+  // The main thread has not run the callback yet.
+  advanceTime(MonotonicTime(std::chrono::seconds(3)));
+  EXPECT_FALSE(refresh_manager_->onFailure(cluster_name_));
+  EXPECT_EQ(cluster_info->failures_count_, 0);
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(callback_count_, 1);
+  EXPECT_FALSE(cluster_info->callback_pending_);
+
+  advanceTime(MonotonicTime(std::chrono::seconds(5)));
+  EXPECT_TRUE(refresh_manager_->onHostDegraded(cluster_name_));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(callback_count_, 2);
+}
+
 // This test exercises the redirection manager's basic functionality with redirect/failure/host
 // degraded events are disabled by setting the threshold to 0
 TEST_F(ClusterRefreshManagerTest, FeatureDisabled) {
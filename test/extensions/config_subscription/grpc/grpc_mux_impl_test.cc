@@ -95,7 +95,9 @@ public:
             random_),
         /*target_xds_authority_=*/"",
         /*eds_resources_cache_=*/std::unique_ptr<MockEdsResourcesCache>(eds_resources_cache_),
-        /*skip_subsequent_node_=*/true};
+        /*skip_subsequent_node_=*/true,
+        /*load_stats_reporter_factory_=*/nullptr,
+        /*resource_decode_pool_=*/std::move(resource_decode_pool_)};
     grpc_mux_ = std::make_unique<GrpcMuxImpl>(grpc_mux_context);
   }
 
@@ -148,6 +150,7 @@ public:
   NiceMock<MockXdsResourcesDelegate> resources_delegate_;
   bool use_config_tracker_{false};
   bool use_resources_delegate_{false};
+  ResourceDecodePoolPtr resource_decode_pool_;
 };
 
 class GrpcMuxImplTest : public GrpcMuxImplTestBase {
@@ -683,6 +686,48 @@ TEST_P(GrpcMuxImplTest, WildcardWatch) {
   }
 }
 
+// Validate that resources decoded on multiple threads are delivered in response order.
+TEST_P(GrpcMuxImplTest, ConcurrentResourceDecode) {
+  Api::ApiPtr api = Api::createApiForTest();
+  envoy::config::core::v3::ResourceDecodeSettings settings;
+  settings.set_concurrency(4);
+  settings.mutable_min_resources_per_thread()->set_value(2);
+  resource_decode_pool_ = std::make_unique<ResourceDecodePool>(
+      api->threadFactory(), time_system_, *stats_.rootScope(), settings);
+  setup();
+
+  InSequence s;
+  const std::string& type_url = Config::TestTypeUrl::get().ClusterLoadAssignment;
+  OpaqueResourceDecoderSharedPtr resource_decoder(
+      std::make_shared<TestUtility::TestOpaqueResourceDecoderImpl<
+          envoy::config::endpoint::v3::ClusterLoadAssignment>>("cluster_name"));
+  auto foo_sub = grpc_mux_->addWatch(type_url, {}, callbacks_, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {}, "", true);
+  grpc_mux_->start();
+
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+  response->set_type_url(type_url);
+  response->set_version_info("1");
+  for (int i = 0; i < 10; ++i) {
+    envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name(absl::StrCat("cluster_", i));
+    std::ignore = response->add_resources()->PackFrom(load_assignment);
+  }
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1"))
+      .WillOnce(Invoke([](const std::vector<DecodedResourceRef>& resources, const std::string&) {
+        EXPECT_EQ(10, resources.size());
+        for (int i = 0; i < 10; ++i) {
+          EXPECT_EQ(absl::StrCat("cluster_", i), resources[i].get().name());
+        }
+        return absl::OkStatus();
+      }));
+  expectSendMessage(type_url, {}, "1");
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+  EXPECT_EQ(1, stats_.counter("control_plane.resource_decode.concurrent_decode").value());
+  EXPECT_TRUE(stats_.histogramRecordedValues("control_plane.resource_decode.update_time"));
+}
+
 // Validate behavior when watches specify resources (potentially overlapping).
 TEST_P(GrpcMuxImplTest, WatchDemux) {
   setup();
@@ -1689,13 +1734,14 @@ TEST(GrpcMuxFactoryTest, InvalidRateLimit) {
   NiceMock<Stats::MockStore> store;
   Stats::MockScope& scope{store.mockScope()};
   NiceMock<LocalInfo::MockLocalInfo> local_info;
+  Api::ApiPtr api = Api::createApiForTest();
   envoy::config::core::v3::ApiConfigSource ads_config;
   ads_config.mutable_rate_limit_settings()->mutable_max_tokens()->set_value(100);
   ads_config.mutable_rate_limit_settings()->mutable_fill_rate()->set_value(
       std::numeric_limits<double>::quiet_NaN());
   EXPECT_THROW(factory->create(std::make_unique<Grpc::MockAsyncClient>(), nullptr, dispatcher,
                                random, scope, ads_config, local_info, nullptr, nullptr,
-                               std::nullopt, std::nullopt, nullptr),
+                               std::nullopt, std::nullopt, nullptr, *api),
                EnvoyException);
 }
 
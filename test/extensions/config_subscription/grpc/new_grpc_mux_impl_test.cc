@@ -1091,13 +1091,14 @@ TEST(NewGrpcMuxFactoryTest, InvalidRateLimit) {
   NiceMock<Stats::MockStore> store;
   Stats::MockScope& scope{store.mockScope()};
   NiceMock<LocalInfo::MockLocalInfo> local_info;
+  Api::ApiPtr api = Api::createApiForTest();
   envoy::config::core::v3::ApiConfigSource ads_config;
   ads_config.mutable_rate_limit_settings()->mutable_max_tokens()->set_value(100);
   ads_config.mutable_rate_limit_settings()->mutable_fill_rate()->set_value(
       std::numeric_limits<double>::quiet_NaN());
   EXPECT_THROW(factory->create(std::make_unique<Grpc::MockAsyncClient>(), nullptr, dispatcher,
                                random, scope, ads_config, local_info, nullptr, nullptr,
-                               std::nullopt, std::nullopt, nullptr),
+                               std::nullopt, std::nullopt, nullptr, *api),
                EnvoyException);
 }
 
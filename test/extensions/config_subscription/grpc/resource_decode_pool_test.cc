@@ -0,0 +1,203 @@
+#include "envoy/config/endpoint/v3/endpoint.pb.h"
+#include "envoy/config/endpoint/v3/endpoint.pb.validate.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "source/extensions/config_subscription/grpc/resource_decode_pool.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/config/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+class ResourceDecodePoolTest : public testing::Test {
+protected:
+  ResourceDecodePoolTest()
+      : api_(Api::createApiForTest()), resource_decoder_("cluster_name") {}
+
+  void setup(uint32_t concurrency, uint32_t min_resources_per_thread) {
+    envoy::config::core::v3::ResourceDecodeSettings settings;
+    settings.set_concurrency(concurrency);
+    settings.mutable_min_resources_per_thread()->set_value(min_resources_per_thread);
+    pool_ = std::make_unique<ResourceDecodePool>(api_->threadFactory(), time_system_,
+                                                 *store_.rootScope(), settings);
+  }
+
+  void addResources(uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+      envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+      load_assignment.set_cluster_name(absl::StrCat("cluster_", resources_.size()));
+      resources_.Add()->PackFrom(load_assignment);
+    }
+  }
+
+  void expectInOrder(const std::vector<DecodedResourcePtr>& decoded_resources) {
+    ASSERT_EQ(resources_.size(), decoded_resources.size());
+    for (uint32_t i = 0; i < decoded_resources.size(); ++i) {
+      EXPECT_EQ(absl::StrCat("cluster_", i), decoded_resources[i]->name());
+      EXPECT_EQ("1", decoded_resources[i]->version());
+    }
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  Stats::TestUtil::TestStore store_;
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder_;
+  Protobuf::RepeatedPtrField<Protobuf::Any> resources_;
+  ResourceDecodePoolPtr pool_;
+};
+
+// Small responses are decoded on the main thread.
+TEST_F(ResourceDecodePoolTest, SerialBelowThreshold) {
+  setup(4, 10);
+  addResources(19);
+  auto decoded_or_error = pool_->decode(resource_decoder_, resources_, "1");
+  ASSERT_TRUE(decoded_or_error.ok());
+  expectInOrder(decoded_or_error.value());
+  EXPECT_EQ(1, store_.counter("control_plane.resource_decode.serial_decode").value());
+  EXPECT_EQ(0, store_.counter("control_plane.resource_decode.concurrent_decode").value());
+}
+
+// Concurrency of 1 never spawns threads.
+TEST_F(ResourceDecodePoolTest, SerialWithoutConcurrency) {
+  setup(1, 1);
+  addResources(100);
+  auto decoded_or_error = pool_->decode(resource_decoder_, resources_, "1");
+  ASSERT_TRUE(decoded_or_error.ok());
+  expectInOrder(decoded_or_error.value());
+  EXPECT_EQ(1, store_.counter("control_plane.resource_decode.serial_decode").value());
+}
+
+// Large responses are decoded on multiple threads and returned in response order.
+TEST_F(ResourceDecodePoolTest, ConcurrentPreservesOrder) {
+  setup(4, 10);
+  addResources(1001);
+  auto decoded_or_error = pool_->decode(resource_decoder_, resources_, "1");
+  ASSERT_TRUE(decoded_or_error.ok());
+  expectInOrder(decoded_or_error.value());
+  EXPECT_EQ(0, store_.counter("control_plane.resource_decode.serial_decode").value());
+  EXPECT_EQ(1, store_.counter("control_plane.resource_decode.concurrent_decode").value());
+}
+
+// Counts the threads created by the pool.
+class CountingThreadFactory : public Thread::ThreadFactory {
+public:
+  explicit CountingThreadFactory(Thread::ThreadFactory& parent) : parent_(parent) {}
+
+  Thread::ThreadPtr createThread(std::function<void()> thread_routine,
+                                 Thread::OptionsOptConstRef options) override {
+    ++threads_created_;
+    return parent_.createThread(std::move(thread_routine), options);
+  }
+  Thread::ThreadId currentThreadId() const override { return parent_.currentThreadId(); }
+
+  Thread::ThreadFactory& parent_;
+  uint32_t threads_created_{};
+};
+
+// The worker threads are started once and reused for every response.
+TEST_F(ResourceDecodePoolTest, ConcurrentReusesThreads) {
+  CountingThreadFactory thread_factory(api_->threadFactory());
+  envoy::config::core::v3::ResourceDecodeSettings settings;
+  settings.set_concurrency(4);
+  settings.mutable_min_resources_per_thread()->set_value(10);
+  pool_ = std::make_unique<ResourceDecodePool>(thread_factory, time_system_, *store_.rootScope(),
+                                               settings);
+  EXPECT_EQ(3, thread_factory.threads_created_);
+
+  addResources(1001);
+  for (int i = 0; i < 3; ++i) {
+    auto decoded_or_error = pool_->decode(resource_decoder_, resources_, "1");
+    ASSERT_TRUE(decoded_or_error.ok());
+    expectInOrder(decoded_or_error.value());
+  }
+  EXPECT_EQ(3, store_.counter("control_plane.resource_decode.concurrent_decode").value());
+  EXPECT_EQ(3, thread_factory.threads_created_);
+  pool_.reset();
+}
+
+// Resources wrapped in a Resource keep the wrapper's metadata.
+TEST_F(ResourceDecodePoolTest, ConcurrentWrappedResources) {
+  setup(2, 1);
+  for (uint32_t i = 0; i < 4; ++i) {
+    envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name(absl::StrCat("cluster_", i));
+    envoy::service::discovery::v3::Resource resource;
+    resource.set_name(absl::StrCat("cluster_", i));
+    resource.add_aliases(absl::StrCat("alias_", i));
+    resource.mutable_ttl()->set_seconds(i + 1);
+    resource.mutable_resource()->PackFrom(load_assignment);
+    resources_.Add()->PackFrom(resource);
+  }
+  auto decoded_or_error = pool_->decode(resource_decoder_, resources_, "1");
+  ASSERT_TRUE(decoded_or_error.ok());
+  expectInOrder(decoded_or_error.value());
+  for (uint32_t i = 0; i < 4; ++i) {
+    const DecodedResource& resource = *decoded_or_error.value()[i];
+    EXPECT_EQ(std::vector<std::string>{absl::StrCat("alias_", i)}, resource.aliases());
+    EXPECT_EQ(std::chrono::milliseconds((i + 1) * 1000), resource.ttl());
+    EXPECT_TRUE(resource.hasResource());
+  }
+}
+
+// When several resources violate their constraints, the first one in response order is reported,
+// regardless of which thread decoded it.
+TEST_F(ResourceDecodePoolTest, ConcurrentReportsFirstError) {
+  setup(4, 1);
+  addResources(8);
+  envoy::config::endpoint::v3::ClusterLoadAssignment missing_name;
+  resources_[6].PackFrom(missing_name);
+  envoy::config::endpoint::v3::ClusterLoadAssignment invalid_policy;
+  invalid_policy.set_cluster_name("cluster_2");
+  invalid_policy.mutable_policy()->mutable_overprovisioning_factor()->set_value(0);
+  resources_[2].PackFrom(invalid_policy);
+  auto decoded_or_error = pool_->decode(resource_decoder_, resources_, "1");
+  ASSERT_FALSE(decoded_or_error.ok());
+  const std::string message(decoded_or_error.status().message());
+  EXPECT_THAT(message, testing::HasSubstr("OverprovisioningFactor"));
+  EXPECT_THAT(message, testing::Not(testing::HasSubstr("ClusterName")));
+}
+
+// Unknown fields are rejected by the validation visitor on the main thread.
+TEST_F(ResourceDecodePoolTest, ConcurrentRejectsUnknownFields) {
+  setup(2, 1);
+  addResources(4);
+  // Field 500 with varint value 1.
+  resources_[3].mutable_value()->append("\xa0\x1f\x01");
+  EXPECT_THROW_WITH_REGEX(pool_->decode(resource_decoder_, resources_, "1").IgnoreError(),
+                          EnvoyException, "has unknown fields");
+}
+
+// Decoders that cannot decode off the main thread are used on the main thread.
+TEST_F(ResourceDecodePoolTest, ConcurrentFallsBackForUnsupportedDecoder) {
+  setup(2, 1);
+  addResources(4);
+  testing::NiceMock<MockOpaqueResourceDecoder> mock_decoder;
+  EXPECT_CALL(mock_decoder, decodeResource(testing::_))
+      .Times(4)
+      .WillRepeatedly(
+          testing::Invoke([](const Protobuf::Any& resource) -> ProtobufTypes::MessagePtr {
+            auto message = std::make_unique<envoy::config::endpoint::v3::ClusterLoadAssignment>();
+            EXPECT_TRUE(resource.UnpackTo(message.get()));
+            return message;
+          }));
+  EXPECT_CALL(mock_decoder, resourceName(testing::_))
+      .Times(4)
+      .WillRepeatedly(testing::Invoke([](const Protobuf::Message& resource) {
+        return dynamic_cast<const envoy::config::endpoint::v3::ClusterLoadAssignment&>(resource)
+            .cluster_name();
+      }));
+  auto decoded_or_error = pool_->decode(mock_decoder, resources_, "1");
+  ASSERT_TRUE(decoded_or_error.ok());
+  expectInOrder(decoded_or_error.value());
+}
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
@@ -4,6 +4,7 @@
 #include "test/test_common/utility.h"
 
 #include "absl/time/time.h"
+#include "cel/expr/syntax.pb.h"
 #include "eval/public/structs/cel_proto_wrapper.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -56,6 +57,73 @@ TEST(Evaluator, Activation) {
   EXPECT_TRUE(activation->FindValue("upstream_filter_state", &arena).has_value());
 }
 
+TEST(Evaluator, ReusableActivation) {
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  const Http::TestRequestHeaderMapImpl headers{{":path", "/foo"}};
+  const Http::TestRequestHeaderMapImpl other_headers{{":path", "/bar"}};
+
+  // The attributes are kept for the same stream data.
+  ReusableActivation* activation =
+      &ReusableActivation::get(nullptr, info, &headers, nullptr, nullptr);
+  const auto request = activation->FindValue("request", &activation->arena());
+  ASSERT_TRUE(request.has_value());
+  activation = &ReusableActivation::get(nullptr, info, &headers, nullptr, nullptr);
+  EXPECT_EQ(request->MapOrDie(),
+            activation->FindValue("request", &activation->arena())->MapOrDie());
+
+  // The attributes created in another arena don't outlive their evaluation.
+  Protobuf::Arena arena;
+  EXPECT_NE(request->MapOrDie(), activation->FindValue("request", &arena)->MapOrDie());
+
+  // Neither are the filter states.
+  const auto filter_state = activation->FindValue("filter_state", &activation->arena());
+  ASSERT_TRUE(filter_state.has_value());
+  EXPECT_NE(filter_state->MapOrDie(),
+            activation->FindValue("filter_state", &activation->arena())->MapOrDie());
+
+  // The use of the response attributes is tracked per evaluation.
+  EXPECT_TRUE(activation->FindValue("response", &activation->arena()).has_value());
+  EXPECT_TRUE(activation->needs_response_path_data());
+  activation = &ReusableActivation::get(nullptr, info, &headers, nullptr, nullptr);
+  EXPECT_FALSE(activation->needs_response_path_data());
+
+  // The attributes are created again for other stream data.
+  activation = &ReusableActivation::get(nullptr, info, &other_headers, nullptr, nullptr);
+  const auto other_request = activation->FindValue("request", &activation->arena());
+  ASSERT_TRUE(other_request.has_value());
+  const auto path = (*other_request->MapOrDie())[CelValue::CreateStringView("path")];
+  ASSERT_TRUE(path.has_value());
+  EXPECT_EQ("/bar", path->StringOrDie().value());
+}
+
+TEST(Evaluator, MatchesReusingActivation) {
+  // request.path == "/foo"
+  cel::expr::Expr expr;
+  auto* call = expr.mutable_call_expr();
+  call->set_function("_==_");
+  auto* select = call->add_args()->mutable_select_expr();
+  select->mutable_operand()->mutable_ident_expr()->set_name("request");
+  select->set_field("path");
+  call->add_args()->mutable_const_expr()->set_string_value("/foo");
+
+  auto compiled =
+      CompiledExpression::Create(std::make_shared<BuilderInstance>(createBuilder()), expr);
+  ASSERT_TRUE(compiled.ok());
+
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  const Http::TestRequestHeaderMapImpl headers{{":path", "/foo"}};
+  const Http::TestRequestHeaderMapImpl other_headers{{":path", "/bar"}};
+  EXPECT_TRUE(compiled->matches(info, headers));
+  EXPECT_TRUE(compiled->matches(info, headers));
+  EXPECT_FALSE(compiled->matches(info, other_headers));
+  EXPECT_TRUE(compiled->matches(info, headers));
+
+  const auto result = compiled->evaluateReusingActivation(nullptr, info, &other_headers, nullptr,
+                                                          nullptr);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_FALSE(result->BoolOrDie());
+}
+
 } // namespace
 } // namespace Expr
 } // namespace Common
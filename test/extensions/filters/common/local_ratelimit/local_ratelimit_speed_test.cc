@@ -0,0 +1,70 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares the workers consuming the tokens of a shared bucket directly with the workers leasing
+// batches of tokens from it. The bucket never runs out of tokens, so that the benchmarks measure
+// the cost of sharing it.
+
+#include <chrono>
+#include <memory>
+
+#include "source/common/event/real_time_system.h"
+#include "source/extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
+
+#include "test/mocks/event/mocks.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+namespace {
+
+Event::RealTimeSystem time_system;
+RateLimitTokenBucketSharedPtr shared_token_bucket;
+
+void initSharedTokenBucket(const benchmark::State&) {
+  shared_token_bucket = std::make_shared<RateLimitTokenBucket>(
+      1'000'000'000, 1'000'000'000, std::chrono::milliseconds(50), time_system, false);
+}
+void destroySharedTokenBucket(const benchmark::State&) { shared_token_bucket.reset(); }
+
+// Every worker consumes the tokens of the shared bucket.
+void bmSharedTokenBucket(benchmark::State& state) {
+  RateLimitTokenBucket& token_bucket = *shared_token_bucket;
+  for (auto _ : state) { // NOLINT
+    const bool allowed = token_bucket.consume();
+    benchmark::DoNotOptimize(allowed);
+  }
+}
+BENCHMARK(bmSharedTokenBucket)
+    ->ThreadRange(1, 64)
+    ->UseRealTime()
+    ->Setup(initSharedTokenBucket)
+    ->Teardown(destroySharedTokenBucket);
+
+// Every worker consumes the tokens it leases from the shared bucket, range(0) tokens at a time.
+void bmLeasedTokenBucket(benchmark::State& state) {
+  testing::NiceMock<Event::MockDispatcher> dispatcher;
+  TokenLeases token_leases(state.range(0), std::chrono::milliseconds(100), dispatcher);
+  for (auto _ : state) { // NOLINT
+    const bool allowed = token_leases.consume(shared_token_bucket, 1.0, 1);
+    benchmark::DoNotOptimize(allowed);
+  }
+}
+BENCHMARK(bmLeasedTokenBucket)
+    ->Arg(16)
+    ->Arg(256)
+    ->ThreadRange(1, 64)
+    ->UseRealTime()
+    ->Setup(initSharedTokenBucket)
+    ->Teardown(destroySharedTokenBucket);
+
+} // namespace
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -2,6 +2,7 @@
 #include "source/extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
 
 #include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/cluster_priority_set.h"
 #include "test/test_common/test_runtime.h"
@@ -127,6 +128,7 @@ public:
 
   std::vector<Envoy::RateLimit::Descriptor> route_descriptors_;
   NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
   std::shared_ptr<LocalRateLimiterImpl> rate_limiter_;
 };
 
@@ -828,6 +830,98 @@ TEST_F(LocalRateLimiterDescriptorImplTest, IsNegativeRefillsTokens) {
   EXPECT_EQ(result.token_bucket_context->remainingTokens(), 2);
 }
 
+class TokenLeasesTest : public testing::Test {
+public:
+  TokenLeasesTest()
+      // A bucket which doesn't refill during the tests.
+      : token_bucket_(std::make_shared<RateLimitTokenBucket>(
+            10, 1, std::chrono::hours(24), dispatcher_.timeSource(), false)) {}
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  RateLimitTokenBucketSharedPtr token_bucket_;
+};
+
+TEST_F(TokenLeasesTest, ConsumeLeasedTokens) {
+  auto* expiry_timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  TokenLeases leases(4, std::chrono::milliseconds(100), dispatcher_);
+
+  EXPECT_CALL(*expiry_timer, enableTimer(std::chrono::milliseconds(100), _));
+  EXPECT_TRUE(leases.consume(token_bucket_, 1.0, 1));
+  EXPECT_EQ(6, token_bucket_->remainingTokens());
+
+  // The leased tokens are consumed without touching the bucket.
+  EXPECT_TRUE(leases.consume(token_bucket_, 1.0, 1));
+  EXPECT_TRUE(leases.consume(token_bucket_, 1.0, 2));
+  EXPECT_EQ(6, token_bucket_->remainingTokens());
+
+  // A new batch is leased once the lease is used up, and the last tokens of the bucket are leased
+  // when a full batch isn't available.
+  EXPECT_TRUE(leases.consume(token_bucket_, 1.0, 1));
+  EXPECT_EQ(2, token_bucket_->remainingTokens());
+  EXPECT_TRUE(leases.consume(token_bucket_, 1.0, 3));
+  EXPECT_TRUE(leases.consume(token_bucket_, 1.0, 2));
+  EXPECT_EQ(0, token_bucket_->remainingTokens());
+  EXPECT_FALSE(leases.consume(token_bucket_, 1.0, 1));
+  EXPECT_EQ(0, leases.size());
+}
+
+TEST_F(TokenLeasesTest, ReturnUnusedTokens) {
+  auto* expiry_timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  TokenLeases leases(4, std::chrono::milliseconds(100), dispatcher_);
+
+  EXPECT_TRUE(leases.consume(token_bucket_, 1.0, 1));
+  EXPECT_EQ(6, token_bucket_->remainingTokens());
+
+  // The lease isn't returned before it expires.
+  expiry_timer->invokeCallback();
+  EXPECT_EQ(1, leases.size());
+  EXPECT_TRUE(expiry_timer->enabled());
+
+  dispatcher_.globalTimeSystem().advanceTimeWait(std::chrono::milliseconds(100));
+  expiry_timer->invokeCallback();
+  EXPECT_EQ(0, leases.size());
+  EXPECT_EQ(9, token_bucket_->remainingTokens());
+
+  // A lease needing more tokens than it has left is returned before leasing a new batch.
+  EXPECT_TRUE(leases.consume(token_bucket_, 1.0, 3));
+  EXPECT_EQ(5, token_bucket_->remainingTokens());
+  EXPECT_TRUE(leases.consume(token_bucket_, 1.0, 2));
+  EXPECT_EQ(2, token_bucket_->remainingTokens());
+}
+
+TEST_F(TokenLeasesTest, ReturnTokensOnDestruction) {
+  {
+    TokenLeases leases(4, std::chrono::milliseconds(100), dispatcher_);
+    EXPECT_TRUE(leases.consume(token_bucket_, 1.0, 1));
+    EXPECT_EQ(6, token_bucket_->remainingTokens());
+  }
+  EXPECT_EQ(9, token_bucket_->remainingTokens());
+}
+
+TEST_F(TokenLeasesTest, ShareFactor) {
+  TokenLeases leases(2, std::chrono::milliseconds(100), dispatcher_);
+  // With half the share, a request consumes 2 tokens of the bucket and a lease holds 4.
+  EXPECT_TRUE(leases.consume(token_bucket_, 0.5, 1));
+  EXPECT_EQ(6, token_bucket_->remainingTokens());
+  EXPECT_TRUE(leases.consume(token_bucket_, 0.5, 1));
+  EXPECT_EQ(6, token_bucket_->remainingTokens());
+}
+
+TEST_F(LocalRateLimiterImplTest, TokenLeasing) {
+  initializeWithAtomicTokenBucket(std::chrono::hours(24), 10, 1);
+  rate_limiter_->enableTokenLeasing(tls_, 4, std::chrono::milliseconds(100));
+
+  auto result = rate_limiter_->requestAllowed(route_descriptors_);
+  EXPECT_TRUE(result.allowed);
+  EXPECT_EQ(6, result.token_bucket_context->remainingTokens());
+
+  // The limiter admits no more requests than the bucket has tokens.
+  for (int i = 0; i < 9; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_).allowed);
+  }
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_).allowed);
+}
+
 } // Namespace LocalRateLimit
 } // namespace Common
 } // namespace Filters
@@ -0,0 +1,361 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/service/ratelimit/v3/rls.pb.h"
+
+#include "source/common/http/header_map_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/common/ratelimit/over_limit_cache.h"
+
+#include "test/extensions/filters/common/ratelimit/mocks.h"
+#include "test/mocks/common.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/mocks/tracing/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Eq;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::NotNull;
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+namespace {
+
+using DescriptorStatus = envoy::service::ratelimit::v3::RateLimitResponse::DescriptorStatus;
+
+class MockRequestCallbacks : public RequestCallbacks {
+public:
+  void complete(LimitStatus status, DescriptorStatusListPtr&& descriptor_statuses,
+                Http::ResponseHeaderMapPtr&& response_headers_to_add,
+                Http::RequestHeaderMapPtr&& request_headers_to_add,
+                const std::string& response_body, DynamicMetadataPtr&& dynamic_metadata) override {
+    complete_(status, descriptor_statuses.get(), response_headers_to_add.get(),
+              request_headers_to_add.get(), response_body, dynamic_metadata.get());
+  }
+
+  MOCK_METHOD(void, complete_,
+              (LimitStatus status, const DescriptorStatusList* descriptor_statuses,
+               const Http::ResponseHeaderMap* response_headers_to_add,
+               const Http::RequestHeaderMap* request_headers_to_add,
+               const std::string& response_body, const Protobuf::Struct* dynamic_metadata));
+};
+
+DescriptorStatus overLimitStatus(std::chrono::seconds duration_until_reset) {
+  DescriptorStatus status;
+  status.set_code(envoy::service::ratelimit::v3::RateLimitResponse::OVER_LIMIT);
+  status.mutable_duration_until_reset()->set_seconds(duration_until_reset.count());
+  return status;
+}
+
+DescriptorStatusListPtr statuses(std::vector<DescriptorStatus> statuses) {
+  return std::make_unique<DescriptorStatusList>(statuses.begin(), statuses.end());
+}
+
+class OverLimitCacheTest : public testing::Test {
+public:
+  Event::SimulatedTimeSystem time_system_;
+};
+
+TEST_F(OverLimitCacheTest, ExpireEntries) {
+  OverLimitCache cache(10, time_system_);
+  EXPECT_FALSE(cache.insert("key", overLimitStatus(std::chrono::seconds(10)),
+                            std::chrono::seconds(10)));
+  EXPECT_EQ(std::nullopt, cache.find("other"));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(4));
+  const auto status = cache.find("key");
+  ASSERT_TRUE(status.has_value());
+  // The status carries the time left until the reset.
+  EXPECT_EQ(6, status->duration_until_reset().seconds());
+
+  time_system_.advanceTimeWait(std::chrono::seconds(6));
+  EXPECT_EQ(std::nullopt, cache.find("key"));
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(OverLimitCacheTest, EvictLeastRecentlyUsed) {
+  OverLimitCache cache(2, time_system_);
+  const DescriptorStatus status = overLimitStatus(std::chrono::seconds(10));
+  EXPECT_FALSE(cache.insert("a", status, std::chrono::seconds(10)));
+  EXPECT_FALSE(cache.insert("b", status, std::chrono::seconds(10)));
+  // Using "a" makes "b" the least recently used entry.
+  EXPECT_TRUE(cache.find("a").has_value());
+  EXPECT_TRUE(cache.insert("c", status, std::chrono::seconds(10)));
+  EXPECT_FALSE(cache.find("b").has_value());
+  EXPECT_TRUE(cache.find("a").has_value());
+  EXPECT_TRUE(cache.find("c").has_value());
+  EXPECT_EQ(2, cache.size());
+}
+
+TEST_F(OverLimitCacheTest, Keys) {
+  Envoy::RateLimit::Descriptor descriptor{{{"a", "bc"}}};
+  EXPECT_EQ(OverLimitCache::descriptorKey("domain", descriptor),
+            OverLimitCache::descriptorKey("domain", descriptor));
+  EXPECT_NE(OverLimitCache::descriptorKey("domain", descriptor),
+            OverLimitCache::descriptorKey("other", descriptor));
+  // Values can't be shifted from one entry to the next.
+  EXPECT_NE(OverLimitCache::descriptorKey("domain", descriptor),
+            OverLimitCache::descriptorKey("domain", {{{"ab", "c"}}}));
+
+  // The descriptors of a request with a limit override are distinct from the ones without.
+  Envoy::RateLimit::Descriptor with_limit = descriptor;
+  with_limit.limit_ = Envoy::RateLimit::RateLimitOverride{10, envoy::type::v3::SECOND};
+  EXPECT_NE(OverLimitCache::descriptorKey("domain", descriptor),
+            OverLimitCache::descriptorKey("domain", with_limit));
+
+  EXPECT_NE(OverLimitCache::requestKey("domain", {descriptor}, 1),
+            OverLimitCache::requestKey("domain", {descriptor}, 2));
+  EXPECT_NE(OverLimitCache::requestKey("domain", {descriptor}, 1),
+            OverLimitCache::requestKey("domain", {descriptor, descriptor}, 1));
+}
+
+class OverLimitCacheClientTest : public testing::Test {
+public:
+  void initialize(bool coalesce_requests) {
+    config_ = std::make_unique<OverLimitCacheConfig>(
+        10, coalesce_requests, tls_,
+        OverLimitCacheStats{
+            ALL_OVER_LIMIT_CACHE_STATS(POOL_COUNTER_PREFIX(*store_.rootScope(), "ratelimit."))});
+  }
+
+  // Creates a client, and the inner client it wraps.
+  std::unique_ptr<OverLimitCacheClient> makeClient(MockClient*& inner) {
+    auto client = std::make_unique<MockClient>();
+    inner = client.get();
+    return std::make_unique<OverLimitCacheClient>(std::move(client), *config_);
+  }
+
+  void limit(Client& client, RequestCallbacks& callbacks,
+             const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+    client.limit(callbacks, "domain", descriptors, span_, stream_info_, 0);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "ratelimit." + name)->value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Stats::IsolatedStoreImpl store_;
+  std::unique_ptr<OverLimitCacheConfig> config_;
+  NiceMock<Tracing::MockSpan> span_;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  const std::vector<Envoy::RateLimit::Descriptor> descriptors_{{{{"key", "value"}}},
+                                                                {{{"other", "value"}}}};
+};
+
+TEST_F(OverLimitCacheClientTest, RejectOverLimitDescriptorsUntilReset) {
+  initialize(false);
+  MockClient* inner;
+  auto client = makeClient(inner);
+  MockRequestCallbacks callbacks;
+
+  RequestCallbacks* inner_callbacks;
+  EXPECT_CALL(*inner, limit(_, "domain", _, _, _, 0))
+      .WillOnce(SaveArgAddress(&inner_callbacks));
+  limit(*client, callbacks, descriptors_);
+  EXPECT_CALL(callbacks, complete_(LimitStatus::OverLimit, NotNull(), _, _, _, _));
+  inner_callbacks->complete(
+      LimitStatus::OverLimit,
+      statuses({DescriptorStatus(), overLimitStatus(std::chrono::seconds(10))}), nullptr, nullptr,
+      "", nullptr);
+
+  // A request with the over limit descriptor is rejected without calling the service.
+  EXPECT_CALL(*inner, limit(_, _, _, _, _, _)).Times(0);
+  EXPECT_CALL(callbacks, complete_(LimitStatus::OverLimit, NotNull(), Eq(nullptr), Eq(nullptr),
+                                   "", Eq(nullptr)))
+      .WillOnce(Invoke([](LimitStatus, const DescriptorStatusList* descriptor_statuses,
+                          const Http::ResponseHeaderMap*, const Http::RequestHeaderMap*,
+                          const std::string&, const Protobuf::Struct*) {
+        ASSERT_EQ(1, descriptor_statuses->size());
+        EXPECT_EQ(envoy::service::ratelimit::v3::RateLimitResponse::OVER_LIMIT,
+                  (*descriptor_statuses)[0].code());
+        EXPECT_EQ(7, (*descriptor_statuses)[0].duration_until_reset().seconds());
+      }));
+  time_system_.advanceTimeWait(std::chrono::seconds(3));
+  limit(*client, callbacks, {descriptors_[1]});
+  EXPECT_EQ(1, counter("over_limit_cache_hit"));
+  testing::Mock::VerifyAndClearExpectations(inner);
+
+  // The descriptor which was within its limit is not cached.
+  EXPECT_CALL(*inner, limit(_, _, _, _, _, _));
+  limit(*client, callbacks, {descriptors_[0]});
+  EXPECT_CALL(*inner, cancel());
+  client->cancel();
+
+  // Once reset, the descriptor is checked by the service again.
+  time_system_.advanceTimeWait(std::chrono::seconds(7));
+  EXPECT_CALL(*inner, limit(_, _, _, _, _, _));
+  limit(*client, callbacks, {descriptors_[1]});
+  EXPECT_CALL(*inner, cancel());
+  client->cancel();
+}
+
+TEST_F(OverLimitCacheClientTest, OnlyCacheDescriptorsWithReset) {
+  initialize(false);
+  MockClient* inner;
+  auto client = makeClient(inner);
+  MockRequestCallbacks callbacks;
+
+  RequestCallbacks* inner_callbacks;
+  EXPECT_CALL(*inner, limit(_, _, _, _, _, _)).WillOnce(SaveArgAddress(&inner_callbacks));
+  limit(*client, callbacks, descriptors_);
+  DescriptorStatus status;
+  status.set_code(envoy::service::ratelimit::v3::RateLimitResponse::OVER_LIMIT);
+  EXPECT_CALL(callbacks, complete_(LimitStatus::OverLimit, _, _, _, _, _));
+  inner_callbacks->complete(LimitStatus::OverLimit, statuses({status, status}), nullptr, nullptr,
+                            "", nullptr);
+
+  EXPECT_CALL(*inner, limit(_, _, _, _, _, _));
+  limit(*client, callbacks, descriptors_);
+  EXPECT_EQ(0, config_->cache().size());
+  EXPECT_CALL(*inner, cancel());
+  client->cancel();
+}
+
+TEST_F(OverLimitCacheClientTest, NegativeHitsBypassCache) {
+  initialize(false);
+  config_->cache().insert(OverLimitCache::descriptorKey("domain", descriptors_[0]),
+                          overLimitStatus(std::chrono::seconds(10)), std::chrono::seconds(10));
+  MockClient* inner;
+  auto client = makeClient(inner);
+  MockRequestCallbacks callbacks;
+
+  std::vector<Envoy::RateLimit::Descriptor> descriptors{descriptors_[0]};
+  descriptors[0].is_negative_hits_ = true;
+  EXPECT_CALL(*inner, limit(_, _, _, _, _, _));
+  limit(*client, callbacks, descriptors);
+  EXPECT_EQ(0, counter("over_limit_cache_hit"));
+  EXPECT_CALL(*inner, cancel());
+  client->cancel();
+}
+
+TEST_F(OverLimitCacheClientTest, CoalesceIdenticalRequests) {
+  initialize(true);
+  MockClient* leader_inner;
+  auto leader = makeClient(leader_inner);
+  MockClient* follower_inner;
+  auto follower = makeClient(follower_inner);
+  MockClient* other_inner;
+  auto other = makeClient(other_inner);
+  MockRequestCallbacks leader_callbacks;
+  MockRequestCallbacks follower_callbacks;
+  MockRequestCallbacks other_callbacks;
+
+  RequestCallbacks* inner_callbacks;
+  EXPECT_CALL(*leader_inner, limit(_, _, _, _, _, _)).WillOnce(SaveArgAddress(&inner_callbacks));
+  limit(*leader, leader_callbacks, descriptors_);
+  EXPECT_CALL(*follower_inner, limit(_, _, _, _, _, _)).Times(0);
+  limit(*follower, follower_callbacks, descriptors_);
+  EXPECT_EQ(1, counter("coalesced_requests"));
+  // Requests with other descriptors are not coalesced.
+  EXPECT_CALL(*other_inner, limit(_, _, _, _, _, _));
+  limit(*other, other_callbacks, {descriptors_[0]});
+
+  // Both requests get the response of the service.
+  auto response_headers = Http::ResponseHeaderMapImpl::create();
+  response_headers->addCopy(Http::LowerCaseString("x-ratelimit"), "ok");
+  EXPECT_CALL(follower_callbacks, complete_(LimitStatus::OK, NotNull(), NotNull(), Eq(nullptr),
+                                            "body", Eq(nullptr)));
+  EXPECT_CALL(leader_callbacks, complete_(LimitStatus::OK, NotNull(), NotNull(), Eq(nullptr),
+                                          "body", Eq(nullptr)));
+  inner_callbacks->complete(LimitStatus::OK, statuses({DescriptorStatus(), DescriptorStatus()}),
+                            std::move(response_headers), nullptr, "body", nullptr);
+
+  // The next request is sent to the service.
+  EXPECT_CALL(*follower_inner, limit(_, _, _, _, _, _));
+  limit(*follower, follower_callbacks, descriptors_);
+  EXPECT_CALL(*follower_inner, cancel());
+  follower->cancel();
+  EXPECT_CALL(*other_inner, cancel());
+  other->cancel();
+}
+
+TEST_F(OverLimitCacheClientTest, CancelledLeaderHandsOverRequest) {
+  initialize(true);
+  MockClient* leader_inner;
+  auto leader = makeClient(leader_inner);
+  MockClient* first_inner;
+  auto first = makeClient(first_inner);
+  MockClient* second_inner;
+  auto second = makeClient(second_inner);
+  MockRequestCallbacks leader_callbacks;
+  MockRequestCallbacks first_callbacks;
+  MockRequestCallbacks second_callbacks;
+
+  EXPECT_CALL(*leader_inner, limit(_, _, _, _, _, _));
+  limit(*leader, leader_callbacks, descriptors_);
+  limit(*first, first_callbacks, descriptors_);
+  limit(*second, second_callbacks, descriptors_);
+
+  // The first coalesced request is sent when its leader is cancelled, and leads the other one.
+  RequestCallbacks* inner_callbacks;
+  EXPECT_CALL(*leader_inner, cancel());
+  EXPECT_CALL(*first_inner, limit(_, "domain", _, _, _, 0))
+      .WillOnce(SaveArgAddress(&inner_callbacks));
+  leader->cancel();
+
+  EXPECT_CALL(second_callbacks, complete_(LimitStatus::Error, _, _, _, _, _));
+  EXPECT_CALL(first_callbacks, complete_(LimitStatus::Error, _, _, _, _, _));
+  inner_callbacks->complete(LimitStatus::Error, nullptr, nullptr, nullptr, "", nullptr);
+}
+
+TEST_F(OverLimitCacheClientTest, CancelCoalescedRequest) {
+  initialize(true);
+  MockClient* leader_inner;
+  auto leader = makeClient(leader_inner);
+  MockClient* follower_inner;
+  auto follower = makeClient(follower_inner);
+  MockRequestCallbacks leader_callbacks;
+  MockRequestCallbacks follower_callbacks;
+
+  RequestCallbacks* inner_callbacks;
+  EXPECT_CALL(*leader_inner, limit(_, _, _, _, _, _)).WillOnce(SaveArgAddress(&inner_callbacks));
+  limit(*leader, leader_callbacks, descriptors_);
+  limit(*follower, follower_callbacks, descriptors_);
+  EXPECT_CALL(*follower_inner, cancel()).Times(0);
+  follower->cancel();
+
+  EXPECT_CALL(follower_callbacks, complete_(_, _, _, _, _, _)).Times(0);
+  EXPECT_CALL(leader_callbacks, complete_(LimitStatus::OK, _, _, _, _, _));
+  inner_callbacks->complete(LimitStatus::OK, nullptr, nullptr, nullptr, "", nullptr);
+}
+
+TEST_F(OverLimitCacheClientTest, DetachedRequestIsSentDirectly) {
+  initialize(true);
+  MockClient* leader_inner;
+  auto leader = makeClient(leader_inner);
+  MockClient* follower_inner;
+  auto follower = makeClient(follower_inner);
+  MockRequestCallbacks leader_callbacks;
+  MockRequestCallbacks follower_callbacks;
+
+  EXPECT_CALL(*leader_inner, limit(_, _, _, _, _, _));
+  limit(*leader, leader_callbacks, descriptors_);
+  limit(*follower, follower_callbacks, descriptors_);
+
+  EXPECT_CALL(*follower_inner, limit(_, "domain", _, _, _, 0));
+  EXPECT_CALL(*follower_inner, detach());
+  follower->detach();
+  EXPECT_CALL(*leader_inner, cancel());
+  leader->cancel();
+}
+
+} // namespace
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
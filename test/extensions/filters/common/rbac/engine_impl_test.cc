@@ -474,6 +474,62 @@ TEST(RoleBasedAccessControlEngineImpl, ConjunctiveCondition) {
   checkEngine(engine, false, LogResult::Undecided, info, conn, headers);
 }
 
+TEST(RoleBasedAccessControlEngineImpl, IndexedPolicies) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  envoy::config::rbac::v3::RBAC rbac;
+  TestUtility::loadFromYaml(R"EOF(
+  action: DENY
+  policies:
+    a_path:
+      permissions: [{url_path: {path: {prefix: "/admin/"}}}]
+      principals: [{any: true}]
+    b_header:
+      permissions: [{header: {name: x-tenant, string_match: {exact: "blocked"}}}]
+      principals: [{any: true}]
+    c_remote_ip:
+      permissions: [{any: true}]
+      principals: [{remote_ip: {address_prefix: "10.0.0.0", prefix_len: 8}}]
+    d_port:
+      permissions: [{destination_port: 8080}]
+      principals: [{any: true}]
+    e_path_and_ip:
+      permissions: [{url_path: {path: {exact: "/"}}}]
+      principals: [{remote_ip: {address_prefix: "192.168.0.0", prefix_len: 16}}]
+  )EOF",
+                            rbac);
+  RBAC::RoleBasedAccessControlEngineImpl engine(rbac, ProtobufMessage::getStrictValidationVisitor(),
+                                                factory_context);
+  rbac.set_index_policies(true);
+  RBAC::RoleBasedAccessControlEngineImpl indexed_engine(
+      rbac, ProtobufMessage::getStrictValidationVisitor(), factory_context);
+
+  // The indexed policies give the same results as the policies evaluated one by one.
+  const auto check = [&](const std::string& remote_address, uint32_t local_port,
+                         const Envoy::Http::TestRequestHeaderMapImpl& headers, bool expected,
+                         const std::string& expected_policy_id) {
+    Envoy::Network::MockConnection conn;
+    NiceMock<StreamInfo::MockStreamInfo> info;
+    info.downstream_connection_info_provider_->setRemoteAddress(
+        Envoy::Network::Utility::parseInternetAddressNoThrow(remote_address, 1234, false));
+    info.downstream_connection_info_provider_->setLocalAddress(
+        Envoy::Network::Utility::parseInternetAddressNoThrow("1.2.3.4", local_port, false));
+    for (const auto* rbac_engine : {&engine, &indexed_engine}) {
+      std::string effective_policy_id;
+      EXPECT_EQ(expected, rbac_engine->handleAction(conn, headers, info, &effective_policy_id));
+      EXPECT_EQ(expected_policy_id, effective_policy_id);
+    }
+  };
+
+  check("1.1.1.1", 80, {{":path", "/public"}}, true, "");
+  check("1.1.1.1", 80, {{":path", "/admin/users"}}, false, "a_path");
+  check("1.1.1.1", 80, {{":path", "/public"}, {"x-tenant", "blocked"}}, false, "b_header");
+  check("10.0.0.1", 80, {{":path", "/admin/users"}}, false, "a_path");
+  check("10.0.0.1", 80, {{":path", "/public"}}, false, "c_remote_ip");
+  check("1.1.1.1", 8080, {{":path", "/public"}}, false, "d_port");
+  check("192.168.1.1", 80, {{":path", "/?q=1"}}, false, "e_path_and_ip");
+  check("192.168.1.1", 80, {{":path", "/public"}}, true, "");
+}
+
 TEST(RoleBasedAccessControlMatcherEngineImpl, Disabled) {
   xds::type::matcher::v3::Matcher matcher;
 
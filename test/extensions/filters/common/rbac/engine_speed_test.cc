@@ -0,0 +1,80 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares the evaluation of range(0) policies one by one with their evaluation through the policy
+// index. Half of the policies require a path prefix and half a remote IP range, and the requests
+// match none of them, which is the worst case without the index.
+
+#include <memory>
+#include <string>
+
+#include "envoy/config/rbac/v3/rbac.pb.h"
+
+#include "source/common/network/utility.h"
+#include "source/extensions/filters/common/rbac/engine_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/server_factory_context.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+namespace {
+
+envoy::config::rbac::v3::RBAC makeRbac(int64_t num_policies, bool index_policies) {
+  envoy::config::rbac::v3::RBAC rbac;
+  rbac.set_action(envoy::config::rbac::v3::RBAC::ALLOW);
+  rbac.set_index_policies(index_policies);
+  for (int64_t i = 0; i < num_policies; i++) {
+    envoy::config::rbac::v3::Policy policy;
+    if (i % 2 == 0) {
+      policy.add_permissions()->mutable_url_path()->mutable_path()->set_prefix(
+          absl::StrCat("/tenant-", i, "/"));
+      policy.add_principals()->set_any(true);
+    } else {
+      policy.add_permissions()->set_any(true);
+      auto* remote_ip = policy.add_principals()->mutable_remote_ip();
+      remote_ip->set_address_prefix(absl::StrCat("10.", i / 256 % 256, ".", i % 256, ".0"));
+      remote_ip->set_prefix_len(24);
+    }
+    (*rbac.mutable_policies())[absl::StrCat("policy-", i)] = policy;
+  }
+  return rbac;
+}
+
+void bmEngine(benchmark::State& state, bool index_policies) {
+  testing::NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  const RoleBasedAccessControlEngineImpl engine(
+      makeRbac(state.range(0), index_policies), ProtobufMessage::getNullValidationVisitor(),
+      factory_context);
+
+  testing::NiceMock<Network::MockConnection> connection;
+  testing::NiceMock<StreamInfo::MockStreamInfo> info;
+  info.downstream_connection_info_provider_->setRemoteAddress(
+      Network::Utility::parseInternetAddressNoThrow("192.168.0.1", 1234, false));
+  const Http::TestRequestHeaderMapImpl headers{{":path", "/tenant-unknown/resource"}};
+  for (auto _ : state) { // NOLINT
+    const bool allowed = engine.handleAction(connection, headers, info, nullptr);
+    benchmark::DoNotOptimize(allowed);
+  }
+}
+
+void bmEvaluateAllPolicies(benchmark::State& state) { bmEngine(state, false); }
+BENCHMARK(bmEvaluateAllPolicies)->Arg(100)->Arg(1000)->Arg(10000);
+
+void bmEvaluateIndexedPolicies(benchmark::State& state) { bmEngine(state, true); }
+BENCHMARK(bmEvaluateIndexedPolicies)->Arg(100)->Arg(1000)->Arg(10000);
+
+} // namespace
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
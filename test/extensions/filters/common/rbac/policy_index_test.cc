@@ -0,0 +1,182 @@
+#include <string>
+#include <vector>
+
+#include "envoy/config/rbac/v3/rbac.pb.h"
+
+#include "source/common/network/utility.h"
+#include "source/extensions/filters/common/rbac/policy_index.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+using testing::NiceMock;
+
+envoy::config::rbac::v3::Policy parsePolicy(const std::string& yaml) {
+  envoy::config::rbac::v3::Policy policy;
+  TestUtility::loadFromYaml(yaml, policy);
+  return policy;
+}
+
+TEST(PolicyIndexTest, PathRequirement) {
+  const auto requirement = PolicyIndex::requirement(parsePolicy(R"EOF(
+  permissions:
+  - or_rules:
+      rules:
+      - url_path: {path: {prefix: "/api/"}}
+      - url_path: {path: {exact: "/health"}}
+  principals:
+  - any: true
+  )EOF"));
+  ASSERT_NE(nullptr, requirement);
+  EXPECT_EQ(PolicyIndex::Requirement::Kind::PathPrefix, requirement->kind_);
+  EXPECT_THAT(requirement->values_, ElementsAre("/api/", "/health"));
+
+  // Paths matched regardless of their case can't be looked up.
+  EXPECT_EQ(nullptr, PolicyIndex::requirement(parsePolicy(R"EOF(
+  permissions:
+  - url_path: {path: {prefix: "/api/", ignore_case: true}}
+  principals:
+  - any: true
+  )EOF")));
+}
+
+TEST(PolicyIndexTest, HeaderRequirement) {
+  const auto requirement = PolicyIndex::requirement(parsePolicy(R"EOF(
+  permissions:
+  - and_rules:
+      rules:
+      - destination_port: 443
+      - header: {name: X-Tenant, string_match: {exact: "t1"}}
+  principals:
+  - any: true
+  )EOF"));
+  ASSERT_NE(nullptr, requirement);
+  EXPECT_EQ(PolicyIndex::Requirement::Kind::HeaderValue, requirement->kind_);
+  EXPECT_EQ("x-tenant", requirement->header_name_);
+  EXPECT_THAT(requirement->values_, ElementsAre("t1"));
+
+  // Inverted matches are satisfied by any other value.
+  EXPECT_EQ(nullptr, PolicyIndex::requirement(parsePolicy(R"EOF(
+  permissions:
+  - header: {name: x-tenant, string_match: {exact: "t1"}, invert_match: true}
+  principals:
+  - any: true
+  )EOF")));
+}
+
+TEST(PolicyIndexTest, PrincipalRequirement) {
+  // The principals are used when the permissions have no requirement.
+  const auto requirement = PolicyIndex::requirement(parsePolicy(R"EOF(
+  permissions:
+  - any: true
+  principals:
+  - remote_ip: {address_prefix: "10.0.0.0", prefix_len: 8}
+  - remote_ip: {address_prefix: "192.168.0.0", prefix_len: 16}
+  )EOF"));
+  ASSERT_NE(nullptr, requirement);
+  EXPECT_EQ(PolicyIndex::Requirement::Kind::IpRange, requirement->kind_);
+  EXPECT_EQ(IPMatcher::Type::DownstreamRemote, requirement->ip_type_);
+  EXPECT_EQ(2U, requirement->ranges_.size());
+}
+
+TEST(PolicyIndexTest, NoRequirement) {
+  // A disjunction has no requirement unless all its operands have one, of the same kind.
+  EXPECT_EQ(nullptr, PolicyIndex::requirement(parsePolicy(R"EOF(
+  permissions:
+  - url_path: {path: {prefix: "/api/"}}
+  - header: {name: x-tenant, string_match: {exact: "t1"}}
+  principals:
+  - direct_remote_ip: {address_prefix: "10.0.0.0", prefix_len: 8}
+  - source_ip: {address_prefix: "10.0.0.0", prefix_len: 8}
+  )EOF")));
+  EXPECT_EQ(nullptr, PolicyIndex::requirement(parsePolicy(R"EOF(
+  permissions:
+  - not_rule: {url_path: {path: {prefix: "/api/"}}}
+  principals:
+  - any: true
+  )EOF")));
+}
+
+TEST(PolicyIndexTest, Candidates) {
+  const std::vector<envoy::config::rbac::v3::Policy> policies{
+      parsePolicy(R"EOF(
+      permissions: [{url_path: {path: {prefix: "/api/"}}}]
+      principals: [{any: true}]
+      )EOF"),
+      parsePolicy(R"EOF(
+      permissions: [{destination_port: 443}]
+      principals: [{any: true}]
+      )EOF"),
+      parsePolicy(R"EOF(
+      permissions: [{url_path: {path: {prefix: "/api/v2/"}}}]
+      principals: [{any: true}]
+      )EOF"),
+      parsePolicy(R"EOF(
+      permissions: [{header: {name: x-tenant, string_match: {exact: "t1"}}}]
+      principals: [{any: true}]
+      )EOF"),
+      parsePolicy(R"EOF(
+      permissions: [{any: true}]
+      principals: [{remote_ip: {address_prefix: "10.0.0.0", prefix_len: 8}}]
+      )EOF"),
+  };
+  std::vector<const envoy::config::rbac::v3::Policy*> policy_ptrs;
+  for (const auto& policy : policies) {
+    policy_ptrs.push_back(&policy);
+  }
+  const PolicyIndex index(policy_ptrs);
+  EXPECT_EQ(4U, index.indexedPolicies());
+
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  std::vector<uint32_t> candidates;
+
+  // The policies without requirement are always candidates.
+  index.candidates(connection, Http::TestRequestHeaderMapImpl{}, info, candidates);
+  EXPECT_THAT(candidates, ElementsAre(1));
+
+  index.candidates(connection, Http::TestRequestHeaderMapImpl{{":path", "/api/v2/users?x=1"}}, info,
+                   candidates);
+  EXPECT_THAT(candidates, ElementsAre(0, 1, 2));
+
+  // Either the joined header values or any of them may match.
+  index.candidates(connection,
+                   Http::TestRequestHeaderMapImpl{{"x-tenant", "t2"}, {"x-tenant", "t1"}}, info,
+                   candidates);
+  EXPECT_THAT(candidates, ElementsAre(1, 3));
+
+  info.downstream_connection_info_provider_->setRemoteAddress(
+      Network::Utility::parseInternetAddressNoThrow("10.1.2.3", 80, false));
+  index.candidates(connection, Http::TestRequestHeaderMapImpl{{":path", "/api/"}}, info,
+                   candidates);
+  EXPECT_THAT(candidates, ElementsAre(0, 1, 4));
+}
+
+TEST(PolicyIndexTest, Empty) {
+  const PolicyIndex index({});
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  std::vector<uint32_t> candidates{1};
+  index.candidates(connection, Http::TestRequestHeaderMapImpl{{":path", "/"}}, info, candidates);
+  EXPECT_THAT(candidates, IsEmpty());
+}
+
+} // namespace
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,93 @@
+#include <string>
+#include <vector>
+
+#include "source/extensions/filters/http/compressor/compression_thread_pool.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+namespace {
+
+class CompressionThreadPoolTest : public testing::Test {
+public:
+  void initialize(const std::string& yaml) {
+    envoy::extensions::filters::http::compressor::v3::Compressor::CompressionThreadPool config;
+    TestUtility::loadFromYaml(yaml, config);
+    thread_pool_ = std::make_unique<CompressionThreadPool>(config, Thread::threadFactoryForTest(),
+                                                           "test.", *store_.rootScope());
+  }
+
+  // Blocks the only pool thread until the returned notification is notified.
+  void blockThread(absl::Notification& release) {
+    absl::Notification started;
+    ASSERT_TRUE(thread_pool_->trySchedule([&started, &release]() {
+      started.Notify();
+      release.WaitForNotification();
+    }));
+    started.WaitForNotification();
+  }
+
+  uint64_t queuedChunks() {
+    return store_.gauge("test.chunks_queued", Stats::Gauge::ImportMode::Accumulate).value();
+  }
+
+  Stats::TestUtil::TestStore store_;
+  CompressionThreadPoolPtr thread_pool_;
+};
+
+TEST_F(CompressionThreadPoolTest, DefaultConfig) {
+  initialize("{}");
+  EXPECT_EQ(64 * 1024, thread_pool_->minChunkSize());
+}
+
+// The work is run in the order in which it is queued.
+TEST_F(CompressionThreadPoolTest, RunInOrder) {
+  initialize("thread_count: 1");
+  absl::Notification release;
+  blockThread(release);
+
+  std::vector<int> order;
+  absl::Notification done;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(thread_pool_->trySchedule([&order, i]() { order.push_back(i); }));
+  }
+  ASSERT_TRUE(thread_pool_->trySchedule([&done]() { done.Notify(); }));
+  EXPECT_EQ(4, queuedChunks());
+
+  release.Notify();
+  done.WaitForNotification();
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), order);
+  EXPECT_EQ(0, queuedChunks());
+}
+
+// Work is rejected while max_queued_chunks chunks are queued.
+TEST_F(CompressionThreadPoolTest, RejectWhenFull) {
+  initialize("max_queued_chunks: 2");
+  absl::Notification release;
+  blockThread(release);
+
+  EXPECT_TRUE(thread_pool_->trySchedule([]() {}));
+  EXPECT_TRUE(thread_pool_->trySchedule([]() {}));
+  EXPECT_FALSE(thread_pool_->trySchedule([]() {}));
+  EXPECT_EQ(1, store_.counter("test.chunks_rejected").value());
+  EXPECT_EQ(2, queuedChunks());
+
+  release.Notify();
+  // The work still queued when the pool is destroyed is dropped.
+  thread_pool_.reset();
+  EXPECT_EQ(0, queuedChunks());
+}
+
+} // namespace
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
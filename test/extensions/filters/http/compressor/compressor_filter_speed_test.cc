@@ -8,8 +8,10 @@
 #include "source/extensions/compression/zstd/compressor/zstd_compressor_impl.h"
 #include "source/extensions/filters/http/compressor/compressor_filter.h"
 
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 #include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
@@ -105,6 +107,7 @@ struct CompressionParams {
 
 CompressorFilterConfigSharedPtr makeGzipConfig(Stats::IsolatedStoreImpl& stats,
                                                testing::NiceMock<Runtime::MockLoader>& runtime,
+                                               Event::Dispatcher& main_thread_dispatcher,
                                                const CompressionParams& params) {
 
   envoy::extensions::filters::http::compressor::v3::Compressor compressor;
@@ -120,13 +123,15 @@ CompressorFilterConfigSharedPtr makeGzipConfig(Stats::IsolatedStoreImpl& stats,
   Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory =
       std::make_unique<MockGzipCompressorFactory>(level, strategy, window_bits, memory_level);
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
-      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory));
+      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory),
+      Thread::threadFactoryForTest(), main_thread_dispatcher);
 
   return config;
 }
 
 CompressorFilterConfigSharedPtr makeZstdConfig(Stats::IsolatedStoreImpl& stats,
                                                testing::NiceMock<Runtime::MockLoader>& runtime,
+                                               Event::Dispatcher& main_thread_dispatcher,
                                                const CompressionParams& params) {
 
   envoy::extensions::filters::http::compressor::v3::Compressor compressor;
@@ -136,13 +141,15 @@ CompressorFilterConfigSharedPtr makeZstdConfig(Stats::IsolatedStoreImpl& stats,
   Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory =
       std::make_unique<MockZstdCompressorFactory>(level, strategy);
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
-      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory));
+      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory),
+      Thread::threadFactoryForTest(), main_thread_dispatcher);
 
   return config;
 }
 
 CompressorFilterConfigSharedPtr makeBrotliConfig(Stats::IsolatedStoreImpl& stats,
                                                  testing::NiceMock<Runtime::MockLoader>& runtime,
+                                                 Event::Dispatcher& main_thread_dispatcher,
                                                  const CompressionParams& params) {
 
   envoy::extensions::filters::http::compressor::v3::Compressor compressor;
@@ -151,7 +158,8 @@ CompressorFilterConfigSharedPtr makeBrotliConfig(Stats::IsolatedStoreImpl& stats
   Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory =
       std::make_unique<MockBrotliCompressorFactory>(quality);
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
-      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory));
+      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory),
+      Thread::threadFactoryForTest(), main_thread_dispatcher);
 
   return config;
 }
@@ -207,18 +215,19 @@ static Result compressWith(enum CompressorLibs lib, std::vector<Buffer::OwnedImp
   auto start = std::chrono::high_resolution_clock::now();
   Stats::IsolatedStoreImpl stats;
   testing::NiceMock<Runtime::MockLoader> runtime;
+  testing::NiceMock<Event::MockDispatcher> main_thread_dispatcher;
   CompressorFilterConfigSharedPtr config;
   std::string compressor = "";
   std::string encoding = "";
   if (lib == CompressorLibs::Brotli) {
-    config = makeBrotliConfig(stats, runtime, params);
+    config = makeBrotliConfig(stats, runtime, main_thread_dispatcher, params);
     encoding = "br";
     compressor = "brotli";
   } else if (lib == CompressorLibs::Gzip) {
-    config = makeGzipConfig(stats, runtime, params);
+    config = makeGzipConfig(stats, runtime, main_thread_dispatcher, params);
     encoding = compressor = "gzip";
   } else if (lib == CompressorLibs::Zstd) {
-    config = makeZstdConfig(stats, runtime, params);
+    config = makeZstdConfig(stats, runtime, main_thread_dispatcher, params);
     encoding = compressor = "zstd";
   }
 
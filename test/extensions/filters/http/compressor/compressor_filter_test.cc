@@ -5,14 +5,17 @@
 
 #include "test/extensions/filters/http/compressor/compressor_filter_testing_peer.h"
 #include "test/mocks/compression/compressor/mocks.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/protobuf/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/server/factory_context.h"
 #include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/notification.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -37,12 +40,18 @@ public:
   }
   const std::string& statsPrefix() const override { CONSTRUCT_ON_FIRST_USE(std::string, "test."); }
   const std::string& contentEncoding() const override { return content_encoding_; }
+  bool supportsOffload() const override { return supports_offload_; }
 
-  void setExpectedCompressCalls(uint32_t calls) { expected_compress_calls_ = calls; }
+  void setSupportsOffload(bool supports_offload) { supports_offload_ = supports_offload; }
+  void setExpectedCompressCalls(uint32_t calls) {
+    expected_compress_calls_ = testing::Exactly(calls);
+  }
+  void setExpectedCompressCalls(testing::Cardinality calls) { expected_compress_calls_ = calls; }
 
 private:
-  uint32_t expected_compress_calls_{1};
+  testing::Cardinality expected_compress_calls_{testing::Exactly(1)};
   const std::string content_encoding_;
+  bool supports_offload_{true};
 };
 
 class CompressorFilterTest : public testing::Test {
@@ -72,7 +81,9 @@ public:
     auto compressor_factory = std::make_unique<TestCompressorFactory>("test");
     compressor_factory_ = compressor_factory.get();
     config_ = std::make_shared<CompressorFilterConfig>(compressor, "test.", *stats_.rootScope(),
-                                                       runtime_, std::move(compressor_factory));
+                                                       runtime_, std::move(compressor_factory),
+                                                       Thread::threadFactoryForTest(),
+                                                       main_thread_dispatcher_);
     filter_ = std::make_unique<CompressorFilter>(config_);
     filter_->setDecoderFilterCallbacks(decoder_callbacks_);
     filter_->setEncoderFilterCallbacks(encoder_callbacks_);
@@ -178,14 +189,16 @@ public:
     }
   }
 
+  // Declared before the configuration, whose compression thread pool holds a stats scope.
+  Stats::TestUtil::TestStore stats_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Event::MockDispatcher> main_thread_dispatcher_;
   TestCompressorFactory* compressor_factory_;
   std::shared_ptr<CompressorFilterConfig> config_;
   std::unique_ptr<CompressorFilter> filter_;
   Buffer::OwnedImpl data_;
   std::string expected_str_;
   std::string response_stats_prefix_;
-  Stats::TestUtil::TestStore stats_;
-  NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
   NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
   NiceMock<StreamInfo::MockStreamInfo> stream_info_;
@@ -1824,14 +1837,16 @@ protected:
     auto compressor_factory1 = std::make_unique<TestCompressorFactory>("test1");
     compressor_factory1->setExpectedCompressCalls(0);
     auto config1 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test1.", *stats1_.rootScope(), runtime_, std::move(compressor_factory1));
+        compressor, "test1.", *stats1_.rootScope(), runtime_, std::move(compressor_factory1),
+        Thread::threadFactoryForTest(), main_thread_dispatcher_);
     filter1_ = std::make_unique<CompressorFilter>(config1);
 
     TestUtility::loadFromJson(json2, compressor);
     auto compressor_factory2 = std::make_unique<TestCompressorFactory>("test2");
     compressor_factory2->setExpectedCompressCalls(0);
     auto config2 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test2.", *stats2_.rootScope(), runtime_, std::move(compressor_factory2));
+        compressor, "test2.", *stats2_.rootScope(), runtime_, std::move(compressor_factory2),
+        Thread::threadFactoryForTest(), main_thread_dispatcher_);
     filter2_ = std::make_unique<CompressorFilter>(config2);
   }
 
@@ -1888,6 +1903,7 @@ protected:
   }
 
   NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Event::MockDispatcher> main_thread_dispatcher_;
   Stats::TestUtil::TestStore stats1_;
   Stats::TestUtil::TestStore stats2_;
   std::unique_ptr<CompressorFilter> filter1_;
@@ -2274,7 +2290,8 @@ protected:
                               compressor);
     auto compressor_factory1 = std::make_unique<TestCompressorFactory>("test1");
     auto config1 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test1.", *stats1_.rootScope(), runtime_, std::move(compressor_factory1));
+        compressor, "test1.", *stats1_.rootScope(), runtime_, std::move(compressor_factory1),
+        Thread::threadFactoryForTest(), main_thread_dispatcher_);
     filter1_ = std::make_unique<CompressorFilter>(config1);
 
     TestUtility::loadFromJson(fmt::format(R"EOF(
@@ -2292,7 +2309,8 @@ protected:
                               compressor);
     auto compressor_factory2 = std::make_unique<TestCompressorFactory>("test2");
     auto config2 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test2.", *stats2_.rootScope(), runtime_, std::move(compressor_factory2));
+        compressor, "test2.", *stats2_.rootScope(), runtime_, std::move(compressor_factory2),
+        Thread::threadFactoryForTest(), main_thread_dispatcher_);
     filter2_ = std::make_unique<CompressorFilter>(config2);
   }
 
@@ -2566,6 +2584,174 @@ TEST_F(CompressorPerRouteLibraryTest, GetCompressorFactoryUsesPerRoute) {
   EXPECT_EQ(per_route_factory.contentEncoding(), "test");
 }
 
+class CompressorFilterThreadPoolTest : public CompressorFilterTest {
+public:
+  void SetUp() override {
+    setUpFilter(R"EOF(
+{
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  },
+  "compression_thread_pool": {
+    "min_chunk_size": 100,
+    "max_queued_chunks": 1
+  }
+}
+)EOF");
+    ON_CALL(encoder_callbacks_, dispatcher()).WillByDefault(ReturnRef(*dispatcher_));
+  }
+
+  void startResponse() {
+    Http::TestRequestHeaderMapImpl request_headers{{":method", "get"}, {"accept-encoding", "test"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+    Http::TestResponseHeaderMapImpl headers{{":status", "200"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+    EXPECT_EQ("test", headers.get_("content-encoding"));
+  }
+
+  uint64_t threadPoolCounter(const std::string& name) {
+    return stats_.counter("test.compressor.test.test.thread_pool." + name).value();
+  }
+
+  Api::ApiPtr api_{Api::createApiForTest()};
+  Event::DispatcherPtr dispatcher_{api_->allocateDispatcher("test_thread")};
+};
+
+// A large chunk is compressed by the pool, and the data received in the meantime is compressed
+// after it.
+TEST_F(CompressorFilterThreadPoolTest, CompressLargeChunkInPool) {
+  compressor_factory_->setExpectedCompressCalls(2);
+  startResponse();
+
+  populateBuffer(1000);
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(data_, false));
+  EXPECT_EQ(0, data_.length());
+  Buffer::OwnedImpl last_chunk("last");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(last_chunk, true));
+
+  std::string injected;
+  testing::InSequence s;
+  EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) { injected += data.toString(); }));
+  EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(_, true))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) {
+        injected += data.toString();
+        dispatcher_->exit();
+      }));
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+
+  EXPECT_EQ(expected_str_ + "last", injected);
+  EXPECT_EQ(1, threadPoolCounter("chunks_compressed"));
+  EXPECT_EQ(
+      1004,
+      stats_.counter("test.compressor.test.test.response.total_uncompressed_bytes").value());
+  EXPECT_EQ(0, stats_.gauge("test.compressor.test.test.thread_pool.chunks_queued",
+                            Stats::Gauge::ImportMode::Accumulate)
+                   .value());
+}
+
+// The trailers wait for the chunk being compressed by the pool, and the upstream is read-disabled
+// while the data waiting for it exceeds the buffer limit.
+TEST_F(CompressorFilterThreadPoolTest, TrailersAndWatermarks) {
+  compressor_factory_->setExpectedCompressCalls(3);
+  startResponse();
+  ON_CALL(encoder_callbacks_, bufferLimit()).WillByDefault(Return(10));
+
+  populateBuffer(1000);
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(data_, false));
+  EXPECT_CALL(encoder_callbacks_, onEncoderFilterAboveWriteBufferHighWatermark());
+  Buffer::OwnedImpl small_chunk("more than ten bytes");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer,
+            filter_->encodeData(small_chunk, false));
+  Http::TestResponseTrailerMapImpl trailers;
+  EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_->encodeTrailers(trailers));
+
+  testing::InSequence s;
+  EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(_, false));
+  EXPECT_CALL(encoder_callbacks_, onEncoderFilterBelowWriteBufferLowWatermark());
+  EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(_, false)).Times(2);
+  EXPECT_CALL(encoder_callbacks_, continueEncoding()).WillOnce(Invoke([&]() {
+    dispatcher_->exit();
+  }));
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+}
+
+// Small chunks are compressed inline.
+TEST_F(CompressorFilterThreadPoolTest, CompressSmallChunkInline) {
+  startResponse();
+  populateBuffer(99);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, true));
+  EXPECT_EQ(0, threadPoolCounter("chunks_compressed"));
+}
+
+// Chunks are compressed inline when the pool is saturated.
+TEST_F(CompressorFilterThreadPoolTest, CompressInlineWhenSaturated) {
+  startResponse();
+  CompressionThreadPool& thread_pool = *config_->compressionThreadPool();
+  absl::Notification started;
+  absl::Notification release;
+  ASSERT_TRUE(thread_pool.trySchedule([&]() {
+    started.Notify();
+    release.WaitForNotification();
+  }));
+  started.WaitForNotification();
+  ASSERT_TRUE(thread_pool.trySchedule([]() {}));
+
+  populateBuffer(1000);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, true));
+  EXPECT_EQ(1, threadPoolCounter("chunks_rejected"));
+  release.Notify();
+  // Wait for the pool threads before the notifications go out of scope.
+  filter_.reset();
+  config_.reset();
+}
+
+// Chunks are compressed inline when the compressors can't be used by the pool threads.
+TEST_F(CompressorFilterThreadPoolTest, CompressInlineWithoutOffloadSupport) {
+  compressor_factory_->setSupportsOffload(false);
+  startResponse();
+  populateBuffer(1000);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, true));
+  EXPECT_EQ(0, threadPoolCounter("chunks_compressed"));
+  EXPECT_EQ(
+      1000,
+      stats_.counter("test.compressor.test.test.response.total_uncompressed_bytes").value());
+}
+
+// The pool threads are joined on the main thread when the configuration is destroyed by another
+// thread.
+TEST_F(CompressorFilterThreadPoolTest, ConfigDestroyedOffMainThread) {
+  filter_.reset();
+  Event::PostCb destroy_pool;
+  EXPECT_CALL(main_thread_dispatcher_, post(_)).WillOnce(Invoke([&](Event::PostCb cb) {
+    destroy_pool = std::move(cb);
+  }));
+  Thread::ThreadPtr thread =
+      Thread::threadFactoryForTest().createThread([this]() { config_.reset(); });
+  thread->join();
+  ASSERT_TRUE(destroy_pool);
+  destroy_pool();
+  destroy_pool = nullptr;
+}
+
+// A chunk compressed after the stream is destroyed is dropped.
+TEST_F(CompressorFilterThreadPoolTest, StreamDestroyedBeforeChunkCompressed) {
+  compressor_factory_->setExpectedCompressCalls(testing::AnyNumber());
+  startResponse();
+  populateBuffer(1000);
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(data_, false));
+  filter_->onDestroy();
+  filter_.reset();
+  // Destroying the configuration stops the pool threads once the chunk is compressed, if it was.
+  config_.reset();
+
+  EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(_, _)).Times(0);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
 } // namespace
 } // namespace Compressor
 } // namespace HttpFilters
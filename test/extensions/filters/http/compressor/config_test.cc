@@ -100,6 +100,32 @@ TEST(CompressorFilterFactoryTests, RegisteredCompressorLibraryConfig) {
   EXPECT_OK(cb_or.status());
 }
 
+// The compressors of a library that does not support offloading can't be compressed by a pool.
+TEST(CompressorFilterFactoryTests, CompressionThreadPoolRequiresOffloadSupport) {
+  const std::string yaml_string = R"EOF(
+  compressor_library:
+    name: test.mock.noop
+    typed_config:
+      "@type": type.googleapis.com/test.mock_compressor_library.Registered
+  compression_thread_pool:
+    thread_count: 1
+  )EOF";
+
+  envoy::extensions::filters::http::compressor::v3::Compressor proto_config;
+  TestUtility::loadFromYaml(yaml_string, proto_config);
+  CompressorFilterFactory factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+
+  TestNoopCompressorLibraryFactory factory_impl;
+  Envoy::Registry::InjectFactory<
+      Envoy::Compression::Compressor::NamedCompressorLibraryConfigFactory>
+      reg(factory_impl);
+  EXPECT_THAT(
+      factory.createFilterFactoryFromProto(proto_config, "stats", context).status().message(),
+      testing::HasSubstr(
+          "compressor library 'test.mock.noop' can't be used with a compression thread pool"));
+}
+
 // Factory that accesses GenericFactoryContext methods.
 class TestCheckingCompressorLibraryFactory
     : public Envoy::Compression::Compressor::NamedCompressorLibraryConfigFactory {
@@ -0,0 +1,191 @@
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/ext_authz/decision_cache.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+namespace {
+
+using testing::NiceMock;
+
+using Filters::Common::ExtAuthz::CheckStatus;
+using Filters::Common::ExtAuthz::Response;
+
+ResponseConstSharedPtr makeResponse(CheckStatus status) {
+  auto response = std::make_shared<Response>();
+  response->status = status;
+  return response;
+}
+
+class DecisionCacheTest : public testing::Test {
+public:
+  Event::SimulatedTimeSystem time_system_;
+};
+
+TEST_F(DecisionCacheTest, ExpireEntries) {
+  DecisionCache cache(10, false, time_system_);
+  const ResponseConstSharedPtr response = makeResponse(CheckStatus::OK);
+  EXPECT_FALSE(cache.insert("key", response, std::chrono::seconds(10)));
+  EXPECT_EQ(response, cache.find("key"));
+  EXPECT_EQ(nullptr, cache.find("other"));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(9));
+  EXPECT_EQ(response, cache.find("key"));
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(nullptr, cache.find("key"));
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(DecisionCacheTest, EvictLeastRecentlyUsed) {
+  DecisionCache cache(2, true, time_system_);
+  const ResponseConstSharedPtr response = makeResponse(CheckStatus::OK);
+  EXPECT_FALSE(cache.insert("a", response, std::chrono::seconds(10)));
+  EXPECT_FALSE(cache.insert("b", response, std::chrono::seconds(10)));
+  // Using "a" makes "b" the least recently used entry.
+  EXPECT_NE(nullptr, cache.find("a"));
+  EXPECT_TRUE(cache.insert("c", response, std::chrono::seconds(10)));
+  EXPECT_EQ(nullptr, cache.find("b"));
+  EXPECT_NE(nullptr, cache.find("a"));
+  EXPECT_NE(nullptr, cache.find("c"));
+
+  // Replacing an entry doesn't evict another one.
+  const ResponseConstSharedPtr denied = makeResponse(CheckStatus::Denied);
+  EXPECT_FALSE(cache.insert("a", denied, std::chrono::seconds(10)));
+  EXPECT_EQ(denied, cache.find("a"));
+  EXPECT_EQ(2, cache.size());
+}
+
+class DecisionCacheConfigTest : public testing::Test {
+public:
+  void initialize(const std::string& yaml) {
+    envoy::extensions::filters::http::ext_authz::v3::DecisionCache proto_config;
+    TestUtility::loadFromYaml(yaml, proto_config);
+    config_ = std::make_unique<DecisionCacheConfig>(proto_config, tls_, time_system_);
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  DecisionCacheConfigPtr config_;
+};
+
+TEST_F(DecisionCacheConfigTest, Key) {
+  initialize(R"EOF(
+  key_headers: ["x-api-key", ":path"]
+  )EOF");
+
+  Http::TestRequestHeaderMapImpl headers{{":path", "/foo"}, {"x-api-key", "secret"}};
+  const std::string key = config_->key(headers, "route");
+  EXPECT_EQ(key, config_->key(Http::TestRequestHeaderMapImpl{{"x-api-key", "secret"},
+                                                             {":path", "/foo"},
+                                                             {"x-other", "other"}},
+                              "route"));
+  EXPECT_NE(key, config_->key(headers, "other_route"));
+  EXPECT_NE(key, config_->key(Http::TestRequestHeaderMapImpl{{":path", "/foo"}}, "route"));
+  // A missing header is distinguished from an empty one.
+  EXPECT_NE(config_->key(Http::TestRequestHeaderMapImpl{{":path", "/foo"}}, "route"),
+            config_->key(Http::TestRequestHeaderMapImpl{{":path", "/foo"}, {"x-api-key", ""}},
+                         "route"));
+  // Values can't be shifted from one header to the next.
+  EXPECT_NE(
+      config_->key(Http::TestRequestHeaderMapImpl{{"x-api-key", "a"}, {":path", "b"}}, "route"),
+      config_->key(Http::TestRequestHeaderMapImpl{{"x-api-key", "ab"}, {":path", ""}}, "route"));
+}
+
+TEST_F(DecisionCacheConfigTest, DefaultTtls) {
+  initialize(R"EOF(
+  allowed_ttl: 60s
+  )EOF");
+
+  EXPECT_EQ(std::chrono::seconds(60), config_->ttl(*makeResponse(CheckStatus::OK)));
+  // Denied decisions are not cached without denied_ttl, and errors are never cached.
+  EXPECT_EQ(std::nullopt, config_->ttl(*makeResponse(CheckStatus::Denied)));
+  EXPECT_EQ(std::nullopt, config_->ttl(*makeResponse(CheckStatus::Error)));
+
+  initialize(R"EOF(
+  denied_ttl: 5s
+  )EOF");
+  EXPECT_EQ(std::nullopt, config_->ttl(*makeResponse(CheckStatus::OK)));
+  EXPECT_EQ(std::chrono::seconds(5), config_->ttl(*makeResponse(CheckStatus::Denied)));
+
+  // Nor are the errors of the authorization service reported as denials.
+  Response server_error;
+  server_error.status = CheckStatus::Denied;
+  server_error.status_code = Http::Code::ServiceUnavailable;
+  EXPECT_EQ(std::nullopt, config_->ttl(server_error));
+}
+
+TEST_F(DecisionCacheConfigTest, TtlFromResponse) {
+  initialize(R"EOF(
+  allowed_ttl: 60s
+  ttl_header: x-cache-ttl
+  ttl_metadata_key: cache_ttl
+  )EOF");
+
+  Response response;
+  response.response_headers_to_add.emplace_back("X-Cache-TTL", "30");
+  EXPECT_EQ(std::chrono::seconds(30), config_->ttl(response));
+
+  // The metadata takes precedence over the header.
+  (*response.dynamic_metadata.mutable_fields())["cache_ttl"] = ValueUtil::numberValue(10);
+  EXPECT_EQ(std::chrono::seconds(10), config_->ttl(response));
+
+  // A TTL of 0 disables the caching of the decision.
+  (*response.dynamic_metadata.mutable_fields())["cache_ttl"] = ValueUtil::numberValue(0);
+  EXPECT_EQ(std::nullopt, config_->ttl(response));
+
+  // As do negative TTLs and NaN, while the huge TTLs are capped.
+  (*response.dynamic_metadata.mutable_fields())["cache_ttl"] = ValueUtil::numberValue(-5);
+  EXPECT_EQ(std::nullopt, config_->ttl(response));
+  (*response.dynamic_metadata.mutable_fields())["cache_ttl"] =
+      ValueUtil::numberValue(std::numeric_limits<double>::quiet_NaN());
+  EXPECT_EQ(std::nullopt, config_->ttl(response));
+  (*response.dynamic_metadata.mutable_fields())["cache_ttl"] =
+      ValueUtil::numberValue(std::numeric_limits<double>::infinity());
+  EXPECT_EQ(std::chrono::hours(24), config_->ttl(response));
+  (*response.dynamic_metadata.mutable_fields())["cache_ttl"] = ValueUtil::numberValue(1e300);
+  EXPECT_EQ(std::chrono::hours(24), config_->ttl(response));
+  response.dynamic_metadata.clear_fields();
+  response.response_headers_to_add.clear();
+  response.headers_to_set.emplace_back("x-cache-ttl", "9223372036854775807");
+  EXPECT_EQ(std::chrono::hours(24), config_->ttl(response));
+  response.headers_to_set.clear();
+
+  // As does a malformed TTL.
+  response.dynamic_metadata.clear_fields();
+  response.response_headers_to_add.clear();
+  response.headers_to_set.emplace_back("x-cache-ttl", "soon");
+  EXPECT_EQ(std::nullopt, config_->ttl(response));
+}
+
+TEST_F(DecisionCacheConfigTest, PerWorkerCache) {
+  initialize("{}");
+  DecisionCache& cache = config_->cache();
+  cache.insert("key", makeResponse(CheckStatus::OK), std::chrono::seconds(10));
+  EXPECT_EQ(&cache, &config_->cache());
+  EXPECT_EQ(1, config_->cache().size());
+
+  initialize(R"EOF(
+  shared: true
+  )EOF");
+  EXPECT_EQ(0, config_->cache().size());
+}
+
+} // namespace
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
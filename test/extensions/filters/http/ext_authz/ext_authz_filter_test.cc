@@ -41,6 +41,7 @@ using testing::Contains;
 using testing::InSequence;
 using testing::Invoke;
 using testing::Key;
+using testing::NiceMock;
 using testing::Not;
 using testing::Return;
 using testing::ReturnRef;
@@ -4176,6 +4177,134 @@ TEST_F(HttpFilterTest, RequestHeaderLimitsReachedDuringRemoval) {
   EXPECT_EQ(1U, config_->stats().request_header_limits_reached_.value());
 }
 
+class DecisionCacheTest : public HttpFilterTest {
+public:
+  void initializeDecisionCache() {
+    initialize(R"EOF(
+    grpc_service:
+      envoy_grpc:
+        cluster_name: "ext_authz_server"
+    decision_cache:
+      key_headers: ["x-api-key"]
+      allowed_ttl: 60s
+      denied_ttl: 10s
+    )EOF");
+    prepareCheck();
+  }
+
+  // Replaces the filter with the one of a new request sharing the filter config.
+  void newRequest(const std::string& api_key) {
+    filter_->onDestroy();
+    client_ = new NiceMock<Filters::Common::ExtAuthz::MockClient>();
+    filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_},
+                                       factory_context_);
+    filter_->setDecoderFilterCallbacks(decoder_filter_callbacks_);
+    filter_->setEncoderFilterCallbacks(encoder_filter_callbacks_);
+    request_headers_ = Http::TestRequestHeaderMapImpl{{"x-api-key", api_key}};
+  }
+
+  // Expects a check call completed with the response.
+  void expectCheck(const Filters::Common::ExtAuthz::Response& response) {
+    EXPECT_CALL(*client_, check(_, _, _, _))
+        .WillOnce(Invoke([response](Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+                                    const envoy::service::auth::v3::CheckRequest&, Tracing::Span&,
+                                    const StreamInfo::StreamInfo&) -> void {
+          callbacks.onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+        }));
+  }
+};
+
+// An allowed decision is replayed, with its header mutations, for the requests with the same key.
+TEST_F(DecisionCacheTest, ReplayAllowedDecision) {
+  initializeDecisionCache();
+  newRequest("alice");
+
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::OK;
+  response.headers_to_set.emplace_back("x-user", "alice");
+  expectCheck(response);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ("alice", request_headers_.get_("x-user"));
+
+  newRequest("alice");
+  EXPECT_CALL(*client_, check(_, _, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ("alice", request_headers_.get_("x-user"));
+
+  // A request with another key calls the authorization service.
+  newRequest("bob");
+  response.headers_to_set.clear();
+  expectCheck(response);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  EXPECT_FALSE(request_headers_.has("x-user"));
+
+  EXPECT_EQ(1U, config_->stats().decision_cache_hit_.value());
+  EXPECT_EQ(2U, config_->stats().decision_cache_miss_.value());
+  EXPECT_EQ(3U, config_->stats().ok_.value());
+}
+
+// A denied decision is replayed with its local reply.
+TEST_F(DecisionCacheTest, ReplayDeniedDecision) {
+  initializeDecisionCache();
+  newRequest("mallory");
+
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::Denied;
+  response.status_code = Http::Code::Unauthorized;
+  response.body = "go away";
+  expectCheck(response);
+  EXPECT_CALL(decoder_filter_callbacks_,
+              sendLocalReply(Http::Code::Unauthorized, "go away", _, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, true));
+
+  newRequest("mallory");
+  EXPECT_CALL(*client_, check(_, _, _, _)).Times(0);
+  EXPECT_CALL(decoder_filter_callbacks_,
+              sendLocalReply(Http::Code::Unauthorized, "go away", _, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, true));
+
+  EXPECT_EQ(1U, config_->stats().decision_cache_hit_.value());
+  EXPECT_EQ(2U, config_->stats().denied_.value());
+}
+
+// Errors are not cached.
+TEST_F(DecisionCacheTest, ErrorsAreNotCached) {
+  initializeDecisionCache();
+  newRequest("alice");
+
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::Error;
+  expectCheck(response);
+  filter_->decodeHeaders(request_headers_, true);
+
+  newRequest("alice");
+  expectCheck(response);
+  filter_->decodeHeaders(request_headers_, true);
+  EXPECT_EQ(0U, config_->stats().decision_cache_hit_.value());
+  EXPECT_EQ(2U, config_->stats().decision_cache_miss_.value());
+}
+
+// The decisions are not cached for the routes without a name, which can't be told apart.
+TEST_F(DecisionCacheTest, UnnamedRoutesAreNotCached) {
+  initializeDecisionCache();
+  decoder_filter_callbacks_.route_->route_name_.clear();
+  newRequest("alice");
+
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::OK;
+  expectCheck(response);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+
+  newRequest("alice");
+  expectCheck(response);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(0U, config_->stats().decision_cache_hit_.value());
+  EXPECT_EQ(0U, config_->stats().decision_cache_miss_.value());
+  EXPECT_EQ(2U, config_->stats().ok_.value());
+}
+
 } // namespace
 } // namespace ExtAuthz
 } // namespace HttpFilters
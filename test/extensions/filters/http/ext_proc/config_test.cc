@@ -209,6 +209,28 @@ TEST(HttpExtProcConfigTest, InvalidHttpServiceProcessingMode) {
                                 "not be configured to send body or trailer."));
 }
 
+TEST(HttpExtProcConfigTest, StreamMultiplexingWithHttpService) {
+  std::string yaml = R"EOF(
+  http_service:
+    http_service:
+      http_uri:
+        uri: "ext_proc_server_0:9000"
+        cluster: "ext_proc_server_0"
+        timeout:
+          seconds: 500
+  stream_multiplexing: {}
+  )EOF";
+
+  ExternalProcessingFilterConfig factory;
+  ProtobufTypes::MessagePtr proto_config = factory.createEmptyConfigProto();
+  TestUtility::loadFromYaml(yaml, *proto_config);
+
+  testing::NiceMock<Server::Configuration::MockFactoryContext> context;
+  auto result = factory.createFilterFactoryFromProto(*proto_config, "stats", context);
+  EXPECT_THAT(result, HasStatus(absl::StatusCode::kInvalidArgument,
+                                "stream_multiplexing can only be used with grpc_service"));
+}
+
 TEST(HttpExtProcConfigTest, HttpServiceTrailerProcessingModeNotSKIP) {
   std::string yaml = R"EOF(
   http_service:
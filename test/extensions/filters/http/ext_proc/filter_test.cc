@@ -6557,6 +6557,41 @@ TEST_F(HttpFilterTest, LocalResponseStarted) {
   filter_->onDestroy();
 }
 
+// With stream multiplexing, the messages of the HTTP stream are tagged with its correlation ID,
+// and the shared gRPC stream stays open when the HTTP stream is done.
+TEST_F(HttpFilterTest, StreamMultiplexing) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_proc_server"
+  stream_multiplexing:
+    max_http_streams_per_grpc_stream: 10
+  processing_mode:
+    response_header_mode: "SKIP"
+  )EOF");
+
+  EXPECT_EQ(FilterHeadersStatus::StopIteration, filter_->decodeHeaders(request_headers_, true));
+  const uint64_t correlation_id = last_request_.stream_correlation_id();
+  EXPECT_NE(0, correlation_id);
+  processRequestHeaders(false, [correlation_id](const HttpHeaders&, ProcessingResponse& response,
+                                                HeadersResponse&) {
+    response.set_stream_correlation_id(correlation_id);
+  });
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers_, true));
+  filter_->onDestroy();
+
+  EXPECT_EQ(1, config_->stats().streams_started_.value());
+  EXPECT_EQ(1, config_->stats().stream_msgs_received_.value());
+  EXPECT_EQ(1, stats_store_
+                   .gauge("ext_proc.multiplexing.grpc_streams_active",
+                          Stats::Gauge::ImportMode::Accumulate)
+                   .value());
+  EXPECT_EQ(0, stats_store_
+                   .gauge("ext_proc.multiplexing.http_streams_active",
+                          Stats::Gauge::ImportMode::Accumulate)
+                   .value());
+}
+
 } // namespace
 
 } // namespace ExternalProcessing
@@ -0,0 +1,277 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/grpc/codec.h"
+#include "source/extensions/filters/http/ext_proc/multiplexed_stream.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/extensions/filters/http/ext_proc/mock_server.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExternalProcessing {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+class MockProcessorCallbacks : public ExternalProcessorCallbacks {
+public:
+  MOCK_METHOD(void, onReceiveMessage, (Grpc::ResponsePtr<ProcessingResponse>&&));
+  MOCK_METHOD(void, onGrpcError, (Grpc::Status::GrpcStatus, const std::string&));
+  MOCK_METHOD(void, onGrpcClose, ());
+  MOCK_METHOD(void, logStreamInfo, ());
+  MOCK_METHOD(void, onComplete, (ProcessingResponse&));
+  MOCK_METHOD(void, onError, ());
+};
+
+class MultiplexedStreamPoolTest : public testing::Test {
+public:
+  MultiplexedStreamPoolTest() {
+    envoy::config::core::v3::GrpcService grpc_service;
+    grpc_service.mutable_envoy_grpc()->set_cluster_name("ext_proc_server");
+    config_with_hash_key_ = Grpc::GrpcServiceConfigWithHashKey(grpc_service);
+    pool_ = std::make_unique<MultiplexedStreamPool>(2, stats_, time_system_);
+  }
+
+  // Expects a shared gRPC stream to be started.
+  void expectStart() {
+    EXPECT_CALL(client_, start(_, _, _, _))
+        .WillOnce(Invoke([this](ExternalProcessorCallbacks& callbacks,
+                                const Grpc::GrpcServiceConfigWithHashKey&,
+                                Http::AsyncClient::StreamOptions&,
+                                Http::StreamFilterSidestreamWatermarkCallbacks&) {
+          auto stream = std::make_unique<NiceMock<MockStream>>();
+          ON_CALL(*stream, streamInfo()).WillByDefault(ReturnRef(grpc_stream_info_));
+          grpc_streams_.push_back(stream.get());
+          shared_callbacks_.push_back(&callbacks);
+          return stream;
+        }));
+  }
+
+  ExternalProcessorStreamPtr attach(MockProcessorCallbacks& callbacks) {
+    return pool_->attach(client_, callbacks, config_with_hash_key_, std::chrono::seconds(1));
+  }
+
+  uint64_t gauge(const std::string& name) {
+    return store_.gauge("test." + name, Stats::Gauge::ImportMode::Accumulate).value();
+  }
+
+  Stats::TestUtil::TestStore store_;
+  ExtProcMultiplexingStats stats_{
+      ALL_EXT_PROC_MULTIPLEXING_STATS(POOL_COUNTER_PREFIX(*store_.rootScope(), "test."),
+                                      POOL_GAUGE_PREFIX(*store_.rootScope(), "test."),
+                                      POOL_HISTOGRAM_PREFIX(*store_.rootScope(), "test."))};
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<StreamInfo::MockStreamInfo> grpc_stream_info_;
+  NiceMock<MockClient> client_;
+  Grpc::GrpcServiceConfigWithHashKey config_with_hash_key_;
+  std::unique_ptr<MultiplexedStreamPool> pool_;
+  std::vector<MockStream*> grpc_streams_;
+  std::vector<ExternalProcessorCallbacks*> shared_callbacks_;
+};
+
+// HTTP streams share a gRPC stream up to max_http_streams_per_grpc_stream.
+TEST_F(MultiplexedStreamPoolTest, ShareGrpcStreams) {
+  NiceMock<MockProcessorCallbacks> callbacks1, callbacks2, callbacks3;
+  expectStart();
+  auto stream1 = attach(callbacks1);
+  auto stream2 = attach(callbacks2);
+  ASSERT_EQ(1, grpc_streams_.size());
+
+  expectStart();
+  auto stream3 = attach(callbacks3);
+  ASSERT_EQ(2, grpc_streams_.size());
+  EXPECT_EQ(2, store_.counter("test.grpc_streams_started").value());
+  EXPECT_EQ(2, gauge("grpc_streams_active"));
+  EXPECT_EQ(3, gauge("http_streams_active"));
+
+  // The messages are tagged with the correlation ID of their HTTP stream, and never end the
+  // shared stream.
+  EXPECT_CALL(*grpc_streams_[0], send(_, false))
+      .WillOnce(Invoke([](ProcessingRequest&& request, bool) {
+        EXPECT_EQ(2, request.stream_correlation_id());
+      }));
+  stream2->send(ProcessingRequest(), true);
+
+  // The least loaded gRPC stream is used once an HTTP stream is done.
+  EXPECT_TRUE(stream1->close());
+  EXPECT_FALSE(stream1->close());
+  NiceMock<MockProcessorCallbacks> callbacks4;
+  auto stream4 = attach(callbacks4);
+  EXPECT_EQ(2, grpc_streams_.size());
+  EXPECT_CALL(*grpc_streams_[0], send(_, false));
+  stream4->send(ProcessingRequest(), false);
+}
+
+// The responses are dispatched to the HTTP streams by correlation ID.
+TEST_F(MultiplexedStreamPoolTest, DispatchResponses) {
+  NiceMock<MockProcessorCallbacks> callbacks1, callbacks2;
+  expectStart();
+  auto stream1 = attach(callbacks1);
+  auto stream2 = attach(callbacks2);
+
+  auto response = std::make_unique<ProcessingResponse>();
+  response->set_stream_correlation_id(2);
+  EXPECT_CALL(callbacks1, onReceiveMessage(_)).Times(0);
+  EXPECT_CALL(callbacks2, onReceiveMessage(_));
+  shared_callbacks_[0]->onReceiveMessage(std::move(response));
+
+  // The responses for HTTP streams that are gone are dropped.
+  stream2.reset();
+  response = std::make_unique<ProcessingResponse>();
+  response->set_stream_correlation_id(2);
+  shared_callbacks_[0]->onReceiveMessage(std::move(response));
+  EXPECT_EQ(1, store_.counter("test.unknown_correlation_id").value());
+
+  // As are the responses for HTTP streams whose filter is destroyed.
+  stream1->notifyFilterDestroy();
+  response = std::make_unique<ProcessingResponse>();
+  response->set_stream_correlation_id(1);
+  shared_callbacks_[0]->onReceiveMessage(std::move(response));
+  EXPECT_EQ(2, store_.counter("test.unknown_correlation_id").value());
+}
+
+// Each HTTP stream accounts the bytes of its own messages, and takes the upstream of the shared
+// gRPC stream.
+TEST_F(MultiplexedStreamPoolTest, StreamInfoPerHttpStream) {
+  grpc_stream_info_.upstream_cluster_info_ = std::make_shared<NiceMock<Upstream::MockClusterInfo>>();
+  NiceMock<MockProcessorCallbacks> callbacks1, callbacks2;
+  expectStart();
+  auto stream1 = attach(callbacks1);
+  auto stream2 = attach(callbacks2);
+  ASSERT_EQ(1, grpc_streams_.size());
+
+  ProcessingRequest request;
+  request.mutable_request_headers()->set_end_of_stream(true);
+  request.set_stream_correlation_id(1);
+  const uint64_t request_bytes = request.ByteSizeLong() + Grpc::GRPC_FRAME_HEADER_SIZE;
+  stream1->send(ProcessingRequest(request), false);
+  stream1->send(ProcessingRequest(request), false);
+
+  auto response = std::make_unique<ProcessingResponse>();
+  response->mutable_request_headers();
+  response->set_stream_correlation_id(2);
+  const uint64_t response_bytes = response->ByteSizeLong() + Grpc::GRPC_FRAME_HEADER_SIZE;
+  shared_callbacks_[0]->onReceiveMessage(std::move(response));
+
+  const auto& meter1 = stream1->streamInfo().getUpstreamBytesMeter();
+  EXPECT_EQ(2 * request_bytes, meter1->wireBytesSent());
+  EXPECT_EQ(0, meter1->wireBytesReceived());
+  const auto& meter2 = stream2->streamInfo().getUpstreamBytesMeter();
+  EXPECT_EQ(0, meter2->wireBytesSent());
+  EXPECT_EQ(response_bytes, meter2->wireBytesReceived());
+  EXPECT_NE(meter1.get(), grpc_stream_info_.getUpstreamBytesMeter().get());
+
+  EXPECT_EQ(grpc_stream_info_.upstreamInfo()->upstreamHost(),
+            stream1->streamInfo().upstreamInfo()->upstreamHost());
+  EXPECT_EQ(grpc_stream_info_.upstreamClusterInfoSharedPtr(),
+            stream2->streamInfo().upstreamClusterInfoSharedPtr());
+
+  // The response code details of the shared stream are taken when it is closed, before the HTTP
+  // streams log their stream info.
+  grpc_stream_info_.response_code_details_ = "via_upstream";
+  EXPECT_CALL(callbacks1, logStreamInfo()).WillOnce(Invoke([&]() {
+    EXPECT_EQ("via_upstream", stream1->streamInfo().responseCodeDetails());
+  }));
+  shared_callbacks_[0]->onGrpcClose();
+}
+
+// All the HTTP streams sharing a gRPC stream are notified when it fails.
+TEST_F(MultiplexedStreamPoolTest, GrpcStreamError) {
+  NiceMock<MockProcessorCallbacks> callbacks1, callbacks2;
+  expectStart();
+  auto stream1 = attach(callbacks1);
+  auto stream2 = attach(callbacks2);
+
+  EXPECT_CALL(callbacks1, logStreamInfo());
+  EXPECT_CALL(callbacks1, onGrpcError(Grpc::Status::Unavailable, "unavailable"))
+      .WillOnce(Invoke([&](Grpc::Status::GrpcStatus, const std::string&) {
+        // The HTTP stream is detached already.
+        EXPECT_FALSE(stream1->close());
+      }));
+  EXPECT_CALL(callbacks2, onGrpcError(Grpc::Status::Unavailable, "unavailable"))
+      .WillOnce(Invoke([&](Grpc::Status::GrpcStatus, const std::string&) { stream2.reset(); }));
+  shared_callbacks_[0]->onGrpcError(Grpc::Status::Unavailable, "unavailable");
+  EXPECT_EQ(0, gauge("grpc_streams_active"));
+  EXPECT_EQ(0, gauge("http_streams_active"));
+
+  // The messages of a detached HTTP stream are dropped.
+  EXPECT_CALL(*grpc_streams_[0], send(_, _)).Times(0);
+  stream1->send(ProcessingRequest(), false);
+
+  // The next HTTP stream starts a new gRPC stream.
+  NiceMock<MockProcessorCallbacks> callbacks3;
+  expectStart();
+  auto stream3 = attach(callbacks3);
+  EXPECT_EQ(2, grpc_streams_.size());
+}
+
+// A clean close of the gRPC stream is reported as such to the HTTP streams.
+TEST_F(MultiplexedStreamPoolTest, GrpcStreamClose) {
+  NiceMock<MockProcessorCallbacks> callbacks;
+  expectStart();
+  auto stream = attach(callbacks);
+
+  EXPECT_CALL(callbacks, onGrpcClose());
+  EXPECT_CALL(callbacks, onGrpcError(_, _)).Times(0);
+  shared_callbacks_[0]->onGrpcClose();
+}
+
+// A failure to start a gRPC stream is reported to the HTTP stream.
+TEST_F(MultiplexedStreamPoolTest, StartFailure) {
+  EXPECT_CALL(client_, start(_, _, _, _))
+      .WillOnce(Invoke([](ExternalProcessorCallbacks& callbacks,
+                          const Grpc::GrpcServiceConfigWithHashKey&,
+                          Http::AsyncClient::StreamOptions&,
+                          Http::StreamFilterSidestreamWatermarkCallbacks&) {
+        callbacks.onGrpcError(Grpc::Status::Internal, "no cluster");
+        return nullptr;
+      }));
+  NiceMock<MockProcessorCallbacks> callbacks;
+  EXPECT_CALL(callbacks, onGrpcError(Grpc::Status::Internal, "no cluster"));
+  EXPECT_EQ(nullptr, attach(callbacks));
+  EXPECT_EQ(0, store_.counter("test.grpc_streams_started").value());
+  EXPECT_EQ(0, gauge("grpc_streams_active"));
+}
+
+// An idle gRPC stream is closed unless it is the last one.
+TEST_F(MultiplexedStreamPoolTest, CloseIdleGrpcStreams) {
+  NiceMock<MockProcessorCallbacks> callbacks1, callbacks2, callbacks3;
+  expectStart();
+  auto stream1 = attach(callbacks1);
+  auto stream2 = attach(callbacks2);
+  expectStart();
+  auto stream3 = attach(callbacks3);
+
+  EXPECT_CALL(*grpc_streams_[1], close()).WillOnce(Return(true));
+  stream3.reset();
+  EXPECT_EQ(1, gauge("grpc_streams_active"));
+
+  EXPECT_CALL(*grpc_streams_[0], close()).Times(0);
+  stream1.reset();
+  stream2.reset();
+  EXPECT_EQ(1, gauge("grpc_streams_active"));
+  EXPECT_EQ(0, gauge("http_streams_active"));
+
+  pool_.reset();
+  EXPECT_EQ(0, gauge("grpc_streams_active"));
+}
+
+} // namespace
+} // namespace ExternalProcessing
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
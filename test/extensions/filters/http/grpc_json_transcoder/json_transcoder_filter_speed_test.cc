@@ -0,0 +1,99 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the transcoding of large JSON requests received in 16KiB chunks: a unary request with a
+// repeated field of range(0) values, and a client streaming request of range(0) messages.
+
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/grpc_json_transcoder/v3/transcoder.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/grpc_json_transcoder/json_transcoder_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace GrpcJsonTranscoder {
+namespace {
+
+constexpr uint64_t ChunkSize = 16 * 1024;
+
+JsonTranscoderConfigSharedPtr makeConfig(Api::Api& api) {
+  envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder proto_config;
+  proto_config.set_proto_descriptor(
+      TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"));
+  proto_config.add_services("bookstore.Bookstore");
+  proto_config.mutable_max_request_body_size()->set_value(64 * 1024 * 1024);
+  absl::Status creation_status = absl::OkStatus();
+  auto config = std::make_shared<JsonTranscoderConfig>(proto_config, api, creation_status);
+  RELEASE_ASSERT(creation_status.ok(), creation_status.ToString());
+  return config;
+}
+
+void bmTranscodeRequest(benchmark::State& state, const std::string& method,
+                        const std::string& path, const std::string& body) {
+  Api::ApiPtr api = Api::createApiForTest();
+  const JsonTranscoderConfigSharedPtr config = makeConfig(*api);
+  Stats::IsolatedStoreImpl store;
+  const auto stats = std::make_shared<GrpcJsonTranscoderFilterStats>(
+      GrpcJsonTranscoderFilterStats::generateStats("prefix", *store.rootScope()));
+  testing::NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  testing::NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks;
+
+  uint64_t transcoded_bytes = 0;
+  for (auto _ : state) { // NOLINT
+    JsonTranscoderFilter filter(config, stats);
+    filter.setDecoderFilterCallbacks(decoder_callbacks);
+    filter.setEncoderFilterCallbacks(encoder_callbacks);
+    Http::TestRequestHeaderMapImpl headers{
+        {"content-type", "application/json"}, {":method", method}, {":path", path}};
+    filter.decodeHeaders(headers, false);
+    for (uint64_t offset = 0; offset < body.size(); offset += ChunkSize) {
+      Buffer::OwnedImpl data(absl::string_view(body).substr(offset, ChunkSize));
+      filter.decodeData(data, offset + ChunkSize >= body.size());
+      transcoded_bytes += data.length();
+    }
+    filter.onDestroy();
+  }
+  benchmark::DoNotOptimize(transcoded_bytes);
+  state.SetBytesProcessed(state.iterations() * body.size());
+}
+
+// A book with range(0) quotes.
+void bmUnaryRepeatedField(benchmark::State& state) {
+  std::string body = "{\"id\": 1, \"title\": \"Quotes\", \"quotes\": [";
+  for (int64_t i = 0; i < state.range(0); i++) {
+    absl::StrAppend(&body, i == 0 ? "" : ",", "\"All happy families are alike; each unhappy ",
+                    "family is unhappy in its own way. ", i, "\"");
+  }
+  absl::StrAppend(&body, "]}");
+  bmTranscodeRequest(state, "PUT", "/shelves/1/books", body);
+}
+BENCHMARK(bmUnaryRepeatedField)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// range(0) shelves created in a client streaming request.
+void bmClientStreaming(benchmark::State& state) {
+  std::string body = "[";
+  for (int64_t i = 0; i < state.range(0); i++) {
+    absl::StrAppend(&body, i == 0 ? "" : ",", "{\"id\": ", i, ", \"theme\": \"Children\"}");
+  }
+  absl::StrAppend(&body, "]");
+  bmTranscodeRequest(state, "POST", "/bulk/shelves", body);
+}
+BENCHMARK(bmClientStreaming)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace GrpcJsonTranscoder
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -17,6 +17,7 @@
 #include "test/test_common/environment.h"
 #include "test/test_common/printers.h"
 #include "test/test_common/status_utility.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -1716,6 +1717,70 @@ TEST_F(GrpcJsonTranscoderFilterMaxMessageSizeTest, DoesNotDecreaseBufferSize) {
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
 };
 
+// The JSON of a request message is bounded while it is transcoded, even though the transcoder
+// consumes each chunk of it as it is received.
+TEST_F(GrpcJsonTranscoderFilterMaxMessageSizeTest, RequestMessageExceedsMaxBodySizeInChunks) {
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"content-type", "application/json"}, {":method", "PUT"}, {":path", "/shelves/1/books"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+
+  Buffer::OwnedImpl request_start{"{\"id\": 1, \"quotes\": ["};
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(request_start, false));
+
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(Http::Code::PayloadTooLarge, _, _, _, _));
+  Http::FilterDataStatus status = Http::FilterDataStatus::Continue;
+  for (int i = 0; i < 100 && status == Http::FilterDataStatus::Continue; i++) {
+    Buffer::OwnedImpl quote{"\"All happy families are alike.\","};
+    status = filter_.decodeData(quote, false);
+    EXPECT_EQ(0, quote.length());
+  }
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, status);
+}
+
+TEST_F(GrpcJsonTranscoderFilterMaxMessageSizeTest, RequestMessageInChunksNotBoundedWhenDisabled) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.grpc_json_transcoder_bound_pending_request_message", "false"}});
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"content-type", "application/json"}, {":method", "PUT"}, {":path", "/shelves/1/books"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(_, _, _, _, _)).Times(0);
+  Buffer::OwnedImpl request_start{"{\"id\": 1, \"quotes\": ["};
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(request_start, false));
+  for (int i = 0; i < 100; i++) {
+    Buffer::OwnedImpl quote{"\"All happy families are alike.\","};
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(quote, false));
+  }
+  Buffer::OwnedImpl request_end{"\"The end.\"]}"};
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(request_end, true));
+
+  Grpc::Decoder decoder;
+  std::vector<Grpc::Frame> frames;
+  ASSERT_TRUE(decoder.decode(request_end, frames).ok());
+  ASSERT_EQ(1, frames.size());
+  bookstore::CreateBookRequest request;
+  ASSERT_TRUE(request.ParseFromString(frames[0].data_->toString()));
+  EXPECT_EQ(101, request.book().quotes_size());
+}
+
+// The messages of a client streaming request are bounded individually.
+TEST_F(GrpcJsonTranscoderFilterMaxMessageSizeTest, StreamingRequestMessagesInChunks) {
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"content-type", "application/json"}, {":method", "POST"}, {":path", "/bulk/shelves"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(_, _, _, _, _)).Times(0);
+  Buffer::OwnedImpl request_start{"["};
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(request_start, false));
+  for (int i = 0; i < 100; i++) {
+    Buffer::OwnedImpl shelf{"{\"theme\": \"Children\"},"};
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(shelf, false));
+  }
+  Buffer::OwnedImpl request_end{"{\"theme\": \"Classics\"}]"};
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(request_end, true));
+}
+
 class GrpcJsonTranscoderFilterReportCollisionTest : public GrpcJsonTranscoderFilterTest {
 public:
   GrpcJsonTranscoderFilterReportCollisionTest() : GrpcJsonTranscoderFilterTest(makeProtoConfig()) {}
@@ -1,5 +1,6 @@
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
 
@@ -8,6 +9,7 @@
 
 #include "test/extensions/filters/http/jwt_authn/test_common.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 namespace Envoy {
@@ -27,12 +29,23 @@ public:
     cache_ = JwtCache::create(enable, config, time_system_);
   }
 
+  void setupCache(const std::string& yaml) {
+    envoy::extensions::filters::http::jwt_authn::v3::JwtCacheConfig config;
+    TestUtility::loadFromYaml(yaml, config);
+    cache_ = JwtCache::create(true, config, time_system_);
+  }
+
   void loadJwt(const char* jwt_str) {
     jwt_ = std::make_unique<JwtVerify::Jwt>();
     Status status = jwt_->parseFromString(jwt_str);
     EXPECT_EQ(status, Status::Ok);
   }
 
+  void insertJwt(const char* jwt_str) {
+    loadJwt(jwt_str);
+    cache_->insert(jwt_str, std::move(jwt_));
+  }
+
   Event::SimulatedTimeSystem time_system_;
   JwtCachePtr cache_;
   std::unique_ptr<JwtVerify::Jwt> jwt_;
@@ -48,11 +61,11 @@ TEST_F(JwtCacheTest, TestEnabledCache) {
   // jwt ownership is moved into the cache.
   EXPECT_FALSE(jwt_);
 
-  auto* jwt1 = cache_->lookup(GoodToken);
+  auto jwt1 = cache_->lookup(GoodToken);
   EXPECT_TRUE(jwt1 != nullptr);
-  EXPECT_EQ(jwt1, origin_jwt);
+  EXPECT_EQ(jwt1.get(), origin_jwt);
 
-  auto* jwt2 = cache_->lookup(ExpiredToken);
+  auto jwt2 = cache_->lookup(ExpiredToken);
   EXPECT_TRUE(jwt2 == nullptr);
 }
 
@@ -65,7 +78,7 @@ TEST_F(JwtCacheTest, TestDisabledCache) {
   // jwt ownership is not moved into the cache.
   EXPECT_TRUE(jwt_);
 
-  auto* jwt = cache_->lookup(GoodToken);
+  auto jwt = cache_->lookup(GoodToken);
   // not found since cache is disabled.
   EXPECT_TRUE(jwt == nullptr);
 }
@@ -77,7 +90,7 @@ TEST_F(JwtCacheTest, TestExpiredToken) {
 
   cache_->insert(ExpiredToken, std::move(jwt_));
 
-  auto* jwt = cache_->lookup(ExpiredToken);
+  auto jwt = cache_->lookup(ExpiredToken);
   // not be found since it is expired.
   EXPECT_TRUE(jwt == nullptr);
 }
@@ -92,9 +105,9 @@ TEST_F(JwtCacheTest, TestValidTokenSize) {
   // jwt ownership is moved into the cache.
   EXPECT_FALSE(jwt_);
 
-  auto* jwt = cache_->lookup(GoodToken);
+  auto jwt = cache_->lookup(GoodToken);
   EXPECT_TRUE(jwt != nullptr);
-  EXPECT_EQ(jwt, origin_jwt);
+  EXPECT_EQ(jwt.get(), origin_jwt);
 }
 
 TEST_F(JwtCacheTest, TestInvalidTokenSize) {
@@ -106,10 +119,97 @@ TEST_F(JwtCacheTest, TestInvalidTokenSize) {
   // jwt ownership is not moved into the cache.
   EXPECT_TRUE(jwt_);
 
-  auto* jwt = cache_->lookup(GoodToken);
+  auto jwt = cache_->lookup(GoodToken);
   EXPECT_TRUE(jwt == nullptr);
 }
 
+TEST_F(JwtCacheTest, TestCacheSizeBytes) {
+  // The size in bytes bounds the cache instead of the number of JWTs.
+  setupCache(R"EOF(
+  jwt_cache_size: 1
+  jwt_cache_size_bytes: 1048576
+  )EOF");
+  insertJwt(GoodToken);
+  insertJwt(NonExpiringToken);
+  EXPECT_NE(cache_->lookup(GoodToken), nullptr);
+  EXPECT_NE(cache_->lookup(NonExpiringToken), nullptr);
+
+  // A JWT larger than the cache is not kept.
+  setupCache(R"EOF(
+  jwt_cache_size_bytes: 1
+  )EOF");
+  insertJwt(GoodToken);
+  EXPECT_EQ(cache_->lookup(GoodToken), nullptr);
+}
+
+TEST_F(JwtCacheTest, TestSharedCache) {
+  setupCache(R"EOF(
+  jwt_cache_size: 1
+  shared: true
+  num_shards: 1
+  )EOF");
+  loadJwt(GoodToken);
+  auto* origin_jwt = jwt_.get();
+  cache_->insert(GoodToken, std::move(jwt_));
+  auto jwt = cache_->lookup(GoodToken);
+  EXPECT_EQ(jwt.get(), origin_jwt);
+
+  // The JWT found stays valid when another worker evicts it.
+  insertJwt(NonExpiringToken);
+  EXPECT_EQ(cache_->lookup(GoodToken), nullptr);
+  EXPECT_NE(cache_->lookup(NonExpiringToken), nullptr);
+  EXPECT_EQ(jwt->jwt_, GoodToken);
+}
+
+TEST_F(JwtCacheTest, TestSharedCacheMoreShardsThanSize) {
+  // The shards are capped by the cache size, which bounds the number of JWTs cached.
+  setupCache(R"EOF(
+  jwt_cache_size: 1
+  shared: true
+  num_shards: 16
+  )EOF");
+  insertJwt(GoodToken);
+  insertJwt(NonExpiringToken);
+  EXPECT_EQ(cache_->lookup(GoodToken), nullptr);
+  EXPECT_NE(cache_->lookup(NonExpiringToken), nullptr);
+}
+
+TEST_F(JwtCacheTest, TestCacheSizeBytesClamped) {
+  setupCache(R"EOF(
+  jwt_cache_size_bytes: 18446744073709551615
+  )EOF");
+  insertJwt(GoodToken);
+  EXPECT_NE(cache_->lookup(GoodToken), nullptr);
+}
+
+TEST_F(JwtCacheTest, TestSharedCacheConcurrentAccess) {
+  setupCache(R"EOF(
+  jwt_cache_size: 2
+  shared: true
+  num_shards: 2
+  )EOF");
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([this]() {
+      for (int j = 0; j < 100; j++) {
+        const char* token = j % 2 == 0 ? GoodToken : NonExpiringToken;
+        auto jwt = cache_->lookup(token);
+        if (jwt == nullptr) {
+          auto parsed = std::make_unique<JwtVerify::Jwt>();
+          EXPECT_EQ(parsed->parseFromString(token), Status::Ok);
+          cache_->insert(token, std::move(parsed));
+        } else {
+          EXPECT_EQ(jwt->jwt_, token);
+        }
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+}
+
 } // namespace
 } // namespace JwtAuthn
 } // namespace HttpFilters
@@ -65,7 +65,7 @@ public:
 
 class MockJwtCache : public JwtCache {
 public:
-  MOCK_METHOD(JwtVerify::Jwt*, lookup, (const std::string&), ());
+  MOCK_METHOD(JwtConstSharedPtr, lookup, (const std::string&), ());
   MOCK_METHOD(void, insert, (const std::string&, std::unique_ptr<JwtVerify::Jwt>&&), ());
 };
 
@@ -171,6 +171,37 @@ TEST_F(FilterTest, RequestOk) {
   EXPECT_EQ(1U, findCounter("test.http_local_rate_limit.rate_limited"));
 }
 
+TEST_F(FilterTest, RequestOkWithTokenLeasing) {
+  setup(R"(
+  stat_prefix: test
+  token_bucket:
+    max_tokens: 3
+    tokens_per_fill: 1
+    fill_interval: 1000s
+  filter_enabled:
+    runtime_key: test_enabled
+    default_value:
+      numerator: 100
+      denominator: HUNDRED
+  filter_enforced:
+    runtime_key: test_enforced
+    default_value:
+      numerator: 100
+      denominator: HUNDRED
+  token_leasing:
+    lease_tokens: 2
+    lease_duration: 1s
+  )");
+  auto headers = Http::TestRequestHeaderMapImpl();
+  // The worker leases 2 tokens, then the last token of the bucket.
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_2_->decodeHeaders(headers, false));
+  EXPECT_EQ(3U, findCounter("test.http_local_rate_limit.ok"));
+  EXPECT_EQ(1U, findCounter("test.http_local_rate_limit.rate_limited"));
+}
+
 TEST_F(FilterTest, RequestOkPerConnection) {
   setup(fmt::format(config_yaml, "false", "1", "true", "\"OFF\""));
   auto headers = Http::TestRequestHeaderMapImpl();
@@ -65,6 +65,54 @@ TEST(RateLimitFilterConfigTest, RatelimitCorrectProto) {
   }
 }
 
+TEST(RateLimitFilterConfigTest, OverLimitCache) {
+  const std::string yaml = R"EOF(
+  domain: test
+  stat_prefix: name
+  rate_limit_service:
+    grpc_service:
+      envoy_grpc:
+        cluster_name: ratelimit_cluster
+  over_limit_cache:
+    max_entries: 100
+    coalesce_requests: true
+  )EOF";
+
+  envoy::extensions::filters::http::ratelimit::v3::RateLimit proto_config{};
+  TestUtility::loadFromYamlAndValidate(yaml, proto_config);
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_CALL(context.server_factory_context_.cluster_manager_.async_client_manager_,
+              getOrCreateRawAsyncClientWithHashKey(_, _, _))
+      .WillOnce(Invoke([](const Grpc::GrpcServiceConfigWithHashKey&, Stats::Scope&, bool) {
+        return std::make_unique<NiceMock<Grpc::MockAsyncClient>>();
+      }));
+
+  RateLimitFilterConfig factory;
+  Http::FilterFactoryCb cb =
+      factory.createFilterFactoryFromProto(proto_config, "stats", context).value();
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+  EXPECT_NE(nullptr, TestUtility::findCounter(context.store_,
+                                              "ratelimit.name.over_limit_cache_hit"));
+}
+
+TEST(RateLimitFilterConfigTest, OverLimitCacheInvalidMaxEntries) {
+  const std::string yaml = R"EOF(
+  domain: test
+  rate_limit_service:
+    grpc_service:
+      envoy_grpc:
+        cluster_name: ratelimit_cluster
+  over_limit_cache:
+    max_entries: 0
+  )EOF";
+
+  envoy::extensions::filters::http::ratelimit::v3::RateLimit proto_config{};
+  EXPECT_THROW(TestUtility::loadFromYamlAndValidate(yaml, proto_config), EnvoyException);
+}
+
 // The filter-level ``rate_limits`` field also accepts a ``limit`` override alongside
 // ``hits_addend``, exercising the FilterConfig (no_limit=false) path. See
 // https://github.com/envoyproxy/envoy/issues/45611.
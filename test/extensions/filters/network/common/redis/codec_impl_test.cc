@@ -8,6 +8,7 @@
 
 #include "test/extensions/filters/network/common/redis/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "absl/strings/match.h"
@@ -141,6 +142,42 @@ TEST_F(RedisRespValueTest, EqualityTestingAndCopyingTest) {
   EXPECT_EQ(value8.type(), RespType::Null);
 }
 
+// Copies share the payload of a buffered bulk string, and mutable access materializes it.
+TEST_F(RedisRespValueTest, BufferedString) {
+  RespValue value;
+  value.type(RespType::BulkString);
+  value.setBufferedString(std::make_unique<Buffer::OwnedImpl>("payload"));
+  ASSERT_NE(nullptr, value.bufferedString());
+
+  RespValue copy(value);
+  EXPECT_EQ(value.bufferedString(), copy.bufferedString());
+  RespValue assigned;
+  assigned = value;
+  EXPECT_EQ(value.bufferedString(), assigned.bufferedString());
+  EXPECT_EQ(value, copy);
+  EXPECT_EQ("\"payload\"", copy.toString());
+
+  // Const access keeps the payload.
+  const RespValue& const_value = value;
+  EXPECT_EQ("payload", const_value.asString());
+  EXPECT_NE(nullptr, value.bufferedString());
+
+  // Mutable access drops it.
+  value.asString().append("!");
+  EXPECT_EQ(nullptr, value.bufferedString());
+  EXPECT_EQ("payload!", value.asString());
+  EXPECT_EQ("payload", copy.asString());
+
+  RespValue moved(std::move(copy));
+  EXPECT_NE(nullptr, moved.bufferedString());
+  EXPECT_EQ("payload", moved.asString());
+
+  // Changing the type drops it.
+  moved.type(RespType::BulkString);
+  EXPECT_EQ(nullptr, moved.bufferedString());
+  EXPECT_EQ("", moved.asString());
+}
+
 TEST_F(RedisRespValueTest, MoveOperationsTest) {
   InSequence s;
 
@@ -279,6 +316,70 @@ TEST_F(RedisEncoderDecoderImplTest, BulkString) {
   EXPECT_EQ(0UL, buffer_.length());
 }
 
+// Large bulk strings are moved out of the decoded buffer and encoded by reference.
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkString) {
+  const std::string payload(DecoderImpl::kMinBufferedBulkStringLength * 3, 'v');
+  const std::string wire = absl::StrCat("*2\r\n$3\r\nSET\r\n$", payload.size(), "\r\n", payload,
+                                        "\r\n");
+  // Decode in chunks that do not line up with the framing.
+  for (uint64_t offset = 0; offset < wire.size(); offset += 10000) {
+    buffer_.add(wire.substr(offset, 10000));
+    decoder_.decode(buffer_);
+    EXPECT_EQ(0UL, buffer_.length());
+  }
+  ASSERT_EQ(1UL, decoded_values_.size());
+  const RespValue& value = decoded_values_[0]->asArray()[1];
+  ASSERT_NE(nullptr, value.bufferedString());
+  EXPECT_EQ(payload.size(), value.bufferedString()->length());
+  EXPECT_EQ(nullptr, decoded_values_[0]->asArray()[0].bufferedString());
+
+  encoder_.encode(*decoded_values_[0], buffer_);
+  // The encoded payload outlives the decoded value.
+  decoded_values_.clear();
+  EXPECT_EQ(wire, buffer_.toString());
+}
+
+// Bulk strings shorter than the threshold are copied into the value.
+TEST_F(RedisEncoderDecoderImplTest, SmallBulkStringNotBuffered) {
+  const std::string payload(DecoderImpl::kMinBufferedBulkStringLength - 1, 'v');
+  buffer_.add(absl::StrCat("$", payload.size(), "\r\n", payload, "\r\n"));
+  decoder_.decode(buffer_);
+  ASSERT_EQ(1UL, decoded_values_.size());
+  EXPECT_EQ(nullptr, decoded_values_[0]->bufferedString());
+  EXPECT_EQ(payload, decoded_values_[0]->asString());
+}
+
+// Values decoded after a buffered bulk string in the same buffer are not affected.
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkStringPipelined) {
+  const std::string payload(DecoderImpl::kMinBufferedBulkStringLength, 'v');
+  buffer_.add(absl::StrCat("$", payload.size(), "\r\n", payload, "\r\n:5\r\n+OK\r\n"));
+  decoder_.decode(buffer_);
+  ASSERT_EQ(3UL, decoded_values_.size());
+  EXPECT_EQ(payload, decoded_values_[0]->asString());
+  EXPECT_EQ(5, decoded_values_[1]->asInteger());
+  EXPECT_EQ("OK", decoded_values_[2]->asString());
+}
+
+// A buffered bulk string must still be followed by CRLF.
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkStringMissingCRLF) {
+  const std::string payload(DecoderImpl::kMinBufferedBulkStringLength, 'v');
+  buffer_.add(absl::StrCat("$", payload.size(), "\r\n", payload, "xx"));
+  EXPECT_THROW(decoder_.decode(buffer_), ProtocolError);
+}
+
+// With the runtime guard disabled, large bulk strings are copied into the value.
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkStringDisabled) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.redis_buffered_bulk_strings", "false"}});
+  DecoderImpl decoder(*this);
+  const std::string payload(DecoderImpl::kMinBufferedBulkStringLength, 'v');
+  buffer_.add(absl::StrCat("$", payload.size(), "\r\n", payload, "\r\n"));
+  decoder.decode(buffer_);
+  ASSERT_EQ(1UL, decoded_values_.size());
+  EXPECT_EQ(nullptr, decoded_values_[0]->bufferedString());
+  EXPECT_EQ(payload, decoded_values_[0]->asString());
+}
+
 TEST_F(RedisEncoderDecoderImplTest, Integer) {
   RespValue value;
   value.type(RespType::Integer);
@@ -0,0 +1,107 @@
+// Benchmarks for proxying RESP values through the decoder and the encoder, as the Redis proxy does
+// for requests and responses. Each benchmark runs with and without buffered bulk strings.
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/common/redis/codec_impl.h"
+
+#include "test/test_common/test_runtime.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Common {
+namespace Redis {
+namespace {
+
+// The size of the slices that the wire bytes are split into, as they would be when read from a
+// connection.
+constexpr uint64_t ReadSize = 16 * 1024;
+
+class PassThrough : public DecoderCallbacks {
+public:
+  explicit PassThrough(bool buffered_bulk_strings) {
+    scoped_runtime_.mergeValues({{"envoy.reloadable_features.redis_buffered_bulk_strings",
+                                  buffered_bulk_strings ? "true" : "false"}});
+    decoder_ = std::make_unique<DecoderImpl>(*this);
+  }
+
+  // Decodes `data` and encodes every decoded value into the output buffer, which is then drained
+  // as if written to the other connection.
+  void proxy(Buffer::Instance& data) {
+    decoder_->decode(data);
+    benchmark::DoNotOptimize(out_.length());
+    out_.drain(out_.length());
+  }
+
+  // DecoderCallbacks
+  void onRespValue(RespValuePtr&& value) override { encoder_.encode(*value, out_); }
+
+private:
+  TestScopedRuntime scoped_runtime_;
+  std::unique_ptr<DecoderImpl> decoder_;
+  EncoderImpl encoder_;
+  Buffer::OwnedImpl out_;
+};
+
+// Appends `wire` to `buffer` in slices of ReadSize bytes.
+void addReads(Buffer::Instance& buffer, const std::string& wire) {
+  for (uint64_t offset = 0; offset < wire.size(); offset += ReadSize) {
+    Buffer::OwnedImpl read(absl::string_view(wire).substr(offset, ReadSize));
+    buffer.move(read);
+  }
+}
+
+// A SET request with a value of range(0) bytes, with buffered bulk strings enabled if range(1) is
+// non-zero.
+static void bmSetRequest(benchmark::State& state) {
+  const std::string value(state.range(0), 'v');
+  const std::string wire = absl::StrCat("*3\r\n$3\r\nSET\r\n$11\r\nsession:123\r\n$", value.size(),
+                                        "\r\n", value, "\r\n");
+  PassThrough pass_through(state.range(1) != 0);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    Buffer::OwnedImpl data;
+    addReads(data, wire);
+    state.ResumeTiming();
+    pass_through.proxy(data);
+  }
+  state.SetBytesProcessed(state.iterations() * wire.size());
+}
+BENCHMARK(bmSetRequest)
+    ->ArgsProduct({{1024, 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// 16 pipelined GET responses with values of range(0) bytes, with buffered bulk strings enabled if
+// range(1) is non-zero.
+static void bmGetResponses(benchmark::State& state) {
+  constexpr uint64_t ResponseCount = 16;
+  const std::string value(state.range(0), 'v');
+  std::string wire;
+  for (uint64_t i = 0; i < ResponseCount; ++i) {
+    absl::StrAppend(&wire, "$", value.size(), "\r\n", value, "\r\n");
+  }
+  PassThrough pass_through(state.range(1) != 0);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    Buffer::OwnedImpl data;
+    addReads(data, wire);
+    state.ResumeTiming();
+    pass_through.proxy(data);
+  }
+  state.SetBytesProcessed(state.iterations() * wire.size());
+}
+BENCHMARK(bmGetResponses)
+    ->ArgsProduct({{1024, 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Redis
+} // namespace Common
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
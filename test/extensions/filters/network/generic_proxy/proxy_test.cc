@@ -111,7 +111,7 @@ public:
     filter_config_ = std::make_shared<FilterConfigImpl>(
         "generic_proxy.test_prefix.", std::move(codec_factory), route_config_provider_, factories,
         tracer_, std::move(tracing_config_), std::move(access_logs), code_or_flags_,
-        factory_context_);
+        factory_context_, write_coalescing_);
   }
 
   AccessLog::InstanceSharedPtr loggerFormFormat(const std::string& format = DEFAULT_LOG_FORMAT) {
@@ -135,6 +135,7 @@ public:
   Tracing::ConnectionManagerTracingConfigPtr tracing_config_;
 
   std::shared_ptr<FilterConfig> filter_config_;
+  WriteCoalescingConfigSharedPtr write_coalescing_;
 
   std::shared_ptr<NiceMock<MockRouteConfigProvider>> route_config_provider_{
       new NiceMock<MockRouteConfigProvider>()};
@@ -333,6 +334,40 @@ TEST_F(FilterTest, GetConnection) {
   EXPECT_EQ(nullptr, filter_->connection().ptr());
 }
 
+TEST_F(FilterTest, WriteCoalescing) {
+  write_coalescing_ = std::make_shared<WriteCoalescingConfig>(
+      envoy::extensions::filters::network::generic_proxy::v3::WriteCoalescing(),
+      "generic_proxy.test_prefix.downstream_", factory_context_.scope_);
+  auto* flush_callback =
+      new NiceMock<Event::MockSchedulableCallback>(&filter_callbacks_.connection_.dispatcher_);
+  initializeFilter();
+  EXPECT_EQ(write_coalescing_, filter_config_->writeCoalescing());
+
+  // The frames are written to the connection together at the end of the event loop iteration.
+  EXPECT_CALL(filter_callbacks_.connection_, write(_, _)).Times(0);
+  Buffer::OwnedImpl frame_1("frame1");
+  server_codec_callbacks_->writeToConnection(frame_1);
+  Buffer::OwnedImpl frame_2("frame2");
+  server_codec_callbacks_->writeToConnection(frame_2);
+
+  EXPECT_CALL(filter_callbacks_.connection_, write(BufferString("frame1frame2"), false));
+  flush_callback->invokeCallback();
+
+  // The buffered frames are written before the connection is closed.
+  Buffer::OwnedImpl frame_3("frame3");
+  server_codec_callbacks_->writeToConnection(frame_3);
+  EXPECT_CALL(filter_callbacks_.connection_, write(BufferString("frame3"), false));
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  filter_->closeDownstreamConnection();
+
+  EXPECT_EQ(3, factory_context_.store_
+                   .counterFromString("generic_proxy.test_prefix.downstream_coalesced_frames")
+                   .value());
+  EXPECT_EQ(2, factory_context_.store_
+                   .counterFromString("generic_proxy.test_prefix.downstream_coalesced_writes")
+                   .value());
+}
+
 TEST_F(FilterTest, BufferWaterMarkTest) {
   initializeFilter();
   filter_->onAboveWriteBufferHighWatermark();
@@ -60,7 +60,7 @@ class MockGenericUpstreamFactory : public GenericUpstreamFactory {
 public:
   MOCK_METHOD(GenericUpstreamSharedPtr, createGenericUpstream,
               (Upstream::ThreadLocalCluster&, Upstream::LoadBalancerContext*, Network::Connection&,
-               const CodecFactory&, bool),
+               const CodecFactory&, bool, const WriteCoalescingConfigSharedPtr&),
               (const));
 };
 
@@ -162,7 +162,7 @@ public:
           .WillOnce(Return(OptRef<const Tracing::Config>{}));
     }
 
-    EXPECT_CALL(mock_upstream_factory_, createGenericUpstream(_, _, _, _, _))
+    EXPECT_CALL(mock_upstream_factory_, createGenericUpstream(_, _, _, _, _, _))
         .WillOnce(Return(mock_generic_upstream_));
     EXPECT_CALL(*mock_generic_upstream_, appendUpstreamRequest(_, _));
   }
@@ -349,7 +349,7 @@ TEST_F(RouterFilterTest, UpstreamClusterNoHealthyUpstream) {
       {cluster_name});
 
   // No valid upstream.
-  EXPECT_CALL(mock_upstream_factory_, createGenericUpstream(_, _, _, _, _))
+  EXPECT_CALL(mock_upstream_factory_, createGenericUpstream(_, _, _, _, _, _))
       .WillOnce(Return(nullptr));
 
   EXPECT_CALL(mock_filter_callback_, sendLocalReply(_, _, _))
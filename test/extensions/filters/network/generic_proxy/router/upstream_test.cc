@@ -1,5 +1,6 @@
 #include <memory>
 
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/common/tracing/common_values.h"
 #include "source/extensions/filters/network/generic_proxy/router/router.h"
 
@@ -7,6 +8,7 @@
 #include "test/extensions/filters/network/generic_proxy/mocks/codec.h"
 #include "test/extensions/filters/network/generic_proxy/mocks/filter.h"
 #include "test/extensions/filters/network/generic_proxy/mocks/route.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/network/connection.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
 #include "test/test_common/utility.h"
@@ -116,17 +118,20 @@ public:
   std::shared_ptr<BoundGenericUpstream> createBoundGenericUpstream(size_t connection_id = 1) {
     if (connection_id == 1) {
       auto result = DefaultGenericUpstreamFactory::get().createGenericUpstream(
-          thread_local_cluster_, nullptr, mock_downstream_connection_1_, mock_codec_factory_, true);
+          thread_local_cluster_, nullptr, mock_downstream_connection_1_, mock_codec_factory_, true,
+          write_coalescing_);
       return std::dynamic_pointer_cast<BoundGenericUpstream>(result);
     } else {
       auto result = DefaultGenericUpstreamFactory::get().createGenericUpstream(
-          thread_local_cluster_, nullptr, mock_downstream_connection_2_, mock_codec_factory_, true);
+          thread_local_cluster_, nullptr, mock_downstream_connection_2_, mock_codec_factory_, true,
+          write_coalescing_);
       return std::dynamic_pointer_cast<BoundGenericUpstream>(result);
     }
   }
   std::shared_ptr<OwnedGenericUpstream> createOwnedGenericUpstream() {
     auto result = DefaultGenericUpstreamFactory::get().createGenericUpstream(
-        thread_local_cluster_, nullptr, mock_downstream_connection_1_, mock_codec_factory_, false);
+        thread_local_cluster_, nullptr, mock_downstream_connection_1_, mock_codec_factory_, false,
+        nullptr);
     return std::dynamic_pointer_cast<OwnedGenericUpstream>(result);
   }
 
@@ -141,6 +146,9 @@ public:
 
   NiceMock<Network::MockServerConnection> mock_downstream_connection_1_;
   NiceMock<Network::MockServerConnection> mock_downstream_connection_2_;
+
+  Stats::IsolatedStoreImpl store_;
+  WriteCoalescingConfigSharedPtr write_coalescing_;
 };
 
 TEST_F(UpstreamTest, BoundGenericUpstreamWillBeReusedForSameConnection) {
@@ -703,6 +711,42 @@ TEST_F(UpstreamTest, BoundGenericUpstreamUpstreamConnectionClose) {
   EXPECT_EQ(0, generic_upstream->waitingResponseRequestsSize());
 }
 
+TEST_F(UpstreamTest, BoundGenericUpstreamWriteCoalescing) {
+  write_coalescing_ = std::make_shared<WriteCoalescingConfig>(
+      envoy::extensions::filters::network::generic_proxy::v3::WriteCoalescing(), "test.upstream_",
+      *store_.rootScope());
+
+  EXPECT_CALL(thread_local_cluster_, tcpConnPool(_, _));
+  auto generic_upstream = createBoundGenericUpstream();
+
+  NiceMock<MockUpstreamRequestCallbacks> mock_upstream_request_callbacks;
+  EXPECT_CALL(thread_local_cluster_.tcp_conn_pool_, newConnection(_));
+  generic_upstream->appendUpstreamRequest(1, &mock_upstream_request_callbacks);
+
+  auto* flush_callback =
+      new NiceMock<Event::MockSchedulableCallback>(&mock_upstream_connection_.dispatcher_);
+  thread_local_cluster_.tcp_conn_pool_.poolReady(mock_upstream_connection_);
+  ASSERT_NE(nullptr, cocec_callbacks_);
+
+  // The frames are written to the connection together at the end of the event loop iteration.
+  EXPECT_CALL(mock_upstream_connection_, write(_, _)).Times(0);
+  Buffer::OwnedImpl frame_1("frame1");
+  cocec_callbacks_->writeToConnection(frame_1);
+  Buffer::OwnedImpl frame_2("frame2");
+  cocec_callbacks_->writeToConnection(frame_2);
+
+  EXPECT_CALL(mock_upstream_connection_, write(BufferString("frame1frame2"), false));
+  flush_callback->invokeCallback();
+  EXPECT_EQ(1, store_.counterFromString("test.upstream_coalesced_writes").value());
+
+  // The buffered frames are written before the connection is closed.
+  Buffer::OwnedImpl frame_3("frame3");
+  cocec_callbacks_->writeToConnection(frame_3);
+  EXPECT_CALL(mock_upstream_connection_, write(BufferString("frame3"), false));
+  generic_upstream->cleanUp(true);
+  EXPECT_EQ(2, store_.counterFromString("test.upstream_coalesced_writes").value());
+}
+
 TEST_F(UpstreamTest, OwnedGenericUpstreamInitializeAndDestroyUpstreamBeforePoolReady) {
   EXPECT_CALL(thread_local_cluster_, tcpConnPool(_, _));
   auto generic_upstream = createOwnedGenericUpstream();
@@ -0,0 +1,159 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/network/generic_proxy/write_coalescer.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/connection.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace GenericProxy {
+namespace {
+
+class WriteCoalescerTest : public testing::Test {
+public:
+  void initialize(const std::string& yaml = "{}") {
+    envoy::extensions::filters::network::generic_proxy::v3::WriteCoalescing proto_config;
+    TestUtility::loadFromYaml(yaml, proto_config);
+    config_ = std::make_shared<WriteCoalescingConfig>(proto_config, "test.downstream_",
+                                                      *store_.rootScope());
+    ON_CALL(connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& buffer, bool) {
+          written_.push_back(buffer.toString());
+          buffer.drain(buffer.length());
+        }));
+  }
+
+  void write(absl::string_view frame) {
+    Buffer::OwnedImpl buffer(frame);
+    coalescer_->write(buffer);
+    EXPECT_EQ(0, buffer.length());
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counterFromString("test.downstream_" + name).value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  NiceMock<Network::MockConnection> connection_;
+  WriteCoalescingConfigSharedPtr config_;
+  std::unique_ptr<WriteCoalescer> coalescer_;
+  std::vector<std::string> written_;
+};
+
+TEST_F(WriteCoalescerTest, DefaultConfig) {
+  initialize();
+  EXPECT_EQ(16 * 1024, config_->maxBytes());
+  EXPECT_EQ(std::chrono::milliseconds(0), config_->maxDelay());
+}
+
+// The frames written in the same event loop iteration are written to the connection together at
+// the end of it.
+TEST_F(WriteCoalescerTest, CoalesceInCurrentIteration) {
+  initialize();
+  auto* flush_callback = new NiceMock<Event::MockSchedulableCallback>(&connection_.dispatcher_);
+  coalescer_ = std::make_unique<WriteCoalescer>(config_, connection_);
+
+  EXPECT_CALL(*flush_callback, scheduleCallbackCurrentIteration());
+  write("frame1");
+  write("frame2");
+  write("frame3");
+  EXPECT_TRUE(written_.empty());
+  EXPECT_EQ(18, coalescer_->bufferedBytes());
+
+  flush_callback->invokeCallback();
+  EXPECT_EQ(std::vector<std::string>{"frame1frame2frame3"}, written_);
+  EXPECT_EQ(0, coalescer_->bufferedBytes());
+  EXPECT_EQ(3, counter("coalesced_frames"));
+  EXPECT_EQ(1, counter("coalesced_writes"));
+
+  // The next frame schedules a new flush.
+  EXPECT_CALL(*flush_callback, scheduleCallbackCurrentIteration());
+  write("frame4");
+  flush_callback->invokeCallback();
+  EXPECT_EQ(2, written_.size());
+  EXPECT_EQ(4, counter("coalesced_frames"));
+  EXPECT_EQ(2, counter("coalesced_writes"));
+}
+
+// The buffered frames are written as soon as max_bytes are buffered.
+TEST_F(WriteCoalescerTest, FlushOnMaxBytes) {
+  initialize("max_bytes: 10");
+  auto* flush_callback = new NiceMock<Event::MockSchedulableCallback>(&connection_.dispatcher_);
+  coalescer_ = std::make_unique<WriteCoalescer>(config_, connection_);
+
+  write("frame1");
+  EXPECT_TRUE(written_.empty());
+  EXPECT_CALL(*flush_callback, cancel());
+  write("frame2");
+  EXPECT_EQ(std::vector<std::string>{"frame1frame2"}, written_);
+  EXPECT_EQ(2, counter("coalesced_frames"));
+  EXPECT_EQ(1, counter("coalesced_writes"));
+}
+
+// With a delay, the frames are buffered across event loop iterations until the timer fires.
+TEST_F(WriteCoalescerTest, FlushAfterMaxDelay) {
+  initialize("max_delay: 0.005s");
+  auto* flush_timer = new NiceMock<Event::MockTimer>(&connection_.dispatcher_);
+  coalescer_ = std::make_unique<WriteCoalescer>(config_, connection_);
+
+  // The timer is armed by the first frame only.
+  EXPECT_CALL(*flush_timer, enableTimer(std::chrono::milliseconds(5), _));
+  write("frame1");
+  write("frame2");
+  EXPECT_TRUE(written_.empty());
+
+  flush_timer->invokeCallback();
+  EXPECT_EQ(std::vector<std::string>{"frame1frame2"}, written_);
+}
+
+// An explicit flush writes the buffered frames now and cancels the scheduled flush.
+TEST_F(WriteCoalescerTest, ExplicitFlush) {
+  initialize();
+  auto* flush_callback = new NiceMock<Event::MockSchedulableCallback>(&connection_.dispatcher_);
+  coalescer_ = std::make_unique<WriteCoalescer>(config_, connection_);
+
+  // Nothing is written if nothing is buffered.
+  coalescer_->flush();
+  EXPECT_TRUE(written_.empty());
+
+  write("frame1");
+  EXPECT_CALL(*flush_callback, cancel());
+  coalescer_->flush();
+  EXPECT_EQ(std::vector<std::string>{"frame1"}, written_);
+  EXPECT_FALSE(flush_callback->enabled_);
+}
+
+// The buffered frames are dropped if the connection is closed before they are written.
+TEST_F(WriteCoalescerTest, ConnectionClosed) {
+  initialize();
+  auto* flush_callback = new NiceMock<Event::MockSchedulableCallback>(&connection_.dispatcher_);
+  coalescer_ = std::make_unique<WriteCoalescer>(config_, connection_);
+
+  write("frame1");
+  connection_.state_ = Network::Connection::State::Closed;
+  EXPECT_CALL(connection_, write(_, _)).Times(0);
+  flush_callback->invokeCallback();
+  EXPECT_EQ(0, coalescer_->bufferedBytes());
+  EXPECT_EQ(0, counter("coalesced_writes"));
+}
+
+} // namespace
+} // namespace GenericProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -165,6 +165,167 @@ TEST(BsonImplTest, ConfigurableParsingDepthLimit) {
                             "BSON recursion limit exceeded");
 }
 
+DocumentSharedPtr createTestDocument() {
+  return DocumentImpl::create()
+      ->addString("string", "string")
+      ->addSymbol("symbol", "symbol")
+      ->addDouble("double", 2.1)
+      ->addDocument("document", DocumentImpl::create()->addString("hello", "world"))
+      ->addArray("array", DocumentImpl::create()->addString("0", "foo"))
+      ->addBinary("binary", "binary_value")
+      ->addObjectId("object_id", Field::ObjectId())
+      ->addBoolean("true", true)
+      ->addDatetime("datetime", 1)
+      ->addNull("null")
+      ->addRegex("regex", {"hello", "i"})
+      ->addInt32("int32", 1)
+      ->addTimestamp("timestamp", 1000)
+      ->addInt64("int64", 2);
+}
+
+TEST(LazyDocumentImplTest, FindDecodesOnlyFoundFields) {
+  DocumentSharedPtr doc = createTestDocument();
+  Buffer::OwnedImpl data;
+  doc->encode(data);
+  const std::string encoded = data.toString();
+
+  DocumentSharedPtr lazy_doc = LazyDocumentImpl::create(data, 100);
+  const auto& lazy = dynamic_cast<const LazyDocumentImpl&>(*lazy_doc);
+  EXPECT_EQ(0, data.length());
+
+  EXPECT_EQ("string", lazy.front()->key());
+  EXPECT_EQ(1, lazy.find("int32")->asInt32());
+  EXPECT_EQ(2, lazy.find("int64", Field::Type::Int64)->asInt64());
+  EXPECT_EQ(nullptr, lazy.find("int64", Field::Type::Int32));
+  EXPECT_EQ(nullptr, lazy.find("missing"));
+  EXPECT_EQ("i", lazy.find("regex")->asRegex().options_);
+  EXPECT_EQ(Field::Type::NullValue, lazy.find("null")->type());
+  const Field* embedded = lazy.find("document", Field::Type::Document);
+  EXPECT_EQ("world", embedded->asDocument().find("hello")->asString());
+  EXPECT_EQ(lazy.find("document"), embedded);
+  EXPECT_FALSE(lazy.decoded());
+
+  // The wire bytes are encoded as is.
+  EXPECT_EQ(static_cast<int32_t>(encoded.size()), lazy.byteSize());
+  Buffer::OwnedImpl output;
+  lazy.encode(output);
+  EXPECT_EQ(encoded, output.toString());
+
+  // Comparing needs every field. Fields that were found before stay valid.
+  EXPECT_TRUE(lazy == *doc);
+  EXPECT_TRUE(lazy.decoded());
+  EXPECT_EQ(doc->toString(), lazy.toString());
+  EXPECT_EQ("world", embedded->asDocument().find("hello")->asString());
+  EXPECT_EQ(1, lazy.find("int32")->asInt32());
+  EXPECT_EQ(static_cast<int32_t>(encoded.size()), lazy.byteSize());
+}
+
+TEST(LazyDocumentImplTest, Add) {
+  Buffer::OwnedImpl data;
+  DocumentImpl::create()->addString("hello", "world")->encode(data);
+  DocumentSharedPtr lazy = LazyDocumentImpl::create(data, 100);
+
+  EXPECT_EQ(lazy, lazy->addInt32("int32", 1));
+  EXPECT_TRUE(*DocumentImpl::create()->addString("hello", "world")->addInt32("int32", 1) == *lazy);
+}
+
+TEST(LazyDocumentImplTest, Empty) {
+  Buffer::OwnedImpl data;
+  DocumentImpl::create()->encode(data);
+  DocumentSharedPtr lazy = LazyDocumentImpl::create(data, 100);
+  EXPECT_EQ(nullptr, lazy->front());
+  EXPECT_EQ(nullptr, lazy->find("hello"));
+  EXPECT_TRUE(lazy->values().empty());
+}
+
+TEST(LazyDocumentImplTest, InvalidDocument) {
+  {
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, 100);
+    EXPECT_THROW(LazyDocumentImpl::create(buffer, 100), EnvoyException);
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, 2);
+    EXPECT_THROW(LazyDocumentImpl::create(buffer, 100), EnvoyException);
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, 5);
+    uint8_t invalid_document_end = 0x1;
+    buffer.add(&invalid_document_end, sizeof(invalid_document_end));
+    EXPECT_THROW(LazyDocumentImpl::create(buffer, 100), EnvoyException);
+  }
+}
+
+// Fields are validated when they are walked over or decoded.
+TEST(LazyDocumentImplTest, InvalidField) {
+  {
+    Buffer::OwnedImpl buffer;
+    std::string key_name("hello");
+    BufferHelper::writeInt32(buffer, 4 + 1 + key_name.size() + 1 + 1);
+    uint8_t invalid_element_type = 0x20;
+    buffer.add(&invalid_element_type, sizeof(invalid_element_type));
+    BufferHelper::writeCString(buffer, key_name);
+    buffer.add(std::string(1, '\0'));
+    DocumentSharedPtr lazy = LazyDocumentImpl::create(buffer, 100);
+    EXPECT_THROW_WITH_MESSAGE(lazy->find("world"), EnvoyException,
+                              "invalid BSON element type: 0x20 key: hello");
+    EXPECT_THROW(lazy->values(), EnvoyException);
+  }
+
+  {
+    // A string that claims to be longer than the document.
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, 4 + 1 + 2 + 4 + 1);
+    uint8_t string_type = static_cast<uint8_t>(Field::Type::String);
+    buffer.add(&string_type, sizeof(string_type));
+    BufferHelper::writeCString(buffer, "a");
+    BufferHelper::writeInt32(buffer, 100);
+    buffer.add(std::string(1, '\0'));
+    DocumentSharedPtr lazy = LazyDocumentImpl::create(buffer, 100);
+    EXPECT_THROW_WITH_MESSAGE(lazy->front(), EnvoyException, "invalid document");
+  }
+
+  {
+    // A key that runs into the document terminator.
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, 4 + 1 + 2);
+    uint8_t int32_type = static_cast<uint8_t>(Field::Type::Int32);
+    buffer.add(&int32_type, sizeof(int32_type));
+    buffer.add("a");
+    buffer.add(std::string(1, '\0'));
+    DocumentSharedPtr lazy = LazyDocumentImpl::create(buffer, 100);
+    EXPECT_THROW_WITH_MESSAGE(lazy->front(), EnvoyException, "invalid CString");
+  }
+}
+
+// Embedded documents are skipped over without being decoded, so their depth only matters once they
+// are decoded.
+TEST(LazyDocumentImplTest, ParsingDepthLimit) {
+  Buffer::OwnedImpl data;
+  DocumentSharedPtr nested = DocumentImpl::create();
+  DocumentSharedPtr current = nested;
+  for (int i = 0; i < 200; i++) {
+    DocumentSharedPtr next = DocumentImpl::create();
+    current->addDocument("a", next);
+    current = next;
+  }
+  DocumentImpl::create()->addDocument("nested", nested)->addString("hello", "world")->encode(data);
+
+  DocumentSharedPtr lazy = LazyDocumentImpl::create(data, 100);
+  EXPECT_EQ("world", lazy->find("hello")->asString());
+  EXPECT_THROW_WITH_MESSAGE(lazy->values(), EnvoyException, "BSON recursion limit exceeded");
+
+  const Document* embedded = &lazy->find("nested")->asDocument();
+  for (int i = 0; i < 99; i++) {
+    embedded = &embedded->find("a")->asDocument();
+  }
+  EXPECT_THROW_WITH_MESSAGE(embedded->find("a"), EnvoyException, "BSON recursion limit exceeded");
+}
+
 } // namespace Bson
 } // namespace MongoProxy
 } // namespace NetworkFilters
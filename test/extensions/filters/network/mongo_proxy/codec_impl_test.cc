@@ -11,7 +11,9 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::_;
 using testing::Eq;
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Pointee;
 
@@ -237,6 +239,41 @@ TEST_F(MongoCodecImplTest, Insert) {
   decoder_.onData(output_);
 }
 
+// Documents of messages decoded with lazy BSON are only decoded once they are needed.
+TEST_F(MongoCodecImplTest, LazyBson) {
+  DecoderImpl lazy_decoder(callbacks_, 100, true);
+
+  InsertMessageImpl insert(4, 4);
+  insert.fullCollectionName("db.test");
+  insert.documents().push_back(
+      Bson::DocumentImpl::create()
+          ->addString("_id", "1")
+          ->addDocument("document", Bson::DocumentImpl::create()->addString("hello", "world")));
+  insert.documents().push_back(Bson::DocumentImpl::create()->addInt32("_id", 2));
+
+  QueryMessageImpl query(5, 5);
+  query.fullCollectionName("db.$cmd");
+  query.query(Bson::DocumentImpl::create()->addString("find", "test")->addString("comment", "c"));
+
+  encoder_.encodeInsert(insert);
+  encoder_.encodeQuery(query);
+  EXPECT_CALL(callbacks_, decodeInsert_(_)).WillOnce(Invoke([&](InsertMessagePtr& message) {
+    for (const Bson::DocumentSharedPtr& document : message->documents()) {
+      EXPECT_FALSE(dynamic_cast<const Bson::LazyDocumentImpl&>(*document).decoded());
+    }
+    EXPECT_EQ("1", message->documents().front()->find("_id")->asString());
+    EXPECT_TRUE(*message == insert);
+  }));
+  EXPECT_CALL(callbacks_, decodeQuery_(_)).WillOnce(Invoke([&](QueryMessagePtr& message) {
+    EXPECT_EQ("find", message->query()->front()->key());
+    EXPECT_EQ("c", message->query()->find("comment")->asString());
+    EXPECT_FALSE(dynamic_cast<const Bson::LazyDocumentImpl&>(*message->query()).decoded());
+    EXPECT_TRUE(*message == query);
+  }));
+  lazy_decoder.onData(output_);
+  EXPECT_EQ(0, output_.length());
+}
+
 TEST_F(MongoCodecImplTest, KillCursorsEqual) {
   {
     KillCursorsMessageImpl k1(0, 0);
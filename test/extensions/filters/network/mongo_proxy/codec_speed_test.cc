@@ -0,0 +1,130 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/fmt.h"
+#include "source/extensions/filters/network/mongo_proxy/bson_impl.h"
+#include "source/extensions/filters/network/mongo_proxy/codec_impl.h"
+#include "source/extensions/filters/network/mongo_proxy/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace MongoProxy {
+
+// Extracts what the proxy filter extracts from each message.
+class SpeedTestDecoderCallbacks : public DecoderCallbacks {
+public:
+  void decodeGetMore(GetMoreMessagePtr&&) override {}
+  void decodeInsert(InsertMessagePtr&& message) override {
+    benchmark::DoNotOptimize(message->fullCollectionName());
+  }
+  void decodeKillCursors(KillCursorsMessagePtr&&) override {}
+  void decodeQuery(QueryMessagePtr&& message) override {
+    QueryMessageInfo info(*message);
+    benchmark::DoNotOptimize(info.command());
+  }
+  void decodeReply(ReplyMessagePtr&&) override {}
+  void decodeCommand(CommandMessagePtr&&) override {}
+  void decodeCommandReply(CommandReplyMessagePtr&&) override {}
+};
+
+// Creates a document of roughly the given size, with a nested document and an array as bulk
+// inserts usually have.
+Bson::DocumentSharedPtr createDocument(uint32_t id, uint64_t size) {
+  const uint64_t values = size / 128 + 1;
+  Bson::DocumentSharedPtr nested = Bson::DocumentImpl::create();
+  Bson::DocumentSharedPtr array = Bson::DocumentImpl::create();
+  for (uint64_t i = 0; i < values; i++) {
+    nested->addString(fmt::format("field{}", i), std::string(64, 'v'));
+    array->addInt64(std::to_string(i), i);
+  }
+  return Bson::DocumentImpl::create()
+      ->addInt32("_id", id)
+      ->addString("name", "name")
+      ->addDocument("nested", nested)
+      ->addArray("array", array);
+}
+
+// Encodes an OP_INSERT message with the given number of documents of the given size.
+std::string encodeInsert(uint64_t documents, uint64_t document_size) {
+  InsertMessageImpl insert(1, 0);
+  insert.fullCollectionName("db.test");
+  for (uint64_t i = 0; i < documents; i++) {
+    insert.documents().push_back(createDocument(i, document_size));
+  }
+
+  Buffer::OwnedImpl output;
+  EncoderImpl(output).encodeInsert(insert);
+  return output.toString();
+}
+
+// Encodes an insert command sent as an OP_QUERY message, as drivers send bulk inserts.
+std::string encodeInsertCommand(uint64_t documents, uint64_t document_size) {
+  Bson::DocumentSharedPtr array = Bson::DocumentImpl::create();
+  for (uint64_t i = 0; i < documents; i++) {
+    array->addDocument(std::to_string(i), createDocument(i, document_size));
+  }
+
+  QueryMessageImpl query(1, 0);
+  query.fullCollectionName("db.$cmd");
+  query.numberToReturn(-1);
+  query.query(Bson::DocumentImpl::create()
+                  ->addString("insert", "test")
+                  ->addArray("documents", array)
+                  ->addString("$comment", R"({"callingFunction": "insert"})"));
+
+  Buffer::OwnedImpl output;
+  EncoderImpl(output).encodeQuery(query);
+  return output.toString();
+}
+
+void decode(benchmark::State& state, const std::string& message, bool lazy_bson) {
+  SpeedTestDecoderCallbacks callbacks;
+  DecoderImpl decoder(callbacks, 100, lazy_bson);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Buffer::OwnedImpl data(message);
+    decoder.onData(data);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * message.size());
+}
+
+} // namespace MongoProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
+
+// Arguments are the number of documents and their size in bytes. Bytes per second is the inverse
+// of CPU time per MB.
+static void bmDecodeInsert(benchmark::State& state) {
+  const std::string message = Envoy::Extensions::NetworkFilters::MongoProxy::encodeInsert(
+      state.range(0), state.range(1));
+  Envoy::Extensions::NetworkFilters::MongoProxy::decode(state, message, false);
+}
+BENCHMARK(bmDecodeInsert)->Args({1, 1 << 20})->Args({100, 16 << 10})->Args({1000, 1 << 10});
+
+static void bmDecodeInsertLazy(benchmark::State& state) {
+  const std::string message = Envoy::Extensions::NetworkFilters::MongoProxy::encodeInsert(
+      state.range(0), state.range(1));
+  Envoy::Extensions::NetworkFilters::MongoProxy::decode(state, message, true);
+}
+BENCHMARK(bmDecodeInsertLazy)->Args({1, 1 << 20})->Args({100, 16 << 10})->Args({1000, 1 << 10});
+
+static void bmDecodeInsertCommand(benchmark::State& state) {
+  const std::string message = Envoy::Extensions::NetworkFilters::MongoProxy::encodeInsertCommand(
+      state.range(0), state.range(1));
+  Envoy::Extensions::NetworkFilters::MongoProxy::decode(state, message, false);
+}
+BENCHMARK(bmDecodeInsertCommand)->Args({1, 1 << 20})->Args({100, 16 << 10});
+
+static void bmDecodeInsertCommandLazy(benchmark::State& state) {
+  const std::string message = Envoy::Extensions::NetworkFilters::MongoProxy::encodeInsertCommand(
+      state.range(0), state.range(1));
+  Envoy::Extensions::NetworkFilters::MongoProxy::decode(state, message, true);
+}
+BENCHMARK(bmDecodeInsertCommandLazy)->Args({1, 1 << 20})->Args({100, 16 << 10});
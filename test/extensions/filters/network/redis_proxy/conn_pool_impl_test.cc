@@ -18,6 +18,8 @@
 #include "test/extensions/filters/network/common/redis/test_utils.h"
 #include "test/extensions/filters/network/redis_proxy/mocks.h"
 #include "test/mocks/api/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/server_factory_context.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/upstream/cluster.h"
 #include "test/mocks/upstream/cluster_manager.h"
@@ -101,7 +103,7 @@ public:
         Common::Redis::Client::createConnPoolSettings(20, hashtagging, true, max_unknown_conns,
                                                       read_policy_, redis_cx_rate_limit_per_sec),
         api_, store_.rootScope(), redis_command_stats, cluster_refresh_manager_, dns_cache,
-        std::nullopt, std::nullopt, /*local_zone=*/"", protocol_version);
+        std::nullopt, std::nullopt, /*local_zone=*/"", protocol_version, read_coalescer_config_);
     conn_pool_impl->init();
     // Set the authentication password for this connection pool.
     conn_pool_impl->tls_->getTyped<InstanceImpl::ThreadLocalPool>().auth_username_ = auth_username_;
@@ -355,6 +357,7 @@ public:
   std::shared_ptr<NiceMock<Extensions::Common::Redis::MockClusterRefreshManager>>
       cluster_refresh_manager_;
   Common::Redis::Client::NoOpTransaction transaction_;
+  ReadCoalescerConfigConstSharedPtr read_coalescer_config_;
 };
 
 TEST_F(RedisConnPoolImplTest, Basic) {
@@ -388,6 +391,56 @@ TEST_F(RedisConnPoolImplTest, Basic) {
   tls_.shutdownThread();
 };
 
+// With read coalescing configured, identical reads in flight share one upstream request.
+TEST_F(RedisConnPoolImplTest, ReadCoalescing) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  read_coalescer_config_ = std::make_shared<const ReadCoalescerConfig>(
+      envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCoalescing(),
+      factory_context);
+  // Delivers the responses served from the coalescer's cache.
+  new NiceMock<Event::MockSchedulableCallback>(&tls_.dispatcher_);
+  setup();
+
+  Common::Redis::RespValueSharedPtr value = std::make_shared<Common::Redis::RespValue>();
+  std::vector<Common::Redis::RespValue> args(2);
+  args[0].type(Common::Redis::RespType::BulkString);
+  args[0].asString() = "get";
+  args[1].type(Common::Redis::RespType::BulkString);
+  args[1].asString() = "hash_key";
+  value->type(Common::Redis::RespType::Array);
+  value->asArray().swap(args);
+
+  Common::Redis::Client::MockPoolRequest active_request;
+  MockPoolCallbacks callbacks1;
+  MockPoolCallbacks callbacks2;
+  Common::Redis::Client::MockClient* client = new NiceMock<Common::Redis::Client::MockClient>();
+  Common::Redis::Client::ClientCallbacks* client_callbacks{};
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_))
+      .WillOnce(Return(cm_.thread_local_cluster_.lb_.host_));
+  EXPECT_CALL(*this, create_(_)).WillOnce(Return(client));
+  EXPECT_CALL(*cm_.thread_local_cluster_.lb_.host_, address())
+      .WillRepeatedly(Return(test_address_));
+  EXPECT_CALL(*client, makeRequest_(Ref(*value), _))
+      .WillOnce(Invoke([&](const Common::Redis::RespValue&,
+                           Common::Redis::Client::ClientCallbacks& callbacks)
+                           -> Common::Redis::Client::PoolRequest* {
+        client_callbacks = &callbacks;
+        return &active_request;
+      }));
+  EXPECT_NE(nullptr, conn_pool_->makeRequest("hash_key", value, callbacks1, transaction_));
+  EXPECT_NE(nullptr, conn_pool_->makeRequest("hash_key", value, callbacks2, transaction_));
+
+  EXPECT_CALL(callbacks1, onResponse_(_));
+  EXPECT_CALL(callbacks2, onResponse_(_));
+  Common::Redis::RespValuePtr response = std::make_unique<Common::Redis::RespValue>();
+  response->type(Common::Redis::RespType::BulkString);
+  response->asString() = "value";
+  client_callbacks->onResponse(std::move(response));
+
+  EXPECT_CALL(*client, close());
+  tls_.shutdownThread();
+}
+
 TEST_F(RedisConnPoolImplTest, ShardSize) {
   InSequence s;
 
@@ -1745,7 +1798,7 @@ TEST_F(RedisConnPoolImplTest, MakeRequestAndRedirectFollowedByDelete) {
       cluster_name_, cm_, *this, tls_,
       Common::Redis::Client::createConnPoolSettings(20, true, true, 100, read_policy_), api_,
       store_.rootScope(), redis_command_stats, cluster_refresh_manager_, nullptr, std::nullopt,
-      std::nullopt, /*local_zone=*/"", Common::Redis::RespProtocolVersion::Resp2);
+      std::nullopt, /*local_zone=*/"", Common::Redis::RespProtocolVersion::Resp2, nullptr);
   conn_pool_->init();
 
   auto& local_pool = threadLocalPool();
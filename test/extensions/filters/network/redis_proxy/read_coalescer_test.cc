@@ -0,0 +1,459 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/filters/network/redis_proxy/v3/redis_proxy.pb.h"
+
+#include "source/extensions/filters/network/common/redis/supported_commands.h"
+#include "source/extensions/filters/network/redis_proxy/read_coalescer.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/extensions/filters/network/common/redis/mocks.h"
+#include "test/extensions/filters/network/redis_proxy/mocks.h"
+#include "test/mocks/server/server_factory_context.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/ascii.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+namespace ConnPool {
+namespace {
+
+Common::Redis::RespValueSharedPtr command(const std::vector<std::string>& args) {
+  auto request = std::make_shared<Common::Redis::RespValue>();
+  std::vector<Common::Redis::RespValue> values(args.size());
+  for (size_t i = 0; i < args.size(); ++i) {
+    values[i].type(Common::Redis::RespType::BulkString);
+    values[i].asString() = args[i];
+  }
+  request->type(Common::Redis::RespType::Array);
+  request->asArray().swap(values);
+  return request;
+}
+
+// Returns the key the command splitter routes a request outside of a transaction by.
+std::string routingKey(const std::vector<std::string>& args) {
+  const std::string command = absl::AsciiStrToLower(args[0]);
+  if (Common::Redis::SupportedCommands::evalCommands().contains(command)) {
+    return args[3];
+  }
+  if (Common::Redis::SupportedCommands::objectCommands().contains(command)) {
+    return args[2];
+  }
+  return args[1];
+}
+
+Common::Redis::RespValuePtr bulkString(const std::string& value) {
+  auto response = std::make_unique<Common::Redis::RespValue>();
+  response->type(Common::Redis::RespType::BulkString);
+  response->asString() = value;
+  return response;
+}
+
+MATCHER_P(BulkStringEq, value, "") {
+  return arg != nullptr && arg->type() == Common::Redis::RespType::BulkString &&
+         arg->asString() == value;
+}
+
+class ReadCoalescerTest : public testing::Test {
+protected:
+  ReadCoalescerTest()
+      : api_(Api::createApiForTest(time_system_)),
+        dispatcher_(api_->allocateDispatcher("test_thread")) {}
+
+  void setup(const std::string& yaml = "") {
+    envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ReadCoalescing config;
+    TestUtility::loadFromYaml(yaml.empty() ? "{}" : yaml, config);
+    coalescer_ = std::make_unique<ReadCoalescer>(
+        std::make_shared<const ReadCoalescerConfig>(config, factory_context_),
+        ReadCoalescerStats{ALL_READ_COALESCER_STATS(POOL_COUNTER(*store_.rootScope()))},
+        *dispatcher_);
+  }
+
+  Common::Redis::Client::PoolRequest* makeRequest(const std::vector<std::string>& args,
+                                                  PoolCallbacks& callbacks) {
+    return makeRequest(routingKey(args), args, callbacks, false);
+  }
+
+  // The command splitter routes every request of a transaction by the first key of the
+  // transaction.
+  Common::Redis::Client::PoolRequest* makeTransactionRequest(const std::string& transaction_key,
+                                                             const std::vector<std::string>& args,
+                                                             PoolCallbacks& callbacks) {
+    return makeRequest(transaction_key, args, callbacks, true);
+  }
+
+  Common::Redis::Client::PoolRequest* makeRequest(const std::string& key,
+                                                  const std::vector<std::string>& args,
+                                                  PoolCallbacks& callbacks, bool in_transaction) {
+    return coalescer_->makeRequest(
+        key, command(args), callbacks, in_transaction,
+        [this](RespVariant&&,
+               PoolCallbacks& upstream_callbacks) -> Common::Redis::Client::PoolRequest* {
+          upstream_callbacks_.push_back(&upstream_callbacks);
+          return fail_upstream_ ? nullptr : &upstream_request_;
+        });
+  }
+
+  uint64_t counter(const std::string& name) { return store_.counter(name).value(); }
+
+  static constexpr absl::string_view CachedKeys = R"EOF(
+cached_keys:
+- prefix: "hot:"
+cache_ttl: 1s
+)EOF";
+
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Stats::TestUtil::TestStore store_;
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context_;
+  std::unique_ptr<ReadCoalescer> coalescer_;
+  std::vector<PoolCallbacks*> upstream_callbacks_;
+  NiceMock<Common::Redis::Client::MockPoolRequest> upstream_request_;
+  bool fail_upstream_{};
+};
+
+// Identical reads in flight share one upstream request, regardless of the command's case.
+TEST_F(ReadCoalescerTest, CoalescesIdenticalReads) {
+  setup();
+  MockPoolCallbacks callbacks1;
+  MockPoolCallbacks callbacks2;
+  EXPECT_NE(nullptr, makeRequest({"get", "foo"}, callbacks1));
+  EXPECT_NE(nullptr, makeRequest({"GET", "foo"}, callbacks2));
+  ASSERT_EQ(1, upstream_callbacks_.size());
+  EXPECT_EQ(1, counter("read_coalesced"));
+
+  EXPECT_CALL(callbacks1, onResponse_(BulkStringEq("bar")));
+  EXPECT_CALL(callbacks2, onResponse_(BulkStringEq("bar")));
+  upstream_callbacks_[0]->onResponse(bulkString("bar"));
+
+  // The group is gone once the response has been delivered.
+  MockPoolCallbacks callbacks3;
+  EXPECT_NE(nullptr, makeRequest({"get", "foo"}, callbacks3));
+  EXPECT_EQ(2, upstream_callbacks_.size());
+  EXPECT_CALL(callbacks3, onFailure_());
+  upstream_callbacks_[1]->onFailure();
+}
+
+// Reads with different commands or arguments are sent upstream separately.
+TEST_F(ReadCoalescerTest, DifferentReadsNotCoalesced) {
+  setup();
+  NiceMock<MockPoolCallbacks> callbacks;
+  makeRequest({"get", "foo"}, callbacks);
+  makeRequest({"get", "bar"}, callbacks);
+  makeRequest({"hget", "foo", "a"}, callbacks);
+  makeRequest({"hget", "foo", "b"}, callbacks);
+  // Arguments are length-prefixed, so these do not collide.
+  makeRequest({"hmget", "foo", std::string("a\0" "1:b", 5)}, callbacks);
+  makeRequest({"hmget", "foo", "a", "b"}, callbacks);
+  EXPECT_EQ(6, upstream_callbacks_.size());
+  EXPECT_EQ(0, counter("read_coalesced"));
+}
+
+// Failures are delivered to every waiter.
+TEST_F(ReadCoalescerTest, FailureDeliveredToAllWaiters) {
+  setup(std::string(CachedKeys));
+  MockPoolCallbacks callbacks1;
+  MockPoolCallbacks callbacks2;
+  makeRequest({"get", "hot:1"}, callbacks1);
+  makeRequest({"get", "hot:1"}, callbacks2);
+  ASSERT_EQ(1, upstream_callbacks_.size());
+
+  EXPECT_CALL(callbacks1, onFailure_());
+  EXPECT_CALL(callbacks2, onFailure_());
+  upstream_callbacks_[0]->onFailure();
+
+  // Nothing was cached.
+  NiceMock<MockPoolCallbacks> callbacks3;
+  makeRequest({"get", "hot:1"}, callbacks3);
+  EXPECT_EQ(2, upstream_callbacks_.size());
+}
+
+// The upstream request is only cancelled once every waiter has cancelled.
+TEST_F(ReadCoalescerTest, CancelWaiters) {
+  setup();
+  MockPoolCallbacks callbacks1;
+  MockPoolCallbacks callbacks2;
+  Common::Redis::Client::PoolRequest* request1 = makeRequest({"get", "foo"}, callbacks1);
+  Common::Redis::Client::PoolRequest* request2 = makeRequest({"get", "foo"}, callbacks2);
+
+  EXPECT_CALL(upstream_request_, cancel()).Times(0);
+  request1->cancel();
+  testing::Mock::VerifyAndClearExpectations(&upstream_request_);
+
+  EXPECT_CALL(upstream_request_, cancel());
+  request2->cancel();
+
+  // A new read is not joined to the cancelled request.
+  NiceMock<MockPoolCallbacks> callbacks3;
+  makeRequest({"get", "foo"}, callbacks3);
+  EXPECT_EQ(2, upstream_callbacks_.size());
+}
+
+// A waiter may cancel another waiter from within its callback.
+TEST_F(ReadCoalescerTest, CancelWaiterDuringDelivery) {
+  setup();
+  MockPoolCallbacks callbacks1;
+  MockPoolCallbacks callbacks2;
+  makeRequest({"get", "foo"}, callbacks1);
+  Common::Redis::Client::PoolRequest* request2 = makeRequest({"get", "foo"}, callbacks2);
+
+  EXPECT_CALL(callbacks1, onResponse_(BulkStringEq("bar")))
+      .WillOnce(Invoke([&](Common::Redis::RespValuePtr&) { request2->cancel(); }));
+  EXPECT_CALL(callbacks2, onResponse_(_)).Times(0);
+  EXPECT_CALL(upstream_request_, cancel()).Times(0);
+  upstream_callbacks_[0]->onResponse(bulkString("bar"));
+}
+
+// If the request cannot be sent upstream, nullptr is returned and no state is left behind.
+TEST_F(ReadCoalescerTest, UpstreamRequestNotMade) {
+  setup();
+  NiceMock<MockPoolCallbacks> callbacks;
+  fail_upstream_ = true;
+  EXPECT_EQ(nullptr, makeRequest({"get", "foo"}, callbacks));
+
+  fail_upstream_ = false;
+  EXPECT_NE(nullptr, makeRequest({"get", "foo"}, callbacks));
+  EXPECT_EQ(2, upstream_callbacks_.size());
+  EXPECT_EQ(0, counter("read_coalesced"));
+}
+
+// Responses for keys matching the cached keys are served from the cache until they expire.
+TEST_F(ReadCoalescerTest, CachesMatchingKeys) {
+  setup(std::string(CachedKeys));
+  NiceMock<MockPoolCallbacks> callbacks;
+  makeRequest({"get", "hot:1"}, callbacks);
+  makeRequest({"get", "cold:1"}, callbacks);
+  ASSERT_EQ(2, upstream_callbacks_.size());
+  upstream_callbacks_[0]->onResponse(bulkString("a"));
+  upstream_callbacks_[1]->onResponse(bulkString("b"));
+
+  // Cached responses are delivered asynchronously.
+  MockPoolCallbacks cached_callbacks;
+  EXPECT_CALL(cached_callbacks, onResponse_(_)).Times(0);
+  EXPECT_NE(nullptr, makeRequest({"get", "hot:1"}, cached_callbacks));
+  testing::Mock::VerifyAndClearExpectations(&cached_callbacks);
+  EXPECT_CALL(cached_callbacks, onResponse_(BulkStringEq("a")));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(1, counter("read_cache_hit"));
+
+  // Keys that do not match are not cached.
+  makeRequest({"get", "cold:1"}, callbacks);
+  EXPECT_EQ(3, upstream_callbacks_.size());
+
+  // Expired responses are not served.
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  makeRequest({"get", "hot:1"}, callbacks);
+  EXPECT_EQ(4, upstream_callbacks_.size());
+  EXPECT_EQ(1, counter("read_cache_hit"));
+}
+
+// Error responses are not cached.
+TEST_F(ReadCoalescerTest, ErrorsNotCached) {
+  setup(std::string(CachedKeys));
+  NiceMock<MockPoolCallbacks> callbacks;
+  makeRequest({"get", "hot:1"}, callbacks);
+  auto error = std::make_unique<Common::Redis::RespValue>();
+  error->type(Common::Redis::RespType::Error);
+  error->asString() = "ERR";
+  upstream_callbacks_[0]->onResponse(std::move(error));
+
+  makeRequest({"get", "hot:1"}, callbacks);
+  EXPECT_EQ(2, upstream_callbacks_.size());
+}
+
+// A cached response that is cancelled before it is delivered is dropped.
+TEST_F(ReadCoalescerTest, CancelCachedResponse) {
+  setup(std::string(CachedKeys));
+  NiceMock<MockPoolCallbacks> callbacks;
+  makeRequest({"get", "hot:1"}, callbacks);
+  upstream_callbacks_[0]->onResponse(bulkString("a"));
+
+  MockPoolCallbacks cached_callbacks;
+  makeRequest({"get", "hot:1"}, cached_callbacks)->cancel();
+  EXPECT_CALL(cached_callbacks, onResponse_(_)).Times(0);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+// Writes drop the cached responses of their key, and keep reads in flight on the key from being
+// joined or cached.
+TEST_F(ReadCoalescerTest, WritesInvalidateKey) {
+  setup(std::string(CachedKeys));
+  NiceMock<MockPoolCallbacks> callbacks;
+  makeRequest({"get", "hot:1"}, callbacks);
+  makeRequest({"get", "hot:2"}, callbacks);
+  upstream_callbacks_[0]->onResponse(bulkString("a"));
+  upstream_callbacks_[1]->onResponse(bulkString("b"));
+
+  // A read in flight when the write is made.
+  makeRequest({"hget", "hot:1", "field"}, callbacks);
+  ASSERT_EQ(3, upstream_callbacks_.size());
+
+  makeRequest({"set", "hot:1", "c"}, callbacks);
+  EXPECT_EQ(4, upstream_callbacks_.size());
+  EXPECT_EQ(1, counter("read_cache_invalidated"));
+
+  // Reads made after the write are not joined to the read made before it.
+  makeRequest({"hget", "hot:1", "field"}, callbacks);
+  EXPECT_EQ(5, upstream_callbacks_.size());
+  // The read made before the write is not cached.
+  upstream_callbacks_[2]->onResponse(bulkString("stale"));
+  upstream_callbacks_[4]->onResponse(bulkString("fresh"));
+  MockPoolCallbacks cached_callbacks;
+  makeRequest({"hget", "hot:1", "field"}, cached_callbacks);
+  EXPECT_CALL(cached_callbacks, onResponse_(BulkStringEq("fresh")));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  // The other key is still cached.
+  makeRequest({"get", "hot:2"}, callbacks);
+  makeRequest({"get", "hot:1"}, callbacks);
+  EXPECT_EQ(6, upstream_callbacks_.size());
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+// Scripts and commands sent to every shard that may change any key invalidate every key.
+TEST_F(ReadCoalescerTest, InvalidateAll) {
+  setup(std::string(CachedKeys));
+  NiceMock<MockPoolCallbacks> callbacks;
+  makeRequest({"get", "hot:1"}, callbacks);
+  makeRequest({"get", "hot:2"}, callbacks);
+  upstream_callbacks_[0]->onResponse(bulkString("a"));
+  upstream_callbacks_[1]->onResponse(bulkString("b"));
+
+  coalescer_->onShardRequest(*command({"info", "server"}));
+  EXPECT_EQ(0, counter("read_cache_invalidated"));
+  coalescer_->onShardRequest(*command({"FLUSHALL"}));
+  EXPECT_EQ(2, counter("read_cache_invalidated"));
+
+  makeRequest({"get", "hot:1"}, callbacks);
+  upstream_callbacks_[2]->onResponse(bulkString("a"));
+  makeRequest({"eval", "return 1", "1", "hot:2"}, callbacks);
+  EXPECT_EQ(3, counter("read_cache_invalidated"));
+  makeRequest({"get", "hot:1"}, callbacks);
+  EXPECT_EQ(5, upstream_callbacks_.size());
+}
+
+// Writes that may change keys other than the one they are routed by invalidate every key.
+TEST_F(ReadCoalescerTest, MultiKeyWritesInvalidateAll) {
+  setup(std::string(CachedKeys));
+  NiceMock<MockPoolCallbacks> callbacks;
+  makeRequest({"get", "hot:1"}, callbacks);
+  makeRequest({"get", "hot:2"}, callbacks);
+  upstream_callbacks_[0]->onResponse(bulkString("a"));
+  upstream_callbacks_[1]->onResponse(bulkString("b"));
+
+  makeRequest({"rename", "hot:1", "hot:2"}, callbacks);
+  EXPECT_EQ(2, counter("read_cache_invalidated"));
+
+  // BITOP is routed by its operation, not by its destination key.
+  makeRequest({"get", "hot:3"}, callbacks);
+  upstream_callbacks_[3]->onResponse(bulkString("c"));
+  makeRequest({"BITOP", "AND", "hot:3", "hot:1"}, callbacks);
+  EXPECT_EQ(3, counter("read_cache_invalidated"));
+
+  makeRequest({"get", "hot:3"}, callbacks);
+  EXPECT_EQ(6, upstream_callbacks_.size());
+  EXPECT_EQ(0, counter("read_cache_hit"));
+}
+
+// Requests in a transaction are neither coalesced nor served from the cache. The writes of a
+// transaction only run at EXEC, which invalidates every key both when it is made and when it
+// completes.
+TEST_F(ReadCoalescerTest, Transactions) {
+  setup(std::string(CachedKeys));
+  NiceMock<MockPoolCallbacks> callbacks;
+  makeRequest({"get", "hot:1"}, callbacks);
+  makeRequest({"get", "hot:2"}, callbacks);
+  upstream_callbacks_[0]->onResponse(bulkString("a"));
+  upstream_callbacks_[1]->onResponse(bulkString("b"));
+
+  makeTransactionRequest("hot:1", {"get", "hot:1"}, callbacks);
+  makeTransactionRequest("hot:1", {"get", "hot:1"}, callbacks);
+  EXPECT_EQ(4, upstream_callbacks_.size());
+  EXPECT_EQ(0, counter("read_cache_hit"));
+
+  // Queued writes have not run yet.
+  makeTransactionRequest("hot:1", {"set", "hot:2", "c"}, callbacks);
+  EXPECT_EQ(0, counter("read_cache_invalidated"));
+  makeRequest({"get", "hot:2"}, callbacks);
+  EXPECT_EQ(1, counter("read_cache_hit"));
+  EXPECT_EQ(5, upstream_callbacks_.size());
+
+  MockPoolCallbacks exec_callbacks;
+  EXPECT_NE(nullptr, makeTransactionRequest("hot:1", {"exec"}, exec_callbacks));
+  EXPECT_EQ(2, counter("read_cache_invalidated"));
+  ASSERT_EQ(6, upstream_callbacks_.size());
+
+  // A read made while EXEC is in flight may run before it, so its response is only cached until
+  // EXEC completes.
+  makeRequest({"get", "hot:2"}, callbacks);
+  upstream_callbacks_[6]->onResponse(bulkString("b"));
+  EXPECT_EQ(2, counter("read_cache_invalidated"));
+  EXPECT_CALL(exec_callbacks, onResponse_(_));
+  upstream_callbacks_[5]->onResponse(bulkString("OK"));
+  EXPECT_EQ(3, counter("read_cache_invalidated"));
+
+  makeRequest({"get", "hot:2"}, callbacks);
+  EXPECT_EQ(8, upstream_callbacks_.size());
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+// When the cache is full, expired responses are evicted to make room, and new responses are not
+// cached if none have expired.
+TEST_F(ReadCoalescerTest, CacheFull) {
+  setup(R"EOF(
+cached_keys:
+- prefix: "hot:"
+cache_ttl: 1s
+max_cached_responses: 1
+)EOF");
+  NiceMock<MockPoolCallbacks> callbacks;
+  makeRequest({"get", "hot:1"}, callbacks);
+  upstream_callbacks_[0]->onResponse(bulkString("a"));
+  makeRequest({"get", "hot:2"}, callbacks);
+  upstream_callbacks_[1]->onResponse(bulkString("b"));
+
+  // Only the first response was cached.
+  makeRequest({"get", "hot:1"}, callbacks);
+  makeRequest({"get", "hot:2"}, callbacks);
+  EXPECT_EQ(3, upstream_callbacks_.size());
+  upstream_callbacks_[2]->onResponse(bulkString("b"));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  makeRequest({"get", "hot:2"}, callbacks);
+  upstream_callbacks_[3]->onResponse(bulkString("b"));
+  makeRequest({"get", "hot:2"}, callbacks);
+  EXPECT_EQ(4, upstream_callbacks_.size());
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+// Cached responses that have not been delivered when the coalescer is destroyed are failed.
+TEST_F(ReadCoalescerTest, DestroyWithUndeliveredCachedResponse) {
+  setup(std::string(CachedKeys));
+  NiceMock<MockPoolCallbacks> callbacks;
+  makeRequest({"get", "hot:1"}, callbacks);
+  upstream_callbacks_[0]->onResponse(bulkString("a"));
+
+  MockPoolCallbacks cached_callbacks;
+  makeRequest({"get", "hot:1"}, cached_callbacks);
+  EXPECT_CALL(cached_callbacks, onFailure_());
+  coalescer_.reset();
+}
+
+} // namespace
+} // namespace ConnPool
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -116,7 +116,8 @@ public:
 
     router_ = std::make_unique<Router>(context_.server_factory_context_.cluster_manager_, *stats_,
                                        context_.server_factory_context_.runtime_loader_,
-                                       shadow_writer, close_downstream_on_error);
+                                       shadow_writer, close_downstream_on_error,
+                                       OptRef<UpstreamMultiplexer>());
 
     EXPECT_EQ(nullptr, router_->downstreamConnection());
     router_->onAboveWriteBufferHighWatermark();
@@ -131,6 +132,21 @@ public:
     initializeRouter(shadow_writer_, close_downstream_on_error);
   }
 
+  void initializeMultiplexedRouter() {
+    stats_ = std::make_shared<const RouterStats>("test", context_.scope(),
+                                                 context_.server_factory_context_.localInfo());
+    upstream_multiplexer_ = std::make_shared<UpstreamMultiplexer>(
+        envoy::extensions::filters::network::thrift_proxy::router::v3::Router::
+            UpstreamMultiplexing(),
+        stats_, context_.server_factory_context_.thread_local_);
+    route_ = new NiceMock<MockRoute>();
+    route_ptr_.reset(route_);
+    router_ = std::make_unique<Router>(context_.server_factory_context_.cluster_manager_, *stats_,
+                                       context_.server_factory_context_.runtime_loader_,
+                                       shadow_writer_, true, *upstream_multiplexer_);
+    router_->setDecoderFilterCallbacks(callbacks_);
+  }
+
   void initializeRouterWithShadowWriter() {
     stats_ = std::make_shared<const RouterStats>("test", context_.scope(),
                                                  context_.server_factory_context_.localInfo());
@@ -316,6 +332,33 @@ public:
     EXPECT_NE(nullptr, upstream_callbacks_);
   }
 
+  void connectMultiplexedUpstream() {
+    auto& tcp_conn_pool =
+        context_.server_factory_context_.cluster_manager_.thread_local_cluster_.tcp_conn_pool_;
+    EXPECT_CALL(*tcp_conn_pool.connection_data_, addUpstreamCallbacks(_))
+        .WillOnce(Invoke([&](Tcp::ConnectionPool::UpstreamCallbacks& cb) -> void {
+          upstream_callbacks_ = &cb;
+        }));
+    EXPECT_CALL(*protocol_, writeMessageBegin(_, _))
+        .WillOnce(Invoke([&](Buffer::Instance&, const MessageMetadata& metadata) -> void {
+          EXPECT_EQ(0, metadata.sequenceId());
+        }));
+    EXPECT_CALL(callbacks_, continueDecoding());
+
+    // The shared connection finds the sequence ids of responses with a transport and protocol of
+    // its own, which are set aside.
+    NiceMock<MockTransport>* transport = transport_;
+    NiceMock<MockProtocol>* protocol = protocol_;
+    tcp_conn_pool.poolReady(upstream_connection_);
+    multiplexed_transport_ = all_transports_.back();
+    multiplexed_protocol_ = all_protocols_.back();
+    all_transports_.pop_back();
+    all_protocols_.pop_back();
+    transport_ = transport;
+    protocol_ = protocol;
+    EXPECT_NE(nullptr, upstream_callbacks_);
+  }
+
   void startRequestWithExistingConnection(MessageType msg_type, int32_t sequence_id = 1) {
     EXPECT_EQ(FilterStatus::Continue, router_->transportBegin({}));
 
@@ -647,8 +690,9 @@ public:
   NiceMock<Event::MockDispatcher> dispatcher_;
   NiceMock<Server::Configuration::MockFactoryContext> context_;
 
-  std::unique_ptr<Router> router_;
   std::shared_ptr<const RouterStats> stats_;
+  UpstreamMultiplexerSharedPtr upstream_multiplexer_;
+  std::unique_ptr<Router> router_;
   MockShadowWriter shadow_writer_;
   std::shared_ptr<ShadowWriterImpl> shadow_writer_impl_;
 
@@ -657,6 +701,8 @@ public:
   NiceMock<ThriftFilters::MockDecoderFilterCallbacks> callbacks_;
   NiceMock<MockTransport>* transport_{};
   NiceMock<MockProtocol>* protocol_{};
+  NiceMock<MockTransport>* multiplexed_transport_{};
+  NiceMock<MockProtocol>* multiplexed_protocol_{};
   std::vector<NiceMock<MockTransport>*> all_transports_;
   std::vector<NiceMock<MockProtocol>*> all_protocols_;
   int32_t transports_requested_{};
@@ -1082,6 +1128,77 @@ TEST_F(ThriftRouterTest, TruncatedResponse) {
                 .value());
 }
 
+// A request sent over a shared connection fails if its response does not arrive in time, without
+// closing the connection.
+TEST_F(ThriftRouterTest, MultiplexedResponseTimeout) {
+  initializeMultiplexedRouter();
+  startRequest(MessageType::Call);
+  connectMultiplexedUpstream();
+  sendTrivialStruct(FieldType::String);
+  auto* timer =
+      new NiceMock<Event::MockTimer>(&context_.server_factory_context_.thread_local_.dispatcher_);
+  completeRequest();
+
+  EXPECT_CALL(callbacks_, sendLocalReply(_, true))
+      .WillOnce(Invoke([&](const DirectResponse& response, bool) -> void {
+        auto& app_ex = dynamic_cast<const AppException&>(response);
+        EXPECT_EQ(AppExceptionType::InternalError, app_ex.type_);
+        EXPECT_THAT(app_ex.what(),
+                    ContainsRegex(".*connection failure before response start: timeout.*"));
+      }));
+  EXPECT_CALL(context_.server_factory_context_.cluster_manager_.thread_local_cluster_.tcp_conn_pool_
+                  .host_->outlier_detector_,
+              putResult(Upstream::Outlier::Result::LocalOriginTimeout, _));
+  EXPECT_CALL(upstream_connection_, close(_)).Times(0);
+  EXPECT_CALL(
+      context_.server_factory_context_.cluster_manager_.thread_local_cluster_.tcp_conn_pool_,
+      released(Ref(upstream_connection_)));
+  timer->invokeCallback();
+  destroyRouter();
+
+  EXPECT_EQ(1UL,
+            context_.server_factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_
+                ->statsScope()
+                .counterFromString("thrift.upstream_resp_exception_local.timeout")
+                .value());
+  EXPECT_EQ(1UL,
+            context_.scope().counterFromString("test.upstream_rq_multiplexed_timeout").value());
+}
+
+// A response frame on a shared connection is delivered in full, so a response that needs more data
+// is truncated.
+TEST_F(ThriftRouterTest, MultiplexedTruncatedResponse) {
+  initializeMultiplexedRouter();
+  startRequest(MessageType::Call);
+  connectMultiplexedUpstream();
+  sendTrivialStruct(FieldType::String);
+  completeRequest();
+
+  EXPECT_CALL(*multiplexed_transport_, decodeFrameStart(_, _)).WillOnce(Return(true));
+  EXPECT_CALL(*multiplexed_protocol_, readMessageBegin(_, _))
+      .WillOnce(Invoke([](Buffer::Instance&, MessageMetadata& metadata) -> bool {
+        metadata.setSequenceId(0);
+        return true;
+      }));
+  EXPECT_CALL(callbacks_, startUpstreamResponse(_, _));
+  EXPECT_CALL(callbacks_, upstreamData(_))
+      .WillOnce(Return(ThriftFilters::ResponseStatus::MoreData));
+  EXPECT_CALL(
+      context_.server_factory_context_.cluster_manager_.thread_local_cluster_.tcp_conn_pool_,
+      released(Ref(upstream_connection_)));
+  EXPECT_CALL(callbacks_, resetDownstreamConnection());
+
+  Buffer::OwnedImpl buffer(std::string("\x00\x00\x00\x02\x01\x02", 6));
+  upstream_callbacks_->onUpstreamData(buffer, false);
+  destroyRouter();
+
+  EXPECT_EQ(1UL,
+            context_.server_factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_
+                ->statsScope()
+                .counterFromString("thrift.downstream_cx_underflow_response_close")
+                .value());
+}
+
 TEST_F(ThriftRouterTest, UpstreamLocalCloseMidResponse) {
   initializeRouter();
   startRequest(MessageType::Call);
@@ -0,0 +1,542 @@
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/network/thrift_proxy/router/v3/router.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/binary_protocol_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/framed_transport_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/header_transport_impl.h"
+#include "source/extensions/filters/network/thrift_proxy/router/upstream_multiplexer.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/tcp/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Ref;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+namespace {
+
+class MockMultiplexedStreamCallbacks : public MultiplexedStreamCallbacks {
+public:
+  // MultiplexedStreamCallbacks
+  MOCK_METHOD(void, onStreamFailure,
+              (ConnectionPool::PoolFailureReason reason, absl::string_view transport_failure_reason,
+               Upstream::HostDescriptionConstSharedPtr host));
+  void onStreamReady(MultiplexedStreamPtr&& stream,
+                     Upstream::HostDescriptionConstSharedPtr) override {
+    stream_ = std::move(stream);
+    stream_->addUpstreamCallbacks(upstream_callbacks_);
+  }
+  MOCK_METHOD(void, onStreamTimeout, ());
+
+  MultiplexedStreamPtr stream_;
+  NiceMock<Tcp::ConnectionPool::MockUpstreamCallbacks> upstream_callbacks_;
+};
+
+class MultiplexedConnPoolTest : public testing::Test {
+public:
+  MultiplexedConnPoolTest()
+      : stats_(std::make_shared<const RouterStats>("test", context_.scope(),
+                                                   context_.server_factory_context_.localInfo())) {
+  }
+
+  void initialize(uint32_t max_requests_per_connection = 2) {
+    conn_pool_ = std::make_unique<MultiplexedConnPool>(stats_, max_requests_per_connection,
+                                                       ResponseTimeout, dispatcher_);
+  }
+
+  Tcp::ConnectionPool::Cancellable* newStream(MockMultiplexedStreamCallbacks& callbacks,
+                                              TransportType transport = TransportType::Framed) {
+    return conn_pool_->newStream(pool_data_, transport, ProtocolType::Binary, callbacks);
+  }
+
+  // Completes the oldest connection attempt of the TCP connection pool.
+  void connectionReady(Network::MockClientConnection& connection) {
+    EXPECT_CALL(*tcp_conn_pool_.connection_data_, addUpstreamCallbacks(_))
+        .WillOnce(Invoke([&](Tcp::ConnectionPool::UpstreamCallbacks& callbacks) {
+          upstream_callbacks_ = &callbacks;
+        }));
+    tcp_conn_pool_.poolReady(connection);
+  }
+
+  // Sends a request over the stream of the given callbacks.
+  void sendRequest(MockMultiplexedStreamCallbacks& callbacks, bool expect_response = true) {
+    Buffer::OwnedImpl request("request");
+    callbacks.stream_->write(request, expect_response);
+  }
+
+  static std::string responseFrame(int32_t sequence_id,
+                                   TransportType transport = TransportType::Framed) {
+    MessageMetadata metadata;
+    metadata.setMethodName("method");
+    metadata.setMessageType(MessageType::Reply);
+    metadata.setSequenceId(sequence_id);
+    metadata.setProtocol(ProtocolType::Binary);
+
+    BinaryProtocolImpl protocol;
+    Buffer::OwnedImpl message;
+    protocol.writeMessageBegin(message, metadata);
+    protocol.writeStructBegin(message, "");
+    protocol.writeFieldBegin(message, "", FieldType::Stop, 0);
+    protocol.writeStructEnd(message);
+    protocol.writeMessageEnd(message);
+
+    Buffer::OwnedImpl frame;
+    if (transport == TransportType::Header) {
+      HeaderTransportImpl().encodeFrame(frame, metadata, message);
+    } else {
+      FramedTransportImpl().encodeFrame(frame, metadata, message);
+    }
+    return frame.toString();
+  }
+
+  void deliver(const std::string& data) {
+    Buffer::OwnedImpl buffer(data);
+    upstream_callbacks_->onUpstreamData(buffer, false);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return context_.scope().counterFromString("test." + name).value();
+  }
+
+  uint64_t gauge(const std::string& name) {
+    return context_.scope()
+        .gaugeFromString("test." + name, Stats::Gauge::ImportMode::Accumulate)
+        .value();
+  }
+
+  static constexpr std::chrono::milliseconds ResponseTimeout{1000};
+
+  NiceMock<Server::Configuration::MockFactoryContext> context_;
+  std::shared_ptr<const RouterStats> stats_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Tcp::ConnectionPool::MockInstance> tcp_conn_pool_;
+  Upstream::TcpPoolData pool_data_{[]() {}, &tcp_conn_pool_};
+  std::unique_ptr<MultiplexedConnPool> conn_pool_;
+  Tcp::ConnectionPool::UpstreamCallbacks* upstream_callbacks_{};
+};
+
+TEST(MultiplexedConnPoolSupportedTest, Supported) {
+  EXPECT_TRUE(MultiplexedConnPool::supported(TransportType::Framed, ProtocolType::Binary));
+  EXPECT_TRUE(MultiplexedConnPool::supported(TransportType::Header, ProtocolType::Compact));
+  EXPECT_FALSE(MultiplexedConnPool::supported(TransportType::Unframed, ProtocolType::Binary));
+  EXPECT_FALSE(MultiplexedConnPool::supported(TransportType::Framed, ProtocolType::Twitter));
+}
+
+// Requests waiting for a connection share it once it is established, up to the limit.
+TEST_F(MultiplexedConnPoolTest, SharesConnection) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks1, callbacks2, callbacks3;
+
+  EXPECT_CALL(tcp_conn_pool_, newConnection(_));
+  EXPECT_NE(nullptr, newStream(callbacks1));
+  EXPECT_NE(nullptr, newStream(callbacks2));
+  connectionReady(connection);
+  ASSERT_NE(nullptr, callbacks1.stream_);
+  ASSERT_NE(nullptr, callbacks2.stream_);
+  EXPECT_EQ(0, callbacks1.stream_->sequenceId());
+  EXPECT_EQ(1, callbacks2.stream_->sequenceId());
+
+  // The connection is at the limit, so another one is opened.
+  EXPECT_CALL(tcp_conn_pool_, newConnection(_));
+  EXPECT_NE(nullptr, newStream(callbacks3));
+  EXPECT_EQ(nullptr, callbacks3.stream_);
+
+  EXPECT_EQ(2, counter("upstream_rq_multiplexed"));
+  EXPECT_EQ(2, gauge("upstream_rq_multiplexed_active"));
+  EXPECT_EQ(1, gauge("upstream_cx_multiplexed_active"));
+
+  // Once a request completes, the next one uses its share of the connection.
+  MockMultiplexedStreamCallbacks callbacks4;
+  callbacks1.stream_.reset();
+  EXPECT_EQ(nullptr, newStream(callbacks4));
+  ASSERT_NE(nullptr, callbacks4.stream_);
+  EXPECT_EQ(2, callbacks4.stream_->sequenceId());
+
+  EXPECT_CALL(callbacks3, onStreamFailure(ConnectionPool::PoolFailureReason::Overflow, _, _));
+  tcp_conn_pool_.poolFailure(ConnectionPool::PoolFailureReason::Overflow);
+
+  EXPECT_CALL(tcp_conn_pool_, released(Ref(connection)));
+  callbacks2.stream_.reset();
+  callbacks4.stream_.reset();
+  EXPECT_EQ(0, gauge("upstream_rq_multiplexed_active"));
+  EXPECT_EQ(0, gauge("upstream_cx_multiplexed_active"));
+}
+
+// Responses are routed to their requests by sequence id, in whatever order they arrive and however
+// they are split.
+TEST_F(MultiplexedConnPoolTest, RoutesResponsesBySequenceId) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks1, callbacks2;
+
+  newStream(callbacks1);
+  newStream(callbacks2);
+  connectionReady(connection);
+  EXPECT_CALL(connection, write(_, false)).Times(2);
+  sendRequest(callbacks1);
+  sendRequest(callbacks2);
+
+  const std::string response1 = responseFrame(0);
+  const std::string response2 = responseFrame(1);
+  EXPECT_CALL(callbacks2.upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) {
+        EXPECT_EQ(response2, data.toString());
+        callbacks2.stream_.reset();
+      }));
+  EXPECT_CALL(callbacks1.upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) {
+        EXPECT_EQ(response1, data.toString());
+        callbacks1.stream_.reset();
+      }));
+  EXPECT_CALL(tcp_conn_pool_, released(Ref(connection)));
+
+  const std::string responses = response2 + response1;
+  deliver(responses.substr(0, 3));
+  deliver(responses.substr(3, response2.size()));
+  deliver(responses.substr(3 + response2.size()));
+  EXPECT_EQ(0, counter("upstream_resp_multiplexed_unmatched"));
+}
+
+// The sequence id is also found in header transport frames.
+TEST_F(MultiplexedConnPoolTest, HeaderTransport) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks;
+
+  newStream(callbacks, TransportType::Header);
+  connectionReady(connection);
+  sendRequest(callbacks);
+
+  const std::string response = responseFrame(0, TransportType::Header);
+  EXPECT_CALL(callbacks.upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) {
+        EXPECT_EQ(response, data.toString());
+        callbacks.stream_.reset();
+      }));
+  deliver(response);
+}
+
+// The connection is kept until the response to a request that was given up arrives, and the
+// response is discarded.
+TEST_F(MultiplexedConnPoolTest, DiscardsResponseOfAbandonedRequest) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks;
+
+  newStream(callbacks);
+  connectionReady(connection);
+  sendRequest(callbacks);
+  Tcp::ConnectionPool::MockUpstreamCallbacks& upstream_callbacks = callbacks.upstream_callbacks_;
+
+  EXPECT_CALL(tcp_conn_pool_, released(_)).Times(0);
+  callbacks.stream_.reset();
+  EXPECT_EQ(1, gauge("upstream_rq_multiplexed_active"));
+
+  // Its sequence id is not reused in the meantime.
+  MockMultiplexedStreamCallbacks callbacks2;
+  EXPECT_EQ(nullptr, newStream(callbacks2));
+  EXPECT_EQ(1, callbacks2.stream_->sequenceId());
+  callbacks2.stream_.reset();
+
+  EXPECT_CALL(upstream_callbacks, onUpstreamData(_, _)).Times(0);
+  EXPECT_CALL(tcp_conn_pool_, released(Ref(connection)));
+  deliver(responseFrame(0));
+  EXPECT_EQ(0, gauge("upstream_rq_multiplexed_active"));
+  EXPECT_EQ(0, counter("upstream_resp_multiplexed_unmatched"));
+}
+
+// Oneway requests do not keep the connection once they are sent.
+TEST_F(MultiplexedConnPoolTest, OnewayRequest) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks;
+
+  newStream(callbacks);
+  connectionReady(connection);
+  sendRequest(callbacks, false);
+
+  EXPECT_CALL(tcp_conn_pool_, released(Ref(connection)));
+  callbacks.stream_.reset();
+}
+
+TEST_F(MultiplexedConnPoolTest, UnmatchedResponse) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks;
+
+  newStream(callbacks);
+  connectionReady(connection);
+  sendRequest(callbacks);
+
+  EXPECT_CALL(callbacks.upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  deliver(responseFrame(7));
+  EXPECT_EQ(1, counter("upstream_resp_multiplexed_unmatched"));
+
+  EXPECT_CALL(tcp_conn_pool_, released(Ref(connection)));
+  EXPECT_CALL(callbacks.upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance&, bool) { callbacks.stream_.reset(); }));
+  deliver(responseFrame(0));
+}
+
+// A request whose response does not arrive in time fails, and gives up its sequence id without
+// closing the connection.
+TEST_F(MultiplexedConnPoolTest, ResponseTimeout) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks1, callbacks2;
+
+  newStream(callbacks1);
+  newStream(callbacks2);
+  connectionReady(connection);
+  auto* timer1 = new NiceMock<Event::MockTimer>(&dispatcher_);
+  sendRequest(callbacks1);
+  EXPECT_TRUE(timer1->enabled_);
+  auto* timer2 = new NiceMock<Event::MockTimer>(&dispatcher_);
+  bool timer2_destroyed = false;
+  timer2->timer_destroyed_ = &timer2_destroyed;
+  sendRequest(callbacks2);
+
+  EXPECT_CALL(connection, close(_)).Times(0);
+  EXPECT_CALL(callbacks1, onStreamTimeout());
+  timer1->invokeCallback();
+  EXPECT_EQ(1, counter("upstream_rq_multiplexed_timeout"));
+  EXPECT_EQ(1, gauge("upstream_rq_multiplexed_active"));
+
+  // The stream no longer refers to the connection.
+  Buffer::OwnedImpl request("request");
+  EXPECT_CALL(connection, write(_, _)).Times(0);
+  callbacks1.stream_->write(request, true);
+  callbacks1.stream_.reset();
+
+  // A late response is discarded.
+  EXPECT_CALL(callbacks1.upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  deliver(responseFrame(0));
+  EXPECT_EQ(1, counter("upstream_resp_multiplexed_unmatched"));
+
+  // The timer of a request is destroyed once its response arrives.
+  EXPECT_CALL(tcp_conn_pool_, released(Ref(connection)));
+  EXPECT_CALL(callbacks2.upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance&, bool) { callbacks2.stream_.reset(); }));
+  deliver(responseFrame(1));
+  EXPECT_TRUE(timer2_destroyed);
+}
+
+// The response of a request that was given up also times out, which hands the connection back.
+TEST_F(MultiplexedConnPoolTest, ResponseTimeoutOfAbandonedRequest) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks;
+
+  newStream(callbacks);
+  connectionReady(connection);
+  auto* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  sendRequest(callbacks);
+
+  EXPECT_CALL(tcp_conn_pool_, released(_)).Times(0);
+  callbacks.stream_.reset();
+
+  EXPECT_CALL(callbacks, onStreamTimeout()).Times(0);
+  EXPECT_CALL(tcp_conn_pool_, released(Ref(connection)));
+  timer->invokeCallback();
+  EXPECT_EQ(1, counter("upstream_rq_multiplexed_timeout"));
+  EXPECT_EQ(0, gauge("upstream_rq_multiplexed_active"));
+}
+
+// Requests outstanding on a connection see its close.
+TEST_F(MultiplexedConnPoolTest, RemoteClose) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks1, callbacks2;
+
+  newStream(callbacks1);
+  newStream(callbacks2);
+  connectionReady(connection);
+  sendRequest(callbacks1);
+
+  // Owners may give up other requests while being notified, in which case those see no close.
+  uint32_t notified = 0;
+  auto on_close = [&](Network::ConnectionEvent) {
+    notified++;
+    callbacks1.stream_.reset();
+    callbacks2.stream_.reset();
+  };
+  EXPECT_CALL(callbacks1.upstream_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose))
+      .Times(testing::AtMost(1))
+      .WillRepeatedly(Invoke(on_close));
+  EXPECT_CALL(callbacks2.upstream_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose))
+      .Times(testing::AtMost(1))
+      .WillRepeatedly(Invoke(on_close));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_EQ(1, notified);
+  EXPECT_EQ(0, gauge("upstream_rq_multiplexed_active"));
+  EXPECT_EQ(0, gauge("upstream_cx_multiplexed_active"));
+
+  // The next request opens a new connection.
+  MockMultiplexedStreamCallbacks callbacks3;
+  EXPECT_CALL(tcp_conn_pool_, newConnection(_));
+  EXPECT_NE(nullptr, newStream(callbacks3));
+  EXPECT_CALL(callbacks3, onStreamFailure(_, _, _));
+  tcp_conn_pool_.poolFailure(ConnectionPool::PoolFailureReason::RemoteConnectionFailure);
+}
+
+// A response that cannot be routed closes the connection.
+TEST_F(MultiplexedConnPoolTest, InvalidResponse) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks;
+
+  newStream(callbacks);
+  connectionReady(connection);
+  sendRequest(callbacks);
+
+  EXPECT_CALL(connection, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(callbacks.upstream_callbacks_, onEvent(Network::ConnectionEvent::LocalClose));
+  deliver(std::string("\x00\x00\x00\x02\xff\xff", 6));
+
+  // The stream no longer refers to the connection.
+  Buffer::OwnedImpl request("request");
+  EXPECT_CALL(connection, write(_, _)).Times(0);
+  callbacks.stream_->write(request, true);
+  callbacks.stream_.reset();
+}
+
+TEST_F(MultiplexedConnPoolTest, InvalidFrameSize) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks;
+
+  newStream(callbacks);
+  connectionReady(connection);
+  sendRequest(callbacks);
+
+  EXPECT_CALL(connection, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(callbacks.upstream_callbacks_, onEvent(Network::ConnectionEvent::LocalClose));
+  deliver(std::string("\x00\x00\x00\x00", 4));
+}
+
+// A draining connection takes no new requests, and is closed once the outstanding ones complete.
+TEST_F(MultiplexedConnPoolTest, DrainConnection) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks1, callbacks2;
+
+  newStream(callbacks1);
+  connectionReady(connection);
+  callbacks1.stream_->drainConnection();
+
+  EXPECT_CALL(tcp_conn_pool_, newConnection(_));
+  EXPECT_NE(nullptr, newStream(callbacks2));
+
+  EXPECT_CALL(connection, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(tcp_conn_pool_, released(Ref(connection)));
+  callbacks1.stream_.reset();
+
+  EXPECT_CALL(callbacks2, onStreamFailure(_, _, _));
+  tcp_conn_pool_.poolFailure(ConnectionPool::PoolFailureReason::Timeout);
+}
+
+// The connection attempt is cancelled once no request waits for it.
+TEST_F(MultiplexedConnPoolTest, CancelWaiters) {
+  initialize();
+  MockMultiplexedStreamCallbacks callbacks1, callbacks2;
+
+  Tcp::ConnectionPool::Cancellable* handle1 = newStream(callbacks1);
+  Tcp::ConnectionPool::Cancellable* handle2 = newStream(callbacks2);
+  ASSERT_NE(nullptr, handle1);
+  ASSERT_NE(nullptr, handle2);
+
+  EXPECT_CALL(tcp_conn_pool_.handles_.front(), cancel(_)).Times(0);
+  handle1->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+  EXPECT_CALL(tcp_conn_pool_.handles_.front(),
+              cancel(Tcp::ConnectionPool::CancelPolicy::Default));
+  handle2->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+}
+
+// The TCP connection pool may have a connection ready right away.
+TEST_F(MultiplexedConnPoolTest, ConnectionReadyImmediately) {
+  initialize();
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks;
+
+  EXPECT_CALL(tcp_conn_pool_, newConnection(_))
+      .WillOnce(Invoke([&](Tcp::ConnectionPool::Callbacks& cb) {
+        tcp_conn_pool_.newConnectionImpl(cb);
+        connectionReady(connection);
+        return nullptr;
+      }));
+  EXPECT_EQ(nullptr, newStream(callbacks));
+  EXPECT_NE(nullptr, callbacks.stream_);
+
+  EXPECT_CALL(tcp_conn_pool_, released(Ref(connection)));
+  callbacks.stream_.reset();
+}
+
+// Destroying the pool fails the requests that are waiting for or outstanding on a connection.
+TEST_F(MultiplexedConnPoolTest, Destroy) {
+  initialize(1);
+  NiceMock<Network::MockClientConnection> connection;
+  MockMultiplexedStreamCallbacks callbacks1, callbacks2;
+
+  newStream(callbacks1);
+  connectionReady(connection);
+  sendRequest(callbacks1);
+  newStream(callbacks2);
+
+  EXPECT_CALL(tcp_conn_pool_.handles_.front(), cancel(_));
+  EXPECT_CALL(callbacks2,
+              onStreamFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure, _, _));
+  EXPECT_CALL(connection, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(callbacks1.upstream_callbacks_, onEvent(Network::ConnectionEvent::LocalClose));
+  conn_pool_.reset();
+  callbacks1.stream_.reset();
+}
+
+TEST(UpstreamMultiplexerTest, PerWorkerConnPool) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  NiceMock<ThreadLocal::MockInstance> tls;
+  auto stats = std::make_shared<const RouterStats>("test", context.scope(),
+                                                   context.server_factory_context_.localInfo());
+  envoy::extensions::filters::network::thrift_proxy::router::v3::Router::UpstreamMultiplexing
+      config;
+  config.mutable_max_concurrent_requests_per_connection()->set_value(1);
+  UpstreamMultiplexer multiplexer(config, stats, tls);
+
+  NiceMock<Tcp::ConnectionPool::MockInstance> tcp_conn_pool;
+  Upstream::TcpPoolData pool_data([]() {}, &tcp_conn_pool);
+  MockMultiplexedStreamCallbacks callbacks1, callbacks2;
+
+  // Each request waits for a connection of its own.
+  EXPECT_CALL(tcp_conn_pool, newConnection(_)).Times(2);
+  multiplexer.connPool().newStream(pool_data, TransportType::Framed, ProtocolType::Binary,
+                                   callbacks1);
+  multiplexer.connPool().newStream(pool_data, TransportType::Framed, ProtocolType::Binary,
+                                   callbacks2);
+
+  EXPECT_CALL(callbacks1, onStreamFailure(_, _, _));
+  EXPECT_CALL(callbacks2, onStreamFailure(_, _, _));
+  tcp_conn_pool.poolFailure(ConnectionPool::PoolFailureReason::Timeout);
+  tcp_conn_pool.poolFailure(ConnectionPool::PoolFailureReason::Timeout);
+}
+
+} // namespace
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
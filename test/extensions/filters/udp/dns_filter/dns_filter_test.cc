@@ -10,6 +10,7 @@
 #include "test/test_common/environment.h"
 #include "test/test_common/registry.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
 
 #include "dns_filter_test_utils.h"
 #include "gmock/gmock.h"
@@ -242,6 +243,31 @@ server_config:
     filename: {}
 )EOF";
 
+  static constexpr absl::string_view external_answer_cache_config = R"EOF(
+stat_prefix: "my_prefix"
+client_config:
+  resolver_timeout: 1s
+  typed_dns_resolver_config:
+    name: envoy.network.dns_resolver.cares
+    typed_config:
+      "@type": type.googleapis.com/envoy.extensions.network.dns_resolver.cares.v3.CaresDnsResolverConfig
+      resolvers:
+      - socket_address:
+          address: "1.1.1.1"
+          port_value: 53
+  max_pending_lookups: 256
+  max_cached_answers: {}
+server_config:
+  inline_dns_table:
+    external_retry_count: 0
+    virtual_domains:
+      - name: "www.foo1.com"
+        endpoint:
+          address_list:
+            address:
+            - "10.0.0.1"
+)EOF";
+
   static constexpr absl::string_view dns_resolver_options_config_not_set = R"EOF(
 stat_prefix: "my_prefix"
 client_config:
@@ -502,6 +528,39 @@ TEST_F(DnsFilterTest, MaxQueryAndResponseSizeTest) {
   response_ctx_ = ResponseValidator::createResponseContext(udp_response_, counters_);
   EXPECT_TRUE(response_ctx_->parse_status_);
 
+  EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, response_ctx_->getQueryResponseCode());
+  // The name of each answer record points to the query name, so all 8 answers fit in the
+  // response although the query itself is around 100 bytes.
+  EXPECT_EQ(8, response_ctx_->answers_.size());
+
+  // Validate stats
+  EXPECT_EQ(1, config_->stats().aaaa_record_queries_.value());
+  EXPECT_EQ(8, config_->stats().local_aaaa_record_answers_.value());
+  EXPECT_EQ(0, config_->stats().downstream_rx_invalid_queries_.value());
+  EXPECT_TRUE(config_->stats().downstream_rx_bytes_.used());
+  EXPECT_TRUE(config_->stats().downstream_tx_bytes_.used());
+}
+
+TEST_F(DnsFilterTest, MaxQueryAndResponseSizeWithoutSerializedAnswersTest) {
+  InSequence s;
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.dns_filter_serialized_answers", "false"}});
+
+  setup(forward_query_off_config);
+  std::string domain(
+      "www.supercalifragilisticexpialidocious.thisismydomainforafivehundredandtwelvebytetest.com");
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_AAAA, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+
+  sendQueryFromClient("10.0.0.1:1000", query);
+  EXPECT_LT(udp_response_.buffer_->length(), Utils::MAX_UDP_DNS_SIZE);
+
+  response_ctx_ = ResponseValidator::createResponseContext(udp_response_, counters_);
+  EXPECT_TRUE(response_ctx_->parse_status_);
+
   EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, response_ctx_->getQueryResponseCode());
   // There are 8 addresses, however, since the domain is part of the answer record, each
   // serialized answer is over 100 bytes in size, there is room for 3 before the next
@@ -565,6 +624,43 @@ TEST_F(DnsFilterTest, QueryNameOf255Octets) {
   response_ctx_ = ResponseValidator::createResponseContext(udp_response_, counters_);
   EXPECT_TRUE(response_ctx_->parse_status_);
 
+  // The query name of 255 octets appears in the response only once, since the name of the
+  // answer record points to it.
+  EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, response_ctx_->getQueryResponseCode());
+  EXPECT_EQ(1, response_ctx_->answers_.size());
+
+  // Validate stats
+  EXPECT_EQ(1, config_->stats().aaaa_record_queries_.value());
+
+  EXPECT_EQ(1, config_->stats().local_aaaa_record_answers_.value());
+  EXPECT_EQ(0, config_->stats().downstream_rx_invalid_queries_.value());
+  EXPECT_TRUE(config_->stats().downstream_rx_bytes_.used());
+  EXPECT_TRUE(config_->stats().downstream_tx_bytes_.used());
+}
+
+TEST_F(DnsFilterTest, QueryNameOf255OctetsWithoutSerializedAnswers) {
+  InSequence s;
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.dns_filter_serialized_answers", "false"}});
+
+  setup(forward_query_off_config);
+  std::string domain(
+      "www.supercalifragilisticexpialidocious.thisismydomainforafivehundredandtwelvebytetest."
+      "a01234567890123456789012345678901234567890123456789."
+      "b01234567890123456789012345678901234567890123456789."
+      "c01234567890123456789012345678901234567890123456789.d01234567.com");
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_AAAA, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+
+  sendQueryFromClient("10.0.0.1:1000", query);
+  EXPECT_LT(udp_response_.buffer_->length(), Utils::MAX_UDP_DNS_SIZE);
+
+  response_ctx_ = ResponseValidator::createResponseContext(udp_response_, counters_);
+  EXPECT_TRUE(response_ctx_->parse_status_);
+
   // The UDP filter limits response size to 512 bytes. Since the query is included in the
   // response, and the query name is 255 octets, the filter cannot return any answers,
   // since together with the answer name, they would exceed the 512 byte limit.
@@ -2602,6 +2698,222 @@ server_config:
   EXPECT_EQ(1, config_->stats().known_domain_queries_.value());
 }
 
+TEST_F(DnsFilterTest, SerializedAnswers) {
+  const std::string answer_ttl_config = R"EOF(
+stat_prefix: "my_prefix"
+server_config:
+  inline_dns_table:
+    external_retry_count: 0
+    virtual_domains:
+      - name: "www.foo1.com"
+        answer_ttl: 60s
+        endpoint:
+          address_list:
+            address:
+            - "10.0.0.1"
+            - "2001:8a:c1::2800:7"
+            - "10.0.0.2"
+)EOF";
+  setup(answer_ttl_config);
+
+  const std::string domain("www.foo1.com");
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+  sendQueryFromClient("10.0.0.1:1000", query);
+
+  // The response contains the query followed by the answers, whose names point to the query name
+  // in the question.
+  EXPECT_EQ(query.size() + 2 * 16, udp_response_.buffer_->length());
+  EXPECT_EQ(0xC00C, udp_response_.buffer_->peekBEInt<uint16_t>(query.size()));
+
+  response_ctx_ = ResponseValidator::createResponseContext(udp_response_, counters_);
+  EXPECT_TRUE(response_ctx_->parse_status_);
+  EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, response_ctx_->getQueryResponseCode());
+  EXPECT_EQ(2, response_ctx_->answers_.size());
+
+  const std::list<std::string> expected{"10.0.0.1", "10.0.0.2"};
+  for (const auto& answer : response_ctx_->answers_) {
+    EXPECT_EQ(answer.first, domain);
+    EXPECT_EQ(60, answer.second->ttl_.count());
+    Utils::verifyAddress(expected, answer.second);
+  }
+
+  const std::string aaaa_query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_AAAA, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(aaaa_query.empty());
+  sendQueryFromClient("10.0.0.1:1000", aaaa_query);
+
+  response_ctx_ = ResponseValidator::createResponseContext(udp_response_, counters_);
+  EXPECT_TRUE(response_ctx_->parse_status_);
+  EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, response_ctx_->getQueryResponseCode());
+  EXPECT_EQ(1, response_ctx_->answers_.size());
+  Utils::verifyAddress({"2001:8a:c1::2800:7"}, response_ctx_->answers_.find(domain)->second);
+
+  // Validate stats
+  EXPECT_EQ(2, config_->stats().downstream_rx_queries_.value());
+  EXPECT_EQ(2, config_->stats().known_domain_queries_.value());
+  EXPECT_EQ(2, config_->stats().local_a_record_answers_.value());
+  EXPECT_EQ(1, config_->stats().local_aaaa_record_answers_.value());
+  EXPECT_EQ(2, config_->stats().downstream_tx_responses_.value());
+}
+
+TEST_F(DnsFilterTest, ExternalAnswerCache) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  setup(fmt::format(external_answer_cache_config, 2));
+
+  const std::string expected_address("130.207.244.251");
+  const std::string domain("www.foobaz.com");
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  // The answer is cached for the TTL it is returned with, shorter than the TTL of the records.
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Completed, "",
+             TestUtility::makeDnsResponse({expected_address}, std::chrono::seconds(600)));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+
+  // The answer is returned from the cache, with the TTL counting down.
+  simTime().advanceTimeWait(std::chrono::seconds(100));
+  sendQueryFromClient("10.0.0.1:1000", query);
+
+  response_ctx_ = ResponseValidator::createResponseContext(udp_response_, counters_);
+  EXPECT_TRUE(response_ctx_->parse_status_);
+  EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, response_ctx_->getQueryResponseCode());
+  EXPECT_EQ(1, response_ctx_->answers_.size());
+  const DnsAnswerRecordPtr& answer = response_ctx_->answers_.find(domain)->second;
+  EXPECT_EQ(200, answer->ttl_.count());
+  Utils::verifyAddress({expected_address}, answer);
+
+  EXPECT_EQ(1, config_->stats().external_answer_cache_hits_.value());
+  EXPECT_EQ(1, config_->stats().external_answer_cache_misses_.value());
+  // The cached answers are counted as external answers.
+  EXPECT_EQ(2, config_->stats().externally_resolved_queries_.value());
+  EXPECT_EQ(2, config_->stats().external_a_record_queries_.value());
+  EXPECT_EQ(2, config_->stats().external_a_record_answers_.value());
+
+  // Once the answer expires, the name is resolved again.
+  simTime().advanceTimeWait(std::chrono::seconds(200));
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Completed, "",
+             TestUtility::makeDnsResponse({expected_address}, std::chrono::seconds(600)));
+
+  response_ctx_ = ResponseValidator::createResponseContext(udp_response_, counters_);
+  EXPECT_TRUE(response_ctx_->parse_status_);
+  EXPECT_EQ(300, response_ctx_->answers_.find(domain)->second->ttl_.count());
+
+  EXPECT_EQ(1, config_->stats().external_answer_cache_hits_.value());
+  EXPECT_EQ(2, config_->stats().external_answer_cache_misses_.value());
+  EXPECT_EQ(3, config_->stats().externally_resolved_queries_.value());
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+}
+
+TEST_F(DnsFilterTest, ExternalAnswerCacheRecordTtl) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  setup(fmt::format(external_answer_cache_config, 2));
+
+  const std::string domain("www.foobaz.com");
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  // The answer is cached until the first of its records expires upstream.
+  std::list<Network::DnsResponse> response =
+      TestUtility::makeDnsResponse({"130.207.244.251"}, std::chrono::seconds(60));
+  response.splice(response.end(),
+                  TestUtility::makeDnsResponse({"130.207.244.252"}, std::chrono::seconds(30)));
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Completed, "", std::move(response));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  response_ctx_ = ResponseValidator::createResponseContext(udp_response_, counters_);
+  EXPECT_TRUE(response_ctx_->parse_status_);
+  EXPECT_EQ(2, response_ctx_->answers_.size());
+  for (const auto& answer : response_ctx_->answers_) {
+    EXPECT_EQ(20, answer.second->ttl_.count());
+  }
+  EXPECT_EQ(1, config_->stats().external_answer_cache_hits_.value());
+
+  // Once the first record expires, the name is resolved again.
+  simTime().advanceTimeWait(std::chrono::seconds(20));
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Completed, "",
+             TestUtility::makeDnsResponse({"130.207.244.251"}, std::chrono::seconds(0)));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+
+  // Records which expire immediately are not cached.
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Completed, "",
+             TestUtility::makeDnsResponse({"130.207.244.251"}));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+
+  EXPECT_EQ(1, config_->stats().external_answer_cache_hits_.value());
+  EXPECT_EQ(3, config_->stats().external_answer_cache_misses_.value());
+}
+
+TEST_F(DnsFilterTest, ExternalAnswerCacheEviction) {
+  setup(fmt::format(external_answer_cache_config, 1));
+
+  // Resolve two names, the second of which evicts the first from the cache.
+  Network::DnsResolver::ResolveCb resolve_cb;
+  for (const char* domain : {"www.foobaz.com", "www.foobar.com", "www.foobaz.com"}) {
+    new NiceMock<Event::MockTimer>(&dispatcher_);
+    EXPECT_CALL(*resolver_, resolve(domain, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+    sendQueryFromClient("10.0.0.1:1000", Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A,
+                                                                    DNS_RECORD_CLASS_IN));
+    resolve_cb(Network::DnsResolver::ResolutionStatus::Completed, "",
+               TestUtility::makeDnsResponse({"130.207.244.251"}));
+    EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+  }
+
+  EXPECT_EQ(0, config_->stats().external_answer_cache_hits_.value());
+  EXPECT_EQ(3, config_->stats().external_answer_cache_misses_.value());
+  EXPECT_EQ(2, config_->stats().external_answer_cache_evictions_.value());
+}
+
+TEST_F(DnsFilterTest, ExternalAnswerCacheSkipsEmptyAnswers) {
+  setup(fmt::format(external_answer_cache_config, 2));
+
+  const std::string domain("www.foobaz.com");
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+
+  Network::DnsResolver::ResolveCb resolve_cb;
+  for (int i = 0; i < 2; i++) {
+    new NiceMock<Event::MockTimer>(&dispatcher_);
+    EXPECT_CALL(*resolver_, resolve(domain, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+    sendQueryFromClient("10.0.0.1:1000", query);
+    resolve_cb(Network::DnsResolver::ResolutionStatus::Completed, "",
+               TestUtility::makeDnsResponse({}));
+    EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+  }
+
+  EXPECT_EQ(0, config_->stats().external_answer_cache_hits_.value());
+  EXPECT_EQ(2, config_->stats().external_answer_cache_misses_.value());
+  EXPECT_EQ(2, config_->stats().unanswered_queries_.value());
+}
+
 // Test that the bootstrap typed_dns_resolver_config is used when client_config is not set.
 TEST_F(DnsFilterTest, BootstrapTypedDnsResolverTest) {
   // Create bootstrap config with typed DNS resolver configuration.
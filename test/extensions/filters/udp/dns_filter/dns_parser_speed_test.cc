@@ -0,0 +1,114 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/fmt.h"
+#include "source/common/common/random_generator.h"
+#include "source/common/network/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/udp/dns_filter/dns_parser.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+#include "dns_filter_test_utils.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+
+// Parses a query and builds the response to it, as the filter does for a query answered from the
+// configured addresses.
+class DnsParserSpeedTest {
+public:
+  DnsParserSpeedTest(uint64_t address_count)
+      : local_(Network::Utility::parseInternetAddressAndPortNoThrow("127.0.0.1:53")),
+        peer_(Network::Utility::parseInternetAddressAndPortNoThrow("127.0.0.1:5353")),
+        query_(Utils::buildQueryForDomain(std::string(Name), DNS_RECORD_TYPE_A,
+                                          DNS_RECORD_CLASS_IN)),
+        counters_(counter("underflow"), counter("record_name_overflow"),
+                  counter("query_parsing_failure"), counter("queries_with_additional_rrs"),
+                  counter("queries_with_ans_or_authority_rrs")),
+        parser_(false, time_system_, 0, random_,
+                store_.rootScope()->histogramFromString("latency",
+                                                        Stats::Histogram::Unit::Milliseconds)) {
+    for (uint64_t i = 0; i < address_count; i++) {
+      addresses_.push_back(
+          Network::Utility::parseInternetAddressNoThrow(fmt::format("10.0.0.{}", i + 1)));
+    }
+    serialized_answers_ =
+        std::make_unique<DnsSerializedAnswers>(DNS_RECORD_TYPE_A, Ttl, addresses_);
+  }
+
+  DnsQueryContextPtr parseQuery() {
+    Network::UdpRecvData data{};
+    data.addresses_.local_ = local_;
+    data.addresses_.peer_ = peer_;
+    data.buffer_ = std::make_unique<Buffer::OwnedImpl>(query_);
+    return parser_.createQueryContext(data, counters_);
+  }
+
+  void respondFromRecords() {
+    DnsQueryContextPtr context = parseQuery();
+    for (const auto& address : addresses_) {
+      parser_.storeDnsAnswerRecord(context, *context->queries_.front(), Ttl, address);
+    }
+    Buffer::OwnedImpl response;
+    parser_.buildResponseBuffer(context, response);
+    benchmark::DoNotOptimize(response.length());
+  }
+
+  void respondFromSerializedAnswers() {
+    DnsQueryContextPtr context = parseQuery();
+    context->serialized_answers_ = serialized_answers_.get();
+    Buffer::OwnedImpl response;
+    parser_.buildSerializedResponseBuffer(context, response);
+    benchmark::DoNotOptimize(response.length());
+  }
+
+private:
+  static constexpr absl::string_view Name = "www.service.example.com";
+  static constexpr std::chrono::seconds Ttl{300};
+
+  Stats::Counter& counter(absl::string_view name) {
+    return store_.rootScope()->counterFromString(std::string(name));
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  Event::SimulatedTimeSystem time_system_;
+  Random::RandomGeneratorImpl random_;
+  const Network::Address::InstanceConstSharedPtr local_;
+  const Network::Address::InstanceConstSharedPtr peer_;
+  const std::string query_;
+  DnsParserCounters counters_;
+  DnsMessageParser parser_;
+  AddressConstPtrVec addresses_;
+  std::unique_ptr<DnsSerializedAnswers> serialized_answers_;
+};
+
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
+
+// The argument is the number of addresses configured for the queried name.
+static void bmRespondFromRecords(benchmark::State& state) {
+  Envoy::Extensions::UdpFilters::DnsFilter::DnsParserSpeedTest test(state.range(0));
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    test.respondFromRecords();
+  }
+}
+BENCHMARK(bmRespondFromRecords)->Arg(1)->Arg(4)->Arg(8);
+
+static void bmRespondFromSerializedAnswers(benchmark::State& state) {
+  Envoy::Extensions::UdpFilters::DnsFilter::DnsParserSpeedTest test(state.range(0));
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    test.respondFromSerializedAnswers();
+  }
+}
+BENCHMARK(bmRespondFromSerializedAnswers)->Arg(1)->Arg(4)->Arg(8);
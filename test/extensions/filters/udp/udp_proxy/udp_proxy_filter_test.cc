@@ -1297,6 +1297,208 @@ tunneling_config:
       "Only one of use_per_packet_load_balancing or tunneling_config can be used.");
 }
 
+TEST_F(UdpProxyFilterTest, MutualExcludeSharedUpstreamSocketsAndUseOriginalSrcIp) {
+  auto config = R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+use_original_src_ip: true
+shared_upstream_sockets: {}
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(
+      setup(readConfig(config)), EnvoyException,
+      "Only one of shared_upstream_sockets or use_original_src_ip can be used.");
+}
+
+TEST_F(UdpProxyFilterTest, MutualExcludeSharedUpstreamSocketsAndTunneling) {
+  auto config = R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+shared_upstream_sockets: {}
+tunneling_config:
+  proxy_host: host.com
+  target_host: host.com
+  default_target_port: 30
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(setup(readConfig(config)), EnvoyException,
+                            "Only one of shared_upstream_sockets or tunneling_config can be used.");
+}
+
+// Sessions to the same upstream host use different shared sockets, and a datagram is written at
+// the end of the event loop iteration when the batch is not full.
+TEST_F(UdpProxyFilterTest, SharedUpstreamSocketsOnePerHost) {
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+shared_upstream_sockets: {}
+  )EOF"));
+
+  // Allow for two sessions.
+  factory_context_.server_factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_
+      ->resetResourceManager(2, 0, 0, 0, 0);
+
+  expectSessionCreate(upstream_address_);
+  auto* flush_callback = new NiceMock<Event::MockSchedulableCallback>(
+      &callbacks_.udp_listener_.dispatcher_);
+  test_sessions_[0].expectWriteToUpstream("hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_TRUE(flush_callback->enabled_);
+  EXPECT_EQ(0, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_datagrams")
+                   ->value());
+  flush_callback->invokeCallback();
+  EXPECT_EQ(1, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_datagrams")
+                   ->value());
+
+  expectSessionCreate(upstream_address_);
+  flush_callback = new NiceMock<Event::MockSchedulableCallback>(
+      &callbacks_.udp_listener_.dispatcher_);
+  test_sessions_[1].expectWriteToUpstream("hello2");
+  recvDataFromDownstream("10.0.0.3:1000", "10.0.0.2:80", "hello2");
+  flush_callback->invokeCallback();
+  EXPECT_EQ(2, config_->stats().upstream_sockets_active_.value());
+  EXPECT_EQ(2, config_->stats().upstream_socket_flows_active_.value());
+
+  // The socket of a session is closed with it.
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, resetFileEvents());
+  test_sessions_[0].idle_timer_->invokeCallback();
+  EXPECT_EQ(1, config_->stats().upstream_sockets_active_.value());
+  EXPECT_EQ(1, config_->stats().upstream_socket_flows_active_.value());
+
+  EXPECT_CALL(*test_sessions_[1].socket_->io_handle_, resetFileEvents());
+  filter_.reset();
+  EXPECT_EQ(0, config_->stats().upstream_sockets_active_.value());
+  EXPECT_EQ(0, config_->stats().upstream_socket_flows_active_.value());
+}
+
+// Sessions to different upstream hosts share a socket, their datagrams are written together with
+// sendmmsg(), and datagrams received on the socket are returned to the session of their host.
+TEST_F(UdpProxyFilterTest, SharedUpstreamSocketsBatchWrites) {
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+shared_upstream_sockets:
+  max_batch_size: 2
+  )EOF"));
+
+  // Allow for two sessions.
+  factory_context_.server_factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_
+      ->resetResourceManager(2, 0, 0, 0, 0);
+
+  expectSessionCreate(upstream_address_);
+  Network::MockIoHandle& io_handle = *test_sessions_[0].socket_->io_handle_;
+  auto* flush_callback = new NiceMock<Event::MockSchedulableCallback>(
+      &callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, nullptr)).Times(AtLeast(1));
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_TRUE(flush_callback->enabled_);
+
+  auto new_host_address = Network::Utility::parseInternetAddressAndPortNoThrow("20.0.0.2:443");
+  auto new_host = createHost(new_host_address);
+  EXPECT_CALL(factory_context_.server_factory_context_.cluster_manager_.thread_local_cluster_.lb_,
+              chooseHost(_))
+      .WillOnce(Return(ByMove(Upstream::HostSelectionResponse{new_host})));
+  auto* idle_timer = new NiceMock<Event::MockTimer>(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*idle_timer, enableTimer(_, nullptr)).Times(AtLeast(1));
+  EXPECT_CALL(os_sys_calls_, supportsMmsg()).WillOnce(Return(true));
+  // The first datagram is written, and the socket buffer is full for the second.
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 2, 0))
+      .WillOnce(Invoke([&](os_fd_t, struct mmsghdr* msgvec, unsigned int,
+                           int) -> Api::SysCallIntResult {
+        EXPECT_EQ("hello",
+                  absl::string_view(static_cast<const char*>(msgvec[0].msg_hdr.msg_iov->iov_base),
+                                    msgvec[0].msg_hdr.msg_iov->iov_len));
+        EXPECT_EQ(0, memcmp(msgvec[0].msg_hdr.msg_name, upstream_address_->sockAddr(),
+                            upstream_address_->sockAddrLen()));
+        EXPECT_EQ(0, memcmp(msgvec[1].msg_hdr.msg_name, new_host_address->sockAddr(),
+                            new_host_address->sockAddrLen()));
+        return {1, 0};
+      }));
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 1, 0))
+      .WillOnce(Return(Api::SysCallIntResult{-1, SOCKET_ERROR_AGAIN}));
+  EXPECT_CALL(io_handle, localAddress())
+      .WillRepeatedly(
+          Return(Network::Utility::parseInternetAddressAndPortNoThrow("127.0.0.1:12345")));
+  recvDataFromDownstream("10.0.0.3:1000", "10.0.0.2:80", "world");
+  // The full batch was written without waiting for the end of the event loop iteration.
+  EXPECT_FALSE(flush_callback->enabled_);
+
+  EXPECT_EQ(1, config_->stats().upstream_sockets_active_.value());
+  EXPECT_EQ(2, config_->stats().upstream_socket_flows_active_.value());
+  EXPECT_EQ(1, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_datagrams")
+                   ->value());
+  EXPECT_EQ(1, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_errors")
+                   ->value());
+  EXPECT_EQ(5, factory_context_.server_factory_context_.cluster_manager_.thread_local_cluster_
+                   .cluster_.info_->traffic_stats_->upstream_cx_tx_bytes_total_.value());
+
+  const auto recv = [](const std::string& data,
+                       const Network::Address::InstanceConstSharedPtr& peer_address) {
+    return [data, peer_address](Buffer::RawSlice* slices, const uint64_t, uint32_t,
+                                const Network::IoHandle::UdpSaveCmsgConfig&,
+                                Network::IoHandle::RecvMsgOutput& output) {
+      memcpy(slices[0].mem_, data.data(), data.size());
+      output.msg_[0].peer_address_ = peer_address;
+      return makeNoError(data.size());
+    };
+  };
+  EXPECT_CALL(io_handle, supportsUdpGro());
+  EXPECT_CALL(io_handle, supportsMmsg());
+  EXPECT_CALL(io_handle, recvmsg(_, 1, _, _, _))
+      .WillOnce(Invoke(recv("back", new_host_address)))
+      .WillOnce(Invoke(recv("stray", Network::Utility::parseInternetAddressAndPortNoThrow(
+                                         "20.0.0.3:443"))))
+      .WillOnce(Return(ByMove(
+          Api::IoCallUint64Result(0, Network::IoSocketError::getIoSocketEagainError()))));
+  EXPECT_CALL(callbacks_.udp_listener_, send(_))
+      .WillOnce(Invoke([](const Network::UdpSendData& send_data) -> Api::IoCallUint64Result {
+        EXPECT_EQ("back", send_data.buffer_.toString());
+        EXPECT_EQ("10.0.0.3:1000", send_data.peer_address_.asString());
+        send_data.buffer_.drain(send_data.buffer_.length());
+        return makeNoError(4);
+      }));
+  EXPECT_OK(test_sessions_[0].file_event_cb_(Event::FileReadyType::Read));
+  EXPECT_EQ(1, config_->stats().upstream_socket_rx_no_flow_.value());
+  checkTransferStats(10 /*rx_bytes*/, 2 /*rx_datagrams*/, 4 /*tx_bytes*/, 1 /*tx_datagrams*/);
+
+  EXPECT_CALL(io_handle, resetFileEvents());
+  filter_.reset();
+  EXPECT_EQ(0, config_->stats().upstream_sockets_active_.value());
+  EXPECT_EQ(0, config_->stats().upstream_socket_flows_active_.value());
+}
+
 // Verify that on second data packet sent from the client, another upstream host is selected.
 TEST_F(UdpProxyFilterTest, PerPacketLoadBalancingBasicFlow) {
   InSequence s;
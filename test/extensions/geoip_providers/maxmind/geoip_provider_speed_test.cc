@@ -0,0 +1,99 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares the lookups of the City test database with and without the per-worker lookup cache. The
+// looked up addresses are drawn from range(0) distinct addresses with a Zipf-like distribution, as
+// the client addresses of a proxy usually are.
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/geoip_providers/maxmind/v3/maxmind.pb.h"
+
+#include "source/common/network/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/geoip_providers/maxmind/geoip_provider.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/filesystem/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace GeoipProviders {
+namespace Maxmind {
+namespace {
+
+constexpr size_t NumLookups = 1 << 16;
+
+std::vector<Network::Address::InstanceConstSharedPtr> zipfAddresses(int64_t num_addresses) {
+  std::mt19937 random(42);
+  std::vector<Network::Address::InstanceConstSharedPtr> addresses;
+  std::vector<double> weights;
+  for (int64_t i = 0; i < num_addresses; i++) {
+    const uint32_t bits = random();
+    addresses.push_back(Network::Utility::parseInternetAddressNoThrow(
+        absl::StrCat(bits >> 24, ".", (bits >> 16) & 0xff, ".", (bits >> 8) & 0xff, ".",
+                     bits & 0xff)));
+    weights.push_back(1.0 / (i + 1));
+  }
+  std::discrete_distribution<size_t> rank(weights.begin(), weights.end());
+  std::vector<Network::Address::InstanceConstSharedPtr> lookups;
+  lookups.reserve(NumLookups);
+  for (size_t i = 0; i < NumLookups; i++) {
+    lookups.push_back(addresses[rank(random)]);
+  }
+  return lookups;
+}
+
+void bmLookup(benchmark::State& state, bool cache) {
+  envoy::extensions::geoip_providers::maxmind::v3::MaxMindConfig config;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(R"EOF(
+    common_provider_config:
+      geo_field_keys:
+        country: "x-geo-country"
+        region: "x-geo-region"
+        city: "x-geo-city"
+    city_db_path: "{{ test_rundir }}/test/extensions/geoip_providers/maxmind/test_data/GeoLite2-City-Test.mmdb"
+  )EOF"),
+                            config);
+  if (cache) {
+    config.mutable_lookup_cache_size()->set_value(10000);
+  }
+  Stats::IsolatedStoreImpl stats_store;
+  Api::ApiPtr api = Api::createApiForTest(stats_store);
+  testing::NiceMock<Event::MockDispatcher> dispatcher;
+  ON_CALL(dispatcher, createFilesystemWatcher_()).WillByDefault(testing::Invoke([] {
+    return new testing::NiceMock<Filesystem::MockWatcher>();
+  }));
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  GeoipProvider provider(
+      dispatcher, *api, tls, nullptr,
+      std::make_shared<GeoipProviderConfig>(config, "prefix.", *stats_store.rootScope()));
+
+  const auto lookups = zipfAddresses(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) { // NOLINT
+    Network::Address::InstanceConstSharedPtr address = lookups[i++ % NumLookups];
+    provider.lookup(Geolocation::LookupRequest{std::move(address)},
+                    [](Geolocation::LookupResult&& result) { benchmark::DoNotOptimize(result); });
+  }
+}
+
+void bmLookupWithoutCache(benchmark::State& state) { bmLookup(state, false); }
+BENCHMARK(bmLookupWithoutCache)->Arg(1000)->Arg(100000);
+
+void bmLookupWithCache(benchmark::State& state) { bmLookup(state, true); }
+BENCHMARK(bmLookupWithCache)->Arg(1000)->Arg(100000);
+
+} // namespace
+} // namespace Maxmind
+} // namespace GeoipProviders
+} // namespace Extensions
+} // namespace Envoy
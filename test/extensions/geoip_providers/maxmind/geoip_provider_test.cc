@@ -764,6 +764,112 @@ TEST_F(GeoipProviderTest, DbEpochGaugeUpdatesWhenReloadedOnMmdbFileUpdate) {
   TestEnvironment::renameFile(city_db_path + "1", city_db_path);
 }
 
+TEST_F(GeoipProviderTest, LookupCacheHitWithinDbNetwork) {
+  const std::string config_yaml = R"EOF(
+    common_provider_config:
+      geo_field_keys:
+        country: "x-geo-country"
+        region: "x-geo-region"
+        city: "x-geo-city"
+    city_db_path: "{{ test_rundir }}/test/extensions/geoip_providers/maxmind/test_data/GeoLite2-City-Test.mmdb"
+    lookup_cache_size: 100
+  )EOF";
+  initializeProvider(config_yaml, cb_added_nullopt);
+  testing::MockFunction<void(Geolocation::LookupResult&&)> lookup_cb;
+  EXPECT_CALL(lookup_cb, Call(_)).WillRepeatedly(SaveArg<0>(&captured_lookup_response_));
+  auto lookup = [&](const std::string& address) {
+    captured_lookup_response_.clear();
+    provider_->lookup(
+        Geolocation::LookupRequest{Network::Utility::parseInternetAddressNoThrow(address)},
+        lookup_cb.AsStdFunction());
+  };
+
+  lookup("81.2.69.144");
+  EXPECT_EQ(3, captured_lookup_response_.size());
+  EXPECT_EQ("London", captured_lookup_response_["x-geo-city"]);
+  // Another address of the network of the database record is served from the cache.
+  lookup("81.2.69.150");
+  EXPECT_EQ(3, captured_lookup_response_.size());
+  EXPECT_EQ("London", captured_lookup_response_["x-geo-city"]);
+  // The addresses of other networks are looked up in the database.
+  lookup("2.125.160.216");
+  EXPECT_EQ(3, captured_lookup_response_.size());
+  EXPECT_EQ("Boxford", captured_lookup_response_["x-geo-city"]);
+  // So are the addresses which are not in the database, once.
+  lookup("10.10.10.10");
+  lookup("10.10.10.10");
+  EXPECT_EQ(0, captured_lookup_response_.size());
+
+  expectStats("city_db", 3, 2, 1);
+  auto& provider_scope = GeoipProviderPeer::providerScope(provider_);
+  EXPECT_EQ(2, provider_scope.counterFromString("lookup_cache.hit").value());
+  EXPECT_EQ(3, provider_scope.counterFromString("lookup_cache.miss").value());
+}
+
+TEST_F(GeoipProviderTest, LookupCacheDisabledByDefault) {
+  initializeProvider(default_city_config_yaml, cb_added_nullopt);
+  testing::MockFunction<void(Geolocation::LookupResult&&)> lookup_cb;
+  EXPECT_CALL(lookup_cb, Call(_)).WillRepeatedly(SaveArg<0>(&captured_lookup_response_));
+  for (int i = 0; i < 2; i++) {
+    provider_->lookup(
+        Geolocation::LookupRequest{Network::Utility::parseInternetAddressNoThrow("81.2.69.144")},
+        lookup_cb.AsStdFunction());
+    EXPECT_EQ("London", captured_lookup_response_["x-geo-city"]);
+  }
+  expectStats("city_db", 2, 2);
+  auto& provider_scope = GeoipProviderPeer::providerScope(provider_);
+  EXPECT_EQ(0, provider_scope.counterFromString("lookup_cache.hit").value());
+  EXPECT_EQ(0, provider_scope.counterFromString("lookup_cache.miss").value());
+}
+
+TEST_F(GeoipProviderTest, LookupCacheClearedOnDbReload) {
+  constexpr absl::string_view config_yaml = R"EOF(
+    common_provider_config:
+      geo_field_keys:
+        city: "x-geo-city"
+    city_db_path: {}
+    lookup_cache_size: 100
+  )EOF";
+  std::string city_db_path = TestEnvironment::substitute(default_city_db_path);
+  std::string reloaded_city_db_path = TestEnvironment::substitute(default_updated_city_db_path);
+  auto cb_added_opt = std::make_optional<ConditionalInitializer>();
+  initializeProvider(fmt::format(config_yaml, city_db_path), cb_added_opt);
+  testing::MockFunction<void(Geolocation::LookupResult&&)> lookup_cb;
+  EXPECT_CALL(lookup_cb, Call(_)).WillRepeatedly(SaveArg<0>(&captured_lookup_response_));
+  auto lookup = [&]() {
+    captured_lookup_response_.clear();
+    provider_->lookup(
+        Geolocation::LookupRequest{Network::Utility::parseInternetAddressNoThrow("81.2.69.144")},
+        lookup_cb.AsStdFunction());
+  };
+
+  lookup();
+  lookup();
+  EXPECT_EQ("London", captured_lookup_response_["x-geo-city"]);
+  TestEnvironment::renameFile(city_db_path, city_db_path + "1");
+  TestEnvironment::renameFile(reloaded_city_db_path, city_db_path);
+  cb_added_opt.value().waitReady();
+  {
+    absl::ReaderMutexLock guard(mutex_);
+    EXPECT_OK(on_changed_cbs_[0](Filesystem::Watcher::Events::MovedTo));
+  }
+  expectReloadStats("city_db", 1, 0);
+  // The result cached from the previous database is not served anymore.
+  lookup();
+  EXPECT_EQ("BoxfordImaginary", captured_lookup_response_["x-geo-city"]);
+  lookup();
+  EXPECT_EQ("BoxfordImaginary", captured_lookup_response_["x-geo-city"]);
+
+  expectStats("city_db", 2, 2);
+  auto& provider_scope = GeoipProviderPeer::providerScope(provider_);
+  EXPECT_EQ(2, provider_scope.counterFromString("lookup_cache.hit").value());
+  EXPECT_EQ(2, provider_scope.counterFromString("lookup_cache.miss").value());
+
+  // Clean up modifications to mmdb file names.
+  TestEnvironment::renameFile(city_db_path, reloaded_city_db_path);
+  TestEnvironment::renameFile(city_db_path + "1", city_db_path);
+}
+
 // Country DB specific tests.
 TEST_F(GeoipProviderTest, ValidConfigCountryDbSuccessfulLookup) {
   const std::string config_yaml = R"EOF(
@@ -0,0 +1,94 @@
+#include <string>
+
+#include "source/common/network/utility.h"
+#include "source/extensions/geoip_providers/maxmind/lookup_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace GeoipProviders {
+namespace Maxmind {
+namespace {
+
+const Network::Address::Ip& ip(const std::string& address) {
+  static absl::flat_hash_map<std::string, Network::Address::InstanceConstSharedPtr> addresses;
+  auto& instance = addresses[address];
+  if (instance == nullptr) {
+    instance = Network::Utility::parseInternetAddressNoThrow(address);
+  }
+  return *instance->ip();
+}
+
+LookupResultMap result(const std::string& city) { return {{"x-geo-city", city}}; }
+
+TEST(LookupCacheTest, FindInNetwork) {
+  LookupCache cache(10);
+  EXPECT_EQ(nullptr, cache.find(ip("81.2.69.144")));
+
+  cache.insert(ip("81.2.69.150"), 28, result("London"));
+  EXPECT_EQ(1, cache.size());
+  for (const std::string address : {"81.2.69.144", "81.2.69.150", "81.2.69.159"}) {
+    const LookupResultMap* found = cache.find(ip(address));
+    ASSERT_NE(nullptr, found) << address;
+    EXPECT_EQ(result("London"), *found);
+  }
+  EXPECT_EQ(nullptr, cache.find(ip("81.2.69.143")));
+  EXPECT_EQ(nullptr, cache.find(ip("81.2.69.160")));
+
+  // The networks of different prefix lengths are all looked up.
+  cache.insert(ip("2.125.160.216"), 29, result("Boxford"));
+  EXPECT_EQ(result("Boxford"), *cache.find(ip("2.125.160.223")));
+  EXPECT_EQ(result("London"), *cache.find(ip("81.2.69.145")));
+}
+
+TEST(LookupCacheTest, AddressFamilies) {
+  LookupCache cache(10);
+  cache.insert(ip("0.0.0.1"), 0, result("v4"));
+  EXPECT_EQ(result("v4"), *cache.find(ip("10.10.10.10")));
+  // The IPv4 and IPv6 networks are distinct, even with the same bits.
+  EXPECT_EQ(nullptr, cache.find(ip("::1")));
+
+  cache.insert(ip("2001:db8::1"), 32, result("v6"));
+  EXPECT_EQ(result("v6"), *cache.find(ip("2001:db8:ffff::1")));
+  EXPECT_EQ(nullptr, cache.find(ip("2001:db9::1")));
+
+  // Host networks.
+  cache.insert(ip("2001:db9::1"), 128, result("host"));
+  EXPECT_EQ(result("host"), *cache.find(ip("2001:db9::1")));
+  EXPECT_EQ(nullptr, cache.find(ip("2001:db9::2")));
+}
+
+TEST(LookupCacheTest, EvictLeastRecentlyUsed) {
+  LookupCache cache(2);
+  cache.insert(ip("10.0.0.1"), 24, result("a"));
+  cache.insert(ip("10.0.1.1"), 24, result("b"));
+  // The first network is used again, so that the second one is evicted.
+  EXPECT_NE(nullptr, cache.find(ip("10.0.0.2")));
+  cache.insert(ip("10.1.2.1"), 16, result("c"));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(result("a"), *cache.find(ip("10.0.0.3")));
+  EXPECT_EQ(nullptr, cache.find(ip("10.0.1.3")));
+  EXPECT_EQ(result("c"), *cache.find(ip("10.1.5.5")));
+
+  // A network already cached is not inserted again.
+  cache.insert(ip("10.1.2.2"), 16, result("d"));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(result("c"), *cache.find(ip("10.1.2.2")));
+}
+
+TEST(LookupCacheTest, Clear) {
+  LookupCache cache(10);
+  cache.insert(ip("10.0.0.1"), 24, result("a"));
+  cache.insert(ip("2001:db8::1"), 64, result("b"));
+  cache.clear();
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(nullptr, cache.find(ip("10.0.0.1")));
+  EXPECT_EQ(nullptr, cache.find(ip("2001:db8::1")));
+}
+
+} // namespace
+} // namespace Maxmind
+} // namespace GeoipProviders
+} // namespace Extensions
+} // namespace Envoy
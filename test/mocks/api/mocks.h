@@ -91,6 +91,8 @@ public:
   MOCK_METHOD(SysCallIntResult, recvmmsg,
               (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags,
                struct timespec* timeout));
+  MOCK_METHOD(SysCallIntResult, sendmmsg,
+              (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags));
   MOCK_METHOD(SysCallIntResult, ftruncate, (int fd, off_t length));
   MOCK_METHOD(SysCallPtrResult, mmap,
               (void* addr, size_t length, int prot, int flags, int fd, off_t offset));
@@ -146,6 +148,9 @@ public:
   // Api::LinuxOsSysCalls
   MOCK_METHOD(SysCallIntResult, sched_getaffinity, (pid_t pid, size_t cpusetsize, cpu_set_t* mask));
   MOCK_METHOD(SysCallIntResult, setns, (int fd, int nstype), (const));
+  MOCK_METHOD(SysCallIntResult, pipe2, (os_fd_t pipefd[2], int flags));
+  MOCK_METHOD(SysCallSizeResult, splice,
+              (os_fd_t fd_in, os_fd_t fd_out, size_t len, unsigned int flags));
 };
 #endif
 
@@ -14,9 +14,11 @@ public:
     // in. These calls are incidental to most tests, so allow any number of them.
     ON_CALL(*this, isMultishotEnabled()).WillByDefault(::testing::Return(false));
     ON_CALL(*this, bufferPool()).WillByDefault(::testing::Return(nullptr));
+    ON_CALL(*this, datagramBufferPool()).WillByDefault(::testing::Return(nullptr));
     ON_CALL(*this, hasReadyCompletions()).WillByDefault(::testing::Return(false));
     EXPECT_CALL(*this, isMultishotEnabled()).Times(::testing::AnyNumber());
     EXPECT_CALL(*this, bufferPool()).Times(::testing::AnyNumber());
+    EXPECT_CALL(*this, datagramBufferPool()).Times(::testing::AnyNumber());
     EXPECT_CALL(*this, hasReadyCompletions()).Times(::testing::AnyNumber());
   }
 
@@ -37,6 +39,11 @@ public:
   MOCK_METHOD(bool, isMultishotEnabled, (), (const));
   MOCK_METHOD(IoUringBufferPoolSharedPtr, bufferPool, ());
   MOCK_METHOD(IoUringResult, prepareReadMultishot, (os_fd_t fd, Request* user_data));
+  MOCK_METHOD(IoUringBufferPoolSharedPtr, datagramBufferPool, ());
+  MOCK_METHOD(IoUringResult, prepareRecvmsgMultishot,
+              (os_fd_t fd, struct msghdr* msg, Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareSendmsg,
+              (os_fd_t fd, const struct msghdr* msg, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareWritev,
               (os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                Request* user_data));
@@ -83,6 +90,8 @@ public:
                bool enable_close_event));
   MOCK_METHOD(IoUringSocket&, addClientSocket,
               (os_fd_t fd, Event::FileReadyCb cb, bool enable_close_event));
+  MOCK_METHOD(IoUringDatagramSocket&, addDatagramSocket, (os_fd_t fd, Event::FileReadyCb cb));
+  MOCK_METHOD(bool, isDatagramEnabled, (), (const));
   MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
   MOCK_METHOD(Request*, submitConnectRequest,
               (IoUringSocket & socket, const Network::Address::InstanceConstSharedPtr& address));
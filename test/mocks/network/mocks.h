@@ -252,6 +252,7 @@ public:
   MOCK_METHOD(uint32_t, workerIndex, (), (const));
   MOCK_METHOD(void, onDataWorker, (Network::UdpRecvData && data));
   MOCK_METHOD(void, post, (Network::UdpRecvData && data));
+  MOCK_METHOD(void, postCallback, (std::function<void(UdpListenerCallbacksOptRef)> cb));
   MOCK_METHOD(size_t, numPacketsExpectedPerEventLoop, (), (const));
   MOCK_METHOD(const IoHandle::UdpSaveCmsgConfig&, udpSaveCmsgConfig, (), (const));
 };